@@ -60,15 +60,23 @@ endif()
 if("tas5805m" IN_LIST DRIVERS_PICKED_COMPONENTS)
     list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tas5805m/tas5805m.c)
     list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_table.c)
+    list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_ramp.c)
+    list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_packed_config/tasxxxx_packed_config.c)
     list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tas5805m)
     list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tasxxxx_volume_table)
+    list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tasxxxx_packed_config)
+    set(TeufelDrivers_TASXXXX_PACK_CONFIG ${DRIVERS_PATH}/tasxxxx_packed_config/tasxxxx_pack_config.py)
 endif()
 
 if("tas5825p" IN_LIST DRIVERS_PICKED_COMPONENTS)
     list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tas5825p/tas5825p.c)
     list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_table.c)
+    list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_ramp.c)
+    list(APPEND TeufelDrivers_SOURCES ${DRIVERS_PATH}/tasxxxx_packed_config/tasxxxx_packed_config.c)
     list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tas5825p)
     list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tasxxxx_volume_table)
+    list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tasxxxx_packed_config)
+    set(TeufelDrivers_TASXXXX_PACK_CONFIG ${DRIVERS_PATH}/tasxxxx_packed_config/tasxxxx_pack_config.py)
 endif()
 
 if("tps25751" IN_LIST DRIVERS_PICKED_COMPONENTS)
@@ -76,6 +84,35 @@ if("tps25751" IN_LIST DRIVERS_PICKED_COMPONENTS)
     list(APPEND TeufelDrivers_INCLUDE_DIR ${DRIVERS_PATH}/tps25751)
 endif()
 
+if(NOT (TARGET TeufelDrivers::Tests))
+    add_library(TeufelDrivers::Tests INTERFACE IMPORTED)
+    target_sources(TeufelDrivers::Tests INTERFACE
+            "${DRIVERS_PATH}/tasxxxx_packed_config/tasxxxx_packed_config.c"
+            "${DRIVERS_PATH}/tasxxxx_packed_config/tests/tasxxxx_packed_config_test.cpp"
+            "${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_table.c"
+            "${DRIVERS_PATH}/tasxxxx_volume_table/tasxxxx_volume_ramp.c"
+            "${DRIVERS_PATH}/tasxxxx_volume_table/tests/tasxxxx_volume_ramp_test.cpp"
+            "${DRIVERS_PATH}/tas5825p/tas5825p.c"
+            "${DRIVERS_PATH}/tas5825p/tests/tas5825p_test.cpp"
+            "${DRIVERS_PATH}/tas5805m/tas5805m.c"
+            "${DRIVERS_PATH}/STM32_vEEPROM/eeprom.c"
+            "${DRIVERS_PATH}/STM32_vEEPROM/virtual_eeprom.c"
+            "${DRIVERS_PATH}/STM32_vEEPROM/tests/eeprom_test.cpp")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tasxxxx_packed_config")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tasxxxx_volume_table")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tas5825p")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tas5805m")
+    # Register model of the amps shared by the host tests
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tasxxxx_packed_config/tests")
+    # Flash HAL and EEPROM configuration of the host tests
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/STM32_vEEPROM/tests")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/STM32_vEEPROM")
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}")
+    # No-op logger of the host tests, the drivers log through driver_logger.h
+    target_include_directories(TeufelDrivers::Tests INTERFACE "${DRIVERS_PATH}/tas5825p/tests")
+    target_compile_definitions(TeufelDrivers::Tests INTERFACE TEUFEL_LOGGER)
+endif()
+
 
 include(FindPackageHandleStandardArgs)
 
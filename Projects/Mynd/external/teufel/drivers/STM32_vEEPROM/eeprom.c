@@ -53,6 +53,13 @@ uint16_t DataVar = 0;
 /* Virtual address defined by the user: 0xFFFF value is prohibited */
 extern uint16_t VirtAddVarTab[NB_OF_VAR];
 
+/* RAM index of the valid page: last value of each variable of VirtAddVarTab,
+   so that reads don't have to scan the page. Built by EE_Init() and kept up
+   to date by EE_WriteVariable() */
+static uint16_t EE_IndexData[NB_OF_VAR];
+static uint8_t  EE_IndexFound[NB_OF_VAR];
+static uint8_t  EE_IndexValid = 0;
+
 /* Private function prototypes -----------------------------------------------*/
 /* Private functions ---------------------------------------------------------*/
 static HAL_StatusTypeDef EE_Format(void);
@@ -60,6 +67,8 @@ static uint16_t EE_FindValidPage(uint8_t Operation);
 static uint16_t EE_VerifyPageFullWriteVariable(uint16_t VirtAddress, uint16_t Data);
 static uint16_t EE_PageTransfer(uint16_t VirtAddress, uint16_t Data);
 static uint16_t EE_VerifyPageFullyErased(uint32_t Address);
+static int16_t EE_FindVarIndex(uint16_t VirtAddress);
+static void EE_BuildIndex(void);
 
 /**
   * @brief  Restore the pages to a known good state in case of page's status
@@ -78,6 +87,8 @@ uint16_t EE_Init(void)
   uint32_t page_error = 0;
   FLASH_EraseInitTypeDef s_eraseinit;
 
+  /* The pages are read directly until they are repaired */
+  EE_IndexValid = 0;
 
   /* Get Page0 status */
   pagestatus0 = (*(__IO uint16_t*)PAGE0_BASE_ADDRESS);
@@ -308,9 +319,76 @@ uint16_t EE_Init(void)
       break;
   }
 
+  EE_BuildIndex();
+
   return HAL_OK;
 }
 
+/**
+  * @brief  Returns the position of a virtual address in VirtAddVarTab.
+  * @param  VirtAddress: Variable virtual address
+  * @retval Index in VirtAddVarTab, -1 if the address isn't in the table
+  */
+static int16_t EE_FindVarIndex(uint16_t VirtAddress)
+{
+  uint16_t varidx = 0;
+
+  for (varidx = 0; varidx < NB_OF_VAR; varidx++)
+  {
+    if (VirtAddVarTab[varidx] == VirtAddress)
+    {
+      return (int16_t)varidx;
+    }
+  }
+
+  return -1;
+}
+
+/**
+  * @brief  Builds the RAM index with a single pass over the valid page. The
+  *   variables are appended in write order, so the last entry of a variable
+  *   is its current value.
+  * @param  None
+  * @retval None
+  */
+static void EE_BuildIndex(void)
+{
+  uint16_t validpage = PAGE0;
+  uint32_t address = EEPROM_START_ADDRESS, pageendaddress = EEPROM_START_ADDRESS;
+  int16_t varidx = -1;
+
+  EE_IndexValid = 0;
+
+  for (varidx = 0; varidx < NB_OF_VAR; varidx++)
+  {
+    EE_IndexFound[varidx] = 0;
+  }
+
+  validpage = EE_FindValidPage(READ_FROM_VALID_PAGE);
+  if (validpage == NO_VALID_PAGE)
+  {
+    return;
+  }
+
+  /* The first variable follows the page header */
+  address = (uint32_t)(EEPROM_START_ADDRESS + (uint32_t)(validpage * PAGE_SIZE) + 4);
+  pageendaddress = (uint32_t)(EEPROM_START_ADDRESS + (uint32_t)((validpage + 1) * PAGE_SIZE));
+
+  /* Stop at the first free location, the following ones are free as well */
+  while ((address < pageendaddress) && ((*(__IO uint32_t*)address) != 0xFFFFFFFF))
+  {
+    varidx = EE_FindVarIndex(*(__IO uint16_t*)(address + 2));
+    if (varidx >= 0)
+    {
+      EE_IndexData[varidx] = (*(__IO uint16_t*)address);
+      EE_IndexFound[varidx] = 1;
+    }
+    address = address + 4;
+  }
+
+  EE_IndexValid = 1;
+}
+
 /**
   * @brief  Verify if specified page is fully erased.
   * @param  Address: page address
@@ -364,6 +442,19 @@ uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data)
   uint16_t validpage = PAGE0;
   uint16_t addressvalue = 0x5555, readstatus = 1;
   uint32_t address = EEPROM_START_ADDRESS, PageStartAddress = EEPROM_START_ADDRESS;
+  int16_t varidx = -1;
+
+  /* Variables of VirtAddVarTab are read from the RAM index */
+  varidx = EE_FindVarIndex(VirtAddress);
+  if (EE_IndexValid && (varidx >= 0))
+  {
+    if (!EE_IndexFound[varidx])
+    {
+      return 1;
+    }
+    *Data = EE_IndexData[varidx];
+    return 0;
+  }
 
   /* Get active Page for read operation */
   validpage = EE_FindValidPage(READ_FROM_VALID_PAGE);
@@ -421,6 +512,7 @@ uint16_t EE_ReadVariable(uint16_t VirtAddress, uint16_t* Data)
 uint16_t EE_WriteVariable(uint16_t VirtAddress, uint16_t Data)
 {
   uint16_t Status = 0;
+  int16_t varidx = -1;
 
   /* Write the variable virtual address and value in the EEPROM */
   Status = EE_VerifyPageFullWriteVariable(VirtAddress, Data);
@@ -432,6 +524,22 @@ uint16_t EE_WriteVariable(uint16_t VirtAddress, uint16_t Data)
     Status = EE_PageTransfer(VirtAddress, Data);
   }
 
+  if (Status == HAL_OK)
+  {
+    /* A page transfer copies the other variables unchanged, only this one is updated */
+    varidx = EE_FindVarIndex(VirtAddress);
+    if (varidx >= 0)
+    {
+      EE_IndexData[varidx] = Data;
+      EE_IndexFound[varidx] = 1;
+    }
+  }
+  else
+  {
+    /* The pages are in an unknown state, read them directly until the next EE_Init() */
+    EE_IndexValid = 0;
+  }
+
   /* Return last operation status */
   return Status;
 }
@@ -0,0 +1,7 @@
+#pragma once
+
+// Same layout as Projects/Mynd/src/persistent_storage/eeprom_config.h
+#define EEPROM_FLASH_PAGE0 ((uint32_t) ADDR_FLASH_PAGE_62)
+#define EEPROM_FLASH_PAGE1 ((uint32_t) ADDR_FLASH_PAGE_63)
+
+#define EEPROM_ELEMENTS 15
@@ -0,0 +1,231 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <vector>
+
+#include <sys/mman.h>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "eeprom.h"
+#include "virtual_eeprom.h"
+}
+
+// Same virtual addresses as Projects/Mynd/src/persistent_storage/e_config.c
+extern "C" {
+uint16_t VirtAddVarTab[NB_OF_VAR] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x70, 0x71, 0x72, 0x73, 0x74,
+};
+}
+
+// Addresses read by Storage::load() for each Storage::Persistable type
+static const std::vector<uint16_t> persistable_addresses(std::begin(VirtAddVarTab), std::end(VirtAddVarTab));
+
+static uint32_t s_programs;
+static uint32_t s_erases;
+
+extern "C" HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    auto *p_halfword = reinterpret_cast<volatile uint16_t *>(static_cast<uintptr_t>(Address));
+
+    // Like the flash controller: a halfword can only be programmed once after an erase, except with 0
+    if (TypeProgram != FLASH_TYPEPROGRAM_HALFWORD || (*p_halfword != 0xFFFF && Data != 0))
+    {
+        return HAL_ERROR;
+    }
+
+    *p_halfword = static_cast<uint16_t>(Data);
+    s_programs++;
+    return HAL_OK;
+}
+
+extern "C" HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    *PageError = 0;
+    for (uint32_t i = 0; i < pEraseInit->NbPages; i++)
+    {
+        auto address = static_cast<uintptr_t>(pEraseInit->PageAddress + i * FLASH_PAGE_SIZE);
+        std::memset(reinterpret_cast<void *>(address), 0xFF, FLASH_PAGE_SIZE);
+        s_erases++;
+    }
+    return HAL_OK;
+}
+
+extern "C" HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    return HAL_OK;
+}
+
+extern "C" HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    return HAL_OK;
+}
+
+// Lookup of the original implementation: scans the valid page backwards for the newest entry of the address
+static int scan_read(uint16_t virt_address, uint16_t *p_data)
+{
+    uint32_t page = (*reinterpret_cast<volatile uint16_t *>(static_cast<uintptr_t>(PAGE0_BASE_ADDRESS)) == VALID_PAGE)
+                        ? PAGE0_BASE_ADDRESS
+                        : PAGE1_BASE_ADDRESS;
+
+    for (uint32_t address = page + PAGE_SIZE - 2; address > page + 2; address -= 4)
+    {
+        if (*reinterpret_cast<volatile uint16_t *>(static_cast<uintptr_t>(address)) == virt_address)
+        {
+            *p_data = *reinterpret_cast<volatile uint16_t *>(static_cast<uintptr_t>(address - 2));
+            return 0;
+        }
+    }
+    return 1;
+}
+
+class VirtualEepromTest : public ::testing::Test
+{
+  protected:
+    static void SetUpTestSuite()
+    {
+        // The emulation works on 32-bit flash addresses, so the flash pages are mapped at their STM32 address
+        void *p_flash = mmap(reinterpret_cast<void *>(static_cast<uintptr_t>(PAGE0_BASE_ADDRESS)), 2 * PAGE_SIZE,
+                             PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+        s_flash_mapped = p_flash == reinterpret_cast<void *>(static_cast<uintptr_t>(PAGE0_BASE_ADDRESS));
+    }
+
+    void SetUp() override
+    {
+        if (!s_flash_mapped)
+        {
+            GTEST_SKIP() << "The flash address range is used by the test executable";
+        }
+
+        std::memset(reinterpret_cast<void *>(static_cast<uintptr_t>(PAGE0_BASE_ADDRESS)), 0xFF, 2 * PAGE_SIZE);
+        ASSERT_EQ(EE_Init(), HAL_OK);
+        s_programs = 0;
+        s_erases   = 0;
+    }
+
+    // Fills the valid page with a history of updates, the last value of each address is stored in `values`
+    static void write_history(size_t count, std::map<uint16_t, uint16_t> &values)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            uint16_t address = persistable_addresses[i % persistable_addresses.size()];
+            uint16_t value   = static_cast<uint16_t>(i * 7919u);
+
+            ASSERT_EQ(EE_WriteVariable(address, value), HAL_OK);
+            values[address] = value;
+        }
+    }
+
+    static inline bool s_flash_mapped = false;
+};
+
+TEST_F(VirtualEepromTest, ReadOfMissingVariableFails)
+{
+    uint16_t value;
+
+    EXPECT_EQ(EE_ReadVariable(0x02, &value), 1);
+    EXPECT_EQ(EE_ReadVariable(0x20, &value), 1);
+}
+
+TEST_F(VirtualEepromTest, ReadsMatchThePageAcrossPageTransfers)
+{
+    std::map<uint16_t, uint16_t> values;
+
+    for (size_t round = 0; round < 8; round++)
+    {
+        write_history(97, values);
+
+        for (uint16_t address : VirtAddVarTab)
+        {
+            uint16_t value = 0, scanned = 0;
+            ASSERT_EQ(EE_ReadVariable(address, &value), 0);
+            ASSERT_EQ(scan_read(address, &scanned), 0);
+            EXPECT_EQ(value, values[address]);
+            EXPECT_EQ(value, scanned);
+        }
+    }
+
+    // 776 writes of 4 bytes don't fit in a 2 KiB page
+    EXPECT_GT(s_erases, 0u);
+}
+
+TEST_F(VirtualEepromTest, IndexIsRebuiltFromFlash)
+{
+    std::map<uint16_t, uint16_t> values;
+    write_history(300, values);
+
+    ASSERT_EQ(EE_Init(), HAL_OK);
+
+    for (uint16_t address : VirtAddVarTab)
+    {
+        uint16_t value = 0;
+        ASSERT_EQ(EE_ReadVariable(address, &value), 0);
+        EXPECT_EQ(value, values[address]);
+    }
+}
+
+TEST_F(VirtualEepromTest, UnchangedValueIsNotWritten)
+{
+    ASSERT_EQ(vEEPROM_AddressWrite(0x04, 17), 0);
+    uint32_t programs = s_programs;
+
+    ASSERT_EQ(vEEPROM_AddressWrite(0x04, 17), 0);
+    EXPECT_EQ(s_programs, programs);
+
+    ASSERT_EQ(vEEPROM_AddressWrite(0x04, 18), 0);
+    EXPECT_EQ(s_programs, programs + 2);
+}
+
+TEST_F(VirtualEepromTest, BootLoadOfAllPersistableKeys)
+{
+    constexpr int loads = 2000;
+
+    // Every key saved once, then a nearly full page of volume and SoC updates: the settings are at the start of
+    // the page, the worst case for the scan
+    std::map<uint16_t, uint16_t> values;
+    write_history(persistable_addresses.size(), values);
+    for (uint16_t i = 0; i < (PAGE_SIZE / 4) - 2 - persistable_addresses.size(); i++)
+    {
+        static const uint16_t frequent_addresses[] = {0x04, 0x71, 0x72};
+        ASSERT_EQ(EE_WriteVariable(frequent_addresses[i % 3], i), HAL_OK);
+    }
+    ASSERT_EQ(s_erases, 0u);
+    ASSERT_EQ(EE_Init(), HAL_OK);
+
+    auto     start    = std::chrono::steady_clock::now();
+    uint32_t checksum = 0;
+    for (int i = 0; i < loads; i++)
+    {
+        for (uint16_t address : persistable_addresses)
+        {
+            uint16_t value = 0;
+            ASSERT_EQ(EE_ReadVariable(address, &value), 0);
+            checksum += value;
+        }
+    }
+    auto indexed = std::chrono::steady_clock::now() - start;
+
+    start                     = std::chrono::steady_clock::now();
+    uint32_t scanned_checksum = 0;
+    for (int i = 0; i < loads; i++)
+    {
+        for (uint16_t address : persistable_addresses)
+        {
+            uint16_t value = 0;
+            ASSERT_EQ(scan_read(address, &value), 0);
+            scanned_checksum += value;
+        }
+    }
+    auto scanned = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(checksum, scanned_checksum);
+
+    auto ns_per_load = [](auto duration)
+    { return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count() / loads; };
+    std::printf("Load of %zu keys: %lld ns indexed, %lld ns scanning the page\n", persistable_addresses.size(),
+                static_cast<long long>(ns_per_load(indexed)), static_cast<long long>(ns_per_load(scanned)));
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/*
+ * Flash part of the STM32F0 HAL for the host tests, implemented by the test on a memory mapping at the flash
+ * address (the EEPROM emulation accesses the flash through 32-bit addresses).
+ */
+
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#define __IO volatile
+
+#define FLASH_PAGE_SIZE            0x800U
+#define FLASH_TYPEERASE_PAGES      0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+
+    typedef enum
+    {
+        HAL_OK      = 0x00U,
+        HAL_ERROR   = 0x01U,
+        HAL_BUSY    = 0x02U,
+        HAL_TIMEOUT = 0x03U
+    } HAL_StatusTypeDef;
+
+    typedef struct
+    {
+        uint32_t TypeErase;
+        uint32_t PageAddress;
+        uint32_t NbPages;
+    } FLASH_EraseInitTypeDef;
+
+    HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+    HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+    HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+    HAL_StatusTypeDef HAL_FLASH_Lock(void);
+
+#if defined(__cplusplus)
+}
+#endif
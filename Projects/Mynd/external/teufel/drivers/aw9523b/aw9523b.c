@@ -332,27 +332,30 @@ int aw9523b_read_pin_cache(const struct aw9523b_handler *h, uint8_t port, uint8_
     return (data >> pin) & 0x1;
 }
 
+int aw9523b_get_dimming_register(uint8_t port, uint8_t pin)
+{
+    if (!is_valid_port(port) || pin > 7)
+        return -E_AW9523B_PARAM;
+
+    if (port == AW9523B_PORT0)
+        return 0x24u + pin;
+
+    if (pin <= 3)
+        return 0x20u + pin;
+
+    return 0x2Cu + pin - 4;
+}
+
 int aw9523b_set_dimming(const struct aw9523b_handler *h, uint8_t port, uint8_t pin, uint8_t value)
 {
-    uint8_t reg = 0;
+    int reg;
 
     if (!h)
         return -E_AW9523B_PARAM;
 
-    if (!is_valid_port(port) || pin > 7)
-        return -E_AW9523B_PARAM;
-
-    if (port == AW9523B_PORT0)
-    {
-        reg = 0x24u + pin;
-    }
-    else
-    {
-        if (pin <= 3)
-            reg = 0x20u + pin;
-        else
-            reg = 0x2Cu + pin - 4;
-    }
+    reg = aw9523b_get_dimming_register(port, pin);
+    if (reg < 0)
+        return reg;
 
     if (h->i2c_write(h->i2c_addr, reg, (uint8_t[]){value}, 1) < 0)
         return -E_AW9523B_IO;
@@ -363,25 +366,14 @@ int aw9523b_set_dimming(const struct aw9523b_handler *h, uint8_t port, uint8_t p
 int aw9523b_set_dimming_multi(const struct aw9523b_handler *h, uint8_t port, uint8_t pin, const uint8_t *value,
                               uint8_t count)
 {
-    uint8_t reg = 0;
+    int reg;
 
     if (!h)
         return -E_AW9523B_PARAM;
 
-    if (!is_valid_port(port) || pin > 7)
-        return -E_AW9523B_PARAM;
-
-    if (port == AW9523B_PORT0)
-    {
-        reg = 0x24u + pin;
-    }
-    else
-    {
-        if (pin <= 3)
-            reg = 0x20u + pin;
-        else
-            reg = 0x2Cu + pin - 4;
-    }
+    reg = aw9523b_get_dimming_register(port, pin);
+    if (reg < 0)
+        return reg;
 
     if (h->i2c_write(h->i2c_addr, reg, (uint8_t *) value, count) < 0)
         return -E_AW9523B_IO;
@@ -206,6 +206,15 @@ extern "C"
     int aw9523b_set_dimming_multi(const aw9523b_handler_t *h, uint8_t port, uint8_t pin, const uint8_t *value,
                                   uint8_t count);
 
+    /**
+     * @brief Get the address of the dimming control register of a pin.
+     * @details Meant for callers which batch several register writes on the bus themselves.
+     * @param[in] port target port
+     * @param[in] pin target pin
+     * @return register address, -1,-2,-3,... otherwise
+     */
+    int aw9523b_get_dimming_register(uint8_t port, uint8_t pin);
+
     /**
      * @brief Set current for all ports.
      * @param h control handler
@@ -2,10 +2,12 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "tasxxxx_packed_config.h"
 
-#define E_TAS5805M_OK    0
-#define E_TAS5805M_IO    1 // I/O operation failed
-#define E_TAS5805M_PARAM 2 // Invalid param
+#define E_TAS5805M_OK       0
+#define E_TAS5805M_IO       1 // I/O operation failed
+#define E_TAS5805M_PARAM    2 // Invalid param
+#define E_TAS5805M_MISMATCH 3 // Registers don't hold the expected values
 
 typedef unsigned char cfg_u8;
 typedef union
@@ -33,6 +35,15 @@ typedef void (*tas5805m_delay_fn_t)(uint32_t ms);
 
 typedef struct tas5805m_handler tas5805m_handler_t;
 
+typedef struct
+{
+    uint32_t writes;             // I2C writes of the driver functions, with the book/page selections
+    uint32_t reads;              // I2C reads of the driver functions
+    uint32_t selections;         // Book/page selections written
+    uint32_t selections_skipped; // Book/page selections skipped, the device was already on the book and page
+    uint32_t configurations;     // Packed configurations loaded, their writes aren't counted
+} tas5805m_stats_t;
+
 typedef struct
 {
     tas5805m_i2c_read_fn_t  i2c_read_fn;
@@ -67,9 +78,31 @@ tas5805m_handler_t *tas5805m_init(const tas5805m_config_t *p_config);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_load_configuration(const tas5805m_handler_t *h, const tas5805m_cfg_reg_t *p_tasxxx_config,
+int tas5805m_load_configuration(tas5805m_handler_t *h, const tas5805m_cfg_reg_t *p_tasxxx_config,
                                 uint32_t config_length);
 
+/**
+ * @brief Loads a packed configuration for the TAS5805M amplifier.
+ *
+ * @param[in] h                     pointer to handler
+ * @param[in] p_config              pointer to packed configuration
+ *
+ * @return 0 if successful, error code otherwise
+ */
+int tas5805m_load_packed_configuration(tas5805m_handler_t *h, const tasxxxx_packed_config_t *p_config);
+
+/**
+ * @brief Checks that the amplifier holds a configuration by reading back its signature words.
+ *
+ * @param[in] h                     pointer to handler
+ * @param[in] p_signature           signature words of the configuration, generated by tasxxxx_pack_config.py
+ * @param[in] count                 number of signature words
+ *
+ * @return 0 if all the words match, -E_TAS5805M_MISMATCH if a word differs, error code otherwise
+ */
+int tas5805m_check_signature(tas5805m_handler_t *h, const tasxxxx_packed_signature_t *p_signature,
+                             uint32_t count);
+
 /**
  * @brief Enables/disables the DSP in the amplifier.
  *
@@ -81,7 +114,7 @@ int tas5805m_load_configuration(const tas5805m_handler_t *h, const tas5805m_cfg_
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_enable_dsp(const tas5805m_handler_t *h, bool enable);
+int tas5805m_enable_dsp(tas5805m_handler_t *h, bool enable);
 
 /**
  * @brief Enables/disables the EQ in the amplifier's DSP.
@@ -91,7 +124,7 @@ int tas5805m_enable_dsp(const tas5805m_handler_t *h, bool enable);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_enable_eq(const tas5805m_handler_t *h, bool enable);
+int tas5805m_enable_eq(tas5805m_handler_t *h, bool enable);
 
 /**
  * @brief Enables/disables the DRC in the amplifier's DSP.
@@ -101,7 +134,7 @@ int tas5805m_enable_eq(const tas5805m_handler_t *h, bool enable);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_enable_drc(const tas5805m_handler_t *h, bool enable);
+int tas5805m_enable_drc(tas5805m_handler_t *h, bool enable);
 
 /**
  * @brief Enables/disables the mute control for both left and right channels.
@@ -111,7 +144,7 @@ int tas5805m_enable_drc(const tas5805m_handler_t *h, bool enable);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_mute(const tas5805m_handler_t *h, bool enable);
+int tas5805m_mute(tas5805m_handler_t *h, bool enable);
 
 /**
  * @brief Sets the device to the given state.
@@ -121,7 +154,7 @@ int tas5805m_mute(const tas5805m_handler_t *h, bool enable);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_set_state(const tas5805m_handler_t *h, tas5805m_device_state_t state);
+int tas5805m_set_state(tas5805m_handler_t *h, tas5805m_device_state_t state);
 
 /**
  * @brief Sets the digital volume control for both left and right channels.
@@ -134,7 +167,20 @@ int tas5805m_set_state(const tas5805m_handler_t *h, tas5805m_device_state_t stat
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_set_volume(const tas5805m_handler_t *h, int8_t volume_db);
+int tas5805m_set_volume(tas5805m_handler_t *h, int8_t volume_db);
+
+/**
+ * @brief Sets the digital volume control for both left and right channels, in fine steps.
+ *
+ * @details The volume range goes from -90 dB to +20 dB, in 1/TASXXXX_VOLUME_STEPS_PER_DB dB (see
+ *          tasxxxx_volume_table.h). Anything less than -90 dB gets written as -infinite dB.
+ *
+ * @param[in] h             pointer to handler
+ * @param[in] volume        volume in 1/TASXXXX_VOLUME_STEPS_PER_DB dB
+ *
+ * @return 0 if successful, error code otherwise
+ */
+int tas5805m_set_fine_volume(tas5805m_handler_t *h, int16_t volume);
 /**
  * @brief Clears any analog faults in the device.
  *
@@ -142,4 +188,29 @@ int tas5805m_set_volume(const tas5805m_handler_t *h, int8_t volume_db);
  *
  * @return 0 if successful, error code otherwise
  */
-int tas5805m_clear_analog_fault(const tas5805m_handler_t *h);
+int tas5805m_clear_analog_fault(tas5805m_handler_t *h);
+
+/**
+ * @brief Makes the driver select the book and page again before the next access.
+ *
+ * @details The driver keeps track of the book and page the device is on, so consecutive accesses to the same page
+ *          don't select it again. It must be told when the device was reset or powered down (PDN pin) behind its back.
+ *
+ * @param[in] h             pointer to handler
+ */
+void tas5805m_invalidate_book_and_page(tas5805m_handler_t *h);
+
+/**
+ * @brief Gets the I2C transaction counters of the driver since the init or the last reset.
+ *
+ * @param[in] h             pointer to handler
+ * @param[out] p_stats      counters
+ */
+void tas5805m_get_stats(const tas5805m_handler_t *h, tas5805m_stats_t *p_stats);
+
+/**
+ * @brief Resets the I2C transaction counters of the driver.
+ *
+ * @param[in] h             pointer to handler
+ */
+void tas5805m_reset_stats(tas5805m_handler_t *h);
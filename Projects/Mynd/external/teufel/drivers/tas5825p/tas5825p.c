@@ -1,6 +1,7 @@
 #include "tas5825p.h"
 #include "tasxxxx_volume_table.h"
 #include <stddef.h>
+#include <string.h>
 
 #define LOG_MODULE_NAME "tas5825p.c"
 #define LOG_LEVEL       LOG_LEVEL_INFO
@@ -75,12 +76,19 @@ struct tas5825p_handler
     tas5825p_i2c_write_fn_t i2c_write_fn;
     tas5825p_delay_fn_t     delay_fn;
     uint8_t                 i2c_device_address;
+    // Book and page the device is on, as far as the driver knows
+    bool                    is_book_and_page_known;
+    uint8_t                 book;
+    uint8_t                 page;
+    tas5825p_stats_t        stats;
 };
 
-static int set_dsp_memory_to_book_and_page(const tas5825p_handler_t *h, uint8_t book, uint8_t page);
-static int tas5825p_read_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data);
-static int tas5825p_write_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t value);
-static int tas5825p_modify_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t bitmask,
+static int set_dsp_memory_to_book_and_page(tas5825p_handler_t *h, uint8_t book, uint8_t page);
+static int tas5825p_read(tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data, uint32_t length);
+static int tas5825p_write(tas5825p_handler_t *h, uint8_t register_address, const uint8_t *p_data, uint32_t length);
+static int tas5825p_read_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data);
+static int tas5825p_write_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t value);
+static int tas5825p_modify_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t bitmask,
                                     uint8_t value);
 
 tas5825p_handler_t *tas5825p_init(const tas5825p_config_t *p_config)
@@ -110,10 +118,13 @@ tas5825p_handler_t *tas5825p_init(const tas5825p_config_t *p_config)
     h->i2c_write_fn       = p_config->i2c_write_fn;
     h->delay_fn           = p_config->delay_fn;
     h->i2c_device_address = p_config->i2c_device_address;
+
+    h->is_book_and_page_known = false;
+    h->stats                  = (tas5825p_stats_t) {0};
     return h;
 }
 
-int tas5825p_load_configuration(const tas5825p_handler_t *h, const tas5825p_cfg_reg_t *p_tasxxx_config,
+int tas5825p_load_configuration(tas5825p_handler_t *h, const tas5825p_cfg_reg_t *p_tasxxx_config,
                                 uint32_t config_length)
 {
     int i = 0;
@@ -129,8 +140,8 @@ int tas5825p_load_configuration(const tas5825p_handler_t *h, const tas5825p_cfg_
                 break;
             case CFG_META_BURST:
                 // The write length is (param - 1) because the register address is included is part of the burst payload
-                if (h->i2c_write_fn(h->i2c_device_address, p_tasxxx_config[i + 1].offset, &p_tasxxx_config[i + 1].value,
-                                    p_tasxxx_config[i].param - 1) != 0)
+                if (tas5825p_write(h, p_tasxxx_config[i + 1].offset, &p_tasxxx_config[i + 1].value,
+                                   p_tasxxx_config[i].param - 1) != 0)
                 {
                     log_error("Failed to load configuration at register 0x%02X", p_tasxxx_config[i + 1].offset);
                     return -E_TAS5825P_IO;
@@ -147,10 +158,52 @@ int tas5825p_load_configuration(const tas5825p_handler_t *h, const tas5825p_cfg_
         }
         i++;
     }
+
+    // The configuration may reset the device
+    h->is_book_and_page_known = false;
     return E_TAS5825P_OK;
 }
 
-int tas5825p_enable_dsp(const tas5825p_handler_t *h, bool enable)
+int tas5825p_load_packed_configuration(tas5825p_handler_t *h, const tasxxxx_packed_config_t *p_config)
+{
+    // The configuration may reset the device and selects its books/pages directly
+    h->is_book_and_page_known = false;
+    h->stats.configurations++;
+
+    int ret = tasxxxx_packed_config_load(p_config, h->i2c_write_fn, h->delay_fn, h->i2c_device_address);
+    if (ret == -1)
+    {
+        log_error("Malformed packed configuration");
+        return -E_TAS5825P_PARAM;
+    }
+    if (ret != 0)
+    {
+        log_error("Failed to load packed configuration");
+        return -E_TAS5825P_IO;
+    }
+    return E_TAS5825P_OK;
+}
+
+int tas5825p_check_signature(tas5825p_handler_t *h, const tasxxxx_packed_signature_t *p_signature,
+                             uint32_t count)
+{
+    h->is_book_and_page_known = false;
+
+    int ret = tasxxxx_packed_config_check_signature(p_signature, count, h->i2c_read_fn, h->i2c_write_fn,
+                                                    h->i2c_device_address);
+    if (ret == 1)
+    {
+        return -E_TAS5825P_MISMATCH;
+    }
+    if (ret != 0)
+    {
+        log_error("Failed to read the signature");
+        return -E_TAS5825P_IO;
+    }
+    return E_TAS5825P_OK;
+}
+
+int tas5825p_enable_dsp(tas5825p_handler_t *h, bool enable)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -161,7 +214,7 @@ int tas5825p_enable_dsp(const tas5825p_handler_t *h, bool enable)
     return tas5825p_modify_register(h, TAS5825P_REG_DEVICE_CTRL_2, 0x10, dis_dsp_bit);
 }
 
-int tas5825p_mute(const tas5825p_handler_t *h, bool enable)
+int tas5825p_mute(tas5825p_handler_t *h, bool enable)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -172,7 +225,7 @@ int tas5825p_mute(const tas5825p_handler_t *h, bool enable)
     return tas5825p_modify_register(h, TAS5825P_REG_DEVICE_CTRL_2, 0x08, mute_bit);
 }
 
-int tas5825p_set_state(const tas5825p_handler_t *h, tas5825p_device_state_t state)
+int tas5825p_set_state(tas5825p_handler_t *h, tas5825p_device_state_t state)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -183,7 +236,7 @@ int tas5825p_set_state(const tas5825p_handler_t *h, tas5825p_device_state_t stat
     return tas5825p_modify_register(h, TAS5825P_REG_DEVICE_CTRL_2, 0x03, ctrl_state_bits);
 }
 
-int tas5825p_enable_eq(const tas5825p_handler_t *h, bool enable)
+int tas5825p_enable_eq(tas5825p_handler_t *h, bool enable)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x8C, 0x0B) != 0)
     {
@@ -192,7 +245,7 @@ int tas5825p_enable_eq(const tas5825p_handler_t *h, bool enable)
 
     uint8_t data[4] = {0};
     data[3] = (enable ? 0x00 : 0x01);
-    if (h->i2c_write_fn(h->i2c_device_address, 0x2C, data, sizeof(data)) != 0)
+    if (tas5825p_write(h, 0x2C, data, sizeof(data)) != 0)
     {
         return -E_TAS5825P_IO;
     }
@@ -200,7 +253,13 @@ int tas5825p_enable_eq(const tas5825p_handler_t *h, bool enable)
     return E_TAS5825P_OK;
 }
 
-int tas5825p_set_volume(const tas5825p_handler_t *h, int8_t volume_db)
+int tas5825p_set_volume(tas5825p_handler_t *h, int8_t volume_db)
+{
+    // The fine volume of a whole dB is the word of the table
+    return tas5825p_set_fine_volume(h, (int16_t) (volume_db * TASXXXX_VOLUME_STEPS_PER_DB));
+}
+
+int tas5825p_set_fine_volume(tas5825p_handler_t *h, int16_t volume)
 {
     // Book, page and registers were defined by EE by checking the I2C traffic
     // of the PPC3 tool
@@ -209,22 +268,14 @@ int tas5825p_set_volume(const tas5825p_handler_t *h, int8_t volume_db)
         return -E_TAS5825P_IO;
     }
 
-    const uint8_t *p_volume_data = tasxxxx_volume_get_data_for_db(volume_db);
-
-    if (h->i2c_write_fn(h->i2c_device_address, 0x0C, p_volume_data, 4) != 0)
-    {
-        return -E_TAS5825P_IO;
-    }
-
-    if (h->i2c_write_fn(h->i2c_device_address, 0x10, p_volume_data, 4) != 0)
-    {
-        return -E_TAS5825P_IO;
-    }
-
-    return E_TAS5825P_OK;
+    // Both channel gains are adjacent coefficients, written in a single burst
+    uint8_t data[8];
+    tasxxxx_volume_coefficient_to_data(tasxxxx_volume_get_coefficient(volume), &data[0]);
+    memcpy(&data[4], &data[0], 4);
+    return tas5825p_write(h, 0x0C, data, sizeof(data));
 }
 
-int tas5825p_set_gpio_mode(const tas5825p_handler_t *h, tas5825p_gpio_t gpio, tas5825p_gpio_mode_t mode)
+int tas5825p_set_gpio_mode(tas5825p_handler_t *h, tas5825p_gpio_t gpio, tas5825p_gpio_mode_t mode)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -235,7 +286,7 @@ int tas5825p_set_gpio_mode(const tas5825p_handler_t *h, tas5825p_gpio_t gpio, ta
     return tas5825p_write_register(h, register_address, (uint8_t)mode);
 }
 
-int tas5825p_set_gpio_output_level(const tas5825p_handler_t *h, tas5825p_gpio_t gpio, bool high)
+int tas5825p_set_gpio_output_level(tas5825p_handler_t *h, tas5825p_gpio_t gpio, bool high)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -247,7 +298,7 @@ int tas5825p_set_gpio_output_level(const tas5825p_handler_t *h, tas5825p_gpio_t
     return tas5825p_modify_register(h, TAS5825P_REG_GPIO_OUT, bitmask, value);
 }
 
-int tas5825p_clear_analog_fault(const tas5825p_handler_t *h)
+int tas5825p_clear_analog_fault(tas5825p_handler_t *h)
 {
     if (set_dsp_memory_to_book_and_page(h, 0x00, 0x00) != 0)
     {
@@ -257,7 +308,7 @@ int tas5825p_clear_analog_fault(const tas5825p_handler_t *h)
     return tas5825p_write_register(h, TAS5825P_REG_FAULT_CLEAR, 0x80);
 }
 
-int tas5825p_recover_dc_fake_fault(const tas5825p_handler_t *h)
+int tas5825p_recover_dc_fake_fault(tas5825p_handler_t *h)
 {
     const uint8_t command_seq[][2] = {
         {0x00, 0x00},
@@ -285,17 +336,68 @@ int tas5825p_recover_dc_fake_fault(const tas5825p_handler_t *h)
     return E_TAS5825P_OK;
 }
 
-static int tas5825p_read_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data)
+void tas5825p_invalidate_book_and_page(tas5825p_handler_t *h)
+{
+    h->is_book_and_page_known = false;
+}
+
+void tas5825p_get_stats(const tas5825p_handler_t *h, tas5825p_stats_t *p_stats)
+{
+    *p_stats = h->stats;
+}
+
+void tas5825p_reset_stats(tas5825p_handler_t *h)
+{
+    h->stats = (tas5825p_stats_t) {0};
+}
+
+static int tas5825p_read(tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data, uint32_t length)
+{
+    h->stats.reads++;
+    if (h->i2c_read_fn(h->i2c_device_address, register_address, p_data, length) != 0)
+    {
+        return -E_TAS5825P_IO;
+    }
+    return E_TAS5825P_OK;
+}
+
+static int tas5825p_write(tas5825p_handler_t *h, uint8_t register_address, const uint8_t *p_data, uint32_t length)
+{
+    h->stats.writes++;
+    if (h->i2c_write_fn(h->i2c_device_address, register_address, p_data, length) != 0)
+    {
+        // The device may or may not have taken the write
+        h->is_book_and_page_known = false;
+        return -E_TAS5825P_IO;
+    }
+    return E_TAS5825P_OK;
+}
+
+static int tas5825p_read_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t *p_data)
 {
-    return (h->i2c_read_fn(h->i2c_device_address, register_address, p_data, 1) == 0) ? E_TAS5825P_OK : -E_TAS5825P_IO;
+    return tas5825p_read(h, register_address, p_data, 1);
 }
 
-static int tas5825p_write_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t value)
+static int tas5825p_write_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t value)
 {
-    return (h->i2c_write_fn(h->i2c_device_address, register_address, &value, 1) == 0) ? E_TAS5825P_OK : -E_TAS5825P_IO;
+    if (tas5825p_write(h, register_address, &value, 1) != 0)
+    {
+        return -E_TAS5825P_IO;
+    }
+
+    // Follows the book/page selections written directly, e.g. by the fault recovery sequences
+    if (register_address == 0x00)
+    {
+        h->page = value;
+    }
+    else if (register_address == 0x7F && h->page == 0x00)
+    {
+        h->book = value;
+    }
+    return E_TAS5825P_OK;
 }
 
-static int tas5825p_modify_register(const tas5825p_handler_t *h, uint8_t register_address, uint8_t bitmask,
+static int tas5825p_modify_register(tas5825p_handler_t *h, uint8_t register_address, uint8_t bitmask,
                                     uint8_t value)
 {
     // Assert that the value does not write outside the provided bitmask
@@ -319,21 +421,37 @@ static int tas5825p_modify_register(const tas5825p_handler_t *h, uint8_t registe
     return tas5825p_write_register(h, register_address, data);
 }
 
-static int set_dsp_memory_to_book_and_page(const tas5825p_handler_t *h, uint8_t book, uint8_t page)
+static int set_dsp_memory_to_book_and_page(tas5825p_handler_t *h, uint8_t book, uint8_t page)
 {
-    // Register 0x00 of every page is used to change the page of the memory book
-    if (tas5825p_write_register(h, 0x00, 0x00) != 0)
+    if (h->is_book_and_page_known && h->book == book && h->page == page)
     {
-        return -E_TAS5825P_IO;
+        h->stats.selections_skipped++;
+        return E_TAS5825P_OK;
     }
+    h->stats.selections++;
 
-    // Register 0x7F of page 0x00 of every book is used to change the book
-    // Change the book here
-    if (tas5825p_write_register(h, 0x7F, book) != 0)
+    if (!h->is_book_and_page_known || h->book != book)
     {
-        return -E_TAS5825P_IO;
+        // Register 0x00 of every page is used to change the page of the memory book
+        if (tas5825p_write_register(h, 0x00, 0x00) != 0)
+        {
+            return -E_TAS5825P_IO;
+        }
+
+        // Register 0x7F of page 0x00 of every book is used to change the book
+        // Change the book here
+        if (tas5825p_write_register(h, 0x7F, book) != 0)
+        {
+            return -E_TAS5825P_IO;
+        }
     }
 
     // Now that we are in the right book, change to the wished page
-    return tas5825p_write_register(h, 0x00, page);
+    if (h->page != page && tas5825p_write_register(h, 0x00, page) != 0)
+    {
+        return -E_TAS5825P_IO;
+    }
+
+    h->is_book_and_page_known = true;
+    return E_TAS5825P_OK;
 }
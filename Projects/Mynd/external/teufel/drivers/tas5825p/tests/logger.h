@@ -0,0 +1,13 @@
+#pragma once
+
+// Logger of the host tests, driver_logger.h maps the driver logs to it when TEUFEL_LOGGER is defined
+#define log_fatal(...)     ((void) 0)
+#define log_error(...)     ((void) 0)
+#define log_err(...)       ((void) 0)
+#define log_warning(...)   ((void) 0)
+#define log_warn(...)      ((void) 0)
+#define log_highlight(...) ((void) 0)
+#define log_info(...)      ((void) 0)
+#define log_debug(...)     ((void) 0)
+#define log_dbg(...)       ((void) 0)
+#define log_trace(...)     ((void) 0)
@@ -0,0 +1,159 @@
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "tas5825p.h"
+#include "tasxxxx_volume_table.h"
+}
+
+#include "tas_register_model.h"
+
+using Bytes = std::vector<uint8_t>;
+
+static TasRegisterModel s_model;
+
+extern "C" {
+static int model_read(uint8_t, uint8_t reg, uint8_t *p_data, uint32_t length)
+{
+    return s_model.read(reg, p_data, length);
+}
+
+static int model_write(uint8_t, uint8_t reg, const uint8_t *p_data, uint32_t length)
+{
+    return s_model.write(reg, p_data, length);
+}
+
+static void model_delay(uint32_t) {}
+}
+
+class Tas5825pTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        s_model = TasRegisterModel();
+
+        static const tas5825p_config_t config = {
+            .i2c_read_fn        = model_read,
+            .i2c_write_fn       = model_write,
+            .delay_fn           = model_delay,
+            .i2c_device_address = 0x98,
+        };
+        static tas5825p_handler_t *p_handler = tas5825p_init(&config);
+
+        h = p_handler;
+        tas5825p_invalidate_book_and_page(h);
+        tas5825p_reset_stats(h);
+    }
+
+    tas5825p_stats_t stats() const
+    {
+        tas5825p_stats_t stats;
+        tas5825p_get_stats(h, &stats);
+        return stats;
+    }
+
+    Bytes volume(uint8_t reg) const
+    {
+        Bytes data;
+        for (uint8_t i = 0; i < 4; i++)
+        {
+            data.push_back(s_model.registers[{0x8C, 0x0B, static_cast<uint8_t>(reg + i)}]);
+        }
+        return data;
+    }
+
+    tas5825p_handler_t *h = nullptr;
+};
+
+TEST_F(Tas5825pTest, VolumeIsASingleBurst)
+{
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+
+    // Page 0, book, page and both channels
+    ASSERT_EQ(s_model.writes.size(), 4u);
+    EXPECT_EQ(s_model.writes.back().first, 0x0C);
+    EXPECT_EQ(s_model.writes.back().second.size(), 8u);
+
+    const Bytes expected(tasxxxx_volume_get_data_for_db(-20), tasxxxx_volume_get_data_for_db(-20) + 4);
+    EXPECT_EQ(volume(0x0C), expected);
+    EXPECT_EQ(volume(0x10), expected);
+}
+
+TEST_F(Tas5825pTest, HeldVolumeButtonSelectsThePageOnce)
+{
+    for (int8_t volume_db = -40; volume_db < -20; volume_db++)
+    {
+        ASSERT_EQ(tas5825p_set_volume(h, volume_db), 0);
+    }
+
+    EXPECT_EQ(s_model.writes.size(), 3u + 20u);
+    EXPECT_EQ(stats().selections, 1u);
+    EXPECT_EQ(stats().selections_skipped, 19u);
+    EXPECT_EQ(stats().writes, 3u + 20u);
+}
+
+TEST_F(Tas5825pTest, OnlyChangedSelectionsAreWritten)
+{
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+    s_model.writes.clear();
+
+    ASSERT_EQ(tas5825p_mute(h, true), 0);
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+
+    // Page 0 and book 0 for the mute, the control register, page 0 and book 0x8C again, the volume page and burst
+    ASSERT_EQ(s_model.writes.size(), 7u);
+    EXPECT_EQ(s_model.book, 0x8C);
+    EXPECT_EQ(s_model.page, 0x0B);
+
+    s_model.writes.clear();
+    ASSERT_EQ(tas5825p_enable_eq(h, true), 0);
+    ASSERT_EQ(s_model.writes.size(), 1u);
+    EXPECT_EQ(s_model.writes[0].first, 0x2C);
+}
+
+TEST_F(Tas5825pTest, ResetIsFollowedByAFullSelection)
+{
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+
+    s_model.power_down();
+    tas5825p_invalidate_book_and_page(h);
+    s_model.writes.clear();
+
+    ASSERT_EQ(tas5825p_set_volume(h, -10), 0);
+    EXPECT_EQ(s_model.writes.size(), 4u);
+    EXPECT_EQ(volume(0x0C), Bytes(tasxxxx_volume_get_data_for_db(-10), tasxxxx_volume_get_data_for_db(-10) + 4));
+}
+
+TEST_F(Tas5825pTest, ConfigurationLoadInvalidatesTheSelection)
+{
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+
+    // Leaves the device on book 0x00, page 0x01
+    const tas5825p_cfg_reg_t config[] = {
+        {0x00, 0x00},
+        {0x7F, 0x00},
+        {0x00, 0x01},
+    };
+    ASSERT_EQ(tas5825p_load_configuration(h, config, sizeof(config) / sizeof(config[0])), 0);
+
+    ASSERT_EQ(tas5825p_set_volume(h, -10), 0);
+    EXPECT_EQ(stats().selections, 2u);
+    EXPECT_EQ(volume(0x0C), Bytes(tasxxxx_volume_get_data_for_db(-10), tasxxxx_volume_get_data_for_db(-10) + 4));
+}
+
+TEST_F(Tas5825pTest, FailedWriteInvalidatesTheSelection)
+{
+    ASSERT_EQ(tas5825p_set_volume(h, -20), 0);
+
+    s_model.fail = true;
+    EXPECT_NE(tas5825p_set_volume(h, -10), 0);
+    s_model.fail = false;
+
+    ASSERT_EQ(tas5825p_set_volume(h, -10), 0);
+    EXPECT_EQ(stats().selections, 2u);
+    EXPECT_EQ(volume(0x0C), Bytes(tasxxxx_volume_get_data_for_db(-10), tasxxxx_volume_get_data_for_db(-10) + 4));
+}
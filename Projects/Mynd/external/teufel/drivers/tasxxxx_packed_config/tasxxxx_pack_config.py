@@ -0,0 +1,582 @@
+#!/usr/bin/env python3
+"""
+Packs TAS5805M/TAS5825P register configurations (the `tasxxxx_cfg_reg_t` arrays exported by PPC3) into the
+compact stream format read by tasxxxx_packed_config.c.
+
+All the arrays of the given headers are packed into a single blob, so a coefficient block which appears in
+several configurations is only stored once. See tasxxxx_packed_config.h for the description of the format.
+
+With --steps, the arrays of an EQ control (one per level, in order) are also packed as the deltas between
+adjacent levels, which only write the coefficients changing from one level to the next.
+
+With --signature, a few DSP words of a configuration which no other array of the headers changes are generated,
+the firmware reads them back to check whether an amplifier kept the configuration.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+CFG_META_SWITCH = 255
+CFG_META_DELAY = 254
+CFG_META_BURST = 253
+
+META = {
+    "CFG_META_SWITCH": CFG_META_SWITCH,
+    "CFG_META_DELAY": CFG_META_DELAY,
+    "CFG_META_BURST": CFG_META_BURST,
+}
+
+# Stream opcodes
+OP_WRITE = 0x00  # 0x00-0x7F: (n + 1) single register writes follow as (register, value) pairs
+OP_BURST = 0x80  # 0x80-0xBF: burst of (n + 1) 32-bit words, followed by the start register and word tokens
+OP_DELAY = 0xC0  # delay in ms follows
+OP_BURST_BYTES = 0xC1  # burst which isn't made of whole words: length, start register and raw bytes follow
+OP_SELECT = 0xC2  # book and page follow, written as page 0 -> book -> page
+
+# Word tokens of a burst
+TOKEN_LITERAL = 0x00  # 0x00-0x3F: (n + 1) words follow
+TOKEN_ZERO = 0x40  # 0x40-0x7F: (n + 1) zero words
+TOKEN_COPY = 0x80  # 0x80-0xBF: (n + 1) words copied from the blob, the 16-bit little endian offset follows
+TOKEN_REPEAT = 0xC0  # 0xC0-0xFF: the previous word repeated (n + 1) times
+
+MAX_WRITES = 128
+MAX_TOKEN_WORDS = 64
+MAX_BURST_LENGTH = 128  # TASXXXX_PACKED_CONFIG_MAX_BURST_LENGTH
+REG_PAGE = 0x00
+REG_BOOK = 0x7F
+PAGE_END = 0x80
+ZERO_WORD = b"\x00\x00\x00\x00"
+BIQUAD_LENGTH = 20  # b0, b1, b2, a1, a2
+FIRST_COEFFICIENT = 0x08  # Registers 0x01-0x07 of the DSP pages aren't coefficients
+SIGNATURE_WORDS = 4
+I2C_TRANSACTION_OVERHEAD = 2  # I2C address and register address
+
+
+def strip_source(source):
+    """Removes comments and `#if 0` blocks from a C header."""
+    source = re.sub(r"/\*.*?\*/", "", source, flags=re.S)
+    source = re.sub(r"//[^\n]*", "", source)
+
+    lines = []
+    disabled_depth = 0
+    for line in source.split("\n"):
+        directive = line.strip()
+        if disabled_depth == 0 and re.match(r"#\s*if\s+0\b", directive):
+            disabled_depth = 1
+            continue
+        if disabled_depth:
+            if directive.startswith("#if"):
+                disabled_depth += 1
+            elif directive.startswith("#endif"):
+                disabled_depth -= 1
+            continue
+        lines.append(line)
+
+    return "\n".join(lines)
+
+
+def parse_header(path):
+    """Returns the (name, [(command, param), ...]) configuration arrays of a header, in order."""
+    with open(path) as f:
+        source = strip_source(f.read())
+
+    arrays = []
+    for match in re.finditer(r"const\s+\w+_cfg_reg_t\s+(\w+)\s*\[\s*\]\s*=\s*\{(.*?)\}\s*;", source, re.S):
+        entries = []
+        for command, param in re.findall(r"\{\s*(\w+)\s*,\s*(\w+)\s*\}", match.group(2)):
+            entries.append((META[command] if command in META else int(command, 0), int(param, 0)))
+        arrays.append((match.group(1), entries))
+
+    return arrays
+
+
+def to_operations(entries):
+    """Turns configuration entries into ("write", reg, value), ("delay", ms), ("burst", reg, data) operations,
+    walking them the same way as tasxxxx_load_configuration()."""
+    operations = []
+    i = 0
+    while i < len(entries):
+        command, param = entries[i]
+        if command == CFG_META_SWITCH:
+            pass
+        elif command == CFG_META_DELAY:
+            operations.append(("delay", param))
+        elif command == CFG_META_BURST:
+            # The burst length includes the register address, stored in the first entry
+            flat = [byte for entry in entries[i + 1 : i + 1 + (param + 1) // 2] for byte in entry][:param]
+            operations.append(("burst", flat[0], bytes(flat[1:])))
+            i += param // 2 + 1
+        else:
+            operations.append(("write", command, param))
+        i += 1
+
+    return operations
+
+
+def merge_operations(operations):
+    """Detects book/page selections and merges bursts which continue each other into maximal bursts."""
+    merged = []
+    for operation in operations:
+        previous = merged[-1] if merged else None
+
+        if (
+            operation[0] == "burst"
+            and previous is not None
+            and previous[0] == "burst"
+            and previous[1] + len(previous[2]) == operation[1]
+            and operation[1] + len(operation[2]) <= PAGE_END
+            and len(previous[2]) + len(operation[2]) <= MAX_BURST_LENGTH
+        ):
+            merged[-1] = ("burst", previous[1], previous[2] + operation[2])
+            continue
+
+        if (
+            operation[0] == "write"
+            and operation[1] == REG_PAGE
+            and len(merged) >= 2
+            and merged[-2] == ("write", REG_PAGE, 0)
+            and merged[-1][0] == "write"
+            and merged[-1][1] == REG_BOOK
+        ):
+            book = merged[-1][2]
+            del merged[-2:]
+            merged.append(("select", book, operation[2]))
+            continue
+
+        merged.append(operation)
+
+    return merged
+
+
+class Packer:
+    def __init__(self):
+        self.blob = bytearray()
+        # word -> [blob offsets of literal words], to find the coefficient blocks which are already stored
+        self.literal_index = {}
+        self.literal_words = {}
+
+    def _add_literals(self, words):
+        self.blob.append(TOKEN_LITERAL | (len(words) - 1))
+        for word in words:
+            offset = len(self.blob)
+            self.blob += word
+            self.literal_index.setdefault(word, []).append(offset)
+            self.literal_words[offset] = word
+
+    def _longest_copy(self, words, start):
+        best_offset, best_length = 0, 0
+        for offset in self.literal_index.get(words[start], []):
+            if offset > 0xFFFF:
+                break
+            length = 0
+            while (
+                start + length < len(words)
+                and length < MAX_TOKEN_WORDS
+                and self.literal_words.get(offset + 4 * length) == words[start + length]
+            ):
+                length += 1
+            if length > best_length:
+                best_offset, best_length = offset, length
+        return best_offset, best_length
+
+    def _pack_words(self, words):
+        pending = []
+
+        def flush():
+            while pending:
+                count = min(len(pending), MAX_TOKEN_WORDS)
+                self._add_literals(pending[:count])
+                del pending[:count]
+
+        i = 0
+        while i < len(words):
+            zeros = 0
+            while i + zeros < len(words) and words[i + zeros] == ZERO_WORD and zeros < MAX_TOKEN_WORDS:
+                zeros += 1
+            if zeros:
+                flush()
+                self.blob.append(TOKEN_ZERO | (zeros - 1))
+                i += zeros
+                continue
+
+            repeats = 0
+            while i > 0 and i + repeats < len(words) and words[i + repeats] == words[i - 1] and repeats < MAX_TOKEN_WORDS:
+                repeats += 1
+            if repeats:
+                flush()
+                self.blob.append(TOKEN_REPEAT | (repeats - 1))
+                i += repeats
+                continue
+
+            offset, length = self._longest_copy(words, i)
+            if length >= 2:
+                flush()
+                self.blob += bytes([TOKEN_COPY | (length - 1), offset & 0xFF, offset >> 8])
+                i += length
+                continue
+
+            pending.append(words[i])
+            if len(pending) == MAX_TOKEN_WORDS:
+                flush()
+            i += 1
+
+        flush()
+
+    def pack(self, operations):
+        start = len(self.blob)
+
+        i = 0
+        while i < len(operations):
+            operation = operations[i]
+            if operation[0] == "write":
+                writes = []
+                while i < len(operations) and operations[i][0] == "write" and len(writes) < MAX_WRITES:
+                    writes.append(operations[i])
+                    i += 1
+                self.blob.append(OP_WRITE | (len(writes) - 1))
+                for _, register, value in writes:
+                    self.blob += bytes([register, value])
+                continue
+
+            if operation[0] == "delay":
+                if operation[1] > 0xFF:
+                    raise ValueError(f"Delay of {operation[1]} ms doesn't fit in the format")
+                self.blob += bytes([OP_DELAY, operation[1]])
+            elif operation[0] == "select":
+                self.blob += bytes([OP_SELECT, operation[1], operation[2]])
+            else:
+                _, register, data = operation
+                if not 0 < len(data) <= MAX_BURST_LENGTH:
+                    raise ValueError(f"Burst of {len(data)} bytes doesn't fit in the format")
+                if len(data) % 4 == 0:
+                    words = [data[j : j + 4] for j in range(0, len(data), 4)]
+                    self.blob += bytes([OP_BURST | (len(words) - 1), register])
+                    self._pack_words(words)
+                else:
+                    self.blob += bytes([OP_BURST_BYTES, len(data), register]) + data
+            i += 1
+
+        return start, len(self.blob) - start
+
+
+def unpack(blob, start, length):
+    """Decodes a packed configuration back into operations (used to check the packer)."""
+    operations = []
+    i = start
+    end = start + length
+    while i < end:
+        op = blob[i]
+        i += 1
+        if op < OP_BURST:
+            for _ in range(op + 1):
+                operations.append(("write", blob[i], blob[i + 1]))
+                i += 2
+        elif op < OP_DELAY:
+            words_left = (op & 0x3F) + 1
+            register = blob[i]
+            i += 1
+            data = bytearray()
+            while words_left:
+                token = blob[i]
+                count = (token & 0x3F) + 1
+                i += 1
+                if token < TOKEN_ZERO:
+                    data += blob[i : i + 4 * count]
+                    i += 4 * count
+                elif token < TOKEN_COPY:
+                    data += ZERO_WORD * count
+                elif token < TOKEN_REPEAT:
+                    offset = blob[i] | (blob[i + 1] << 8)
+                    i += 2
+                    data += blob[offset : offset + 4 * count]
+                else:
+                    data += data[-4:] * count
+                words_left -= count
+            operations.append(("burst", register, bytes(data)))
+        elif op == OP_DELAY:
+            operations.append(("delay", blob[i]))
+            i += 1
+        elif op == OP_BURST_BYTES:
+            operations.append(("burst", blob[i + 1], bytes(blob[i + 2 : i + 2 + blob[i]])))
+            i += 2 + blob[i]
+        elif op == OP_SELECT:
+            operations += [("write", REG_PAGE, 0), ("write", REG_BOOK, blob[i]), ("write", REG_PAGE, blob[i + 1])]
+            i += 2
+        else:
+            raise ValueError(f"Unknown opcode 0x{op:02X} at {i - 1}")
+
+    return operations
+
+
+def register_writes(operations):
+    """Flattens operations into the sequence of single register writes they result in."""
+    writes = []
+    for operation in operations:
+        if operation[0] == "burst":
+            writes += [("write", operation[1] + j, value) for j, value in enumerate(operation[2])]
+        elif operation[0] == "select":
+            writes += [("write", REG_PAGE, 0), ("write", REG_BOOK, operation[1]), ("write", REG_PAGE, operation[2])]
+        else:
+            writes.append(operation)
+    return writes
+
+
+def step_delta(previous, current):
+    """Returns the bursts which turn the coefficients written by `previous` into the ones written by `current`.
+
+    Only the changed coefficients (32-bit words) are written. The feedback coefficients (a1, a2) of a biquad are always written
+    together in one burst, so the filter never runs with the poles of two different levels.
+    """
+    if any(op[0] != "burst" for op in previous) or [op[:2] for op in previous] != [op[:2] for op in current]:
+        raise ValueError("EQ levels must be bursts to the same registers")
+
+    delta = []
+    for (_, register, old), (_, _, new) in zip(previous, current):
+        if len(old) != len(new) or len(old) % 4:
+            raise ValueError("EQ levels must be bursts of whole words")
+
+        changed = [old[j : j + 4] != new[j : j + 4] for j in range(0, len(old), 4)]
+        if len(old) % BIQUAD_LENGTH == 0:
+            for a1 in range(3, len(changed), BIQUAD_LENGTH // 4):
+                changed[a1] = changed[a1 + 1] = changed[a1] or changed[a1 + 1]
+
+        j = 0
+        while j < len(changed):
+            if not changed[j]:
+                j += 1
+                continue
+            end = j
+            while end < len(changed) and changed[end]:
+                end += 1
+            delta.append(("burst", register + 4 * j, new[4 * j : 4 * end]))
+            j = end
+
+    return delta
+
+
+def apply_writes(registers, operations):
+    """Updates a register map with the register writes of operations."""
+    for _, register, value in register_writes(operations):
+        registers[register] = value
+    return registers
+
+
+def book_page_writes(operations, book=None, page=None):
+    """Returns the {(book, page, register): value} map written by operations and the book and page selected at the
+    end. An array which doesn't select a book or page writes to the ones the previous array selected, None if unknown.
+    """
+    registers = {}
+    for _, register, value in [write for write in register_writes(operations) if write[0] == "write"]:
+        if register == REG_PAGE:
+            page = value
+        elif register == REG_BOOK and page == 0:
+            book = value
+        else:
+            registers[(book, page, register)] = value
+    return registers, book, page
+
+
+def pick_signature(tables, name):
+    """Picks words written by configuration `name` on DSP pages which no other configuration writes, one word per page
+    on pages spread from the first to the last one it writes. The values are the ones at the end of the configuration.
+    Values which are zero or appear twice are skipped, they would also match a wrong page."""
+    registers = None
+    other_pages = set()
+    book = page = header = None
+    for table in tables:
+        if table[1] != header:
+            book = page = None
+            header = table[1]
+        writes, book, page = book_page_writes(table[5], book, page)
+        if table[0] == name:
+            registers = writes
+        else:
+            other_pages |= {(book, page) for book, page, _ in writes}
+
+    if registers is None:
+        sys.exit(f"Unknown configuration {name} for the signature")
+
+    words = {}
+    for book, page, register in registers:
+        if (
+            book not in (0, None)
+            and (book, page) not in other_pages
+            and (None, page) not in other_pages
+            and register >= FIRST_COEFFICIENT
+            and register % 4 == 0
+            and all((book, page, register + j) in registers for j in range(4))
+        ):
+            words[(book, page, register)] = bytes(registers[(book, page, register + j)] for j in range(4))
+
+    values = list(words.values())
+    pages = {}
+    for (book, page, register), value in words.items():
+        if value != ZERO_WORD and values.count(value) == 1:
+            pages.setdefault((book, page), (book, page, register, value))
+
+    candidates = list(pages.values())
+    if len(candidates) < SIGNATURE_WORDS:
+        sys.exit(f"{name} has only {len(candidates)} signature words")
+
+    step = (len(candidates) - 1) / (SIGNATURE_WORDS - 1)
+    return [candidates[round(i * step)] for i in range(SIGNATURE_WORDS)]
+
+
+def i2c_bytes(operations):
+    """Returns the bytes a configuration sends on the bus, counting the I2C and register address of every write."""
+    count = 0
+    for operation in operations:
+        if operation[0] == "burst":
+            count += I2C_TRANSACTION_OVERHEAD + len(operation[2])
+        elif operation[0] != "delay":
+            count += (I2C_TRANSACTION_OVERHEAD + 1) * len(register_writes([operation]))
+    return count
+
+
+def pack_steps(packer, tables, steps):
+    """Packs the deltas between adjacent levels of an EQ control given as NAME=LEVEL_ARRAY,LEVEL_ARRAY,...
+
+    A step whose delta isn't smaller on the bus than the full level loads the full level, which is already packed.
+    """
+    name, _, levels = steps.partition("=")
+    levels = levels.split(",")
+    operations = {table[0]: table[5] for table in tables}
+    packed = {table[0]: table[3:5] for table in tables}
+    for level in levels:
+        if level not in operations:
+            sys.exit(f"Unknown EQ level {level} in {name}")
+    if len(levels) < 2:
+        sys.exit(f"{name} needs at least two EQ levels")
+
+    deltas = {"up": [], "down": []}
+    for previous, current in zip(levels, levels[1:]):
+        for direction, old, new in (("up", previous, current), ("down", current, previous)):
+            delta = step_delta(operations[old], operations[new])
+            full_bytes = i2c_bytes(operations[new])
+            if i2c_bytes(delta) >= full_bytes:
+                deltas[direction].append((old, new, *packed[new], full_bytes, None))
+                continue
+
+            start, length = packer.pack(merge_operations(delta))
+            registers = apply_writes(apply_writes({}, operations[old]), unpack(packer.blob, start, length))
+            if registers != apply_writes({}, operations[new]):
+                sys.exit(f"Delta from {old} to {new} doesn't give the registers of {new}")
+            deltas[direction].append((old, new, start, length, full_bytes, i2c_bytes(delta)))
+
+    if all(step[5] is None for direction in deltas.values() for step in direction):
+        sys.exit(f"No delta of {name} is smaller than the full level, load the levels instead")
+
+    return name, levels, deltas
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Pack TAS5805M/TAS5825P register configurations")
+    parser.add_argument("headers", nargs="+", help="headers with tasxxxx_cfg_reg_t arrays")
+    parser.add_argument("-o", "--output", required=True, help="generated header")
+    parser.add_argument("-n", "--name", default="tasxxxx_packed_config", help="name of the generated blob")
+    parser.add_argument(
+        "-s",
+        "--steps",
+        action="append",
+        default=[],
+        metavar="NAME=LEVEL,LEVEL,...",
+        help="arrays of the levels of an EQ control, in order, to pack as deltas between adjacent levels",
+    )
+    parser.add_argument(
+        "-g",
+        "--signature",
+        action="append",
+        default=[],
+        metavar="NAME=ARRAY",
+        help="words of an array no other array changes, to check that an amplifier kept the configuration",
+    )
+    parser.add_argument("-r", "--report", action="store_true", help="print the I2C bytes of every EQ step")
+    args = parser.parse_args()
+
+    packer = Packer()
+    tables = []
+    for header in args.headers:
+        for name, entries in parse_header(header):
+            operations = to_operations(entries)
+            start, length = packer.pack(merge_operations(operations))
+            tables.append((name, os.path.basename(header), len(entries), start, length, operations))
+
+    for name, _, _, start, length, operations in tables:
+        if register_writes(unpack(packer.blob, start, length)) != register_writes(operations):
+            sys.exit(f"Packing {name} doesn't give back the same register writes")
+
+    steps = [pack_steps(packer, tables, argument) for argument in args.steps]
+    signatures = []
+    for argument in args.signature:
+        name, _, array = argument.partition("=")
+        signatures.append((name, array, pick_signature(tables, array)))
+
+    lines = [
+        "// Generated by tasxxxx_pack_config.py, do not edit",
+        "#pragma once",
+        '#include "tasxxxx_packed_config.h"',
+        "",
+        f"static const uint8_t {args.name}_blob[] = {{",
+    ]
+    for j in range(0, len(packer.blob), 16):
+        lines.append("    " + " ".join(f"0x{byte:02X}," for byte in packer.blob[j : j + 16]))
+    lines += ["};", ""]
+
+    original_size = 0
+    for name, header, entry_count, start, length, _ in tables:
+        original_size += 2 * entry_count
+        lines.append(f"// {name} ({header}): {entry_count} entries ({2 * entry_count} bytes)")
+        lines.append(
+            f"static const tasxxxx_packed_config_t {name}_packed = {{{args.name}_blob, {start}, {length}}};"
+        )
+
+    for name, levels, deltas in steps:
+        lines += [
+            "",
+            f"// Deltas between the {len(levels)} levels of {levels[0]} .. {levels[-1]},",
+            "// with the I2C bytes of the delta and of the full level it replaces,",
+            "// or the full level when the delta isn't smaller",
+            f"#define {name.upper()}_COUNT {len(levels) - 1}",
+        ]
+        for direction in ("up", "down"):
+            lines.append(f"static const tasxxxx_packed_config_t {name}_{direction}[] = {{")
+            for _, new, start, length, full_bytes, delta_bytes in deltas[direction]:
+                if delta_bytes is None:
+                    comment = f"{new}: {full_bytes} bytes"
+                else:
+                    comment = f"-> {new}: {delta_bytes} ({full_bytes}) bytes"
+                lines.append(f"    {{{args.name}_blob, {start}, {length}}}, // {comment}")
+            lines.append("};")
+
+    for name, array, words in signatures:
+        lines += [
+            "",
+            f"// Words of {array} which no other configuration changes",
+            f"#define {name.upper()}_COUNT {len(words)}",
+            f"static const tasxxxx_packed_signature_t {name}[] = {{",
+        ]
+        for book, page, register, value in words:
+            value = ", ".join(f"0x{byte:02X}" for byte in value)
+            lines.append(f"    {{0x{book:02X}, 0x{page:02X}, 0x{register:02X}, {{{value}}}}},")
+        lines.append("};")
+
+    lines += ["", f"// {original_size} bytes of configuration packed into {len(packer.blob)} bytes", ""]
+
+    with open(args.output, "w") as f:
+        f.write("\n".join(lines))
+
+    if args.report:
+        for name, _, deltas in steps:
+            print(f"{name}: I2C bytes per step, full level -> delta")
+            for direction in ("up", "down"):
+                for old, new, _, _, full_bytes, delta_bytes in deltas[direction]:
+                    print(f"  {old} -> {new}: {full_bytes} -> {full_bytes if delta_bytes is None else delta_bytes}")
+            steps_bytes = [step for direction in ("up", "down") for step in deltas[direction]]
+            full = sum(step[4] for step in steps_bytes) / len(steps_bytes)
+            delta = sum(step[4] if step[5] is None else step[5] for step in steps_bytes) / len(steps_bytes)
+            print(f"  average: {full:.1f} -> {delta:.1f}")
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,216 @@
+#include "tasxxxx_packed_config.h"
+#include <stddef.h>
+#include <string.h>
+
+#define OP_BURST       0x80
+#define OP_DELAY       0xC0
+#define OP_BURST_BYTES 0xC1
+#define OP_SELECT      0xC2
+
+#define TOKEN_ZERO   0x40
+#define TOKEN_COPY   0x80
+#define TOKEN_REPEAT 0xC0
+
+#define REG_PAGE 0x00
+#define REG_BOOK 0x7F
+
+// Register 0x00 of every page changes the page, register 0x7F of page 0 changes the book
+static int select_book_and_page(tasxxxx_packed_config_write_fn_t write_fn, uint8_t i2c_address, uint8_t book,
+                                uint8_t page)
+{
+    if (write_fn(i2c_address, REG_PAGE, (const uint8_t[]){0x00}, 1) != 0 ||
+        write_fn(i2c_address, REG_BOOK, &book, 1) != 0 || write_fn(i2c_address, REG_PAGE, &page, 1) != 0)
+    {
+        return -2;
+    }
+    return 0;
+}
+
+// Decodes the word tokens of a burst into p_burst, returns the number of stream bytes used or -1 if malformed
+static int unpack_words(const tasxxxx_packed_config_t *p_config, const uint8_t *p_stream, size_t stream_length,
+                        uint8_t *p_burst, size_t length)
+{
+    size_t i = 0;
+    size_t n = 0;
+
+    while (n < length)
+    {
+        if (i >= stream_length)
+        {
+            return -1;
+        }
+
+        uint8_t token = p_stream[i++];
+        size_t  bytes = 4u * ((token & 0x3Fu) + 1u);
+
+        if (n + bytes > length)
+        {
+            return -1;
+        }
+
+        if (token < TOKEN_ZERO)
+        {
+            if (i + bytes > stream_length)
+            {
+                return -1;
+            }
+            memcpy(&p_burst[n], &p_stream[i], bytes);
+            i += bytes;
+        }
+        else if (token < TOKEN_COPY)
+        {
+            memset(&p_burst[n], 0, bytes);
+        }
+        else if (token < TOKEN_REPEAT)
+        {
+            if (i + 2 > stream_length)
+            {
+                return -1;
+            }
+            uint16_t offset = p_stream[i] | (p_stream[i + 1] << 8);
+            memcpy(&p_burst[n], &p_config->p_blob[offset], bytes);
+            i += 2;
+        }
+        else
+        {
+            if (n < 4)
+            {
+                return -1;
+            }
+            // Bounded by the burst length too, redundant with the check above but visible to the compiler
+            for (size_t j = n; j < n + bytes && j + 4 <= length; j += 4)
+            {
+                memcpy(&p_burst[j], &p_burst[n - 4], 4);
+            }
+        }
+        n += bytes;
+    }
+
+    return (int) i;
+}
+
+int tasxxxx_packed_config_load(const tasxxxx_packed_config_t *p_config, tasxxxx_packed_config_write_fn_t write_fn,
+                               tasxxxx_packed_config_delay_fn_t delay_fn, uint8_t i2c_address)
+{
+    // Bursts are sent from RAM, so they can be sent with DMA in a single transaction
+    uint8_t burst[TASXXXX_PACKED_CONFIG_MAX_BURST_LENGTH];
+
+    const uint8_t *p_stream = &p_config->p_blob[p_config->offset];
+    size_t         length   = p_config->length;
+    size_t         i        = 0;
+
+    while (i < length)
+    {
+        uint8_t op = p_stream[i++];
+
+        if (op < OP_BURST)
+        {
+            size_t count = op + 1u;
+            if (i + 2u * count > length)
+            {
+                return -1;
+            }
+            for (size_t j = 0; j < count; j++, i += 2)
+            {
+                if (write_fn(i2c_address, p_stream[i], &p_stream[i + 1], 1) != 0)
+                {
+                    return -2;
+                }
+            }
+        }
+        else if (op < OP_DELAY)
+        {
+            size_t burst_length = 4u * ((op & 0x3Fu) + 1u);
+            if (i >= length || burst_length > sizeof(burst))
+            {
+                return -1;
+            }
+
+            uint8_t register_address = p_stream[i++];
+            int     used             = unpack_words(p_config, &p_stream[i], length - i, burst, burst_length);
+            if (used < 0)
+            {
+                return -1;
+            }
+            i += used;
+
+            if (write_fn(i2c_address, register_address, burst, burst_length) != 0)
+            {
+                return -2;
+            }
+        }
+        else if (op == OP_DELAY)
+        {
+            if (i >= length)
+            {
+                return -1;
+            }
+            delay_fn(p_stream[i++]);
+        }
+        else if (op == OP_BURST_BYTES)
+        {
+            if (i + 2 > length || i + 2 + p_stream[i] > length || p_stream[i] > sizeof(burst))
+            {
+                return -1;
+            }
+
+            uint8_t burst_length = p_stream[i];
+            memcpy(burst, &p_stream[i + 2], burst_length);
+            if (write_fn(i2c_address, p_stream[i + 1], burst, burst_length) != 0)
+            {
+                return -2;
+            }
+            i += 2u + burst_length;
+        }
+        else if (op == OP_SELECT)
+        {
+            if (i + 2 > length)
+            {
+                return -1;
+            }
+
+            if (select_book_and_page(write_fn, i2c_address, p_stream[i], p_stream[i + 1]) != 0)
+            {
+                return -2;
+            }
+            i += 2;
+        }
+        else
+        {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int tasxxxx_packed_config_check_signature(const tasxxxx_packed_signature_t *p_signature, uint32_t count,
+                                          tasxxxx_packed_config_read_fn_t  read_fn,
+                                          tasxxxx_packed_config_write_fn_t write_fn, uint8_t i2c_address)
+{
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const tasxxxx_packed_signature_t *p_word = &p_signature[i];
+
+        if (i == 0 || p_word->book != p_signature[i - 1].book || p_word->page != p_signature[i - 1].page)
+        {
+            if (select_book_and_page(write_fn, i2c_address, p_word->book, p_word->page) != 0)
+            {
+                return -2;
+            }
+        }
+
+        uint8_t value[4];
+        if (read_fn(i2c_address, p_word->register_address, value, sizeof(value)) != 0)
+        {
+            return -2;
+        }
+
+        if (memcmp(value, p_word->value, sizeof(value)) != 0)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
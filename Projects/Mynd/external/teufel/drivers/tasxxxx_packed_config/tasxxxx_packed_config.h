@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Packed TAS5805M/TAS5825P register configuration, generated from the PPC3 exported register arrays by
+ * tasxxxx_pack_config.py.
+ *
+ * A configuration is a stream of operations:
+ *   0x00-0x7F  (n + 1) single register writes, followed by (register, value) pairs
+ *   0x80-0xBF  burst of (n + 1) 32-bit words, followed by the start register and word tokens
+ *   0xC0       delay, followed by the delay in ms
+ *   0xC1       burst of raw bytes, followed by the length, the start register and the bytes
+ *   0xC2       book/page selection, followed by the book and the page
+ *
+ * The words of a burst are given by tokens:
+ *   0x00-0x3F  (n + 1) words follow
+ *   0x40-0x7F  (n + 1) zero words
+ *   0x80-0xBF  (n + 1) words copied from the blob, the 16-bit little endian blob offset follows
+ *   0xC0-0xFF  the previous word repeated (n + 1) times
+ *
+ * The register writes are the same and in the same order as with the original arrays, but contiguous
+ * bursts are merged so every burst is sent in a single I2C transaction.
+ *
+ * A signature is a handful of 32-bit DSP words of a configuration which no other configuration changes. Reading
+ * them back tells whether an amplifier still holds the configuration, e.g. after it was kept in deep sleep.
+ */
+
+// A burst never goes past the last register of a page (0x7F)
+#define TASXXXX_PACKED_CONFIG_MAX_BURST_LENGTH 128
+
+typedef struct
+{
+    const uint8_t *p_blob; // Blob shared by all the configurations of a generated header
+    uint16_t       offset; // Start of the configuration in the blob
+    uint16_t       length;
+} tasxxxx_packed_config_t;
+
+typedef struct
+{
+    uint8_t book;
+    uint8_t page;
+    uint8_t register_address; // First register of the word
+    uint8_t value[4];
+} tasxxxx_packed_signature_t;
+
+typedef int (*tasxxxx_packed_config_read_fn_t)(uint8_t i2c_address, uint8_t register_address, uint8_t *p_data,
+                                               uint32_t length);
+typedef int (*tasxxxx_packed_config_write_fn_t)(uint8_t i2c_address, uint8_t register_address, const uint8_t *p_data,
+                                                uint32_t length);
+typedef void (*tasxxxx_packed_config_delay_fn_t)(uint32_t ms);
+
+/**
+ * @brief Writes a packed configuration to an amplifier, each burst in a single I2C write.
+ *
+ * @param[in] p_config          packed configuration
+ * @param[in] write_fn          I2C write function of the amplifier driver
+ * @param[in] delay_fn          delay function of the amplifier driver
+ * @param[in] i2c_address       I2C address of the amplifier
+ *
+ * @return 0 if successful, -1 if the configuration is malformed, -2 if an I2C write failed
+ */
+int tasxxxx_packed_config_load(const tasxxxx_packed_config_t *p_config, tasxxxx_packed_config_write_fn_t write_fn,
+                               tasxxxx_packed_config_delay_fn_t delay_fn, uint8_t i2c_address);
+
+/**
+ * @brief Reads back the words of a signature from an amplifier, the book/page is only selected when it changes.
+ *
+ * @param[in] p_signature       signature words
+ * @param[in] count             number of signature words
+ * @param[in] read_fn           I2C read function of the amplifier driver
+ * @param[in] write_fn          I2C write function of the amplifier driver
+ * @param[in] i2c_address       I2C address of the amplifier
+ *
+ * @return 0 if all the words match, 1 if a word differs, -2 if an I2C transfer failed
+ */
+int tasxxxx_packed_config_check_signature(const tasxxxx_packed_signature_t *p_signature, uint32_t count,
+                                          tasxxxx_packed_config_read_fn_t  read_fn,
+                                          tasxxxx_packed_config_write_fn_t write_fn, uint8_t i2c_address);
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// Register map of a TAS5825P/TAS5805M for the host tests: register 0x00 of every page selects the page, register 0x7F
+// of page 0 the book. The registers are kept in deep sleep and lost when the amplifier is powered down. The writes
+// are recorded as (register, data), one entry per I2C transaction.
+class TasRegisterModel
+{
+  public:
+    using Bytes = std::vector<uint8_t>;
+
+    int write(uint8_t register_address, const uint8_t *p_data, uint32_t length)
+    {
+        if (fail)
+        {
+            return -1;
+        }
+
+        writes.emplace_back(register_address, Bytes(p_data, p_data + length));
+        for (uint32_t i = 0; i < length; i++)
+        {
+            const uint8_t address = static_cast<uint8_t>(register_address + i);
+            if (address == 0x00)
+            {
+                page = p_data[i];
+            }
+            else if (address == 0x7F && page == 0x00)
+            {
+                book = p_data[i];
+            }
+            else
+            {
+                registers[{book, page, address}] = p_data[i];
+            }
+        }
+        return 0;
+    }
+
+    int read(uint8_t register_address, uint8_t *p_data, uint32_t length)
+    {
+        reads++;
+        if (fail)
+        {
+            return -1;
+        }
+
+        for (uint32_t i = 0; i < length; i++)
+        {
+            auto it   = registers.find({book, page, static_cast<uint8_t>(register_address + i)});
+            p_data[i] = (it != registers.end()) ? it->second : 0;
+        }
+        return 0;
+    }
+
+    // The power down pin was toggled
+    void power_down()
+    {
+        registers.clear();
+        book = 0;
+        page = 0;
+    }
+
+    std::map<std::tuple<uint8_t, uint8_t, uint8_t>, uint8_t> registers; // (book, page, register)
+    std::vector<std::pair<uint8_t, Bytes>>                   writes;
+
+    uint8_t  book  = 0;
+    uint8_t  page  = 0;
+    unsigned reads = 0;
+    bool     fail  = false;
+};
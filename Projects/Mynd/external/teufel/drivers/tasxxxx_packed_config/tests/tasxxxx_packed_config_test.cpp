@@ -0,0 +1,207 @@
+#include <cstdint>
+#include <map>
+#include <tuple>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "tasxxxx_packed_config.h"
+}
+
+#include "tas_register_model.h"
+
+using Bytes = std::vector<uint8_t>;
+using Write = std::tuple<uint8_t, uint8_t, Bytes>; // I2C address, register, data
+
+static std::vector<Write>    s_writes;
+static std::vector<uint32_t> s_delays;
+static int                   s_fail_after = -1;
+
+static int write_fn(uint8_t i2c_address, uint8_t register_address, const uint8_t *p_data, uint32_t length)
+{
+    if (s_fail_after >= 0 && static_cast<int>(s_writes.size()) >= s_fail_after)
+    {
+        return -1;
+    }
+    s_writes.emplace_back(i2c_address, register_address, Bytes(p_data, p_data + length));
+    return 0;
+}
+
+static void delay_fn(uint32_t ms)
+{
+    s_delays.push_back(ms);
+}
+
+class TasxxxxPackedConfigTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        s_writes.clear();
+        s_delays.clear();
+        s_fail_after = -1;
+    }
+
+    int load(const Bytes &blob, uint16_t offset = 0)
+    {
+        tasxxxx_packed_config_t config = {blob.data(), offset, static_cast<uint16_t>(blob.size() - offset)};
+        return tasxxxx_packed_config_load(&config, write_fn, delay_fn, 0x4C);
+    }
+};
+
+TEST_F(TasxxxxPackedConfigTest, SingleWritesAndDelay)
+{
+    Bytes blob = {0x01, 0x02, 0x11, 0x03, 0x02, 0xC0, 0x05};
+
+    EXPECT_EQ(load(blob), 0);
+    ASSERT_EQ(s_writes.size(), 2u);
+    EXPECT_EQ(s_writes[0], Write(0x4C, 0x02, Bytes{0x11}));
+    EXPECT_EQ(s_writes[1], Write(0x4C, 0x03, Bytes{0x02}));
+    EXPECT_EQ(s_delays, std::vector<uint32_t>{5});
+}
+
+TEST_F(TasxxxxPackedConfigTest, BookPageSelection)
+{
+    Bytes blob = {0xC2, 0x8C, 0x2B};
+
+    EXPECT_EQ(load(blob), 0);
+    ASSERT_EQ(s_writes.size(), 3u);
+    EXPECT_EQ(s_writes[0], Write(0x4C, 0x00, Bytes{0x00}));
+    EXPECT_EQ(s_writes[1], Write(0x4C, 0x7F, Bytes{0x8C}));
+    EXPECT_EQ(s_writes[2], Write(0x4C, 0x00, Bytes{0x2B}));
+}
+
+TEST_F(TasxxxxPackedConfigTest, BurstIsSentInOneWrite)
+{
+    // Two literal words, two zero words, the previous word repeated twice
+    Bytes blob = {0x85, 0x18, 0x01, 1, 2, 3, 4, 5, 6, 7, 8, 0x41, 0xC1};
+
+    EXPECT_EQ(load(blob), 0);
+    ASSERT_EQ(s_writes.size(), 1u);
+    EXPECT_EQ(s_writes[0], Write(0x4C, 0x18, Bytes{1, 2, 3, 4, 5, 6, 7, 8, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                   0, 0}));
+}
+
+TEST_F(TasxxxxPackedConfigTest, BurstCopiesWordsFromBlob)
+{
+    // The second configuration of the blob copies the words of the first one
+    Bytes blob = {0x80, 0x30, 0x00, 0xAA, 0xBB, 0xCC, 0xDD, 0x80, 0x40, 0x80, 0x03, 0x00};
+
+    EXPECT_EQ(load(blob, 7), 0);
+    ASSERT_EQ(s_writes.size(), 1u);
+    EXPECT_EQ(s_writes[0], Write(0x4C, 0x40, Bytes{0xAA, 0xBB, 0xCC, 0xDD}));
+}
+
+TEST_F(TasxxxxPackedConfigTest, RawBurst)
+{
+    Bytes blob = {0xC1, 0x03, 0x54, 0x01, 0x02, 0x03};
+
+    EXPECT_EQ(load(blob), 0);
+    ASSERT_EQ(s_writes.size(), 1u);
+    EXPECT_EQ(s_writes[0], Write(0x4C, 0x54, Bytes{0x01, 0x02, 0x03}));
+}
+
+TEST_F(TasxxxxPackedConfigTest, MalformedConfiguration)
+{
+    // Truncated writes, burst tokens past the burst length, repeat without previous word, unknown opcode
+    EXPECT_EQ(load(Bytes{0x01, 0x02, 0x11, 0x03}), -1);
+    EXPECT_EQ(load(Bytes{0x80, 0x18, 0x41}), -1);
+    EXPECT_EQ(load(Bytes{0x80, 0x18, 0xC0}), -1);
+    EXPECT_EQ(load(Bytes{0xC1, 0x81, 0x18}), -1);
+    EXPECT_EQ(load(Bytes{0xC3}), -1);
+    EXPECT_TRUE(s_writes.empty());
+}
+
+TEST_F(TasxxxxPackedConfigTest, WriteFailureStopsLoading)
+{
+    Bytes blob = {0x02, 0x02, 0x11, 0x03, 0x02, 0x04, 0x00};
+
+    s_fail_after = 1;
+    EXPECT_EQ(load(blob), -2);
+    EXPECT_EQ(s_writes.size(), 1u);
+}
+
+static TasRegisterModel s_amp;
+
+static int model_write_fn(uint8_t, uint8_t register_address, const uint8_t *p_data, uint32_t length)
+{
+    return s_amp.write(register_address, p_data, length);
+}
+
+static int model_read_fn(uint8_t, uint8_t register_address, uint8_t *p_data, uint32_t length)
+{
+    return s_amp.read(register_address, p_data, length);
+}
+
+// A configuration on two DSP pages, an EQ level on a third page, and words of the configuration as its signature
+static const Bytes c_blob = {
+    0xC2, 0x8C, 0x2C, 0x83, 0x08, 0x03, 0x00, 0x03, 0x69, 0xD0, 0x7A, 0xC6, 0xB8, 0x5A, 0x08, 0x00, 0x00, 0x00, 0x01,
+    0x02, 0x03, 0x04, 0xC2, 0xAA, 0x24, 0x80, 0x40, 0x00, 0x07, 0xCE, 0xEF, 0xFB, // Configuration
+    0xC2, 0xAA, 0x03, 0x80, 0x18, 0x00, 0x11, 0x22, 0x33, 0x44,                   // EQ level
+};
+
+static const tasxxxx_packed_config_t c_config   = {c_blob.data(), 0, 32};
+static const tasxxxx_packed_config_t c_eq_level = {c_blob.data(), 32, 10};
+
+static const tasxxxx_packed_signature_t c_signature[] = {
+    {0x8C, 0x2C, 0x08, {0x00, 0x03, 0x69, 0xD0}},
+    {0x8C, 0x2C, 0x14, {0x01, 0x02, 0x03, 0x04}},
+    {0xAA, 0x24, 0x40, {0x07, 0xCE, 0xEF, 0xFB}},
+};
+
+class TasxxxxPackedSignatureTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        s_amp = TasRegisterModel();
+        ASSERT_EQ(tasxxxx_packed_config_load(&c_config, model_write_fn, delay_fn, 0x4C), 0);
+        ASSERT_EQ(tasxxxx_packed_config_load(&c_eq_level, model_write_fn, delay_fn, 0x4C), 0);
+    }
+
+    static int check()
+    {
+        return tasxxxx_packed_config_check_signature(c_signature, 3, model_read_fn, model_write_fn, 0x4C);
+    }
+};
+
+TEST_F(TasxxxxPackedSignatureTest, RetainedConfigurationMatches)
+{
+    // Deep sleep keeps the registers, the EQ level isn't part of the signature
+    const auto registers = s_amp.registers;
+    s_amp.writes.clear();
+    s_amp.reads = 0;
+
+    EXPECT_EQ(check(), 0);
+    EXPECT_EQ(s_amp.registers, registers);
+
+    // The book/page is selected once per page
+    EXPECT_EQ(s_amp.writes.size(), 6u);
+    EXPECT_EQ(s_amp.reads, 3u);
+}
+
+TEST_F(TasxxxxPackedSignatureTest, LostConfigurationMismatches)
+{
+    s_amp.power_down();
+    EXPECT_EQ(check(), 1);
+
+    ASSERT_EQ(tasxxxx_packed_config_load(&c_config, model_write_fn, delay_fn, 0x4C), 0);
+    EXPECT_EQ(check(), 0);
+}
+
+TEST_F(TasxxxxPackedSignatureTest, ChangedWordMismatches)
+{
+    // Another configuration wrote a word of the signature
+    const Bytes                   blob   = {0xC2, 0xAA, 0x24, 0x80, 0x40, 0x00, 0x07, 0xCE, 0xEF, 0xFA};
+    const tasxxxx_packed_config_t config = {blob.data(), 0, static_cast<uint16_t>(blob.size())};
+    ASSERT_EQ(tasxxxx_packed_config_load(&config, model_write_fn, delay_fn, 0x4C), 0);
+
+    EXPECT_EQ(check(), 1);
+}
+
+TEST_F(TasxxxxPackedSignatureTest, ReadFailure)
+{
+    s_amp.fail = true;
+    EXPECT_EQ(check(), -2);
+}
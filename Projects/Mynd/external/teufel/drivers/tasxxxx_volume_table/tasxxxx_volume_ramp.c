@@ -0,0 +1,71 @@
+#include "tasxxxx_volume_ramp.h"
+
+static int16_t clamp_volume(int16_t volume)
+{
+    if (volume < TASXXXX_VOLUME_MUTE)
+    {
+        return TASXXXX_VOLUME_MUTE;
+    }
+    else if (volume > TASXXXX_VOLUME_MAX)
+    {
+        return TASXXXX_VOLUME_MAX;
+    }
+    return volume;
+}
+
+void tasxxxx_volume_ramp_init(tasxxxx_volume_ramp_t *p_ramp, int16_t step, uint32_t period_ms, int16_t volume)
+{
+    p_ramp->step      = (step > 0) ? step : 1;
+    p_ramp->period_ms = (period_ms > 0) ? period_ms : 1;
+    p_ramp->step_ms   = 0;
+    tasxxxx_volume_ramp_set_volume(p_ramp, volume);
+}
+
+void tasxxxx_volume_ramp_set_target(tasxxxx_volume_ramp_t *p_ramp, int16_t target, uint32_t now_ms)
+{
+    if (!tasxxxx_volume_ramp_is_running(p_ramp))
+    {
+        p_ramp->step_ms = now_ms - p_ramp->period_ms;
+    }
+    p_ramp->target = clamp_volume(target);
+}
+
+void tasxxxx_volume_ramp_set_volume(tasxxxx_volume_ramp_t *p_ramp, int16_t volume)
+{
+    p_ramp->volume = clamp_volume(volume);
+    p_ramp->target = p_ramp->volume;
+}
+
+bool tasxxxx_volume_ramp_is_running(const tasxxxx_volume_ramp_t *p_ramp)
+{
+    return p_ramp->volume != p_ramp->target;
+}
+
+bool tasxxxx_volume_ramp_update(tasxxxx_volume_ramp_t *p_ramp, uint32_t now_ms)
+{
+    if (!tasxxxx_volume_ramp_is_running(p_ramp))
+    {
+        return false;
+    }
+
+    uint32_t steps = (now_ms - p_ramp->step_ms) / p_ramp->period_ms;
+    if (steps == 0)
+    {
+        return false;
+    }
+    p_ramp->step_ms += steps * p_ramp->period_ms;
+
+    // The volume range is less than 2^12, the change is capped before it could overflow
+    int32_t distance = (int32_t) p_ramp->target - p_ramp->volume;
+    int32_t change   = (steps < 0x1000u) ? (int32_t) steps * p_ramp->step : INT32_MAX;
+
+    if (distance > 0)
+    {
+        p_ramp->volume = (int16_t) ((change < distance) ? p_ramp->volume + change : p_ramp->target);
+    }
+    else
+    {
+        p_ramp->volume = (int16_t) ((change < -distance) ? p_ramp->volume - change : p_ramp->target);
+    }
+    return true;
+}
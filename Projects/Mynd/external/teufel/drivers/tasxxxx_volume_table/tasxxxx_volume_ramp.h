@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "tasxxxx_volume_table.h"
+
+// Moves the volume of the amps towards a target in fine steps, one step per period. The steps only depend on the time:
+// the target may change at any rate, and an update which comes late catches up with a single larger step, so there
+// is never more than one write per amp and update.
+typedef struct
+{
+    int16_t  volume;    // Volume of the last step, in 1/TASXXXX_VOLUME_STEPS_PER_DB dB
+    int16_t  target;    // Volume the ramp goes to
+    int16_t  step;      // Volume change per period
+    uint32_t period_ms; // Time between two steps
+    uint32_t step_ms;   // Time of the last step
+} tasxxxx_volume_ramp_t;
+
+/**
+ * @brief Initializes the ramp, without running it.
+ *
+ * @param[out] p_ramp       ramp
+ * @param[in] step          volume change per period, in 1/TASXXXX_VOLUME_STEPS_PER_DB dB
+ * @param[in] period_ms     time between two steps
+ * @param[in] volume        volume the amps are at
+ */
+void tasxxxx_volume_ramp_init(tasxxxx_volume_ramp_t *p_ramp, int16_t step, uint32_t period_ms, int16_t volume);
+
+/**
+ * @brief Sets the volume the ramp goes to, from the volume it is at.
+ *
+ * @details A ramp which wasn't running takes its first step at the next update.
+ *
+ * @param[in] p_ramp        ramp
+ * @param[in] target        volume in 1/TASXXXX_VOLUME_STEPS_PER_DB dB, clamped to mute and TASXXXX_VOLUME_MAX
+ * @param[in] now_ms        current time
+ */
+void tasxxxx_volume_ramp_set_target(tasxxxx_volume_ramp_t *p_ramp, int16_t target, uint32_t now_ms);
+
+/**
+ * @brief Sets the volume the amps are at, e.g. after they were reset, and stops the ramp there.
+ */
+void tasxxxx_volume_ramp_set_volume(tasxxxx_volume_ramp_t *p_ramp, int16_t volume);
+
+bool tasxxxx_volume_ramp_is_running(const tasxxxx_volume_ramp_t *p_ramp);
+
+/**
+ * @brief Takes the steps due since the last one.
+ *
+ * @param[in] p_ramp        ramp
+ * @param[in] now_ms        current time
+ *
+ * @return true if the volume changed and must be written to the amps, false otherwise
+ */
+bool tasxxxx_volume_ramp_update(tasxxxx_volume_ramp_t *p_ramp, uint32_t now_ms);
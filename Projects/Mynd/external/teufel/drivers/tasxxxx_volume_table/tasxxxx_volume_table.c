@@ -128,6 +128,42 @@ const uint8_t * tasxxxx_volume_get_data_for_db(int8_t volume_db)
     }
     else
     {
-        return tasxxxx_volume_table[volume_db + 90];
+        // The first entry is the mute, -90 dB is the second one
+        return tasxxxx_volume_table[volume_db + 91];
     }
 }
+
+static uint32_t coefficient_of(const uint8_t *p_data)
+{
+    return ((uint32_t) p_data[0] << 24) | ((uint32_t) p_data[1] << 16) | ((uint32_t) p_data[2] << 8) | p_data[3];
+}
+
+uint32_t tasxxxx_volume_get_coefficient(int16_t volume)
+{
+    if (volume < TASXXXX_VOLUME_MIN)
+    {
+        return 0;
+    }
+    else if (volume >= TASXXXX_VOLUME_MAX)
+    {
+        return coefficient_of(tasxxxx_volume_table[111]);
+    }
+
+    // Whole dB above -90 dB and the fraction of a dB, both positive
+    uint32_t offset   = (uint32_t) (volume - TASXXXX_VOLUME_MIN);
+    uint32_t index    = 1 + offset / TASXXXX_VOLUME_STEPS_PER_DB;
+    uint32_t fraction = offset % TASXXXX_VOLUME_STEPS_PER_DB;
+
+    // The coefficients differ by less than 2^24 between two dB, the product fits in 32 bit
+    uint32_t low  = coefficient_of(tasxxxx_volume_table[index]);
+    uint32_t high = coefficient_of(tasxxxx_volume_table[index + 1]);
+    return low + ((high - low) * fraction) / TASXXXX_VOLUME_STEPS_PER_DB;
+}
+
+void tasxxxx_volume_coefficient_to_data(uint32_t coefficient, uint8_t *p_data)
+{
+    p_data[0] = (uint8_t) (coefficient >> 24);
+    p_data[1] = (uint8_t) (coefficient >> 16);
+    p_data[2] = (uint8_t) (coefficient >> 8);
+    p_data[3] = (uint8_t) coefficient;
+}
@@ -2,4 +2,27 @@
 
 #include <stdint.h>
 
+// Fine volume, in 1/TASXXXX_VOLUME_STEPS_PER_DB dB: from -90 dB to +20 dB, anything below is muted (-infinite dB)
+#define TASXXXX_VOLUME_STEPS_PER_DB (16)
+#define TASXXXX_VOLUME_MIN          (-90 * TASXXXX_VOLUME_STEPS_PER_DB)
+#define TASXXXX_VOLUME_MAX          (20 * TASXXXX_VOLUME_STEPS_PER_DB)
+#define TASXXXX_VOLUME_MUTE         (TASXXXX_VOLUME_MIN - 1)
+
 const uint8_t * tasxxxx_volume_get_data_for_db(int8_t volume_db);
+
+/**
+ * @brief Gets the gain coefficient (format 9.23) of a fine volume.
+ *
+ * @details The coefficients between the whole dB of the table are interpolated linearly. With the rounding of the
+ *          table words, they are less than 0.02 dB off the logarithmic curve. At the whole dB they are the table words.
+ *
+ * @param[in] volume        volume in 1/TASXXXX_VOLUME_STEPS_PER_DB dB
+ *
+ * @return gain coefficient
+ */
+uint32_t tasxxxx_volume_get_coefficient(int16_t volume);
+
+/**
+ * @brief Converts a gain coefficient to the 4 bytes of its DSP memory word (big endian).
+ */
+void tasxxxx_volume_coefficient_to_data(uint32_t coefficient, uint8_t *p_data);
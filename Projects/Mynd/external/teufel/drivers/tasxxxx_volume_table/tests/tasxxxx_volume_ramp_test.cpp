@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "tasxxxx_volume_ramp.h"
+#include "tasxxxx_volume_table.h"
+}
+
+constexpr int16_t c_steps_per_db = TASXXXX_VOLUME_STEPS_PER_DB;
+constexpr int16_t c_quarter_db   = c_steps_per_db / 4;
+
+static uint32_t coefficient_of_table(int8_t volume_db)
+{
+    const uint8_t *p_data = tasxxxx_volume_get_data_for_db(volume_db);
+    return (uint32_t{p_data[0]} << 24) | (uint32_t{p_data[1]} << 16) | (uint32_t{p_data[2]} << 8) | p_data[3];
+}
+
+static double db_of(uint32_t coefficient)
+{
+    return 20.0 * std::log10(coefficient / static_cast<double>(1u << 23));
+}
+
+TEST(TasxxxxVolumeTable, WholeDbAreTheTable)
+{
+    for (int volume_db = -90; volume_db <= 20; volume_db++)
+    {
+        const int16_t volume = static_cast<int16_t>(volume_db * c_steps_per_db);
+        EXPECT_EQ(tasxxxx_volume_get_coefficient(volume), coefficient_of_table(static_cast<int8_t>(volume_db)))
+            << volume_db << " dB";
+
+        uint8_t data[4];
+        tasxxxx_volume_coefficient_to_data(tasxxxx_volume_get_coefficient(volume), data);
+        EXPECT_EQ(std::memcmp(data, tasxxxx_volume_get_data_for_db(static_cast<int8_t>(volume_db)), sizeof(data)), 0);
+    }
+
+    EXPECT_EQ(tasxxxx_volume_get_coefficient(TASXXXX_VOLUME_MUTE), 0u);
+    EXPECT_EQ(tasxxxx_volume_get_coefficient(INT16_MIN), 0u);
+    EXPECT_EQ(tasxxxx_volume_get_coefficient(INT16_MAX), coefficient_of_table(20));
+}
+
+TEST(TasxxxxVolumeTable, FineStepsAreMonotonicAndAccurate)
+{
+    double max_error_db = 0.0;
+
+    for (int32_t volume = TASXXXX_VOLUME_MIN; volume < TASXXXX_VOLUME_MAX; volume++)
+    {
+        const uint32_t coefficient = tasxxxx_volume_get_coefficient(static_cast<int16_t>(volume));
+        EXPECT_LT(coefficient, tasxxxx_volume_get_coefficient(static_cast<int16_t>(volume + 1))) << volume;
+
+        // The rounding of the table words dominates at the lowest levels
+        const double error_db = std::fabs(db_of(coefficient) - volume / static_cast<double>(c_steps_per_db));
+        max_error_db          = std::max(max_error_db, error_db);
+        EXPECT_LT(error_db, (volume < -60 * c_steps_per_db) ? 0.05 : 0.02) << volume;
+    }
+
+    std::printf("Max error %.4f dB\n", max_error_db);
+}
+
+// Volumes written by a ramp updated every update_ms until it is done, with the target set at 0 ms
+static std::vector<int16_t> run(tasxxxx_volume_ramp_t &ramp, int16_t target, uint32_t update_ms,
+                                std::vector<uint32_t> *p_times = nullptr)
+{
+    std::vector<int16_t> volumes;
+    uint32_t             now_ms = 1000;
+
+    tasxxxx_volume_ramp_set_target(&ramp, target, now_ms);
+    while (tasxxxx_volume_ramp_is_running(&ramp) && volumes.size() < 10000)
+    {
+        if (tasxxxx_volume_ramp_update(&ramp, now_ms))
+        {
+            volumes.push_back(ramp.volume);
+            if (p_times != nullptr)
+            {
+                p_times->push_back(now_ms - 1000);
+            }
+        }
+        now_ms += update_ms;
+    }
+    return volumes;
+}
+
+TEST(TasxxxxVolumeRamp, StepsAreMonotonicAndReachTheTarget)
+{
+    tasxxxx_volume_ramp_t ramp;
+    tasxxxx_volume_ramp_init(&ramp, c_quarter_db, 5, -30 * c_steps_per_db);
+
+    std::vector<uint32_t> times;
+    auto                  volumes = run(ramp, -20 * c_steps_per_db, 1, &times);
+
+    // 10 dB in 0.25 dB steps, the first one right away and then one every period
+    ASSERT_EQ(volumes.size(), 40u);
+    EXPECT_EQ(volumes.back(), -20 * c_steps_per_db);
+    for (size_t i = 0; i < volumes.size(); i++)
+    {
+        EXPECT_EQ(volumes[i], -30 * c_steps_per_db + static_cast<int16_t>(i + 1) * c_quarter_db);
+        EXPECT_EQ(times[i], i * 5u);
+    }
+
+    // And back down to mute
+    volumes = run(ramp, TASXXXX_VOLUME_MUTE, 1);
+    for (size_t i = 1; i < volumes.size(); i++)
+    {
+        EXPECT_LT(volumes[i], volumes[i - 1]);
+        EXPECT_LE(volumes[i - 1] - volumes[i], c_quarter_db);
+    }
+    EXPECT_EQ(volumes.back(), TASXXXX_VOLUME_MUTE);
+    EXPECT_EQ(tasxxxx_volume_get_coefficient(volumes.back()), 0u);
+}
+
+TEST(TasxxxxVolumeRamp, LateUpdatesCatchUp)
+{
+    tasxxxx_volume_ramp_t fine;
+    tasxxxx_volume_ramp_t late;
+    tasxxxx_volume_ramp_init(&fine, c_quarter_db, 5, 0);
+    tasxxxx_volume_ramp_init(&late, c_quarter_db, 5, 0);
+
+    std::vector<uint32_t> fine_times;
+    std::vector<uint32_t> late_times;
+    const auto            fine_volumes = run(fine, -10 * c_steps_per_db, 1, &fine_times);
+    const auto            late_volumes = run(late, -10 * c_steps_per_db, 17, &late_times);
+
+    // The ramp takes as long, with fewer and larger steps
+    EXPECT_LT(late_volumes.size(), fine_volumes.size());
+    EXPECT_LE(late_times.back(), fine_times.back() + 17u);
+    for (size_t i = 1; i < late_volumes.size(); i++)
+    {
+        EXPECT_LT(late_volumes[i], late_volumes[i - 1]);
+        EXPECT_LE(late_volumes[i - 1] - late_volumes[i], 4 * c_quarter_db);
+    }
+}
+
+TEST(TasxxxxVolumeRamp, TargetChangesDontAddSteps)
+{
+    tasxxxx_volume_ramp_t ramp;
+    tasxxxx_volume_ramp_init(&ramp, c_quarter_db, 5, -40 * c_steps_per_db);
+
+    // A held volume button, the target goes up by 0.5 dB every millisecond
+    unsigned writes = 0;
+    int16_t  target = -40 * c_steps_per_db;
+    for (uint32_t now_ms = 0; now_ms < 100; now_ms++)
+    {
+        target = static_cast<int16_t>(target + 2 * c_quarter_db);
+        tasxxxx_volume_ramp_set_target(&ramp, target, now_ms);
+
+        const int16_t volume = ramp.volume;
+        if (tasxxxx_volume_ramp_update(&ramp, now_ms))
+        {
+            writes++;
+            EXPECT_EQ(ramp.volume - volume, c_quarter_db);
+        }
+    }
+
+    EXPECT_EQ(writes, 20u);
+    EXPECT_TRUE(tasxxxx_volume_ramp_is_running(&ramp));
+
+    // The ramp reverses from where it is when the target goes the other way
+    const int16_t volume = ramp.volume;
+    tasxxxx_volume_ramp_set_target(&ramp, -40 * c_steps_per_db, 100);
+    ASSERT_TRUE(tasxxxx_volume_ramp_update(&ramp, 100));
+    EXPECT_EQ(ramp.volume, volume - c_quarter_db);
+}
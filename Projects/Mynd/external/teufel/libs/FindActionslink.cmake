@@ -24,6 +24,8 @@ if(NOT (TARGET Actionslink))
             "${Actionslink_PATH}/src/transport/actionslink_bt_ll.h"
             "${Actionslink_PATH}/src/transport/actionslink_bt_ul.c"
             "${Actionslink_PATH}/src/transport/actionslink_bt_ul.h"
+            "${Actionslink_PATH}/src/transport/actionslink_hdlc.c"
+            "${Actionslink_PATH}/src/transport/actionslink_hdlc.h"
             "${Actionslink_PATH}/src/utils/actionslink_utils.c"
             "${Actionslink_PATH}/src/utils/actionslink_utils.h")
     target_include_directories(Actionslink INTERFACE "${Actionslink_PATH}/src/api")
@@ -72,6 +74,53 @@ if(NOT (TARGET Actionslink::LogLevelTrace))
     target_link_libraries(Actionslink::LogLevelTrace INTERFACE Actionslink)
 endif()
 
+# The transport tests need the nanopb generated headers (message.pb.h) in the include path of the consumer
+if(NOT (TARGET Actionslink::Tests))
+    add_library(Actionslink::Tests INTERFACE IMPORTED)
+    target_sources(Actionslink::Tests INTERFACE
+            "${Actionslink_PATH}/src/log/actionslink_log.c"
+            "${Actionslink_PATH}/src/transport/actionslink_bt_ul.c"
+            "${Actionslink_PATH}/src/transport/actionslink_hdlc.c"
+            "${Actionslink_PATH}/src/utils/actionslink_utils.c"
+            "${Actionslink_PATH}/tests/actionslink_bt_ul_test.cpp"
+            "${Actionslink_PATH}/tests/actionslink_hdlc_test.cpp")
+    target_include_directories(Actionslink::Tests INTERFACE "${Actionslink_PATH}/src/api")
+    target_include_directories(Actionslink::Tests INTERFACE "${Actionslink_PATH}/src/log")
+    target_include_directories(Actionslink::Tests INTERFACE "${Actionslink_PATH}/src/transport")
+    target_include_directories(Actionslink::Tests INTERFACE "${Actionslink_PATH}/src/utils")
+    target_compile_definitions(Actionslink::Tests INTERFACE "-DACTIONSLINK_LOG_LEVEL=0")
+endif()
+
+# Host side emulator of the Actions module, see src/emulator/actionslink_emulator.h
+if(NOT (TARGET Actionslink::Emulator))
+    add_library(Actionslink::Emulator INTERFACE IMPORTED)
+    target_sources(Actionslink::Emulator INTERFACE
+            "${Actionslink_PATH}/src/emulator/actionslink_emulator.c"
+            "${Actionslink_PATH}/src/emulator/actionslink_emulator.h")
+    target_include_directories(Actionslink::Emulator INTERFACE "${Actionslink_PATH}/src/emulator")
+    target_link_libraries(Actionslink::Emulator INTERFACE Actionslink)
+endif()
+
+# The real transport against the emulator, kept apart from Actionslink::Tests which replaces the lower layer. Built
+# by Projects/Mynd/sim/CMakeLists.txt, which generates the nanopb sources.
+if(NOT (TARGET Actionslink::EmulatorTests))
+    add_library(Actionslink::EmulatorTests INTERFACE IMPORTED)
+    target_sources(Actionslink::EmulatorTests INTERFACE
+            "${Actionslink_PATH}/src/emulator/actionslink_emulator.c"
+            "${Actionslink_PATH}/src/log/actionslink_log.c"
+            "${Actionslink_PATH}/src/transport/actionslink_bt_ll.c"
+            "${Actionslink_PATH}/src/transport/actionslink_bt_ul.c"
+            "${Actionslink_PATH}/src/transport/actionslink_hdlc.c"
+            "${Actionslink_PATH}/src/utils/actionslink_utils.c"
+            "${Actionslink_PATH}/tests/actionslink_emulator_test.cpp")
+    target_include_directories(Actionslink::EmulatorTests INTERFACE "${Actionslink_PATH}/src/api")
+    target_include_directories(Actionslink::EmulatorTests INTERFACE "${Actionslink_PATH}/src/emulator")
+    target_include_directories(Actionslink::EmulatorTests INTERFACE "${Actionslink_PATH}/src/log")
+    target_include_directories(Actionslink::EmulatorTests INTERFACE "${Actionslink_PATH}/src/transport")
+    target_include_directories(Actionslink::EmulatorTests INTERFACE "${Actionslink_PATH}/src/utils")
+    target_compile_definitions(Actionslink::EmulatorTests INTERFACE "-DACTIONSLINK_LOG_LEVEL=0")
+endif()
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(Actionslink
         FOUND_VAR Actionslink_FOUND
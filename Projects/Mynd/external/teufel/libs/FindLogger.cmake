@@ -18,6 +18,7 @@ if(NOT (TARGET Logger))
     target_sources(Logger INTERFACE
         "${Logger_PATH}/logger.h"
         "${Logger_PATH}/logger.c"
+        "${Logger_PATH}/logger_binary.c"
         "${Logger_PATH}/implementations/logger_weak_implementation.c"
     )
 endif()
@@ -42,6 +43,14 @@ if(NOT (TARGET Logger::Config2))
     target_link_libraries(Logger::Config2 INTERFACE Logger)
 endif()
 
+# Binary output, decoded on the host by tools/logger_decode.py
+if(NOT (TARGET Logger::Config3))
+    add_library(Logger::Config3 INTERFACE IMPORTED)
+    target_include_directories(Logger::Config3 INTERFACE "${Logger_PATH}/configs/num3")
+    target_compile_definitions(Logger::Config3 INTERFACE "-DLOGGER_BINARY")
+    target_link_libraries(Logger::Config3 INTERFACE Logger)
+endif()
+
 if(NOT (TARGET Logger::ConfigOff))
     add_library(Logger::ConfigOff INTERFACE IMPORTED)
     target_include_directories(Logger::ConfigOff INTERFACE "${Logger_PATH}/configs/off")
@@ -68,6 +77,30 @@ if(NOT (TARGET Logger::Format3))
     target_link_libraries(Logger::Format3 INTERFACE Logger)
 endif()
 
+###### Tests ######
+
+# Round trip of the binary output through the decoder, which reads the descriptors from the test executable: it must
+# not be position independent
+if(NOT (TARGET Logger::Tests))
+    add_library(Logger::Tests INTERFACE IMPORTED)
+    target_sources(Logger::Tests INTERFACE
+        "${Logger_PATH}/logger_binary.c"
+        "${Logger_PATH}/implementations/logger_weak_implementation.c"
+        "${Logger_PATH}/tests/logger_binary_test.cpp"
+        "${Logger_PATH}/tests/logger_binary_test_c.c"
+    )
+    target_include_directories(Logger::Tests INTERFACE
+        "${Logger_PATH}"
+        "${Logger_PATH}/configs/num3"
+        "${Logger_PATH}/formats/num1"
+    )
+    target_compile_definitions(Logger::Tests INTERFACE
+        "-DLOGGER_BINARY"
+        "-DLOGGER_DECODE_SCRIPT=\"${Logger_PATH}/tools/logger_decode.py\""
+    )
+    target_link_options(Logger::Tests INTERFACE "-no-pie")
+endif()
+
 include(FindPackageHandleStandardArgs)
 find_package_handle_standard_args(Logger
     REQUIRED_VARS Logger_INCLUDE_DIRS
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
+#include <iterator>
 #include <variant>
 #include <cassert>
 
@@ -15,9 +17,87 @@
 #include "dbg_log.h"
 #endif
 
+// Task notification used by Wakeup(), index 0 is used by the FreeRTOS stream and message buffers
+#ifndef GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX
+#define GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX (configTASK_NOTIFICATION_ARRAY_ENTRIES - 1)
+#endif
+
 namespace Teufel::GenericThread
 {
 
+// Message ID reserved for Wakeup(), it is never passed to the message callback
+constexpr uint8_t WakeupMid = 0xFF;
+
+// Idle timeout to sleep until a message is posted or Wakeup() is called
+constexpr uint32_t IdleForever = UINT32_MAX;
+
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+#if !defined(configGENERATE_RUN_TIME_STATS) || (configGENERATE_RUN_TIME_STATS != 1)
+#error "GENERIC_THREAD_ENABLE_STATS times the callbacks with the FreeRTOS run time counter"
+#endif
+
+// Callback durations in run time counter units: bucket i counts the durations below HandlerBucketLimits[i], the last
+// bucket all the longer ones
+constexpr uint32_t HandlerBucketLimits[] = {100, 1000, 10000};
+constexpr uint8_t  HandlerBuckets        = std::size(HandlerBucketLimits) + 1;
+
+struct HandlerStats
+{
+    uint32_t Count;
+    uint32_t MaxTime;
+    uint16_t Histogram[HandlerBuckets]; // Saturates
+};
+
+// Type-erased statistics of a thread, all threads are linked in StatsList
+struct ThreadStats
+{
+    const char   *Name;
+    uint8_t       QueueSize;
+    uint8_t       MaxQueueSize;
+    HandlerStats  Idle;
+    HandlerStats *Handlers; // One per message type, indexed by the index of the alternative in the message variant
+    uint8_t       HandlerCount;
+    ThreadStats  *Next;
+};
+
+inline ThreadStats *StatsList = nullptr;
+
+// Static, the threads are allocated from the heap
+template <typename T>
+inline HandlerStats HandlerStatsOf[std::variant_size_v<T>];
+
+inline void AddSample(HandlerStats &stats, uint32_t time)
+{
+    uint8_t bucket = 0;
+    while (bucket < std::size(HandlerBucketLimits) && time >= HandlerBucketLimits[bucket])
+    {
+        bucket++;
+    }
+
+    stats.Count++;
+    stats.MaxTime = std::max(stats.MaxTime, time);
+    if (stats.Histogram[bucket] != UINT16_MAX)
+    {
+        stats.Histogram[bucket]++;
+    }
+}
+
+/**
+ * @brief Clears the queue high-water marks and the callback statistics of all threads.
+ */
+inline void ResetStats()
+{
+    for (ThreadStats *stats = StatsList; stats != nullptr; stats = stats->Next)
+    {
+        taskENTER_CRITICAL();
+        stats->MaxQueueSize = 0;
+        stats->Idle         = {};
+        std::fill(stats->Handlers, stats->Handlers + stats->HandlerCount, HandlerStats{});
+        taskEXIT_CRITICAL();
+    }
+}
+#endif
+
 template <typename T>
 struct QueueMessage
 {
@@ -40,6 +120,10 @@ struct Config
 
     void (*Callback)(uint8_t mid, T msg);
 
+    // Optional, evaluated before every wait instead of IdleMs. Return IdleForever to only run the idle callback
+    // on Wakeup(), so the task doesn't wake up periodically while there's nothing to do
+    uint32_t (*Callback_GetIdleMs)();
+
 #if defined(configSUPPORT_STATIC_ALLOCATION) && (configSUPPORT_STATIC_ALLOCATION == 1)
     StackType_t *StackBuffer;
     StaticTask_t *StaticTask;
@@ -67,16 +151,38 @@ struct GenericThread
     TaskHandle_t     task;
     QueueHandle_t    queue;
     uint32_t         idle_ms;
+    volatile bool    wakeup_pending;
 
-#if defined(GENERIC_THREAD_ENABLE_STATS)
+    // Number of times the task woke up, by cause
     struct
     {
-        uint8_t  MaxQueueSize;
-        uint16_t MinStackSize_bytes;
-    } stats;
+        uint32_t Messages;
+        uint32_t Wakeups;
+        uint32_t Timeouts;
+    } wakeups;
+
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+    ThreadStats stats;
 #endif
 };
 
+template <typename T>
+static void run_idle(GenericThread<T> *gthread)
+{
+    if (!gthread->config->Callback_Idle)
+    {
+        return;
+    }
+
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+    uint32_t start = portGET_RUN_TIME_COUNTER_VALUE();
+    gthread->config->Callback_Idle();
+    AddSample(gthread->stats.Idle, portGET_RUN_TIME_COUNTER_VALUE() - start);
+#else
+    gthread->config->Callback_Idle();
+#endif
+}
+
 template <typename T>
 [[noreturn]] static void task_loop(void *pvParameters)
 {
@@ -96,10 +202,7 @@ template <typename T>
         while (true)
         {
             vTaskDelay(pdMS_TO_TICKS(gthread->idle_ms));
-            if (config->Callback_Idle)
-            {
-                config->Callback_Idle();
-            }
+            run_idle(gthread);
         }
     }
     else
@@ -108,19 +211,42 @@ template <typename T>
 
         while (true)
         {
-            if (xQueueReceive(gthread->queue, (void *) &(msg), pdMS_TO_TICKS(gthread->idle_ms)))
+            // A wakeup whose message didn't fit in the queue is only recorded in the notification
+            if (ulTaskNotifyTakeIndexed(GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX, pdTRUE, 0) != 0)
             {
-                config->Callback(msg.mid, msg.payload);
+                gthread->wakeups.Wakeups++;
+                run_idle(gthread);
             }
-            else
+
+            uint32_t   idle_ms = config->Callback_GetIdleMs ? config->Callback_GetIdleMs() : gthread->idle_ms;
+            TickType_t timeout = (idle_ms == IdleForever) ? portMAX_DELAY : pdMS_TO_TICKS(idle_ms);
+
+            if (xQueueReceive(gthread->queue, (void *) &(msg), timeout))
             {
-                if (config->Callback_Idle)
+                if (msg.mid == WakeupMid)
                 {
-                    config->Callback_Idle();
+                    gthread->wakeup_pending = false;
+                    ulTaskNotifyTakeIndexed(GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX, pdTRUE, 0);
+                    gthread->wakeups.Wakeups++;
+                    run_idle(gthread);
                 }
+                else
+                {
+                    gthread->wakeups.Messages++;
 #if defined(GENERIC_THREAD_ENABLE_STATS)
-                gthread->stats.MinStackSize_bytes = uxTaskGetStackHighWaterMark2(gthread->task) * 4;
+                    const size_t   type  = msg.payload.index();
+                    const uint32_t start = portGET_RUN_TIME_COUNTER_VALUE();
+                    config->Callback(msg.mid, msg.payload);
+                    AddSample(gthread->stats.Handlers[type], portGET_RUN_TIME_COUNTER_VALUE() - start);
+#else
+                    config->Callback(msg.mid, msg.payload);
 #endif
+                }
+            }
+            else
+            {
+                gthread->wakeups.Timeouts++;
+                run_idle(gthread);
             }
         }
     }
@@ -134,13 +260,23 @@ GenericThread<T> *create(const Config<T> *config)
     auto gthread = (GenericThread<T> *) new GenericThread<T>;
     assert(gthread != nullptr);
 
-    gthread->config  = config;
-    gthread->idle_ms = config->IdleMs;
-    gthread->task    = nullptr;
-    gthread->queue   = nullptr;
+    gthread->config         = config;
+    gthread->idle_ms        = config->IdleMs;
+    gthread->task           = nullptr;
+    gthread->queue          = nullptr;
+    gthread->wakeup_pending = false;
+    gthread->wakeups        = {};
 #if defined(GENERIC_THREAD_ENABLE_STATS)
-    GenThread->stats.MaxQueueSize       = 0;
-    GenThread->stats.MinStackSize_bytes = config->StackSize * 4;
+    gthread->stats      = {};
+    gthread->stats.Name = config->Name;
+    if constexpr (!std::is_same_v<T, void>)
+    {
+        gthread->stats.QueueSize    = config->QueueSize;
+        gthread->stats.Handlers     = HandlerStatsOf<T>;
+        gthread->stats.HandlerCount = std::variant_size_v<T>;
+    }
+    gthread->stats.Next = StatsList;
+    StatsList           = &gthread->stats;
 #endif
 
     log_trace("[%s] Create Message Queue\n", config->Name);
@@ -178,6 +314,7 @@ GenericThread<T> *create(const Config<T> *config)
     xHandle = xTaskCreateStatic(task_loop<T>, config->Name, config->StackSize, (void *) gthread, config->Priority,
                              config->StackBuffer, config->StaticTask);
     assert(xHandle);
+    gthread->task = xHandle;
 #endif
 
     return gthread;
@@ -202,8 +339,15 @@ int PostMsg(GenericThread<T> *gthread, uint8_t mid, T msg)
         .payload = msg,
     };
 
-    uint32_t IPSR_register;
+    // Host builds (mynd-sim) run the interrupt handlers from a task, so they are always in thread mode
+    uint32_t IPSR_register = 0U;
+#if defined(__arm__)
     __asm volatile("MRS %0, ipsr" : "=r"(IPSR_register));
+#endif
+
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+    UBaseType_t queueSize = 0;
+#endif
 
     if (0U == IPSR_register)
     {
@@ -213,6 +357,9 @@ int PostMsg(GenericThread<T> *gthread, uint8_t mid, T msg)
                     uxQueueSpacesAvailable(gthread->queue));
             error = -1;
         }
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+        queueSize = uxQueueMessagesWaiting(gthread->queue);
+#endif
     }
     else
     {
@@ -221,21 +368,89 @@ int PostMsg(GenericThread<T> *gthread, uint8_t mid, T msg)
             // log_err("[ISR] Post Msg failed for \"%s\" with event:%d", pcTaskGetName(gen_thread->Task), event);
             error = -2;
         }
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+        queueSize = uxQueueMessagesWaitingFromISR(gthread->queue);
+#endif
         // Switch context if necessary.
         portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
     }
 
 #if defined(GENERIC_THREAD_ENABLE_STATS)
-    uint32_t queueSize          = gthread->config->QueueSize - uxQueueSpacesAvailable(gthread->queue);
-    gthread->stats.MaxQueueSize = MAX(queueSize, gthread->stats.MaxQueueSize);
+    // The queue may have been read in between, a lower bound of the high-water mark
+    gthread->stats.MaxQueueSize = std::max<uint8_t>(queueSize, gthread->stats.MaxQueueSize);
 #endif
 
     return error;
 }
 
-#if defined(GENERIC_THREAD_ENABLE_STATS)
-uint16_t getMinStackSize(GenericThread_t *gthread);
-uint8_t  getMaxQueueSize(GenericThread_t *gthread);
+/**
+ * @brief Makes the thread run its idle callback as soon as possible, e.g. when an ISR has new data for it.
+ * @note  Can be called from tasks and interrupts. Wakeups are coalesced: while one is pending, further calls
+ *        only update the task notification, so the queue never fills up with them.
+ */
+template <typename T>
+int Wakeup(GenericThread<T> *gthread)
+{
+    if constexpr (std::is_same_v<T, void>)
+        return -1;
+
+    if ((!gthread) || (!gthread->queue) || (!gthread->task))
+    {
+        return -1;
+    }
+
+    QueueMessage<T> txmsg = {
+        .mid     = WakeupMid,
+        .payload = {},
+    };
+
+    uint32_t IPSR_register = 0U;
+#if defined(__arm__)
+    __asm volatile("MRS %0, ipsr" : "=r"(IPSR_register));
 #endif
 
+    if (0U == IPSR_register)
+    {
+        xTaskNotifyGiveIndexed(gthread->task, GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX);
+        if (!gthread->wakeup_pending)
+        {
+            gthread->wakeup_pending = true;
+            if (xQueueSend(gthread->queue, (void *) &txmsg, 0) != pdPASS)
+            {
+                gthread->wakeup_pending = false;
+            }
+        }
+    }
+    else
+    {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+        vTaskNotifyGiveIndexedFromISR(gthread->task, GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX,
+                                      &xHigherPriorityTaskWoken);
+        if (!gthread->wakeup_pending)
+        {
+            gthread->wakeup_pending = true;
+            if (xQueueSendFromISR(gthread->queue, (void *) &txmsg, &xHigherPriorityTaskWoken) != pdTRUE)
+            {
+                gthread->wakeup_pending = false;
+            }
+        }
+        // Switch context if necessary.
+        portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Blocks the calling thread until Wakeup() is called or the timeout expires.
+ * @note  Meant for message callbacks which need to wait for data from an ISR (instead of polling with vTaskDelay).
+ *
+ * @return true if woken up, false if timed out
+ */
+inline bool WaitForWakeup(uint32_t timeout_ms)
+{
+    return ulTaskNotifyTakeIndexed(GENERIC_THREAD_WAKEUP_NOTIFICATION_INDEX, pdTRUE, pdMS_TO_TICKS(timeout_ms)) != 0;
+}
+
 }
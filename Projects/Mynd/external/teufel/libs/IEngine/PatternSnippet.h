@@ -2,6 +2,8 @@
 
 #include <cstdint>
 #include <array>
+#include <limits>
+#include <type_traits>
 
 namespace IndicationEngine
 {
@@ -66,6 +68,60 @@ class PatternFn final : public PatternSnippet<T>
     }
 };
 
+// Scales a value of a full brightness curve to the brightness: value * brightness / max
+template <typename T = uint8_t>
+constexpr T scale_brightness(T value, T brightness)
+{
+    uint32_t product = static_cast<uint32_t>(value) * brightness;
+    if constexpr (std::is_same_v<T, uint8_t>)
+    {
+        // product / 255 without a division, exact for product <= 255 * 255
+        return static_cast<T>((product + 1 + (product >> 8)) >> 8);
+    }
+    else
+    {
+        return static_cast<T>(product / std::numeric_limits<T>::max());
+    }
+}
+
+// Lookup table of a curve at full brightness, generated at compile time with MakeLookUpTable() to stay in flash. The
+// brightness is applied to the values as they are read, so changing it doesn't touch the table.
+template <std::size_t SIZE, typename T = uint8_t>
+class PatternScaledFn final : public PatternSnippet<T>
+{
+  private:
+    const std::array<T, SIZE> &lookup_table;
+    T                          m_brightness;
+
+  public:
+    explicit PatternScaledFn(const std::array<T, SIZE> &table,
+                             std::type_identity_t<T> brightness = std::numeric_limits<T>::max())
+      : lookup_table(table)
+      , m_brightness(brightness){};
+
+    PatternScaledFn(const PatternScaledFn &)  = delete;
+    PatternScaledFn(const PatternScaledFn &&) = delete;
+
+    [[nodiscard]] std::size_t steps() const override
+    {
+        return lookup_table.size();
+    }
+
+    T operator[](int index) const override
+    {
+        if (index >= 0 && index < static_cast<int>(lookup_table.size()))
+        {
+            return scale_brightness(lookup_table[index], m_brightness);
+        }
+        return 0U;
+    }
+
+    void update(T brightness)
+    {
+        m_brightness = brightness;
+    }
+};
+
 template <typename T = uint8_t>
 class PatternConst final : public PatternSnippet<T>
 {
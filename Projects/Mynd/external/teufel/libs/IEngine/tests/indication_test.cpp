@@ -87,3 +87,80 @@ TEST(IndicationEngineTest, FillLookUpTableExtendedTypeUint16WithQuadraticFunctio
     ASSERT_EQ(s.table.size(), 3);
     EXPECT_THAT(s.table, ::testing::ContainerEq(std::array<uint16_t, 3>{0, 255, 1020}));
 }
+
+TEST(IndicationEngineTest, MakeLookUpTableMatchesFillLookUpTable)
+{
+    constexpr auto table = ie::MakeLookUpTable<PATTERN_MS_TO_STEPS_INT(2000)>(cubic_fn, 0.f, 1.f,
+                                                                             PATTERN_MS_TO_STEPS_INT(2000) - 1);
+
+    auto s = LookUpTable<uint8_t, 2000>{};
+    ie::FillLookUpTable(cubic_fn, s.table, 0.f, 1.f);
+
+    EXPECT_THAT(table, ::testing::ContainerEq(s.table));
+}
+
+TEST(IndicationEngineTest, ScaleBrightnessMatchesDivision)
+{
+    for (uint32_t value = 0; value <= UINT8_MAX; value++)
+    {
+        for (uint32_t brightness = 0; brightness <= UINT8_MAX; brightness++)
+        {
+            ASSERT_EQ(ie::scale_brightness(static_cast<uint8_t>(value), static_cast<uint8_t>(brightness)),
+                      value * brightness / UINT8_MAX);
+        }
+    }
+}
+
+// The scaled full brightness table against the table filled at the brightness, as the LED patterns did before. Both
+// round: they are equal at the full and at zero brightness and differ by at most one in between.
+template <std::uint32_t DURATION_MS, class Function>
+static void ExpectScaledFnMatchesFillLookUpTable(Function f)
+{
+    constexpr auto N     = PATTERN_MS_TO_STEPS_INT(DURATION_MS);
+    constexpr auto table = ie::MakeLookUpTable<N>(f, 0.f, 1.f, N - 1);
+
+    ie::PatternScaledFn snippet(table);
+    ASSERT_EQ(snippet.steps(), N);
+
+    for (uint32_t brightness = 0; brightness <= UINT8_MAX; brightness++)
+    {
+        auto s = LookUpTable<uint8_t, DURATION_MS>{};
+        ie::FillLookUpTable(f, s.table, 0.f, 1.f, static_cast<uint8_t>(brightness));
+        snippet.update(static_cast<uint8_t>(brightness));
+
+        for (std::size_t i = 0; i < N; i++)
+        {
+            if (brightness == 0 || brightness == UINT8_MAX)
+            {
+                ASSERT_EQ(snippet[i], s.table[i]) << "brightness " << brightness << ", step " << i;
+            }
+            else
+            {
+                ASSERT_NEAR(snippet[i], s.table[i], 1) << "brightness " << brightness << ", step " << i;
+            }
+        }
+    }
+    EXPECT_EQ(snippet[N], 0);
+}
+
+TEST(IndicationEngineTest, PatternScaledFnMatchesFillLookUpTable)
+{
+    ExpectScaledFnMatchesFillLookUpTable<2000>(cubic_fn);
+    ExpectScaledFnMatchesFillLookUpTable<2000>([](float x) { return (1.f - x) * (1.f - x) * (1.f - x); });
+    ExpectScaledFnMatchesFillLookUpTable<500>(linear_up_fn);
+    ExpectScaledFnMatchesFillLookUpTable<500>(linear_down_fn);
+}
+
+TEST(IndicationEngineTest, PatternScaledFnUpdateKeepsTheTable)
+{
+    constexpr auto table = ie::MakeLookUpTable<3>(linear_up_fn, 0.f, 1.f, 2);
+
+    ie::PatternScaledFn snippet(table, 100);
+    EXPECT_EQ(snippet[1], 49); // 127 * 100 / 255
+    EXPECT_EQ(snippet[2], 100);
+
+    snippet.update(UINT8_MAX);
+    EXPECT_EQ(snippet[1], table[1]);
+    EXPECT_EQ(snippet[2], UINT8_MAX);
+    EXPECT_EQ(table[2], UINT8_MAX);
+}
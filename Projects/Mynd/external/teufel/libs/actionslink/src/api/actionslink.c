@@ -33,16 +33,26 @@ int actionslink_init(const actionslink_config_t *p_config, const actionslink_eve
         return -1;
     }
 
-    if ((p_config->write_buffer_fn == NULL) || (p_config->read_buffer_fn == NULL) || (p_config->p_tx_buffer == NULL) ||
+    if ((p_config->write_buffer_fn == NULL) || (p_config->read_buffer_fn == NULL) ||
         (p_config->p_rx_buffer == NULL) || (p_config->get_tick_ms_fn == NULL))
     {
         return -1;
     }
 
-    if (p_config->tx_buffer_size < 32)
+    // The TX buffer is only needed if the frames can't be built directly in a buffer provided by the caller
+    bool has_external_tx_buffer = (p_config->get_tx_buffer_fn != NULL) && (p_config->send_tx_buffer_fn != NULL);
+    if (!has_external_tx_buffer)
     {
-        log_error("tx buffer is too small (< 32 bytes)");
-        return -1;
+        if (p_config->p_tx_buffer == NULL)
+        {
+            return -1;
+        }
+
+        if (p_config->tx_buffer_size < 32)
+        {
+            log_error("tx buffer is too small (< 32 bytes)");
+            return -1;
+        }
     }
 
     if (p_config->rx_buffer_size < 32)
@@ -110,9 +120,14 @@ void actionslink_tick(void)
         return;
     }
 
-    ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
-    // Nothing to do with the response, we just need to pass the buffer to the function
-    actionslink_bt_ul_rx(&response);
+    // Process everything received since the last tick, so that the caller only needs to tick again
+    // once new data arrives. Nothing to do with the response, we just need to pass the buffer to the function
+    int result;
+    do
+    {
+        ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
+        result                     = actionslink_bt_ul_rx(&response);
+    } while (result == 1);
 }
 
 bool actionslink_is_ready(void)
@@ -367,6 +382,20 @@ int actionslink_disconnect_all_bt_devices(void)
     return 0;
 }
 
+static void on_control_volume_completed(int result, const ActionsLink_ToMcu *p_response, void *p_context)
+{
+    (void) p_context;
+    if (result != 0)
+    {
+        log_error("failed to set volume [no response]");
+    }
+    else if (p_response->Payload.response.Response.set_volume.status.code != ActionsLink_Error_Code_Success)
+    {
+        log_error("failed to set volume [%s]",
+                        get_error_desc(p_response->Payload.response.Response.set_volume.status.code));
+    }
+}
+
 static int control_volume(ActionsLink_Audio_VolumeControl_VolumeControlAction action)
 {
     if (!is_driver_ready())
@@ -380,12 +409,10 @@ static int control_volume(ActionsLink_Audio_VolumeControl_VolumeControlAction ac
     message.Payload.request.which_Request             = ActionsLink_FromMcuRequest_set_volume_tag;
     message.Payload.request.Request.set_volume.action = action;
 
-    ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
-    if ((actionslink_bt_ul_tx_rx(&message, &response) != 0) ||
-        (response.Payload.response.Response.set_volume.status.code != ActionsLink_Error_Code_Success))
+    // Volume steps are pipelined (e.g. while a volume button is held), the result is checked on completion
+    if (actionslink_bt_ul_tx_async(&message, on_control_volume_completed, NULL) != 0)
     {
-        log_error("failed to set volume [%s]",
-                        get_error_desc(response.Payload.response.Response.set_volume.status.code));
+        log_error("failed to send volume command");
         return -1;
     }
     return 0;
@@ -425,6 +452,20 @@ int actionslink_set_bt_absolute_avrcp_volume(uint8_t avrcp_volume)
     return 0;
 }
 
+static void on_send_avrcp_command_completed(int result, const ActionsLink_ToMcu *p_response, void *p_context)
+{
+    (void) p_context;
+    if (result != 0)
+    {
+        log_error("failed to send avrcp action [no response]");
+    }
+    else if (p_response->Payload.response.Response.send_avrcp_action.status.code != ActionsLink_Error_Code_Success)
+    {
+        log_error("failed to send avrcp action [%s]",
+                        get_error_desc(p_response->Payload.response.Response.send_avrcp_action.status.code));
+    }
+}
+
 static int send_avrcp_command(ActionsLink_Bluetooth_AvrcpAction_Action action)
 {
     if (!is_driver_ready())
@@ -438,12 +479,10 @@ static int send_avrcp_command(ActionsLink_Bluetooth_AvrcpAction_Action action)
     message.Payload.request.which_Request                    = ActionsLink_FromMcuRequest_send_avrcp_action_tag;
     message.Payload.request.Request.send_avrcp_action.action = action;
 
-    ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
-    if ((actionslink_bt_ul_tx_rx(&message, &response) != 0) ||
-        (response.Payload.response.Response.send_avrcp_action.status.code != ActionsLink_Error_Code_Success))
+    // AVRCP actions are pipelined, the result is checked on completion
+    if (actionslink_bt_ul_tx_async(&message, on_send_avrcp_command_completed, NULL) != 0)
     {
-        log_error("failed to send avrcp action [%s]",
-                        get_error_desc(response.Payload.response.Response.send_avrcp_action.status.code));
+        log_error("failed to send avrcp action");
         return -1;
     }
     return 0;
@@ -37,6 +37,8 @@ extern "C"
 
     /**
      * @brief Reads from the buffers and generates events, if any.
+     * @note  All the frames received so far are processed, so it's enough to call this function
+     *        when new data has been received or while actionslink_is_busy() (for the timeouts).
      */
     void actionslink_tick(void);
 
@@ -167,6 +169,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to increase the volume by one step.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -174,6 +178,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to decrease the volume by one step.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -192,6 +198,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to tell the Bluetooth device to play/pause audio.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -199,6 +207,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to tell the Bluetooth device to play audio.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -206,6 +216,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to tell the Bluetooth device to pause audio.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -213,6 +225,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to tell the Bluetooth device to go to the next track.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -220,6 +234,8 @@ extern "C"
 
     /**
      * @brief Sends a command to the Actions module to tell the Bluetooth device to go to the previous track.
+     * @note  The command is pipelined: this returns once the request is queued, the response
+     *        (or a timeout) is checked later and failures are logged.
      *
      * @return 0 if successful, -1 otherwise
      */
@@ -61,6 +61,45 @@ typedef int (*actionslink_write_buffer_fn_t)(const uint8_t *p_data, uint8_t leng
  */
 typedef int (*actionslink_read_buffer_fn_t)(uint8_t *p_data, uint8_t length, uint32_t timeout);
 
+/**
+ * @brief Function to read all the data already received from the Actions module, without waiting.
+ * @note  This is not a mandatory function and can be NULL if not needed. If available, it is used
+ *        instead of the read buffer function to fetch the received bytes in bulk.
+ *
+ * @param[out] p_data       pointer to where the data will be written
+ * @param[in]  max_length   maximum length of data to read
+ *
+ * @return number of bytes read
+ */
+typedef size_t (*actionslink_read_available_fn_t)(uint8_t *p_data, size_t max_length);
+
+/**
+ * @brief Function to get a buffer where the next frame is built in place before being sent
+ *        to the Actions module, e.g. a DMA TX buffer.
+ * @note  This is not a mandatory function and can be NULL if not needed. If available together with
+ *        the send TX buffer function, it is used instead of the TX buffer and the write buffer function,
+ *        and the TX buffer is not needed.
+ *
+ * @param[out] pp_buffer    pointer to where the pointer to the buffer will be written
+ * @param[out] p_size       pointer to where the size of the buffer will be written
+ * @param[in]  timeout      timeout value
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+typedef int (*actionslink_get_tx_buffer_fn_t)(uint8_t **pp_buffer, size_t *p_size, uint32_t timeout);
+
+/**
+ * @brief Function to send a frame built in the buffer returned by the get TX buffer function.
+ * @note  This is not a mandatory function and can be NULL if not needed. The function is expected
+ *        to start the transmission and return without waiting for it to complete.
+ *
+ * @param[in] p_data        pointer to the frame, within the buffer returned by the get TX buffer function
+ * @param[in] length        length of the frame
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+typedef int (*actionslink_send_tx_buffer_fn_t)(const uint8_t *p_data, size_t length);
+
 /**
  * @brief Function to yield the task while waiting for long running operations,
  *        e.g. waiting for a response from the Actions module.
@@ -84,17 +123,20 @@ typedef void (*actionslink_log_fn_t)(actionslink_log_level_t level, const char *
 
 typedef struct actionslink_config
 {
-    actionslink_write_buffer_fn_t write_buffer_fn; // Mandatory function
-    actionslink_read_buffer_fn_t  read_buffer_fn;  // Mandatory function
-    actionslink_get_tick_ms_fn_t  get_tick_ms_fn;  // Mandatory function
-    actionslink_msp_init_fn_t     msp_init_fn;     // Optional function
-    actionslink_msp_deinit_fn_t   msp_deinit_fn;   // Optional function
-    actionslink_task_yield_fn_t   task_yield_fn;   // Optional function
-    actionslink_log_fn_t          log_fn;          // Optional function
-    uint8_t                      *p_rx_buffer;
-    uint8_t                      *p_tx_buffer;
-    uint16_t                      rx_buffer_size;
-    uint16_t                      tx_buffer_size;
+    actionslink_write_buffer_fn_t   write_buffer_fn;   // Mandatory function
+    actionslink_read_buffer_fn_t    read_buffer_fn;    // Mandatory function
+    actionslink_get_tick_ms_fn_t    get_tick_ms_fn;    // Mandatory function
+    actionslink_msp_init_fn_t       msp_init_fn;       // Optional function
+    actionslink_msp_deinit_fn_t     msp_deinit_fn;     // Optional function
+    actionslink_task_yield_fn_t     task_yield_fn;     // Optional function
+    actionslink_log_fn_t            log_fn;            // Optional function
+    uint8_t                        *p_rx_buffer;
+    uint8_t                        *p_tx_buffer;
+    uint16_t                        rx_buffer_size;
+    uint16_t                        tx_buffer_size;
+    actionslink_read_available_fn_t read_available_fn; // Optional function
+    actionslink_get_tx_buffer_fn_t  get_tx_buffer_fn;  // Optional function
+    actionslink_send_tx_buffer_fn_t send_tx_buffer_fn; // Optional function
 } actionslink_config_t;
 
 typedef enum
@@ -0,0 +1,1219 @@
+#include "actionslink_emulator.h"
+#include "actionslink_hdlc.h"
+#include "message.pb.h"
+#include "pb_decode.h"
+#include "pb_encode.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Same frame layout as actionslink_bt_ll.c
+#define PACKET_HEADER_SIZE              (8u)
+#define PACKET_START_MAGIC_BYTE         (0x55u)
+
+#define PACKET_INDEX_START_BYTE         (0u)
+#define PACKET_INDEX_PACKET_TYPE        (1u)
+#define PACKET_INDEX_TRANSACTION_ID     (2u)
+#define PACKET_INDEX_PAYLOAD_LENGTH_LSB (3u)
+#define PACKET_INDEX_PAYLOAD_LENGTH_MSB (4u)
+#define PACKET_INDEX_PAYLOAD_CRC        (5u)
+#define PACKET_INDEX_RESERVED           (6u)
+#define PACKET_INDEX_HEADER_CRC         (7u)
+#define PACKET_INDEX_PAYLOAD_START      (8u)
+
+#define PACKET_TYPE_ACK                 (0x00u)
+#define PACKET_TYPE_PROTOBUF            (0x01u)
+
+#define NACK_REASON_BAD_PACKET          (1u)
+#define NACK_REASON_BAD_CRC             (2u)
+#define NACK_REASON_INVALID_LENGTH      (3u)
+#define NACK_REASON_BUSY                (4u)
+
+#define MAX_PAYLOAD_SIZE                (256u)
+#define RX_BUFFER_SIZE                  (PACKET_HEADER_SIZE + 512u)
+// Both delimiters and every byte escaped
+#define MAX_FRAME_SIZE                  (2u + 2u * (PACKET_HEADER_SIZE + MAX_PAYLOAD_SIZE))
+#define MAX_QUEUED_FRAMES               (64u)
+#define MAX_PENDING_FRAMES              (64u)
+#define MAX_OPEN_REQUESTS               (32u)
+#define NO_REQUEST                      (-1)
+
+// Actions module of the default "connect" command
+#define DEFAULT_DEVICE_ADDRESS          (0x0000123456789ABCull)
+
+typedef struct
+{
+    uint32_t due_ms; // When the last byte is on the MCU side
+    size_t   length;
+    size_t   offset; // Bytes already read
+    uint8_t  data[MAX_FRAME_SIZE];
+} queued_frame_t;
+
+// Frame of the emulator waiting for the ACK of the MCU
+typedef struct
+{
+    bool              in_use;
+    bool              is_corrupted; // Sent with a bad CRC, the MCU NACKs it
+    uint8_t           transaction_id;
+    uint8_t           retries;
+    uint32_t          sent_ms;
+    int               request_index; // Open request answered (or sent) by this frame, NO_REQUEST otherwise
+    ActionsLink_ToMcu message;
+} pending_frame_t;
+
+typedef struct
+{
+    bool                             in_use;
+    actionslink_emulator_direction_t direction;
+    uint16_t                         tag;
+    uint32_t                         seq;
+    uint32_t                         first_ms;
+    uint32_t                         retries;
+} open_request_t;
+
+typedef struct
+{
+    uint8_t  direction;
+    uint16_t tag;
+    uint32_t retries;
+    uint32_t latency_ms;
+} sample_t;
+
+typedef struct
+{
+    const char *name;
+    int         value;
+} name_value_t;
+
+static struct
+{
+    const actionslink_emulator_config_t *p_config;
+    uint32_t                             random;
+    uint32_t                             ack_latency_ms;
+    uint32_t                             response_latency_ms;
+    uint32_t                             jitter_ms;
+
+    actionslink_hdlc_decoder_t decoder;
+    uint8_t                    rx_buffer[RX_BUFFER_SIZE];
+
+    queued_frame_t queue[MAX_QUEUED_FRAMES];
+    size_t         queue_head;
+    size_t         queue_count;
+    uint32_t       last_due_ms;
+    bool           is_last_frame_corrupted;
+
+    pending_frame_t pending[MAX_PENDING_FRAMES];
+    open_request_t  requests[MAX_OPEN_REQUESTS];
+    uint8_t         next_transaction_id;
+    uint32_t        next_seq;
+
+    // Injected faults, each counts down the frames it applies to
+    uint32_t drop_frames;
+    uint32_t drop_acks;
+    uint32_t nack_frames;
+    uint32_t corrupt_crcs;
+
+    // State of the module
+    bool     is_connected;
+    uint32_t audio_source;
+    uint32_t csb_state;
+    int32_t  avrcp_volume;
+
+    // AVRCP volume storm in progress
+    uint32_t storm_remaining;
+    uint32_t storm_interval_ms;
+    uint32_t storm_next_ms;
+    int32_t  storm_step;
+
+    actionslink_emulator_stats_t stats;
+    sample_t                     samples[ACTIONSLINK_EMULATOR_MAX_SAMPLES];
+    size_t                       number_of_samples;
+} m_emulator;
+
+static uint32_t m_sorted_latencies[ACTIONSLINK_EMULATOR_MAX_SAMPLES];
+
+static const name_value_t m_power_states[] = {
+    {"off", ActionsLink_System_PowerState_SystemPowerMode_OFF},
+    {"on", ActionsLink_System_PowerState_SystemPowerMode_ON},
+    {"standby", ActionsLink_System_PowerState_SystemPowerMode_STANDBY},
+};
+
+static const name_value_t m_audio_sources[] = {
+    {"a2dp1", ActionsLink_Audio_AudioSourceType_A2DP1},
+    {"a2dp2", ActionsLink_Audio_AudioSourceType_A2DP2},
+    {"usb", ActionsLink_Audio_AudioSourceType_USB},
+    {"analog", ActionsLink_Audio_AudioSourceType_ANALOG},
+};
+
+static const name_value_t m_disconnection_types[] = {
+    {"link-loss", ActionsLink_Bluetooth_DisconnectionEvt_DisconnectionType_LINK_LOSS},
+    {"user", ActionsLink_Bluetooth_DisconnectionEvt_DisconnectionType_USER_REQUEST},
+};
+
+static const name_value_t m_csb_states[] = {
+    {"disabled", ActionsLink_Bluetooth_CsbState_CsbStateType_DISABLED},
+    {"broadcasting", ActionsLink_Bluetooth_CsbState_CsbStateType_BROADCASTING},
+    {"receiver-pairing", ActionsLink_Bluetooth_CsbState_CsbStateType_RECEIVER_PAIRING},
+    {"receiver-connected", ActionsLink_Bluetooth_CsbState_CsbStateType_RECEIVER_CONNECTED},
+};
+
+static const name_value_t m_csb_disconnect_reasons[] = {
+    {"unknown", ActionsLink_Bluetooth_CsbState_CsbReceiverDisconnectReason_UNKNOWN},
+    {"user", ActionsLink_Bluetooth_CsbState_CsbReceiverDisconnectReason_USER_REQUEST},
+    {"power-off", ActionsLink_Bluetooth_CsbState_CsbReceiverDisconnectReason_POWER_OFF},
+    {"link-loss", ActionsLink_Bluetooth_CsbState_CsbReceiverDisconnectReason_LINK_LOSS},
+};
+
+// Requests of the module without arguments (Common.Command)
+static const name_value_t m_requests[] = {
+    {"get_mcu_firmware_version", ActionsLink_ToMcuRequest_get_mcu_firmware_version_tag},
+    {"get_color", ActionsLink_ToMcuRequest_get_color_tag},
+    {"get_off_timer", ActionsLink_ToMcuRequest_get_off_timer_tag},
+    {"get_brightness", ActionsLink_ToMcuRequest_get_brightness_tag},
+    {"get_pdcontroller_firmware_version", ActionsLink_ToMcuRequest_get_pdcontroller_firmware_version_tag},
+    {"get_bass", ActionsLink_ToMcuRequest_get_bass_tag},
+    {"get_treble", ActionsLink_ToMcuRequest_get_treble_tag},
+    {"get_eco_mode", ActionsLink_ToMcuRequest_get_eco_mode_tag},
+    {"get_sound_icons", ActionsLink_ToMcuRequest_get_sound_icons_tag},
+    {"get_battery_friendly_charging", ActionsLink_ToMcuRequest_get_battery_friendly_charging_tag},
+    {"get_battery_capacity", ActionsLink_ToMcuRequest_get_battery_capacity_tag},
+    {"get_battery_max_capacity", ActionsLink_ToMcuRequest_get_battery_max_capacity_tag},
+};
+
+static uint32_t now_ms(void);
+static uint32_t next_random(void);
+static void     reset_state(void);
+static void     poll(uint32_t now);
+static int      queue_frame(uint8_t packet_type, uint8_t value, uint8_t transaction_id,
+                            const ActionsLink_ToMcu *p_message, uint32_t latency_ms);
+static int      send_message(const ActionsLink_ToMcu *p_message, uint32_t latency_ms, int request_index);
+static void     send_event(const ActionsLink_ToMcuEvent *p_event);
+static void     retransmit(pending_frame_t *p_pending, uint32_t now);
+static void     process_frame(uint32_t now);
+static void     process_ack(uint8_t transaction_id, uint8_t value, uint32_t now);
+static void     process_message(const ActionsLink_FromMcu *p_message, bool is_received, uint32_t now);
+static void     answer_request(const ActionsLink_FromMcuRequest *p_request, int request_index);
+static int      open_request(actionslink_emulator_direction_t direction, uint16_t tag, uint32_t seq, uint32_t now);
+static int      find_request(actionslink_emulator_direction_t direction, uint16_t tag, uint32_t seq);
+static void     close_request(int request_index, uint32_t now);
+static bool     lookup(const name_value_t *p_table, size_t size, const char *p_name, int *p_value);
+static int      compare_latencies(const void *p_a, const void *p_b);
+
+#define LOOKUP(table, name, p_value) lookup(table, sizeof(table) / sizeof(table[0]), name, p_value)
+
+void actionslink_emulator_init(const actionslink_emulator_config_t *p_config)
+{
+    memset(&m_emulator, 0, sizeof(m_emulator));
+    m_emulator.p_config            = p_config;
+    m_emulator.random              = (p_config->seed != 0) ? p_config->seed : 1u;
+    m_emulator.ack_latency_ms      = p_config->ack_latency_ms;
+    m_emulator.response_latency_ms = p_config->response_latency_ms;
+    m_emulator.jitter_ms           = p_config->jitter_ms;
+
+    actionslink_hdlc_decoder_init(&m_emulator.decoder, m_emulator.rx_buffer, sizeof(m_emulator.rx_buffer),
+                                  PACKET_HEADER_SIZE);
+    reset_state();
+}
+
+void actionslink_emulator_reset(void)
+{
+    actionslink_hdlc_decoder_reset(&m_emulator.decoder);
+    m_emulator.queue_head      = 0;
+    m_emulator.queue_count     = 0;
+    m_emulator.storm_remaining = 0;
+
+    for (size_t i = 0; i < MAX_PENDING_FRAMES; i++)
+    {
+        m_emulator.pending[i].in_use = false;
+    }
+    for (size_t i = 0; i < MAX_OPEN_REQUESTS; i++)
+    {
+        m_emulator.requests[i].in_use = false;
+    }
+    m_emulator.stats.requests_pending = 0;
+
+    reset_state();
+}
+
+int actionslink_emulator_run(const char *p_command)
+{
+    char     name[32];
+    char     arg[32];
+    char     extra[32];
+    unsigned a, b;
+    int      consumed;
+    int      value;
+
+    if (sscanf(p_command, "%31s%n", name, &consumed) != 1)
+    {
+        return -1;
+    }
+
+    const char            *p_args = p_command + consumed;
+    const int              args   = sscanf(p_args, "%31s %31s", arg, extra);
+    ActionsLink_ToMcuEvent event  = ActionsLink_ToMcuEvent_init_zero;
+
+    if (strcmp(name, "ready") == 0)
+    {
+        event.which_Event = ActionsLink_ToMcuEvent_notify_system_ready_tag;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "power") == 0 && args >= 1 && LOOKUP(m_power_states, arg, &value))
+    {
+        event.which_Event                   = ActionsLink_ToMcuEvent_notify_power_state_tag;
+        event.Event.notify_power_state.mode = value;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "connect") == 0)
+    {
+        unsigned long long address = DEFAULT_DEVICE_ADDRESS;
+        if (args >= 1 && sscanf(arg, "%llx", &address) != 1)
+        {
+            return -1;
+        }
+
+        event.which_Event                               = ActionsLink_ToMcuEvent_notify_bt_connection_tag;
+        event.Event.notify_bt_connection.has_device     = true;
+        event.Event.notify_bt_connection.device.address = address;
+        send_event(&event);
+
+        m_emulator.is_connected                      = true;
+        event.which_Event                            = ActionsLink_ToMcuEvent_notify_bt_connection_state_tag;
+        event.Event.notify_bt_connection_state.state = ActionsLink_Bluetooth_ConnectionState_ConnectionType_CONNECTED;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "disconnect") == 0)
+    {
+        value = ActionsLink_Bluetooth_DisconnectionEvt_DisconnectionType_LINK_LOSS;
+        if (args >= 1 && !LOOKUP(m_disconnection_types, arg, &value))
+        {
+            return -1;
+        }
+
+        event.which_Event                                  = ActionsLink_ToMcuEvent_notify_bt_disconnection_tag;
+        event.Event.notify_bt_disconnection.has_device     = true;
+        event.Event.notify_bt_disconnection.device.address = DEFAULT_DEVICE_ADDRESS;
+        event.Event.notify_bt_disconnection.type           = value;
+        send_event(&event);
+
+        m_emulator.is_connected = false;
+        event.which_Event       = ActionsLink_ToMcuEvent_notify_bt_connection_state_tag;
+        event.Event.notify_bt_connection_state.state =
+            ActionsLink_Bluetooth_ConnectionState_ConnectionType_DISCONNECTED;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "stream") == 0 && args >= 1 && (strcmp(arg, "on") == 0 || strcmp(arg, "off") == 0))
+    {
+        const bool is_streaming = strcmp(arg, "on") == 0;
+
+        if (is_streaming)
+        {
+            event.which_Event                      = ActionsLink_ToMcuEvent_notify_audio_source_tag;
+            event.Event.notify_audio_source.source = m_emulator.audio_source;
+            send_event(&event);
+
+            event.which_Event                            = ActionsLink_ToMcuEvent_notify_bt_a2dp_data_tag;
+            event.Event.notify_bt_a2dp_data.channel_mode = ActionsLink_Bluetooth_ChannelMode_Stereo;
+            event.Event.notify_bt_a2dp_data.codec        = ActionsLink_Bluetooth_CodecType_SBC;
+            event.Event.notify_bt_a2dp_data.sample_rate  = 44100u;
+            send_event(&event);
+        }
+
+        event.which_Event                       = ActionsLink_ToMcuEvent_notify_bt_avrcp_state_tag;
+        event.Event.notify_bt_avrcp_state.state = is_streaming ? ActionsLink_Bluetooth_AvrcpState_AvrcpState_PLAY
+                                                               : ActionsLink_Bluetooth_AvrcpState_AvrcpState_PAUSE;
+        send_event(&event);
+
+        event.which_Event               = ActionsLink_ToMcuEvent_notify_stream_state_tag;
+        event.Event.notify_stream_state = is_streaming;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "source") == 0 && args >= 1 && LOOKUP(m_audio_sources, arg, &value))
+    {
+        m_emulator.audio_source                = (uint32_t) value;
+        event.which_Event                      = ActionsLink_ToMcuEvent_notify_audio_source_tag;
+        event.Event.notify_audio_source.source = value;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "volume") == 0 && sscanf(p_args, "%u", &a) == 1 && a <= 127u)
+    {
+        m_emulator.avrcp_volume                         = (int32_t) a;
+        event.which_Event                               = ActionsLink_ToMcuEvent_notify_volume_tag;
+        event.Event.notify_volume.which_Volume          = ActionsLink_Audio_Volume_absolute_avrcp_tag;
+        event.Event.notify_volume.Volume.absolute_avrcp = (int32_t) a;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "avrcp-storm") == 0 && sscanf(p_args, "%u %u", &a, &b) == 2)
+    {
+        m_emulator.storm_remaining   = a;
+        m_emulator.storm_interval_ms = b;
+        m_emulator.storm_next_ms     = now_ms();
+        m_emulator.storm_step        = (m_emulator.avrcp_volume < 127) ? 1 : -1;
+        poll(now_ms());
+        return 0;
+    }
+
+    if (strcmp(name, "csb") == 0 && args >= 1 && LOOKUP(m_csb_states, arg, &value))
+    {
+        int reason = ActionsLink_Bluetooth_CsbState_CsbReceiverDisconnectReason_UNKNOWN;
+        if (args >= 2 && !LOOKUP(m_csb_disconnect_reasons, extra, &reason))
+        {
+            return -1;
+        }
+
+        m_emulator.csb_state                           = (uint32_t) value;
+        event.which_Event                              = ActionsLink_ToMcuEvent_notify_csb_state_tag;
+        event.Event.notify_csb_state.state             = value;
+        event.Event.notify_csb_state.disconnect_reason = reason;
+        send_event(&event);
+        return 0;
+    }
+
+    if (strcmp(name, "request") == 0 && args >= 1 && LOOKUP(m_requests, arg, &value))
+    {
+        ActionsLink_ToMcu message             = ActionsLink_ToMcu_init_zero;
+        message.which_Payload                 = ActionsLink_ToMcu_request_tag;
+        message.Payload.request.seq           = m_emulator.next_seq++;
+        message.Payload.request.which_Request = (pb_size_t) value;
+
+        m_emulator.stats.requests_sent++;
+        send_message(&message, 0,
+                     open_request(ACTIONSLINK_EMULATOR_TO_MCU, (uint16_t) value, message.Payload.request.seq,
+                                  now_ms()));
+        return 0;
+    }
+
+    if (sscanf(p_args, "%u", &a) == 1)
+    {
+        if (strcmp(name, "drop") == 0)
+        {
+            m_emulator.drop_frames = a;
+            return 0;
+        }
+        if (strcmp(name, "drop-ack") == 0)
+        {
+            m_emulator.drop_acks = a;
+            return 0;
+        }
+        if (strcmp(name, "nack") == 0)
+        {
+            m_emulator.nack_frames = a;
+            return 0;
+        }
+        if (strcmp(name, "corrupt-crc") == 0)
+        {
+            m_emulator.corrupt_crcs = a;
+            return 0;
+        }
+        if (strcmp(name, "jitter") == 0)
+        {
+            m_emulator.jitter_ms = a;
+            return 0;
+        }
+    }
+
+    if (strcmp(name, "latency") == 0 && sscanf(p_args, "%31s %u", arg, &a) == 2)
+    {
+        if (strcmp(arg, "ack") == 0)
+        {
+            m_emulator.ack_latency_ms = a;
+            return 0;
+        }
+        if (strcmp(arg, "response") == 0)
+        {
+            m_emulator.response_latency_ms = a;
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+int actionslink_emulator_write_buffer(const uint8_t *p_data, uint8_t length, uint32_t timeout)
+{
+    (void) timeout;
+
+    const uint32_t now = now_ms();
+    while (length > 0)
+    {
+        size_t consumed;
+        if (actionslink_hdlc_decode(&m_emulator.decoder, p_data, length, &consumed) == ACTIONSLINK_HDLC_RX_FRAME)
+        {
+            process_frame(now);
+            actionslink_hdlc_decoder_reset(&m_emulator.decoder);
+        }
+        p_data += consumed;
+        length -= (uint8_t) consumed;
+    }
+    return 0;
+}
+
+int actionslink_emulator_read_buffer(uint8_t *p_data, uint8_t length, uint32_t timeout)
+{
+    (void) timeout;
+
+    const uint32_t now = now_ms();
+    poll(now);
+
+    // Everything or nothing, the bytes due are counted first
+    size_t due = 0;
+    for (size_t i = 0; i < m_emulator.queue_count && due < length; i++)
+    {
+        const queued_frame_t *p_frame = &m_emulator.queue[(m_emulator.queue_head + i) % MAX_QUEUED_FRAMES];
+        if ((int32_t) (now - p_frame->due_ms) < 0)
+        {
+            break;
+        }
+        due += p_frame->length - p_frame->offset;
+    }
+
+    if (due < length)
+    {
+        return -1;
+    }
+    return (actionslink_emulator_read_available(p_data, length) == length) ? 0 : -1;
+}
+
+size_t actionslink_emulator_read_available(uint8_t *p_data, size_t max_length)
+{
+    const uint32_t now = now_ms();
+    poll(now);
+
+    size_t length = 0;
+    while (m_emulator.queue_count > 0 && length < max_length)
+    {
+        queued_frame_t *p_frame = &m_emulator.queue[m_emulator.queue_head];
+        if ((int32_t) (now - p_frame->due_ms) < 0)
+        {
+            break;
+        }
+
+        size_t chunk = p_frame->length - p_frame->offset;
+        if (chunk > max_length - length)
+        {
+            chunk = max_length - length;
+        }
+        memcpy(&p_data[length], &p_frame->data[p_frame->offset], chunk);
+        p_frame->offset += chunk;
+        length += chunk;
+
+        if (p_frame->offset == p_frame->length)
+        {
+            m_emulator.queue_head = (m_emulator.queue_head + 1u) % MAX_QUEUED_FRAMES;
+            m_emulator.queue_count--;
+        }
+    }
+    return length;
+}
+
+void actionslink_emulator_get_stats(actionslink_emulator_stats_t *p_stats)
+{
+    *p_stats = m_emulator.stats;
+}
+
+int actionslink_emulator_get_latency(actionslink_emulator_direction_t direction, uint16_t tag,
+                                     actionslink_emulator_latency_t *p_latency)
+{
+    size_t count = 0;
+
+    memset(p_latency, 0, sizeof(*p_latency));
+    p_latency->direction = direction;
+    p_latency->tag       = tag;
+
+    for (size_t i = 0; i < m_emulator.number_of_samples; i++)
+    {
+        const sample_t *p_sample = &m_emulator.samples[i];
+        if (p_sample->direction == direction && (tag == 0 || p_sample->tag == tag))
+        {
+            m_sorted_latencies[count++] = p_sample->latency_ms;
+            p_latency->retries += p_sample->retries;
+        }
+    }
+
+    if (count == 0)
+    {
+        return -1;
+    }
+
+    // Nearest rank percentiles
+    qsort(m_sorted_latencies, count, sizeof(m_sorted_latencies[0]), compare_latencies);
+    p_latency->count  = (uint32_t) count;
+    p_latency->p50_ms = m_sorted_latencies[(count * 50u + 99u) / 100u - 1u];
+    p_latency->p90_ms = m_sorted_latencies[(count * 90u + 99u) / 100u - 1u];
+    p_latency->p99_ms = m_sorted_latencies[(count * 99u + 99u) / 100u - 1u];
+    p_latency->max_ms = m_sorted_latencies[count - 1u];
+    return 0;
+}
+
+size_t actionslink_emulator_get_latencies(actionslink_emulator_latency_t *p_latencies, size_t max_count)
+{
+    size_t count = 0;
+
+    for (int direction = ACTIONSLINK_EMULATOR_FROM_MCU; direction <= ACTIONSLINK_EMULATOR_TO_MCU; direction++)
+    {
+        if (count < max_count && actionslink_emulator_get_latency(direction, 0, &p_latencies[count]) == 0)
+        {
+            count++;
+        }
+    }
+
+    for (int direction = ACTIONSLINK_EMULATOR_FROM_MCU; direction <= ACTIONSLINK_EMULATOR_TO_MCU; direction++)
+    {
+        // The tags are the field numbers of the oneofs, in increasing order
+        uint16_t last_tag = 0;
+        for (;;)
+        {
+            uint16_t next_tag = UINT16_MAX;
+            for (size_t i = 0; i < m_emulator.number_of_samples; i++)
+            {
+                const sample_t *p_sample = &m_emulator.samples[i];
+                if (p_sample->direction == direction && p_sample->tag > last_tag && p_sample->tag < next_tag)
+                {
+                    next_tag = p_sample->tag;
+                }
+            }
+
+            if (next_tag == UINT16_MAX || count == max_count)
+            {
+                break;
+            }
+
+            actionslink_emulator_get_latency(direction, next_tag, &p_latencies[count++]);
+            last_tag = next_tag;
+        }
+    }
+    return count;
+}
+
+static uint32_t now_ms(void)
+{
+    return m_emulator.p_config->get_tick_ms_fn();
+}
+
+// xorshift32, the same sequence for the same seed
+static uint32_t next_random(void)
+{
+    uint32_t x = m_emulator.random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    m_emulator.random = x;
+    return x;
+}
+
+static void reset_state(void)
+{
+    m_emulator.is_connected = false;
+    m_emulator.audio_source = ActionsLink_Audio_AudioSourceType_A2DP1;
+    m_emulator.csb_state    = ActionsLink_Bluetooth_CsbState_CsbStateType_DISABLED;
+    m_emulator.avrcp_volume = 64;
+}
+
+/**
+ * @brief This function does the time based work: the next steps of a storm and the frames to send again.
+ *
+ * @param[in] now       current time
+ */
+static void poll(uint32_t now)
+{
+    while (m_emulator.storm_remaining > 0 && (int32_t) (now - m_emulator.storm_next_ms) >= 0)
+    {
+        // Up and down by one step, like a volume slider on the phone
+        const int32_t volume = m_emulator.avrcp_volume + m_emulator.storm_step;
+        if (volume < 0 || volume > 127)
+        {
+            m_emulator.storm_step = -m_emulator.storm_step;
+        }
+        m_emulator.avrcp_volume += m_emulator.storm_step;
+
+        ActionsLink_ToMcuEvent event                    = ActionsLink_ToMcuEvent_init_zero;
+        event.which_Event                               = ActionsLink_ToMcuEvent_notify_volume_tag;
+        event.Event.notify_volume.which_Volume          = ActionsLink_Audio_Volume_absolute_avrcp_tag;
+        event.Event.notify_volume.Volume.absolute_avrcp = m_emulator.avrcp_volume;
+        send_event(&event);
+
+        m_emulator.storm_remaining--;
+        m_emulator.storm_next_ms += m_emulator.storm_interval_ms;
+    }
+
+    for (size_t i = 0; i < MAX_PENDING_FRAMES; i++)
+    {
+        pending_frame_t *p_pending = &m_emulator.pending[i];
+        if (p_pending->in_use && (int32_t) (now - p_pending->sent_ms) > (int32_t) ACTIONSLINK_EMULATOR_RETRY_TIMEOUT_MS)
+        {
+            retransmit(p_pending, now);
+        }
+    }
+}
+
+/**
+ * @brief This function builds a frame and queues it for the MCU.
+ * @note  The frames reach the MCU in order, the jitter only delays them.
+ *
+ * @param[in] packet_type       ACK or protobuf
+ * @param[in] value             NACK reason of an ACK packet, 0 otherwise
+ * @param[in] transaction_id    transaction ID of the frame
+ * @param[in] p_message         pointer to the payload, NULL for ACK packets
+ * @param[in] latency_ms        time the module takes to send the frame
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+static int queue_frame(uint8_t packet_type, uint8_t value, uint8_t transaction_id,
+                       const ActionsLink_ToMcu *p_message, uint32_t latency_ms)
+{
+    uint8_t payload[MAX_PAYLOAD_SIZE];
+    size_t  payload_length = 0;
+
+    if (p_message != NULL)
+    {
+        pb_ostream_t stream = pb_ostream_from_buffer(payload, sizeof(payload));
+        if (!pb_encode(&stream, ActionsLink_ToMcu_fields, p_message))
+        {
+            return -1;
+        }
+        payload_length = stream.bytes_written;
+    }
+
+    if (m_emulator.queue_count == MAX_QUEUED_FRAMES)
+    {
+        m_emulator.stats.queue_overflows++;
+        return -1;
+    }
+
+    uint8_t header[PACKET_HEADER_SIZE];
+    header[PACKET_INDEX_START_BYTE]         = PACKET_START_MAGIC_BYTE;
+    header[PACKET_INDEX_PACKET_TYPE]        = (uint8_t) ((value << 3) | packet_type);
+    header[PACKET_INDEX_TRANSACTION_ID]     = transaction_id;
+    header[PACKET_INDEX_PAYLOAD_LENGTH_LSB] = payload_length & 0xFF;
+    header[PACKET_INDEX_PAYLOAD_LENGTH_MSB] = (payload_length >> 8) & 0xFF;
+    header[PACKET_INDEX_PAYLOAD_CRC]        = actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, payload,
+                                                                    payload_length);
+    header[PACKET_INDEX_RESERVED]           = 0x00;
+
+    // A bad payload CRC for the protobuf packets, a bad header CRC for the ACKs
+    if (m_emulator.corrupt_crcs > 0 && payload_length > 0)
+    {
+        header[PACKET_INDEX_PAYLOAD_CRC] ^= 0xFF;
+    }
+    header[PACKET_INDEX_HEADER_CRC] =
+        actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, header, PACKET_HEADER_SIZE - 1);
+    m_emulator.is_last_frame_corrupted = m_emulator.corrupt_crcs > 0;
+    if (m_emulator.corrupt_crcs > 0)
+    {
+        if (payload_length == 0)
+        {
+            header[PACKET_INDEX_HEADER_CRC] ^= 0xFF;
+        }
+        m_emulator.corrupt_crcs--;
+        m_emulator.stats.crcs_corrupted++;
+    }
+
+    queued_frame_t *p_frame =
+        &m_emulator.queue[(m_emulator.queue_head + m_emulator.queue_count) % MAX_QUEUED_FRAMES];
+    p_frame->length                  = 0;
+    p_frame->offset                  = 0;
+    p_frame->data[p_frame->length++] = ACTIONSLINK_HDLC_FRAME_DELIMITER;
+
+    for (size_t i = 0; i < PACKET_HEADER_SIZE + payload_length; i++)
+    {
+        const uint8_t byte = (i < PACKET_HEADER_SIZE) ? header[i] : payload[i - PACKET_HEADER_SIZE];
+        if (actionslink_hdlc_is_escape_required(byte))
+        {
+            p_frame->data[p_frame->length++] = ACTIONSLINK_HDLC_ESCAPE_CHARACTER;
+            p_frame->data[p_frame->length++] = byte ^ ACTIONSLINK_HDLC_ESCAPE_MASK;
+        }
+        else
+        {
+            p_frame->data[p_frame->length++] = byte;
+        }
+    }
+    p_frame->data[p_frame->length++] = ACTIONSLINK_HDLC_FRAME_DELIMITER;
+
+    uint32_t due_ms = now_ms() + latency_ms;
+    if (m_emulator.jitter_ms > 0)
+    {
+        due_ms += next_random() % (m_emulator.jitter_ms + 1u);
+    }
+    if (m_emulator.queue_count > 0 && (int32_t) (due_ms - m_emulator.last_due_ms) < 0)
+    {
+        due_ms = m_emulator.last_due_ms;
+    }
+    p_frame->due_ms        = due_ms;
+    m_emulator.last_due_ms = due_ms;
+    m_emulator.queue_count++;
+    m_emulator.stats.frames_sent++;
+    return 0;
+}
+
+/**
+ * @brief This function sends a protobuf frame and keeps it until the MCU ACKs it.
+ *
+ * @param[in] p_message         pointer to the message
+ * @param[in] latency_ms        time the module takes to send the frame
+ * @param[in] request_index     open request answered or sent by this message, NO_REQUEST otherwise
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+static int send_message(const ActionsLink_ToMcu *p_message, uint32_t latency_ms, int request_index)
+{
+    const uint8_t transaction_id = m_emulator.next_transaction_id++;
+
+    if (queue_frame(PACKET_TYPE_PROTOBUF, 0, transaction_id, p_message, latency_ms) != 0)
+    {
+        return -1;
+    }
+
+    // Without a free slot, the frame is sent once and never retried
+    for (size_t i = 0; i < MAX_PENDING_FRAMES; i++)
+    {
+        pending_frame_t *p_pending = &m_emulator.pending[i];
+        if (!p_pending->in_use)
+        {
+            p_pending->in_use         = true;
+            p_pending->is_corrupted   = m_emulator.is_last_frame_corrupted;
+            p_pending->transaction_id = transaction_id;
+            p_pending->retries        = 0;
+            p_pending->sent_ms        = m_emulator.last_due_ms;
+            p_pending->request_index  = request_index;
+            p_pending->message        = *p_message;
+            break;
+        }
+    }
+    return 0;
+}
+
+static void send_event(const ActionsLink_ToMcuEvent *p_event)
+{
+    ActionsLink_ToMcu message = ActionsLink_ToMcu_init_zero;
+    message.which_Payload     = ActionsLink_ToMcu_event_tag;
+    message.Payload.event     = *p_event;
+
+    if (send_message(&message, 0, NO_REQUEST) == 0)
+    {
+        m_emulator.stats.events_sent++;
+    }
+}
+
+static void retransmit(pending_frame_t *p_pending, uint32_t now)
+{
+    if (p_pending->retries >= ACTIONSLINK_EMULATOR_MAX_RETRIES)
+    {
+        p_pending->in_use = false;
+        m_emulator.stats.module_failures++;
+        return;
+    }
+
+    p_pending->retries++;
+    p_pending->sent_ms = now;
+    m_emulator.stats.module_retries++;
+    if (p_pending->request_index != NO_REQUEST)
+    {
+        m_emulator.requests[p_pending->request_index].retries++;
+    }
+
+    // Same transaction ID, the MCU ACKs whichever copy it gets
+    if (queue_frame(PACKET_TYPE_PROTOBUF, 0, p_pending->transaction_id, &p_pending->message, 0) == 0)
+    {
+        p_pending->sent_ms      = m_emulator.last_due_ms;
+        p_pending->is_corrupted = m_emulator.is_last_frame_corrupted;
+    }
+}
+
+/**
+ * @brief This function validates a frame of the MCU, like actionslink_bt_ll.c does, and processes it.
+ *
+ * @param[in] now       current time
+ */
+static void process_frame(uint32_t now)
+{
+    const actionslink_hdlc_decoder_t *p_decoder = &m_emulator.decoder;
+    const uint8_t                    *p_rx_data = m_emulator.rx_buffer;
+    uint8_t                           reason    = 0;
+
+    if (p_decoder->received_length < PACKET_HEADER_SIZE)
+    {
+        reason = NACK_REASON_INVALID_LENGTH;
+    }
+    else if (p_decoder->received_length != p_decoder->buffered_length)
+    {
+        reason = NACK_REASON_BUSY;
+    }
+    else if (p_decoder->header_crc != p_rx_data[PACKET_INDEX_HEADER_CRC] ||
+             p_decoder->payload_crc != p_rx_data[PACKET_INDEX_PAYLOAD_CRC])
+    {
+        reason = NACK_REASON_BAD_CRC;
+    }
+    else if (p_rx_data[PACKET_INDEX_START_BYTE] != PACKET_START_MAGIC_BYTE ||
+             (p_rx_data[PACKET_INDEX_PACKET_TYPE] & 0x07) > PACKET_TYPE_PROTOBUF)
+    {
+        reason = NACK_REASON_BAD_PACKET;
+    }
+    else if (((p_rx_data[PACKET_INDEX_PAYLOAD_LENGTH_MSB] << 8) | p_rx_data[PACKET_INDEX_PAYLOAD_LENGTH_LSB]) !=
+             (int) (p_decoder->buffered_length - PACKET_HEADER_SIZE))
+    {
+        reason = NACK_REASON_INVALID_LENGTH;
+    }
+
+    if (reason != 0)
+    {
+        m_emulator.stats.bad_frames++;
+        m_emulator.stats.nacks_sent++;
+        queue_frame(PACKET_TYPE_ACK, reason, 0, NULL, m_emulator.ack_latency_ms);
+        return;
+    }
+
+    const uint8_t  packet_type    = p_rx_data[PACKET_INDEX_PACKET_TYPE] & 0x07;
+    const uint8_t  value          = p_rx_data[PACKET_INDEX_PACKET_TYPE] >> 3;
+    const uint8_t  transaction_id = p_rx_data[PACKET_INDEX_TRANSACTION_ID];
+    const uint16_t payload_length = (uint16_t) (p_decoder->buffered_length - PACKET_HEADER_SIZE);
+
+    m_emulator.stats.frames_received++;
+    if (packet_type == PACKET_TYPE_ACK)
+    {
+        process_ack(transaction_id, value, now);
+        return;
+    }
+
+    ActionsLink_FromMcu message   = ActionsLink_FromMcu_init_zero;
+    pb_istream_t        stream_in = pb_istream_from_buffer(&p_rx_data[PACKET_INDEX_PAYLOAD_START], payload_length);
+    if (payload_length == 0 || !pb_decode(&stream_in, ActionsLink_FromMcu_fields, &message))
+    {
+        m_emulator.stats.bad_frames++;
+        m_emulator.stats.nacks_sent++;
+        queue_frame(PACKET_TYPE_ACK, NACK_REASON_BAD_PACKET, 0, NULL, m_emulator.ack_latency_ms);
+        return;
+    }
+
+    // Lost on the wire: no ACK, no response. The request is still recorded, its latency starts here.
+    if (m_emulator.drop_frames > 0)
+    {
+        m_emulator.drop_frames--;
+        m_emulator.stats.frames_dropped++;
+        process_message(&message, false, now);
+        return;
+    }
+
+    if (m_emulator.nack_frames > 0)
+    {
+        m_emulator.nack_frames--;
+        m_emulator.stats.nacks_sent++;
+        queue_frame(PACKET_TYPE_ACK, NACK_REASON_BUSY, transaction_id, NULL, m_emulator.ack_latency_ms);
+        process_message(&message, false, now);
+        return;
+    }
+
+    // The module got the frame, but its ACK is lost
+    if (m_emulator.drop_acks > 0)
+    {
+        m_emulator.drop_acks--;
+        m_emulator.stats.acks_dropped++;
+    }
+    else
+    {
+        queue_frame(PACKET_TYPE_ACK, 0, transaction_id, NULL, m_emulator.ack_latency_ms);
+    }
+
+    process_message(&message, true, now);
+}
+
+static void process_ack(uint8_t transaction_id, uint8_t value, uint32_t now)
+{
+    pending_frame_t *p_nacked = NULL;
+
+    for (size_t i = 0; i < MAX_PENDING_FRAMES; i++)
+    {
+        pending_frame_t *p_pending = &m_emulator.pending[i];
+        if (!p_pending->in_use)
+        {
+            continue;
+        }
+
+        if (value == 0 && p_pending->transaction_id == transaction_id)
+        {
+            p_pending->in_use = false;
+
+            // The response of a request of the MCU is delivered
+            const int request_index = p_pending->request_index;
+            if (request_index != NO_REQUEST &&
+                m_emulator.requests[request_index].direction == ACTIONSLINK_EMULATOR_FROM_MCU)
+            {
+                close_request(request_index, now);
+            }
+            return;
+        }
+
+        // Only the frames already on the MCU side can be NACKed
+        if ((int32_t) (now - p_pending->sent_ms) < 0)
+        {
+            continue;
+        }
+
+        if (p_nacked == NULL || (p_pending->is_corrupted && !p_nacked->is_corrupted) ||
+            (p_pending->is_corrupted == p_nacked->is_corrupted &&
+             (int32_t) (p_pending->sent_ms - p_nacked->sent_ms) < 0))
+        {
+            p_nacked = p_pending;
+        }
+    }
+
+    // The MCU can't tell which frame it NACKs (its transaction ID is 0): a corrupted frame goes again, else the
+    // oldest one
+    if (value != 0)
+    {
+        m_emulator.stats.nacks_received++;
+        if (p_nacked != NULL)
+        {
+            retransmit(p_nacked, now);
+        }
+    }
+}
+
+/**
+ * @brief This function processes a message of the MCU.
+ *
+ * @param[in] p_message     pointer to the message
+ * @param[in] is_received   false if the frame was dropped or NACKed, only the request is recorded then
+ * @param[in] now           current time
+ */
+static void process_message(const ActionsLink_FromMcu *p_message, bool is_received, uint32_t now)
+{
+    switch (p_message->which_Payload)
+    {
+        case ActionsLink_FromMcu_request_tag:
+        {
+            const ActionsLink_FromMcuRequest *p_request = &p_message->Payload.request;
+
+            int request_index = find_request(ACTIONSLINK_EMULATOR_FROM_MCU, p_request->which_Request, p_request->seq);
+
+            m_emulator.stats.requests_received++;
+            if (request_index != NO_REQUEST)
+            {
+                // Sent again by the MCU, the module answers again
+                m_emulator.requests[request_index].retries++;
+                m_emulator.stats.mcu_retries++;
+            }
+            else
+            {
+                request_index =
+                    open_request(ACTIONSLINK_EMULATOR_FROM_MCU, p_request->which_Request, p_request->seq, now);
+            }
+
+            if (is_received)
+            {
+                answer_request(p_request, request_index);
+            }
+            break;
+        }
+
+        case ActionsLink_FromMcu_response_tag:
+        {
+            const ActionsLink_FromMcuResponse *p_response = &p_message->Payload.response;
+            const int request_index =
+                find_request(ACTIONSLINK_EMULATOR_TO_MCU, p_response->which_Response, p_response->seq);
+            if (is_received && request_index != NO_REQUEST)
+            {
+                close_request(request_index, now);
+            }
+            break;
+        }
+
+        case ActionsLink_FromMcu_event_tag:
+            if (is_received)
+            {
+                m_emulator.stats.events_received++;
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**
+ * @brief This function sends the response to a request of the MCU, and the events the module sends
+ *        after some of them.
+ *
+ * @param[in] p_request         pointer to the request
+ * @param[in] request_index     open request of the MCU
+ */
+static void answer_request(const ActionsLink_FromMcuRequest *p_request, int request_index)
+{
+    ActionsLink_ToMcu message               = ActionsLink_ToMcu_init_zero;
+    message.which_Payload                   = ActionsLink_ToMcu_response_tag;
+    message.Payload.response.seq            = p_request->seq;
+    message.Payload.response.which_Response = p_request->which_Request;
+
+    // The other responses are a successful Common.Result or empty
+    ActionsLink_ToMcuResponse *p_response = &message.Payload.response;
+    switch (p_request->which_Request)
+    {
+        case ActionsLink_FromMcuRequest_get_firmware_version_tag:
+            p_response->Response.get_firmware_version.major = 1;
+            break;
+        case ActionsLink_FromMcuRequest_get_a2dp_data_tag:
+        {
+            ActionsLink_Bluetooth_ResponseA2dpData *p_a2dp_data = &p_response->Response.get_a2dp_data;
+            p_a2dp_data->which_Result                           = ActionsLink_Bluetooth_ResponseA2dpData_data_tag;
+            p_a2dp_data->Result.data.channel_mode               = ActionsLink_Bluetooth_ChannelMode_Stereo;
+            p_a2dp_data->Result.data.codec                      = ActionsLink_Bluetooth_CodecType_SBC;
+            p_a2dp_data->Result.data.sample_rate                = 44100u;
+            break;
+        }
+        case ActionsLink_FromMcuRequest_get_bt_connection_state_tag:
+            p_response->Response.get_bt_connection_state.which_Result =
+                ActionsLink_Bluetooth_ResponseConnectionState_state_tag;
+            p_response->Response.get_bt_connection_state.Result.state.state =
+                m_emulator.is_connected ? ActionsLink_Bluetooth_ConnectionState_ConnectionType_CONNECTED
+                                        : ActionsLink_Bluetooth_ConnectionState_ConnectionType_DISCONNECTED;
+            break;
+        case ActionsLink_FromMcuRequest_get_csb_state_tag:
+            p_response->Response.get_csb_state.which_Result       = ActionsLink_Bluetooth_ResponseCsbState_state_tag;
+            p_response->Response.get_csb_state.Result.state.state = m_emulator.csb_state;
+            break;
+        default:
+            break;
+    }
+
+    send_message(&message, m_emulator.response_latency_ms, request_index);
+
+    ActionsLink_ToMcuEvent event = ActionsLink_ToMcuEvent_init_zero;
+    switch (p_request->which_Request)
+    {
+        case ActionsLink_FromMcuRequest_set_power_state_tag:
+            event.which_Event                   = ActionsLink_ToMcuEvent_notify_power_state_tag;
+            event.Event.notify_power_state.mode = p_request->Request.set_power_state.mode;
+            send_event(&event);
+
+            // Once powered on, the module reports its audio source
+            if (p_request->Request.set_power_state.mode == ActionsLink_System_PowerState_SystemPowerMode_ON)
+            {
+                event.which_Event                      = ActionsLink_ToMcuEvent_notify_audio_source_tag;
+                event.Event.notify_audio_source.source = m_emulator.audio_source;
+                send_event(&event);
+            }
+            break;
+
+        case ActionsLink_FromMcuRequest_set_audio_source_tag:
+            m_emulator.audio_source                = p_request->Request.set_audio_source.source;
+            event.which_Event                      = ActionsLink_ToMcuEvent_notify_audio_source_tag;
+            event.Event.notify_audio_source.source = m_emulator.audio_source;
+            send_event(&event);
+            break;
+
+        case ActionsLink_FromMcuRequest_disconnect_all_bt_devices_tag:
+            if (m_emulator.is_connected)
+            {
+                actionslink_emulator_run("disconnect user");
+            }
+            break;
+
+        case ActionsLink_FromMcuRequest_exit_csb_mode_tag:
+            m_emulator.csb_state               = ActionsLink_Bluetooth_CsbState_CsbStateType_DISABLED;
+            event.which_Event                  = ActionsLink_ToMcuEvent_notify_csb_state_tag;
+            event.Event.notify_csb_state.state = m_emulator.csb_state;
+            send_event(&event);
+            break;
+
+        default:
+            break;
+    }
+}
+
+static int open_request(actionslink_emulator_direction_t direction, uint16_t tag, uint32_t seq, uint32_t now)
+{
+    for (int i = 0; i < (int) MAX_OPEN_REQUESTS; i++)
+    {
+        open_request_t *p_request = &m_emulator.requests[i];
+        if (!p_request->in_use)
+        {
+            p_request->in_use    = true;
+            p_request->direction = direction;
+            p_request->tag       = tag;
+            p_request->seq       = seq;
+            p_request->first_ms  = now;
+            p_request->retries   = 0;
+            m_emulator.stats.requests_pending++;
+            return i;
+        }
+    }
+
+    // Not measured, e.g. the MCU doesn't answer the requests of the emulator
+    return NO_REQUEST;
+}
+
+static int find_request(actionslink_emulator_direction_t direction, uint16_t tag, uint32_t seq)
+{
+    for (int i = 0; i < (int) MAX_OPEN_REQUESTS; i++)
+    {
+        const open_request_t *p_request = &m_emulator.requests[i];
+        if (p_request->in_use && p_request->direction == direction && p_request->tag == tag && p_request->seq == seq)
+        {
+            return i;
+        }
+    }
+    return NO_REQUEST;
+}
+
+static void close_request(int request_index, uint32_t now)
+{
+    open_request_t *p_request = &m_emulator.requests[request_index];
+
+    if (m_emulator.number_of_samples < ACTIONSLINK_EMULATOR_MAX_SAMPLES)
+    {
+        sample_t *p_sample   = &m_emulator.samples[m_emulator.number_of_samples++];
+        p_sample->direction  = (uint8_t) p_request->direction;
+        p_sample->tag        = p_request->tag;
+        p_sample->retries    = p_request->retries;
+        p_sample->latency_ms = now - p_request->first_ms;
+    }
+    else
+    {
+        m_emulator.stats.samples_dropped++;
+    }
+
+    p_request->in_use = false;
+    m_emulator.stats.requests_pending--;
+
+    // The other copies of the response still waiting for their ACK don't refer to it anymore
+    for (size_t i = 0; i < MAX_PENDING_FRAMES; i++)
+    {
+        if (m_emulator.pending[i].request_index == request_index)
+        {
+            m_emulator.pending[i].request_index = NO_REQUEST;
+        }
+    }
+}
+
+static bool lookup(const name_value_t *p_table, size_t size, const char *p_name, int *p_value)
+{
+    for (size_t i = 0; i < size; i++)
+    {
+        if (strcmp(p_table[i].name, p_name) == 0)
+        {
+            *p_value = p_table[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+static int compare_latencies(const void *p_a, const void *p_b)
+{
+    const uint32_t a = *(const uint32_t *) p_a;
+    const uint32_t b = *(const uint32_t *) p_b;
+    return (a > b) - (a < b);
+}
@@ -0,0 +1,184 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "actionslink_types.h"
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+/*
+ * Host side emulator of the Actions module, for load testing the transport and the handlers of the application
+ * without the module. It speaks the same HDLC framing and nanopb messages as the module: the MCU frames are
+ * decoded, ACKed and the requests answered, and scenario commands send the events of the module (connection,
+ * stream, AVRCP volume storms, CSB state) or inject faults (lost frames, lost ACKs, NACKs, corrupted CRCs).
+ *
+ * The emulator is plugged into the transport through the write and read hooks of actionslink_config_t, or by
+ * a UART model passing the bytes on. It has no thread: the time based work (latencies, timeouts, storms) is done
+ * when the MCU side reads. All the random delays come from a PRNG seeded by the configuration, so a scenario
+ * gives the same result on every run.
+ *
+ * The latency of a request is measured from its first transmission to the ACK of its response by the MCU (for
+ * the requests of the MCU) or to the response of the MCU (for the requests of the module). The retries are the
+ * transmissions after the first one, by the MCU or by the emulator.
+ */
+
+// Frames the emulator sends again if the MCU doesn't ACK them in time, like the transport of the MCU
+#ifndef ACTIONSLINK_EMULATOR_RETRY_TIMEOUT_MS
+#define ACTIONSLINK_EMULATOR_RETRY_TIMEOUT_MS (300u)
+#endif
+
+#ifndef ACTIONSLINK_EMULATOR_MAX_RETRIES
+#define ACTIONSLINK_EMULATOR_MAX_RETRIES (2u)
+#endif
+
+// Latencies kept for the percentiles, the later requests are only counted
+#ifndef ACTIONSLINK_EMULATOR_MAX_SAMPLES
+#define ACTIONSLINK_EMULATOR_MAX_SAMPLES (8192u)
+#endif
+
+typedef enum {
+    ACTIONSLINK_EMULATOR_FROM_MCU, // Requests of the MCU, answered by the emulator
+    ACTIONSLINK_EMULATOR_TO_MCU,   // Requests of the emulator, answered by the MCU
+} actionslink_emulator_direction_t;
+
+typedef struct
+{
+    actionslink_get_tick_ms_fn_t get_tick_ms_fn;      // Mandatory function, the time of the MCU side
+    uint32_t                     seed;                // Seed of the jitter, 0 is replaced by 1
+    uint32_t                     ack_latency_ms;      // Time between a frame of the MCU and its ACK
+    uint32_t                     response_latency_ms; // Time between a request of the MCU and its response
+    uint32_t                     jitter_ms;           // Random delay added to every frame, 0 to jitter_ms
+} actionslink_emulator_config_t;
+
+typedef struct
+{
+    uint32_t frames_received;   // Valid frames of the MCU, ACKs included
+    uint32_t frames_sent;       // Frames to the MCU, ACKs and retries included
+    uint32_t bad_frames;        // Frames of the MCU with a wrong length, CRC or payload
+    uint32_t requests_received; // Requests of the MCU, retries included
+    uint32_t requests_sent;     // Requests of the emulator
+    uint32_t requests_pending;  // Requests of both sides not answered yet
+    uint32_t events_received;   // Events of the MCU, retries included
+    uint32_t events_sent;       // Events of the emulator
+    uint32_t mcu_retries;       // Requests the MCU sent again
+    uint32_t module_retries;    // Frames the emulator sent again after a NACK or a timeout
+    uint32_t module_failures;   // Frames the MCU never ACKed, after all the retries
+    uint32_t nacks_received;
+    uint32_t nacks_sent;
+    uint32_t frames_dropped; // Injected faults
+    uint32_t acks_dropped;
+    uint32_t crcs_corrupted;
+    uint32_t queue_overflows; // Frames to the MCU lost because the emulator queue was full
+    uint32_t samples_dropped; // Latencies not kept for the percentiles
+} actionslink_emulator_stats_t;
+
+typedef struct
+{
+    actionslink_emulator_direction_t direction;
+    uint16_t                         tag;     // Field number of the request in message.proto, 0 for all of them
+    uint32_t                         count;   // Answered requests
+    uint32_t                         retries; // Retries of the answered requests
+    uint32_t                         p50_ms;
+    uint32_t                         p90_ms;
+    uint32_t                         p99_ms;
+    uint32_t                         max_ms;
+} actionslink_emulator_latency_t;
+
+/**
+ * @brief Initializes the emulator and clears its statistics.
+ *
+ * @param[in] p_config      pointer to the configuration, must remain valid
+ */
+void actionslink_emulator_init(const actionslink_emulator_config_t *p_config);
+
+/**
+ * @brief Resets the emulated module, e.g. when its reset pin is asserted: the frames in flight and the state of
+ *        the module are cleared. The statistics and the injected faults are kept.
+ */
+void actionslink_emulator_reset(void);
+
+/**
+ * @brief Runs a scenario command:
+ *        - events of the module: ready, power <on|off|standby>, connect [address], disconnect [link-loss|user],
+ *          stream <on|off>, source <a2dp1|a2dp2|usb|analog>, volume <0-127>, avrcp-storm <count> <interval_ms>,
+ *          csb <disabled|broadcasting|receiver-pairing|receiver-connected> [unknown|user|power-off|link-loss]
+ *        - requests of the module: request <get_... field of ToMcuRequest>, e.g. request get_battery_capacity
+ *        - faults on the next frames: drop <n>, drop-ack <n>, nack <n>, corrupt-crc <n>
+ *        - timing: jitter <ms>, latency <ack|response> <ms>
+ *
+ * @param[in] p_command     command and its arguments, e.g. "avrcp-storm 50 10"
+ *
+ * @return 0 if successful, -1 if the command is unknown or its arguments are invalid
+ */
+int actionslink_emulator_run(const char *p_command);
+
+/**
+ * @brief Bytes sent by the MCU to the module, an actionslink_write_buffer_fn_t.
+ *
+ * @param[in] p_data        pointer to the bytes
+ * @param[in] length        number of bytes
+ * @param[in] timeout       unused, the bytes are always taken
+ *
+ * @return 0
+ */
+int actionslink_emulator_write_buffer(const uint8_t *p_data, uint8_t length, uint32_t timeout);
+
+/**
+ * @brief Bytes sent by the module to the MCU, an actionslink_read_buffer_fn_t.
+ * @note  Doesn't wait: the bytes are read only if that many are due at the current time.
+ *
+ * @param[out] p_data       pointer to where the bytes will be written
+ * @param[in]  length       number of bytes to read
+ * @param[in]  timeout      unused
+ *
+ * @return 0 if successful, -1 if fewer bytes are due
+ */
+int actionslink_emulator_read_buffer(uint8_t *p_data, uint8_t length, uint32_t timeout);
+
+/**
+ * @brief All the bytes sent by the module to the MCU which are due at the current time,
+ *        an actionslink_read_available_fn_t.
+ *
+ * @param[out] p_data       pointer to where the bytes will be written
+ * @param[in]  max_length   maximum number of bytes to read
+ *
+ * @return number of bytes read
+ */
+size_t actionslink_emulator_read_available(uint8_t *p_data, size_t max_length);
+
+/**
+ * @brief Gets the statistics since the initialization.
+ *
+ * @param[out] p_stats      pointer to where the statistics will be written
+ */
+void actionslink_emulator_get_stats(actionslink_emulator_stats_t *p_stats);
+
+/**
+ * @brief Gets the latency percentiles of the answered requests.
+ *
+ * @param[in]  direction    requests of the MCU or of the emulator
+ * @param[in]  tag          field number of the request, 0 for all the requests of the direction
+ * @param[out] p_latency    pointer to where the latencies will be written
+ *
+ * @return 0 if successful, -1 if no such request was answered
+ */
+int actionslink_emulator_get_latency(actionslink_emulator_direction_t direction, uint16_t tag,
+                                     actionslink_emulator_latency_t *p_latency);
+
+/**
+ * @brief Gets the latency percentiles of all the answered requests of both directions, then of each request.
+ *
+ * @param[out] p_latencies  pointer to where the latencies will be written
+ * @param[in]  max_count    maximum number of latencies to write
+ *
+ * @return number of latencies written
+ */
+size_t actionslink_emulator_get_latencies(actionslink_emulator_latency_t *p_latencies, size_t max_count);
+
+#if defined(__cplusplus)
+}
+#endif
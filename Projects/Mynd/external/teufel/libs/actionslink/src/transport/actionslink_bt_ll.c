@@ -1,17 +1,16 @@
 #include "actionslink_bt_ll.h"
+#include "actionslink_hdlc.h"
 #include "actionslink_log.h"
 #include "actionslink_utils.h"
 #include "pb_encode.h"
 #include "pb_decode.h"
 #include <string.h>
 
-// We build the frames according to the HDLC protocol
-// see https://en.wikipedia.org/wiki/High-Level_Data_Link_Control
-#define HDLC_FRAME_DELIMITER            (0x7Eu)
-#define HDLC_ESCAPE_CHARACTER           (0x7Du)
-#define HDLC_ESCAPE_MASK                (0x20u)
+#define HDLC_FRAME_DELIMITER            ACTIONSLINK_HDLC_FRAME_DELIMITER
+#define HDLC_ESCAPE_CHARACTER           ACTIONSLINK_HDLC_ESCAPE_CHARACTER
+#define HDLC_ESCAPE_MASK                ACTIONSLINK_HDLC_ESCAPE_MASK
 
-#define INITIAL_CRC8_VALUE              (0x00u)
+#define INITIAL_CRC8_VALUE              ACTIONSLINK_HDLC_INITIAL_CRC8
 
 #define PACKET_HEADER_SIZE              (8u)
 #define PACKET_START_MAGIC_BYTE         (0x55u)
@@ -30,7 +29,12 @@
 #define UART_RX_TIMEOUT_MS          (100u)
 #define EXPECTED_BYTE_RX_TIMEOUT_MS (1u)
 
-#define PROCESS_FRAME_INCOMPLETE    (-1)
+// Room for the start delimiter and the header with all its bytes escaped
+#define TX_FRAME_HEADROOM           (1u + 2u * PACKET_HEADER_SIZE)
+
+// Bytes read per call when the rx buffer is already full and the rest of the frame is discarded
+#define OVERFLOW_CHUNK_SIZE         (16u)
+
 #define PROCESS_FRAME_ERROR         (-2)
 
 #define NACK_REASON_BAD_PACKET      (1u)
@@ -38,26 +42,31 @@
 #define NACK_REASON_INVALID_LENGTH  (3u)
 #define NACK_REASON_BUSY            (4u)
 
-typedef enum
+typedef struct
 {
-    TRANSPORT_STATE_DATA,
-    TRANSPORT_STATE_ESCAPED_DATA,
-} transport_state_t;
+    uint8_t *p_buffer;
+    size_t   index; // Where the next escaped byte is written to
+    size_t   end;   // Index reserved for the end frame delimiter
+    uint8_t  crc;   // CRC8 of the unescaped payload written so far
+} tx_frame_stream_t;
 
 static struct
 {
     const actionslink_config_t *p_config;
-    transport_state_t       state;
-    size_t                  received_data_length;
-    size_t                  buffered_data_length;
-    uint32_t                last_rx_timestamp;
+    actionslink_hdlc_decoder_t  decoder;
+    const uint8_t              *p_pending;      // Raw bytes read after the last completed frame
+    size_t                      pending_length; // Number of raw bytes still to be decoded
+    uint32_t                    last_rx_timestamp;
 } m_bt_ll;
 
+static uint8_t m_overflow_chunk[OVERFLOW_CHUNK_SIZE];
+
 static void    reset_transport_state(void);
-static size_t  get_number_of_escaped_chars(const uint8_t *p_buffer, size_t length);
-static bool    is_escape_required(uint8_t byte);
-static uint8_t calculate_crc8(uint8_t crc, const uint8_t *p_buffer, size_t length);
-static int     process_received_byte(uint8_t byte, actionslink_bt_ll_rx_packet_t *p_packet);
+static int     get_tx_buffer(uint8_t **pp_buffer, size_t *p_size);
+static int     send_tx_frame(const uint8_t *p_frame, size_t length);
+static bool    write_escaped_payload(pb_ostream_t *p_stream, const pb_byte_t *p_data, size_t length);
+static size_t  read_raw_data(uint8_t *p_data, size_t max_length);
+static int     process_received_frame(actionslink_bt_ll_rx_packet_t *p_packet);
 static int     validate_received_data(actionslink_bt_ll_rx_packet_t *p_packet);
 static int     send_ack(uint8_t transaction_id);
 static int     send_nack(uint8_t transaction_id, uint8_t nack_reason);
@@ -65,104 +74,91 @@ static int     send_nack(uint8_t transaction_id, uint8_t nack_reason);
 void actionslink_bt_ll_init(const actionslink_config_t *p_config)
 {
     m_bt_ll.p_config = p_config;
+    actionslink_hdlc_decoder_init(&m_bt_ll.decoder, p_config->p_rx_buffer, p_config->rx_buffer_size,
+                                  PACKET_HEADER_SIZE);
     actionslink_bt_ll_reset();
 }
 
 void actionslink_bt_ll_reset(void)
 {
     reset_transport_state();
+    m_bt_ll.p_pending      = NULL;
+    m_bt_ll.pending_length = 0;
     log_debug("bt_ll: transport state reset");
 }
 
 int actionslink_bt_ll_tx(const actionslink_bt_ll_tx_packet_t *p_packet)
 {
-    uint8_t *p_tx_buffer                     = m_bt_ll.p_config->p_tx_buffer;
-    uint16_t tx_buffer_size                  = m_bt_ll.p_config->tx_buffer_size;
-    p_tx_buffer[PACKET_INDEX_START_BYTE]     = PACKET_START_MAGIC_BYTE;
-    p_tx_buffer[PACKET_INDEX_PACKET_TYPE]    = (p_packet->value << 3) | p_packet->packet_type;
-    p_tx_buffer[PACKET_INDEX_TRANSACTION_ID] = p_packet->transaction_id;
-    p_tx_buffer[PACKET_INDEX_RESERVED]       = 0x00;
-
-    size_t payload_length;
-    if (p_packet->p_payload != NULL)
+    uint8_t *p_tx_buffer;
+    size_t   tx_buffer_size;
+    if (get_tx_buffer(&p_tx_buffer, &tx_buffer_size) != 0)
     {
-        if (!pb_get_encoded_size(&payload_length, ActionsLink_FromMcu_fields, p_packet->p_payload))
-        {
-            log_error("bt_ll: failed to calculate encoded payload size");
-            return -1;
-        }
-
-        pb_ostream_t stream_out = pb_ostream_from_buffer(&p_tx_buffer[PACKET_INDEX_PAYLOAD_START], tx_buffer_size - PACKET_HEADER_SIZE);
-        if (!pb_encode(&stream_out, ActionsLink_FromMcu_fields, p_packet->p_payload))
-        {
-            log_error("bt_ll: failed to encode payload");
-            return -1;
-        }
-
-        uint8_t payload_crc = calculate_crc8(INITIAL_CRC8_VALUE, &p_tx_buffer[PACKET_INDEX_PAYLOAD_START], payload_length);
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_LENGTH_LSB] = payload_length & 0xFF;
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_LENGTH_MSB] = (payload_length >> 8) & 0xFF;
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_CRC] = payload_crc;
+        log_error("bt_ll: no tx buffer available");
+        return -1;
     }
-    else
+
+    // Leave room for the escaped header and both frame delimiters
+    if (tx_buffer_size < TX_FRAME_HEADROOM + 1)
     {
-        payload_length = 0;
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_LENGTH_LSB] = 0;
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_LENGTH_MSB] = 0;
-        p_tx_buffer[PACKET_INDEX_PAYLOAD_CRC] = INITIAL_CRC8_VALUE;
+        log_error("bt_ll: tx buffer is not large enough for tx (%d available)", tx_buffer_size);
+        return -1;
     }
 
-    uint8_t header_crc = calculate_crc8(INITIAL_CRC8_VALUE, p_tx_buffer, PACKET_HEADER_SIZE - 1);
-    p_tx_buffer[PACKET_INDEX_HEADER_CRC] = header_crc;
-
-    size_t escaped_chars_in_header  = get_number_of_escaped_chars(p_tx_buffer, PACKET_HEADER_SIZE);
-    size_t escaped_chars_in_payload = get_number_of_escaped_chars(&p_tx_buffer[PACKET_INDEX_PAYLOAD_START], payload_length);
+    // The payload is encoded only once, it is escaped and its CRC calculated on the fly
+    // while nanopb writes it right after the room reserved for the header
+    tx_frame_stream_t frame = {
+        .p_buffer = p_tx_buffer,
+        .index    = TX_FRAME_HEADROOM,
+        .end      = tx_buffer_size - 1,
+        .crc      = INITIAL_CRC8_VALUE,
+    };
 
-    // The amount of data to send is header + payload,
-    // plus one extra byte per escaped byte
-    // plus 2 bytes for start/end frame delimiters,
-    size_t total_length = PACKET_HEADER_SIZE + payload_length + escaped_chars_in_header + escaped_chars_in_payload + 2;
-    if (total_length > tx_buffer_size)
+    size_t payload_length = 0;
+    if (p_packet->p_payload != NULL)
     {
-        log_error("bt_ll: tx buffer is not large enough for tx (%d required)", total_length);
-        return -1;
+        pb_ostream_t stream_out = {
+            .callback      = write_escaped_payload,
+            .state         = &frame,
+            .max_size      = SIZE_MAX,
+            .bytes_written = 0,
+        };
+        if (!pb_encode(&stream_out, ActionsLink_FromMcu_fields, p_packet->p_payload))
+        {
+            log_error("bt_ll: failed to encode payload (%d bytes of tx buffer available)", tx_buffer_size);
+            return -1;
+        }
+        payload_length = stream_out.bytes_written;
     }
 
-    // We reuse the same buffer to build the HDLC frame
-    // We start writing to the end of the buffer,
-    // moving the bytes from the end of the original payload
-    // to their final positions in the tx frame.
-    // The index of any given byte in the original payload is always
-    // lower than its index in the final tx frame, so this is safe
-    // i.e. payload[0] is always frame[1], payload[1] is always frame[2] or frame[3], ...
-    size_t index_in_escaped_array         = total_length - 1;
-    p_tx_buffer[index_in_escaped_array--] = HDLC_FRAME_DELIMITER;
-
-    uint32_t length_before_escaping_data = PACKET_HEADER_SIZE + payload_length;
-    for (int i = length_before_escaping_data - 1; i >= 0; i--)
+    uint8_t header[PACKET_HEADER_SIZE];
+    header[PACKET_INDEX_START_BYTE]         = PACKET_START_MAGIC_BYTE;
+    header[PACKET_INDEX_PACKET_TYPE]        = (p_packet->value << 3) | p_packet->packet_type;
+    header[PACKET_INDEX_TRANSACTION_ID]     = p_packet->transaction_id;
+    header[PACKET_INDEX_PAYLOAD_LENGTH_LSB] = payload_length & 0xFF;
+    header[PACKET_INDEX_PAYLOAD_LENGTH_MSB] = (payload_length >> 8) & 0xFF;
+    header[PACKET_INDEX_PAYLOAD_CRC]        = frame.crc;
+    header[PACKET_INDEX_RESERVED]           = 0x00;
+    header[PACKET_INDEX_HEADER_CRC]         = actionslink_hdlc_crc8(INITIAL_CRC8_VALUE, header, PACKET_HEADER_SIZE - 1);
+
+    // The header is escaped backwards, so that it ends right in front of the payload.
+    // The frame then starts somewhere within the reserved room
+    size_t frame_start = TX_FRAME_HEADROOM;
+    for (int i = PACKET_HEADER_SIZE - 1; i >= 0; i--)
     {
-        if (is_escape_required(p_tx_buffer[i]))
+        if (actionslink_hdlc_is_escape_required(header[i]))
         {
-            p_tx_buffer[index_in_escaped_array--] = p_tx_buffer[i] ^ HDLC_ESCAPE_MASK;
-            p_tx_buffer[index_in_escaped_array--] = HDLC_ESCAPE_CHARACTER;
+            p_tx_buffer[--frame_start] = header[i] ^ HDLC_ESCAPE_MASK;
+            p_tx_buffer[--frame_start] = HDLC_ESCAPE_CHARACTER;
         }
         else
         {
-            p_tx_buffer[index_in_escaped_array--] = p_tx_buffer[i];
+            p_tx_buffer[--frame_start] = header[i];
         }
     }
+    p_tx_buffer[--frame_start] = HDLC_FRAME_DELIMITER;
+    p_tx_buffer[frame.index++] = HDLC_FRAME_DELIMITER;
 
-    // After moving each byte in the payload to its respective index,
-    // we should have ended with index 0, where the frame delimiter goes
-    if (index_in_escaped_array != 0)
-    {
-        log_error("bt_ll: failed to construct tx frame");
-        return -1;
-    }
-
-    p_tx_buffer[0] = HDLC_FRAME_DELIMITER;
-
-    int ret_val = m_bt_ll.p_config->write_buffer_fn(p_tx_buffer, total_length, UART_TX_TIMEOUT_MS);
+    int ret_val = send_tx_frame(&p_tx_buffer[frame_start], frame.index - frame_start);
     if (ret_val != 0)
     {
         log_error("bt_ll: failed to send data over UART");
@@ -173,34 +169,55 @@ int actionslink_bt_ll_tx(const actionslink_bt_ll_tx_packet_t *p_packet)
 
 int actionslink_bt_ll_rx(actionslink_bt_ll_rx_packet_t *p_packet)
 {
-    uint8_t byte;
-    while (m_bt_ll.p_config->read_buffer_fn(&byte, 1, EXPECTED_BYTE_RX_TIMEOUT_MS) == 0)
-    {
-        m_bt_ll.last_rx_timestamp = actionslink_utils_get_ms();
+    actionslink_hdlc_decoder_t *p_decoder = &m_bt_ll.decoder;
 
-        // Process the next byte and if it completes a command propagate the data to the caller
-        int rx_result = process_received_byte(byte, p_packet);
-        if (rx_result >= 0)
+    for (;;)
+    {
+        if (m_bt_ll.pending_length == 0)
         {
-            reset_transport_state();
-            return 1;
+            // Read straight into the free tail of the rx buffer, the decoder unescapes the bytes
+            // in place. Once the buffer is full, the rest of the frame is only counted
+            uint8_t *p_read = m_bt_ll.p_config->p_rx_buffer + p_decoder->buffered_length;
+            size_t   free   = p_decoder->buffer_size - p_decoder->buffered_length;
+            if (free == 0)
+            {
+                p_read = m_overflow_chunk;
+                free   = sizeof(m_overflow_chunk);
+            }
+
+            m_bt_ll.pending_length = read_raw_data(p_read, free);
+            m_bt_ll.p_pending      = p_read;
+            if (m_bt_ll.pending_length == 0)
+            {
+                break;
+            }
+            m_bt_ll.last_rx_timestamp = actionslink_utils_get_ms();
         }
 
-        // Return if there were any frame errors
-        if (rx_result == PROCESS_FRAME_ERROR)
+        size_t consumed;
+        actionslink_hdlc_rx_result_t rx_result =
+            actionslink_hdlc_decode(p_decoder, m_bt_ll.p_pending, m_bt_ll.pending_length, &consumed);
+        m_bt_ll.p_pending      += consumed;
+        m_bt_ll.pending_length -= consumed;
+
+        // A complete frame was received, propagate the data to the caller.
+        // The remaining raw bytes always lie after the frame in the rx buffer,
+        // so they are decoded in place on the next call
+        if (rx_result == ACTIONSLINK_HDLC_RX_FRAME)
         {
+            int ret_val = process_received_frame(p_packet);
             reset_transport_state();
-            return -1;
+            return (ret_val == 0) ? 1 : -1;
         }
     }
 
     // Check for RX timeouts
     if (actionslink_utils_get_ms_since(m_bt_ll.last_rx_timestamp) > UART_RX_TIMEOUT_MS)
     {
-        if (m_bt_ll.received_data_length > 0)
+        if (p_decoder->received_length > 0)
         {
             log_debug("bt_ll: timeout -> discarding partial frame (%d bytes)",
-                        m_bt_ll.buffered_data_length);
+                        p_decoder->buffered_length);
             reset_transport_state();
         }
     }
@@ -211,78 +228,68 @@ int actionslink_bt_ll_rx(actionslink_bt_ll_rx_packet_t *p_packet)
 
 static void reset_transport_state(void)
 {
-    m_bt_ll.received_data_length = 0;
-    m_bt_ll.buffered_data_length = 0;
-    m_bt_ll.state                = TRANSPORT_STATE_DATA;
+    actionslink_hdlc_decoder_reset(&m_bt_ll.decoder);
 }
 
 /**
- * @brief This function processes received bytes into frames.
+ * @brief This function reads the raw bytes received from the Actions module.
+ * @note  The optional bulk read function is used if available, otherwise the bytes
+ *        are read one by one with the mandatory read function.
  *
- * @param[in] byte      byte to process
+ * @param[out] p_data       pointer to where the data will be written
+ * @param[in]  max_length   maximum number of bytes to read
  *
- * @return 0 if successful
- *         PROCESS_FRAME_INCOMPLETE if a complete frame hasn't been received yet
- *         PROCESS_FRAME_ERROR if something went wrong while building a frame
+ * @return number of bytes read
  */
-static int process_received_byte(uint8_t byte, actionslink_bt_ll_rx_packet_t *p_packet)
+static size_t read_raw_data(uint8_t *p_data, size_t max_length)
 {
-    log_trace("bt_ll: rx 0x%02X", byte);
-    if (byte == HDLC_FRAME_DELIMITER)
+    if (m_bt_ll.p_config->read_available_fn != NULL)
     {
-        log_trace("bt_ll: received frame delimiter");
-        if (m_bt_ll.received_data_length > 0)
-        {
-            // Valid frames should contain at least the header
-            // Frames with no payload are allowed
-            if (m_bt_ll.received_data_length >= PACKET_HEADER_SIZE)
-            {
-                // An entire frame was received and buffered all the data received
-                if (m_bt_ll.received_data_length == m_bt_ll.buffered_data_length)
-                {
-                    return validate_received_data(p_packet);
-                }
-                else
-                {
-                    log_error("bt_ll: rx buffer is not large enough - received %d bytes, buffered %d",
-                                m_bt_ll.received_data_length, m_bt_ll.buffered_data_length);
-                    send_nack(0, NACK_REASON_BUSY);
-                }
-            }
-            else
-            {
-                log_warning("bt_ll: invalid rx frame (too short: %d bytes)",
-                            m_bt_ll.received_data_length);
-                send_nack(0, NACK_REASON_INVALID_LENGTH);
-            }
-            return PROCESS_FRAME_ERROR;
-        }
+        return m_bt_ll.p_config->read_available_fn(p_data, max_length);
     }
-    else if (byte == HDLC_ESCAPE_CHARACTER)
+
+    size_t length = 0;
+    while (length < max_length &&
+           m_bt_ll.p_config->read_buffer_fn(&p_data[length], 1, EXPECTED_BYTE_RX_TIMEOUT_MS) == 0)
     {
-        // Received the escape character, next byte will need to be "unescaped"
-        m_bt_ll.state = TRANSPORT_STATE_ESCAPED_DATA;
+        length++;
     }
-    else
+    return length;
+}
+
+/**
+ * @brief This function checks that a complete frame was received and buffered.
+ *
+ * @param[out] p_packet      pointer to container where the received packet will be stored
+ *
+ * @return 0 if successful
+ *         PROCESS_FRAME_ERROR if the frame is invalid
+ */
+static int process_received_frame(actionslink_bt_ll_rx_packet_t *p_packet)
+{
+    const actionslink_hdlc_decoder_t *p_decoder = &m_bt_ll.decoder;
+
+    log_trace("bt_ll: received frame delimiter");
+
+    // Valid frames should contain at least the header
+    // Frames with no payload are allowed
+    if (p_decoder->received_length < PACKET_HEADER_SIZE)
     {
-        if (m_bt_ll.buffered_data_length < m_bt_ll.p_config->rx_buffer_size)
-        {
-            if (m_bt_ll.state == TRANSPORT_STATE_ESCAPED_DATA)
-            {
-                // Escaped bytes must invert bit 5 according to the HDLC protocol
-                byte ^= HDLC_ESCAPE_MASK;
-                // Next byte should be normal data again
-                m_bt_ll.state = TRANSPORT_STATE_DATA;
-            }
-            m_bt_ll.p_config->p_rx_buffer[m_bt_ll.buffered_data_length] = byte;
-            m_bt_ll.buffered_data_length++;
-        }
+        log_warning("bt_ll: invalid rx frame (too short: %d bytes)", p_decoder->received_length);
+        send_nack(0, NACK_REASON_INVALID_LENGTH);
+        return PROCESS_FRAME_ERROR;
+    }
 
-        m_bt_ll.received_data_length++;
+    // An entire frame was received but not all the data could be buffered
+    if (p_decoder->received_length != p_decoder->buffered_length)
+    {
+        log_error("bt_ll: rx buffer is not large enough - received %d bytes, buffered %d",
+                    p_decoder->received_length, p_decoder->buffered_length);
+        send_nack(0, NACK_REASON_BUSY);
+        return PROCESS_FRAME_ERROR;
     }
 
-    // Frame hasn't been received completely yet
-    return PROCESS_FRAME_INCOMPLETE;
+    return validate_received_data(p_packet);
 }
 
 /**
@@ -296,7 +303,8 @@ static int process_received_byte(uint8_t byte, actionslink_bt_ll_rx_packet_t *p_
 static int validate_received_data(actionslink_bt_ll_rx_packet_t *p_packet) {
     const uint8_t *p_rx_data = m_bt_ll.p_config->p_rx_buffer;
 
-    uint8_t calculated_header_crc = calculate_crc8(INITIAL_CRC8_VALUE, p_rx_data, PACKET_HEADER_SIZE - 1);
+    // Both CRCs were calculated by the decoder while unescaping the frame
+    uint8_t calculated_header_crc = m_bt_ll.decoder.header_crc;
     if (calculated_header_crc != p_rx_data[PACKET_INDEX_HEADER_CRC])
     {
         log_error("bt_ll: invalid header crc (exp 0x%08X, recv 0x%08X)",
@@ -324,7 +332,15 @@ static int validate_received_data(actionslink_bt_ll_rx_packet_t *p_packet) {
     uint8_t transaction_id = p_rx_data[PACKET_INDEX_TRANSACTION_ID];
     uint16_t payload_length = (p_rx_data[PACKET_INDEX_PAYLOAD_LENGTH_MSB] << 8) | p_rx_data[PACKET_INDEX_PAYLOAD_LENGTH_LSB];
 
-    uint8_t calculated_payload_crc = calculate_crc8(INITIAL_CRC8_VALUE, &p_rx_data[PACKET_INDEX_PAYLOAD_START], payload_length);
+    if (payload_length != m_bt_ll.decoder.buffered_length - PACKET_HEADER_SIZE)
+    {
+        log_error("bt_ll: invalid payload length (exp %d, recv %d)",
+                        payload_length, m_bt_ll.decoder.buffered_length - PACKET_HEADER_SIZE);
+        send_nack(0, NACK_REASON_INVALID_LENGTH);
+        return PROCESS_FRAME_ERROR;
+    }
+
+    uint8_t calculated_payload_crc = m_bt_ll.decoder.payload_crc;
     if (calculated_payload_crc != p_rx_data[PACKET_INDEX_PAYLOAD_CRC])
     {
         log_error("bt_ll: invalid payload crc (exp 0x%08X, recv 0x%08X)",
@@ -378,76 +394,94 @@ static int validate_received_data(actionslink_bt_ll_rx_packet_t *p_packet) {
     return 0;
 }
 
-static size_t get_number_of_escaped_chars(const uint8_t *p_buffer, size_t length)
+/**
+ * @brief This function gets the buffer where the tx frame is built.
+ * @note  The buffer provided by the optional get tx buffer function (e.g. a DMA buffer) is preferred,
+ *        so that the frame doesn't need to be copied again before being sent.
+ *
+ * @param[out] pp_buffer    pointer to where the pointer to the buffer will be written to
+ * @param[out] p_size       pointer to where the size of the buffer will be written to
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+static int get_tx_buffer(uint8_t **pp_buffer, size_t *p_size)
 {
-    if (!p_buffer || length == 0)
+    if (m_bt_ll.p_config->get_tx_buffer_fn != NULL && m_bt_ll.p_config->send_tx_buffer_fn != NULL)
     {
-        return 0;
+        return m_bt_ll.p_config->get_tx_buffer_fn(pp_buffer, p_size, UART_TX_TIMEOUT_MS);
     }
 
-    size_t escaped_chars = 0;
-    for (size_t i = 0; i < length; ++i)
+    *pp_buffer = m_bt_ll.p_config->p_tx_buffer;
+    *p_size    = m_bt_ll.p_config->tx_buffer_size;
+    return 0;
+}
+
+/**
+ * @brief This function sends a frame built in the buffer returned by get_tx_buffer().
+ *
+ * @param[in] p_frame       pointer to the frame
+ * @param[in] length        length of the frame
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+static int send_tx_frame(const uint8_t *p_frame, size_t length)
+{
+    if (m_bt_ll.p_config->get_tx_buffer_fn != NULL && m_bt_ll.p_config->send_tx_buffer_fn != NULL)
     {
-        if (p_buffer[i] == HDLC_FRAME_DELIMITER || p_buffer[i] == HDLC_ESCAPE_CHARACTER)
-        {
-            escaped_chars++;
-        }
+        return m_bt_ll.p_config->send_tx_buffer_fn(p_frame, length);
     }
-    return escaped_chars;
+
+    if (length > UINT8_MAX)
+    {
+        log_error("bt_ll: tx frame is too long for the write buffer function (%d bytes)", length);
+        return -1;
+    }
+    return m_bt_ll.p_config->write_buffer_fn(p_frame, length, UART_TX_TIMEOUT_MS);
 }
 
-static bool is_escape_required(uint8_t byte)
+/**
+ * @brief nanopb output stream callback, escapes the encoded payload and calculates its CRC on the fly.
+ *
+ * @param[in] p_stream      pointer to the output stream, its state is a tx_frame_stream_t
+ * @param[in] p_data        pointer to the encoded bytes
+ * @param[in] length        number of encoded bytes
+ *
+ * @return true if successful, false if the tx buffer is full
+ */
+static bool write_escaped_payload(pb_ostream_t *p_stream, const pb_byte_t *p_data, size_t length)
 {
-    return (byte == HDLC_FRAME_DELIMITER || byte == HDLC_ESCAPE_CHARACTER);
-}
+    tx_frame_stream_t *p_frame = (tx_frame_stream_t *) p_stream->state;
+    uint8_t           *p_out   = p_frame->p_buffer;
+    size_t             index   = p_frame->index;
+    uint8_t            crc     = p_frame->crc;
 
-// Lookup table for CRC-8 calculation
-// - POLY: 0x07
-// - INIT: 0x00
-// - REFIN: false
-// - REFOUT: false
-// - XOROUT: 0x00
-static const uint8_t crc8_table[] = {
-    0x00, 0x07, 0x0e, 0x09, 0x1c, 0x1b, 0x12, 0x15,
-    0x38, 0x3f, 0x36, 0x31, 0x24, 0x23, 0x2a, 0x2d,
-    0x70, 0x77, 0x7e, 0x79, 0x6c, 0x6b, 0x62, 0x65,
-    0x48, 0x4f, 0x46, 0x41, 0x54, 0x53, 0x5a, 0x5d,
-    0xe0, 0xe7, 0xee, 0xe9, 0xfc, 0xfb, 0xf2, 0xf5,
-    0xd8, 0xdf, 0xd6, 0xd1, 0xc4, 0xc3, 0xca, 0xcd,
-    0x90, 0x97, 0x9e, 0x99, 0x8c, 0x8b, 0x82, 0x85,
-    0xa8, 0xaf, 0xa6, 0xa1, 0xb4, 0xb3, 0xba, 0xbd,
-    0xc7, 0xc0, 0xc9, 0xce, 0xdb, 0xdc, 0xd5, 0xd2,
-    0xff, 0xf8, 0xf1, 0xf6, 0xe3, 0xe4, 0xed, 0xea,
-    0xb7, 0xb0, 0xb9, 0xbe, 0xab, 0xac, 0xa5, 0xa2,
-    0x8f, 0x88, 0x81, 0x86, 0x93, 0x94, 0x9d, 0x9a,
-    0x27, 0x20, 0x29, 0x2e, 0x3b, 0x3c, 0x35, 0x32,
-    0x1f, 0x18, 0x11, 0x16, 0x03, 0x04, 0x0d, 0x0a,
-    0x57, 0x50, 0x59, 0x5e, 0x4b, 0x4c, 0x45, 0x42,
-    0x6f, 0x68, 0x61, 0x66, 0x73, 0x74, 0x7d, 0x7a,
-    0x89, 0x8e, 0x87, 0x80, 0x95, 0x92, 0x9b, 0x9c,
-    0xb1, 0xb6, 0xbf, 0xb8, 0xad, 0xaa, 0xa3, 0xa4,
-    0xf9, 0xfe, 0xf7, 0xf0, 0xe5, 0xe2, 0xeb, 0xec,
-    0xc1, 0xc6, 0xcf, 0xc8, 0xdd, 0xda, 0xd3, 0xd4,
-    0x69, 0x6e, 0x67, 0x60, 0x75, 0x72, 0x7b, 0x7c,
-    0x51, 0x56, 0x5f, 0x58, 0x4d, 0x4a, 0x43, 0x44,
-    0x19, 0x1e, 0x17, 0x10, 0x05, 0x02, 0x0b, 0x0c,
-    0x21, 0x26, 0x2f, 0x28, 0x3d, 0x3a, 0x33, 0x34,
-    0x4e, 0x49, 0x40, 0x47, 0x52, 0x55, 0x5c, 0x5b,
-    0x76, 0x71, 0x78, 0x7f, 0x6a, 0x6d, 0x64, 0x63,
-    0x3e, 0x39, 0x30, 0x37, 0x22, 0x25, 0x2c, 0x2b,
-    0x06, 0x01, 0x08, 0x0f, 0x1a, 0x1d, 0x14, 0x13,
-    0xae, 0xa9, 0xa0, 0xa7, 0xb2, 0xb5, 0xbc, 0xbb,
-    0x96, 0x91, 0x98, 0x9f, 0x8a, 0x8d, 0x84, 0x83,
-    0xde, 0xd9, 0xd0, 0xd7, 0xc2, 0xc5, 0xcc, 0xcb,
-    0xe6, 0xe1, 0xe8, 0xef, 0xfa, 0xfd, 0xf4, 0xf3,
-};
-
-static uint8_t calculate_crc8(uint8_t crc, const uint8_t *p_buffer, size_t length) {
-    while (length--)
+    for (size_t i = 0; i < length; i++)
     {
-        crc = crc8_table[crc ^ *p_buffer++];
+        uint8_t byte = p_data[i];
+        crc          = actionslink_hdlc_crc8_byte(crc, byte);
+
+        if (actionslink_hdlc_is_escape_required(byte))
+        {
+            if (index + 2 > p_frame->end)
+            {
+                return false;
+            }
+            p_out[index++] = HDLC_ESCAPE_CHARACTER;
+            p_out[index++] = byte ^ HDLC_ESCAPE_MASK;
+        }
+        else
+        {
+            if (index + 1 > p_frame->end)
+            {
+                return false;
+            }
+            p_out[index++] = byte;
+        }
     }
-    return crc;
+
+    p_frame->index = index;
+    p_frame->crc   = crc;
+    return true;
 }
 
 static int send_ack(uint8_t transaction_id)
@@ -45,13 +45,11 @@ void actionslink_bt_ll_reset(void);
 
 /**
  * @brief Sends a packet to the Actions module.
- * @note  This function reuses the buffer passed to it to build a frame around
- *        the payload. If the buffer is not big enough to construct the frame,
- *        this function will return error.
+ * @note  The payload is encoded, escaped and its CRC calculated in a single pass, directly
+ *        into the TX buffer (or the buffer provided by get_tx_buffer_fn if configured).
+ *        If the buffer is not big enough to construct the frame, this function will return error.
  *
  * @param[in] p_packet          pointer to packet to send
- * @param[in] p_tx_buffer       pointer to buffer to use for constructing the frame
- * @param[in] tx_buffer_size    size of the TX buffer
  *
  * @return 0 if successful, -1 otherwise
  */
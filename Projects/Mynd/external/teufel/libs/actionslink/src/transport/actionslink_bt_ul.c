@@ -8,37 +8,57 @@
 
 typedef enum
 {
-    TRANSPORT_STATE_IDLE,
-    TRANSPORT_STATE_ACK,
-    TRANSPORT_STATE_RESPONSE,
-    TRANSPORT_STATE_SUCCESS,
-    TRANSPORT_STATE_ERROR,
-    TRANSPORT_STATE_TIMEOUT,
-} transport_state_t;
+    TRANSACTION_STATE_FREE,
+    TRANSACTION_STATE_ACK,
+    TRANSACTION_STATE_RESPONSE,
+} transaction_state_t;
 
-static struct
+typedef struct
+{
+    transaction_state_t                    state;
+    uint8_t                                transaction_id;
+    uint16_t                               tag;
+    uint32_t                               seq;
+    bool                                   expect_response;
+    bool                                   retransmit_pending;
+    uint8_t                                tx_retries;
+    uint32_t                               timestamp;
+    actionslink_bt_ul_completion_handler_t completion_handler;
+    void                                  *p_context;
+    ActionsLink_FromMcu                    message; // Kept to retransmit the message if it gets lost
+} transaction_t;
+
+typedef struct
 {
-    uint16_t tag;
-    uint8_t  transaction_id;
-    bool     expect_response;
-    uint32_t timestamp;
-} m_message;
+    bool is_done;
+    int  result;
+} sync_transaction_t;
+
+static transaction_t m_transactions[ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS];
 
 static struct
 {
     const actionslink_config_t         *p_config;
     actionslink_bt_ul_event_handler_t   event_handler;
     actionslink_bt_ul_request_handler_t request_handler;
-    transport_state_t                   state;
-    uint8_t                             tx_retries;
     volatile bool                       stop_requested;
     uint8_t                             next_tx_transaction_id;
     bool                                within_event_handler;
+    bool                                within_rx;
 } m_bt_ul;
 
-static transport_state_t transport_state_idle(const actionslink_bt_ll_rx_packet_t *p_packet);
-static transport_state_t transport_state_ack(const actionslink_bt_ll_rx_packet_t *p_packet);
-static transport_state_t transport_state_response(const actionslink_bt_ll_rx_packet_t *p_packet);
+static transaction_t *allocate_transaction(void);
+static int            wait_for_pending_transactions(size_t max_pending);
+static int            send_transaction(transaction_t *p_transaction);
+static void           complete_transaction(transaction_t *p_transaction, int result, const ActionsLink_ToMcu *p_response);
+static void           abort_all_transactions(void);
+static void           retry_or_fail_transaction(transaction_t *p_transaction);
+static int            process_transaction_timeouts(void);
+static int            process_ack(const actionslink_bt_ll_rx_packet_t *p_packet);
+static int            process_response(const ActionsLink_ToMcu *p_message);
+static void           process_protobuf(const actionslink_bt_ll_rx_packet_t *p_packet, int *p_completed);
+static void           on_sync_transaction_completed(int result, const ActionsLink_ToMcu *p_response, void *p_context);
+static void           yield(void);
 
 void actionslink_bt_ul_init(const actionslink_config_t *p_config, actionslink_bt_ul_event_handler_t event_handler,
                             actionslink_bt_ul_request_handler_t request_handler)
@@ -47,16 +67,33 @@ void actionslink_bt_ul_init(const actionslink_config_t *p_config, actionslink_bt
     m_bt_ul.p_config               = p_config;
     m_bt_ul.event_handler          = event_handler;
     m_bt_ul.request_handler        = request_handler;
-    m_bt_ul.state                  = TRANSPORT_STATE_IDLE;
     m_bt_ul.stop_requested         = false;
-    m_bt_ul.tx_retries             = 0;
     m_bt_ul.next_tx_transaction_id = 0;
     m_bt_ul.within_event_handler   = false;
+    m_bt_ul.within_rx              = false;
+
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
+    {
+        m_transactions[i].state = TRANSACTION_STATE_FREE;
+    }
 }
 
 bool actionslink_bt_ul_is_busy(void)
 {
-    return m_bt_ul.state != TRANSPORT_STATE_IDLE;
+    return actionslink_bt_ul_get_number_of_pending_transactions() > 0;
+}
+
+size_t actionslink_bt_ul_get_number_of_pending_transactions(void)
+{
+    size_t pending = 0;
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
+    {
+        if (m_transactions[i].state != TRANSACTION_STATE_FREE)
+        {
+            pending++;
+        }
+    }
+    return pending;
 }
 
 void actionslink_bt_ul_stop_communication(void)
@@ -92,53 +129,50 @@ int actionslink_bt_ul_tx_rx(ActionsLink_FromMcu *p_message, ActionsLink_ToMcu *p
         return -1;
     }
 
-    int result_rx;
-    m_bt_ul.tx_retries = 0;
-    do
+    // Received responses are decoded into p_response, which may carry decode callbacks meant for
+    // this request only, so let the transactions already in flight complete first
+    if (wait_for_pending_transactions(0) != 0)
+    {
+        return -1;
+    }
+
+    sync_transaction_t sync = {
+        .is_done = false,
+        .result  = -1,
+    };
+    if (actionslink_bt_ul_tx_async(p_message, on_sync_transaction_completed, &sync) != 0)
+    {
+        return -1;
+    }
+
+    while (!sync.is_done)
     {
-        if (actionslink_bt_ul_tx(p_message) == 0)
+        // Keep processing received bytes until either we get the expected response or all the retries time out
+        if (actionslink_bt_ul_rx(p_response) == 0)
         {
-            do
-            {
-                // Keep processing received bytes until either we get the expected response or a timeout
-                result_rx = actionslink_bt_ul_rx(p_response);
-                // If we haven't received a response, yield the task and check again later
-                if (result_rx == 0)
-                {
-                    if (m_bt_ul.p_config->task_yield_fn)
-                    {
-                        m_bt_ul.p_config->task_yield_fn();
-                    }
-                }
-            } while (result_rx == 0);
-
-            if (result_rx == 1)
-            {
-                log_debug("bt_ul: message sent and confirmed");
-                return 0;
-            }
+            yield();
         }
-        else
+
+        if (m_bt_ul.stop_requested)
         {
-            // We failed to send the message, yield the task and try again later
-            if (m_bt_ul.p_config->task_yield_fn)
-            {
-                m_bt_ul.p_config->task_yield_fn();
-            }
+            abort_all_transactions();
         }
-        m_bt_ul.tx_retries++;
-        log_debug("bt_ul: tx attempt %d/%d failed", m_bt_ul.tx_retries,
-                    MAX_NUMBER_OF_TX_RETRIES);
-    } while (m_bt_ul.tx_retries < MAX_NUMBER_OF_TX_RETRIES && m_bt_ul.stop_requested == false);
-
-    log_error("bt_ul: tx failed (tag %d)", m_message.tag);
+    }
 
-    // Failed to receive a response after timing out X times
-    // or RX failed because of something else other than a timeout
-    return -1;
+    if (sync.result == 0)
+    {
+        log_debug("bt_ul: message sent and confirmed");
+    }
+    return sync.result;
 }
 
 int actionslink_bt_ul_tx(ActionsLink_FromMcu *p_message)
+{
+    return actionslink_bt_ul_tx_async(p_message, NULL, NULL);
+}
+
+int actionslink_bt_ul_tx_async(const ActionsLink_FromMcu *p_message,
+                               actionslink_bt_ul_completion_handler_t completion_handler, void *p_context)
 {
     // Do not process commands if a protocol stop was requested
     if (m_bt_ul.stop_requested)
@@ -146,60 +180,59 @@ int actionslink_bt_ul_tx(ActionsLink_FromMcu *p_message)
         return -1;
     }
 
-    // Guard against sending packets while we are expecting for responses
-    if (m_bt_ul.state != TRANSPORT_STATE_IDLE)
+    transaction_t *p_transaction = allocate_transaction();
+    if (p_transaction == NULL)
     {
-        log_info("bt_ul: transport busy");
-        return -1;
-    }
+        // Waiting for a free slot means processing received packets, which isn't possible
+        // while already processing one (e.g. sending a response from a request handler)
+        if (m_bt_ul.within_event_handler || m_bt_ul.within_rx)
+        {
+            log_info("bt_ul: transport busy");
+            return -1;
+        }
 
-    m_bt_ul.state                 = TRANSPORT_STATE_ACK;
-    m_message.timestamp           = actionslink_utils_get_ms();
+        if (wait_for_pending_transactions(ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS - 1) != 0)
+        {
+            return -1;
+        }
+        p_transaction = allocate_transaction();
+    }
 
-    uint8_t sequence_number = 0;
     switch (p_message->which_Payload)
     {
         case ActionsLink_FromMcu_request_tag:
-            m_message.tag             = p_message->Payload.request.which_Request;
-            sequence_number           = p_message->Payload.request.seq;
-            m_message.expect_response = true;
+            p_transaction->tag             = p_message->Payload.request.which_Request;
+            p_transaction->seq             = p_message->Payload.request.seq;
+            p_transaction->expect_response = true;
             break;
         case ActionsLink_FromMcu_response_tag:
-            m_message.tag             = p_message->Payload.response.which_Response;
-            sequence_number           = p_message->Payload.response.seq;
-            m_message.expect_response = false;
+            p_transaction->tag             = p_message->Payload.response.which_Response;
+            p_transaction->seq             = p_message->Payload.response.seq;
+            p_transaction->expect_response = false;
             break;
         case ActionsLink_FromMcu_event_tag:
-            m_message.tag             = p_message->Payload.event.which_Event;
-            sequence_number           = 0;
-            m_message.expect_response = false;
+            p_transaction->tag             = p_message->Payload.event.which_Event;
+            p_transaction->seq             = 0;
+            p_transaction->expect_response = false;
             break;
         default:
             log_error("bt_ul: invalid message type %d", p_message->which_Payload);
+            p_transaction->state = TRANSACTION_STATE_FREE;
             return -1;
     }
 
-    actionslink_bt_ll_tx_packet_t packet = {
-        .packet_type = ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF,
-        .value = 0,
-        .transaction_id = m_bt_ul.next_tx_transaction_id++,
-        .p_payload = p_message,
-    };
+    p_transaction->message            = *p_message;
+    p_transaction->completion_handler = completion_handler;
+    p_transaction->p_context          = p_context;
+    p_transaction->tx_retries         = 0;
 
-    m_message.transaction_id = packet.transaction_id;
-
-    log_debug("bt_ul: sending packet (tx id %d, tag %d, seq %d)",
-                    m_message.transaction_id,
-                    m_message.tag,
-                    sequence_number);
-
-    if (actionslink_bt_ll_tx(&packet) != 0)
+    if (send_transaction(p_transaction) != 0)
     {
-        m_bt_ul.state = TRANSPORT_STATE_IDLE;
-        return -1;
+        // Retried the next time received data is processed
+        p_transaction->tx_retries++;
+        p_transaction->retransmit_pending = true;
     }
 
-    log_debug("bt_ul: tx successful");
     return 0;
 }
 
@@ -214,219 +247,314 @@ int actionslink_bt_ul_rx(ActionsLink_ToMcu *p_response)
     actionslink_bt_ll_rx_packet_t packet = {0};
     packet.payload.p_message = p_response;
 
+    int completed = 0;
+
     // Check if the lower layer received a complete message
     int rx_result = actionslink_bt_ll_rx(&packet);
 
+    // Handlers may send messages that end up processing received data again, restore the flag on return
+    bool was_within_rx = m_bt_ul.within_rx;
+    m_bt_ul.within_rx  = true;
+
     // We received a message
     if (rx_result == 1)
     {
         log_debug("bt_ul: received ll packet (tx ID: %d)", packet.transaction_id);
 
-        switch (m_bt_ul.state)
+        switch (packet.packet_type)
         {
-            case TRANSPORT_STATE_IDLE:
-                m_bt_ul.state = transport_state_idle(&packet);
+            case ACTIONSLINK_BT_LL_PACKET_TYPE_ACK:
+                completed += process_ack(&packet);
                 break;
-            case TRANSPORT_STATE_ACK:
-                m_bt_ul.state = transport_state_ack(&packet);
-                break;
-            case TRANSPORT_STATE_RESPONSE:
-                m_bt_ul.state = transport_state_response(&packet);
+
+            case ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF:
+                process_protobuf(&packet, &completed);
                 break;
+
             default:
+                log_error("bt_ul: received invalid packet type %d", packet.packet_type);
                 break;
         }
     }
-    else if (rx_result == -1)
+
+    // Lost packets are only detected by their timeout, the retries are handled per transaction
+    completed += process_transaction_timeouts();
+
+    m_bt_ul.within_rx = was_within_rx;
+
+    if (rx_result == -1)
     {
         // Something went wrong in the lower layer
-        m_bt_ul.state = TRANSPORT_STATE_ERROR;
+        return -1;
     }
-    else
+
+    return ((rx_result == 1) || (completed > 0)) ? 1 : 0;
+}
+
+static transaction_t *allocate_transaction(void)
+{
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
     {
-        // We haven't received anything yet
-        // Check if we have a message in progress and check for response timeouts
-        if ((m_bt_ul.state == TRANSPORT_STATE_ACK) || (m_bt_ul.state == TRANSPORT_STATE_RESPONSE))
+        if (m_transactions[i].state == TRANSACTION_STATE_FREE)
         {
-            if (actionslink_utils_get_ms_since(m_message.timestamp) > MESSAGE_RESPONSE_TIMEOUT_MS)
-            {
-                log_debug("bt_ul: message with tag %d timed out: no response",
-                            m_message.tag);
-                m_bt_ul.state = TRANSPORT_STATE_TIMEOUT;
-            }
+            m_transactions[i].state              = TRANSACTION_STATE_ACK;
+            m_transactions[i].retransmit_pending = false;
+            return &m_transactions[i];
         }
     }
+    return NULL;
+}
 
-    switch (m_bt_ul.state)
+/**
+ * @brief This function processes received data until at most the given number of transactions is pending.
+ *
+ * @param[in] max_pending   maximum number of pending transactions to return
+ *
+ * @return 0 if successful, -1 if a protocol stop was requested
+ */
+static int wait_for_pending_transactions(size_t max_pending)
+{
+    while (actionslink_bt_ul_get_number_of_pending_transactions() > max_pending)
     {
-        case TRANSPORT_STATE_SUCCESS:
-            m_bt_ul.state = TRANSPORT_STATE_IDLE;
-            return 1;
-        case TRANSPORT_STATE_ERROR:
-            m_bt_ul.state = TRANSPORT_STATE_IDLE;
+        ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
+        if (actionslink_bt_ul_rx(&response) == 0)
+        {
+            yield();
+        }
+
+        if (m_bt_ul.stop_requested)
+        {
+            abort_all_transactions();
             return -1;
-        case TRANSPORT_STATE_TIMEOUT:
-            m_bt_ul.state = TRANSPORT_STATE_IDLE;
-            return -2;
-        default:
-            // Not done yet - keep the state as is
-            return 0;
+        }
     }
+    return 0;
 }
 
-static transport_state_t transport_state_idle(const actionslink_bt_ll_rx_packet_t *p_packet)
+/**
+ * @brief This function sends (or resends) the message of a transaction, using a new transaction ID.
+ *
+ * @param[in] p_transaction     pointer to the transaction
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+static int send_transaction(transaction_t *p_transaction)
 {
-    const ActionsLink_ToMcu *p_message = p_packet->payload.p_message;
-    switch (p_packet->packet_type)
+    actionslink_bt_ll_tx_packet_t packet = {
+        .packet_type = ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF,
+        .value = 0,
+        .transaction_id = m_bt_ul.next_tx_transaction_id++,
+        .p_payload = &p_transaction->message,
+    };
+
+    p_transaction->transaction_id     = packet.transaction_id;
+    p_transaction->state              = TRANSACTION_STATE_ACK;
+    p_transaction->retransmit_pending = false;
+    p_transaction->timestamp          = actionslink_utils_get_ms();
+
+    log_debug("bt_ul: sending packet (tx id %d, tag %d, seq %d)",
+                    p_transaction->transaction_id,
+                    p_transaction->tag,
+                    p_transaction->seq);
+
+    if (actionslink_bt_ll_tx(&packet) != 0)
     {
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_ACK:
-            log_warning("bt_ul: received unexpected ACK (tx ID: %d)", p_packet->transaction_id);
-            break;
+        return -1;
+    }
 
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF:
-            switch (p_message->which_Payload)
-            {
-                case ActionsLink_ToMcu_request_tag:
-                    log_debug("bt_ul: received request message");
-                    m_bt_ul.request_handler(&p_message->Payload.request, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
-                    break;
-
-                case ActionsLink_ToMcu_response_tag:
-                    log_warning("bt_ul: received unexpected response message (tag %d)",
-                                    p_message->Payload.response.which_Response);
-                    break;
-
-                case ActionsLink_ToMcu_event_tag:
-                    log_debug("bt_ul: received event message");
-                    m_bt_ul.within_event_handler = true;
-                    m_bt_ul.event_handler(&p_message->Payload.event, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
-                    m_bt_ul.within_event_handler = false;
-                    break;
-
-                default:
-                    log_error("bt_ul: received invalid message type %d", p_message->which_Payload);
-                    break;
-            }
-            break;
+    log_debug("bt_ul: tx successful");
+    return 0;
+}
 
-        default:
-            log_error("bt_ul: received invalid packet type %d", p_packet->packet_type);
-            break;
+static void complete_transaction(transaction_t *p_transaction, int result, const ActionsLink_ToMcu *p_response)
+{
+    // Free the slot first, the handler may send a new message
+    actionslink_bt_ul_completion_handler_t completion_handler = p_transaction->completion_handler;
+    void                                  *p_context          = p_transaction->p_context;
+    p_transaction->state                                      = TRANSACTION_STATE_FREE;
 
+    if (result != 0)
+    {
+        log_error("bt_ul: tx failed (tag %d)", p_transaction->tag);
     }
 
-    return TRANSPORT_STATE_IDLE;
+    if (completion_handler != NULL)
+    {
+        completion_handler(result, p_response, p_context);
+    }
 }
 
-static transport_state_t transport_state_ack(const actionslink_bt_ll_rx_packet_t *p_packet)
+static void abort_all_transactions(void)
 {
-    const ActionsLink_ToMcu *p_message = p_packet->payload.p_message;
-    switch (p_packet->packet_type)
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
     {
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_ACK:
+        if (m_transactions[i].state != TRANSACTION_STATE_FREE)
+        {
+            complete_transaction(&m_transactions[i], -1, NULL);
+        }
+    }
+}
+
+static void retry_or_fail_transaction(transaction_t *p_transaction)
+{
+    while (p_transaction->tx_retries < MAX_NUMBER_OF_TX_RETRIES)
+    {
+        log_debug("bt_ul: retrying tag %d (attempt %d/%d)", p_transaction->tag, p_transaction->tx_retries + 1,
+                    MAX_NUMBER_OF_TX_RETRIES);
+        if (send_transaction(p_transaction) == 0)
+        {
+            return;
+        }
+        p_transaction->tx_retries++;
+    }
 
-            if (p_packet->transaction_id == m_message.transaction_id)
+    complete_transaction(p_transaction, -1, NULL);
+}
+
+/**
+ * @brief This function retries or fails the transactions that weren't acknowledged/responded in time.
+ *
+ * @return number of transactions that failed
+ */
+static int process_transaction_timeouts(void)
+{
+    int failed = 0;
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
+    {
+        transaction_t *p_transaction = &m_transactions[i];
+        if (p_transaction->state == TRANSACTION_STATE_FREE)
+        {
+            continue;
+        }
+
+        if (p_transaction->retransmit_pending ||
+            actionslink_utils_get_ms_since(p_transaction->timestamp) > MESSAGE_RESPONSE_TIMEOUT_MS)
+        {
+            if (!p_transaction->retransmit_pending)
             {
-                log_debug("bt_ul: received ACK (tx ID: %d)", p_packet->transaction_id);
-                if (m_message.expect_response)
-                {
-                    m_message.timestamp = actionslink_utils_get_ms();
-                    return TRANSPORT_STATE_RESPONSE;
-                }
-                return TRANSPORT_STATE_SUCCESS;
+                log_debug("bt_ul: message with tag %d timed out: no %s", p_transaction->tag,
+                            (p_transaction->state == TRANSACTION_STATE_ACK) ? "ack" : "response");
+                p_transaction->tx_retries++;
             }
-            else
+
+            retry_or_fail_transaction(p_transaction);
+            if (p_transaction->state == TRANSACTION_STATE_FREE)
             {
-                log_warning("bt_ul: received ACK with invalid transaction ID (exp %d, recv %d)",
-                                m_message.transaction_id, p_packet->transaction_id);
+                failed++;
             }
-            break;
+        }
+    }
+    return failed;
+}
 
+/**
+ * @brief This function matches a received ACK/NACK with the transaction waiting for it.
+ *
+ * @return 1 if a transaction completed, 0 otherwise
+ */
+static int process_ack(const actionslink_bt_ll_rx_packet_t *p_packet)
+{
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
+    {
+        transaction_t *p_transaction = &m_transactions[i];
+        if (p_transaction->state != TRANSACTION_STATE_ACK || p_transaction->transaction_id != p_packet->transaction_id)
+        {
+            continue;
+        }
 
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF:
-            switch (p_message->which_Payload)
-            {
-                case ActionsLink_ToMcu_request_tag:
-                    log_warning("bt_ul: received request while waiting for ACK (tag %d)",
-                                    p_message->Payload.request.which_Request);
-                    break;
-
-                case ActionsLink_ToMcu_response_tag:
-                    log_warning("bt_ul: received response while waiting for ACK (tag %d)",
-                                    p_message->Payload.response.which_Response);
-                    break;
-
-                case ActionsLink_ToMcu_event_tag:
-                    log_debug("bt_ul: received event message");
-                    m_bt_ul.within_event_handler = true;
-                    m_bt_ul.event_handler(&p_message->Payload.event, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
-                    m_bt_ul.within_event_handler = false;
-                    break;
-
-                default:
-                    log_error("bt_ul: received invalid message type %d", p_message->which_Payload);
-                    break;
-            }
-            break;
+        if (p_packet->value != 0)
+        {
+            // NACK, only this message needs to be sent again
+            log_warning("bt_ul: received NACK (tx ID: %d, reason %d)", p_packet->transaction_id, p_packet->value);
+            p_transaction->tx_retries++;
+            retry_or_fail_transaction(p_transaction);
+            return (p_transaction->state == TRANSACTION_STATE_FREE) ? 1 : 0;
+        }
 
-        default:
-            log_error("bt_ul: received invalid packet type %d", p_packet->packet_type);
-            break;
+        log_debug("bt_ul: received ACK (tx ID: %d)", p_packet->transaction_id);
+        if (p_transaction->expect_response)
+        {
+            p_transaction->state     = TRANSACTION_STATE_RESPONSE;
+            p_transaction->timestamp = actionslink_utils_get_ms();
+            return 0;
+        }
 
+        complete_transaction(p_transaction, 0, NULL);
+        return 1;
     }
 
-    return TRANSPORT_STATE_ACK;
+    log_warning("bt_ul: received unexpected ACK (tx ID: %d)", p_packet->transaction_id);
+    return 0;
 }
 
-static transport_state_t transport_state_response(const actionslink_bt_ll_rx_packet_t *p_packet)
+/**
+ * @brief This function matches a received response with the request it answers.
+ * @note  The response may overtake a lost ACK, so requests still waiting for the ACK are also considered.
+ *
+ * @return 1 if a transaction completed, 0 otherwise
+ */
+static int process_response(const ActionsLink_ToMcu *p_message)
+{
+    const ActionsLink_ToMcuResponse *p_response = &p_message->Payload.response;
+    for (size_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS; i++)
+    {
+        transaction_t *p_transaction = &m_transactions[i];
+        if (p_transaction->state == TRANSACTION_STATE_FREE || !p_transaction->expect_response)
+        {
+            continue;
+        }
+
+        if (p_transaction->seq == p_response->seq && p_transaction->tag == p_response->which_Response)
+        {
+            log_debug("bt_ul: received response (tag %d)", p_response->which_Response);
+            complete_transaction(p_transaction, 0, p_message);
+            return 1;
+        }
+    }
+
+    log_warning("bt_ul: received unexpected response message (tag %d)", p_response->which_Response);
+    return 0;
+}
+
+static void process_protobuf(const actionslink_bt_ll_rx_packet_t *p_packet, int *p_completed)
 {
     const ActionsLink_ToMcu *p_message = p_packet->payload.p_message;
-    switch (p_packet->packet_type)
+    switch (p_message->which_Payload)
     {
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_ACK:
-            log_warning("bt_ul: received ACK while waiting for response (tx ID: %d)", p_packet->transaction_id);
+        case ActionsLink_ToMcu_request_tag:
+            log_debug("bt_ul: received request message");
+            m_bt_ul.request_handler(&p_message->Payload.request, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
             break;
 
-        case ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF:
-            switch (p_message->which_Payload)
-            {
-                case ActionsLink_ToMcu_request_tag:
-                    log_warning("bt_ul: received request while waiting for response (tag %d)",
-                                    p_message->Payload.request.which_Request);
-                    break;
-
-                case ActionsLink_ToMcu_response_tag:
-                    if (p_message->Payload.response.which_Response == m_message.tag)
-                    {
-                        log_debug("bt_ul: received response (tag %d)",
-                                        p_message->Payload.response.which_Response);
-                        return TRANSPORT_STATE_SUCCESS;
-                    }
-                    else
-                    {
-                        log_warning("bt_ul: received response with unexpected tag %d",
-                                        p_message->Payload.response.which_Response);
-                    }
-                    break;
-
-                case ActionsLink_ToMcu_event_tag:
-                    log_debug("bt_ul: received event message");
-                    m_bt_ul.within_event_handler = true;
-                    m_bt_ul.event_handler(&p_message->Payload.event, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
-                    m_bt_ul.within_event_handler = false;
-                    break;
-
-                default:
-                    log_error("bt_ul: received invalid message type %d", p_message->which_Payload);
-                    break;
-            }
+        case ActionsLink_ToMcu_response_tag:
+            *p_completed += process_response(p_message);
             break;
 
-        default:
-            log_error("bt_ul: received invalid packet type %d", p_packet->packet_type);
+        case ActionsLink_ToMcu_event_tag:
+            log_debug("bt_ul: received event message");
+            m_bt_ul.within_event_handler = true;
+            m_bt_ul.event_handler(&p_message->Payload.event, p_packet->payload.p_raw_data, p_packet->payload.raw_data_length);
+            m_bt_ul.within_event_handler = false;
             break;
 
+        default:
+            log_error("bt_ul: received invalid message type %d", p_message->which_Payload);
+            break;
     }
+}
+
+static void on_sync_transaction_completed(int result, const ActionsLink_ToMcu *p_response, void *p_context)
+{
+    (void) p_response;
+    sync_transaction_t *p_sync = (sync_transaction_t *) p_context;
+    p_sync->result             = result;
+    p_sync->is_done            = true;
+}
 
-    return TRANSPORT_STATE_RESPONSE;
+static void yield(void)
+{
+    if (m_bt_ul.p_config->task_yield_fn)
+    {
+        m_bt_ul.p_config->task_yield_fn();
+    }
 }
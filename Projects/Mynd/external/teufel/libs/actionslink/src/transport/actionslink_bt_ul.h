@@ -3,6 +3,11 @@
 #include "actionslink_types.h"
 #include "message.pb.h"
 
+// Number of messages that can wait for their ACK/response at the same time
+#ifndef ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS
+#define ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS (4u)
+#endif
+
 /**
  * @brief Handler for events sent by the Actions module.
  *
@@ -21,6 +26,15 @@ typedef void (*actionslink_bt_ul_event_handler_t)(const ActionsLink_ToMcuEvent *
  */
 typedef void (*actionslink_bt_ul_request_handler_t)(const ActionsLink_ToMcuRequest *p_request, const uint8_t *p_data, uint16_t data_length);
 
+/**
+ * @brief Handler for completed transactions.
+ *
+ * @param[in] result        0 if successful, -1 if the message could not be delivered after all the retries
+ * @param[in] p_response    pointer to the received response, NULL if no response was expected or on failure
+ * @param[in] p_context     context passed along with the message
+ */
+typedef void (*actionslink_bt_ul_completion_handler_t)(int result, const ActionsLink_ToMcu *p_response, void *p_context);
+
 /**
  * @brief Initializes the upper layer of the Actionslink transport.
  *
@@ -33,10 +47,17 @@ void actionslink_bt_ul_init(const actionslink_config_t *p_config, actionslink_bt
 /**
  * @brief Checks if the Actions upper transport layer is busy.
  *
- * @return true if busy, false otherwise
+ * @return true if any message is waiting for its ACK/response, false otherwise
  */
 bool actionslink_bt_ul_is_busy(void);
 
+/**
+ * @brief Gets the number of messages waiting for their ACK/response.
+ *
+ * @return number of pending transactions
+ */
+size_t actionslink_bt_ul_get_number_of_pending_transactions(void);
+
 /**
  * @brief Requests the Actions upper transport layer to stop processing TX/RX.
  */
@@ -45,6 +66,8 @@ void actionslink_bt_ul_stop(void);
 /**
  * @brief Sends a message and waits for the Actions module to send the ACK/confirmation response.
  * @note  This function validates that the response corresponds to the sent message.
+ *        The messages already in flight are completed before sending this one, so that only
+ *        the response to this message is decoded into p_response.
  *
  * @param[in]  p_message        pointer to message to send
  * @param[out] p_response       pointer to struct where the response should be written to
@@ -55,6 +78,7 @@ int actionslink_bt_ul_tx_rx(ActionsLink_FromMcu *p_message, ActionsLink_ToMcu *p
 
 /**
  * @brief Sends a command to the Actions module, expecting a response.
+ * @note  This function doesn't wait for the ACK, see actionslink_bt_ul_tx_async().
  *
  * @param[in] p_message         pointer to message to send
  *
@@ -62,6 +86,25 @@ int actionslink_bt_ul_tx_rx(ActionsLink_FromMcu *p_message, ActionsLink_ToMcu *p
  */
 int actionslink_bt_ul_tx(ActionsLink_FromMcu *p_message);
 
+/**
+ * @brief Sends a message without waiting for the Actions module to acknowledge/respond to it.
+ * @note  The message is copied into a transaction table, keyed by its transaction ID, so several
+ *        messages can be in flight at the same time. Each transaction has its own timeout and
+ *        only the lost messages are sent again. The completion handler is called from
+ *        actionslink_bt_ul_rx() once the ACK (or the response for requests) is received,
+ *        or once all the retries have failed.
+ *        If the table is full, this function processes received data until a transaction completes.
+ *        Any data referenced by the message (e.g. encode callback arguments) must remain valid until then.
+ *
+ * @param[in] p_message             pointer to message to send
+ * @param[in] completion_handler    function to call when the transaction completes, can be NULL
+ * @param[in] p_context             context passed to the completion handler
+ *
+ * @return 0 if successful, -1 otherwise
+ */
+int actionslink_bt_ul_tx_async(const ActionsLink_FromMcu *p_message,
+                               actionslink_bt_ul_completion_handler_t completion_handler, void *p_context);
+
 /**
  * @brief Processes received data and gets a response, if any.
  * @note  This function must be called periodically.
@@ -69,8 +112,8 @@ int actionslink_bt_ul_tx(ActionsLink_FromMcu *p_message);
  *
  * @param[out] p_response       pointer to struct where the response should be written to
  *
- * @return  0 if nothing was received
- *          1 if a message was expected and received
- *         -1 if a message was expected, but something went wrong
+ * @return  0 if nothing was received and no transaction was completed
+ *          1 if a packet was received or a transaction was completed (successfully or not)
+ *         -1 if something went wrong while receiving data
  */
 int actionslink_bt_ul_rx(ActionsLink_ToMcu *p_response);
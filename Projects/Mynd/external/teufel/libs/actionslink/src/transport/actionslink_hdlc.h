@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(__cplusplus)
+extern "C" {
+#endif
+
+// We build the frames according to the HDLC protocol
+// see https://en.wikipedia.org/wiki/High-Level_Data_Link_Control
+#define ACTIONSLINK_HDLC_FRAME_DELIMITER  (0x7Eu)
+#define ACTIONSLINK_HDLC_ESCAPE_CHARACTER (0x7Du)
+#define ACTIONSLINK_HDLC_ESCAPE_MASK      (0x20u)
+
+#define ACTIONSLINK_HDLC_INITIAL_CRC8     (0x00u)
+
+typedef enum {
+    ACTIONSLINK_HDLC_RX_INCOMPLETE, // All the input was consumed without completing a frame
+    ACTIONSLINK_HDLC_RX_FRAME,      // A frame delimiter closed a non-empty frame
+} actionslink_hdlc_rx_result_t;
+
+/**
+ * @brief State of the HDLC frame decoder.
+ * @note  The frame is made of a header followed by a payload. The last byte of the header
+ *        holds the CRC8 of the preceding header bytes, so the decoder keeps two CRCs:
+ *        one over the header (excluding its CRC byte) and one over the payload.
+ */
+typedef struct
+{
+    uint8_t *p_buffer;        // Where the unescaped frame is written to
+    size_t   buffer_size;     // Size of the buffer
+    size_t   header_length;   // Length of the frame header (including the header CRC byte)
+    size_t   received_length; // Number of unescaped bytes received in the current frame
+    size_t   buffered_length; // Number of unescaped bytes stored in the buffer (<= received_length)
+    bool     is_escaped;      // The previous byte was the escape character
+    uint8_t  header_crc;      // CRC8 of the header bytes (excluding the header CRC byte)
+    uint8_t  payload_crc;     // CRC8 of the payload bytes
+} actionslink_hdlc_decoder_t;
+
+/**
+ * @brief Initializes an HDLC frame decoder.
+ *
+ * @param[out] p_decoder        pointer to the decoder
+ * @param[in]  p_buffer         pointer to the buffer where the unescaped frames are written to
+ * @param[in]  buffer_size      size of the buffer
+ * @param[in]  header_length    length of the frame header, the last header byte is the header CRC
+ */
+void actionslink_hdlc_decoder_init(actionslink_hdlc_decoder_t *p_decoder, uint8_t *p_buffer, size_t buffer_size,
+                                   size_t header_length);
+
+/**
+ * @brief Discards the frame being decoded.
+ *
+ * @param[in] p_decoder     pointer to the decoder
+ */
+void actionslink_hdlc_decoder_reset(actionslink_hdlc_decoder_t *p_decoder);
+
+/**
+ * @brief Decodes a span of received bytes.
+ * @note  The bytes are unescaped into the decoder buffer and the header/payload CRCs are
+ *        computed in the same pass. The span may point into the decoder buffer at or after
+ *        the current write position (p_buffer + buffered_length), in which case it is unescaped
+ *        in place without any extra copy.
+ *        After a frame is returned, the caller must reset the decoder before decoding the rest of the span.
+ *
+ * @param[in]  p_decoder    pointer to the decoder
+ * @param[in]  p_data       pointer to the received bytes
+ * @param[in]  length       number of received bytes
+ * @param[out] p_consumed   number of bytes consumed from the span
+ *
+ * @return ACTIONSLINK_HDLC_RX_FRAME if a frame was completed, ACTIONSLINK_HDLC_RX_INCOMPLETE otherwise
+ */
+actionslink_hdlc_rx_result_t actionslink_hdlc_decode(actionslink_hdlc_decoder_t *p_decoder, const uint8_t *p_data,
+                                                     size_t length, size_t *p_consumed);
+
+/**
+ * @brief Calculates the CRC8 (poly 0x07, no reflection, no final XOR) of a buffer.
+ *
+ * @param[in] crc           initial CRC value
+ * @param[in] p_data        pointer to the data
+ * @param[in] length        length of the data
+ *
+ * @return CRC8 value
+ */
+uint8_t actionslink_hdlc_crc8(uint8_t crc, const uint8_t *p_data, size_t length);
+
+/**
+ * @brief Updates a CRC8 with a single byte.
+ *
+ * @param[in] crc           current CRC value
+ * @param[in] byte          byte to add
+ *
+ * @return CRC8 value
+ */
+uint8_t actionslink_hdlc_crc8_byte(uint8_t crc, uint8_t byte);
+
+/**
+ * @brief Checks if a byte must be escaped in an HDLC frame.
+ *
+ * @param[in] byte          byte to check
+ *
+ * @return true if the byte must be escaped, false otherwise
+ */
+static inline bool actionslink_hdlc_is_escape_required(uint8_t byte)
+{
+    return (byte == ACTIONSLINK_HDLC_FRAME_DELIMITER || byte == ACTIONSLINK_HDLC_ESCAPE_CHARACTER);
+}
+
+#if defined(__cplusplus)
+}
+#endif
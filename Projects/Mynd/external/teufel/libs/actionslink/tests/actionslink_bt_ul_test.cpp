@@ -0,0 +1,367 @@
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <set>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+extern "C"
+{
+#include "actionslink_bt_ll.h"
+#include "actionslink_bt_ul.h"
+#include "actionslink_utils.h"
+}
+
+// Must match the timeout and the number of attempts in actionslink_bt_ul.c
+#define RESPONSE_TIMEOUT_MS 300u
+#define NUMBER_OF_ATTEMPTS  2u
+
+// Loopback simulation of the Actions module at packet level: every packet sent by the upper layer
+// is ACKed after ack_latency_ms and every request is answered after response_latency_ms, using a
+// simulated clock which advances by 1 ms every time the upper layer yields or finds nothing to receive.
+struct BtModuleSimulator
+{
+    struct Scheduled
+    {
+        uint32_t                        due_ms;
+        actionslink_bt_ll_packet_type_t packet_type;
+        uint8_t                         value;
+        uint8_t                         transaction_id;
+        ActionsLink_ToMcu               message;
+    };
+
+    struct Transmitted
+    {
+        uint32_t time_ms;
+        uint8_t  transaction_id;
+        uint32_t seq;
+    };
+
+    uint32_t                 now_ms              = 0;
+    uint32_t                 ack_latency_ms      = 2;
+    uint32_t                 response_latency_ms = 20;
+    std::set<size_t>         dropped;  // Indexes of the transmitted packets that get lost on the wire
+    std::set<size_t>         nacked;   // Indexes of the transmitted packets that get NACKed
+    std::deque<Scheduled>    rx_queue; // Sorted by due time
+    std::vector<Transmitted> transmitted;
+
+    void schedule(const Scheduled &scheduled)
+    {
+        auto it = std::upper_bound(rx_queue.begin(), rx_queue.end(), scheduled,
+                                   [](const Scheduled &a, const Scheduled &b) { return a.due_ms < b.due_ms; });
+        rx_queue.insert(it, scheduled);
+    }
+
+    void on_tx(const actionslink_bt_ll_tx_packet_t *p_packet)
+    {
+        const ActionsLink_FromMcuRequest &request = p_packet->p_payload->Payload.request;
+        const size_t                      index   = transmitted.size();
+        transmitted.push_back({now_ms, p_packet->transaction_id, request.seq});
+
+        if (dropped.count(index))
+        {
+            return;
+        }
+
+        Scheduled ack{};
+        ack.due_ms         = now_ms + ack_latency_ms;
+        ack.packet_type    = ACTIONSLINK_BT_LL_PACKET_TYPE_ACK;
+        ack.value          = nacked.count(index) ? 1 : 0;
+        ack.transaction_id = p_packet->transaction_id;
+        schedule(ack);
+
+        if (ack.value != 0 || p_packet->p_payload->which_Payload != ActionsLink_FromMcu_request_tag)
+        {
+            return;
+        }
+
+        Scheduled response{};
+        response.due_ms                                  = now_ms + response_latency_ms;
+        response.packet_type                             = ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF;
+        response.transaction_id                          = p_packet->transaction_id;
+        response.message.which_Payload                   = ActionsLink_ToMcu_response_tag;
+        response.message.Payload.response.seq            = request.seq;
+        response.message.Payload.response.which_Response = request.which_Request;
+        schedule(response);
+    }
+
+    int on_rx(actionslink_bt_ll_rx_packet_t *p_packet)
+    {
+        if (rx_queue.empty() || rx_queue.front().due_ms > now_ms)
+        {
+            return 0;
+        }
+
+        Scheduled scheduled = rx_queue.front();
+        rx_queue.pop_front();
+
+        p_packet->packet_type    = scheduled.packet_type;
+        p_packet->value          = scheduled.value;
+        p_packet->transaction_id = scheduled.transaction_id;
+        if (scheduled.packet_type == ACTIONSLINK_BT_LL_PACKET_TYPE_PROTOBUF)
+        {
+            *p_packet->payload.p_message = scheduled.message;
+        }
+        return 1;
+    }
+};
+
+static BtModuleSimulator *mp_simulator;
+
+extern "C"
+{
+    void actionslink_bt_ll_init(const actionslink_config_t *p_config)
+    {
+        (void) p_config;
+    }
+
+    void actionslink_bt_ll_reset(void) {}
+
+    int actionslink_bt_ll_tx(const actionslink_bt_ll_tx_packet_t *p_packet)
+    {
+        mp_simulator->on_tx(p_packet);
+        return 0;
+    }
+
+    int actionslink_bt_ll_rx(actionslink_bt_ll_rx_packet_t *p_packet)
+    {
+        return mp_simulator->on_rx(p_packet);
+    }
+}
+
+static uint32_t get_tick_ms(void)
+{
+    return mp_simulator->now_ms;
+}
+
+static void task_yield(void)
+{
+    mp_simulator->now_ms++;
+}
+
+static void on_event(const ActionsLink_ToMcuEvent *, const uint8_t *, uint16_t) {}
+
+static void on_request(const ActionsLink_ToMcuRequest *, const uint8_t *, uint16_t) {}
+
+struct Completion
+{
+    int      result;
+    uint32_t seq;
+    uint32_t time_ms;
+};
+
+static std::vector<Completion> m_completions;
+
+static void on_completed(int result, const ActionsLink_ToMcu *p_response, void *p_context)
+{
+    (void) p_context;
+    m_completions.push_back({result, p_response ? p_response->Payload.response.seq : UINT32_MAX, mp_simulator->now_ms});
+}
+
+class ActionslinkBtUlTest : public ::testing::Test
+{
+  protected:
+    BtModuleSimulator    simulator;
+    actionslink_config_t config{};
+    uint32_t             next_seq = 0;
+
+    void SetUp() override
+    {
+        mp_simulator = &simulator;
+        m_completions.clear();
+
+        config.get_tick_ms_fn = get_tick_ms;
+        config.task_yield_fn  = task_yield;
+        actionslink_utils_init(&config);
+        actionslink_bt_ul_init(&config, on_event, on_request);
+    }
+
+    ActionsLink_FromMcu make_request(pb_size_t tag)
+    {
+        ActionsLink_FromMcu message           = ActionsLink_FromMcu_init_zero;
+        message.which_Payload                 = ActionsLink_FromMcu_request_tag;
+        message.Payload.request.seq           = next_seq++;
+        message.Payload.request.which_Request = tag;
+        return message;
+    }
+
+    // Mirrors actionslink_tick(), which is called periodically by the Bluetooth task
+    void run_until_idle()
+    {
+        while (actionslink_bt_ul_get_number_of_pending_transactions() > 0)
+        {
+            ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
+            if (actionslink_bt_ul_rx(&response) == 0)
+            {
+                simulator.now_ms++;
+            }
+        }
+    }
+};
+
+TEST_F(ActionslinkBtUlTest, PipelinesBackToBackRequests)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+        EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+    }
+
+    // All requests are on the wire before the first ACK arrives
+    EXPECT_EQ(actionslink_bt_ul_get_number_of_pending_transactions(), 3u);
+    ASSERT_EQ(simulator.transmitted.size(), 3u);
+    EXPECT_EQ(simulator.transmitted.back().time_ms, 0u);
+
+    run_until_idle();
+
+    ASSERT_EQ(m_completions.size(), 3u);
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        EXPECT_EQ(m_completions[i].result, 0);
+        EXPECT_EQ(m_completions[i].seq, i);
+        EXPECT_EQ(m_completions[i].time_ms, simulator.response_latency_ms);
+    }
+}
+
+TEST_F(ActionslinkBtUlTest, RetriesOnlyTheLostRequest)
+{
+    simulator.dropped = {1};
+
+    for (int i = 0; i < 3; i++)
+    {
+        ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_send_avrcp_action_tag);
+        EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+    }
+
+    run_until_idle();
+
+    ASSERT_EQ(simulator.transmitted.size(), 4u);
+    EXPECT_EQ(simulator.transmitted[3].seq, 1u);
+    EXPECT_NE(simulator.transmitted[3].transaction_id, simulator.transmitted[1].transaction_id);
+    EXPECT_GT(simulator.transmitted[3].time_ms, RESPONSE_TIMEOUT_MS);
+
+    ASSERT_EQ(m_completions.size(), 3u);
+    EXPECT_THAT(m_completions, ::testing::Each(::testing::Field(&Completion::result, 0)));
+    EXPECT_EQ(m_completions[0].seq, 0u);
+    EXPECT_EQ(m_completions[1].seq, 2u);
+    EXPECT_EQ(m_completions[2].seq, 1u);
+}
+
+TEST_F(ActionslinkBtUlTest, FailsAfterAllAttemptsAreLost)
+{
+    simulator.dropped = {0, 1, 2};
+
+    ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+    EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+
+    run_until_idle();
+
+    EXPECT_EQ(simulator.transmitted.size(), NUMBER_OF_ATTEMPTS);
+    ASSERT_EQ(m_completions.size(), 1u);
+    EXPECT_EQ(m_completions[0].result, -1);
+    EXPECT_EQ(m_completions[0].seq, UINT32_MAX);
+}
+
+TEST_F(ActionslinkBtUlTest, NackResendsWithoutWaitingForTheTimeout)
+{
+    simulator.nacked = {0};
+
+    ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+    EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+
+    run_until_idle();
+
+    ASSERT_EQ(simulator.transmitted.size(), 2u);
+    EXPECT_EQ(simulator.transmitted[1].time_ms, simulator.ack_latency_ms);
+    ASSERT_EQ(m_completions.size(), 1u);
+    EXPECT_EQ(m_completions[0].result, 0);
+    EXPECT_LT(m_completions[0].time_ms, RESPONSE_TIMEOUT_MS);
+}
+
+TEST_F(ActionslinkBtUlTest, NackOfTheLastAttemptFailsWithoutWaitingForTheTimeout)
+{
+    simulator.nacked = {0, 1};
+
+    ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+    EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+
+    run_until_idle();
+
+    EXPECT_EQ(simulator.transmitted.size(), NUMBER_OF_ATTEMPTS);
+    ASSERT_EQ(m_completions.size(), 1u);
+    EXPECT_EQ(m_completions[0].result, -1);
+    EXPECT_EQ(m_completions[0].time_ms, NUMBER_OF_ATTEMPTS * simulator.ack_latency_ms);
+}
+
+TEST_F(ActionslinkBtUlTest, FullTableWaitsForAFreeSlot)
+{
+    for (uint32_t i = 0; i < ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS + 1; i++)
+    {
+        ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+        EXPECT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+    }
+
+    EXPECT_EQ(m_completions.size(), 1u);
+    EXPECT_EQ(simulator.transmitted.back().time_ms, simulator.response_latency_ms);
+
+    run_until_idle();
+    EXPECT_EQ(m_completions.size(), ACTIONSLINK_BT_UL_MAX_PENDING_TRANSACTIONS + 1);
+}
+
+TEST_F(ActionslinkBtUlTest, SyncRequestWaitsForTheRequestsInFlight)
+{
+    ActionsLink_FromMcu async_message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+    EXPECT_EQ(actionslink_bt_ul_tx_async(&async_message, on_completed, nullptr), 0);
+
+    ActionsLink_FromMcu sync_message = make_request(ActionsLink_FromMcuRequest_send_avrcp_action_tag);
+    ActionsLink_ToMcu   response     = ActionsLink_ToMcu_init_zero;
+    EXPECT_EQ(actionslink_bt_ul_tx_rx(&sync_message, &response), 0);
+
+    ASSERT_EQ(m_completions.size(), 1u);
+    EXPECT_EQ(m_completions[0].seq, async_message.Payload.request.seq);
+    EXPECT_EQ(response.Payload.response.seq, sync_message.Payload.request.seq);
+    EXPECT_EQ(actionslink_bt_ul_get_number_of_pending_transactions(), 0u);
+}
+
+TEST_F(ActionslinkBtUlTest, RoundTripLatency)
+{
+    const uint32_t number_of_requests = 64;
+
+    // One request at a time, as before the transaction table
+    uint32_t start_ms = simulator.now_ms;
+    for (uint32_t i = 0; i < number_of_requests; i++)
+    {
+        ActionsLink_FromMcu message  = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+        ActionsLink_ToMcu   response = ActionsLink_ToMcu_init_zero;
+        ASSERT_EQ(actionslink_bt_ul_tx_rx(&message, &response), 0);
+    }
+    const uint32_t sequential_ms = simulator.now_ms - start_ms;
+
+    // Back-to-back, e.g. while the volume button is held
+    start_ms = simulator.now_ms;
+    std::vector<uint32_t> sent_ms;
+    for (uint32_t i = 0; i < number_of_requests; i++)
+    {
+        // Blocks while the transaction table is full, so the request is on the wire once this returns
+        ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_volume_tag);
+        ASSERT_EQ(actionslink_bt_ul_tx_async(&message, on_completed, nullptr), 0);
+        sent_ms.push_back(simulator.now_ms);
+    }
+    run_until_idle();
+    const uint32_t pipelined_ms = simulator.now_ms - start_ms;
+
+    ASSERT_EQ(m_completions.size(), number_of_requests);
+    uint32_t max_round_trip_ms = 0;
+    for (uint32_t i = 0; i < number_of_requests; i++)
+    {
+        max_round_trip_ms = std::max(max_round_trip_ms, m_completions[i].time_ms - sent_ms[i]);
+    }
+
+    printf("%u requests, %u ms response latency: sequential %u ms, pipelined %u ms (max round trip %u ms)\n",
+           number_of_requests, simulator.response_latency_ms, sequential_ms, pipelined_ms, max_round_trip_ms);
+
+    EXPECT_EQ(max_round_trip_ms, simulator.response_latency_ms);
+    EXPECT_LT(pipelined_ms * 2, sequential_ms);
+}
@@ -0,0 +1,241 @@
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include "actionslink_bt_ll.h"
+#include "actionslink_bt_ul.h"
+#include "actionslink_emulator.h"
+#include "actionslink_utils.h"
+}
+
+// Must match the timeout in actionslink_bt_ul.c
+#define RESPONSE_TIMEOUT_MS 300u
+
+// The real transport of the MCU against the emulator, byte by byte over the write/read hooks, with a simulated
+// clock which advances by 1 ms every time the transport yields or finds nothing to receive.
+static uint32_t m_now_ms;
+
+static std::vector<pb_size_t> m_events;
+
+static uint32_t get_tick_ms(void)
+{
+    return m_now_ms;
+}
+
+static void task_yield(void)
+{
+    m_now_ms++;
+}
+
+static void on_event(const ActionsLink_ToMcuEvent *p_event, const uint8_t *, uint16_t)
+{
+    m_events.push_back(p_event->which_Event);
+}
+
+// Answers the requests of the emulator, like the request handlers of the Bluetooth task
+static void on_request(const ActionsLink_ToMcuRequest *p_request, const uint8_t *, uint16_t)
+{
+    ActionsLink_FromMcu message             = ActionsLink_FromMcu_init_zero;
+    message.which_Payload                   = ActionsLink_FromMcu_response_tag;
+    message.Payload.response.seq            = p_request->seq;
+    message.Payload.response.which_Response = p_request->which_Request;
+    actionslink_bt_ul_tx_async(&message, nullptr, nullptr);
+}
+
+static size_t count_events(pb_size_t tag)
+{
+    size_t count = 0;
+    for (auto event : m_events)
+    {
+        count += (event == tag) ? 1 : 0;
+    }
+    return count;
+}
+
+class ActionslinkEmulatorTest : public ::testing::Test
+{
+  protected:
+    uint8_t                       rx_buffer[512];
+    uint8_t                       tx_buffer[256];
+    actionslink_config_t          config{};
+    actionslink_emulator_config_t emulator_config{};
+    uint32_t                      next_seq = 0;
+
+    void SetUp() override
+    {
+        m_now_ms = 1000;
+        m_events.clear();
+
+        config.write_buffer_fn = actionslink_emulator_write_buffer;
+        config.read_buffer_fn  = actionslink_emulator_read_buffer;
+        config.get_tick_ms_fn  = get_tick_ms;
+        config.task_yield_fn   = task_yield;
+        config.p_rx_buffer     = rx_buffer;
+        config.rx_buffer_size  = sizeof(rx_buffer);
+        config.p_tx_buffer     = tx_buffer;
+        config.tx_buffer_size  = sizeof(tx_buffer);
+        actionslink_utils_init(&config);
+        actionslink_bt_ll_init(&config);
+        actionslink_bt_ul_init(&config, on_event, on_request);
+
+        emulator_config.get_tick_ms_fn      = get_tick_ms;
+        emulator_config.seed                = 1;
+        emulator_config.ack_latency_ms      = 2;
+        emulator_config.response_latency_ms = 20;
+        actionslink_emulator_init(&emulator_config);
+    }
+
+    ActionsLink_FromMcu make_request(pb_size_t tag)
+    {
+        ActionsLink_FromMcu message           = ActionsLink_FromMcu_init_zero;
+        message.which_Payload                 = ActionsLink_FromMcu_request_tag;
+        message.Payload.request.seq           = next_seq++;
+        message.Payload.request.which_Request = tag;
+        return message;
+    }
+
+    // Mirrors actionslink_tick(), which is called periodically by the Bluetooth task
+    void run_for(uint32_t duration_ms)
+    {
+        const uint32_t end_ms = m_now_ms + duration_ms;
+        while (m_now_ms < end_ms)
+        {
+            ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
+            if (actionslink_bt_ul_rx(&response) == 0)
+            {
+                m_now_ms++;
+            }
+        }
+    }
+
+    actionslink_emulator_stats_t stats() const
+    {
+        actionslink_emulator_stats_t stats;
+        actionslink_emulator_get_stats(&stats);
+        return stats;
+    }
+};
+
+TEST_F(ActionslinkEmulatorTest, AnswersTheRequestsOfTheMcu)
+{
+    ASSERT_EQ(actionslink_emulator_run("ready"), 0);
+    run_for(10);
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_system_ready_tag), 1u);
+
+    ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_set_power_state_tag);
+    message.Payload.request.Request.set_power_state.mode = ActionsLink_System_PowerState_SystemPowerMode_ON;
+    ActionsLink_ToMcu response = ActionsLink_ToMcu_init_zero;
+    ASSERT_EQ(actionslink_bt_ul_tx_rx(&message, &response), 0);
+    run_for(10);
+
+    // The module reports its power state and audio source after powering on
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_power_state_tag), 1u);
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_audio_source_tag), 1u);
+
+    actionslink_emulator_latency_t latency;
+    ASSERT_EQ(actionslink_emulator_get_latency(ACTIONSLINK_EMULATOR_FROM_MCU,
+                                               ActionsLink_FromMcuRequest_set_power_state_tag, &latency),
+              0);
+    EXPECT_EQ(latency.count, 1u);
+    EXPECT_EQ(latency.retries, 0u);
+    EXPECT_GE(latency.p50_ms, emulator_config.response_latency_ms);
+    EXPECT_LT(latency.max_ms, RESPONSE_TIMEOUT_MS);
+
+    EXPECT_EQ(stats().requests_pending, 0u);
+    EXPECT_EQ(stats().bad_frames, 0u);
+}
+
+TEST_F(ActionslinkEmulatorTest, LostRequestIsRetriedByTheMcu)
+{
+    ASSERT_EQ(actionslink_emulator_run("drop 1"), 0);
+
+    ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_get_csb_state_tag);
+    ActionsLink_ToMcu   response = ActionsLink_ToMcu_init_zero;
+    ASSERT_EQ(actionslink_bt_ul_tx_rx(&message, &response), 0);
+    EXPECT_EQ(response.Payload.response.which_Response, ActionsLink_FromMcuRequest_get_csb_state_tag);
+    run_for(10);
+
+    actionslink_emulator_latency_t latency;
+    ASSERT_EQ(actionslink_emulator_get_latency(ACTIONSLINK_EMULATOR_FROM_MCU, 0, &latency), 0);
+    EXPECT_EQ(latency.count, 1u);
+    EXPECT_EQ(latency.retries, 1u);
+    EXPECT_GT(latency.p50_ms, RESPONSE_TIMEOUT_MS);
+    EXPECT_EQ(stats().frames_dropped, 1u);
+    EXPECT_EQ(stats().mcu_retries, 1u);
+}
+
+TEST_F(ActionslinkEmulatorTest, CorruptedEventIsSentAgain)
+{
+    ASSERT_EQ(actionslink_emulator_run("corrupt-crc 1"), 0);
+    ASSERT_EQ(actionslink_emulator_run("connect"), 0);
+    run_for(100);
+
+    // NACKed by the MCU and handled once
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_bt_connection_tag), 1u);
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_bt_connection_state_tag), 1u);
+    EXPECT_EQ(stats().crcs_corrupted, 1u);
+    EXPECT_EQ(stats().nacks_received, 1u);
+    EXPECT_EQ(stats().module_retries, 1u);
+    EXPECT_EQ(stats().module_failures, 0u);
+}
+
+TEST_F(ActionslinkEmulatorTest, SameSeedGivesTheSameLatencies)
+{
+    auto run_scenario = [this](uint32_t seed) {
+        emulator_config.seed      = seed;
+        emulator_config.jitter_ms = 15;
+        actionslink_emulator_init(&emulator_config);
+
+        for (int i = 0; i < 50; i++)
+        {
+            ActionsLink_FromMcu message = make_request(ActionsLink_FromMcuRequest_get_bt_connection_state_tag);
+            EXPECT_EQ(actionslink_bt_ul_tx_async(&message, nullptr, nullptr), 0);
+            run_for(5);
+        }
+        run_for(100);
+
+        actionslink_emulator_latency_t latency;
+        EXPECT_EQ(actionslink_emulator_get_latency(ACTIONSLINK_EMULATOR_FROM_MCU, 0, &latency), 0);
+        return latency;
+    };
+
+    const auto first  = run_scenario(7);
+    const auto second = run_scenario(7);
+
+    std::printf("p50 %u ms, p90 %u ms, p99 %u ms, max %u ms\n", first.p50_ms, first.p90_ms, first.p99_ms,
+                first.max_ms);
+    EXPECT_EQ(first.count, 50u);
+    EXPECT_EQ(second.count, first.count);
+    EXPECT_EQ(second.p50_ms, first.p50_ms);
+    EXPECT_EQ(second.p90_ms, first.p90_ms);
+    EXPECT_EQ(second.p99_ms, first.p99_ms);
+    EXPECT_EQ(second.max_ms, first.max_ms);
+    EXPECT_LE(first.p50_ms, first.p90_ms);
+    EXPECT_LE(first.p90_ms, first.p99_ms);
+    EXPECT_LE(first.p99_ms, first.max_ms);
+}
+
+TEST_F(ActionslinkEmulatorTest, AvrcpStormAndRequestsOfTheModule)
+{
+    ASSERT_EQ(actionslink_emulator_run("avrcp-storm 50 0"), 0);
+    ASSERT_EQ(actionslink_emulator_run("request get_battery_capacity"), 0);
+    run_for(500);
+
+    EXPECT_EQ(count_events(ActionsLink_ToMcuEvent_notify_volume_tag), 50u);
+    EXPECT_EQ(stats().events_sent, 50u);
+    EXPECT_EQ(stats().module_failures, 0u);
+    EXPECT_EQ(stats().queue_overflows, 0u);
+
+    actionslink_emulator_latency_t latency;
+    ASSERT_EQ(actionslink_emulator_get_latency(ACTIONSLINK_EMULATOR_TO_MCU,
+                                               ActionsLink_ToMcuRequest_get_battery_capacity_tag, &latency),
+              0);
+    EXPECT_EQ(latency.count, 1u);
+    EXPECT_EQ(stats().requests_pending, 0u);
+
+    EXPECT_EQ(actionslink_emulator_run("avrcp-storm"), -1);
+    EXPECT_EQ(actionslink_emulator_run("request set_volume"), -1);
+}
@@ -0,0 +1,339 @@
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "actionslink_hdlc.h"
+
+#define HEADER_SIZE      8
+#define HEADER_CRC_INDEX 7
+
+using Bytes = std::vector<uint8_t>;
+
+// Builds an escaped frame with the header CRC at HEADER_CRC_INDEX, mirroring actionslink_bt_ll_tx
+static Bytes build_frame(Bytes header, const Bytes &payload)
+{
+    header.resize(HEADER_SIZE);
+    header[HEADER_CRC_INDEX] = actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, header.data(), HEADER_SIZE - 1);
+
+    Bytes raw = header;
+    raw.insert(raw.end(), payload.begin(), payload.end());
+
+    Bytes frame{ACTIONSLINK_HDLC_FRAME_DELIMITER};
+    for (auto byte : raw)
+    {
+        if (actionslink_hdlc_is_escape_required(byte))
+        {
+            frame.push_back(ACTIONSLINK_HDLC_ESCAPE_CHARACTER);
+            frame.push_back(byte ^ ACTIONSLINK_HDLC_ESCAPE_MASK);
+        }
+        else
+        {
+            frame.push_back(byte);
+        }
+    }
+    frame.push_back(ACTIONSLINK_HDLC_FRAME_DELIMITER);
+    return frame;
+}
+
+// Per-byte decoder equivalent to the one the span decoder replaced, used as reference
+struct ReferenceDecoder
+{
+    Bytes  buffer;
+    size_t buffer_size;
+    size_t received = 0;
+    bool   escaped  = false;
+
+    explicit ReferenceDecoder(size_t size) : buffer_size(size) {}
+
+    // Returns true when a frame is completed
+    bool push(uint8_t byte)
+    {
+        if (byte == ACTIONSLINK_HDLC_FRAME_DELIMITER)
+        {
+            return received > 0;
+        }
+        if (byte == ACTIONSLINK_HDLC_ESCAPE_CHARACTER)
+        {
+            escaped = true;
+            return false;
+        }
+        if (escaped)
+        {
+            byte ^= ACTIONSLINK_HDLC_ESCAPE_MASK;
+            escaped = false;
+        }
+        if (buffer.size() < buffer_size)
+        {
+            buffer.push_back(byte);
+        }
+        received++;
+        return false;
+    }
+
+    void reset()
+    {
+        buffer.clear();
+        received = 0;
+        escaped  = false;
+    }
+};
+
+struct DecodedFrame
+{
+    Bytes   data;
+    size_t  received;
+    uint8_t header_crc;
+    uint8_t payload_crc;
+};
+
+// Feeds the stream to the span decoder in chunks of chunk_size bytes
+static std::vector<DecodedFrame> decode_stream(const Bytes &stream, size_t buffer_size, size_t chunk_size)
+{
+    std::vector<DecodedFrame>  frames;
+    Bytes                      buffer(buffer_size);
+    actionslink_hdlc_decoder_t decoder;
+    actionslink_hdlc_decoder_init(&decoder, buffer.data(), buffer.size(), HEADER_SIZE);
+
+    for (size_t offset = 0; offset < stream.size(); offset += chunk_size)
+    {
+        const uint8_t *p_data = &stream[offset];
+        size_t         length = std::min(chunk_size, stream.size() - offset);
+        while (length > 0)
+        {
+            size_t consumed;
+            if (actionslink_hdlc_decode(&decoder, p_data, length, &consumed) == ACTIONSLINK_HDLC_RX_FRAME)
+            {
+                frames.push_back({Bytes(buffer.begin(), buffer.begin() + decoder.buffered_length),
+                                  decoder.received_length, decoder.header_crc, decoder.payload_crc});
+                actionslink_hdlc_decoder_reset(&decoder);
+            }
+            p_data += consumed;
+            length -= consumed;
+        }
+    }
+    return frames;
+}
+
+static std::vector<DecodedFrame> reference_decode_stream(const Bytes &stream, size_t buffer_size)
+{
+    std::vector<DecodedFrame> frames;
+    ReferenceDecoder          decoder(buffer_size);
+    for (auto byte : stream)
+    {
+        if (decoder.push(byte))
+        {
+            const auto &b          = decoder.buffer;
+            size_t      header_len = std::min<size_t>(b.size(), HEADER_SIZE - 1);
+            uint8_t     header_crc = actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, b.data(), header_len);
+            uint8_t     payload_crc =
+                b.size() > HEADER_SIZE
+                    ? actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, &b[HEADER_SIZE], b.size() - HEADER_SIZE)
+                    : ACTIONSLINK_HDLC_INITIAL_CRC8;
+            frames.push_back({b, decoder.received, header_crc, payload_crc});
+            decoder.reset();
+        }
+    }
+    return frames;
+}
+
+TEST(ActionslinkHdlcTest, Crc8MatchesKnownValue)
+{
+    // CRC-8 (poly 0x07, init 0x00) check value
+    const uint8_t data[] = {'1', '2', '3', '4', '5', '6', '7', '8', '9'};
+    EXPECT_EQ(actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, data, sizeof(data)), 0xF4);
+
+    uint8_t crc = ACTIONSLINK_HDLC_INITIAL_CRC8;
+    for (auto byte : data)
+    {
+        crc = actionslink_hdlc_crc8_byte(crc, byte);
+    }
+    EXPECT_EQ(crc, 0xF4);
+}
+
+TEST(ActionslinkHdlcTest, DecodeFrameWithoutPayload)
+{
+    Bytes header = {0x55, 0x00, 0x12, 0x00, 0x00, 0x00, 0x00};
+    auto  frames = decode_stream(build_frame(header, {}), 64, 64);
+
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].data.size(), HEADER_SIZE);
+    EXPECT_EQ(frames[0].received, HEADER_SIZE);
+    EXPECT_EQ(frames[0].header_crc, frames[0].data[HEADER_CRC_INDEX]);
+    EXPECT_EQ(frames[0].payload_crc, ACTIONSLINK_HDLC_INITIAL_CRC8);
+}
+
+TEST(ActionslinkHdlcTest, DecodeEscapedFrame)
+{
+    Bytes payload = {0x7E, 0x01, 0x7D, 0x7D, 0x5E, 0x7E};
+    Bytes header  = {0x55, 0x7E, 0x7D, static_cast<uint8_t>(payload.size()), 0x00, 0x00, 0x00};
+    header[5]     = actionslink_hdlc_crc8(ACTIONSLINK_HDLC_INITIAL_CRC8, payload.data(), payload.size());
+    auto frames   = decode_stream(build_frame(header, payload), 64, 64);
+
+    ASSERT_EQ(frames.size(), 1u);
+    ASSERT_EQ(frames[0].data.size(), HEADER_SIZE + payload.size());
+    EXPECT_THAT(Bytes(frames[0].data.begin() + HEADER_SIZE, frames[0].data.end()), ::testing::ContainerEq(payload));
+    EXPECT_EQ(frames[0].data[1], 0x7E);
+    EXPECT_EQ(frames[0].data[2], 0x7D);
+    EXPECT_EQ(frames[0].header_crc, frames[0].data[HEADER_CRC_INDEX]);
+    EXPECT_EQ(frames[0].payload_crc, frames[0].data[5]);
+}
+
+TEST(ActionslinkHdlcTest, DecodeFrameSplitAtEveryPosition)
+{
+    Bytes payload = {0x10, 0x7D, 0x20, 0x7E, 0x30};
+    Bytes header  = {0x55, 0x01, 0x03, static_cast<uint8_t>(payload.size()), 0x00, 0x00, 0x00};
+    Bytes frame   = build_frame(header, payload);
+    auto  whole   = decode_stream(frame, 64, frame.size());
+    ASSERT_EQ(whole.size(), 1u);
+
+    for (size_t chunk_size = 1; chunk_size < frame.size(); chunk_size++)
+    {
+        auto frames = decode_stream(frame, 64, chunk_size);
+        ASSERT_EQ(frames.size(), 1u) << "chunk size " << chunk_size;
+        EXPECT_EQ(frames[0].data, whole[0].data) << "chunk size " << chunk_size;
+        EXPECT_EQ(frames[0].payload_crc, whole[0].payload_crc) << "chunk size " << chunk_size;
+    }
+}
+
+TEST(ActionslinkHdlcTest, DecodeBackToBackFramesInOneSpan)
+{
+    Bytes stream;
+    for (uint8_t id = 0; id < 3; id++)
+    {
+        Bytes frame = build_frame({0x55, 0x01, id, 0x01, 0x00, 0x00, 0x00}, {id});
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    auto frames = decode_stream(stream, 64, stream.size());
+    ASSERT_EQ(frames.size(), 3u);
+    for (uint8_t id = 0; id < 3; id++)
+    {
+        EXPECT_EQ(frames[id].data[2], id);
+        EXPECT_EQ(frames[id].data[HEADER_SIZE], id);
+    }
+}
+
+TEST(ActionslinkHdlcTest, DecodeInPlace)
+{
+    Bytes payload = {0x7E, 0x7D, 0x00, 0xFF};
+    Bytes frame   = build_frame({0x55, 0x01, 0x07, static_cast<uint8_t>(payload.size()), 0x00, 0x00, 0x00}, payload);
+
+    // The raw bytes are read into the decoder buffer itself, like actionslink_bt_ll_rx does
+    Bytes buffer(64);
+    std::copy(frame.begin(), frame.end(), buffer.begin());
+
+    actionslink_hdlc_decoder_t decoder;
+    actionslink_hdlc_decoder_init(&decoder, buffer.data(), buffer.size(), HEADER_SIZE);
+
+    size_t consumed;
+    ASSERT_EQ(actionslink_hdlc_decode(&decoder, buffer.data(), frame.size(), &consumed), ACTIONSLINK_HDLC_RX_FRAME);
+    EXPECT_EQ(consumed, frame.size());
+    ASSERT_EQ(decoder.buffered_length, HEADER_SIZE + payload.size());
+    EXPECT_THAT(Bytes(buffer.begin() + HEADER_SIZE, buffer.begin() + decoder.buffered_length),
+                ::testing::ContainerEq(payload));
+    EXPECT_EQ(decoder.header_crc, buffer[HEADER_CRC_INDEX]);
+}
+
+TEST(ActionslinkHdlcTest, OverflowIsCountedButNotBuffered)
+{
+    Bytes payload(40, 0xA5);
+    auto  frames = decode_stream(build_frame({0x55, 0x01, 0x01, 40, 0x00, 0x00, 0x00}, payload), 32, 5);
+
+    ASSERT_EQ(frames.size(), 1u);
+    EXPECT_EQ(frames[0].data.size(), 32u);
+    EXPECT_EQ(frames[0].received, HEADER_SIZE + payload.size());
+}
+
+TEST(ActionslinkHdlcTest, BrokenFramesAreDelimited)
+{
+    // A frame cut short by a delimiter, followed by a valid frame
+    Bytes stream = {ACTIONSLINK_HDLC_FRAME_DELIMITER, 0x55, 0x01, ACTIONSLINK_HDLC_ESCAPE_CHARACTER};
+    Bytes frame  = build_frame({0x55, 0x01, 0x09, 0x00, 0x00, 0x00, 0x00}, {});
+    stream.insert(stream.end(), frame.begin(), frame.end());
+
+    auto frames = decode_stream(stream, 64, 3);
+    ASSERT_EQ(frames.size(), 2u);
+    EXPECT_EQ(frames[0].received, 2u);
+    EXPECT_EQ(frames[1].data.size(), HEADER_SIZE);
+    EXPECT_EQ(frames[1].header_crc, frames[1].data[HEADER_CRC_INDEX]);
+}
+
+TEST(ActionslinkHdlcTest, FuzzMatchesReferenceDecoder)
+{
+    std::mt19937                        rng(0x5EED);
+    std::uniform_int_distribution<int>  byte_dist(0, 255);
+    std::uniform_int_distribution<int>  special_dist(0, 7);
+    std::uniform_int_distribution<int>  length_dist(0, 300);
+    std::uniform_int_distribution<int>  chunk_dist(1, 48);
+    std::uniform_int_distribution<int>  size_dist(8, 80);
+
+    for (int iteration = 0; iteration < 500; iteration++)
+    {
+        // Random data with plenty of delimiters and escape characters
+        Bytes stream(length_dist(rng));
+        for (auto &byte : stream)
+        {
+            switch (special_dist(rng))
+            {
+                case 0:
+                    byte = ACTIONSLINK_HDLC_FRAME_DELIMITER;
+                    break;
+                case 1:
+                    byte = ACTIONSLINK_HDLC_ESCAPE_CHARACTER;
+                    break;
+                default:
+                    byte = static_cast<uint8_t>(byte_dist(rng));
+                    break;
+            }
+        }
+
+        size_t buffer_size = size_dist(rng);
+        auto   expected    = reference_decode_stream(stream, buffer_size);
+        auto   actual      = decode_stream(stream, buffer_size, chunk_dist(rng));
+
+        ASSERT_EQ(actual.size(), expected.size()) << "iteration " << iteration;
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            ASSERT_EQ(actual[i].data, expected[i].data) << "iteration " << iteration << " frame " << i;
+            ASSERT_EQ(actual[i].received, expected[i].received) << "iteration " << iteration << " frame " << i;
+            ASSERT_EQ(actual[i].header_crc, expected[i].header_crc) << "iteration " << iteration << " frame " << i;
+            ASSERT_EQ(actual[i].payload_crc, expected[i].payload_crc) << "iteration " << iteration << " frame " << i;
+        }
+    }
+}
+
+TEST(ActionslinkHdlcTest, ThroughputBenchmark)
+{
+    std::mt19937                       rng(0xBE7C);
+    std::uniform_int_distribution<int> byte_dist(0, 255);
+
+    Bytes stream;
+    while (stream.size() < (1u << 20))
+    {
+        Bytes payload(56);
+        for (auto &byte : payload)
+        {
+            byte = static_cast<uint8_t>(byte_dist(rng));
+        }
+        Bytes frame = build_frame({0x55, 0x01, 0x01, 56, 0x00, 0x00, 0x00}, payload);
+        stream.insert(stream.end(), frame.begin(), frame.end());
+    }
+
+    using clock = std::chrono::steady_clock;
+
+    auto   start      = clock::now();
+    auto   per_byte   = decode_stream(stream, 64, 1);
+    auto   per_byte_t = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    start             = clock::now();
+    auto   per_span   = decode_stream(stream, 64, 64);
+    auto   per_span_t = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+
+    ASSERT_EQ(per_byte.size(), per_span.size());
+    std::printf("hdlc decode: per-byte %.3f bytes/ns, per-span %.3f bytes/ns (%zu bytes)\n",
+                stream.size() / per_byte_t, stream.size() / per_span_t, stream.size());
+}
@@ -6,3 +6,5 @@ __attribute__((weak)) uint32_t logger_get_timestamp()
 {
     return 0;
 }
+
+__attribute__((weak)) void logger_binary_notify(void) {}
@@ -25,6 +25,7 @@
 
 #define LOGGER_OUTPUT_RAW       0 // Logs using printf without any formatting
 #define LOGGER_OUTPUT_FORMATTED 1 // Generic output, which invokes printf call, with defined formatting
+#define LOGGER_OUTPUT_BINARY    2 // Compact records formatted on the host by tools/logger_decode.py
 
 typedef enum
 {
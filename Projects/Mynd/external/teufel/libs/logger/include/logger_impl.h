@@ -25,6 +25,24 @@ void logger_init(void);
  */
 void logger_flush(void);
 
+typedef struct
+{
+    uint32_t dropped_bytes;   // Bytes which didn't fit into the buffer of the logger thread
+    uint32_t peak_fill_bytes; // Highest fill level of the buffer
+    uint32_t size_bytes;
+} logger_stats_t;
+
+/**
+ * @brief Gets the statistics of the buffer between the log calls and the logger thread since the last reset.
+ * @note  All zero without the logger thread (LOGGER_USE_EXTERNAL_THREAD).
+ */
+void logger_get_stats(logger_stats_t *p_stats);
+
+/**
+ * @brief Resets the statistics of the buffer.
+ */
+void logger_reset_stats(void);
+
 /**
  * @brief Gets a system timestamp.
  * @return timestamp
@@ -44,6 +44,13 @@ static void print_buffer_full_error(void);
 static StreamBufferHandle_t sbuffer_logger_h = NULL;
 static SemaphoreHandle_t    mutex;
 
+// Updated from the tasks and the interrupts which log
+static struct
+{
+    uint32_t dropped_bytes;
+    uint32_t peak_fill_bytes;
+} s_stats;
+
 int logger_init(StreamBufferHandle_t sbuf)
 {
     if (!sbuf)
@@ -68,9 +75,12 @@ int logger_init(StreamBufferHandle_t sbuf)
 int logger_internal_lock(void)
 {
 #if defined(FreeRTOS) && defined(LOGGER_USE_EXTERNAL_THREAD)
+    // Stays 0 on host builds (mynd-sim), which run the interrupt handlers from a task
     uint32_t IPSR_register = 0U;
 
+#if defined(__arm__)
     __asm volatile("MRS %0, ipsr" : "=r"(IPSR_register));
+#endif
 
     if (0U == IPSR_register)
     {
@@ -96,7 +106,9 @@ void logger_internal_unlock(void)
 
     uint32_t IPSR_register = 0U;
 
+#if defined(__arm__)
     __asm volatile("MRS %0, ipsr" : "=r"(IPSR_register));
+#endif
 
     if (0U == IPSR_register)
     {
@@ -250,23 +262,66 @@ static void print_buffer(char *p_data, size_t length)
 
     uint32_t IPSR_register = 0U;
 
+#if defined(__arm__)
     __asm volatile("MRS %0, ipsr" : "=r"(IPSR_register));
+#endif
 
+    size_t sent = 0;
     if (xStreamBufferIsFull(sbuffer_logger_h) == pdFALSE)
     {
-        // We intentionally do not check what xStreamBufferSend functions return,
-        // because not much to do to handle the errors.
+        // Not much to do to handle the errors, what didn't fit is only counted
         if (0U == IPSR_register)
-            xStreamBufferSend(sbuffer_logger_h, p_data, length, pdMS_TO_TICKS(LOGGER_STREAM_BUFFER_TIMEOUT_MS));
+            sent = xStreamBufferSend(sbuffer_logger_h, p_data, length, pdMS_TO_TICKS(LOGGER_STREAM_BUFFER_TIMEOUT_MS));
         else
-            xStreamBufferSendFromISR(sbuffer_logger_h, p_data, length, NULL);
+            sent = xStreamBufferSendFromISR(sbuffer_logger_h, p_data, length, NULL);
     }
+
+    size_t      fill = xStreamBufferBytesAvailable(sbuffer_logger_h);
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    s_stats.dropped_bytes += length - sent;
+    if (fill > s_stats.peak_fill_bytes)
+    {
+        s_stats.peak_fill_bytes = fill;
+    }
+    taskEXIT_CRITICAL_FROM_ISR(mask);
 #else
     (void) length;
     printf("%s", p_data);
 #endif
 }
 
+#if LOGGER_OUTPUT_OPTION != LOGGER_OUTPUT_BINARY
+void logger_get_stats(logger_stats_t *p_stats)
+{
+#if defined(FreeRTOS) && defined(LOGGER_USE_EXTERNAL_THREAD)
+    taskENTER_CRITICAL();
+    p_stats->dropped_bytes   = s_stats.dropped_bytes;
+    p_stats->peak_fill_bytes = s_stats.peak_fill_bytes;
+    taskEXIT_CRITICAL();
+
+    // The stream buffer keeps no size, it is what is in it and what is left
+    p_stats->size_bytes = 0;
+    if (sbuffer_logger_h != NULL)
+    {
+        p_stats->size_bytes =
+            xStreamBufferBytesAvailable(sbuffer_logger_h) + xStreamBufferSpacesAvailable(sbuffer_logger_h);
+    }
+#else
+    *p_stats = (logger_stats_t) {0};
+#endif
+}
+
+void logger_reset_stats(void)
+{
+#if defined(FreeRTOS) && defined(LOGGER_USE_EXTERNAL_THREAD)
+    taskENTER_CRITICAL();
+    s_stats.dropped_bytes   = 0;
+    s_stats.peak_fill_bytes = 0;
+    taskEXIT_CRITICAL();
+#endif
+}
+#endif
+
 static void print_encoding_error(void)
 {
     printf("<encoding error>");
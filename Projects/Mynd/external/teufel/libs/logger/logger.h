@@ -48,6 +48,8 @@
 
 #if LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_RAW
 #include "outputs/logger_printf.h"
+#elif LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY
+#include "outputs/logger_binary.h"
 #else
 
 #if defined __cplusplus
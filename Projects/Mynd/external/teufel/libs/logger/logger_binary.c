@@ -0,0 +1,275 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "logger_config.h"
+#include "include/logger_impl.h"
+
+#if LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY
+
+#include "outputs/logger_binary.h"
+
+#if (LOGGER_BINARY_BUFFER_SIZE & (LOGGER_BINARY_BUFFER_SIZE - 1)) != 0 || LOGGER_BINARY_BUFFER_SIZE > 0x8000
+#error "Logger binary buffer size must be a power of two, at most 32 kB"
+#endif
+
+// Up to 253 bytes a record is a single COBS block
+#if LOGGER_BINARY_RECORD_SIZE < 16 || LOGGER_BINARY_RECORD_SIZE > 253
+#error "Logger binary record size must be within 16 and 253 bytes"
+#endif
+
+// The Cortex-M0 has no exclusive access instructions: the producers, which may be interrupts, reserve and copy their
+// record with the interrupts masked for a few microseconds. The single consumer needs no lock, it only advances the
+// tail after it has read the record.
+#if defined(FreeRTOS)
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define LOGGER_BINARY_LOCK()   UBaseType_t logger_binary_saved_mask = taskENTER_CRITICAL_FROM_ISR()
+#define LOGGER_BINARY_UNLOCK() taskEXIT_CRITICAL_FROM_ISR(logger_binary_saved_mask)
+#else
+#define LOGGER_BINARY_LOCK()
+#define LOGGER_BINARY_UNLOCK()
+#endif
+
+// Each record is stored with a length byte: varint descriptor address, varint timestamp, arguments
+static struct
+{
+    uint8_t           buffer[LOGGER_BINARY_BUFFER_SIZE];
+    volatile uint16_t head; // Free running, written by the producers
+    volatile uint16_t tail; // Free running, written by the consumer
+    volatile uint32_t dropped; // Records, reported in the output and reset by the consumer
+    logger_stats_t    stats;
+} s_ring;
+
+static size_t put_varint(uint8_t *p_record, size_t length, uint32_t value)
+{
+    while (value >= 0x80u)
+    {
+        p_record[length++] = (uint8_t) (value | 0x80u);
+        value >>= 7;
+    }
+    p_record[length++] = (uint8_t) value;
+    return length;
+}
+
+// Only for the 64 bit arguments, the Cortex-M0 needs register pairs and twice the instructions for them
+static size_t put_varint64(uint8_t *p_record, size_t length, uint64_t value)
+{
+    while (value >= 0x80u)
+    {
+        p_record[length++] = (uint8_t) (value | 0x80u);
+        value >>= 7;
+    }
+    p_record[length++] = (uint8_t) value;
+    return length;
+}
+
+static int ring_write(const uint8_t *p_record, size_t length)
+{
+    int written = 0;
+
+    LOGGER_BINARY_LOCK();
+    uint16_t head = s_ring.head;
+    if ((uint16_t) (head - s_ring.tail) <= LOGGER_BINARY_BUFFER_SIZE - length)
+    {
+        for (size_t i = 0; i < length; i++)
+        {
+            s_ring.buffer[(uint16_t) (head + i) & (LOGGER_BINARY_BUFFER_SIZE - 1u)] = p_record[i];
+        }
+        s_ring.head = (uint16_t) (head + length);
+        written     = 1;
+
+        uint16_t fill = (uint16_t) (s_ring.head - s_ring.tail);
+        if (fill > s_ring.stats.peak_fill_bytes)
+        {
+            s_ring.stats.peak_fill_bytes = fill;
+        }
+    }
+    else
+    {
+        s_ring.dropped++;
+        s_ring.stats.dropped_bytes += length;
+    }
+    LOGGER_BINARY_UNLOCK();
+
+    return written;
+}
+
+void logger_binary_log(uint32_t descriptor, uint32_t arg_types, uint32_t arg_count, ...)
+{
+    // Length byte, record and the largest argument which may not fit (a 64 bit varint)
+    uint8_t record[1u + LOGGER_BINARY_RECORD_SIZE + 10u];
+    size_t  length = 1u;
+
+    length = put_varint(record, length, descriptor);
+    length = put_varint(record, length, logger_get_timestamp());
+
+    va_list args;
+    va_start(args, arg_count);
+    for (uint32_t i = 0; i < arg_count && length <= LOGGER_BINARY_RECORD_SIZE; i++)
+    {
+        uint32_t arg_type = (arg_types >> (i * LOGGER_BINARY_ARG_BITS)) & LOGGER_BINARY_ARG_MASK;
+        size_t arg_start = length;
+
+        switch (arg_type)
+        {
+            case LOGGER_BINARY_ARG_WORD:
+                length = put_varint(record, length, va_arg(args, uint32_t));
+                break;
+
+            case LOGGER_BINARY_ARG_SWORD:
+            {
+                int32_t value = va_arg(args, int32_t);
+                length        = put_varint(record, length, ((uint32_t) value << 1) ^ (uint32_t) (value >> 31));
+                break;
+            }
+
+            case LOGGER_BINARY_ARG_DWORD:
+                length = put_varint64(record, length, va_arg(args, uint64_t));
+                break;
+
+            case LOGGER_BINARY_ARG_SDWORD:
+            {
+                int64_t value = va_arg(args, int64_t);
+                length        = put_varint64(record, length, ((uint64_t) value << 1) ^ (uint64_t) (value >> 63));
+                break;
+            }
+
+            case LOGGER_BINARY_ARG_STRING:
+            {
+                const char *p_string = va_arg(args, const char *);
+                if (p_string == NULL)
+                {
+                    p_string = "(null)";
+                }
+
+                // Truncated to the space left in the record
+                size_t string_length = strlen(p_string);
+                if (string_length > LOGGER_BINARY_MAX_STRING_LENGTH)
+                {
+                    string_length = LOGGER_BINARY_MAX_STRING_LENGTH;
+                }
+                if (string_length > LOGGER_BINARY_RECORD_SIZE - length)
+                {
+                    string_length = LOGGER_BINARY_RECORD_SIZE - length;
+                }
+
+                record[length++] = (uint8_t) string_length;
+                memcpy(&record[length], p_string, string_length);
+                length += string_length;
+                break;
+            }
+
+            default: // LOGGER_BINARY_ARG_DOUBLE
+            {
+                // Raw IEEE 754 bits, little endian on both the target and the host
+                double value = va_arg(args, double);
+                memcpy(&record[length], &value, sizeof(value));
+                length += sizeof(value);
+                break;
+            }
+        }
+
+        // The decoder prints the arguments which don't fit as missing
+        if (length > 1u + LOGGER_BINARY_RECORD_SIZE)
+        {
+            length = arg_start;
+            break;
+        }
+    }
+    va_end(args);
+
+    record[0] = (uint8_t) (length - 1u);
+    if (ring_write(record, length))
+    {
+        logger_binary_notify();
+    }
+}
+
+// Consistent Overhead Byte Stuffing: the frame contains no 0x00 but its end
+static size_t cobs_encode(const uint8_t *p_data, size_t length, uint8_t *p_frame)
+{
+    size_t  code_index = 0;
+    size_t  out        = 1;
+    uint8_t code       = 1;
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (p_data[i] == 0u)
+        {
+            p_frame[code_index] = code;
+            code_index          = out++;
+            code                = 1;
+        }
+        else
+        {
+            p_frame[out++] = p_data[i];
+            if (++code == 0xFFu)
+            {
+                p_frame[code_index] = code;
+                code_index          = out++;
+                code                = 1;
+            }
+        }
+    }
+    p_frame[code_index] = code;
+    p_frame[out++]      = 0u;
+
+    return out;
+}
+
+size_t logger_binary_read_frame(uint8_t *p_frame, size_t size)
+{
+    uint8_t record[LOGGER_BINARY_RECORD_SIZE];
+
+    if (size < LOGGER_BINARY_FRAME_SIZE)
+    {
+        return 0;
+    }
+
+    LOGGER_BINARY_LOCK();
+    uint32_t dropped = s_ring.dropped;
+    s_ring.dropped   = 0;
+    LOGGER_BINARY_UNLOCK();
+
+    if (dropped != 0u)
+    {
+        p_frame[0] = LOGGER_BINARY_FRAME_DROPPED;
+        return 1u + cobs_encode(record, put_varint(record, 0, dropped), &p_frame[1]);
+    }
+
+    uint16_t tail = s_ring.tail;
+    if (tail == s_ring.head)
+    {
+        return 0;
+    }
+
+    size_t length = s_ring.buffer[tail & (LOGGER_BINARY_BUFFER_SIZE - 1u)];
+    for (size_t i = 0; i < length; i++)
+    {
+        record[i] = s_ring.buffer[(uint16_t) (tail + 1u + i) & (LOGGER_BINARY_BUFFER_SIZE - 1u)];
+    }
+    s_ring.tail = (uint16_t) (tail + 1u + length);
+
+    p_frame[0] = LOGGER_BINARY_FRAME_RECORD;
+    return 1u + cobs_encode(record, length, &p_frame[1]);
+}
+
+void logger_get_stats(logger_stats_t *p_stats)
+{
+    LOGGER_BINARY_LOCK();
+    *p_stats = s_ring.stats;
+    LOGGER_BINARY_UNLOCK();
+
+    p_stats->size_bytes = LOGGER_BINARY_BUFFER_SIZE;
+}
+
+void logger_reset_stats(void)
+{
+    LOGGER_BINARY_LOCK();
+    s_ring.stats = (logger_stats_t) {0};
+    LOGGER_BINARY_UNLOCK();
+}
+
+#endif // LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY
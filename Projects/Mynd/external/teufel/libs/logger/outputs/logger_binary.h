@@ -0,0 +1,180 @@
+#pragma once
+
+// Binary output (LOGGER_OUTPUT_BINARY): a log call doesn't format anything on the target. It stores a compact record
+// (descriptor address, timestamp, raw arguments) in a RAM ring, the logger thread sends the records as frames and
+// tools/logger_decode.py formats them on the host from the ELF file.
+//
+// The descriptor of a log call (level, location, argument types and format string) is placed in its own
+// .logger_fmt.<n> section. The linker script collects them in the .logger_fmt INFO section, which stays in the ELF
+// file but isn't loaded: the format strings take no flash. Host builds link them as regular read-only data and must
+// not be position independent, the records only carry the low 32 bits of the descriptor address.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined __cplusplus
+#include <type_traits>
+#endif
+
+// Argument types, 3 bits per argument in the descriptor
+#define LOGGER_BINARY_ARG_WORD    0u // Unsigned integers, characters and pointers up to 32 bits
+#define LOGGER_BINARY_ARG_SWORD   1u // Signed integers up to 32 bits, zigzag encoded: small negative values stay short
+#define LOGGER_BINARY_ARG_DWORD   2u // 64 bit integers, and pointers on 64 bit hosts
+#define LOGGER_BINARY_ARG_SDWORD  3u
+#define LOGGER_BINARY_ARG_STRING  4u
+#define LOGGER_BINARY_ARG_DOUBLE  5u // float arguments are promoted to double
+#define LOGGER_BINARY_ARG_BITS    3u
+#define LOGGER_BINARY_ARG_MASK    0x7u
+
+// More arguments don't compile (LOGGER_BINARY_TYPES_<n> undefined)
+#define LOGGER_BINARY_MAX_ARGS 10
+
+// Set in the level of the descriptor for the log_*_raw() calls, which print no header and no new line
+#define LOGGER_BINARY_LEVEL_RAW 0x80
+
+// Frame start markers, 0xF8..0xFF never appear in UTF-8 text. The frame is the COBS encoded record and a 0x00.
+#define LOGGER_BINARY_FRAME_RECORD  0xF8u
+#define LOGGER_BINARY_FRAME_DROPPED 0xF9u // Varint count of the records dropped because the ring was full
+
+// Largest frame logger_binary_read_frame() returns
+#define LOGGER_BINARY_FRAME_SIZE (LOGGER_BINARY_RECORD_SIZE + 3u)
+
+typedef struct
+{
+    uint8_t  level; // logger_log_level_t, LOGGER_BINARY_LEVEL_RAW
+    uint8_t  arg_count;
+    uint16_t line;
+    uint32_t arg_types;
+    // Followed by the module name and the format string, each terminated by '\0'
+} logger_binary_descriptor_t;
+
+#if defined __cplusplus
+extern "C"
+{
+#endif
+
+    // Record of a log call, drops it when the ring is full. Safe from tasks and interrupts.
+    void logger_binary_log(uint32_t descriptor, uint32_t arg_types, uint32_t arg_count, ...);
+
+    // Next frame for the output, 0 when the ring is empty. Single consumer: the logger thread.
+    size_t logger_binary_read_frame(uint8_t *p_frame, size_t size);
+
+    // Called after a record was written, weak: the logger thread can wait for it instead of polling
+    void logger_binary_notify(void);
+
+#if defined __cplusplus
+}
+#endif
+
+// --------------------------------------------------------------------------
+// Argument types, resolved at compile time
+// --------------------------------------------------------------------------
+
+#if defined __cplusplus
+
+template <typename T>
+constexpr uint32_t logger_binary_arg_type()
+{
+    using U = std::decay_t<T>;
+
+    if constexpr (std::is_same_v<U, char *> || std::is_same_v<U, const char *>)
+        return LOGGER_BINARY_ARG_STRING;
+    else if constexpr (std::is_floating_point_v<U>)
+        return LOGGER_BINARY_ARG_DOUBLE;
+    else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>)
+        return sizeof(U) > 4u ? LOGGER_BINARY_ARG_SDWORD : LOGGER_BINARY_ARG_SWORD;
+    else
+        return sizeof(U) > 4u ? LOGGER_BINARY_ARG_DWORD : LOGGER_BINARY_ARG_WORD;
+}
+
+#define LOGGER_BINARY_ARG_TYPE(x) logger_binary_arg_type<decltype(x)>()
+
+#else
+
+// char, short and the unsigned types below 32 bits are promoted to int, only their values matter
+#define LOGGER_BINARY_ARG_TYPE(x)                                                                                      \
+    _Generic((x),                                                                                                      \
+        char *: LOGGER_BINARY_ARG_STRING,                                                                              \
+        const char *: LOGGER_BINARY_ARG_STRING,                                                                        \
+        float: LOGGER_BINARY_ARG_DOUBLE,                                                                               \
+        double: LOGGER_BINARY_ARG_DOUBLE,                                                                              \
+        char: LOGGER_BINARY_ARG_SWORD,                                                                                 \
+        signed char: LOGGER_BINARY_ARG_SWORD,                                                                          \
+        short: LOGGER_BINARY_ARG_SWORD,                                                                                \
+        int: LOGGER_BINARY_ARG_SWORD,                                                                                  \
+        long: (sizeof(long) > 4u ? LOGGER_BINARY_ARG_SDWORD : LOGGER_BINARY_ARG_SWORD),                                \
+        long long: LOGGER_BINARY_ARG_SDWORD,                                                                           \
+        default: (sizeof(x) > 4u ? LOGGER_BINARY_ARG_DWORD : LOGGER_BINARY_ARG_WORD))
+
+#endif
+
+#define LOGGER_BINARY_CAT_(a, b)    a##b
+#define LOGGER_BINARY_CAT(a, b)     LOGGER_BINARY_CAT_(a, b)
+#define LOGGER_BINARY_STRINGIFY_(x) #x
+#define LOGGER_BINARY_STRINGIFY(x)  LOGGER_BINARY_STRINGIFY_(x)
+
+// Number of arguments including the format string
+#define LOGGER_BINARY_COUNT(...) LOGGER_BINARY_COUNT_(__VA_ARGS__, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define LOGGER_BINARY_COUNT_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, n, ...) n
+
+#define LOGGER_BINARY_FORMAT(fmt, ...) fmt
+
+// The arguments after the format string, each preceded by a comma
+#define LOGGER_BINARY_ARGS(...) LOGGER_BINARY_CAT(LOGGER_BINARY_ARGS_, LOGGER_BINARY_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define LOGGER_BINARY_ARGS_1(fmt)
+#define LOGGER_BINARY_ARGS_N(fmt, ...) , __VA_ARGS__
+#define LOGGER_BINARY_ARGS_2           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_3           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_4           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_5           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_6           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_7           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_8           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_9           LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_10          LOGGER_BINARY_ARGS_N
+#define LOGGER_BINARY_ARGS_11          LOGGER_BINARY_ARGS_N
+
+// Types of the arguments after the format string, the first one in the lowest bits
+#define LOGGER_BINARY_TYPE(i, x) ((uint32_t) LOGGER_BINARY_ARG_TYPE(x) << (LOGGER_BINARY_ARG_BITS * (i)))
+#define LOGGER_BINARY_TYPES(...) LOGGER_BINARY_CAT(LOGGER_BINARY_TYPES_, LOGGER_BINARY_COUNT(__VA_ARGS__))(__VA_ARGS__)
+#define LOGGER_BINARY_TYPES_1(f) 0u
+#define LOGGER_BINARY_TYPES_2(f, a) LOGGER_BINARY_TYPES_1(f) | LOGGER_BINARY_TYPE(0, a)
+#define LOGGER_BINARY_TYPES_3(f, a, b) LOGGER_BINARY_TYPES_2(f, a) | LOGGER_BINARY_TYPE(1, b)
+#define LOGGER_BINARY_TYPES_4(f, a, b, c) LOGGER_BINARY_TYPES_3(f, a, b) | LOGGER_BINARY_TYPE(2, c)
+#define LOGGER_BINARY_TYPES_5(f, a, b, c, d) LOGGER_BINARY_TYPES_4(f, a, b, c) | LOGGER_BINARY_TYPE(3, d)
+#define LOGGER_BINARY_TYPES_6(f, a, b, c, d, e) LOGGER_BINARY_TYPES_5(f, a, b, c, d) | LOGGER_BINARY_TYPE(4, e)
+#define LOGGER_BINARY_TYPES_7(f, a, b, c, d, e, g) LOGGER_BINARY_TYPES_6(f, a, b, c, d, e) | LOGGER_BINARY_TYPE(5, g)
+#define LOGGER_BINARY_TYPES_8(f, a, b, c, d, e, g, h)                                                                  \
+    LOGGER_BINARY_TYPES_7(f, a, b, c, d, e, g) | LOGGER_BINARY_TYPE(6, h)
+#define LOGGER_BINARY_TYPES_9(f, a, b, c, d, e, g, h, i)                                                               \
+    LOGGER_BINARY_TYPES_8(f, a, b, c, d, e, g, h) | LOGGER_BINARY_TYPE(7, i)
+#define LOGGER_BINARY_TYPES_10(f, a, b, c, d, e, g, h, i, j)                                                           \
+    LOGGER_BINARY_TYPES_9(f, a, b, c, d, e, g, h, i) | LOGGER_BINARY_TYPE(8, j)
+#define LOGGER_BINARY_TYPES_11(f, a, b, c, d, e, g, h, i, j, k)                                                        \
+    LOGGER_BINARY_TYPES_10(f, a, b, c, d, e, g, h, i, j) | LOGGER_BINARY_TYPE(9, k)
+
+#define LOGGER_BINARY_SECTION(n) __attribute__((section(".logger_fmt." LOGGER_BINARY_STRINGIFY(n)), used))
+
+// --------------------------------------------------------------------------
+// Log macros
+// --------------------------------------------------------------------------
+
+#define log_internal_binary(level, ...)                                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        if (LOG_LEVEL >= ((level) & ~LOGGER_BINARY_LEVEL_RAW))                                                         \
+        {                                                                                                              \
+            static const struct                                                                                       \
+            {                                                                                                          \
+                logger_binary_descriptor_t descriptor;                                                                 \
+                char strings[sizeof(LOG_MODULE_NAME) + sizeof(LOGGER_BINARY_FORMAT(__VA_ARGS__))];                     \
+            } logger_binary_entry LOGGER_BINARY_SECTION(__COUNTER__) = {                                               \
+                {(uint8_t) (level), LOGGER_BINARY_COUNT(__VA_ARGS__) - 1u, __LINE__, LOGGER_BINARY_TYPES(__VA_ARGS__)},\
+                LOG_MODULE_NAME "\0" LOGGER_BINARY_FORMAT(__VA_ARGS__)};                                               \
+            logger_binary_log((uint32_t) (uintptr_t) &logger_binary_entry, LOGGER_BINARY_TYPES(__VA_ARGS__),           \
+                              LOGGER_BINARY_COUNT(__VA_ARGS__) - 1u LOGGER_BINARY_ARGS(__VA_ARGS__));                  \
+        }                                                                                                              \
+    } while (0)
+
+#define log_internal(level, ...)     log_internal_binary(level, __VA_ARGS__)
+#define log_internal_raw(level, ...) log_internal_binary((level) | LOGGER_BINARY_LEVEL_RAW, __VA_ARGS__)
@@ -0,0 +1,324 @@
+#define LOG_MODULE_NAME "logger_binary_test.cpp"
+#define LOG_LEVEL       LOG_LEVEL_TRACE
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include "logger.h"
+
+// The records are decoded with the descriptors of this executable, by the same script as the firmware logs
+#ifndef LOGGER_DECODE_SCRIPT
+#error "LOGGER_DECODE_SCRIPT must be the path of tools/logger_decode.py"
+#endif
+
+using Bytes = std::vector<uint8_t>;
+
+static uint32_t s_timestamp;
+
+extern "C"
+{
+    uint32_t logger_get_timestamp()
+    {
+        return s_timestamp;
+    }
+
+    size_t logger_binary_test_log_from_c(char *p_expected, size_t size);
+}
+
+static std::string format(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static std::string format(const char *fmt, ...)
+{
+    char    buffer[256];
+    va_list args;
+
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+
+    return buffer;
+}
+
+// Header of the formatted output (configs/num2, formats/num1) as printed by logger.c
+static std::string format_header(uint32_t timestamp, const char *level, const char *module, unsigned line)
+{
+    std::string header   = format("T%08u: [%-5s] ", timestamp, level);
+    std::string location = format("%s:", module);
+    return header + location + format("%-*u ", LOGGER_LOG_LOCATION_WIDTH - static_cast<int>(location.size()), line);
+}
+
+static Bytes read_frames()
+{
+    Bytes   stream;
+    uint8_t frame[LOGGER_BINARY_FRAME_SIZE];
+
+    while (size_t length = logger_binary_read_frame(frame, sizeof(frame)))
+    {
+        stream.insert(stream.end(), frame, frame + length);
+    }
+    return stream;
+}
+
+static std::string decode(const Bytes &stream, bool message_only = true)
+{
+    char path[] = "/tmp/logger_binary_test_XXXXXX";
+    int  fd     = mkstemp(path);
+    EXPECT_GE(fd, 0);
+
+    FILE *p_file = fdopen(fd, "wb");
+    fwrite(stream.data(), 1, stream.size(), p_file);
+    fclose(p_file);
+
+    char    exe[4096];
+    ssize_t exe_length = readlink("/proc/self/exe", exe, sizeof(exe) - 1);
+    EXPECT_GT(exe_length, 0);
+    exe[exe_length > 0 ? exe_length : 0] = '\0';
+
+    std::string command = format("python3 '%s' %s '%s' '%s'", LOGGER_DECODE_SCRIPT,
+                                 message_only ? "--message-only" : "", exe, path);
+
+    std::string output;
+    FILE       *p_pipe = popen(command.c_str(), "r");
+    char        buffer[256];
+    while (size_t length = fread(buffer, 1, sizeof(buffer), p_pipe))
+    {
+        output.append(buffer, length);
+    }
+    EXPECT_EQ(pclose(p_pipe), 0);
+
+    remove(path);
+    return output;
+}
+
+static std::vector<std::string> split_lines(const std::string &text)
+{
+    std::vector<std::string> lines;
+    size_t                   start = 0;
+    size_t                   end;
+
+    while ((end = text.find('\n', start)) != std::string::npos)
+    {
+        std::string line = text.substr(start, end - start);
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        lines.push_back(line);
+        start = end + 1;
+    }
+    return lines;
+}
+
+class LoggerBinary : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        s_timestamp = 0;
+        read_frames();
+        logger_reset_stats();
+    }
+};
+
+#define LOG_EXPECT(...)                                                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        log_info(__VA_ARGS__);                                                                                         \
+        expected.push_back(format(__VA_ARGS__));                                                                       \
+    } while (0)
+
+TEST_F(LoggerBinary, RoundTripMatchesPrintf)
+{
+    std::vector<std::string> expected;
+    Bytes                    stream;
+
+    enum class Source
+    {
+        Bluetooth = 2,
+    };
+
+    const std::string name    = "Mynd";
+    const char        label[] = "battery";
+    int               value   = 1234;
+    unsigned long     big     = 4000000000ul;
+    double            level   = 87.25;
+
+    LOG_EXPECT("no arguments");
+    LOG_EXPECT("%s: %d%%", name.c_str(), -42);
+    LOG_EXPECT("%s level %.2f %%, raw %5d, hex 0x%08lX", label, level, value, big);
+    LOG_EXPECT("source %d, ptr %p", static_cast<int>(Source::Bluetooth), static_cast<void *>(&value));
+    LOG_EXPECT("[%-8s] [%8s] [%.3s]", "left", "right", "truncated");
+    LOG_EXPECT("width %*d, precision %.*s", 6, 7, 2, "abc");
+    LOG_EXPECT("signed char %hhd, short %hd, negative %ld", 300, 70000, -5l);
+    LOG_EXPECT("exp %e, general %g", 12345.678, 0.0001);
+    LOG_EXPECT("%d %d %d %d %d %d %d %d %d %d", 1, -2, 3, -4, 5, -6, 7, -8, 9, -10);
+    LOG_EXPECT("int64 %lld, uint64 %llu, uint32 %u", -9000000000ll, 18000000000000000000ull, 4294967295u);
+
+    log_info_raw("raw %d\r\n", 5);
+    expected.push_back("raw 5");
+
+    // Shell output between the frames is passed through
+    stream = read_frames();
+    const std::string shell = "shell> status\r\nok\r\n";
+    stream.insert(stream.end(), shell.begin(), shell.end());
+    expected.push_back("shell> status");
+    expected.push_back("ok");
+
+    char   c_expected[512];
+    size_t length = logger_binary_test_log_from_c(c_expected, sizeof(c_expected));
+    for (const auto &line : split_lines(std::string(c_expected, length)))
+    {
+        expected.push_back(line);
+    }
+
+    Bytes c_stream = read_frames();
+    stream.insert(stream.end(), c_stream.begin(), c_stream.end());
+
+    EXPECT_EQ(split_lines(decode(stream)), expected);
+}
+
+TEST_F(LoggerBinary, HeaderMatchesTheFormattedOutput)
+{
+    s_timestamp         = 1234567;
+    const unsigned line = __LINE__ + 1;
+    log_warning("charger %s", "fault");
+
+    std::string expected = format_header(s_timestamp, "WARN", LOG_MODULE_NAME, line) + "charger fault\r\n";
+    EXPECT_EQ(decode(read_frames(), false), expected);
+}
+
+TEST_F(LoggerBinary, DroppedRecordsAreReported)
+{
+    // More records than the ring can take, the first ones stay
+    const unsigned calls = LOGGER_BINARY_BUFFER_SIZE;
+    for (unsigned i = 0; i < calls; i++)
+    {
+        log_debug("tick %u", i);
+    }
+
+    auto lines = split_lines(decode(read_frames()));
+    ASSERT_GE(lines.size(), 2u);
+
+    unsigned dropped = 0;
+    ASSERT_EQ(std::sscanf(lines.front().c_str(), "<%u log records dropped>", &dropped), 1) << lines.front();
+    EXPECT_EQ(dropped + lines.size() - 1, calls);
+    EXPECT_EQ(lines[1], "tick 0");
+    EXPECT_EQ(lines.back(), format("tick %u", calls - dropped - 1));
+
+    // The ring was filled up to less than a record
+    logger_stats_t stats;
+    logger_get_stats(&stats);
+    EXPECT_EQ(stats.size_bytes, size_t{LOGGER_BINARY_BUFFER_SIZE});
+    EXPECT_GT(stats.dropped_bytes, dropped);
+    EXPECT_LE(stats.peak_fill_bytes, stats.size_bytes);
+    EXPECT_GT(stats.peak_fill_bytes + LOGGER_BINARY_RECORD_SIZE, stats.size_bytes);
+}
+
+TEST_F(LoggerBinary, ArgumentsWhichDontFitAreMissing)
+{
+    const std::string text(40, 'a');
+
+    log_info("%s|%s|%s|%d", text.c_str(), text.c_str(), text.c_str(), 5);
+
+    // Strings are truncated to LOGGER_BINARY_MAX_STRING_LENGTH, the second one to the end of the record
+    auto lines = split_lines(decode(read_frames()));
+    ASSERT_EQ(lines.size(), 1u);
+
+    const std::string first(LOGGER_BINARY_MAX_STRING_LENGTH, 'a');
+    EXPECT_EQ(lines[0].substr(0, first.size() + 1), first + "|");
+    EXPECT_NE(lines[0].find("|<missing>|<missing>"), std::string::npos) << lines[0];
+    EXPECT_LE(lines[0].size(), LOGGER_BINARY_RECORD_SIZE + 2 * strlen("|<missing>"));
+}
+
+// The formatted output of a log as logger.c prints it, without the colors
+static size_t print_formatted(char *p_buffer, size_t size, unsigned line, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static size_t print_formatted(char *p_buffer, size_t size, unsigned line, const char *fmt, ...)
+{
+    va_list args;
+    int     length = snprintf(p_buffer, size, "T%08u: ", s_timestamp);
+    length += snprintf(&p_buffer[length], size - length, "[%-5s] ", "INFO");
+
+    int location = snprintf(&p_buffer[length], size - length, "%s:", LOG_MODULE_NAME);
+    length += location;
+    length += snprintf(&p_buffer[length], size - length, "%-*u ", LOGGER_LOG_LOCATION_WIDTH - location, line);
+
+    va_start(args, fmt);
+    length += vsnprintf(&p_buffer[length], size - length, fmt, args);
+    va_end(args);
+
+    length += snprintf(&p_buffer[length], size - length, "%s", LOGGER_NEW_LINE_STRING);
+    return static_cast<size_t>(length);
+}
+
+static size_t drain_frames()
+{
+    uint8_t frame[LOGGER_BINARY_FRAME_SIZE];
+    size_t  bytes = 0;
+
+    while (size_t length = logger_binary_read_frame(frame, sizeof(frame)))
+    {
+        bytes += length;
+    }
+    return bytes;
+}
+
+// Typical logs of the firmware, most have no or one argument: bytes on the UART and time per log against the
+// formatted output. The time of the binary output includes the framing by the logger thread.
+TEST_F(LoggerBinary, CostAgainstTheFormattedOutput)
+{
+    constexpr unsigned c_rounds  = 10000;
+    constexpr unsigned c_logs    = 4;
+    uint32_t           voltage   = 3712;
+    int                current   = -250;
+    int                volume    = 17;
+    const char        *p_powered = "on";
+    char               buffer[256];
+
+    size_t formatted_bytes = 0;
+    size_t binary_bytes    = 0;
+
+    const auto start_formatted = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < c_rounds; i++)
+    {
+        s_timestamp = i * 100u;
+        formatted_bytes += print_formatted(buffer, sizeof(buffer), __LINE__, "Entering the pseudo-off state");
+        formatted_bytes += print_formatted(buffer, sizeof(buffer), __LINE__, "Battery %u mV, %d mA", voltage, current);
+        formatted_bytes += print_formatted(buffer, sizeof(buffer), __LINE__, "Volume %d", volume);
+        formatted_bytes += print_formatted(buffer, sizeof(buffer), __LINE__, "Bluetooth powered %s", p_powered);
+    }
+    const auto formatted_time = std::chrono::steady_clock::now() - start_formatted;
+
+    const auto start_binary = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < c_rounds; i++)
+    {
+        s_timestamp = i * 100u;
+        log_info("Entering the pseudo-off state");
+        log_info("Battery %u mV, %d mA", voltage, current);
+        log_info("Volume %d", volume);
+        log_info("Bluetooth powered %s", p_powered);
+        binary_bytes += drain_frames();
+    }
+    const auto binary_time = std::chrono::steady_clock::now() - start_binary;
+
+    const auto ns_per_log = [](auto duration)
+    {
+        auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+        return static_cast<long long>(ns / (c_rounds * c_logs));
+    };
+
+    std::printf("%-10s %10s %10s\n", "output", "bytes/log", "ns/log");
+    std::printf("%-10s %10zu %10lld\n", "formatted", formatted_bytes / (c_rounds * c_logs), ns_per_log(formatted_time));
+    std::printf("%-10s %10zu %10lld\n", "binary", binary_bytes / (c_rounds * c_logs), ns_per_log(binary_time));
+
+    EXPECT_LE(binary_bytes * 5, formatted_bytes);
+}
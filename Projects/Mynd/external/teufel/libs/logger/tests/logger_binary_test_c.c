@@ -0,0 +1,39 @@
+// Log calls from C: the argument types come from _Generic instead of the C++ templates
+#define LOG_MODULE_NAME "logger_binary_test_c"
+#define LOG_LEVEL       LOG_LEVEL_TRACE
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "logger.h"
+
+#define LOG_EXPECT(...)                                                                                                \
+    do                                                                                                                 \
+    {                                                                                                                  \
+        log_info(__VA_ARGS__);                                                                                         \
+        length += snprintf(&p_expected[length], size - length, __VA_ARGS__);                                           \
+        length += snprintf(&p_expected[length], size - length, "\n");                                                  \
+    } while (0)
+
+// Logs from C, the expected messages are written to p_expected, one per line
+size_t logger_binary_test_log_from_c(char *p_expected, size_t size)
+{
+    size_t      length  = 0;
+    char        name[]  = "eeprom";
+    const char *p_state = "ready";
+    int8_t      offset  = -3;
+    uint16_t    voltage = 4200;
+    uint64_t    uptime  = 123456789012ull;
+    float       gain    = -6.5f;
+    int         on      = 1;
+
+    LOG_EXPECT("no arguments");
+    LOG_EXPECT("%s is %s", name, p_state);
+    LOG_EXPECT("Bluetooth powered %s", on ? "on" : "off");
+    LOG_EXPECT("offset %d, voltage %u mV, register 0x%02X", offset, voltage, 0xA5u);
+    LOG_EXPECT("uptime %llu us", (unsigned long long) uptime);
+    LOG_EXPECT("gain %.1f dB", gain);
+    LOG_EXPECT("char '%c', percent %%", 'x');
+
+    return length;
+}
@@ -0,0 +1,368 @@
+#!/usr/bin/env python3
+"""
+Decodes the output of the binary logger (LOGGER_OUTPUT_BINARY, see outputs/logger_binary.h).
+
+The target sends each log as a frame: a start marker, the COBS encoded record and a 0x00. The record holds the
+address of the descriptor of the log call, the timestamp and the raw arguments. The descriptors (level, location,
+argument types and format string) are read from the ELF file of the firmware, the logs are printed as the formatted
+output would have printed them. Anything outside of the frames (shell output, printf) is passed through.
+
+    logger_decode.py build/mynd-offset.elf /dev/ttyUSB0 --baudrate 115200
+    logger_decode.py build/mynd-offset.elf capture.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FRAME_RECORD = 0xF8
+FRAME_DROPPED = 0xF9
+
+ARG_WORD = 0
+ARG_SWORD = 1  # Zigzag encoded
+ARG_DWORD = 2
+ARG_SDWORD = 3  # Zigzag encoded
+ARG_STRING = 4
+ARG_DOUBLE = 5
+ARG_BITS = 3
+INTEGERS = (ARG_WORD, ARG_SWORD, ARG_DWORD, ARG_SDWORD)
+
+LEVEL_RAW = 0x80
+LEVEL_NAMES = ["OFF", "FATAL", "ERROR", "WARN", "HIGH", "INFO", "DEBUG", "TRACE"]
+
+LOCATION_WIDTH = 30  # LOGGER_LOG_LOCATION_WIDTH of formats/num1
+NEW_LINE = "\r\n"
+
+SECTION_PREFIX = ".logger_fmt"
+SHF_ALLOC = 0x2
+SHT_NOBITS = 8
+
+CONVERSION = re.compile(
+    r"%(?P<flags>[-+ #0]*)(?P<width>\*|\d+)?(?:\.(?P<precision>\*|\d*))?"
+    r"(?P<length>hh|h|ll|l|j|z|t|L)?(?P<conversion>[diouxXcsfFeEgGaAp%])"
+)
+
+
+class Descriptor:
+    def __init__(self, level, arg_count, line, arg_types, module, fmt):
+        self.level = level
+        self.arg_count = arg_count
+        self.line = line
+        self.arg_types = [(arg_types >> (ARG_BITS * i)) & ((1 << ARG_BITS) - 1) for i in range(arg_count)]
+        self.module = module
+        self.fmt = fmt
+
+
+class Elf:
+    """The sections of an ELF file, just what it takes to read the descriptors."""
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self.data = f.read()
+
+        if self.data[:4] != b"\x7fELF":
+            raise ValueError(f"{path} is not an ELF file")
+
+        self.is_64_bit = self.data[4] == 2
+        self.endian = "<" if self.data[5] == 1 else ">"
+
+        if self.is_64_bit:
+            shoff, = struct.unpack_from(self.endian + "Q", self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(self.endian + "HHH", self.data, 0x3A)
+            header = "IIQQQQIIQQ"
+        else:
+            shoff, = struct.unpack_from(self.endian + "I", self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(self.endian + "HHH", self.data, 0x2E)
+            header = "IIIIIIIIII"
+
+        headers = [struct.unpack_from(self.endian + header, self.data, shoff + i * shentsize) for i in range(shnum)]
+        names_offset = headers[shstrndx][4]
+
+        self.sections = []
+        for name, sh_type, flags, addr, offset, size, *_ in headers:
+            self.sections.append(
+                {
+                    "name": self.c_string(names_offset + name),
+                    "type": sh_type,
+                    "flags": flags,
+                    "addr": addr,
+                    "offset": offset,
+                    "size": size,
+                }
+            )
+
+        # The descriptor sections, all at address 0 in the firmware (not loaded), and the loaded ones on the host
+        self.descriptor_sections = [s for s in self.sections if s["name"].startswith(SECTION_PREFIX)]
+        self.loaded_sections = [s for s in self.sections if s["flags"] & SHF_ALLOC and s["type"] != SHT_NOBITS]
+        self.descriptors = {}
+
+    def c_string(self, offset):
+        end = self.data.index(b"\0", offset)
+        return self.data[offset:end].decode("utf-8", errors="replace")
+
+    def file_offset(self, address):
+        for sections in (self.descriptor_sections, self.loaded_sections):
+            for section in sections:
+                # The records only hold the low 32 bits of the address
+                start = section["addr"] & 0xFFFFFFFF
+                if start <= address < start + section["size"]:
+                    return section["offset"] + address - start
+        return None
+
+    def descriptor(self, address):
+        if address not in self.descriptors:
+            offset = self.file_offset(address)
+            if offset is None:
+                return None
+
+            level, arg_count, line, arg_types = struct.unpack_from(self.endian + "BBHI", self.data, offset)
+            module = self.c_string(offset + 8)
+            fmt = self.c_string(offset + 8 + len(module.encode("utf-8")) + 1)
+            self.descriptors[address] = Descriptor(level, arg_count, line, arg_types, module, fmt)
+
+        return self.descriptors[address]
+
+
+def cobs_decode(data):
+    out = bytearray()
+    index = 0
+    while index < len(data):
+        code = data[index]
+        if code == 0 or index + code > len(data):
+            raise ValueError("invalid COBS frame")
+        out += data[index + 1 : index + code]
+        index += code
+        if code < 0xFF and index < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def read_varint(data, index):
+    value = 0
+    shift = 0
+    while True:
+        if index >= len(data):
+            raise ValueError("truncated varint")
+        byte = data[index]
+        index += 1
+        value |= (byte & 0x7F) << shift
+        shift += 7
+        if byte < 0x80:
+            return value, index
+
+
+def read_args(descriptor, data, index):
+    """Arguments of the record, (type, value), None for the ones which didn't fit into the record."""
+    args = []
+    for arg_type in descriptor.arg_types:
+        if index >= len(data):
+            args.append(None)
+            continue
+
+        if arg_type in INTEGERS:
+            value, index = read_varint(data, index)
+            if arg_type in (ARG_SWORD, ARG_SDWORD):
+                value = (value >> 1) ^ -(value & 1)
+        elif arg_type == ARG_STRING:
+            length = data[index]
+            value = data[index + 1 : index + 1 + length].decode("utf-8", errors="replace")
+            index += 1 + length
+        else:
+            value, = struct.unpack_from("<d", data, index)
+            index += 8
+        args.append((arg_type, value))
+    return args
+
+
+def to_signed(value, bits):
+    value &= (1 << bits) - 1
+    return value - (1 << bits) if value & (1 << (bits - 1)) else value
+
+
+def integer_bits(arg_type, length):
+    if length == "hh":
+        return 8
+    if length == "h":
+        return 16
+    return 64 if arg_type in (ARG_DWORD, ARG_SDWORD) else 32
+
+
+def format_printf(fmt, args):
+    """Formats the arguments as printf() would, with Python's % operator."""
+    args = list(args)
+    out = []
+    position = 0
+
+    def next_arg():
+        return args.pop(0) if args else None
+
+    def next_int():
+        arg = next_arg()
+        if arg is None or arg[0] not in INTEGERS:
+            return None
+        return to_signed(arg[1], integer_bits(arg[0], None))
+
+    for match in CONVERSION.finditer(fmt):
+        out.append(fmt[position : match.start()])
+        position = match.end()
+
+        conversion = match.group("conversion")
+        if conversion == "%":
+            out.append("%")
+            continue
+
+        flags = match.group("flags")
+        width = match.group("width") or ""
+        precision = match.group("precision")
+
+        if width == "*":
+            width = next_int()
+            if width is None:
+                out.append("<missing>")
+                continue
+            if width < 0:
+                flags += "-"
+                width = -width
+            width = str(width)
+
+        if precision == "*":
+            precision = next_int()
+            precision = "" if precision is None or precision < 0 else str(precision)
+
+        spec = "%" + flags + width + ("." + precision if precision is not None else "")
+        arg = next_arg()
+        if arg is None:
+            out.append("<missing>")
+            continue
+
+        arg_type, value = arg
+        length = match.group("length")
+
+        if conversion in "di":
+            if arg_type not in INTEGERS:
+                out.append("<?>")
+                continue
+            out.append((spec + "d") % to_signed(value, integer_bits(arg_type, length)))
+        elif conversion in "ouxX":
+            if arg_type not in INTEGERS:
+                out.append("<?>")
+                continue
+            value &= (1 << integer_bits(arg_type, length)) - 1
+            out.append((spec + ("d" if conversion == "u" else conversion)) % value)
+        elif conversion == "p":
+            out.append((spec + "#x") % value if arg_type in INTEGERS else "<?>")
+        elif conversion == "c":
+            out.append((spec.split(".")[0] + "s") % chr(value & 0xFF) if arg_type in INTEGERS else "<?>")
+        elif conversion == "s":
+            out.append((spec + "s") % value if arg_type == ARG_STRING else "<?>")
+        elif conversion in "aA":
+            text = float(value).hex() if arg_type == ARG_DOUBLE else "<?>"
+            out.append(text.upper() if conversion == "A" else text)
+        else:
+            out.append((spec + conversion) % value if arg_type == ARG_DOUBLE else "<?>")
+
+    out.append(fmt[position:])
+    return "".join(out)
+
+
+class Decoder:
+    def __init__(self, elf, message_only=False):
+        self.elf = elf
+        self.message_only = message_only
+
+    def decode_frame(self, marker, frame):
+        """Text of one frame, as the formatted output would have printed it."""
+        data = cobs_decode(frame)
+
+        if marker == FRAME_DROPPED:
+            count, _ = read_varint(data, 0)
+            return f"<{count} log records dropped>{NEW_LINE}"
+
+        address, index = read_varint(data, 0)
+        timestamp, index = read_varint(data, index)
+
+        descriptor = self.elf.descriptor(address)
+        if descriptor is None:
+            return f"<unknown log descriptor 0x{address:08x}, wrong ELF file?>{NEW_LINE}"
+
+        message = format_printf(descriptor.fmt, read_args(descriptor, data, index))
+        if descriptor.level & LEVEL_RAW:
+            return message
+        if self.message_only:
+            return message + NEW_LINE
+
+        level = LEVEL_NAMES[descriptor.level] if descriptor.level < len(LEVEL_NAMES) else "?"
+        location = f"{descriptor.module}:"
+        location += str(descriptor.line).ljust(LOCATION_WIDTH - len(location))
+        return f"T{timestamp:08d}: [{level:<5}] {location} {message}{NEW_LINE}"
+
+    def decode(self, chunks):
+        """Decoded text of a stream of bytes, chunk by chunk."""
+        marker = None
+        frame = bytearray()
+
+        for chunk in chunks:
+            text = bytearray()
+            out = []
+            for byte in chunk:
+                if marker is None:
+                    if byte in (FRAME_RECORD, FRAME_DROPPED):
+                        marker = byte
+                        frame.clear()
+                    else:
+                        text.append(byte)
+                elif byte == 0:
+                    out.append(text.decode("utf-8", errors="replace"))
+                    text.clear()
+                    try:
+                        out.append(self.decode_frame(marker, bytes(frame)))
+                    except (ValueError, IndexError, struct.error) as error:
+                        out.append(f"<corrupted log frame: {error}>{NEW_LINE}")
+                    marker = None
+                else:
+                    frame.append(byte)
+
+            out.append(text.decode("utf-8", errors="replace"))
+            yield "".join(out)
+
+
+def read_chunks(args):
+    if args.baudrate:
+        import serial  # pyserial, only needed to read from a serial port
+
+        with serial.Serial(args.input, args.baudrate, timeout=0.1) as port:
+            while True:
+                chunk = port.read(256)
+                if chunk:
+                    yield chunk
+    else:
+        with (sys.stdin.buffer if args.input == "-" else open(args.input, "rb")) as f:
+            while True:
+                chunk = f.read1(4096) if hasattr(f, "read1") else f.read(4096)
+                if not chunk:
+                    return
+                yield chunk
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode the output of the binary logger")
+    parser.add_argument("elf", help="ELF file of the firmware which sent the logs")
+    parser.add_argument("input", nargs="?", default="-", help="captured output or serial port, stdin by default")
+    parser.add_argument("-b", "--baudrate", type=int, help="read from a serial port at this baud rate")
+    parser.add_argument(
+        "--message-only", action="store_true", help="print the logs without the timestamp, level and location"
+    )
+    args = parser.parse_args()
+
+    decoder = Decoder(Elf(args.elf), args.message_only)
+    try:
+        for text in decoder.decode(read_chunks(args)):
+            sys.stdout.write(text)
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()
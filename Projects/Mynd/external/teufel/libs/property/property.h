@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <optional>
@@ -27,6 +29,157 @@ struct PropertyMutex
 // Initialize the mutex with a default value
 inline IMutex *PropertyMutex::mutex = nullptr;
 
+/**
+ * Sequence lock of the scalar (bool, arithmetic and enum) properties: they are read without taking the property
+ * mutex. Writers are serialised by the mutex and increment the version before and after they update a value, so the
+ * version is odd while a write is in progress. A reader copies the value and starts again if the version changed in
+ * the meantime.
+ *
+ * On a single core, a reader which finds an odd version has preempted the writer, which can't finish before the
+ * reader blocks. Such a reader takes the mutex instead, so the writer inherits its priority and completes the write.
+ *
+ * The version is shared by all properties, so a read of several properties within one read() is coherent (see
+ * getPropertySnapshot()), and so is a write of several properties within one write(): nested writes don't change the
+ * version. Only loads, stores and fences are used, which the Cortex-M0 supports without a library.
+ */
+struct PropertySeqLock
+{
+    static std::atomic<uint32_t> version;
+    static uint32_t              mutex_reads; // Reads which found a write in progress, updated with the mutex taken
+    static uint8_t               write_depth; // Nesting of write(), updated with the mutex taken
+
+    template <typename F>
+    static void write(F &&fn)
+    {
+        if (PropertyMutex::mutex)
+            PropertyMutex::mutex->lock();
+
+        auto v = version.load(std::memory_order_relaxed);
+        if (write_depth++ == 0)
+        {
+            version.store(v + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        fn();
+
+        if (--write_depth == 0)
+        {
+            std::atomic_thread_fence(std::memory_order_release);
+            version.store(v + 2, std::memory_order_relaxed);
+        }
+
+        if (PropertyMutex::mutex)
+            PropertyMutex::mutex->unlock();
+    }
+
+    template <typename F>
+    static auto read(F &&fn)
+    {
+        // A writer completing between the two loads makes the read start again, a writer preempted in the middle of
+        // its update makes it take the mutex
+        for (uint8_t attempt = 0; attempt < 2; attempt++)
+        {
+            auto v = version.load(std::memory_order_acquire);
+            if (v & 1u)
+                break;
+
+            auto value = fn();
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (version.load(std::memory_order_relaxed) == v)
+                return value;
+        }
+
+        if (PropertyMutex::mutex)
+            PropertyMutex::mutex->lock();
+
+        mutex_reads++;
+        auto value = fn();
+
+        if (PropertyMutex::mutex)
+            PropertyMutex::mutex->unlock();
+
+        return value;
+    }
+};
+
+inline std::atomic<uint32_t> PropertySeqLock::version     = 0;
+inline uint32_t              PropertySeqLock::mutex_reads = 0;
+inline uint8_t               PropertySeqLock::write_depth = 0;
+
+class PropertyTopic;
+
+/**
+ * Subscriber of the changes of a property. Subscribers are static objects which add themselves to their topic when
+ * they are constructed (before the scheduler starts) and are never removed, so a topic needs no heap and no lock.
+ *
+ * The callback runs in the task which changed the property, with no property lock held: it should only record that
+ * there is work to do (e.g. set a flag checked by the subscriber's task).
+ */
+class PropertySubscriber : public Teufel::Core::Uncopyable
+{
+  public:
+    PropertySubscriber(PropertyTopic &topic, void (*on_change)());
+
+  private:
+    friend class PropertyTopic;
+
+    void (*m_on_change)();
+    PropertySubscriber *m_p_next = nullptr;
+};
+
+/**
+ * List of the subscribers of a property. A topic must be constant-initialized (constinit) so that the subscribers of
+ * other translation units can be added to it during their static initialization.
+ */
+class PropertyTopic : public Teufel::Core::Uncopyable
+{
+  public:
+    constexpr PropertyTopic() = default;
+
+    void subscribe(PropertySubscriber &subscriber)
+    {
+        subscriber.m_p_next = m_p_head;
+        m_p_head            = &subscriber;
+    }
+
+    void publish() const
+    {
+        for (auto *p_subscriber = m_p_head; p_subscriber != nullptr; p_subscriber = p_subscriber->m_p_next)
+            p_subscriber->m_on_change();
+    }
+
+  private:
+    PropertySubscriber *m_p_head = nullptr;
+};
+
+inline PropertySubscriber::PropertySubscriber(PropertyTopic &topic, void (*on_change)())
+  : m_on_change(on_change)
+{
+    topic.subscribe(*this);
+}
+
+// Publishes the changes of a property to the subscribers of its topic, if it has one
+class PropertyPublisher
+{
+  public:
+    void publish_to(const PropertyTopic &topic)
+    {
+        m_p_topic = &topic;
+    }
+
+  protected:
+    void publish() const
+    {
+        if (m_p_topic)
+            m_p_topic->publish();
+    }
+
+  private:
+    const PropertyTopic *m_p_topic = nullptr;
+};
+
 enum class PropertyType
 {
     Optional,
@@ -50,7 +203,7 @@ using PropertyNonOpt = _Property<T, PropertyType::NonOptional>;
 
 /* String type */
 template <size_t N, PropertyType PT>
-class _Property<std::array<uint8_t, N>, PT> : public Teufel::Core::Uncopyable
+class _Property<std::array<uint8_t, N>, PT> : public Teufel::Core::Uncopyable, public PropertyPublisher
 {
   public:
     // Property w initial value
@@ -107,6 +260,8 @@ class _Property<std::array<uint8_t, N>, PT> : public Teufel::Core::Uncopyable
             PropertyMutex::mutex->unlock();
 
         log_info("Property (%s) set: %s", m_name, m_value.data());
+
+        publish();
     }
 
   private:
@@ -117,7 +272,7 @@ class _Property<std::array<uint8_t, N>, PT> : public Teufel::Core::Uncopyable
 };
 
 template <PropertyType PT>
-class _Property<bool, PT> : public Teufel::Core::Uncopyable
+class _Property<bool, PT> : public Teufel::Core::Uncopyable, public PropertyPublisher
 {
   public:
     // Property w initial value
@@ -140,15 +295,7 @@ class _Property<bool, PT> : public Teufel::Core::Uncopyable
 
     [[nodiscard]] auto get() const
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        auto v = m_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
-
-        return v;
+        return PropertySeqLock::read([this] { return m_value; });
     }
 
     void set(bool v)
@@ -156,42 +303,30 @@ class _Property<bool, PT> : public Teufel::Core::Uncopyable
         if (m_value.has_value() && *m_value == v)
             return;
 
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = v;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = v; });
 
         log_info("Property (%s) set: %d", m_name, v);
+
+        publish();
     }
 
     void set_default()
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = m_default_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = m_default_value; });
 
         log_info("Property (%s) set: %d", m_name, m_default_value);
+
+        publish();
     }
 
     void invalidate()
         requires(PT == PropertyType::Optional)
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = std::nullopt;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = std::nullopt; });
 
         log_info("Property (%s) invalidate", m_name);
+
+        publish();
     }
 
   private:
@@ -202,7 +337,9 @@ class _Property<bool, PT> : public Teufel::Core::Uncopyable
 
 /* Arithmetic type */
 template <typename T, PropertyType PT>
-class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::type> : public Teufel::Core::Uncopyable
+class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::type>
+  : public Teufel::Core::Uncopyable,
+    public PropertyPublisher
 {
   public:
     // Property w initial value
@@ -231,15 +368,7 @@ class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::ty
 
     [[nodiscard]] constexpr auto get() const
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        auto v = m_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
-
-        return v;
+        return PropertySeqLock::read([this] { return m_value; });
     }
 
     void set(T v)
@@ -253,13 +382,7 @@ class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::ty
         if (m_value.has_value() && *m_value == v)
             return;
 
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = v;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = v; });
 
         if constexpr (std::is_same_v<T, int8_t> || std::is_same_v<T, int16_t> || std::is_same_v<T, int32_t> ||
                       std::is_same_v<T, int64_t>)
@@ -274,33 +397,27 @@ class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::ty
         {
             log_info("Property (%s) set: %u", m_name, v);
         }
+
+        publish();
     }
 
     void set_default()
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = m_default_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = m_default_value; });
 
         log_info("Property (%s) set: %u", m_name, m_default_value);
+
+        publish();
     }
 
     void invalidate()
         requires(PT == PropertyType::Optional)
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = std::nullopt;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = std::nullopt; });
 
         log_info("Property (%s) invalidate", m_name);
+
+        publish();
     }
 
     constexpr T get_min() const
@@ -338,7 +455,9 @@ class _Property<T, PT, typename std::enable_if<std::is_arithmetic<T>::value>::ty
 
 /* Enum type */
 template <typename T, PropertyType PT>
-class _Property<T, PT, typename std::enable_if<std::is_enum<T>::value>::type> : public Teufel::Core::Uncopyable
+class _Property<T, PT, typename std::enable_if<std::is_enum<T>::value>::type>
+  : public Teufel::Core::Uncopyable,
+    public PropertyPublisher
 {
   public:
     _Property(const char *name, T default_value, T initial_value)
@@ -359,15 +478,7 @@ class _Property<T, PT, typename std::enable_if<std::is_enum<T>::value>::type> :
 
     std::optional<T> get() const
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        std::optional<T> v = m_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
-
-        return v;
+        return PropertySeqLock::read([this] { return m_value; });
     }
 
     void set(T v)
@@ -375,15 +486,11 @@ class _Property<T, PT, typename std::enable_if<std::is_enum<T>::value>::type> :
         if (m_value.has_value() && *m_value == v)
             return;
 
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = v;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = v; });
 
         log_info("Property (%s) set: %u", m_name, v);
+
+        publish();
     }
 
     void set(T v, const char *desc)
@@ -391,42 +498,30 @@ class _Property<T, PT, typename std::enable_if<std::is_enum<T>::value>::type> :
         if (m_value.has_value() && *m_value == v)
             return;
 
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = v;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = v; });
 
         log_info("Property (%s) set: %s", m_name, desc);
+
+        publish();
     }
 
     void set_default()
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = m_default_value;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = m_default_value; });
 
         log_info("Property (%s) set: %u", m_name, m_default_value);
+
+        publish();
     }
 
     void invalidate()
         requires(PT == PropertyType::Optional)
     {
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->lock();
-
-        m_value = std::nullopt;
-
-        if (PropertyMutex::mutex)
-            PropertyMutex::mutex->unlock();
+        PropertySeqLock::write([&] { m_value = std::nullopt; });
 
         log_info("Property (%s) invalidate", m_name);
+
+        publish();
     }
 
   private:
@@ -1,4 +1,6 @@
-set(FREERTOS_PATH ${CMAKE_CURRENT_SOURCE_DIR}/external/thirdparty/freertos-kernel)
+if(NOT FREERTOS_PATH)
+    set(FREERTOS_PATH ${CMAKE_CURRENT_SOURCE_DIR}/external/thirdparty/freertos-kernel)
+endif()
 
 if(NOT FreeRTOS_FIND_COMPONENTS)
     set(FreeRTOS_FIND_COMPONENTS
@@ -71,7 +73,39 @@ foreach(HEAP ${FreeRTOS_HEAPS})
     endif()
 endforeach()
 
+# The POSIX port (host builds) is not under portable/GCC and needs its event helper and pthreads
+if(Posix IN_LIST FreeRTOS_FIND_COMPONENTS)
+    set(FreeRTOS_Posix_PATH "${FREERTOS_PATH}/portable/ThirdParty/GCC/Posix")
+    find_file(FreeRTOS_Posix_SOURCE
+        NAMES port.c
+        PATHS "${FreeRTOS_Posix_PATH}"
+        NO_DEFAULT_PATH
+    )
+    list(APPEND FreeRTOS_INCLUDE_DIRS "${FreeRTOS_Posix_PATH}")
+
+    if(NOT (TARGET FreeRTOS::Posix))
+        find_package(Threads REQUIRED)
+        add_library(FreeRTOS::Posix INTERFACE IMPORTED)
+        target_link_libraries(FreeRTOS::Posix INTERFACE FreeRTOS Threads::Threads)
+        target_sources(FreeRTOS::Posix INTERFACE
+            "${FreeRTOS_Posix_SOURCE}"
+            "${FreeRTOS_Posix_PATH}/utils/wait_for_event.c"
+        )
+        target_include_directories(FreeRTOS::Posix INTERFACE "${FreeRTOS_Posix_PATH}" "${FreeRTOS_Posix_PATH}/utils")
+    endif()
+
+    if(FreeRTOS_Posix_SOURCE AND FreeRTOS_COMMON_INCLUDE)
+        set(FreeRTOS_Posix_FOUND TRUE)
+    else()
+        set(FreeRTOS_Posix_FOUND FALSE)
+    endif()
+endif()
+
 foreach(PORT ${FreeRTOS_FIND_COMPONENTS})
+    if(PORT STREQUAL "Posix")
+        continue()
+    endif()
+
     find_path(FreeRTOS_${PORT}_PATH
         NAMES portmacro.h
         PATHS "${FREERTOS_PATH}/portable/GCC"
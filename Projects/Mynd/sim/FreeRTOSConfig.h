@@ -0,0 +1,86 @@
+#pragma once
+
+/*
+ * FreeRTOS configuration of the host simulation (POSIX port). Kept as close as possible to src/FreeRTOSConfig.h,
+ * so the tasks are scheduled the same way as on the device.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define configUSE_PREEMPTION                  1
+#define configUSE_TICKLESS_IDLE               0
+#define configSUPPORT_STATIC_ALLOCATION       1
+#define configSUPPORT_DYNAMIC_ALLOCATION      0
+#define configCPU_CLOCK_HZ                    ((unsigned long) 48000000)
+#define configTICK_RATE_HZ                    ((TickType_t) 1000)
+#define configMAX_PRIORITIES                  5
+#define configMINIMAL_STACK_SIZE              ((uint16_t) 256 / 4)
+#define configTOTAL_HEAP_SIZE                 ((size_t) (10 * 1024))
+#define configMAX_TASK_NAME_LEN               10
+#define configUSE_16_BIT_TICKS                0
+#define configIDLE_SHOULD_YIELD               1
+#define configUSE_TASK_NOTIFICATIONS          1
+#define configTASK_NOTIFICATION_ARRAY_ENTRIES 8
+#define configUSE_MUTEXES                     1
+#define configUSE_RECURSIVE_MUTEXES           1
+#define configQUEUE_REGISTRY_SIZE             8
+
+/* Hook function related definitions. */
+#define configUSE_IDLE_HOOK                1
+#define configUSE_TICK_HOOK                0
+#define configCHECK_FOR_STACK_OVERFLOW     0 /* The POSIX port runs the tasks on pthread stacks */
+#define configUSE_MALLOC_FAILED_HOOK       0
+#define configUSE_DAEMON_TASK_STARTUP_HOOK 1
+
+#define configUSE_STATS_FORMATTING_FUNCTIONS 0
+#define configGENERATE_RUN_TIME_STATS        0
+
+#define configUSE_TRACE_FACILITY 0
+
+/* Co-routine definitions. */
+#define configUSE_CO_ROUTINES           0
+#define configMAX_CO_ROUTINE_PRIORITIES (2)
+
+/* Software timer definitions. */
+#define configUSE_TIMERS             1
+#define configTIMER_TASK_PRIORITY    (3)
+#define configTIMER_QUEUE_LENGTH     5
+#define configTIMER_TASK_STACK_DEPTH (768 / 4)
+
+/* Optional functions - most linkers will remove unused functions anyway. */
+#define INCLUDE_vTaskPrioritySet            1
+#define INCLUDE_uxTaskPriorityGet           1
+#define INCLUDE_vTaskDelete                 0
+#define INCLUDE_vTaskSuspend                1
+#define INCLUDE_xResumeFromISR              1
+#define INCLUDE_vTaskDelayUntil             1
+#define INCLUDE_vTaskDelay                  1
+#define INCLUDE_xTaskGetSchedulerState      1
+#define INCLUDE_xTaskGetCurrentTaskHandle   1
+#define INCLUDE_uxTaskGetStackHighWaterMark 0
+#define INCLUDE_xTaskGetIdleTaskHandle      0
+#define INCLUDE_eTaskGetState               0
+#define INCLUDE_xEventGroupSetBitFromISR    1
+#define INCLUDE_xTimerPendFunctionCall      1
+#define INCLUDE_xTaskAbortDelay             0
+#define INCLUDE_xTaskGetHandle              1
+#define INCLUDE_xTaskResumeFromISR          1
+#define INCLUDE_xQueueGetMutexHolder        1
+
+#define INCLUDE_vTaskCleanUpResources 0
+
+/* Interrupt priorities are not used by the POSIX port, the values only need to be valid. */
+#define configKERNEL_INTERRUPT_PRIORITY      255
+#define configMAX_SYSCALL_INTERRUPT_PRIORITY 191
+
+#ifndef BOOTLOADER
+#define configASSERT(x)                                                                                                \
+    if ((x) == 0)                                                                                                      \
+    {                                                                                                                  \
+        taskDISABLE_INTERRUPTS();                                                                                      \
+        printf("RTOS assert! %s:%d\r\n", __FILE__, __LINE__);                                                          \
+        abort();                                                                                                       \
+    }
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+
+// The benchmarks run without the logger, the logs of the libraries are compiled out
+#define log_fatal(...)   ((void) 0)
+#define log_err(...)     ((void) 0)
+#define log_error(...)   ((void) 0)
+#define log_warn(...)    ((void) 0)
+#define log_warning(...) ((void) 0)
+#define log_high(...)    ((void) 0)
+#define log_info(...)    ((void) 0)
+#define log_debug(...)   ((void) 0)
+#define log_trace(...)   ((void) 0)
@@ -0,0 +1,296 @@
+/*
+ * Property read benchmark on the FreeRTOS POSIX port.
+ *
+ * Three tasks with the priorities of the firmware tasks contend on a set of properties: "System" keeps writing them,
+ * "Audio" (same priority) reads them in a loop and "Bluetooth" (higher priority) wakes up every tick and reads them
+ * in bursts, as the LED, button and connection code does. The POSIX port runs one task at a time, like the MCU.
+ *
+ * Each read mode runs for the same time:
+ * - mutex:    every read takes the property mutex, as property.h did before the sequence lock
+ * - seqlock:  getProperty()-style reads of single properties
+ * - snapshot: coherent reads of three properties, as getPropertySnapshot() does
+ *
+ * A stall is a read which had to wait for the mutex held by another task (priority inversion when the holder has a
+ * lower priority). The Bluetooth column is the worst read latency of the highest priority reader.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <tuple>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "task.h"
+
+#include "property/property.h"
+
+#define BENCH_STACK_SIZE   (configMINIMAL_STACK_SIZE * 4)
+#define BENCH_RUN_TICKS    2000u
+#define BENCH_BURST_LENGTH 200u
+
+enum class Color : uint8_t
+{
+    Black,
+    White,
+    Berry,
+};
+
+static PropertyNonOpt<uint8_t> s_volume{"volume", 0, 100, 1, 30, 30};
+static PropertyNonOpt<uint8_t> s_battery_level{"battery level", 0, 100, 1, 50, 50};
+static PropertyNonOpt<bool>    s_eco_mode{"eco mode", false, false};
+static PropertyNonOpt<Color>   s_color{"color", Color::Black, Color::Black};
+
+enum class Mode
+{
+    Mutex,
+    SeqLock,
+    Snapshot,
+};
+
+struct ReaderStats
+{
+    uint32_t reads;
+    uint32_t stalls;
+    uint64_t max_read_ns;
+};
+
+static volatile Mode s_mode;
+static volatile bool s_running;
+static ReaderStats   s_audio_stats;
+static ReaderStats   s_bluetooth_stats;
+static uint32_t      s_writes;
+static uint32_t      s_incoherent_snapshots;
+
+static SemaphoreHandle_t s_mutex;
+static StaticSemaphore_t s_mutex_buffer;
+
+// Like the property mutex of task_system.cpp, plus the count of takes which had to wait for the holder
+static ReaderStats *get_current_stats()
+{
+    const char *p_name = pcTaskGetName(nullptr);
+    if (p_name[0] == 'A')
+        return &s_audio_stats;
+    if (p_name[0] == 'B')
+        return &s_bluetooth_stats;
+    return nullptr;
+}
+
+static IMutex s_property_mutex{
+    .lock =
+        []()
+    {
+        if (xSemaphoreTakeRecursive(s_mutex, 0) == pdTRUE)
+            return;
+
+        if (auto *p_stats = get_current_stats())
+            p_stats->stalls++;
+
+        configASSERT(xSemaphoreTakeRecursive(s_mutex, portMAX_DELAY) == pdTRUE);
+    },
+    .unlock = []() { configASSERT(xSemaphoreGiveRecursive(s_mutex) == pdTRUE); },
+};
+
+static uint64_t now_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000u + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static uint32_t read_properties()
+{
+    switch (s_mode)
+    {
+        case Mode::Mutex:
+        {
+            PropertyMutex::mutex->lock();
+            uint32_t sum = *s_volume.get() + *s_battery_level.get();
+            PropertyMutex::mutex->unlock();
+            return sum;
+        }
+        case Mode::SeqLock:
+            return *s_volume.get() + *s_battery_level.get();
+        case Mode::Snapshot:
+        default:
+        {
+            auto [volume, battery_level, eco_mode] = PropertySeqLock::read(
+                [] { return std::make_tuple(*s_volume.get(), *s_battery_level.get(), *s_eco_mode.get()); });
+
+            // The writer keeps the volume and battery level equal and the eco mode set when they are odd
+            if (volume != battery_level || eco_mode != static_cast<bool>(volume & 1u))
+                s_incoherent_snapshots++;
+
+            return volume + battery_level;
+        }
+    }
+}
+
+static void reader_burst(ReaderStats *p_stats)
+{
+    for (uint32_t i = 0; i < BENCH_BURST_LENGTH; i++)
+    {
+        uint64_t start = now_ns();
+        (void) read_properties();
+        p_stats->max_read_ns = std::max(p_stats->max_read_ns, now_ns() - start);
+        p_stats->reads++;
+    }
+}
+
+static void system_task(void *)
+{
+    for (uint8_t value = 0;; value = (value + 1) % 100)
+    {
+        if (!s_running)
+        {
+            vTaskDelay(1);
+            continue;
+        }
+
+        // One write of three properties, the snapshot readers check that they never see a part of it
+        PropertySeqLock::write(
+            [value]
+            {
+                s_volume.set(value);
+                s_battery_level.set(value);
+                s_eco_mode.set(value & 1u);
+            });
+        s_color.set(static_cast<Color>(value % 3));
+        s_writes++;
+    }
+}
+
+static void audio_task(void *)
+{
+    for (;;)
+    {
+        if (!s_running)
+        {
+            vTaskDelay(1);
+            continue;
+        }
+
+        reader_burst(&s_audio_stats);
+    }
+}
+
+static void bluetooth_task(void *)
+{
+    for (;;)
+    {
+        vTaskDelay(1);
+        if (s_running)
+            reader_burst(&s_bluetooth_stats);
+    }
+}
+
+static void print_result(const char *p_mode, uint32_t elapsed_ms, uint32_t mutex_reads)
+{
+    uint32_t reads = s_audio_stats.reads + s_bluetooth_stats.reads;
+
+    std::printf("%-9s %12lu %10lu %8lu %12lu %14lu %12lu\n", p_mode,
+                static_cast<unsigned long>(static_cast<uint64_t>(reads) * 1000u / elapsed_ms),
+                static_cast<unsigned long>(s_audio_stats.stalls + s_bluetooth_stats.stalls),
+                static_cast<unsigned long>(mutex_reads),
+                static_cast<unsigned long>(s_bluetooth_stats.max_read_ns / 1000u),
+                static_cast<unsigned long>(static_cast<uint64_t>(s_writes) * 1000u / elapsed_ms),
+                static_cast<unsigned long>(s_incoherent_snapshots));
+}
+
+static void bench_task(void *)
+{
+    static const std::tuple<Mode, const char *> modes[] = {
+        {Mode::Mutex, "mutex"},
+        {Mode::SeqLock, "seqlock"},
+        {Mode::Snapshot, "snapshot"},
+    };
+
+    std::printf("%-9s %12s %10s %8s %12s %14s %12s\n", "mode", "reads/s", "stalls", "fallback", "BT max [us]",
+                "writes/s", "incoherent");
+
+    for (const auto &[mode, p_name] : modes)
+    {
+        s_mode                 = mode;
+        s_audio_stats          = {};
+        s_bluetooth_stats      = {};
+        s_writes               = 0;
+        s_incoherent_snapshots = 0;
+        uint32_t mutex_reads   = PropertySeqLock::mutex_reads;
+        uint64_t start         = now_ns();
+
+        s_running = true;
+        vTaskDelay(BENCH_RUN_TICKS);
+        s_running = false;
+
+        auto elapsed_ms = static_cast<uint32_t>((now_ns() - start) / 1000000u);
+        vTaskDelay(2);
+        print_result(p_name, elapsed_ms, PropertySeqLock::mutex_reads - mutex_reads);
+    }
+
+    std::fflush(stdout);
+    std::exit(EXIT_SUCCESS);
+}
+
+template <size_t N>
+struct StaticTask
+{
+    StackType_t  stack[N];
+    StaticTask_t buffer;
+};
+
+static StaticTask<BENCH_STACK_SIZE> s_tasks[4];
+
+extern "C"
+{
+    void vApplicationIdleHook(void) {}
+
+    void vApplicationDaemonTaskStartupHook(void) {}
+
+    static StaticTask_t xIdleTaskTCBBuffer;
+    static StackType_t  xIdleStack[configMINIMAL_STACK_SIZE];
+
+    void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                       uint32_t *pulIdleTaskStackSize)
+    {
+        *ppxIdleTaskTCBBuffer   = &xIdleTaskTCBBuffer;
+        *ppxIdleTaskStackBuffer = &xIdleStack[0];
+        *pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+    }
+
+    static StaticTask_t xTimerTaskTCBBuffer;
+    static StackType_t  xTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+    void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                        uint32_t *pulTimerTaskStackSize)
+    {
+        *ppxTimerTaskTCBBuffer   = &xTimerTaskTCBBuffer;
+        *ppxTimerTaskStackBuffer = &xTimerStack[0];
+        *pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+    }
+}
+
+int main()
+{
+    s_mutex = xSemaphoreCreateRecursiveMutexStatic(&s_mutex_buffer);
+    configASSERT(s_mutex);
+    PropertyMutex::mutex = &s_property_mutex;
+
+    // Same priorities as src/tasks/task_priorities.h, the benchmark control task above all of them
+    const std::tuple<TaskFunction_t, const char *, UBaseType_t> tasks[] = {
+        {system_task, "System", tskIDLE_PRIORITY + 1},
+        {audio_task, "Audio", tskIDLE_PRIORITY + 1},
+        {bluetooth_task, "Bluetooth", tskIDLE_PRIORITY + 2},
+        {bench_task, "Bench", tskIDLE_PRIORITY + 3},
+    };
+
+    for (size_t i = 0; i < 4; i++)
+    {
+        const auto &[task_fn, p_name, priority] = tasks[i];
+        configASSERT(xTaskCreateStatic(task_fn, p_name, BENCH_STACK_SIZE, nullptr, priority, s_tasks[i].stack,
+                                       &s_tasks[i].buffer) != nullptr);
+    }
+
+    vTaskStartScheduler();
+    return EXIT_FAILURE;
+}
@@ -0,0 +1,97 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "bsp_adc.h"
+#include "board_hw.h"
+#include "sim_hal.h"
+#include "sim_models.h"
+
+// The conversions are triggered by TIM15 on the device, with a period of 100 ms
+#define ADC_TRIGGER_PERIOD_MS 100u
+
+// Channels of a conversion sequence, the DMA stores them by ascending channel number
+static const uint32_t sequence[] = {
+    BAT_VOLTAGE_ADC_CHANNEL, ISNS_REF_ADC_CHANNEL, ISENS_ADC_CHANNEL,
+    PSYS_ADC_CHANNEL,        BAT_NTC2_ADC_CHANNEL, ADC_CHANNEL_VREFINT,
+};
+
+static struct
+{
+    uint16_t                              *p_buffer;
+    uint32_t                               buffer_size;
+    bsp_adc_conversion_complete_callback_t callback;
+    uint32_t                               last_trigger_ms;
+    volatile bool                          is_running;
+    bool                                   is_poll_registered;
+} s_adc;
+
+static void adc_poll(uint32_t now_ms)
+{
+    if (!s_adc.is_running || now_ms - s_adc.last_trigger_ms < ADC_TRIGGER_PERIOD_MS)
+    {
+        return;
+    }
+
+    s_adc.last_trigger_ms = now_ms;
+
+    // The buffer size is in samples, the firmware passes its 16-bit buffer as a 32-bit pointer
+    for (uint32_t i = 0; i < s_adc.buffer_size; i++)
+    {
+        s_adc.p_buffer[i] = sim_adc_get_channel_value(sequence[i % (sizeof(sequence) / sizeof(sequence[0]))]);
+    }
+
+    if (s_adc.callback != NULL)
+    {
+        s_adc.callback();
+    }
+}
+
+void bsp_bat_voltage_enable_init(void)
+{
+    GPIO_InitTypeDef GPIO_InitStruct;
+
+    GPIO_InitStruct.Pin   = BAT_VOLTAGE_ENABLE_GPIO_PIN;
+    GPIO_InitStruct.Mode  = BAT_VOLTAGE_ENABLE_GPIO_MODE;
+    GPIO_InitStruct.Pull  = BAT_VOLTAGE_ENABLE_GPIO_PULL;
+    GPIO_InitStruct.Speed = BAT_VOLTAGE_ENABLE_GPIO_SPEED;
+    HAL_GPIO_Init(BAT_VOLTAGE_ENABLE_GPIO_PORT, &GPIO_InitStruct);
+}
+
+void bsp_bat_voltage_enable(bool enable)
+{
+    HAL_GPIO_WritePin(BAT_VOLTAGE_ENABLE_GPIO_PORT, BAT_VOLTAGE_ENABLE_GPIO_PIN,
+                      enable ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
+
+void bsp_adc_init(void)
+{
+    if (!s_adc.is_poll_registered)
+    {
+        sim_irq_add_poll(adc_poll);
+        s_adc.is_poll_registered = true;
+    }
+}
+
+void bsp_adc_deinit(void)
+{
+    s_adc.is_running = false;
+}
+
+void bsp_adc_start(uint32_t *buffer, uint32_t buffer_size, bsp_adc_conversion_complete_callback_t callback)
+{
+    s_adc.is_running  = false;
+    s_adc.p_buffer    = (uint16_t *) buffer;
+    s_adc.buffer_size = buffer_size;
+    s_adc.callback    = callback;
+    s_adc.is_running  = true;
+}
+
+void bsp_adc_stop(void)
+{
+    s_adc.is_running = false;
+}
+
+bool bsp_adc_is_busy(void)
+{
+    return s_adc.is_running;
+}
@@ -0,0 +1,167 @@
+#include <stdbool.h>
+#include <string.h>
+
+#include "bsp_bluetooth_uart.h"
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "task.h"
+#include "logger.h"
+#include "sim_models.h"
+
+#define STORAGE_SIZE_BYTES 128u
+static uint8_t              sbuffer_storage[STORAGE_SIZE_BYTES];
+static StaticStreamBuffer_t StreamBufferStruct;
+static StreamBufferHandle_t sbuffer_handle_rx;
+static volatile bool        missed_rx_data = false;
+
+// Frames are built in this buffer, like in the DMA TX buffer of the device
+#define TX_BUFFER_SIZE 256u
+static uint8_t tx_buffer[TX_BUFFER_SIZE];
+
+// The previous frame is on the wire until this tick, the buffer can't be reused before
+static volatile TickType_t tx_done_tick;
+
+static bsp_bluetooth_uart_stats_t       stats;
+static bsp_bluetooth_uart_rx_callback_t rx_callback = NULL;
+
+void bsp_bluetooth_uart_init(void)
+{
+    sbuffer_handle_rx = xStreamBufferCreateStatic(sizeof(sbuffer_storage), 0u, sbuffer_storage, &StreamBufferStruct);
+    if (sbuffer_handle_rx == NULL)
+    {
+        log_error("Failed to create BT UART stream buffer");
+    }
+}
+
+void bsp_bluetooth_uart_msp_init(void) {}
+
+void bsp_bluetooth_uart_msp_deinit(void) {}
+
+void bsp_bluetooth_uart_clear_buffer(void)
+{
+    if (xStreamBufferReset(sbuffer_handle_rx) != pdPASS)
+    {
+        log_error("Failed to reset BT UART buffer");
+    }
+}
+
+int bsp_bluetooth_uart_tx(const uint8_t *p_data, size_t length)
+{
+    // Blocking transmission, the task waits for the bytes to go out
+    sim_bt_module_on_tx(p_data, length);
+    vTaskDelay(pdMS_TO_TICKS(sim_bt_module_wire_time_ms(length)));
+    return 0;
+}
+
+int bsp_bluetooth_uart_tx_get_buffer(uint8_t **pp_buffer, size_t *p_size, uint32_t timeout_ms)
+{
+    TickType_t start = xTaskGetTickCount();
+    while ((TickType_t) (xTaskGetTickCount() - tx_done_tick) > portMAX_DELAY / 2)
+    {
+        if ((xTaskGetTickCount() - start) > pdMS_TO_TICKS(timeout_ms))
+        {
+            log_error("BT UART TX timeout");
+            return -1;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    *pp_buffer = tx_buffer;
+    *p_size    = sizeof(tx_buffer);
+    return 0;
+}
+
+int bsp_bluetooth_uart_tx_send_buffer(const uint8_t *p_data, size_t length)
+{
+    if (p_data < tx_buffer || (p_data + length) > (tx_buffer + sizeof(tx_buffer)))
+    {
+        log_error("BT UART TX data is not in the DMA buffer");
+        return -1;
+    }
+
+    // The module sees the frame at once, the buffer stays busy for the time it takes on the wire
+    tx_done_tick = xTaskGetTickCount() + pdMS_TO_TICKS(sim_bt_module_wire_time_ms(length));
+    sim_bt_module_on_tx(p_data, length);
+    return 0;
+}
+
+int bsp_bluetooth_uart_rx(uint8_t *p_data, size_t length)
+{
+    if (xStreamBufferBytesAvailable(sbuffer_handle_rx) < length)
+    {
+        return -1;
+    }
+
+    if (missed_rx_data)
+    {
+        missed_rx_data = false;
+        log_error("Lost RX data");
+    }
+
+    size_t bytes_received = xStreamBufferReceive(sbuffer_handle_rx, (void *) p_data, length, 0);
+    if (bytes_received != length)
+    {
+        log_error("UART RX failed: expected %d, received %d", length, bytes_received);
+        return -1;
+    }
+
+    return 0;
+}
+
+size_t bsp_bluetooth_uart_rx_available(uint8_t *p_data, size_t max_length)
+{
+    if (missed_rx_data)
+    {
+        missed_rx_data = false;
+        log_error("Lost RX data");
+    }
+
+    return xStreamBufferReceive(sbuffer_handle_rx, (void *) p_data, max_length, 0);
+}
+
+void bsp_bluetooth_uart_set_rx_callback(bsp_bluetooth_uart_rx_callback_t callback)
+{
+    rx_callback = callback;
+}
+
+void bsp_bluetooth_uart_get_stats(bsp_bluetooth_uart_stats_t *p_stats)
+{
+    taskENTER_CRITICAL();
+    *p_stats = stats;
+    taskEXIT_CRITICAL();
+}
+
+void bsp_bluetooth_uart_isr_rx_event_callback(void) {}
+
+void bsp_bluetooth_uart_isr_char_match_callback(void) {}
+
+void bsp_bluetooth_uart_isr_error_callback(void) {}
+
+void sim_bluetooth_uart_receive(const uint8_t *p_data, size_t length)
+{
+    BaseType_t higher_prio_task_woken = pdFALSE;
+
+    if (sbuffer_handle_rx == NULL || length == 0)
+    {
+        return;
+    }
+
+    // One RX event per call, as the character match interrupt of the device raises one per frame
+    stats.rx_irq_count++;
+
+    size_t bytes_sent = xStreamBufferSendFromISR(sbuffer_handle_rx, p_data, length, &higher_prio_task_woken);
+
+    stats.rx_bytes += bytes_sent;
+    if (bytes_sent != length)
+    {
+        stats.rx_dropped_bytes += length - bytes_sent;
+        missed_rx_data = true;
+    }
+
+    if (rx_callback != NULL)
+    {
+        rx_callback();
+    }
+
+    portYIELD_FROM_ISR(higher_prio_task_woken);
+}
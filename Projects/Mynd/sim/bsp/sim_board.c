@@ -0,0 +1,49 @@
+#include <time.h>
+
+#include "board.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f0xx_hal.h"
+
+void board_init(void)
+{
+    /* Enable all GPIO clocks */
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    __HAL_RCC_GPIOB_CLK_ENABLE();
+    __HAL_RCC_GPIOC_CLK_ENABLE();
+    __HAL_RCC_GPIOD_CLK_ENABLE();
+    __HAL_RCC_GPIOF_CLK_ENABLE();
+}
+
+uint32_t get_systick(void)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED)
+        return 0;
+
+    // The simulated interrupts run from a task, so the task API is always the right one
+    return xTaskGetTickCount();
+}
+
+uint32_t board_get_ms_since(uint32_t tick_ms)
+{
+    uint32_t current_tick_ms = get_systick();
+
+    // Handle overflow
+    if (current_tick_ms < tick_ms)
+    {
+        // Note: if last tick is UINT32_MAX and current tick is 0, this function should return 1
+        return (UINT32_MAX - tick_ms) + current_tick_ms + 1;
+    }
+    else
+    {
+        return current_tick_ms - tick_ms;
+    }
+}
+
+uint32_t board_get_cycle_count(void)
+{
+    // Host time counted in cycles of the 48 MHz MCU clock
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t) (((uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec) * 48u / 1000u);
+}
@@ -0,0 +1,92 @@
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "bsp_debug_uart.h"
+#include "FreeRTOS.h"
+#include "stream_buffer.h"
+#include "sim_models.h"
+
+#define STORAGE_SIZE_BYTES 64u
+static uint8_t              sbuffer_storage[STORAGE_SIZE_BYTES];
+static StaticStreamBuffer_t StreamBufferStruct;
+static StreamBufferHandle_t sbuffer_handle_rx;
+static bool                 is_stdin_closed;
+
+static bsp_debug_uart_tx_done_callback_t tx_done_callback;
+
+// The terminal is the other end of the debug UART. stdin is polled from the simulated interrupt context, like the
+// RX interrupt of the device, so no task blocks in read()
+static void stdin_poll(uint32_t now_ms)
+{
+    (void) now_ms;
+
+    struct pollfd fd    = {.fd = STDIN_FILENO, .events = POLLIN};
+    uint8_t       data[STORAGE_SIZE_BYTES];
+    size_t        space = xStreamBufferSpacesAvailable(sbuffer_handle_rx);
+
+    // Like the UART, leave the bytes in the "wire" until the firmware has room for them
+    if (is_stdin_closed || space == 0 || poll(&fd, 1, 0) <= 0 || !(fd.revents & (POLLIN | POLLHUP)))
+    {
+        return;
+    }
+
+    ssize_t length = read(STDIN_FILENO, data, space < sizeof(data) ? space : sizeof(data));
+    if (length > 0)
+    {
+        xStreamBufferSendFromISR(sbuffer_handle_rx, data, (size_t) length, NULL);
+    }
+    else
+    {
+        is_stdin_closed = true;
+    }
+}
+
+void bsp_debug_uart_init(void)
+{
+    sbuffer_handle_rx = xStreamBufferCreateStatic(sizeof(sbuffer_storage), 1u, sbuffer_storage, &StreamBufferStruct);
+    configASSERT(sbuffer_handle_rx != NULL);
+
+    sim_irq_add_poll(stdin_poll);
+}
+
+void bsp_debug_uart_msp_init(void) {}
+
+int bsp_debug_uart_tx(const uint8_t *p_data, size_t length)
+{
+    fwrite(p_data, 1, length, stdout);
+    fflush(stdout);
+    return 0;
+}
+
+// The transfer is done right away, the callback is called before this function returns
+int bsp_debug_uart_tx_dma(const uint8_t *p_data, size_t length)
+{
+    bsp_debug_uart_tx(p_data, length);
+    if (tx_done_callback != NULL)
+    {
+        tx_done_callback();
+    }
+    return 0;
+}
+
+void bsp_debug_uart_set_tx_done_callback(bsp_debug_uart_tx_done_callback_t callback)
+{
+    tx_done_callback = callback;
+}
+
+bool bsp_debug_uart_is_tx_busy(void)
+{
+    return false;
+}
+
+int bsp_debug_uart_rx(uint8_t *p_data, size_t length)
+{
+    if (xStreamBufferBytesAvailable(sbuffer_handle_rx) < length)
+    {
+        return -1;
+    }
+
+    return xStreamBufferReceive(sbuffer_handle_rx, (void *) p_data, length, 0) == length ? 0 : -1;
+}
@@ -0,0 +1,123 @@
+#include <string.h>
+
+#include "task.h"
+
+#include "sim_i2c_bus.h"
+
+static i2c_rtos_device_stats_t *get_device_stats(sim_i2c_bus_t *p_bus, uint8_t i2c_address)
+{
+    i2c_rtos_stats_t *p_stats = &p_bus->stats;
+
+    for (uint8_t i = 0; i < p_stats->number_of_devices; i++)
+    {
+        if (p_stats->devices[i].i2c_address == i2c_address)
+        {
+            return &p_stats->devices[i];
+        }
+    }
+
+    if (p_stats->number_of_devices == I2C_RTOS_MAX_DEVICES)
+    {
+        return NULL;
+    }
+
+    i2c_rtos_device_stats_t *p_device = &p_stats->devices[p_stats->number_of_devices++];
+    p_device->i2c_address             = i2c_address;
+    return p_device;
+}
+
+void sim_i2c_bus_init(sim_i2c_bus_t *p_bus, uint32_t speed_khz, sim_i2c_device_fn_t device_fn)
+{
+    memset(p_bus, 0, sizeof(*p_bus));
+    p_bus->mutex     = xSemaphoreCreateMutexStatic(&p_bus->mutex_buffer);
+    p_bus->speed_khz = speed_khz;
+    p_bus->device_fn = device_fn;
+    configASSERT(p_bus->mutex != NULL);
+}
+
+int sim_i2c_bus_transfer_batch(sim_i2c_bus_t *p_bus, const i2c_rtos_transfer_t *p_transfers, size_t count)
+{
+    int      error      = 0;
+    uint32_t bus_clocks = 0;
+
+    if (xSemaphoreTake(p_bus->mutex, pdMS_TO_TICKS(1000)) != pdTRUE)
+    {
+        return -1;
+    }
+
+    p_bus->stats.batches++;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        i2c_rtos_device_stats_t *p_device = get_device_stats(p_bus, p_transfers[i].i2c_address);
+
+        // The simulated interrupts must see the register accesses of a transfer as a whole
+        taskENTER_CRITICAL();
+        int result = p_bus->device_fn(&p_transfers[i]);
+        taskEXIT_CRITICAL();
+
+        if (result != 0)
+        {
+            if (p_device != NULL)
+            {
+                p_device->errors++;
+            }
+            error = -4;
+            break;
+        }
+
+        // 9 clocks per byte (8 data bits and the ACK), plus the repeated start and address byte of a read
+        uint32_t frame_bytes = 1u + p_transfers[i].reg_address_size + p_transfers[i].length;
+        if (p_transfers[i].direction == I2C_RTOS_READ)
+        {
+            frame_bytes += 1u;
+        }
+
+        bus_clocks += frame_bytes * 9u;
+        if (p_device != NULL)
+        {
+            p_device->transfers++;
+            p_device->bytes += p_transfers[i].length;
+            p_device->bus_clocks += frame_bytes * 9u;
+        }
+    }
+
+    // Hold the bus as long as the transfers would have occupied it
+    p_bus->pending_bus_us += bus_clocks * 1000u / p_bus->speed_khz;
+    if (p_bus->pending_bus_us >= 1000u * portTICK_PERIOD_MS)
+    {
+        TickType_t ticks = pdMS_TO_TICKS(p_bus->pending_bus_us / 1000u);
+        p_bus->pending_bus_us -= ticks * portTICK_PERIOD_MS * 1000u;
+        vTaskDelay(ticks);
+    }
+
+    (void) xSemaphoreGive(p_bus->mutex);
+    return error;
+}
+
+int sim_i2c_bus_get_stats(sim_i2c_bus_t *p_bus, i2c_rtos_stats_t *p_stats)
+{
+    if (xSemaphoreTake(p_bus->mutex, pdMS_TO_TICKS(100)) != pdTRUE)
+    {
+        return -1;
+    }
+
+    *p_stats            = p_bus->stats;
+    p_stats->elapsed_ms = (xTaskGetTickCount() - p_bus->stats_reset_tick) * portTICK_PERIOD_MS;
+
+    (void) xSemaphoreGive(p_bus->mutex);
+    return 0;
+}
+
+void sim_i2c_bus_reset_stats(sim_i2c_bus_t *p_bus)
+{
+    if (xSemaphoreTake(p_bus->mutex, pdMS_TO_TICKS(100)) != pdTRUE)
+    {
+        return;
+    }
+
+    memset(&p_bus->stats, 0, sizeof(p_bus->stats));
+    p_bus->stats_reset_tick = xTaskGetTickCount();
+
+    (void) xSemaphoreGive(p_bus->mutex);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+/*
+ * I2C bus shared by the sim bsp replacements. Executes the transfers on the device models and keeps the same
+ * statistics as the i2c_freertos driver of the device.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
+#include "platform/stm32/i2c_freertos.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Executes one transfer on the addressed device model.
+     *
+     * @return 0 if the device acknowledged the transfer, -1 otherwise
+     */
+    typedef int (*sim_i2c_device_fn_t)(const i2c_rtos_transfer_t *p_transfer);
+
+    typedef struct
+    {
+        SemaphoreHandle_t   mutex;
+        StaticSemaphore_t   mutex_buffer;
+        uint32_t            speed_khz;
+        uint32_t            pending_bus_us; // Bus time not waited for yet, the tick is the time resolution
+        TickType_t          stats_reset_tick;
+        i2c_rtos_stats_t    stats;
+        sim_i2c_device_fn_t device_fn;
+    } sim_i2c_bus_t;
+
+    void sim_i2c_bus_init(sim_i2c_bus_t *p_bus, uint32_t speed_khz, sim_i2c_device_fn_t device_fn);
+
+    /**
+     * @brief Same as i2c_rtos_transfer_batch(). The calling task is blocked for the time the transfers occupy
+     *        the bus, once it adds up to a tick.
+     */
+    int sim_i2c_bus_transfer_batch(sim_i2c_bus_t *p_bus, const i2c_rtos_transfer_t *p_transfers, size_t count);
+
+    int  sim_i2c_bus_get_stats(sim_i2c_bus_t *p_bus, i2c_rtos_stats_t *p_stats);
+    void sim_i2c_bus_reset_stats(sim_i2c_bus_t *p_bus);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,35 @@
+#include "bsp_low_power.h"
+#include "board.h"
+
+// The host has no STOP mode, the requests of the firmware are only recorded for the shell
+static struct
+{
+    bool     is_stop_allowed;
+    uint32_t stats_reset_ms;
+} s_low_power;
+
+void bsp_low_power_init(void)
+{
+    s_low_power.stats_reset_ms = get_systick();
+}
+
+void bsp_low_power_allow_stop(bool allow)
+{
+    s_low_power.is_stop_allowed = allow;
+}
+
+bool bsp_low_power_is_stop_allowed(void)
+{
+    return s_low_power.is_stop_allowed;
+}
+
+void bsp_low_power_get_stats(bsp_low_power_stats_t *p_stats)
+{
+    *p_stats            = (bsp_low_power_stats_t) {0};
+    p_stats->elapsed_ms = board_get_ms_since(s_low_power.stats_reset_ms);
+}
+
+void bsp_low_power_reset_stats(void)
+{
+    s_low_power.stats_reset_ms = get_systick();
+}
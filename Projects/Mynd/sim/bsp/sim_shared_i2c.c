@@ -0,0 +1,139 @@
+#include <stdbool.h>
+
+#include "bsp_shared_i2c.h"
+#include "board_hw.h"
+#include "logger.h"
+#include "sim_i2c_bus.h"
+#include "sim_models.h"
+
+static sim_i2c_bus_t s_bus;
+static bool          s_is_initialized;
+
+static int device_transfer(const i2c_rtos_transfer_t *p_transfer)
+{
+    uint8_t reg = (uint8_t) p_transfer->reg_address;
+
+    if (p_transfer->i2c_address == AW9523B_I2C_ADDRESS)
+    {
+        return p_transfer->direction == I2C_RTOS_WRITE
+                   ? sim_aw9523b_write(reg, p_transfer->p_buffer, p_transfer->length)
+                   : sim_aw9523b_read(reg, p_transfer->p_buffer, p_transfer->length);
+    }
+
+    if (sim_tas58xx_is_present(p_transfer->i2c_address))
+    {
+        return p_transfer->direction == I2C_RTOS_WRITE
+                   ? sim_tas58xx_write(p_transfer->i2c_address, reg, p_transfer->p_buffer, p_transfer->length)
+                   : sim_tas58xx_read(p_transfer->i2c_address, reg, p_transfer->p_buffer, p_transfer->length);
+    }
+
+    // Nobody acknowledges the address
+    return -1;
+}
+
+void bsp_shared_i2c_init(void)
+{
+    if (s_is_initialized)
+    {
+        return;
+    }
+
+    sim_i2c_bus_init(&s_bus, SHARED_I2C_SPEED_KHZ, device_transfer);
+    s_is_initialized = true;
+}
+
+void bsp_shared_i2c_deinit(void) {}
+
+void bsp_shared_i2c_msp_init(void) {}
+
+void bsp_shared_i2c_msp_deinit(void) {}
+
+int bsp_shared_i2c_write(uint8_t i2c_address, uint8_t register_address, const uint8_t *p_buffer, uint32_t length)
+{
+    if (!s_is_initialized)
+    {
+        log_error("Can't write on I2C before initialization");
+        return -1;
+    }
+
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = register_address,
+        .reg_address_size = 1,
+        .direction        = I2C_RTOS_WRITE,
+        .p_buffer         = (uint8_t *) p_buffer,
+        .length           = length,
+    };
+
+    int error = sim_i2c_bus_transfer_batch(&s_bus, &transfer, 1);
+    if (error < 0)
+    {
+        log_err("I2C write failed (address 0x%02X, register 0x%02X, error %d)", i2c_address, register_address, error);
+    }
+    return error;
+}
+
+int bsp_shared_i2c_read(uint8_t i2c_address, uint8_t register_address, uint8_t *p_buffer, uint32_t length)
+{
+    if (!s_is_initialized)
+    {
+        log_error("Can't read on I2C before initialization");
+        return -1;
+    }
+
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = register_address,
+        .reg_address_size = 1,
+        .direction        = I2C_RTOS_READ,
+        .p_buffer         = p_buffer,
+        .length           = length,
+    };
+
+    int error = sim_i2c_bus_transfer_batch(&s_bus, &transfer, 1);
+    if (error < 0)
+    {
+        log_err("I2C read failed (address 0x%02X, register 0x%02X, error %d)", i2c_address, register_address, error);
+    }
+    return error;
+}
+
+int bsp_shared_i2c_transfer_batch(const i2c_rtos_transfer_t *p_transfers, size_t count)
+{
+    if (!s_is_initialized)
+    {
+        log_error("Can't transfer on I2C before initialization");
+        return -1;
+    }
+
+    return sim_i2c_bus_transfer_batch(&s_bus, p_transfers, count);
+}
+
+int bsp_shared_i2c_get_stats(i2c_rtos_stats_t *p_stats)
+{
+    if (!s_is_initialized)
+    {
+        return -1;
+    }
+
+    return sim_i2c_bus_get_stats(&s_bus, p_stats);
+}
+
+void bsp_shared_i2c_reset_stats(void)
+{
+    if (s_is_initialized)
+    {
+        sim_i2c_bus_reset_stats(&s_bus);
+    }
+}
+
+// The transfers complete in the calling task
+bool bsp_shared_i2c_is_busy(void)
+{
+    return false;
+}
+
+uint32_t bsp_shared_i2c_get_speed_khz(void)
+{
+    return SHARED_I2C_SPEED_KHZ;
+}
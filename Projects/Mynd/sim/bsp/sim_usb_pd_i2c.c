@@ -0,0 +1,74 @@
+#include <stdbool.h>
+
+#include "bsp_usb_pd_i2c.h"
+#include "board_hw.h"
+#include "logger.h"
+#include "sim_i2c_bus.h"
+#include "sim_models.h"
+
+// Matches USB_PD_I2C_TIMING
+#define USB_PD_I2C_SPEED_KHZ 100u
+
+static sim_i2c_bus_t s_bus;
+static bool          s_is_initialized;
+
+static int device_transfer(const i2c_rtos_transfer_t *p_transfer)
+{
+    if (p_transfer->i2c_address != TPS25751_I2C_ADDRESS)
+    {
+        return -1;
+    }
+
+    return p_transfer->direction == I2C_RTOS_WRITE
+               ? sim_tps25751_write((uint8_t) p_transfer->reg_address, p_transfer->p_buffer, p_transfer->length)
+               : sim_tps25751_read((uint8_t) p_transfer->reg_address, p_transfer->p_buffer, p_transfer->length);
+}
+
+void bsp_usb_pd_i2c_init(void)
+{
+    if (!s_is_initialized)
+    {
+        sim_i2c_bus_init(&s_bus, USB_PD_I2C_SPEED_KHZ, device_transfer);
+        s_is_initialized = true;
+    }
+}
+
+void bsp_usb_pd_i2c_msp_init(void) {}
+
+int bsp_usb_pd_i2c_write(uint8_t i2c_address, uint8_t register_address, const uint8_t *p_buffer, uint32_t length)
+{
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = register_address,
+        .reg_address_size = 1,
+        .direction        = I2C_RTOS_WRITE,
+        .p_buffer         = (uint8_t *) p_buffer,
+        .length           = length,
+    };
+
+    int error = sim_i2c_bus_transfer_batch(&s_bus, &transfer, 1);
+    if (error < 0)
+    {
+        log_err("I2C write failed (address 0x%02X, register 0x%02X)", i2c_address, register_address);
+    }
+    return error;
+}
+
+int bsp_usb_pd_i2c_read(uint8_t i2c_address, uint8_t register_address, uint8_t *p_buffer, uint32_t length)
+{
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = register_address,
+        .reg_address_size = 1,
+        .direction        = I2C_RTOS_READ,
+        .p_buffer         = p_buffer,
+        .length           = length,
+    };
+
+    int error = sim_i2c_bus_transfer_batch(&s_bus, &transfer, 1);
+    if (error < 0)
+    {
+        log_err("I2C read failed (address 0x%02X, register 0x%02X)", i2c_address, register_address);
+    }
+    return error;
+}
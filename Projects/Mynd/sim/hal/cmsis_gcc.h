@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+ * Core intrinsics used by the firmware, mapped to their host equivalents.
+ */
+
+#include <signal.h>
+#include <stdlib.h>
+
+#define __disable_irq() ((void) 0)
+#define __enable_irq()  ((void) 0)
+#define __WFI()         ((void) 0)
+#define __NOP()         ((void) 0)
+#define __DSB()         __sync_synchronize()
+#define __ISB()         __sync_synchronize()
+
+// A breakpoint stops the debugger attached to the simulation, or ends it with a core dump
+#define __BKPT(value)   raise(SIGTRAP)
@@ -0,0 +1,414 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "sim_hal.h"
+#include "stm32f0xx_ll_adc.h"
+
+// The RTC backup registers survive NVIC_SystemReset() through the environment of the restarted process
+#define SIM_BACKUP_ENV "MYND_SIM_RTC_BKP0R"
+
+GPIO_TypeDef sim_gpio_ports[6];
+ADC_TypeDef  sim_adc1;
+RTC_TypeDef  sim_rtc;
+
+static char   **s_argv;
+static uint8_t *s_flash;
+static bool     s_flash_unlocked;
+
+static sim_flash_stats_t s_flash_stats;
+static uint16_t          s_adc_values[ADC_NUMBER_OF_CHANNELS];
+static uint32_t          s_adc_channel;
+static volatile uint16_t s_exti_pending;
+
+void sim_hal_init(int argc, char **argv)
+{
+    (void) argc;
+    s_argv = argv;
+
+    const char *p_backup = getenv(SIM_BACKUP_ENV);
+    if (p_backup != NULL)
+    {
+        sim_rtc.BKP0R = (uint32_t) strtoul(p_backup, NULL, 0);
+        unsetenv(SIM_BACKUP_ENV);
+    }
+
+    // The internal reference reads as VREFINT_CAL when VDDA is 3.3 V
+    s_adc_values[ADC_CHANNEL_VREFINT] = SIM_VREFINT_CAL;
+}
+
+HAL_StatusTypeDef HAL_Init(void)
+{
+    return HAL_OK;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt_priority, uint32_t sub_priority)
+{
+    (void) irq;
+    (void) preempt_priority;
+    (void) sub_priority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type irq)
+{
+    (void) irq;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type irq)
+{
+    (void) irq;
+}
+
+void NVIC_DisableIRQ(IRQn_Type irq)
+{
+    (void) irq;
+}
+
+void NVIC_SystemReset(void)
+{
+    char backup[16];
+
+    fflush(stdout);
+    if (s_flash != NULL)
+    {
+        msync(s_flash, FLASH_SIZE, MS_SYNC);
+    }
+
+    snprintf(backup, sizeof(backup), "0x%08X", (unsigned) sim_rtc.BKP0R);
+    setenv(SIM_BACKUP_ENV, backup, 1);
+
+    printf("\r\n[sim] System reset\r\n");
+    fflush(stdout);
+    execv("/proc/self/exe", s_argv);
+
+    perror("[sim] Failed to restart");
+    exit(EXIT_FAILURE);
+}
+
+/* -------------------------------------------------------------------------------------------------------------- */
+/* GPIO                                                                                                           */
+/* -------------------------------------------------------------------------------------------------------------- */
+
+static inline unsigned pin_number(uint16_t pin)
+{
+    return (unsigned) __builtin_ctz(pin);
+}
+
+void HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init)
+{
+    for (unsigned i = 0; i < 16; i++)
+    {
+        if (GPIO_Init->Pin & (1u << i))
+        {
+            GPIOx->mode[i] = GPIO_Init->Mode;
+            GPIOx->pull[i] = GPIO_Init->Pull;
+
+            // An unconnected input follows its pull resistor, the devices drive their lines from here on
+            if (GPIO_Init->Pull == GPIO_PULLUP)
+            {
+                GPIOx->input |= (uint16_t) (1u << i);
+            }
+            else if (GPIO_Init->Pull == GPIO_PULLDOWN)
+            {
+                GPIOx->input &= (uint16_t) ~(1u << i);
+            }
+        }
+    }
+}
+
+void HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin)
+{
+    for (unsigned i = 0; i < 16; i++)
+    {
+        if (GPIO_Pin & (1u << i))
+        {
+            GPIOx->mode[i] = GPIO_MODE_ANALOG;
+            GPIOx->pull[i] = GPIO_NOPULL;
+        }
+    }
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    uint32_t mode = GPIOx->mode[pin_number(GPIO_Pin)];
+
+    if (mode == GPIO_MODE_OUTPUT_PP || mode == GPIO_MODE_OUTPUT_OD)
+    {
+        return (GPIOx->output & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+    }
+
+    return (GPIOx->input & GPIO_Pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    if (PinState == GPIO_PIN_SET)
+    {
+        GPIOx->output |= GPIO_Pin;
+    }
+    else
+    {
+        GPIOx->output &= (uint16_t) ~GPIO_Pin;
+    }
+}
+
+void HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+    GPIOx->output ^= GPIO_Pin;
+}
+
+void sim_gpio_set_input(GPIO_TypeDef *port, uint16_t pin, bool level)
+{
+    bool     previous = (port->input & pin) != 0;
+    uint32_t mode     = port->mode[pin_number(pin)];
+
+    if (level)
+    {
+        port->input |= pin;
+    }
+    else
+    {
+        port->input &= (uint16_t) ~pin;
+    }
+
+    // As on the device, the EXTI line is shared by the pins with the same number on all ports
+    bool rising  = !previous && level && (mode == GPIO_MODE_IT_RISING || mode == GPIO_MODE_IT_RISING_FALLING);
+    bool falling = previous && !level && (mode == GPIO_MODE_IT_FALLING || mode == GPIO_MODE_IT_RISING_FALLING);
+    if (rising || falling)
+    {
+        __atomic_fetch_or(&s_exti_pending, pin, __ATOMIC_SEQ_CST);
+    }
+}
+
+bool sim_gpio_get_output(GPIO_TypeDef *port, uint16_t pin)
+{
+    return (port->output & pin) != 0;
+}
+
+void sim_gpio_process_exti(void)
+{
+    uint16_t pending = __atomic_exchange_n(&s_exti_pending, 0, __ATOMIC_SEQ_CST);
+
+    while (pending != 0)
+    {
+        uint16_t pin = (uint16_t) (1u << __builtin_ctz(pending));
+        pending &= (uint16_t) ~pin;
+        HAL_GPIO_EXTI_Callback(pin);
+    }
+}
+
+__attribute__((weak)) void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    (void) GPIO_Pin;
+}
+
+/* -------------------------------------------------------------------------------------------------------------- */
+/* ADC                                                                                                            */
+/* -------------------------------------------------------------------------------------------------------------- */
+
+void sim_adc_set_channel_mv(uint32_t channel, uint32_t mv)
+{
+    if (channel < ADC_NUMBER_OF_CHANNELS && channel != ADC_CHANNEL_VREFINT)
+    {
+        s_adc_values[channel] = (uint16_t) ((mv > 3300u ? 3300u : mv) * 4095u / 3300u);
+    }
+}
+
+uint16_t sim_adc_get_channel_value(uint32_t channel)
+{
+    return channel < ADC_NUMBER_OF_CHANNELS ? s_adc_values[channel] : 0;
+}
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc)
+{
+    hadc->channels  = 0;
+    hadc->ErrorCode = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef *hadc)
+{
+    hadc->channels = 0;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig)
+{
+    if (sConfig->Channel >= ADC_NUMBER_OF_CHANNELS)
+    {
+        return HAL_ERROR;
+    }
+
+    hadc->channels |= 1u << sConfig->Channel;
+    s_adc_channel = sConfig->Channel;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc)
+{
+    (void) hadc;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc)
+{
+    return hadc->channels != 0 ? HAL_OK : HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout)
+{
+    (void) hadc;
+    (void) Timeout;
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef *hadc)
+{
+    (void) hadc;
+    return s_adc_values[s_adc_channel];
+}
+
+/* -------------------------------------------------------------------------------------------------------------- */
+/* FLASH                                                                                                          */
+/* -------------------------------------------------------------------------------------------------------------- */
+
+int sim_flash_open(const char *path)
+{
+    int flags = MAP_SHARED | MAP_FIXED_NOREPLACE;
+    int fd    = -1;
+
+    if (path != NULL)
+    {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0)
+        {
+            fprintf(stderr, "[sim] Can't open the flash file %s: %s\n", path, strerror(errno));
+            return -1;
+        }
+
+        off_t size = lseek(fd, 0, SEEK_END);
+        if (size < (off_t) FLASH_SIZE)
+        {
+            // A new (or short) file is an erased flash
+            uint8_t erased[FLASH_PAGE_SIZE];
+            memset(erased, 0xFF, sizeof(erased));
+            for (off_t offset = size; offset < (off_t) FLASH_SIZE; offset += (off_t) sizeof(erased))
+            {
+                if (pwrite(fd, erased, sizeof(erased), offset) != (ssize_t) sizeof(erased))
+                {
+                    close(fd);
+                    return -1;
+                }
+            }
+        }
+    }
+    else
+    {
+        flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE;
+    }
+
+    // The firmware accesses the flash through its absolute addresses, so it is mapped where it is on the device
+    void *p_flash = mmap((void *) FLASH_BASE, FLASH_SIZE, PROT_READ | PROT_WRITE, flags, fd, 0);
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+
+    if (p_flash != (void *) FLASH_BASE)
+    {
+        fprintf(stderr, "[sim] Can't map the flash at 0x%08lX: %s\n", (unsigned long) FLASH_BASE, strerror(errno));
+        return -1;
+    }
+
+    s_flash = p_flash;
+    if (path == NULL)
+    {
+        memset(s_flash, 0xFF, FLASH_SIZE);
+    }
+
+    return 0;
+}
+
+void sim_flash_get_stats(sim_flash_stats_t *p_stats)
+{
+    *p_stats = s_flash_stats;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+    s_flash_unlocked = true;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+    s_flash_unlocked = false;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+    uint32_t halfwords = (TypeProgram == FLASH_TYPEPROGRAM_WORD) ? 2u : 1u;
+
+    if (s_flash == NULL || !s_flash_unlocked || (Address & 1u) != 0 || Address < FLASH_BASE ||
+        Address + 2u * halfwords > FLASH_BASE + FLASH_SIZE)
+    {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t i = 0; i < halfwords; i++)
+    {
+        volatile uint16_t *p_halfword = (volatile uint16_t *) (uintptr_t) (Address + 2u * i);
+        uint16_t           value      = (uint16_t) (Data >> (16u * i));
+
+        // Like on the device, only an erased halfword can be programmed (or any halfword to 0)
+        if (*p_halfword != 0xFFFFu && value != 0)
+        {
+            s_flash_stats.program_errors++;
+            return HAL_ERROR;
+        }
+
+        *p_halfword = value;
+        s_flash_stats.halfword_programs++;
+    }
+
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+    *PageError = 0xFFFFFFFFu;
+
+    if (s_flash == NULL || !s_flash_unlocked || pEraseInit->TypeErase != FLASH_TYPEERASE_PAGES)
+    {
+        return HAL_ERROR;
+    }
+
+    for (uint32_t i = 0; i < pEraseInit->NbPages; i++)
+    {
+        uint32_t address = pEraseInit->PageAddress + i * FLASH_PAGE_SIZE;
+        if (address < FLASH_BASE || address + FLASH_PAGE_SIZE > FLASH_BASE + FLASH_SIZE)
+        {
+            *PageError = address;
+            return HAL_ERROR;
+        }
+
+        memset(&s_flash[(address - FLASH_BASE) & ~(FLASH_PAGE_SIZE - 1u)], 0xFF, FLASH_PAGE_SIZE);
+        s_flash_stats.page_erases++;
+    }
+
+    return HAL_OK;
+}
+
+/* -------------------------------------------------------------------------------------------------------------- */
+/* PWR                                                                                                            */
+/* -------------------------------------------------------------------------------------------------------------- */
+
+void HAL_PWR_EnableBkUpAccess(void) {}
+
+void HAL_PWR_DisableBkUpAccess(void) {}
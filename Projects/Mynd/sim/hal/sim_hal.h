@@ -0,0 +1,64 @@
+#pragma once
+
+/*
+ * Simulation side of the HAL shim: lets the device models and the command line drive the peripherals that
+ * the firmware accesses through stm32f0xx_hal.h.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "stm32f0xx_hal.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    typedef struct
+    {
+        uint32_t page_erases;
+        uint32_t halfword_programs;
+        uint32_t program_errors; // Programming of a halfword that was not erased
+    } sim_flash_stats_t;
+
+    /**
+     * @brief Keeps the command line, so NVIC_SystemReset() can restart the simulation with it.
+     */
+    void sim_hal_init(int argc, char **argv);
+
+    /**
+     * @brief Maps the virtual flash at FLASH_BASE, backed by a file so the vEEPROM content survives restarts.
+     * @note  The file is created erased (0xFF) if it doesn't exist.
+     *
+     * @param[in] path      backing file, NULL for a flash that is lost at exit
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int sim_flash_open(const char *path);
+
+    void sim_flash_get_stats(sim_flash_stats_t *p_stats);
+
+    /**
+     * @brief Drives an input pin from a simulated device. The EXTI callback of the pin runs from the simulated
+     *        interrupt context if its edge is enabled.
+     */
+    void sim_gpio_set_input(GPIO_TypeDef *port, uint16_t pin, bool level);
+
+    bool sim_gpio_get_output(GPIO_TypeDef *port, uint16_t pin);
+
+    /**
+     * @brief Runs the EXTI callbacks of the edges detected since the last call, from the simulated interrupt context.
+     */
+    void sim_gpio_process_exti(void);
+
+    /**
+     * @brief Sets the voltage seen by an ADC channel, converted with a 3.3 V reference.
+     */
+    void sim_adc_set_channel_mv(uint32_t channel, uint32_t mv);
+
+    uint16_t sim_adc_get_channel_value(uint32_t channel);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,315 @@
+#pragma once
+
+/*
+ * Subset of the STM32F0 HAL used by the firmware outside of the bsp folder, implemented on top of the simulated
+ * peripherals in sim_hal.c. Only what the firmware and board_hw.h reference is declared here.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cmsis_gcc.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+#define __IO volatile
+
+    typedef enum
+    {
+        HAL_OK      = 0x00U,
+        HAL_ERROR   = 0x01U,
+        HAL_BUSY    = 0x02U,
+        HAL_TIMEOUT = 0x03U
+    } HAL_StatusTypeDef;
+
+    typedef enum
+    {
+        DISABLE = 0U,
+        ENABLE  = !DISABLE
+    } FunctionalState;
+
+#define HAL_MAX_DELAY 0xFFFFFFFFU
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Interrupts and reset                                                                                       */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef enum
+    {
+        SysTick_IRQn             = -1,
+        DMA1_Channel1_IRQn       = 9,
+        DMA1_Channel2_3_IRQn     = 10,
+        DMA1_Channel4_5_6_7_IRQn = 11,
+        I2C1_IRQn                = 23,
+        I2C2_IRQn                = 24,
+        USART1_IRQn              = 27,
+        USART2_IRQn              = 28,
+    } IRQn_Type;
+
+    void HAL_NVIC_SetPriority(IRQn_Type irq, uint32_t preempt_priority, uint32_t sub_priority);
+    void HAL_NVIC_EnableIRQ(IRQn_Type irq);
+    void HAL_NVIC_DisableIRQ(IRQn_Type irq);
+    void NVIC_DisableIRQ(IRQn_Type irq);
+
+    /**
+     * @brief Restarts the simulation process, the virtual flash and the RTC backup registers are kept.
+     */
+    __attribute__((noreturn)) void NVIC_SystemReset(void);
+
+    HAL_StatusTypeDef HAL_Init(void);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Clocks: the peripherals of the simulation are always clocked                                               */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+#define __HAL_RCC_GPIOA_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_GPIOB_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_GPIOC_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_GPIOD_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_GPIOF_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_DMA1_CLK_ENABLE()      ((void) 0)
+#define __HAL_RCC_ADC1_CLK_ENABLE()      ((void) 0)
+#define __HAL_RCC_ADC1_FORCE_RESET()     ((void) 0)
+#define __HAL_RCC_ADC1_RELEASE_RESET()   ((void) 0)
+#define __HAL_RCC_I2C1_CLK_ENABLE()      ((void) 0)
+#define __HAL_RCC_I2C1_CLK_DISABLE()     ((void) 0)
+#define __HAL_RCC_I2C1_FORCE_RESET()     ((void) 0)
+#define __HAL_RCC_I2C1_RELEASE_RESET()   ((void) 0)
+#define __HAL_RCC_I2C2_CLK_ENABLE()      ((void) 0)
+#define __HAL_RCC_I2C2_CLK_DISABLE()     ((void) 0)
+#define __HAL_RCC_I2C2_FORCE_RESET()     ((void) 0)
+#define __HAL_RCC_I2C2_RELEASE_RESET()   ((void) 0)
+#define __HAL_RCC_USART1_CLK_ENABLE()    ((void) 0)
+#define __HAL_RCC_USART1_CLK_DISABLE()   ((void) 0)
+#define __HAL_RCC_USART2_CLK_ENABLE()    ((void) 0)
+#define __HAL_RCC_USART2_CLK_DISABLE()   ((void) 0)
+#define __HAL_RCC_TIM15_CLK_ENABLE()     ((void) 0)
+#define __HAL_RCC_PWR_CLK_ENABLE()       ((void) 0)
+#define __HAL_RCC_SYSCFG_CLK_ENABLE()    ((void) 0)
+#define __HAL_SYSCFG_REMAPMEMORY_SRAM()  ((void) 0)
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* GPIO                                                                                                       */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef struct
+    {
+        uint32_t mode[16];
+        uint32_t pull[16];
+        uint16_t input;  // Level driven by the simulated devices
+        uint16_t output; // Level driven by the firmware
+    } GPIO_TypeDef;
+
+    extern GPIO_TypeDef sim_gpio_ports[6];
+
+#define GPIOA (&sim_gpio_ports[0])
+#define GPIOB (&sim_gpio_ports[1])
+#define GPIOC (&sim_gpio_ports[2])
+#define GPIOD (&sim_gpio_ports[3])
+#define GPIOF (&sim_gpio_ports[5])
+
+    typedef struct
+    {
+        uint32_t Pin;
+        uint32_t Mode;
+        uint32_t Pull;
+        uint32_t Speed;
+        uint32_t Alternate;
+    } GPIO_InitTypeDef;
+
+    typedef enum
+    {
+        GPIO_PIN_RESET = 0U,
+        GPIO_PIN_SET
+    } GPIO_PinState;
+
+#define GPIO_PIN_0   ((uint16_t) 0x0001U)
+#define GPIO_PIN_1   ((uint16_t) 0x0002U)
+#define GPIO_PIN_2   ((uint16_t) 0x0004U)
+#define GPIO_PIN_3   ((uint16_t) 0x0008U)
+#define GPIO_PIN_4   ((uint16_t) 0x0010U)
+#define GPIO_PIN_5   ((uint16_t) 0x0020U)
+#define GPIO_PIN_6   ((uint16_t) 0x0040U)
+#define GPIO_PIN_7   ((uint16_t) 0x0080U)
+#define GPIO_PIN_8   ((uint16_t) 0x0100U)
+#define GPIO_PIN_9   ((uint16_t) 0x0200U)
+#define GPIO_PIN_10  ((uint16_t) 0x0400U)
+#define GPIO_PIN_11  ((uint16_t) 0x0800U)
+#define GPIO_PIN_12  ((uint16_t) 0x1000U)
+#define GPIO_PIN_13  ((uint16_t) 0x2000U)
+#define GPIO_PIN_14  ((uint16_t) 0x4000U)
+#define GPIO_PIN_15  ((uint16_t) 0x8000U)
+#define GPIO_PIN_All ((uint16_t) 0xFFFFU)
+
+#define GPIO_MODE_INPUT             0x00000000U
+#define GPIO_MODE_OUTPUT_PP         0x00000001U
+#define GPIO_MODE_OUTPUT_OD         0x00000011U
+#define GPIO_MODE_AF_PP             0x00000002U
+#define GPIO_MODE_AF_OD             0x00000012U
+#define GPIO_MODE_ANALOG            0x00000003U
+#define GPIO_MODE_IT_RISING         0x10110000U
+#define GPIO_MODE_IT_FALLING        0x10210000U
+#define GPIO_MODE_IT_RISING_FALLING 0x10310000U
+
+#define GPIO_NOPULL   0x00000000U
+#define GPIO_PULLUP   0x00000001U
+#define GPIO_PULLDOWN 0x00000002U
+
+#define GPIO_SPEED_FREQ_LOW    0x00000000U
+#define GPIO_SPEED_FREQ_MEDIUM 0x00000001U
+#define GPIO_SPEED_FREQ_HIGH   0x00000003U
+
+#define GPIO_AF1_USART1 ((uint8_t) 0x01U)
+#define GPIO_AF1_USART2 ((uint8_t) 0x01U)
+#define GPIO_AF1_I2C1   ((uint8_t) 0x01U)
+#define GPIO_AF1_I2C2   ((uint8_t) 0x01U)
+
+    void          HAL_GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_Init);
+    void          HAL_GPIO_DeInit(GPIO_TypeDef *GPIOx, uint32_t GPIO_Pin);
+    GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+    void          HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+    void          HAL_GPIO_TogglePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+    void          HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* ADC                                                                                                        */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+#define ADC_CHANNEL_0          0U
+#define ADC_CHANNEL_1          1U
+#define ADC_CHANNEL_2          2U
+#define ADC_CHANNEL_3          3U
+#define ADC_CHANNEL_4          4U
+#define ADC_CHANNEL_5          5U
+#define ADC_CHANNEL_6          6U
+#define ADC_CHANNEL_7          7U
+#define ADC_CHANNEL_8          8U
+#define ADC_CHANNEL_9          9U
+#define ADC_CHANNEL_10         10U
+#define ADC_CHANNEL_11         11U
+#define ADC_CHANNEL_12         12U
+#define ADC_CHANNEL_13         13U
+#define ADC_CHANNEL_14         14U
+#define ADC_CHANNEL_15         15U
+#define ADC_CHANNEL_TEMPSENSOR 16U
+#define ADC_CHANNEL_VREFINT    17U
+#define ADC_NUMBER_OF_CHANNELS 18U
+
+#define ADC_CLOCK_SYNC_PCLK_DIV4      0U
+#define ADC_RESOLUTION_12B            0U
+#define ADC_DATAALIGN_RIGHT           0U
+#define ADC_SCAN_DIRECTION_FORWARD    1U
+#define ADC_EOC_SINGLE_CONV           0U
+#define ADC_SOFTWARE_START            0U
+#define ADC_EXTERNALTRIGCONVEDGE_NONE 0U
+#define ADC_OVR_DATA_OVERWRITTEN      0U
+#define ADC_RANK_CHANNEL_NUMBER       0x00001000U
+#define ADC_SAMPLETIME_239CYCLES_5    7U
+
+    typedef struct
+    {
+        uint32_t dummy;
+    } ADC_TypeDef;
+
+    extern ADC_TypeDef sim_adc1;
+#define ADC1 (&sim_adc1)
+
+    typedef struct
+    {
+        uint32_t        ClockPrescaler;
+        uint32_t        Resolution;
+        uint32_t        DataAlign;
+        uint32_t        ScanConvMode;
+        uint32_t        EOCSelection;
+        FunctionalState LowPowerAutoWait;
+        FunctionalState LowPowerAutoPowerOff;
+        FunctionalState ContinuousConvMode;
+        FunctionalState DiscontinuousConvMode;
+        uint32_t        ExternalTrigConv;
+        uint32_t        ExternalTrigConvEdge;
+        FunctionalState DMAContinuousRequests;
+        uint32_t        Overrun;
+    } ADC_InitTypeDef;
+
+    typedef struct
+    {
+        ADC_TypeDef    *Instance;
+        ADC_InitTypeDef Init;
+        uint32_t        channels; // Bit mask of the configured channels
+        uint32_t        ErrorCode;
+    } ADC_HandleTypeDef;
+
+    typedef struct
+    {
+        uint32_t Channel;
+        uint32_t Rank;
+        uint32_t SamplingTime;
+    } ADC_ChannelConfTypeDef;
+
+    HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef *hadc);
+    HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef *hadc);
+    HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef *hadc, ADC_ChannelConfTypeDef *sConfig);
+    HAL_StatusTypeDef HAL_ADCEx_Calibration_Start(ADC_HandleTypeDef *hadc);
+    HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef *hadc);
+    HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef *hadc, uint32_t Timeout);
+    uint32_t          HAL_ADC_GetValue(ADC_HandleTypeDef *hadc);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* I2C: the handles only exist for the platform driver declarations, the buses are modelled in sim/bsp        */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef struct
+    {
+        void *Instance;
+    } I2C_HandleTypeDef;
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* FLASH: the virtual flash is mapped at FLASH_BASE and backed by a file                                      */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+#define FLASH_BASE      0x08000000UL
+#define FLASH_SIZE      (128U * 1024U)
+#define FLASH_PAGE_SIZE 0x800U
+
+#define FLASH_TYPEERASE_PAGES      0x00U
+#define FLASH_TYPEPROGRAM_HALFWORD 0x01U
+#define FLASH_TYPEPROGRAM_WORD     0x02U
+#define FLASH_LATENCY_1            0x01U
+
+    typedef struct
+    {
+        uint32_t TypeErase;
+        uint32_t PageAddress;
+        uint32_t NbPages;
+    } FLASH_EraseInitTypeDef;
+
+    HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+    HAL_StatusTypeDef HAL_FLASH_Lock(void);
+    HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data);
+    HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* PWR/RTC backup domain                                                                                      */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef struct
+    {
+        volatile uint32_t BKP0R;
+        volatile uint32_t BKP1R;
+        volatile uint32_t BKP2R;
+        volatile uint32_t BKP3R;
+        volatile uint32_t BKP4R;
+    } RTC_TypeDef;
+
+    extern RTC_TypeDef sim_rtc;
+#define RTC (&sim_rtc)
+
+    void HAL_PWR_EnableBkUpAccess(void);
+    void HAL_PWR_DisableBkUpAccess(void);
+
+#if defined(__cplusplus)
+}
+#endif
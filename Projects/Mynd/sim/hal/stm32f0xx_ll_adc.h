@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+ * LL ADC helpers used by the battery monitoring.
+ */
+
+#include <stdint.h>
+
+#define LL_ADC_RESOLUTION_12B 0x00000000U
+
+// Factory calibration of VREFINT at 3.3 V, read from the system memory on the device
+#define SIM_VREFINT_CAL 1526U
+
+#define __LL_ADC_CALC_VREFANALOG_VOLTAGE(__VREFINT_ADC_DATA__, __ADC_RESOLUTION__)                                     \
+    (((uint32_t) SIM_VREFINT_CAL * 3300U) / (uint32_t) (__VREFINT_ADC_DATA__))
@@ -0,0 +1,338 @@
+#include <cstdio>
+#include <cstdlib>
+#include <getopt.h>
+
+#include "board.h"
+#include "board_hw.h"
+#include "board_link.h"
+#include "bsp_bluetooth_uart.h"
+#include "bsp_debug_uart.h"
+#include "bsp_shared_i2c.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stream_buffer.h"
+#include "task_system.h"
+
+#include "logger.h"
+#include "external/teufel/libs/greeting/greeting.h"
+#include "external/teufel/libs/app_assert/app_assert.h"
+
+#include "actionslink_emulator.h"
+#include "sim_hal.h"
+#include "sim_models.h"
+
+#define TASK_LOGGER_STACK_SIZE 64
+static StaticTask_t logger_task_buffer;
+static StackType_t  logger_task_stack[TASK_LOGGER_STACK_SIZE];
+
+#define LOGGER_STORAGE_SIZE_BYTES 512
+static uint8_t              logger_sbuffer_storage[LOGGER_STORAGE_SIZE_BYTES];
+static StaticStreamBuffer_t LoggerStreamBufferStruct;
+
+static uint32_t s_duration_ms;
+
+static void print_bt_emulator_stats()
+{
+    actionslink_emulator_stats_t   stats;
+    actionslink_emulator_latency_t latencies[32];
+
+    actionslink_emulator_get_stats(&stats);
+    printf("[sim] BT emulator: %u requests/%u events from the MCU, %u requests/%u events to it, %u still pending\r\n",
+           static_cast<unsigned>(stats.requests_received), static_cast<unsigned>(stats.events_received),
+           static_cast<unsigned>(stats.requests_sent), static_cast<unsigned>(stats.events_sent),
+           static_cast<unsigned>(stats.requests_pending));
+    printf("[sim]   %u MCU retries, %u module retries, %u module failures, %u bad frames, %u/%u NACKs sent/received, "
+           "%u frames and %u ACKs dropped, %u CRCs corrupted\r\n",
+           static_cast<unsigned>(stats.mcu_retries), static_cast<unsigned>(stats.module_retries),
+           static_cast<unsigned>(stats.module_failures), static_cast<unsigned>(stats.bad_frames),
+           static_cast<unsigned>(stats.nacks_sent), static_cast<unsigned>(stats.nacks_received),
+           static_cast<unsigned>(stats.frames_dropped), static_cast<unsigned>(stats.acks_dropped),
+           static_cast<unsigned>(stats.crcs_corrupted));
+
+    // The tags are the field numbers of the requests in message.proto
+    const size_t count = actionslink_emulator_get_latencies(latencies, sizeof(latencies) / sizeof(latencies[0]));
+    for (size_t i = 0; i < count; i++)
+    {
+        const auto &latency = latencies[i];
+        char        tag[16] = "all";
+        if (latency.tag != 0)
+        {
+            snprintf(tag, sizeof(tag), "tag %u", static_cast<unsigned>(latency.tag));
+        }
+
+        printf("[sim]   %s %-7s %5u answered, p50 %4u ms, p90 %4u ms, p99 %4u ms, max %4u ms, %u retries\r\n",
+               latency.direction == ACTIONSLINK_EMULATOR_FROM_MCU ? "MCU requests   " : "module requests", tag,
+               static_cast<unsigned>(latency.count), static_cast<unsigned>(latency.p50_ms),
+               static_cast<unsigned>(latency.p90_ms), static_cast<unsigned>(latency.p99_ms),
+               static_cast<unsigned>(latency.max_ms), static_cast<unsigned>(latency.retries));
+    }
+}
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    int __io_putchar(int ch)
+    {
+        return putchar(ch);
+    }
+
+    void vApplicationIdleHook(void)
+    {
+        // "Low-power mode"
+        __WFI();
+    }
+
+    void vApplicationDaemonTaskStartupHook(void)
+    {
+        char buffer[24];
+
+        board_init();
+        bsp_debug_uart_init();
+
+        snprintf(buffer, sizeof(buffer), "MYND (rev%d)", read_hw_revision());
+
+        printf("\r\n\r\n\n");
+        PrintFirmwareInfo(buffer);
+    }
+
+    static StaticTask_t xIdleTaskTCBBuffer;
+    static StackType_t  xIdleStack[configMINIMAL_STACK_SIZE];
+
+    void vApplicationGetIdleTaskMemory(StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer,
+                                       uint32_t *pulIdleTaskStackSize)
+    {
+        *ppxIdleTaskTCBBuffer   = &xIdleTaskTCBBuffer;
+        *ppxIdleTaskStackBuffer = &xIdleStack[0];
+        *pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+    }
+
+    static StaticTask_t xTimerTaskTCBBuffer;
+    static StackType_t  xTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+    void vApplicationGetTimerTaskMemory(StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer,
+                                        uint32_t *pulTimerTaskStackSize)
+    {
+        *ppxTimerTaskTCBBuffer   = &xTimerTaskTCBBuffer;
+        *ppxTimerTaskStackBuffer = &xTimerStack[0];
+        *pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+    }
+
+    uint32_t logger_get_timestamp()
+    {
+        return get_systick();
+    }
+
+    void sim_request_exit(void)
+    {
+        i2c_rtos_stats_t           i2c_stats;
+        bsp_bluetooth_uart_stats_t uart_stats;
+        sim_bt_module_stats_t      bt_stats;
+        sim_flash_stats_t          flash_stats;
+
+        printf("\r\n[sim] Stopped after %u ms\r\n", static_cast<unsigned>(get_systick()));
+
+        if (bsp_shared_i2c_get_stats(&i2c_stats) == 0)
+        {
+            printf("[sim] Shared I2C: %u batches over %u ms\r\n", static_cast<unsigned>(i2c_stats.batches),
+                   static_cast<unsigned>(i2c_stats.elapsed_ms));
+            for (uint8_t i = 0; i < i2c_stats.number_of_devices; i++)
+            {
+                const auto &device = i2c_stats.devices[i];
+                printf("[sim]   0x%02X: %u transfers, %u bytes, %u errors, %u bus clocks\r\n", device.i2c_address,
+                       static_cast<unsigned>(device.transfers), static_cast<unsigned>(device.bytes),
+                       static_cast<unsigned>(device.errors), static_cast<unsigned>(device.bus_clocks));
+            }
+        }
+
+        for (uint8_t i2c_address : {TAS5825P_I2C_ADDRESS, TAS5805M_I2C_ADDRESS})
+        {
+            sim_tas58xx_stats_t amp_stats;
+            if (sim_tas58xx_get_stats(i2c_address, &amp_stats) == 0)
+            {
+                printf("[sim] Amp 0x%02X: %u register writes, %u reads, %u page and %u book changes\r\n", i2c_address,
+                       static_cast<unsigned>(amp_stats.register_writes),
+                       static_cast<unsigned>(amp_stats.register_reads), static_cast<unsigned>(amp_stats.page_changes),
+                       static_cast<unsigned>(amp_stats.book_changes));
+            }
+        }
+
+        bsp_bluetooth_uart_get_stats(&uart_stats);
+        sim_bt_module_get_stats(&bt_stats);
+        printf("[sim] BT UART: %u frames/%u bytes to the MCU, %u frames/%u bytes from it, %u RX events, %u bytes "
+               "dropped\r\n",
+               static_cast<unsigned>(bt_stats.rx_frames), static_cast<unsigned>(bt_stats.rx_bytes),
+               static_cast<unsigned>(bt_stats.tx_frames), static_cast<unsigned>(bt_stats.tx_bytes),
+               static_cast<unsigned>(uart_stats.rx_irq_count), static_cast<unsigned>(uart_stats.rx_dropped_bytes));
+
+        if (sim_bt_module_is_emulated())
+        {
+            print_bt_emulator_stats();
+        }
+
+        sim_flash_get_stats(&flash_stats);
+        printf("[sim] Flash: %u page erases, %u halfword programs, %u program errors\r\n",
+               static_cast<unsigned>(flash_stats.page_erases), static_cast<unsigned>(flash_stats.halfword_programs),
+               static_cast<unsigned>(flash_stats.program_errors));
+
+        fflush(stdout);
+        exit(EXIT_SUCCESS);
+    }
+
+#if defined(__cplusplus)
+}
+#endif
+
+static void print_usage(const char *p_name)
+{
+    printf("Usage: %s [options]\n"
+           "  --script <file>        scenario script (timed BT frames, buttons, GPIO and ADC levels)\n"
+           "  --flash <file>         virtual flash backing file, keeps the vEEPROM between runs\n"
+           "  --bt-tx-log <file>     writes the frames sent to the Bluetooth module\n"
+           "  --bt-emulator[=<seed>] emulated Bluetooth module, <seed> of its jitter (default 1)\n"
+           "  --duration-ms <ms>     stops the simulation and prints the statistics after <ms>\n"
+           "  --hw-revision <n>      board revision read from the HW_REVISION pin (default 5)\n",
+           p_name);
+}
+
+int main(int argc, char **argv)
+{
+    static const struct option options[] = {
+        {"script", required_argument, nullptr, 's'},      {"flash", required_argument, nullptr, 'f'},
+        {"bt-tx-log", required_argument, nullptr, 't'},   {"duration-ms", required_argument, nullptr, 'd'},
+        {"hw-revision", required_argument, nullptr, 'r'}, {"bt-emulator", optional_argument, nullptr, 'e'},
+        {"help", no_argument, nullptr, 'h'},              {nullptr, 0, nullptr, 0},
+    };
+
+    const char *p_script_path    = nullptr;
+    const char *p_flash_path     = nullptr;
+    const char *p_tx_log_path    = nullptr;
+    unsigned    hw_revision      = 5;
+    bool        is_bt_emulated   = false;
+    uint32_t    bt_emulator_seed = 1;
+
+    for (int option; (option = getopt_long(argc, argv, "h", options, nullptr)) != -1;)
+    {
+        switch (option)
+        {
+            case 's':
+                p_script_path = optarg;
+                break;
+            case 'f':
+                p_flash_path = optarg;
+                break;
+            case 't':
+                p_tx_log_path = optarg;
+                break;
+            case 'd':
+                s_duration_ms = static_cast<uint32_t>(strtoul(optarg, nullptr, 0));
+                break;
+            case 'r':
+                hw_revision = static_cast<unsigned>(strtoul(optarg, nullptr, 0));
+                break;
+            case 'e':
+                is_bt_emulated = true;
+                if (optarg != nullptr)
+                {
+                    bt_emulator_seed = static_cast<uint32_t>(strtoul(optarg, nullptr, 0));
+                }
+                break;
+            default:
+                print_usage(argv[0]);
+                return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    sim_hal_init(argc, argv);
+    if (sim_flash_open(p_flash_path) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    // The revision pins are divider voltages in steps of 0.3 V, see board_link_hw_revision.c
+    sim_adc_set_channel_mv(HW_REVISION_ADC_CHANNEL, 300u * hw_revision);
+    sim_adc_set_channel_mv(BT_VER_ADC_CHANNEL, 300u);
+    sim_adc_set_channel_mv(AMP_VER_ADC_CHANNEL, 300u);
+
+    // Charged battery (7.4 V behind its divider), NTC at room temperature and no current
+    sim_adc_set_channel_mv(BAT_VOLTAGE_ADC_CHANNEL, 7400u / 3u);
+    sim_adc_set_channel_mv(BAT_NTC2_ADC_CHANNEL, 1650u);
+    sim_adc_set_channel_mv(ISNS_REF_ADC_CHANNEL, 1650u);
+    sim_adc_set_channel_mv(ISENS_ADC_CHANNEL, 1650u);
+
+    sim_aw9523b_reset();
+    sim_irq_init();
+
+    if (p_script_path != nullptr && sim_script_load(p_script_path) != 0)
+    {
+        return EXIT_FAILURE;
+    }
+
+    if (p_tx_log_path != nullptr && sim_bt_module_open_tx_log(p_tx_log_path) != 0)
+    {
+        fprintf(stderr, "[sim] Can't open %s\n", p_tx_log_path);
+        return EXIT_FAILURE;
+    }
+
+    if (is_bt_emulated)
+    {
+        sim_bt_module_enable_emulator(bt_emulator_seed);
+    }
+
+    if (s_duration_ms != 0)
+    {
+        sim_irq_add_poll(
+            +[](uint32_t now_ms)
+            {
+                if (now_ms >= s_duration_ms)
+                {
+                    sim_request_exit();
+                }
+            });
+    }
+
+    // Call this function as early as possible, like on the device
+    read_hw_revision();
+
+    static auto sbuffer_logger_h = xStreamBufferCreateStatic(sizeof(logger_sbuffer_storage), 1u, logger_sbuffer_storage,
+                                                             &LoggerStreamBufferStruct);
+
+    logger_init(sbuffer_logger_h);
+
+    TaskHandle_t status = xTaskCreateStatic(
+        +[](void *)
+        {
+            for (;;)
+            {
+                if (uint8_t data; xStreamBufferReceive(sbuffer_logger_h, &data, 1, portMAX_DELAY) > 0)
+                {
+                    __io_putchar(data);
+                    if (data == '\n')
+                    {
+                        fflush(stdout);
+                    }
+                }
+            }
+        },
+        "Logger", TASK_LOGGER_STACK_SIZE, nullptr, 2, logger_task_stack, &logger_task_buffer);
+    APP_ASSERT(status);
+
+    Teufel::Task::System::start();
+    vTaskStartScheduler();
+
+    return EXIT_FAILURE;
+}
+
+void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin)
+{
+    switch (GPIO_Pin)
+    {
+        case IO_EXP_INT_GPIO_PIN:
+        {
+            board_link_io_expander_on_interrupt();
+            break;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#include <string.h>
+
+#include "board_hw.h"
+#include "sim_hal.h"
+#include "sim_models.h"
+
+#define REG_INPUT_PORT0    0x00u
+#define REG_INPUT_PORT1    0x01u
+#define REG_OUTPUT_PORT0   0x02u
+#define REG_CONFIG_PORT0   0x04u
+#define REG_INT_PORT0      0x06u
+#define REG_ID             0x10u
+#define REG_LED_MODE_PORT0 0x12u
+#define REG_SOFTWARE_RESET 0x7Fu
+#define NUMBER_OF_REGS     0x80u
+#define CHIP_ID            0x23u
+
+static struct
+{
+    uint8_t regs[NUMBER_OF_REGS];
+    uint8_t input_levels[2]; // Levels driven on the pins, the buttons pull their pin low
+    uint8_t latched_inputs[2];
+    bool    is_interrupt_pending;
+} s_aw9523b = {
+    .input_levels = {0xFF, 0xFF},
+};
+
+static void set_interrupt_line(bool asserted)
+{
+    s_aw9523b.is_interrupt_pending = asserted;
+
+    // The INT output is open drain and active low
+    sim_gpio_set_input(IO_EXP_INT_GPIO_PORT, IO_EXP_INT_GPIO_PIN, !asserted);
+}
+
+static uint8_t read_input_port(uint8_t port)
+{
+    // Pins configured as outputs read back the output register
+    uint8_t config = s_aw9523b.regs[REG_CONFIG_PORT0 + port];
+    uint8_t output = s_aw9523b.regs[REG_OUTPUT_PORT0 + port];
+
+    return (uint8_t) ((s_aw9523b.input_levels[port] & config) | (output & (uint8_t) ~config));
+}
+
+void sim_aw9523b_reset(void)
+{
+    memset(s_aw9523b.regs, 0, sizeof(s_aw9523b.regs));
+    s_aw9523b.regs[REG_LED_MODE_PORT0]      = 0xFF;
+    s_aw9523b.regs[REG_LED_MODE_PORT0 + 1u] = 0xFF;
+    s_aw9523b.latched_inputs[0]             = s_aw9523b.input_levels[0];
+    s_aw9523b.latched_inputs[1]             = s_aw9523b.input_levels[1];
+    set_interrupt_line(false);
+}
+
+int sim_aw9523b_write(uint8_t reg, const uint8_t *p_data, size_t length)
+{
+    if (reg + length > NUMBER_OF_REGS)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < length; i++, reg++)
+    {
+        if (reg == REG_SOFTWARE_RESET)
+        {
+            if (p_data[i] == 0x00u)
+            {
+                sim_aw9523b_reset();
+            }
+        }
+        else if (reg != REG_INPUT_PORT0 && reg != REG_INPUT_PORT1 && reg != REG_ID)
+        {
+            s_aw9523b.regs[reg] = p_data[i];
+        }
+    }
+
+    return 0;
+}
+
+int sim_aw9523b_read(uint8_t reg, uint8_t *p_data, size_t length)
+{
+    if (reg + length > NUMBER_OF_REGS)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < length; i++, reg++)
+    {
+        if (reg == REG_INPUT_PORT0 || reg == REG_INPUT_PORT1)
+        {
+            uint8_t port = reg - REG_INPUT_PORT0;
+
+            p_data[i]                      = read_input_port(port);
+            s_aw9523b.latched_inputs[port] = p_data[i];
+
+            // Reading the input registers releases the interrupt
+            if (s_aw9523b.is_interrupt_pending)
+            {
+                set_interrupt_line(false);
+            }
+        }
+        else if (reg == REG_ID)
+        {
+            p_data[i] = CHIP_ID;
+        }
+        else
+        {
+            p_data[i] = s_aw9523b.regs[reg];
+        }
+    }
+
+    return 0;
+}
+
+void sim_aw9523b_set_input(uint8_t port, uint8_t pin, bool level)
+{
+    if (port > 1 || pin > 7)
+    {
+        return;
+    }
+
+    uint8_t mask = (uint8_t) (1u << pin);
+
+    if (level)
+    {
+        s_aw9523b.input_levels[port] |= mask;
+    }
+    else
+    {
+        s_aw9523b.input_levels[port] &= (uint8_t) ~mask;
+    }
+
+    // Only inputs with their interrupt enabled (bit cleared) raise the INT line
+    bool is_input          = (s_aw9523b.regs[REG_CONFIG_PORT0 + port] & mask) != 0;
+    bool is_interrupt_on   = (s_aw9523b.regs[REG_INT_PORT0 + port] & mask) == 0;
+    bool has_level_changed = ((s_aw9523b.latched_inputs[port] ^ s_aw9523b.input_levels[port]) & mask) != 0;
+
+    if (is_input && is_interrupt_on && has_level_changed && !s_aw9523b.is_interrupt_pending)
+    {
+        set_interrupt_line(true);
+    }
+}
@@ -0,0 +1,216 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "actionslink_emulator.h"
+#include "board_hw.h"
+#include "sim_hal.h"
+#include "sim_models.h"
+
+#define HDLC_FRAME_DELIMITER 0x7Eu
+#define BAUDRATE             115200u
+#define BITS_PER_BYTE        10u // Start, 8 data and stop bits
+#define RX_FIFO_SIZE         4096u
+
+// Emulated module: time from the power on (or the reset release) to its system ready event, and its typical
+// processing times
+#define EMULATOR_BOOT_TIME_MS        1450u
+#define EMULATOR_ACK_LATENCY_MS      2u
+#define EMULATOR_RESPONSE_LATENCY_MS 20u
+
+static struct
+{
+    uint8_t               rx_fifo[RX_FIFO_SIZE]; // Bytes the module hasn't put on the wire yet
+    size_t                rx_head;
+    size_t                rx_count;
+    uint32_t              rx_credit_bits; // Bits the wire could carry since the last byte went out
+    size_t                tx_frame_length;
+    FILE                 *p_tx_log;
+    sim_bt_module_stats_t stats;
+    bool                  is_poll_registered;
+
+    bool                          is_emulated;
+    bool                          is_emulator_running; // Powered and out of reset
+    bool                          is_emulator_booting;
+    uint32_t                      emulator_boot_end_ms;
+    actionslink_emulator_config_t emulator_config;
+} s_bt;
+
+static uint32_t get_tick_ms(void)
+{
+    return (uint32_t) (xTaskGetTickCount() * portTICK_PERIOD_MS);
+}
+
+static void rx_poll(uint32_t now_ms)
+{
+    uint8_t chunk[BAUDRATE / BITS_PER_BYTE / 1000u + 1u];
+    size_t  length = 0;
+
+    if (s_bt.rx_count == 0)
+    {
+        s_bt.rx_credit_bits = 0;
+        return;
+    }
+
+    (void) now_ms;
+    s_bt.rx_credit_bits += BAUDRATE / 1000u;
+
+    // Every tick the UART gets the bytes that went over the wire meanwhile, as one RX event (the idle line or
+    // character match interrupt of the device)
+    while (s_bt.rx_count > 0 && s_bt.rx_credit_bits >= BITS_PER_BYTE && length < sizeof(chunk))
+    {
+        size_t tail = (s_bt.rx_head + RX_FIFO_SIZE - s_bt.rx_count) % RX_FIFO_SIZE;
+
+        chunk[length++] = s_bt.rx_fifo[tail];
+        s_bt.rx_count--;
+        s_bt.rx_credit_bits -= BITS_PER_BYTE;
+    }
+
+    sim_bluetooth_uart_receive(chunk, length);
+}
+
+static void emulator_poll(uint32_t now_ms)
+{
+    uint8_t chunk[64];
+    size_t  length;
+
+    const bool is_running = sim_gpio_get_output(BT_CTRL_3V3_GPIO_PORT, BT_CTRL_3V3_GPIO_PIN) &&
+                            !sim_gpio_get_output(BT_RESET_GPIO_PORT, BT_RESET_GPIO_PIN);
+
+    // Whatever was in flight is lost with the power or the reset, the module boots again
+    if (is_running && !s_bt.is_emulator_running)
+    {
+        actionslink_emulator_reset();
+        s_bt.is_emulator_booting  = true;
+        s_bt.emulator_boot_end_ms = now_ms + EMULATOR_BOOT_TIME_MS;
+    }
+    s_bt.is_emulator_running = is_running;
+
+    if (!is_running)
+    {
+        return;
+    }
+
+    if (s_bt.is_emulator_booting && (int32_t) (now_ms - s_bt.emulator_boot_end_ms) >= 0)
+    {
+        s_bt.is_emulator_booting = false;
+        actionslink_emulator_run("ready");
+    }
+
+    while ((length = actionslink_emulator_read_available(chunk, sizeof(chunk))) > 0)
+    {
+        sim_bt_module_send(chunk, length);
+    }
+}
+
+uint32_t sim_bt_module_wire_time_ms(size_t length)
+{
+    return (uint32_t) ((length * BITS_PER_BYTE * 1000u + BAUDRATE - 1u) / BAUDRATE);
+}
+
+void sim_bt_module_send(const uint8_t *p_data, size_t length)
+{
+    if (!s_bt.is_poll_registered)
+    {
+        sim_irq_add_poll(rx_poll);
+        s_bt.is_poll_registered = true;
+    }
+
+    for (size_t i = 0; i < length && s_bt.rx_count < RX_FIFO_SIZE; i++)
+    {
+        s_bt.rx_fifo[s_bt.rx_head] = p_data[i];
+        s_bt.rx_head               = (s_bt.rx_head + 1u) % RX_FIFO_SIZE;
+        s_bt.rx_count++;
+
+        if (p_data[i] == HDLC_FRAME_DELIMITER && i > 0)
+        {
+            s_bt.stats.rx_frames++;
+        }
+    }
+
+    s_bt.stats.rx_bytes += length;
+}
+
+void sim_bt_module_on_tx(const uint8_t *p_data, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        if (s_bt.p_tx_log != NULL && (s_bt.tx_frame_length == 0 || p_data[i] != HDLC_FRAME_DELIMITER))
+        {
+            if (s_bt.tx_frame_length == 0)
+            {
+                fprintf(s_bt.p_tx_log, "%u", (unsigned) (xTaskGetTickCount() * portTICK_PERIOD_MS));
+            }
+            fprintf(s_bt.p_tx_log, " %02X", p_data[i]);
+        }
+
+        // A delimiter closes the frame if there is something between it and the opening one
+        if (p_data[i] == HDLC_FRAME_DELIMITER && s_bt.tx_frame_length > 1)
+        {
+            s_bt.stats.tx_frames++;
+            s_bt.tx_frame_length = 0;
+
+            if (s_bt.p_tx_log != NULL)
+            {
+                fprintf(s_bt.p_tx_log, " %02X\n", p_data[i]);
+            }
+            continue;
+        }
+
+        s_bt.tx_frame_length = p_data[i] == HDLC_FRAME_DELIMITER ? 1u : s_bt.tx_frame_length + 1u;
+    }
+
+    s_bt.stats.tx_bytes += length;
+
+    // The emulator takes the bytes at most 255 at a time, like the write hook of the transport
+    if (s_bt.is_emulated && s_bt.is_emulator_running && !s_bt.is_emulator_booting)
+    {
+        taskENTER_CRITICAL();
+        for (size_t offset = 0; offset < length; offset += UINT8_MAX)
+        {
+            const size_t chunk = (length - offset < UINT8_MAX) ? length - offset : UINT8_MAX;
+            actionslink_emulator_write_buffer(&p_data[offset], (uint8_t) chunk, 0);
+        }
+        taskEXIT_CRITICAL();
+    }
+}
+
+void sim_bt_module_enable_emulator(uint32_t seed)
+{
+    s_bt.emulator_config.get_tick_ms_fn      = get_tick_ms;
+    s_bt.emulator_config.seed                = seed;
+    s_bt.emulator_config.ack_latency_ms      = EMULATOR_ACK_LATENCY_MS;
+    s_bt.emulator_config.response_latency_ms = EMULATOR_RESPONSE_LATENCY_MS;
+    actionslink_emulator_init(&s_bt.emulator_config);
+
+    s_bt.is_emulated = true;
+    sim_irq_add_poll(emulator_poll);
+}
+
+bool sim_bt_module_is_emulated(void)
+{
+    return s_bt.is_emulated;
+}
+
+int sim_bt_module_run_emulator(const char *p_command)
+{
+    return s_bt.is_emulated ? actionslink_emulator_run(p_command) : -1;
+}
+
+int sim_bt_module_open_tx_log(const char *path)
+{
+    s_bt.p_tx_log = fopen(path, "w");
+    return s_bt.p_tx_log != NULL ? 0 : -1;
+}
+
+void sim_bt_module_get_stats(sim_bt_module_stats_t *p_stats)
+{
+    *p_stats = s_bt.stats;
+
+    if (s_bt.p_tx_log != NULL)
+    {
+        fflush(s_bt.p_tx_log);
+    }
+}
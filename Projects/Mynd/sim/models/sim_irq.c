@@ -0,0 +1,47 @@
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include "sim_hal.h"
+#include "sim_models.h"
+
+#define SIM_IRQ_MAX_POLLS  8u
+#define SIM_IRQ_STACK_SIZE (configMINIMAL_STACK_SIZE * 4)
+
+static sim_irq_poll_fn_t s_polls[SIM_IRQ_MAX_POLLS];
+static size_t            s_number_of_polls;
+
+static StackType_t  s_irq_task_stack[SIM_IRQ_STACK_SIZE];
+static StaticTask_t s_irq_task_buffer;
+
+static void irq_task(void *p_arg)
+{
+    (void) p_arg;
+
+    TickType_t last_wake = xTaskGetTickCount();
+
+    for (;;)
+    {
+        vTaskDelayUntil(&last_wake, 1);
+
+        uint32_t now_ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+        for (size_t i = 0; i < s_number_of_polls; i++)
+        {
+            s_polls[i](now_ms);
+        }
+
+        // The device models only latch the edges, the EXTI handlers run here like the other interrupts
+        sim_gpio_process_exti();
+    }
+}
+
+void sim_irq_init(void)
+{
+    configASSERT(xTaskCreateStatic(irq_task, "SimIRQ", SIM_IRQ_STACK_SIZE, NULL, configMAX_PRIORITIES - 1,
+                                   s_irq_task_stack, &s_irq_task_buffer) != NULL);
+}
+
+void sim_irq_add_poll(sim_irq_poll_fn_t poll_fn)
+{
+    configASSERT(s_number_of_polls < SIM_IRQ_MAX_POLLS);
+    s_polls[s_number_of_polls++] = poll_fn;
+}
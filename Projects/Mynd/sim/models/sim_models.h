@@ -0,0 +1,156 @@
+#pragma once
+
+/*
+ * Models of the devices around the MCU. They are accessed by the bsp replacements in sim/bsp, the way the
+ * firmware accesses the real devices, and driven by the scenario script.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Simulated interrupt context                                                                                */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef void (*sim_irq_poll_fn_t)(uint32_t now_ms);
+
+    /**
+     * @brief Creates the task that runs the simulated interrupts. It has the highest priority, so like an interrupt
+     *        handler it can't be preempted by the firmware tasks.
+     * @note  Must be called before the scheduler is started.
+     */
+    void sim_irq_init(void);
+
+    /**
+     * @brief Registers a function called every tick from the simulated interrupt context, to raise the interrupts
+     *        of a peripheral or a device model.
+     */
+    void sim_irq_add_poll(sim_irq_poll_fn_t poll_fn);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Scenario script                                                                                            */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    /**
+     * @brief Loads the timed events of a scenario script, see sim/README.md for the format.
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int sim_script_load(const char *path);
+
+    /**
+     * @brief Prints the statistics of the run and ends the simulation (implemented by main.cpp).
+     */
+    void sim_request_exit(void);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* TAS5825P and TAS5805M amplifiers (shared I2C bus)                                                          */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef struct
+    {
+        uint32_t register_writes;
+        uint32_t register_reads;
+        uint32_t page_changes; // Writes to the page register
+        uint32_t book_changes; // Writes to the book register
+    } sim_tas58xx_stats_t;
+
+    bool sim_tas58xx_is_present(uint8_t i2c_address);
+    int  sim_tas58xx_write(uint8_t i2c_address, uint8_t reg, const uint8_t *p_data, size_t length);
+    int  sim_tas58xx_read(uint8_t i2c_address, uint8_t reg, uint8_t *p_data, size_t length);
+    int  sim_tas58xx_get_stats(uint8_t i2c_address, sim_tas58xx_stats_t *p_stats);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* AW9523B IO expander (shared I2C bus)                                                                       */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    int  sim_aw9523b_write(uint8_t reg, const uint8_t *p_data, size_t length);
+    int  sim_aw9523b_read(uint8_t reg, uint8_t *p_data, size_t length);
+    void sim_aw9523b_reset(void);
+
+    /**
+     * @brief Drives an input of the IO expander (the buttons are active low). The INT line goes low if the pin is
+     *        an input with its interrupt enabled, until the input registers are read.
+     */
+    void sim_aw9523b_set_input(uint8_t port, uint8_t pin, bool level);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* TPS25751 USB PD controller (USB PD I2C bus) and the BQ25713 charger behind it                              */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    int  sim_tps25751_write(uint8_t reg, const uint8_t *p_data, size_t length);
+    int  sim_tps25751_read(uint8_t reg, uint8_t *p_data, size_t length);
+    void sim_bq25713_set_battery_mv(uint32_t mv);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Actions Bluetooth module (Bluetooth UART)                                                                  */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    typedef struct
+    {
+        uint32_t rx_frames; // Frames sent to the MCU
+        uint32_t rx_bytes;
+        uint32_t tx_frames; // Frames received from the MCU
+        uint32_t tx_bytes;
+    } sim_bt_module_stats_t;
+
+    /**
+     * @brief Queues bytes sent by the module to the MCU. They reach the UART at the 115200 baud wire speed.
+     */
+    void sim_bt_module_send(const uint8_t *p_data, size_t length);
+
+    /**
+     * @brief Called by the UART with the bytes sent by the MCU.
+     */
+    void sim_bt_module_on_tx(const uint8_t *p_data, size_t length);
+
+    /**
+     * @brief Writes the frames sent by the MCU to a file, one line per frame with its timestamp.
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int sim_bt_module_open_tx_log(const char *path);
+
+    void sim_bt_module_get_stats(sim_bt_module_stats_t *p_stats);
+
+    /**
+     * @brief Time on the UART wire of a number of bytes, in ms (rounded up).
+     */
+    uint32_t sim_bt_module_wire_time_ms(size_t length);
+
+    /**
+     * @brief Answers the MCU with the actionslink emulator instead of the script frames alone. The emulated module
+     *        boots when it is powered and out of reset, and sends its system ready event.
+     * @note  Must be called before the scheduler is started.
+     *
+     * @param[in] seed      seed of the jitter of the emulator
+     */
+    void sim_bt_module_enable_emulator(uint32_t seed);
+
+    bool sim_bt_module_is_emulated(void);
+
+    /**
+     * @brief Runs a scenario command of the emulator, see actionslink_emulator_run().
+     *
+     * @return 0 if successful, -1 if the command is invalid or the emulator isn't enabled
+     */
+    int sim_bt_module_run_emulator(const char *p_command);
+
+    /* ---------------------------------------------------------------------------------------------------------- */
+    /* Hooks of the bsp replacements                                                                              */
+    /* ---------------------------------------------------------------------------------------------------------- */
+
+    /**
+     * @brief Feeds bytes received by the Bluetooth UART, from the simulated interrupt context.
+     */
+    void sim_bluetooth_uart_receive(const uint8_t *p_data, size_t length);
+
+#if defined(__cplusplus)
+}
+#endif
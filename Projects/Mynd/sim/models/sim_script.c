@@ -0,0 +1,235 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "board_hw.h"
+#include "sim_hal.h"
+#include "sim_models.h"
+
+/*
+ * A scenario script is a list of timed events, one per line: "<time_ms> <command> <arguments>", with the times
+ * counted from the start of the scheduler and in increasing order. Everything after a '#' is a comment.
+ */
+
+#define MAX_LINE_LENGTH  1024u
+#define MAX_FRAME_LENGTH 256u
+
+// Resistor divider between the battery and its ADC input
+#define BAT_VOLTAGE_DIVIDER_RATIO 3u
+
+typedef struct
+{
+    uint32_t time_ms;
+    char    *p_command; // Command and its arguments
+} event_t;
+
+static event_t *s_events;
+static size_t   s_number_of_events;
+static size_t   s_next_event;
+
+static const struct
+{
+    const char *name;
+    uint8_t     pin;
+} buttons[] = {
+    // IO expander port 0 pins, see board_link_io_expander.c
+    {"bt", 2},
+    {"play", 3},
+    {"minus", 4},
+    {"plus", 5},
+};
+
+static GPIO_TypeDef *get_port(char name)
+{
+    switch (toupper((unsigned char) name))
+    {
+        case 'A':
+            return GPIOA;
+        case 'B':
+            return GPIOB;
+        case 'C':
+            return GPIOC;
+        case 'D':
+            return GPIOD;
+        case 'F':
+            return GPIOF;
+        default:
+            return NULL;
+    }
+}
+
+static int run_bt(const char *p_args)
+{
+    uint8_t  frame[MAX_FRAME_LENGTH];
+    size_t   length = 0;
+    unsigned byte;
+    int      consumed;
+
+    while (length < sizeof(frame) && sscanf(p_args, " %2x%n", &byte, &consumed) == 1)
+    {
+        frame[length++] = (uint8_t) byte;
+        p_args += consumed;
+    }
+
+    sim_bt_module_send(frame, length);
+    return length > 0 ? 0 : -1;
+}
+
+static int run_button(const char *p_args)
+{
+    char name[16], action[16];
+
+    if (sscanf(p_args, "%15s %15s", name, action) != 2)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < sizeof(buttons) / sizeof(buttons[0]); i++)
+    {
+        if (strcmp(name, buttons[i].name) == 0)
+        {
+            // The buttons pull their pin low while pressed
+            sim_aw9523b_set_input(0, buttons[i].pin, strcmp(action, "press") != 0);
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+static int run_event(char *p_command)
+{
+    char     name[16];
+    int      consumed;
+    unsigned a, b, c;
+    char     port;
+
+    if (sscanf(p_command, "%15s%n", name, &consumed) != 1)
+    {
+        return -1;
+    }
+
+    const char *p_args = p_command + consumed;
+
+    if (strcmp(name, "bt") == 0)
+    {
+        return run_bt(p_args);
+    }
+
+    if (strcmp(name, "button") == 0)
+    {
+        return run_button(p_args);
+    }
+
+    if (strcmp(name, "btemu") == 0)
+    {
+        return sim_bt_module_run_emulator(p_args);
+    }
+
+    if (strcmp(name, "ioexp") == 0 && sscanf(p_args, "%u %u %u", &a, &b, &c) == 3)
+    {
+        sim_aw9523b_set_input((uint8_t) a, (uint8_t) b, c != 0);
+        return 0;
+    }
+
+    if (strcmp(name, "gpio") == 0 && sscanf(p_args, " %c%u %u", &port, &a, &b) == 3 && get_port(port) != NULL &&
+        a < 16)
+    {
+        sim_gpio_set_input(get_port(port), (uint16_t) (1u << a), b != 0);
+        return 0;
+    }
+
+    if (strcmp(name, "adc") == 0 && sscanf(p_args, "%u %u", &a, &b) == 2)
+    {
+        sim_adc_set_channel_mv(a, b);
+        return 0;
+    }
+
+    if (strcmp(name, "vbat") == 0 && sscanf(p_args, "%u", &a) == 1)
+    {
+        sim_adc_set_channel_mv(BAT_VOLTAGE_ADC_CHANNEL, a / BAT_VOLTAGE_DIVIDER_RATIO);
+        sim_bq25713_set_battery_mv(a);
+        return 0;
+    }
+
+    if (strcmp(name, "exit") == 0)
+    {
+        sim_request_exit();
+        return 0;
+    }
+
+    return -1;
+}
+
+static void script_poll(uint32_t now_ms)
+{
+    while (s_next_event < s_number_of_events && s_events[s_next_event].time_ms <= now_ms)
+    {
+        event_t *p_event = &s_events[s_next_event++];
+
+        if (run_event(p_event->p_command) != 0)
+        {
+            fprintf(stderr, "[sim] Invalid script event at %u ms: %s\n", (unsigned) p_event->time_ms,
+                    p_event->p_command);
+        }
+    }
+}
+
+int sim_script_load(const char *path)
+{
+    char     line[MAX_LINE_LENGTH];
+    unsigned line_number = 0;
+    uint32_t last_time   = 0;
+    FILE    *p_file      = fopen(path, "r");
+
+    if (p_file == NULL)
+    {
+        fprintf(stderr, "[sim] Can't open the script %s\n", path);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), p_file) != NULL)
+    {
+        unsigned long time_ms;
+        int           consumed;
+
+        line_number++;
+        line[strcspn(line, "#\r\n")] = '\0';
+
+        if (sscanf(line, "%lu%n", &time_ms, &consumed) != 1)
+        {
+            if (strspn(line, " \t") != strlen(line))
+            {
+                fprintf(stderr, "[sim] %s:%u: missing time\n", path, line_number);
+                fclose(p_file);
+                return -1;
+            }
+            continue;
+        }
+
+        if (time_ms < last_time)
+        {
+            fprintf(stderr, "[sim] %s:%u: events must be in chronological order\n", path, line_number);
+            fclose(p_file);
+            return -1;
+        }
+
+        event_t *p_events = realloc(s_events, (s_number_of_events + 1u) * sizeof(event_t));
+        if (p_events == NULL)
+        {
+            fclose(p_file);
+            return -1;
+        }
+
+        s_events                               = p_events;
+        s_events[s_number_of_events].time_ms   = (uint32_t) time_ms;
+        s_events[s_number_of_events].p_command = strdup(line + consumed);
+        s_number_of_events++;
+        last_time = (uint32_t) time_ms;
+    }
+
+    fclose(p_file);
+    sim_irq_add_poll(script_poll);
+    return 0;
+}
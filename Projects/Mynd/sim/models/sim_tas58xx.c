@@ -0,0 +1,207 @@
+#include <string.h>
+
+#include "board_hw.h"
+#include "sim_models.h"
+
+/*
+ * Register map of the TAS5825P/TAS5805M: 128 registers per page, 256 pages per book. Register 0x00 of every page
+ * selects the page and register 0x7F of page 0 selects the book. Only the pages the firmware writes are allocated.
+ */
+
+#define REG_PAGE              0x00u
+#define REG_RESET_CTRL        0x01u
+#define REG_DEVICE_CTRL_2     0x03u
+#define REG_PAGE_AUTO_INC     0x0Fu
+#define REG_POWER_STATE       0x68u
+#define REG_BOOK              0x7Fu
+#define PAGE_SIZE             128u
+#define FIRST_COEFFICIENT     0x08u // First register of a page after a page auto-increment
+#define MAX_PAGES_PER_AMP     96u
+#define RESET_CTRL_RST_REG    0x10u
+#define PAGE_AUTO_INC_DISABLE 0x08u
+
+typedef struct
+{
+    uint8_t book;
+    uint8_t page;
+    uint8_t regs[PAGE_SIZE];
+} page_t;
+
+typedef struct
+{
+    uint8_t             i2c_address;
+    uint8_t             book;
+    uint8_t             page;
+    size_t              number_of_pages;
+    page_t              pages[MAX_PAGES_PER_AMP];
+    sim_tas58xx_stats_t stats;
+} amp_t;
+
+static amp_t s_amps[] = {
+    {.i2c_address = TAS5825P_I2C_ADDRESS},
+    {.i2c_address = TAS5805M_I2C_ADDRESS},
+};
+
+static amp_t *get_amp(uint8_t i2c_address)
+{
+    for (size_t i = 0; i < sizeof(s_amps) / sizeof(s_amps[0]); i++)
+    {
+        if (s_amps[i].i2c_address == i2c_address)
+        {
+            return &s_amps[i];
+        }
+    }
+
+    return NULL;
+}
+
+static page_t *get_page(amp_t *p_amp, uint8_t book, uint8_t page, bool allocate)
+{
+    for (size_t i = 0; i < p_amp->number_of_pages; i++)
+    {
+        if (p_amp->pages[i].book == book && p_amp->pages[i].page == page)
+        {
+            return &p_amp->pages[i];
+        }
+    }
+
+    if (!allocate || p_amp->number_of_pages == MAX_PAGES_PER_AMP)
+    {
+        return NULL;
+    }
+
+    page_t *p_page = &p_amp->pages[p_amp->number_of_pages++];
+    p_page->book   = book;
+    p_page->page   = page;
+    memset(p_page->regs, 0, sizeof(p_page->regs));
+    return p_page;
+}
+
+static uint8_t read_reg(amp_t *p_amp, uint8_t book, uint8_t page, uint8_t reg)
+{
+    page_t *p_page = get_page(p_amp, book, page, false);
+    return p_page != NULL ? p_page->regs[reg] : 0;
+}
+
+static void reset_registers(amp_t *p_amp)
+{
+    p_amp->book            = 0;
+    p_amp->page            = 0;
+    p_amp->number_of_pages = 0;
+}
+
+static int write_reg(amp_t *p_amp, uint8_t reg, uint8_t value)
+{
+    if (reg == REG_PAGE)
+    {
+        p_amp->page = value;
+        p_amp->stats.page_changes++;
+        return 0;
+    }
+
+    if (reg == REG_BOOK && p_amp->page == 0)
+    {
+        p_amp->book = value;
+        p_amp->stats.book_changes++;
+        return 0;
+    }
+
+    if (p_amp->book == 0 && p_amp->page == 0 && reg == REG_RESET_CTRL && (value & RESET_CTRL_RST_REG))
+    {
+        reset_registers(p_amp);
+        return 0;
+    }
+
+    page_t *p_page = get_page(p_amp, p_amp->book, p_amp->page, true);
+    if (p_page == NULL)
+    {
+        return -1;
+    }
+
+    p_page->regs[reg] = value;
+    return 0;
+}
+
+bool sim_tas58xx_is_present(uint8_t i2c_address)
+{
+    return get_amp(i2c_address) != NULL;
+}
+
+int sim_tas58xx_write(uint8_t i2c_address, uint8_t reg, const uint8_t *p_data, size_t length)
+{
+    amp_t *p_amp = get_amp(i2c_address);
+    if (p_amp == NULL || reg >= PAGE_SIZE)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < length; i++)
+    {
+        if (write_reg(p_amp, reg, p_data[i]) != 0)
+        {
+            return -1;
+        }
+
+        p_amp->stats.register_writes++;
+
+        // Bursts continue on the coefficients of the next page, unless the page auto-increment is disabled
+        if (++reg == PAGE_SIZE)
+        {
+            if (read_reg(p_amp, 0, 0, REG_PAGE_AUTO_INC) & PAGE_AUTO_INC_DISABLE)
+            {
+                return i + 1 == length ? 0 : -1;
+            }
+
+            p_amp->page++;
+            reg = FIRST_COEFFICIENT;
+        }
+    }
+
+    return 0;
+}
+
+int sim_tas58xx_read(uint8_t i2c_address, uint8_t reg, uint8_t *p_data, size_t length)
+{
+    amp_t *p_amp = get_amp(i2c_address);
+    if (p_amp == NULL || reg + length > PAGE_SIZE)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < length; i++, reg++)
+    {
+        if (reg == REG_PAGE)
+        {
+            p_data[i] = p_amp->page;
+        }
+        else if (reg == REG_BOOK && p_amp->page == 0)
+        {
+            p_data[i] = p_amp->book;
+        }
+        else if (reg == REG_POWER_STATE && p_amp->book == 0 && p_amp->page == 0)
+        {
+            // The amplifier reaches the state requested in DEVICE_CTRL_2 immediately, and never reports a fault
+            p_data[i] = read_reg(p_amp, 0, 0, REG_DEVICE_CTRL_2) & 0x03u;
+        }
+        else
+        {
+            p_data[i] = read_reg(p_amp, p_amp->book, p_amp->page, reg);
+        }
+
+        p_amp->stats.register_reads++;
+    }
+
+    return 0;
+}
+
+int sim_tas58xx_get_stats(uint8_t i2c_address, sim_tas58xx_stats_t *p_stats)
+{
+    amp_t *p_amp = get_amp(i2c_address);
+    if (p_amp == NULL)
+    {
+        return -1;
+    }
+
+    *p_stats = p_amp->stats;
+    return 0;
+}
@@ -0,0 +1,204 @@
+#include <string.h>
+
+#include "board_hw.h"
+#include "sim_models.h"
+
+/*
+ * The TPS25751 registers are read and written with a leading byte count. 4CC commands written to CMD1 take their
+ * input from DATA1 and leave their output there, they complete immediately. The I2Cr/I2Cw commands reach the
+ * BQ25713 charger on the I2C controller bus of the TPS25751, FLrd/FLad/FLwd its configuration EEPROM.
+ */
+
+#define REG_MODE          0x03u
+#define REG_CMD1          0x08u
+#define REG_DATA1         0x09u
+#define NUMBER_OF_REGS    0x100u
+#define MAX_REG_SIZE      64u
+#define EEPROM_SIZE       (32u * 1024u)
+#define EEPROM_READ_SIZE  16u
+#define BQ25713_REGS      0x40u
+#define BQ25713_ADC_VBAT  0x2Cu
+#define BQ25713_ADC_VSYS  0x2Du
+#define BQ25713_MANUF_ID  0x2Eu
+#define BQ25713_DEVICE_ID 0x2Fu
+
+typedef struct
+{
+    uint8_t length;
+    uint8_t data[MAX_REG_SIZE];
+} reg_t;
+
+static struct
+{
+    reg_t    regs[NUMBER_OF_REGS];
+    uint8_t  eeprom[EEPROM_SIZE];
+    uint16_t eeprom_address;
+    uint8_t  charger_regs[BQ25713_REGS];
+    bool     is_initialized;
+} s_tps25751;
+
+static void set_reg(uint8_t reg, const void *p_data, size_t length)
+{
+    memcpy(s_tps25751.regs[reg].data, p_data, length);
+    s_tps25751.regs[reg].length = (uint8_t) length;
+}
+
+static void init(void)
+{
+    set_reg(REG_MODE, "APP ", 4);
+    memset(s_tps25751.eeprom, 0xFF, sizeof(s_tps25751.eeprom));
+
+    s_tps25751.charger_regs[BQ25713_MANUF_ID]  = 0x40;
+    s_tps25751.charger_regs[BQ25713_DEVICE_ID] = 0x88;
+    sim_bq25713_set_battery_mv(7400);
+
+    s_tps25751.is_initialized = true;
+}
+
+void sim_bq25713_set_battery_mv(uint32_t mv)
+{
+    uint32_t code = mv > 2880u ? (mv - 2880u) / 64u : 0u;
+
+    s_tps25751.charger_regs[BQ25713_ADC_VBAT] = (uint8_t) (code > 0xFFu ? 0xFFu : code);
+    s_tps25751.charger_regs[BQ25713_ADC_VSYS] = s_tps25751.charger_regs[BQ25713_ADC_VBAT];
+}
+
+static bool execute_charger_read(const uint8_t *p_input)
+{
+    uint8_t i2c_address = p_input[0], reg = p_input[1], length = p_input[2];
+    uint8_t output[1 + MAX_REG_SIZE - 1] = {0};
+
+    if (i2c_address != BQ25713_I2C_ADDRESS || reg + length > BQ25713_REGS || length >= MAX_REG_SIZE)
+    {
+        output[0] = 1; // The target didn't acknowledge
+        set_reg(REG_DATA1, output, 1);
+        return true;
+    }
+
+    memcpy(&output[1], &s_tps25751.charger_regs[reg], length);
+    set_reg(REG_DATA1, output, 1u + length);
+    return true;
+}
+
+static bool execute_charger_write(const uint8_t *p_input)
+{
+    // Input: target address, number of bytes (register address included), register address, data
+    uint8_t i2c_address = p_input[0], length = p_input[1], reg = p_input[2];
+    uint8_t result      = 0;
+
+    if (i2c_address != BQ25713_I2C_ADDRESS || length == 0 || reg + length - 1u > BQ25713_REGS)
+    {
+        result = 1;
+    }
+    else
+    {
+        memcpy(&s_tps25751.charger_regs[reg], &p_input[3], length - 1u);
+    }
+
+    set_reg(REG_DATA1, &result, 1);
+    return true;
+}
+
+static bool execute_command(const char *command)
+{
+    const uint8_t *p_input = s_tps25751.regs[REG_DATA1].data;
+    uint8_t        result  = 0;
+
+    if (memcmp(command, "I2Cr", 4) == 0)
+    {
+        return execute_charger_read(p_input);
+    }
+
+    if (memcmp(command, "I2Cw", 4) == 0)
+    {
+        return execute_charger_write(p_input);
+    }
+
+    if (memcmp(command, "FLrd", 4) == 0)
+    {
+        uint16_t address = (uint16_t) (p_input[0] | (p_input[1] << 8)) % EEPROM_SIZE;
+        uint8_t  output[EEPROM_READ_SIZE];
+
+        for (size_t i = 0; i < sizeof(output); i++)
+        {
+            output[i] = s_tps25751.eeprom[(address + i) % EEPROM_SIZE];
+        }
+        set_reg(REG_DATA1, output, sizeof(output));
+        return true;
+    }
+
+    if (memcmp(command, "FLad", 4) == 0)
+    {
+        s_tps25751.eeprom_address = (uint16_t) (p_input[0] | (p_input[1] << 8)) % EEPROM_SIZE;
+        set_reg(REG_DATA1, &result, 1);
+        return true;
+    }
+
+    if (memcmp(command, "FLwd", 4) == 0)
+    {
+        for (size_t i = 0; i < s_tps25751.regs[REG_DATA1].length; i++)
+        {
+            s_tps25751.eeprom[s_tps25751.eeprom_address] = p_input[i];
+            s_tps25751.eeprom_address                    = (s_tps25751.eeprom_address + 1u) % EEPROM_SIZE;
+        }
+        set_reg(REG_DATA1, &result, 1);
+        return true;
+    }
+
+    // Commands without a simulated effect, the USB-C port stays unplugged
+    static const char *const accepted_commands[] = {"DBfg", "SWSr", "SSrC", "GSrC", "GO2P", "PBMs", "PBMe", "PBMc"};
+    for (size_t i = 0; i < sizeof(accepted_commands) / sizeof(accepted_commands[0]); i++)
+    {
+        if (memcmp(command, accepted_commands[i], 4) == 0)
+        {
+            set_reg(REG_DATA1, &result, 1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int sim_tps25751_write(uint8_t reg, const uint8_t *p_data, size_t length)
+{
+    if (!s_tps25751.is_initialized)
+    {
+        init();
+    }
+
+    // The first byte is the number of bytes that follow
+    if (length < 1 || p_data[0] > MAX_REG_SIZE || p_data[0] > length - 1u)
+    {
+        return -1;
+    }
+
+    set_reg(reg, &p_data[1], p_data[0]);
+
+    if (reg == REG_CMD1)
+    {
+        bool is_done = p_data[0] == 4 && execute_command((const char *) &p_data[1]);
+        set_reg(REG_CMD1, is_done ? "\0\0\0\0" : "!CMD", 4);
+    }
+
+    return 0;
+}
+
+int sim_tps25751_read(uint8_t reg, uint8_t *p_data, size_t length)
+{
+    if (!s_tps25751.is_initialized)
+    {
+        init();
+    }
+
+    if (length < 1 || length - 1u > MAX_REG_SIZE)
+    {
+        return -1;
+    }
+
+    // Registers that were never written read as zeros of the requested size
+    const reg_t *p_reg = &s_tps25751.regs[reg];
+    p_data[0]          = (uint8_t) (length - 1u);
+    memset(&p_data[1], 0, length - 1u);
+    memcpy(&p_data[1], p_reg->data, p_reg->length < length - 1u ? p_reg->length : length - 1u);
+    return 0;
+}
@@ -6,7 +6,8 @@ extern uint32_t SystemCoreClock;
 #define portREMOVE_STATIC_QUALIFIER
 
 #define configUSE_PREEMPTION                  1
-#define configUSE_TICKLESS_IDLE               0
+#define configUSE_TICKLESS_IDLE               2 // vPortSuppressTicksAndSleep() is in bsp_low_power.c
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP 2
 #define configSUPPORT_STATIC_ALLOCATION       1
 #define configSUPPORT_DYNAMIC_ALLOCATION      0
 #define configCPU_CLOCK_HZ                    (SystemCoreClock)
@@ -31,9 +32,27 @@ extern uint32_t SystemCoreClock;
 #define configUSE_DAEMON_TASK_STARTUP_HOOK 1
 
 #define configUSE_STATS_FORMATTING_FUNCTIONS 0
-#define configGENERATE_RUN_TIME_STATS        0
 
-#define configUSE_TRACE_FACILITY 0
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+// Profiling builds: run time per task counted by TIM2 in microseconds, `top` shell command
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+    void     board_run_time_counter_init(void);
+    uint32_t board_get_run_time_counter(void);
+#ifdef __cplusplus
+}
+#endif
+
+#define configGENERATE_RUN_TIME_STATS            1
+#define configUSE_TRACE_FACILITY                 1
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() board_run_time_counter_init()
+#define portGET_RUN_TIME_COUNTER_VALUE()         board_get_run_time_counter()
+#else
+#define configGENERATE_RUN_TIME_STATS 0
+#define configUSE_TRACE_FACILITY      0
+#endif
 
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES           0
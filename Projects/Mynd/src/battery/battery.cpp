@@ -1,7 +1,8 @@
 
 // Due to the flash size limit, only the WARNING level is available
-// for use in the complete firmware (including the bootloader).
-#if defined(BOOTLOADER)
+// for use in the complete firmware (including the bootloader),
+// unless the binary logger keeps the format strings out of the flash.
+#if defined(BOOTLOADER) && !defined(LOGGER_BINARY)
 #define LOG_LEVEL LOG_LEVEL_WARNING
 #else
 #define LOG_LEVEL LOG_LEVEL_INFO
@@ -75,7 +76,19 @@ PROPERTY_ENUM_SET(Tus::ChargeType, m_charge_type)
 // because the ADC is configured to 12 bits resolution
 static uint16_t __attribute__((aligned(4))) s_adc_buffer[12 * 6];
 
-static float              calculate_battery_current_milliamps(uint32_t vcc_mv, int32_t isns_ref, int32_t isns);
+constexpr auto c_adc_number_of_samples_per_conversion = 12u;
+constexpr auto c_adc_number_of_sampled_channels       = 6u;
+constexpr auto c_adc_buffer_size = c_adc_number_of_samples_per_conversion * c_adc_number_of_sampled_channels;
+
+static_assert(c_adc_buffer_size <= sizeof(s_adc_buffer) / sizeof(uint16_t),
+              "s_adc_buffer is too small to hold the samples");
+
+// While the STOP mode may be entered the ADC converts one buffer per SoC sample, it would keep the MCU out of it
+static volatile bool s_is_adc_one_shot = false;
+static volatile bool s_is_adc_paused   = false;
+
+static void start_adc();
+
 static std::optional<int> get_battery_current();
 
 static SemaphoreHandle_t sys_adc_buffer_mutex = nullptr;
@@ -129,6 +142,25 @@ static EWMA<4, uint32_t> vrefint_smoother{};
 static uint32_t adc_conv_time_ms;
 static uint32_t battery_current_processing_time_ms;
 
+struct CycleStats
+{
+    uint32_t calls;
+    uint64_t cycles;
+    uint32_t max_cycles;
+};
+
+// Cycles of poll() and of the SoC timer, see the `soc stats` shell command
+static CycleStats s_poll_stats;
+static CycleStats s_soc_sample_stats;
+
+static void add_cycles(CycleStats &stats, uint32_t start)
+{
+    uint32_t cycles = board_get_cycle_count() - start;
+    stats.calls++;
+    stats.cycles += cycles;
+    stats.max_cycles = std::max(stats.max_cycles, cycles);
+}
+
 static SocEstimator soc_estimator{};
 
 void init()
@@ -137,7 +169,14 @@ void init()
         "SoC", pdMS_TO_TICKS(10), pdTRUE, 0,
         +[](TimerHandle_t /*xTimer*/)
         {
+            if (s_is_adc_paused)
+            {
+                s_is_adc_paused = false;
+                start_adc();
+            }
+
             static uint32_t last_soc_processing;
+            uint32_t        start              = board_get_cycle_count();
             auto            battery_current_ma = get_battery_current().value_or(0);
 #if defined(BATTERY_DEBUG)
             if (mocking_battery_current != INT32_MAX)
@@ -147,6 +186,7 @@ void init()
 #endif
             soc_estimator.add_sample(s_battery.last_battery_voltage_mv, battery_current_ma);
             s_battery.last_battery_current = battery_current_ma;
+            add_cycles(s_soc_sample_stats, start);
 
             battery_current_processing_time_ms = get_systick() - last_soc_processing;
             last_soc_processing                = get_systick();
@@ -155,13 +195,6 @@ void init()
 
     xTimerStart(soc_timer, 0);
 
-    constexpr auto c_adc_number_of_samples_per_conversion = 12u;
-    static auto    adc_number_of_sampled_channels         = 6u;
-    static auto    adc_buffer_size = c_adc_number_of_samples_per_conversion * adc_number_of_sampled_channels;
-
-    APP_ASSERT(adc_buffer_size <= sizeof(s_adc_buffer) / sizeof(uint16_t),
-               "s_adc_buffer is too small to hold the samples");
-
     sys_adc_buffer_mutex = xSemaphoreCreateMutexStatic(&sys_adc_buffer_mutex_buffer);
 
     APP_ASSERT(sys_adc_buffer_mutex != nullptr, "Failed to create mutex");
@@ -177,30 +210,58 @@ void init()
         s_battery.is_charger_initialized = true;
     }
 
-    bsp_adc_start((uint32_t *) s_adc_buffer, adc_buffer_size,
-                  +[]()
-                  {
-                      if (xSemaphoreTakeFromISR(sys_adc_buffer_mutex, NULL) == pdFALSE)
-                          return;
-
-                      static uint32_t s_sample_tick_last = 0;
-                      auto            tick               = get_systick();
-                      // adc_conv_time_ms = tick - s_sample_tick_last;
-                      s_sample_tick_last = std::exchange(tick, get_systick());
-
-                      // TODO: drop it, after PP samples are not used anymore
-                      for (uint32_t i = 0; i < adc_buffer_size; i += adc_number_of_sampled_channels)
-                      {
-                          bat_voltage_smoother(s_adc_buffer[i]);
-                          isens_ref_smoother(s_adc_buffer[i + 1]);
-                          isens_smoother(s_adc_buffer[i + 2]);
-                          psys_smoother(s_adc_buffer[i + 3]);
-                          ntc_sens_smoother(s_adc_buffer[i + 4]);
-                          vrefint_smoother(s_adc_buffer[i + 5]);
-                      }
-
-                      xSemaphoreGiveFromISR(sys_adc_buffer_mutex, NULL);
-                  });
+    start_adc();
+}
+
+static void on_adc_conversion_complete()
+{
+    if (s_is_adc_one_shot)
+    {
+        bsp_adc_stop();
+        s_is_adc_paused = true;
+    }
+
+    if (xSemaphoreTakeFromISR(sys_adc_buffer_mutex, NULL) == pdFALSE)
+        return;
+
+    static uint32_t s_sample_tick_last = 0;
+    auto            tick               = get_systick();
+    // adc_conv_time_ms = tick - s_sample_tick_last;
+    s_sample_tick_last = std::exchange(tick, get_systick());
+
+    // TODO: drop it, after PP samples are not used anymore
+    for (uint32_t i = 0; i < c_adc_buffer_size; i += c_adc_number_of_sampled_channels)
+    {
+        bat_voltage_smoother(s_adc_buffer[i]);
+        isens_ref_smoother(s_adc_buffer[i + 1]);
+        isens_smoother(s_adc_buffer[i + 2]);
+        psys_smoother(s_adc_buffer[i + 3]);
+        ntc_sens_smoother(s_adc_buffer[i + 4]);
+        vrefint_smoother(s_adc_buffer[i + 5]);
+    }
+
+    xSemaphoreGiveFromISR(sys_adc_buffer_mutex, NULL);
+}
+
+static void start_adc()
+{
+    bsp_adc_start((uint32_t *) s_adc_buffer, c_adc_buffer_size, on_adc_conversion_complete);
+}
+
+// The SoC estimator integrates the current over the actual time between two samples, the period only sets the
+// resolution
+void set_sample_period(uint32_t period_ms)
+{
+    if (soc_timer == nullptr || xTimerGetPeriod(soc_timer) == pdMS_TO_TICKS(period_ms))
+        return;
+
+    xTimerChangePeriod(soc_timer, pdMS_TO_TICKS(period_ms), 0);
+}
+
+// The SoC timer starts the next buffer, and the continuous conversions again once the one shot mode is left
+void set_adc_one_shot(bool enable)
+{
+    s_is_adc_one_shot = enable;
 }
 
 static BatteryIndicator battery_indicator{
@@ -239,7 +300,7 @@ static std::optional<int> get_battery_current()
     auto raw_isens_tmp     = isens_smoother.get();
 
     xSemaphoreGive(sys_adc_buffer_mutex);
-    return static_cast<int>(calculate_battery_current_milliamps(vdda, raw_isens_ref_tmp, raw_isens_tmp));
+    return Soc::Selected::battery_current_ma(vdda, raw_isens_ref_tmp, raw_isens_tmp);
 }
 
 static void monitor_battery_level()
@@ -462,7 +523,7 @@ static void monitor_power_bank_mode()
     }
 }
 
-void poll()
+static void update()
 {
     // Calculate NTC temperature
     update_battery_temperature();
@@ -542,6 +603,15 @@ void poll()
 #endif
 }
 
+void poll()
+{
+    uint32_t start = board_get_cycle_count();
+
+    update();
+
+    add_cycles(s_poll_stats, start);
+}
+
 Ux::System::ChargeType toggle_fast_charging()
 {
     auto charge_type = !board_link_charger_is_fast_charge_enabled() ? Ux::System::ChargeType::FastCharge
@@ -578,36 +648,6 @@ uint16_t get_battery_voltage_mv()
 }
 #endif // INCLUDE_PRODUCTION_TESTS
 
-static float calculate_battery_current_milliamps(uint32_t vcc_mv, int32_t isns_ref, int32_t isns)
-{
-    constexpr float r_sns = 0.005f; // Ohms
-    constexpr float gain  = 20.f;   // Gain of the INA
-
-    int32_t         diff_adc                 = isns_ref - isns; // RAW ADC values
-    constexpr float adc_mamp_lsb_resolution1 = (gain * r_sns * 4095.f);
-
-    // There is current mismatch between the INA and the ADC, and it's about 15mA,
-    // so we need to compensate it.
-    return 15.f + static_cast<float>(vcc_mv) * static_cast<float>(diff_adc) / adc_mamp_lsb_resolution1;
-    /*
-     * This is simplified and slightly optimized version of the follwoing code:
-     *
-     * // adc_v_lsb calculated as follows:
-     * // VCC / ((2 ^ ADC_bits) - 1),
-     * // where VCC = 3.3V and ADC_bits = 12
-     * float adc_v_lsb = (static_cast<float>(vcc_mv) * 0.001f) / 4095.f;
-     *
-     * // adc_amp_lsb_resolution calculated as follows:
-     * // (adc_v_lsb / gain ) / r_sns,
-     * // where gain = 20 and r_sns = 0.005
-     * float adc_amp_lsb_resolution = adc_v_lsb / (gain * r_sns); // ampere/lsb
-     *
-     * auto check_vsns = (static_cast<float>(diff_adc) * adc_v_lsb) / gain;
-     * auto check_iload = check_vsns / r_sns;
-     * return check_iload * 1000.f; // convert to milliamps
-     */
-}
-
 void load_persistent_parameters()
 {
     auto charge_type = Storage::load<Tus::ChargeType>().value_or(Tus::ChargeType::BatteryFriendly);
@@ -628,6 +668,22 @@ void factory_reset()
     soc_estimator.reset(s_battery.last_battery_voltage_mv);
 }
 
+static void print_cycle_stats(const char *name, CycleStats &stats)
+{
+    const auto copy = stats;
+
+    printf("%s: %lu calls, %lu cycles on average, %lu at most\r\n", name, copy.calls,
+           copy.calls ? static_cast<uint32_t>(copy.cycles / copy.calls) : 0u, copy.max_cycles);
+
+    stats = {};
+}
+
+static void print_soc_cycle_stats()
+{
+    print_cycle_stats("poll", s_poll_stats);
+    print_cycle_stats("SoC sample", s_soc_sample_stats);
+}
+
 #ifdef BATTERY_DEBUG
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_b_level,
                                SHELL_CMD_PARSED_UINT8(set, "set level", 0, UINT8_MAX,
@@ -702,6 +758,16 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_soc,
                                    +[]() { soc_estimator.reset(s_battery.last_battery_voltage_mv); }),
                                SHELL_CMD_NO_ARGS(
                                    show, "show", +[]() { soc_estimator.stat(); }),
+                               SHELL_CMD_NO_ARGS(stats, "poll and SoC sample cycles since the last call",
+                                                 print_soc_cycle_stats),
+                               SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_ARG_REGISTER(soc, &sub_soc, "soc", NULL, 2, 0);
+#else
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_soc,
+                               SHELL_CMD_NO_ARGS(stats, "poll and SoC sample cycles since the last call",
+                                                 print_soc_cycle_stats),
                                SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
@@ -16,6 +16,8 @@ void                   load_persistent_parameters();
 void                   save_persistent_parameters();
 void                   set_power_state(const Teufel::Ux::System::PowerState &state);
 void                   factory_reset();
+void                   set_sample_period(uint32_t period_ms);
+void                   set_adc_one_shot(bool enable);
 
 #ifdef INCLUDE_PRODUCTION_TESTS
 // RAW battery data which are exposed only for prod testing purpose!
@@ -6,11 +6,7 @@
 #include "soc_estimator.h"
 #include "kvstorage.h"
 
-static inline float integrate_charge(float previous_value, int16_t battery_in_out_current_ma, uint32_t time_delta_ms)
-{
-    return previous_value +
-           static_cast<float>(battery_in_out_current_ma) * .001f * static_cast<float>(time_delta_ms) * .001f;
-}
+namespace SocMath = Soc::Selected;
 
 void SocEstimator::add_sample(uint16_t battery_voltage_mv, int16_t battery_in_out_current_ma)
 {
@@ -18,8 +14,8 @@ void SocEstimator::add_sample(uint16_t battery_voltage_mv, int16_t battery_in_ou
     static uint32_t s_last_sample_timestamp = get_systick() - 10u;
 
     // Integrate the charge
-    m_integrated_charge =
-        integrate_charge(m_integrated_charge, battery_in_out_current_ma, board_get_ms_since(s_last_sample_timestamp));
+    m_integrated_charge = SocMath::integrate_charge(m_integrated_charge, battery_in_out_current_ma,
+                                                    board_get_ms_since(s_last_sample_timestamp));
     s_last_sample_timestamp = get_systick();
 #endif
     m_battery_voltage_mv = battery_voltage_mv;
@@ -35,8 +31,9 @@ void SocEstimator::add_sample(uint16_t battery_voltage_mv, int16_t battery_in_ou
  */
 uint8_t SocEstimator::get_battery_level() const
 {
-    auto voltage_mv = std::clamp(m_battery_voltage_mv, c_battery_voltage_mv_min, c_battery_voltage_mv_max);
-    return ((voltage_mv - c_battery_voltage_mv_min) * 100) / (c_battery_voltage_mv_max - c_battery_voltage_mv_min);
+    auto voltage_mv = std::clamp(m_battery_voltage_mv, Soc::c_battery_voltage_mv_min, Soc::c_battery_voltage_mv_max);
+    return ((voltage_mv - Soc::c_battery_voltage_mv_min) * 100) /
+           (Soc::c_battery_voltage_mv_max - Soc::c_battery_voltage_mv_min);
 }
 #else
 uint8_t SocEstimator::get_battery_level() const
@@ -44,20 +41,21 @@ uint8_t SocEstimator::get_battery_level() const
     if (m_algo_state == Teufel::Ux::System::BatterySoCAlgoState::Reset ||
         m_algo_state == Teufel::Ux::System::BatterySoCAlgoState::FirstStartOrBatteryReset)
     {
-        auto charge = vbat_to_charge::convert(m_battery_voltage_mv);
-        return charge_to_soc::convert(charge, m_battery_factory_capacity);
+        auto charge = SocMath::vbat_to_charge(m_battery_voltage_mv);
+        return SocMath::charge_to_soc(charge, SocMath::c_factory_capacity);
     }
     else
-        return charge_to_soc::convert(m_integrated_charge, m_capacity);
+        return SocMath::charge_to_soc(m_integrated_charge, m_capacity);
 }
 #endif
 
 void SocEstimator::stat() const
 {
-    // Convert m_integrated_charge from ampere-seconds to milli-ampere-hours
-    auto charge_mah = m_integrated_charge * 1000.f / 3600.f;
+    // Convert m_integrated_charge from milli-ampere-seconds to milli-ampere-hours
+    auto charge_mah = SocMath::to_milliampere_seconds(m_integrated_charge) / 3600;
+    auto capacity   = SocMath::to_milliampere_seconds(m_capacity) / 1000;
     log_warn_raw("soc: algo state: %s, CHG: %d (mAh), CAP: %d (As), BAT: %u (mV)\r\n", getDesc(m_algo_state),
-                 static_cast<int>(charge_mah), static_cast<int>(m_capacity), m_battery_voltage_mv);
+                 static_cast<int>(charge_mah), static_cast<int>(capacity), m_battery_voltage_mv);
 }
 
 void SocEstimator::init(uint16_t battery_voltage_mv)
@@ -70,21 +68,23 @@ void SocEstimator::init(uint16_t battery_voltage_mv)
     // After the factory reset, or full EEPROM erase
     if (m_algo_state == Teufel::Ux::System::BatterySoCAlgoState::Reset)
     {
-        m_capacity          = m_battery_factory_capacity;
-        m_integrated_charge = vbat_to_charge::convert(battery_voltage_mv);
+        m_capacity          = SocMath::c_factory_capacity;
+        m_integrated_charge = SocMath::vbat_to_charge(battery_voltage_mv);
         m_algo_state        = Teufel::Ux::System::BatterySoCAlgoState::FirstStartOrBatteryReset;
 
         save_persistent_parameters();
     }
     else
     {
-        m_integrated_charge = Storage::load<Teufel::Ux::System::BatterySocAccumulatedCharge>()
-                                  .value_or(Teufel::Ux::System::BatterySocAccumulatedCharge{0})
-                                  .value;
-
-        m_capacity = Storage::load<Teufel::Ux::System::BatterySocCapacity>()
-                         .value_or(Teufel::Ux::System::BatterySocCapacity{m_battery_factory_capacity})
-                         .value;
+        m_integrated_charge = SocMath::from_milliampere_seconds(
+            Storage::load<Teufel::Ux::System::BatterySocAccumulatedCharge>()
+                .value_or(Teufel::Ux::System::BatterySocAccumulatedCharge{0})
+                .value);
+
+        m_capacity = SocMath::from_milliampere_seconds(
+            Storage::load<Teufel::Ux::System::BatterySocCapacity>()
+                .value_or(Teufel::Ux::System::BatterySocCapacity{Soc::c_factory_capacity_mas})
+                .value);
     }
 #else
     Storage::save(Teufel::Ux::System::BatterySoCAlgoState::Reset);
@@ -98,9 +98,9 @@ void SocEstimator::reset(uint16_t battery_voltage_mv)
 {
 #ifndef BOARD_CONFIG_BATTERY_LEVEL_ESTIMATOR_SIMPLE
     // TODO: set m_integrated_charge to 0 for the measurements
-    m_integrated_charge = vbat_to_charge::convert(battery_voltage_mv);
-    // m_integrated_charge = 0.f;
-    m_capacity   = m_battery_factory_capacity;
+    m_integrated_charge = SocMath::vbat_to_charge(battery_voltage_mv);
+    // m_integrated_charge = 0;
+    m_capacity   = SocMath::c_factory_capacity;
     m_algo_state = Teufel::Ux::System::BatterySoCAlgoState::FirstStartOrBatteryReset;
     save_persistent_parameters();
     log_info("soc: reset...");
@@ -111,10 +111,11 @@ void SocEstimator::reset(uint16_t battery_voltage_mv)
 void SocEstimator::save_persistent_parameters()
 {
 #ifndef BOARD_CONFIG_BATTERY_LEVEL_ESTIMATOR_SIMPLE
+    using namespace Teufel::Ux::System;
     log_info("soc: saving persistent parameters...");
     stat();
-    Storage::save(Teufel::Ux::System::BatterySocAccumulatedCharge{m_integrated_charge});
-    Storage::save(Teufel::Ux::System::BatterySocCapacity{m_capacity});
+    Storage::save(BatterySocAccumulatedCharge{SocMath::to_milliampere_seconds(m_integrated_charge)});
+    Storage::save(BatterySocCapacity{SocMath::to_milliampere_seconds(m_capacity)});
     Storage::save(m_algo_state);
 #endif
 }
@@ -131,12 +132,12 @@ void SocEstimator::on_charge()
     switch (m_algo_state)
     {
         case BatterySoCAlgoState::FirstStartOrBatteryReset:
-            m_integrated_charge = m_battery_factory_capacity;
+            m_integrated_charge = SocMath::c_factory_capacity;
             m_algo_state        = BatterySoCAlgoState::FirstFullChargeCompleted;
             break;
 
         case BatterySoCAlgoState::FirstFullChargeCompleted:
-            m_integrated_charge = m_battery_factory_capacity;
+            m_integrated_charge = SocMath::c_factory_capacity;
             break;
 
         case BatterySoCAlgoState::FirstFullDischargeCompleted:
@@ -145,7 +146,8 @@ void SocEstimator::on_charge()
             break;
 
         case BatterySoCAlgoState::NormalOperation:
-            m_capacity          = (m_capacity + m_integrated_charge) / 2.f;
+            // The mean without the sum, which doesn't fit in the charge
+            m_capacity          = m_capacity + (m_integrated_charge - m_capacity) / 2;
             m_integrated_charge = m_capacity;
             break;
     }
@@ -160,23 +162,23 @@ void SocEstimator::on_discharge()
     switch (m_algo_state)
     {
         case BatterySoCAlgoState::FirstStartOrBatteryReset:
-            m_integrated_charge = 0.f;
+            m_integrated_charge = 0;
             m_algo_state        = BatterySoCAlgoState::FirstFullDischargeCompleted;
             break;
 
         case BatterySoCAlgoState::FirstFullChargeCompleted:
-            m_capacity          = m_battery_factory_capacity - m_integrated_charge;
-            m_integrated_charge = 0.f;
+            m_capacity          = SocMath::c_factory_capacity - m_integrated_charge;
+            m_integrated_charge = 0;
             m_algo_state        = BatterySoCAlgoState::NormalOperation;
             break;
 
         case BatterySoCAlgoState::FirstFullDischargeCompleted:
-            m_integrated_charge = 0.f;
+            m_integrated_charge = 0;
             break;
 
         case BatterySoCAlgoState::NormalOperation:
-            m_capacity          = m_capacity - m_integrated_charge / 2.f;
-            m_integrated_charge = 0.f;
+            m_capacity          = m_capacity - m_integrated_charge / 2;
+            m_integrated_charge = 0;
             break;
     }
     save_persistent_parameters();
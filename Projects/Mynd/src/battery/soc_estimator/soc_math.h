@@ -0,0 +1,296 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Arithmetic of the SoC estimator, in two implementations with the same interface:
+// - Float: the original floating point implementation, kept as the reference of the tests.
+// - Fixed: integer only, the STM32F072 has no FPU and every float operation is a soft-float library call.
+// The estimator uses Soc::Selected, which is Fixed unless BOARD_CONFIG_SOC_ESTIMATOR_FLOAT is defined.
+namespace Soc
+{
+
+// Persisted values of the charge and of the capacity are in milliampere * seconds
+constexpr int32_t c_factory_capacity_mas = 17'640'000; // 17640 As (4.9 Ah)
+
+constexpr uint16_t c_battery_voltage_mv_min = 6000u;
+constexpr uint16_t c_battery_voltage_mv_max = 8400u;
+
+// LUT input: (VBAT - 6 V) / 2.4 V, output: charge / capacity
+constexpr std::array c_vbat_to_charge_lut{0.0f,    0.0013f, 0.0128f, 0.0528f, 0.1686f, 0.4544f,
+                                          0.6251f, 0.7484f, 0.8617f, 0.9635f, 1.0f,    1.0f};
+
+// LUT input: charge / capacity, output: SoC
+constexpr std::array c_charge_to_soc_lut{0.0f,   0.0907f, 0.185f, 0.281f, 0.378f, 0.476f,
+                                         0.575f, 0.677f,  0.782f, 0.889f, 1.0f,   1.0f};
+
+// The INA amplifies the voltage over the current sense resistor for the ADC
+constexpr float c_current_sense_r_ohm = 0.005f;
+constexpr float c_current_sense_gain  = 20.f;
+
+// There is current mismatch between the INA and the ADC, and it's about 15mA, so we need to compensate it.
+constexpr int32_t c_current_offset_ma = 15;
+
+namespace Float
+{
+using Charge = float; // Ampere * seconds
+
+constexpr Charge c_factory_capacity = 17'640.f;
+
+inline Charge from_milliampere_seconds(int32_t value)
+{
+    return static_cast<float>(value) / 1000.f;
+}
+
+inline int32_t to_milliampere_seconds(Charge value)
+{
+    return static_cast<int32_t>(value * 1000.f);
+}
+
+inline Charge integrate_charge(Charge previous_value, int16_t battery_in_out_current_ma, uint32_t time_delta_ms)
+{
+    return previous_value +
+           static_cast<float>(battery_in_out_current_ma) * .001f * static_cast<float>(time_delta_ms) * .001f;
+}
+
+inline float apply_lut(float value, const float *lut, uint8_t n)
+{
+    // n is the number of elements in the LUT
+    value *= (n - 2);
+    auto lower_index = (int) floorf(value);
+    auto upper_index = (int) ceilf(value);
+    return std::lerp(lut[lower_index], lut[upper_index], value - lower_index);
+}
+
+inline Charge vbat_to_charge(uint16_t vbat_mv)
+{
+    vbat_mv    = std::clamp(vbat_mv, c_battery_voltage_mv_min, c_battery_voltage_mv_max);
+    auto lut_v = apply_lut((static_cast<float>(vbat_mv) / 1000.f - 6.f) / 2.4f, c_vbat_to_charge_lut.data(),
+                           c_vbat_to_charge_lut.size());
+    return c_factory_capacity * lut_v;
+}
+
+inline uint8_t charge_to_soc(Charge charge, Charge capacity)
+{
+    auto value = std::clamp(charge / capacity, 0.f, 1.f);
+    auto lut_v = apply_lut(value, c_charge_to_soc_lut.data(), c_charge_to_soc_lut.size());
+    return static_cast<uint8_t>(100.f * lut_v);
+}
+
+inline int battery_current_ma(uint32_t vcc_mv, int32_t isns_ref, int32_t isns)
+{
+    int32_t         diff_adc                 = isns_ref - isns; // RAW ADC values
+    constexpr float adc_mamp_lsb_resolution1 = (c_current_sense_gain * c_current_sense_r_ohm * 4095.f);
+
+    return static_cast<int>(static_cast<float>(c_current_offset_ma) +
+                            static_cast<float>(vcc_mv) * static_cast<float>(diff_adc) / adc_mamp_lsb_resolution1);
+    /*
+     * This is simplified and slightly optimized version of the follwoing code:
+     *
+     * // adc_v_lsb calculated as follows:
+     * // VCC / ((2 ^ ADC_bits) - 1),
+     * // where VCC = 3.3V and ADC_bits = 12
+     * float adc_v_lsb = (static_cast<float>(vcc_mv) * 0.001f) / 4095.f;
+     *
+     * // adc_amp_lsb_resolution calculated as follows:
+     * // (adc_v_lsb / gain ) / r_sns,
+     * // where gain = 20 and r_sns = 0.005
+     * float adc_amp_lsb_resolution = adc_v_lsb / (gain * r_sns); // ampere/lsb
+     *
+     * auto check_vsns = (static_cast<float>(diff_adc) * adc_v_lsb) / gain;
+     * auto check_iload = check_vsns / r_sns;
+     * return check_iload * 1000.f; // convert to milliamps
+     */
+}
+}
+
+// The charge is integrated in 1/64 milliampere * seconds (Q6 mAs), so that the factory capacity and almost twice it
+// fit in an int32: the Cortex-M0 has no 64 bit division, every int64 one is an __aeabi_ldivmod call. A sample of mA * ms
+// is rounded to the nearest 1/64 mAs, 7.8 uAs at most, which is 0.016 % of the capacity per hour at 10 ms samples.
+// The LUTs hold the values of the float LUTs in 1/10000, which is their exact decimal precision. The charge of a voltage
+// is interpolated exactly, in mV. The SoC is interpolated at a 20 bit binary fraction of the charge over the capacity
+// and truncated like the cast of the float implementation. The float implementation rounds at every step instead, its
+// result can be one below where the exact value is on or just above an integer; the truncated fraction puts the fixed
+// result one below where it's within 1.2e-4 above one.
+namespace Fixed
+{
+using Charge = int32_t; // Milliampere * seconds, Q6
+
+constexpr int c_charge_fraction_bits = 6;
+
+constexpr int32_t c_max_charge_mas = INT32_MAX >> c_charge_fraction_bits;
+
+constexpr Charge c_factory_capacity = c_factory_capacity_mas * (Charge{1} << c_charge_fraction_bits);
+constexpr Charge c_max_charge       = c_max_charge_mas * (Charge{1} << c_charge_fraction_bits);
+
+constexpr int32_t c_lut_scale = 10'000;
+
+// Binary fraction of the LUT inputs
+constexpr int      c_fraction_bits = 20;
+constexpr uint32_t c_fraction_one  = uint32_t{1} << c_fraction_bits;
+
+template <std::size_t N>
+constexpr std::array<int32_t, N> to_fixed_lut(const std::array<float, N> &lut)
+{
+    std::array<int32_t, N> fixed_lut{};
+    for (std::size_t i = 0; i < N; i++)
+    {
+        fixed_lut[i] = static_cast<int32_t>(lut[i] * c_lut_scale + .5f);
+    }
+    return fixed_lut;
+}
+
+// The interpolations multiply the steps of the LUTs, which only rise, and check that the products fit
+template <std::size_t N>
+constexpr int32_t max_lut_step(const std::array<int32_t, N> &lut)
+{
+    int32_t max_step = 0;
+    for (std::size_t i = 0; i + 1 < N; i++)
+    {
+        max_step = std::max(max_step, lut[i + 1] - lut[i]);
+    }
+    return max_step;
+}
+
+constexpr auto c_fixed_vbat_to_charge_lut = to_fixed_lut(c_vbat_to_charge_lut);
+constexpr auto c_fixed_charge_to_soc_lut  = to_fixed_lut(c_charge_to_soc_lut);
+
+static_assert(c_fixed_vbat_to_charge_lut[1] == 13 && c_fixed_vbat_to_charge_lut[9] == 9635);
+static_assert(c_fixed_charge_to_soc_lut[1] == 907 && c_fixed_charge_to_soc_lut[10] == c_lut_scale);
+static_assert(std::is_sorted(c_fixed_vbat_to_charge_lut.begin(), c_fixed_vbat_to_charge_lut.end()) &&
+              std::is_sorted(c_fixed_charge_to_soc_lut.begin(), c_fixed_charge_to_soc_lut.end()));
+static_assert(max_lut_step(c_fixed_charge_to_soc_lut) < (1 << (32 - c_fraction_bits)));
+
+// Persisted values beyond the range of the charge saturate
+constexpr Charge from_milliampere_seconds(int32_t value)
+{
+    return std::clamp(value, -c_max_charge_mas, c_max_charge_mas) * (Charge{1} << c_charge_fraction_bits);
+}
+
+constexpr int32_t to_milliampere_seconds(Charge value)
+{
+    return value / (Charge{1} << c_charge_fraction_bits);
+}
+
+constexpr Charge integrate_charge(Charge previous_value, int16_t battery_in_out_current_ma, uint32_t time_delta_ms)
+{
+    // mA * ms * 64 / 1000 fits in an int32 up to 8 s at 32 A, the SoC timer samples every 10 ms
+    constexpr uint32_t max_sample_ms = 8'000u;
+
+    while (time_delta_ms > max_sample_ms)
+    {
+        previous_value = integrate_charge(previous_value, battery_in_out_current_ma, max_sample_ms);
+        time_delta_ms -= max_sample_ms;
+    }
+
+    int32_t charge_uas = int32_t{battery_in_out_current_ma} * static_cast<int32_t>(time_delta_ms);
+    int32_t delta      = (charge_uas * 8 + (charge_uas < 0 ? -62 : 62)) / 125;
+
+    // Saturates instead of wrapping around
+    return (delta < 0) ? std::max(previous_value, -c_max_charge - delta) + delta
+                       : std::min(previous_value, c_max_charge - delta) + delta;
+}
+
+// numerator / denominator as a 20 bit binary fraction, truncated, with 0 <= numerator <= denominator < 2^31. A shift
+// and subtract division, the numerator doesn't fit in 32 bits once shifted up front.
+constexpr uint32_t to_fraction(uint32_t numerator, uint32_t denominator)
+{
+    if (numerator >= denominator)
+    {
+        return c_fraction_one;
+    }
+
+    uint32_t fraction = 0;
+    for (int bit = 0; bit < c_fraction_bits; bit++)
+    {
+        numerator <<= 1;
+        fraction <<= 1;
+        if (numerator >= denominator)
+        {
+            numerator -= denominator;
+            fraction |= 1u;
+        }
+    }
+    return fraction;
+}
+
+// Interpolates the LUT at a 20 bit binary fraction (within [0, 1]), the result is the LUT value in 1/10000, truncated
+template <std::size_t N>
+constexpr int32_t apply_lut(const std::array<int32_t, N> &lut, uint32_t fraction)
+{
+    uint32_t value = fraction * (N - 2);
+    auto     index = static_cast<std::size_t>(value >> c_fraction_bits);
+    uint32_t rest  = value & (c_fraction_one - 1);
+
+    if (index >= N - 1)
+    {
+        return lut[N - 1];
+    }
+    return lut[index] + static_cast<int32_t>((static_cast<uint32_t>(lut[index + 1] - lut[index]) * rest) >>
+                                             c_fraction_bits);
+}
+
+constexpr Charge vbat_to_charge(uint16_t vbat_mv)
+{
+    constexpr auto    &lut           = c_fixed_vbat_to_charge_lut;
+    constexpr int32_t  vbat_range_mv = c_battery_voltage_mv_max - c_battery_voltage_mv_min;
+    constexpr int32_t  lut_steps     = static_cast<int32_t>(lut.size() - 2);
+
+    // The charge of 1/10000 of the capacity, times the rest within a step in 1/2400: exact and rounded, in int32
+    constexpr Charge charge_per_lut_step = c_factory_capacity / c_lut_scale;
+    constexpr Charge charge_per_rest     = charge_per_lut_step / vbat_range_mv;
+    constexpr Charge charge_per_rest_rem = charge_per_lut_step % vbat_range_mv;
+    static_assert(charge_per_lut_step * c_lut_scale == c_factory_capacity);
+    static_assert(int64_t{max_lut_step(lut)} * vbat_range_mv * charge_per_rest_rem <= INT32_MAX);
+
+    vbat_mv = std::clamp(vbat_mv, c_battery_voltage_mv_min, c_battery_voltage_mv_max);
+
+    int32_t value = (vbat_mv - c_battery_voltage_mv_min) * lut_steps;
+    auto    index = static_cast<std::size_t>(value / vbat_range_mv);
+    int32_t rest  = value - static_cast<int32_t>(index) * vbat_range_mv;
+
+    if (index >= lut.size() - 1)
+    {
+        return lut.back() * charge_per_lut_step;
+    }
+
+    int32_t step = (lut[index + 1] - lut[index]) * rest;
+    return lut[index] * charge_per_lut_step + step * charge_per_rest +
+           (step * charge_per_rest_rem + vbat_range_mv / 2) / vbat_range_mv;
+}
+
+constexpr uint8_t charge_to_soc(Charge charge, Charge capacity)
+{
+    if (capacity <= 0)
+    {
+        return 0;
+    }
+
+    auto fraction = to_fraction(static_cast<uint32_t>(std::clamp<Charge>(charge, 0, capacity)),
+                                static_cast<uint32_t>(capacity));
+    return static_cast<uint8_t>(apply_lut(c_fixed_charge_to_soc_lut, fraction) / (c_lut_scale / 100));
+}
+
+constexpr int battery_current_ma(uint32_t vcc_mv, int32_t isns_ref, int32_t isns)
+{
+    // vcc_mv * diff_adc / (gain * r_sns * 4095), with 2 * gain * r_sns * 4095 = 819
+    constexpr int32_t adc_mamp_lsb_resolution_x2 = 819;
+
+    int32_t diff_adc = isns_ref - isns; // RAW ADC values
+
+    // Division truncates toward zero, like the cast of the float implementation
+    return (c_current_offset_ma * adc_mamp_lsb_resolution_x2 + 2 * static_cast<int32_t>(vcc_mv) * diff_adc) /
+           adc_mamp_lsb_resolution_x2;
+}
+}
+
+#ifdef BOARD_CONFIG_SOC_ESTIMATOR_FLOAT
+namespace Selected = Float;
+#else
+namespace Selected = Fixed;
+#endif
+
+}
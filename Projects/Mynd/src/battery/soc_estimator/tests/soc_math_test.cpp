@@ -0,0 +1,284 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+
+#include <gtest/gtest.h>
+
+#include "soc_math.h"
+
+using namespace Soc;
+
+// The fixed point implementation interpolates at a 20 bit fraction, the float one rounds at every step. The tests
+// compare both with the exact value computed in long double: the fixed point result is its truncation, or one below
+// where the exact value is within the truncation of the fraction above an integer. The float result may only differ
+// from it by one, where the exact value is within the float rounding of an integer.
+static bool is_float_rounding_tie(long double exact)
+{
+    return std::fabs(exact - std::round(exact)) <= std::max(100.L, std::fabs(exact)) * 1e-6L;
+}
+
+// 100 % times the steepest LUT step over 2^-20 of the charge
+static constexpr long double c_fraction_tolerance = 1.2e-4L;
+
+static bool is_fraction_truncation(int fixed, long double exact)
+{
+    auto truncated = std::floor(exact + 1e-9L);
+    return fixed == static_cast<int>(truncated) - 1 && exact - truncated < c_fraction_tolerance;
+}
+
+static long double to_ampere_seconds(Fixed::Charge charge)
+{
+    return charge / (1000.L * (1 << Fixed::c_charge_fraction_bits));
+}
+
+template <typename Lut>
+static long double exact_lut(const Lut &lut, long double x)
+{
+    x *= lut.size() - 2;
+    auto index = static_cast<size_t>(x);
+    if (index >= lut.size() - 1)
+    {
+        return lut.back() / 10'000.L;
+    }
+    return (lut[index] + (lut[index + 1] - lut[index]) * (x - index)) / 10'000.L;
+}
+
+static long double exact_soc(Fixed::Charge charge, Fixed::Charge capacity)
+{
+    auto ratio = std::clamp(static_cast<long double>(charge) / capacity, 0.L, 1.L);
+    return 100.L * exact_lut(Fixed::c_fixed_charge_to_soc_lut, ratio);
+}
+
+struct Comparison
+{
+    uint32_t samples;
+    uint32_t mismatches;
+    uint32_t truncations;
+};
+
+static void compare(Comparison &comparison, int fixed, int reference, long double exact)
+{
+    comparison.samples++;
+
+    bool is_truncated = is_fraction_truncation(fixed, exact);
+    comparison.truncations += is_truncated;
+
+    if (!is_truncated)
+    {
+        EXPECT_EQ(fixed, static_cast<int>(std::floor(exact + 1e-9L))) << "exact " << exact;
+    }
+    if (fixed != reference)
+    {
+        comparison.mismatches++;
+        EXPECT_EQ(std::abs(fixed - reference), 1) << "exact " << exact;
+        EXPECT_TRUE(is_float_rounding_tie(exact) || is_truncated)
+            << "exact " << exact << ", fixed " << fixed << ", float " << reference;
+    }
+}
+
+TEST(SocMath, LutsHoldTheFloatLutValues)
+{
+    for (size_t i = 0; i < c_charge_to_soc_lut.size(); i++)
+    {
+        EXPECT_NEAR(Fixed::c_fixed_charge_to_soc_lut[i] / 10'000.f, c_charge_to_soc_lut[i], 1e-6f);
+        EXPECT_NEAR(Fixed::c_fixed_vbat_to_charge_lut[i] / 10'000.f, c_vbat_to_charge_lut[i], 1e-6f);
+    }
+}
+
+TEST(SocMath, PersistedChargeRoundTrips)
+{
+    for (int32_t mas : {-Fixed::c_max_charge_mas, -17'640'000, -1, 0, 1, 12'345'678, c_factory_capacity_mas,
+                        Fixed::c_max_charge_mas})
+    {
+        EXPECT_EQ(Fixed::to_milliampere_seconds(Fixed::from_milliampere_seconds(mas)), mas);
+    }
+
+    // Beyond the range of the charge
+    EXPECT_EQ(Fixed::from_milliampere_seconds(INT32_MIN), -Fixed::c_max_charge);
+    EXPECT_EQ(Fixed::from_milliampere_seconds(INT32_MAX), Fixed::c_max_charge);
+    EXPECT_EQ(Fixed::from_milliampere_seconds(c_factory_capacity_mas), Fixed::c_factory_capacity);
+    EXPECT_EQ(Float::from_milliampere_seconds(c_factory_capacity_mas), Float::c_factory_capacity);
+}
+
+TEST(SocMath, ChargeIntegratesLongGapsAndSaturates)
+{
+    // An hour without a sample, e.g. in the STOP mode
+    EXPECT_EQ(Fixed::integrate_charge(0, 1000, 3'600'000u), Fixed::from_milliampere_seconds(3'600'000));
+    EXPECT_EQ(Fixed::integrate_charge(0, -1000, 3'600'001u), Fixed::from_milliampere_seconds(-3'600'001));
+
+    EXPECT_EQ(Fixed::integrate_charge(Fixed::c_max_charge - 1, 1000, 10u), Fixed::c_max_charge);
+    EXPECT_EQ(Fixed::integrate_charge(-Fixed::c_max_charge + 1, INT16_MIN, 100'000u), -Fixed::c_max_charge);
+}
+
+TEST(SocMath, BatteryCurrentMatchesFloat)
+{
+    Comparison comparison{};
+
+    // VDDA between 2.4 V and 3.6 V, every ADC difference within 10 A
+    for (uint32_t vcc_mv = 2400; vcc_mv <= 3600; vcc_mv++)
+    {
+        for (int32_t diff_adc = -1500; diff_adc <= 1500; diff_adc++)
+        {
+            long double exact = (c_current_offset_ma * 819 + 2 * static_cast<int32_t>(vcc_mv) * diff_adc) / 819.L;
+            if (std::fabs(exact) > 10'000)
+            {
+                continue;
+            }
+
+            int fixed     = Fixed::battery_current_ma(vcc_mv, 2048, 2048 - diff_adc);
+            int reference = Float::battery_current_ma(vcc_mv, 2048, 2048 - diff_adc);
+
+            comparison.samples++;
+            EXPECT_EQ(fixed, static_cast<int>(std::trunc(exact)));
+            if (fixed != reference)
+            {
+                comparison.mismatches++;
+                EXPECT_EQ(std::abs(fixed - reference), 1);
+                EXPECT_TRUE(is_float_rounding_tie(exact)) << "exact " << exact;
+            }
+        }
+    }
+
+    std::printf("battery current: %u of %u conversions differ from float, at float rounding ties\n",
+                comparison.mismatches, comparison.samples);
+}
+
+TEST(SocMath, VbatLevelMatchesFloat)
+{
+    Comparison comparison{};
+
+    for (uint32_t vbat_mv = 5900; vbat_mv <= 8500; vbat_mv++)
+    {
+        auto v = static_cast<uint16_t>(vbat_mv);
+
+        auto fixed_charge = Fixed::vbat_to_charge(v);
+        auto x            = (std::clamp(vbat_mv, 6000u, 8400u) - 6000.L) / 2400.L;
+        EXPECT_EQ(fixed_charge, static_cast<Fixed::Charge>(std::round(
+                                    Fixed::c_factory_capacity * exact_lut(Fixed::c_fixed_vbat_to_charge_lut, x))));
+
+        compare(comparison, Fixed::charge_to_soc(fixed_charge, Fixed::c_factory_capacity),
+                Float::charge_to_soc(Float::vbat_to_charge(v), Float::c_factory_capacity),
+                exact_soc(fixed_charge, Fixed::c_factory_capacity));
+    }
+
+    std::printf("vbat: %u of %u levels differ from float, at float rounding ties or fraction truncations (%u)\n",
+                comparison.mismatches, comparison.samples, comparison.truncations);
+}
+
+TEST(SocMath, ChargeLevelMatchesFloat)
+{
+    // Factory capacity and capacities learnt over the charge cycles
+    for (int32_t capacity_mas : {c_factory_capacity_mas, 19'000'000, 15'000'000, 12'345'678})
+    {
+        Comparison comparison{};
+
+        // Every mAs, from a little below empty to a little above full
+        for (int32_t charge_mas = -1000; charge_mas <= capacity_mas + 1000; charge_mas++)
+        {
+            auto fixed_charge   = Fixed::from_milliampere_seconds(charge_mas);
+            auto fixed_capacity = Fixed::from_milliampere_seconds(capacity_mas);
+
+            compare(comparison, Fixed::charge_to_soc(fixed_charge, fixed_capacity),
+                    Float::charge_to_soc(Float::from_milliampere_seconds(charge_mas),
+                                         Float::from_milliampere_seconds(capacity_mas)),
+                    exact_soc(fixed_charge, fixed_capacity));
+        }
+
+        std::printf("capacity %d mAs: %u of %u levels differ from float, at float rounding ties or fraction "
+                    "truncations (%u)\n",
+                    capacity_mas, comparison.mismatches, comparison.samples, comparison.truncations);
+    }
+}
+
+// A charge or discharge, sampled by the SoC timer
+struct Trace
+{
+    const char *name;
+    int32_t     start_charge_mas;
+    int32_t     end_charge_mas;
+    int16_t     min_current_ma;
+    int16_t     max_current_ma;
+};
+
+TEST(SocMath, TracesMatchFloat)
+{
+    // Playback at varying volume until empty, then a charge at the battery friendly and at the fast charge currents
+    const Trace traces[] = {
+        {"discharge", c_factory_capacity_mas, 0, -2500, -150},
+        {"charge", 0, c_factory_capacity_mas, 800, 1500},
+        {"fast charge", 0, c_factory_capacity_mas, 2000, 3000},
+    };
+
+    for (const auto &trace : traces)
+    {
+        std::mt19937                            rng(0x50C);
+        std::uniform_int_distribution<int16_t>  load(trace.min_current_ma, trace.max_current_ma);
+        std::uniform_int_distribution<int16_t>  noise(-20, 20);
+        std::uniform_int_distribution<uint32_t> period_ms(9, 12); // The timer task runs late at times
+
+        auto    fixed_charge   = Fixed::from_milliampere_seconds(trace.start_charge_mas);
+        auto    float_charge   = Float::from_milliampere_seconds(trace.start_charge_mas);
+        int64_t exact_charge   = int64_t{trace.start_charge_mas} * 1000; // uAs
+        int16_t current_ma     = load(rng);
+        bool    is_discharging = trace.end_charge_mas < trace.start_charge_mas;
+
+        Comparison comparison{};
+        uint32_t   now_ms = 0, last_level_ms = 0, sample_count = 0;
+        int        max_drift = 0, last_fixed_level = is_discharging ? 100 : 0;
+        long double max_rounding_uas = 0;
+
+        while (is_discharging ? fixed_charge > Fixed::from_milliampere_seconds(trace.end_charge_mas)
+                              : fixed_charge < Fixed::from_milliampere_seconds(trace.end_charge_mas))
+        {
+            if (now_ms % 1000 < 10)
+            {
+                current_ma = load(rng);
+            }
+
+            auto sample_ma = static_cast<int16_t>(current_ma + noise(rng));
+            auto delta_ms  = period_ms(rng);
+            now_ms += delta_ms;
+
+            fixed_charge = Fixed::integrate_charge(fixed_charge, sample_ma, delta_ms);
+            float_charge = Float::integrate_charge(float_charge, sample_ma, delta_ms);
+            exact_charge += int64_t{sample_ma} * delta_ms;
+            sample_count++;
+
+            // The level is read every 200 ms
+            if (now_ms - last_level_ms < 200)
+            {
+                continue;
+            }
+            last_level_ms = now_ms;
+
+            // Each sample is rounded to the nearest 1/64 mAs
+            auto rounding_uas = std::fabs(to_ampere_seconds(fixed_charge) * 1e6L - exact_charge);
+            ASSERT_LE(rounding_uas, sample_count * 1000.L / (2 << Fixed::c_charge_fraction_bits));
+            max_rounding_uas = std::max(max_rounding_uas, rounding_uas);
+
+            int fixed_level = Fixed::charge_to_soc(fixed_charge, Fixed::c_factory_capacity);
+            compare(comparison, fixed_level,
+                    Float::charge_to_soc(static_cast<float>(to_ampere_seconds(fixed_charge)), Float::c_factory_capacity),
+                    exact_soc(fixed_charge, Fixed::c_factory_capacity));
+
+            // The level follows the charge, which only falls during a discharge and only rises during a charge
+            EXPECT_TRUE(is_discharging ? fixed_level <= last_fixed_level : fixed_level >= last_fixed_level);
+            last_fixed_level = fixed_level;
+
+            int float_level = Float::charge_to_soc(float_charge, Float::c_factory_capacity);
+            max_drift       = std::max(max_drift, std::abs(float_level - fixed_level));
+        }
+
+        EXPECT_EQ(Fixed::charge_to_soc(fixed_charge, Fixed::c_factory_capacity), is_discharging ? 0 : 100);
+
+        // Float additions of 10 ms samples to thousands of As lose most of the sample: informative only
+        std::printf("%s trace, %u s: %u of %u levels differ from float on the same charge, at float rounding ties or "
+                    "fraction truncations (%u); the fixed integrator rounds by up to %.3f As, the float one drifts by "
+                    "up to %d %%, %.1f As at the end\n",
+                    trace.name, now_ms / 1000, comparison.mismatches, comparison.samples, comparison.truncations,
+                    static_cast<double>(max_rounding_uas * 1e-6L), max_drift,
+                    static_cast<double>(float_charge - static_cast<float>(exact_charge * 1e-6L)));
+    }
+}
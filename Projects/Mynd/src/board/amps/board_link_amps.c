@@ -3,21 +3,27 @@
 
 #include "config.h"
 #include "board_link_amps.h"
+#include "board_link_amps_retention.h"
+#include "board.h"
 #include "board_hw.h"
 #include "bsp_shared_i2c.h"
 #include "tas5805m.h"
 #include "tas5825p.h"
+#include "tasxxxx_volume_ramp.h"
 #include "FreeRTOS.h"
 #include "task.h"
 
-#include "eco_5805_config.h"
-#include "eco_5805_treble_config.h"
-#include "eco_5825_config.h"
-#include "eco_5825_bass_config.h"
-#include "eco_5805_eco_mode_config.h"
-#include "eco_5825_eco_mode_config.h"
-#include "eco_5805_patch_to_bypass_mode.h"
-#include "eco_5825_patch_to_bypass_mode.h"
+#include "amps_packed_config.h"
+
+// The bass/treble level in the DSP isn't known after the amp configuration is (re)loaded
+#define EQ_LEVEL_UNKNOWN INT8_MIN
+
+typedef enum
+{
+    ECO_MODE_UNKNOWN,
+    ECO_MODE_OFF,
+    ECO_MODE_ON,
+} eco_mode_t;
 
 static void thread_sleep_ms(uint32_t ms);
 
@@ -37,11 +43,16 @@ static const tas5825p_config_t tas5825p_config = {
 
 static struct
 {
-    tas5805m_handler_t *tas5805m;
-    tas5825p_handler_t *tas5825p;
-    int8_t              tweeter_volume_db;
-    int8_t              woofer_volume_db;
-    bool                is_muted;
+    tas5805m_handler_t         *tas5805m;
+    tas5825p_handler_t         *tas5825p;
+    int8_t                      tweeter_volume_db;
+    int8_t                      woofer_volume_db;
+    int8_t                      bass_db;
+    int8_t                      treble_db;
+    eco_mode_t                  eco_mode;
+    bool                        is_muted;
+    board_link_amps_retention_t retention;
+    tasxxxx_volume_ramp_t       volume_ramp; // Fine volume of both amps, CONFIG_AMPS_VOLUME_RAMP
 } s_amps;
 
 void board_link_amps_init(void)
@@ -86,11 +97,35 @@ void board_link_amps_init(void)
     {
         log_error("Failed to initialize tas5825p");
     }
+
+    s_amps.bass_db   = EQ_LEVEL_UNKNOWN;
+    s_amps.treble_db = EQ_LEVEL_UNKNOWN;
+
+    tasxxxx_volume_ramp_init(&s_amps.volume_ramp, CONFIG_AMPS_VOLUME_RAMP_STEP, CONFIG_AMPS_VOLUME_RAMP_PERIOD_MS,
+                             TASXXXX_VOLUME_MUTE);
 }
 
 void board_link_amps_enable(bool enable)
 {
     HAL_GPIO_WritePin(AMPS_POWER_DOWN_GPIO_PORT, AMPS_POWER_DOWN_GPIO_PIN, (enable) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+
+    // The amps come out of the power down on book 0, page 0. Not initialized yet on the first call.
+    if (s_amps.tas5805m != NULL && s_amps.tas5825p != NULL)
+    {
+        tas5805m_invalidate_book_and_page(s_amps.tas5805m);
+        tas5825p_invalidate_book_and_page(s_amps.tas5825p);
+    }
+
+    if (!enable)
+    {
+        s_amps.bass_db               = EQ_LEVEL_UNKNOWN;
+        s_amps.treble_db             = EQ_LEVEL_UNKNOWN;
+        s_amps.eco_mode              = ECO_MODE_UNKNOWN;
+        s_amps.retention.is_retained = false;
+
+        // The volume fades in from the mute once the amps are set up again
+        tasxxxx_volume_ramp_set_volume(&s_amps.volume_ramp, TASXXXX_VOLUME_MUTE);
+    }
     log_info("Amps power %s", enable ? "enabled" : "disabled");
 }
 
@@ -113,7 +148,10 @@ int board_link_amps_setup_woofer(board_link_amps_mode_t mode)
     // Datasheet specifies that we need to wait at least 5 ms to allow the device to settle down after enabling the DSP
     thread_sleep_ms(10);
 
-    if (tas5825p_load_configuration(s_amps.tas5825p, tas5825p_config_registers, TAS5825P_CONFIG_REGISTERS_SIZE) == 0)
+    s_amps.bass_db        = EQ_LEVEL_UNKNOWN;
+    s_amps.eco_mode       = ECO_MODE_UNKNOWN;
+    s_amps.retention.mode = mode;
+    if (tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_config_registers_packed) == 0)
     {
         log_info("Woofer amp configuration loaded");
     }
@@ -125,8 +163,7 @@ int board_link_amps_setup_woofer(board_link_amps_mode_t mode)
 
     if (mode == AMP_MODE_BYPASS)
     {
-        if (tas5825p_load_configuration(s_amps.tas5825p, tas5825p_bypass_config_registers,
-                                        TAS5825P_BYPASS_CONFIG_REGISTERS_SIZE) == 0)
+        if (tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_bypass_config_registers_packed) == 0)
         {
             log_info("Woofer amp bypass configuration loaded");
         }
@@ -145,6 +182,15 @@ int board_link_amps_setup_woofer(board_link_amps_mode_t mode)
         board_link_amps_set_envelope_tracking_mode(AMP_ENVELOPE_TRACKING_MODE_OFF_MAX_PVDD);
     }
 
+#if CONFIG_AMPS_VOLUME_RAMP
+    // The configuration has its own volume, the amps start playing at the one of the ramp
+    if (tas5825p_set_fine_volume(s_amps.tas5825p, s_amps.volume_ramp.volume) != 0)
+    {
+        log_error("Failed to set woofer amp volume");
+        result = -1;
+    }
+#endif
+
     if (tas5825p_set_state(s_amps.tas5825p, TAS5825P_DEVICE_STATE_PLAY) != 0)
     {
         log_error("Failed to set woofer amp to Play state");
@@ -172,7 +218,10 @@ int board_link_amps_setup_tweeter(board_link_amps_mode_t mode)
     // Datasheet specifies that we need to wait at least 5 ms to allow the device to settle down after enabling the DSP
     thread_sleep_ms(10);
 
-    if (tas5805m_load_configuration(s_amps.tas5805m, tas5805m_config_registers, TAS5805M_CONFIG_REGISTERS_SIZE) == 0)
+    s_amps.treble_db      = EQ_LEVEL_UNKNOWN;
+    s_amps.eco_mode       = ECO_MODE_UNKNOWN;
+    s_amps.retention.mode = mode;
+    if (tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_config_registers_packed) == 0)
     {
         log_info("Tweeter amp configuration loaded");
     }
@@ -184,8 +233,7 @@ int board_link_amps_setup_tweeter(board_link_amps_mode_t mode)
 
     if (mode == AMP_MODE_BYPASS)
     {
-        if (tas5805m_load_configuration(s_amps.tas5805m, tas5805m_bypass_config_registers,
-                                        TAS5805M_BYPASS_CONFIG_REGISTERS_SIZE) == 0)
+        if (tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_bypass_config_registers_packed) == 0)
         {
             log_info("Tweeter amp bypass configuration loaded");
         }
@@ -208,6 +256,15 @@ int board_link_amps_setup_tweeter(board_link_amps_mode_t mode)
         }
     }
 
+#if CONFIG_AMPS_VOLUME_RAMP
+    // The configuration has its own volume, the amps start playing at the one of the ramp
+    if (tas5805m_set_fine_volume(s_amps.tas5805m, s_amps.volume_ramp.volume) != 0)
+    {
+        log_error("Failed to set tweeter amp volume");
+        result = -1;
+    }
+#endif
+
     if (tas5805m_set_state(s_amps.tas5805m, TAS5805M_DEVICE_STATE_PLAY) != 0)
     {
         log_error("Failed to set tweeter amp to Play state");
@@ -217,17 +274,62 @@ int board_link_amps_setup_tweeter(board_link_amps_mode_t mode)
     return result;
 }
 
+int board_link_amps_suspend(void)
+{
+    int result = 0;
+
+    // Deep sleep keeps the registers and the DSP memory, as long as PDN stays high and DVDD is supplied
+    if (tas5825p_set_state(s_amps.tas5825p, TAS5825P_DEVICE_STATE_DEEP_SLEEP) != 0)
+    {
+        log_error("Failed to set woofer amp to Deep Sleep state");
+        result = -1;
+    }
+
+    if (tas5805m_set_state(s_amps.tas5805m, TAS5805M_DEVICE_STATE_DEEP_SLEEP) != 0)
+    {
+        log_error("Failed to set tweeter amp to Deep Sleep state");
+        result = -1;
+    }
+
+    s_amps.retention.is_retained = (result == 0);
+    return result;
+}
+
+int board_link_amps_resume(board_link_amps_mode_t mode)
+{
+    const board_link_amps_retention_config_t config = {
+        .tas5825p                 = s_amps.tas5825p,
+        .tas5805m                 = s_amps.tas5805m,
+        .p_tas5825p_signature     = tas5825p_signature,
+        .tas5825p_signature_count = TAS5825P_SIGNATURE_COUNT,
+        .p_tas5805m_signature     = tas5805m_signature,
+        .tas5805m_signature_count = TAS5805M_SIGNATURE_COUNT,
+    };
+
+    if (board_link_amps_retention_resume(&config, &s_amps.retention, mode) != 0)
+    {
+        return -1;
+    }
+
+    // A loaded configuration leaves the amps unmuted as well
+    board_link_amps_mute(false);
+    log_info("Amps configuration retained");
+    return 0;
+}
+
 void board_link_amps_enable_eco_mode(bool enable)
 {
     int result = 0;
+
+    if (s_amps.eco_mode == (enable ? ECO_MODE_ON : ECO_MODE_OFF))
+    {
+        return;
+    }
     if (enable)
     {
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_normal_to_eco_mode_config_1,
-                                              TAS5825P_NORMAL_TO_ECO_CONFIG1_REGISTERS_SIZE);
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_normal_to_eco_mode_config_2,
-                                              TAS5825P_NORMAL_TO_ECO_CONFIG2_REGISTERS_SIZE);
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_normal_to_eco_mode_config_3,
-                                              TAS5825P_NORMAL_TO_ECO_CONFIG3_REGISTERS_SIZE);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_normal_to_eco_mode_config_1_packed);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_normal_to_eco_mode_config_2_packed);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_normal_to_eco_mode_config_3_packed);
 
         if (result == 0)
         {
@@ -238,10 +340,8 @@ void board_link_amps_enable_eco_mode(bool enable)
             log_error("Failed to load EcoMode configuration on woofer amp");
         }
 
-        result += tas5805m_load_configuration(s_amps.tas5805m, tas5805m_normal_to_eco_mode_config_1,
-                                              TAS5805M_NORMAL_TO_ECO_MODE_CONFIG1_REGISTERS_SIZE);
-        result += tas5805m_load_configuration(s_amps.tas5805m, tas5805m_normal_to_eco_mode_config_2,
-                                              TAS5805M_NORMAL_TO_ECO_MODE_CONFIG2_REGISTERS_SIZE);
+        result += tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_normal_to_eco_mode_config_1_packed);
+        result += tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_normal_to_eco_mode_config_2_packed);
 
         if (result == 0)
         {
@@ -254,12 +354,9 @@ void board_link_amps_enable_eco_mode(bool enable)
     }
     else
     {
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_eco_to_normal_mode_config_1,
-                                              TAS5825P_ECO_TO_NORMAL_CONFIG1_REGISTERS_SIZE);
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_eco_to_normal_mode_config_2,
-                                              TAS5825P_ECO_TO_NORMAL_CONFIG2_REGISTERS_SIZE);
-        result += tas5825p_load_configuration(s_amps.tas5825p, tas5825p_eco_to_normal_mode_config_3,
-                                              TAS5825P_ECO_TO_NORMAL_CONFIG3_REGISTERS_SIZE);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_eco_to_normal_mode_config_1_packed);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_eco_to_normal_mode_config_2_packed);
+        result += tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_eco_to_normal_mode_config_3_packed);
 
         if (result == 0)
         {
@@ -270,10 +367,8 @@ void board_link_amps_enable_eco_mode(bool enable)
             log_error("Failed to load non-EcoMode configuration on woofer amp");
         }
 
-        result += tas5805m_load_configuration(s_amps.tas5805m, tas5805m_eco_to_normal_mode_config_1,
-                                              TAS5805M_ECO_TO_NORMAL_MODE_CONFIG1_REGISTERS_SIZE);
-        result += tas5805m_load_configuration(s_amps.tas5805m, tas5805m_eco_to_normal_mode_config_2,
-                                              TAS5805M_ECO_TO_NORMAL_MODE_CONFIG2_REGISTERS_SIZE);
+        result += tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_eco_to_normal_mode_config_1_packed);
+        result += tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_eco_to_normal_mode_config_2_packed);
 
         if (result == 0)
         {
@@ -284,6 +379,8 @@ void board_link_amps_enable_eco_mode(bool enable)
             log_error("Failed to load non-EcoMode configuration on tweeter amp");
         }
     }
+
+    s_amps.eco_mode = (result != 0) ? ECO_MODE_UNKNOWN : (enable ? ECO_MODE_ON : ECO_MODE_OFF);
 }
 
 void board_link_amps_set_envelope_tracking_mode(board_link_amps_envelope_tracking_mode_t mode)
@@ -336,27 +433,49 @@ void board_link_amps_set_bass_level(int8_t bass_db)
         return;
     }
 
-    if (tas5825p_load_configuration(s_amps.tas5825p, tas5825p_bass_preconfig, TAS5825P_BASS_PRECONFIG_SIZE) != 0)
+    if (bass_db == s_amps.bass_db)
+    {
+        return;
+    }
+
+    if (tas5825p_load_packed_configuration(s_amps.tas5825p, &tas5825p_bass_preconfig_packed) != 0)
     {
         log_error("Failed to load bass preconfig");
         return;
     }
 
-    static const tas5825p_cfg_reg_t *bass_configs[] = {
-        tas5825p_bass_minus_6db_config, tas5825p_bass_minus_5db_config, tas5825p_bass_minus_4db_config,
-        tas5825p_bass_minus_3db_config, tas5825p_bass_minus_2db_config, tas5825p_bass_minus_1db_config,
-        tas5825p_bass_0db_config,       tas5825p_bass_plus_1db_config,  tas5825p_bass_plus_2db_config,
-        tas5825p_bass_plus_3db_config,  tas5825p_bass_plus_4db_config,  tas5825p_bass_plus_5db_config,
-        tas5825p_bass_plus_6db_config,
+    static const tasxxxx_packed_config_t *bass_configs[] = {
+        &tas5825p_bass_minus_6db_config_packed, &tas5825p_bass_minus_5db_config_packed,
+        &tas5825p_bass_minus_4db_config_packed, &tas5825p_bass_minus_3db_config_packed,
+        &tas5825p_bass_minus_2db_config_packed, &tas5825p_bass_minus_1db_config_packed,
+        &tas5825p_bass_0db_config_packed,       &tas5825p_bass_plus_1db_config_packed,
+        &tas5825p_bass_plus_2db_config_packed,  &tas5825p_bass_plus_3db_config_packed,
+        &tas5825p_bass_plus_4db_config_packed,  &tas5825p_bass_plus_5db_config_packed,
+        &tas5825p_bass_plus_6db_config_packed,
     };
 
-    uint8_t                   index         = bass_db + 6;
-    const tas5825p_cfg_reg_t *p_bass_config = bass_configs[index];
+    uint8_t                        index         = bass_db + 6;
+    const tasxxxx_packed_config_t *p_bass_config = bass_configs[index];
+
+    // A 1 dB step only writes the coefficients which differ from the current level, or the full level when the delta
+    // isn't smaller
+    if (s_amps.bass_db != EQ_LEVEL_UNKNOWN && bass_db == s_amps.bass_db + 1)
+    {
+        p_bass_config = &bass_steps_up[index - 1];
+    }
+    else if (s_amps.bass_db != EQ_LEVEL_UNKNOWN && bass_db == s_amps.bass_db - 1)
+    {
+        p_bass_config = &bass_steps_down[index];
+    }
 
-    if (tas5825p_load_configuration(s_amps.tas5825p, p_bass_config, TAS5825P_BASS_CONFIG_SIZE) != 0)
+    if (tas5825p_load_packed_configuration(s_amps.tas5825p, p_bass_config) != 0)
     {
         log_error("Failed to load bass config");
+        s_amps.bass_db = EQ_LEVEL_UNKNOWN;
+        return;
     }
+
+    s_amps.bass_db = bass_db;
 }
 
 void board_link_amps_set_treble_level(int8_t treble_db)
@@ -366,27 +485,38 @@ void board_link_amps_set_treble_level(int8_t treble_db)
         return;
     }
 
-    if (tas5805m_load_configuration(s_amps.tas5805m, tas5805m_treble_preconfig, TAS5805M_TREBLE_PRECONFIG_SIZE) != 0)
+    if (treble_db == s_amps.treble_db)
+    {
+        return;
+    }
+
+    if (tas5805m_load_packed_configuration(s_amps.tas5805m, &tas5805m_treble_preconfig_packed) != 0)
     {
         log_error("Failed to load treble preconfig");
         return;
     }
 
-    static const tas5805m_cfg_reg_t *treble_configs[] = {
-        tas5805m_treble_minus_6db_config, tas5805m_treble_minus_5db_config, tas5805m_treble_minus_4db_config,
-        tas5805m_treble_minus_3db_config, tas5805m_treble_minus_2db_config, tas5805m_treble_minus_1db_config,
-        tas5805m_treble_0db_config,       tas5805m_treble_plus_1db_config,  tas5805m_treble_plus_2db_config,
-        tas5805m_treble_plus_3db_config,  tas5805m_treble_plus_4db_config,  tas5805m_treble_plus_5db_config,
-        tas5805m_treble_plus_6db_config,
+    static const tasxxxx_packed_config_t *treble_configs[] = {
+        &tas5805m_treble_minus_6db_config_packed, &tas5805m_treble_minus_5db_config_packed,
+        &tas5805m_treble_minus_4db_config_packed, &tas5805m_treble_minus_3db_config_packed,
+        &tas5805m_treble_minus_2db_config_packed, &tas5805m_treble_minus_1db_config_packed,
+        &tas5805m_treble_0db_config_packed,       &tas5805m_treble_plus_1db_config_packed,
+        &tas5805m_treble_plus_2db_config_packed,  &tas5805m_treble_plus_3db_config_packed,
+        &tas5805m_treble_plus_4db_config_packed,  &tas5805m_treble_plus_5db_config_packed,
+        &tas5805m_treble_plus_6db_config_packed,
     };
 
-    uint8_t                   index           = treble_db + 6;
-    const tas5805m_cfg_reg_t *p_treble_config = treble_configs[index];
+    uint8_t                        index           = treble_db + 6;
+    const tasxxxx_packed_config_t *p_treble_config = treble_configs[index];
 
-    if (tas5805m_load_configuration(s_amps.tas5805m, p_treble_config, TAS5805M_TREBLE_CONFIG_SIZE) != 0)
+    if (tas5805m_load_packed_configuration(s_amps.tas5805m, p_treble_config) != 0)
     {
         log_error("Failed to load treble config");
+        s_amps.treble_db = EQ_LEVEL_UNKNOWN;
+        return;
     }
+
+    s_amps.treble_db = treble_db;
 }
 
 void board_link_amps_set_volume(int8_t volume_db)
@@ -431,6 +561,29 @@ int8_t board_link_amps_get_woofer_volume(void)
     return s_amps.woofer_volume_db;
 }
 
+void board_link_amps_ramp_volume_to(int16_t volume)
+{
+    tasxxxx_volume_ramp_set_target(&s_amps.volume_ramp, volume, get_systick());
+}
+
+bool board_link_amps_run_volume_ramp(void)
+{
+    if (!tasxxxx_volume_ramp_update(&s_amps.volume_ramp, get_systick()))
+    {
+        return tasxxxx_volume_ramp_is_running(&s_amps.volume_ramp);
+    }
+
+    // The next step, if any, writes the volume again after a failure
+    int result = 0;
+    result += tas5825p_set_fine_volume(s_amps.tas5825p, s_amps.volume_ramp.volume);
+    result += tas5805m_set_fine_volume(s_amps.tas5805m, s_amps.volume_ramp.volume);
+    if (result != 0)
+    {
+        log_error("Failed to set amps volume");
+    }
+    return tasxxxx_volume_ramp_is_running(&s_amps.volume_ramp);
+}
+
 void board_link_amps_mute(bool enable)
 {
     if (tas5805m_mute(s_amps.tas5805m, enable) == 0)
@@ -473,6 +626,26 @@ void board_link_amps_woofer_fault_recover(void)
     }
 }
 
+void board_link_amps_get_stats(board_link_amps_stats_t *p_woofer, board_link_amps_stats_t *p_tweeter)
+{
+    tas5825p_stats_t woofer;
+    tas5805m_stats_t tweeter;
+
+    tas5825p_get_stats(s_amps.tas5825p, &woofer);
+    tas5805m_get_stats(s_amps.tas5805m, &tweeter);
+
+    *p_woofer  = (board_link_amps_stats_t) {woofer.writes, woofer.reads, woofer.selections, woofer.selections_skipped,
+                                            woofer.configurations};
+    *p_tweeter = (board_link_amps_stats_t) {tweeter.writes, tweeter.reads, tweeter.selections,
+                                            tweeter.selections_skipped, tweeter.configurations};
+}
+
+void board_link_amps_reset_stats(void)
+{
+    tas5825p_reset_stats(s_amps.tas5825p);
+    tas5805m_reset_stats(s_amps.tas5805m);
+}
+
 static void thread_sleep_ms(uint32_t ms)
 {
     vTaskDelay(pdMS_TO_TICKS(ms));
@@ -16,6 +16,16 @@ typedef enum
     AMP_ENVELOPE_TRACKING_MODE_ON,
 } board_link_amps_envelope_tracking_mode_t;
 
+// I2C transactions of an amp driver, see tas5825p_stats_t/tas5805m_stats_t
+typedef struct
+{
+    uint32_t writes;
+    uint32_t reads;
+    uint32_t selections;
+    uint32_t selections_skipped;
+    uint32_t configurations;
+} board_link_amps_stats_t;
+
 #if defined(__cplusplus)
 extern "C"
 {
@@ -29,6 +39,25 @@ extern "C"
 
     int board_link_amps_setup_tweeter(board_link_amps_mode_t mode);
 
+    /**
+     * @brief Puts both amps in deep sleep, where they keep their configuration while the PDN pin stays high.
+     *
+     * @details The amps must be muted. Instead of disabling the amps, when the power budget allows it.
+     *
+     * @return 0 if successful, -1 otherwise (the amps must be disabled)
+     */
+    int board_link_amps_suspend(void);
+
+    /**
+     * @brief Brings the amps out of deep sleep if they kept the configuration of the mode, checked by reading back
+     *        the signature words of both configurations. The EQ levels and the eco mode are kept as well.
+     *
+     * @param[in] mode          mode the amps are set up for
+     *
+     * @return 0 if the amps are playing, -1 if they must be set up
+     */
+    int board_link_amps_resume(board_link_amps_mode_t mode);
+
     void board_link_amps_enable_eco_mode(bool enable);
 
     void board_link_amps_set_envelope_tracking_mode(board_link_amps_envelope_tracking_mode_t mode);
@@ -91,6 +120,20 @@ extern "C"
     int8_t board_link_amps_get_tweeter_volume(void);
     int8_t board_link_amps_get_woofer_volume(void);
 
+    /**
+     * @brief Ramps the volume of both amps to the target in fine steps, taken by board_link_amps_run_volume_ramp().
+     *
+     * @param[in] volume        volume in 1/TASXXXX_VOLUME_STEPS_PER_DB dB (see tasxxxx_volume_table.h)
+     */
+    void board_link_amps_ramp_volume_to(int16_t volume);
+
+    /**
+     * @brief Takes the steps of the volume ramp due by now, with a single write per amp.
+     *
+     * @return true while the ramp runs, it must be run again within CONFIG_AMPS_VOLUME_RAMP_PERIOD_MS
+     */
+    bool board_link_amps_run_volume_ramp(void);
+
     void board_link_amps_mute(bool enable);
 
     bool board_link_amps_is_muted(void);
@@ -98,6 +141,9 @@ extern "C"
     bool board_link_amps_woofer_fault_detected(void);
     void board_link_amps_woofer_fault_recover(void);
 
+    void board_link_amps_get_stats(board_link_amps_stats_t *p_woofer, board_link_amps_stats_t *p_tweeter);
+    void board_link_amps_reset_stats(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,46 @@
+#define LOG_LEVEL LOG_LEVEL_ERROR
+#include "logger.h"
+
+#include "board_link_amps_retention.h"
+
+int board_link_amps_retention_resume(const board_link_amps_retention_config_t *p_config,
+                                     board_link_amps_retention_t *p_retention, board_link_amps_mode_t mode)
+{
+    if (!p_retention->is_retained)
+    {
+        return -1;
+    }
+    p_retention->is_retained = false;
+
+    if (mode != p_retention->mode)
+    {
+        log_info("Amps configuration retained for another mode");
+        return -1;
+    }
+
+    // PVDD may have been removed, or DVDD with it in which case the amps are back to their defaults
+    if (tas5825p_check_signature(p_config->tas5825p, p_config->p_tas5825p_signature,
+                                 p_config->tas5825p_signature_count) != 0 ||
+        tas5805m_check_signature(p_config->tas5805m, p_config->p_tas5805m_signature,
+                                 p_config->tas5805m_signature_count) != 0)
+    {
+        log_warn("Amps didn't retain their configuration");
+        return -1;
+    }
+
+    // The amps latched the PVDD under voltage of the boost converter being off
+    int result = 0;
+    result += tas5825p_clear_analog_fault(p_config->tas5825p);
+    result += tas5805m_clear_analog_fault(p_config->tas5805m);
+    result += tas5825p_set_state(p_config->tas5825p, TAS5825P_DEVICE_STATE_HI_Z);
+    result += tas5805m_set_state(p_config->tas5805m, TAS5805M_DEVICE_STATE_HI_Z);
+    result += tas5825p_set_state(p_config->tas5825p, TAS5825P_DEVICE_STATE_PLAY);
+    result += tas5805m_set_state(p_config->tas5805m, TAS5805M_DEVICE_STATE_PLAY);
+    if (result != 0)
+    {
+        log_error("Failed to resume the amps");
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "board_link_amps.h"
+#include "tas5805m.h"
+#include "tas5825p.h"
+
+// The amps and the signature words of their configurations
+typedef struct
+{
+    tas5825p_handler_t               *tas5825p;
+    tas5805m_handler_t               *tas5805m;
+    const tasxxxx_packed_signature_t *p_tas5825p_signature;
+    uint32_t                          tas5825p_signature_count;
+    const tasxxxx_packed_signature_t *p_tas5805m_signature;
+    uint32_t                          tas5805m_signature_count;
+} board_link_amps_retention_config_t;
+
+typedef struct
+{
+    bool                   is_retained; // Both amps were put in deep sleep with their configuration
+    board_link_amps_mode_t mode;        // Mode of the loaded configuration
+} board_link_amps_retention_t;
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Decides whether the amps kept the configuration of the mode in deep sleep and brings them out of it.
+     *
+     * @details The retention is used once: it's only valid if the amps were suspended with the configuration of the
+     *          mode and both signatures read back. The latched PVDD fault is then cleared and the amps go through
+     *          Hi-Z to Play. It has no dependency on the HAL, so that it builds on the host.
+     *
+     * @param[in]     p_config      amps and their signatures
+     * @param[in,out] p_retention   retention state, no longer retained afterwards
+     * @param[in]     mode          mode the amps are set up for
+     *
+     * @return 0 if the amps are playing, -1 if they must be set up
+     */
+    int board_link_amps_retention_resume(const board_link_amps_retention_config_t *p_config,
+                                         board_link_amps_retention_t *p_retention, board_link_amps_mode_t mode);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -0,0 +1,305 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "eco_5805_config.h"
+#include "eco_5805_eco_mode_config.h"
+#include "eco_5805_patch_to_bypass_mode.h"
+#include "eco_5805_treble_config.h"
+#include "eco_5825_bass_config.h"
+#include "eco_5825_config.h"
+#include "eco_5825_eco_mode_config.h"
+#include "eco_5825_patch_to_bypass_mode.h"
+
+#include "amps_packed_config.h"
+}
+
+#include "tas_register_model.h"
+
+// Replays the PPC3 exported arrays with the original loaders of the drivers and the generated amps_packed_config.h
+// with the packed config loader, each into its own register model, and compares what the amps receive.
+
+using Bytes = TasRegisterModel::Bytes;
+using Trace = std::vector<std::pair<uint8_t, uint8_t>>; // (register, value) of every byte written
+
+static TasRegisterModel      s_amp;
+static std::vector<uint32_t> s_delays;
+
+static int model_read(uint8_t, uint8_t register_address, uint8_t *p_data, uint32_t length)
+{
+    return s_amp.read(register_address, p_data, length);
+}
+
+static int model_write(uint8_t, uint8_t register_address, const uint8_t *p_data, uint32_t length)
+{
+    return s_amp.write(register_address, p_data, length);
+}
+
+static void model_delay(uint32_t ms)
+{
+    s_delays.push_back(ms);
+}
+
+// The bursts are merged differently, the bytes and their order are the same
+static Trace trace(const TasRegisterModel &amp)
+{
+    Trace trace;
+    for (const auto &[register_address, data] : amp.writes)
+    {
+        for (size_t i = 0; i < data.size(); i++)
+        {
+            trace.emplace_back(static_cast<uint8_t>(register_address + i), data[i]);
+        }
+    }
+    return trace;
+}
+
+struct Load
+{
+    TasRegisterModel      amp;
+    std::vector<uint32_t> delays;
+};
+
+template <typename Fn>
+static Load run(const TasRegisterModel &initial, Fn load)
+{
+    s_amp = initial;
+    s_amp.writes.clear();
+    s_delays.clear();
+    EXPECT_EQ(load(), 0);
+    return {s_amp, s_delays};
+}
+
+static Load load_packed(const TasRegisterModel &initial, const tasxxxx_packed_config_t &config)
+{
+    return run(initial, [&] { return tasxxxx_packed_config_load(&config, model_write, model_delay, 0x4C); });
+}
+
+template <typename Handler, typename Reg, typename LoadFn>
+static Load load_array(const TasRegisterModel &initial, Handler *h, LoadFn load_fn, const Reg *p_array, size_t length)
+{
+    return run(initial, [&] { return load_fn(h, p_array, static_cast<uint32_t>(length)); });
+}
+
+template <typename Reg>
+struct Table
+{
+    const char                    *name;
+    const Reg                     *p_array;
+    size_t                         length;
+    const tasxxxx_packed_config_t *p_packed;
+};
+
+#define TABLE(name) {#name, name, sizeof(name) / sizeof(name[0]), &name##_packed}
+
+static const Table<tas5825p_cfg_reg_t> c_tas5825p_tables[] = {
+    TABLE(tas5825p_config_registers),
+    TABLE(tas5825p_bypass_config_registers),
+    TABLE(tas5825p_normal_to_eco_mode_config_1),
+    TABLE(tas5825p_normal_to_eco_mode_config_2),
+    TABLE(tas5825p_normal_to_eco_mode_config_3),
+    TABLE(tas5825p_eco_to_normal_mode_config_1),
+    TABLE(tas5825p_eco_to_normal_mode_config_2),
+    TABLE(tas5825p_eco_to_normal_mode_config_3),
+    TABLE(tas5825p_bass_preconfig),
+    TABLE(tas5825p_bass_minus_6db_config),
+    TABLE(tas5825p_bass_minus_5db_config),
+    TABLE(tas5825p_bass_minus_4db_config),
+    TABLE(tas5825p_bass_minus_3db_config),
+    TABLE(tas5825p_bass_minus_2db_config),
+    TABLE(tas5825p_bass_minus_1db_config),
+    TABLE(tas5825p_bass_0db_config),
+    TABLE(tas5825p_bass_plus_1db_config),
+    TABLE(tas5825p_bass_plus_2db_config),
+    TABLE(tas5825p_bass_plus_3db_config),
+    TABLE(tas5825p_bass_plus_4db_config),
+    TABLE(tas5825p_bass_plus_5db_config),
+    TABLE(tas5825p_bass_plus_6db_config),
+};
+
+static const Table<tas5805m_cfg_reg_t> c_tas5805m_tables[] = {
+    TABLE(tas5805m_config_registers),
+    TABLE(tas5805m_bypass_config_registers),
+    TABLE(tas5805m_normal_to_eco_mode_config_1),
+    TABLE(tas5805m_normal_to_eco_mode_config_2),
+    TABLE(tas5805m_eco_to_normal_mode_config_1),
+    TABLE(tas5805m_eco_to_normal_mode_config_2),
+    TABLE(tas5805m_treble_preconfig),
+    TABLE(tas5805m_treble_minus_6db_config),
+    TABLE(tas5805m_treble_minus_5db_config),
+    TABLE(tas5805m_treble_minus_4db_config),
+    TABLE(tas5805m_treble_minus_3db_config),
+    TABLE(tas5805m_treble_minus_2db_config),
+    TABLE(tas5805m_treble_minus_1db_config),
+    TABLE(tas5805m_treble_0db_config),
+    TABLE(tas5805m_treble_plus_1db_config),
+    TABLE(tas5805m_treble_plus_2db_config),
+    TABLE(tas5805m_treble_plus_3db_config),
+    TABLE(tas5805m_treble_plus_4db_config),
+    TABLE(tas5805m_treble_plus_5db_config),
+    TABLE(tas5805m_treble_plus_6db_config),
+};
+
+class AmpsPackedConfigTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        static const tas5825p_config_t tas5825p_config = {model_read, model_write, model_delay, 0x4C};
+        static const tas5805m_config_t tas5805m_config = {model_read, model_write, model_delay, 0x2D};
+        static tas5825p_handler_t     *p_tas5825p      = tas5825p_init(&tas5825p_config);
+        static tas5805m_handler_t     *p_tas5805m      = tas5805m_init(&tas5805m_config);
+
+        tas5825p = p_tas5825p;
+        tas5805m = p_tas5805m;
+    }
+
+    template <typename Handler, typename Reg, typename LoadFn>
+    static void expect_same_writes(Handler *h, LoadFn load_fn, const Table<Reg> &table, const TasRegisterModel &initial)
+    {
+        SCOPED_TRACE(table.name);
+
+        const Load original = load_array(initial, h, load_fn, table.p_array, table.length);
+        const Load packed   = load_packed(initial, *table.p_packed);
+
+        EXPECT_EQ(trace(packed.amp), trace(original.amp));
+        EXPECT_EQ(packed.delays, original.delays);
+        EXPECT_EQ(packed.amp.registers, original.amp.registers);
+        EXPECT_LE(packed.amp.writes.size(), original.amp.writes.size());
+    }
+
+    // The signature words are the values the configuration (first table) leaves behind, on pages which no other
+    // table writes, so that loading any of them keeps the signature
+    template <typename Handler, typename Reg, typename LoadFn, size_t N>
+    static void expect_signature_on_own_pages(Handler *h, LoadFn load_fn, const Table<Reg> (&tables)[N],
+                                              const tasxxxx_packed_signature_t *p_signature, size_t count)
+    {
+        const Load configured = load_array(TasRegisterModel(), h, load_fn, tables[0].p_array, tables[0].length);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const tasxxxx_packed_signature_t &word = p_signature[i];
+            SCOPED_TRACE("word " + std::to_string(i));
+
+            for (uint8_t j = 0; j < 4; j++)
+            {
+                const uint8_t register_address = static_cast<uint8_t>(word.register_address + j);
+                const auto    it = configured.amp.registers.find({word.book, word.page, register_address});
+                ASSERT_NE(it, configured.amp.registers.end());
+                EXPECT_EQ(it->second, word.value[j]);
+            }
+
+            // The EQ levels write to the page their preconfiguration selected, so the tables are loaded in order
+            TasRegisterModel previous = configured.amp;
+            for (size_t t = 1; t < N; t++)
+            {
+                SCOPED_TRACE(tables[t].name);
+
+                // Only what the table writes
+                previous.registers.clear();
+                previous = load_array(previous, h, load_fn, tables[t].p_array, tables[t].length).amp;
+                const auto on_page = std::count_if(previous.registers.begin(), previous.registers.end(), [&](auto &r) {
+                    return std::get<0>(r.first) == word.book && std::get<1>(r.first) == word.page;
+                });
+                EXPECT_EQ(on_page, 0);
+            }
+        }
+    }
+
+    tas5825p_handler_t *tas5825p = nullptr;
+    tas5805m_handler_t *tas5805m = nullptr;
+};
+
+TEST_F(AmpsPackedConfigTest, Tas5825pTablesWriteTheSameBytes)
+{
+    // The EQ and eco mode tables are loaded on top of the configuration
+    const Load configured =
+        load_array(TasRegisterModel(), tas5825p, tas5825p_load_configuration, tas5825p_config_registers,
+                   sizeof(tas5825p_config_registers) / sizeof(tas5825p_config_registers[0]));
+
+    for (const auto &table : c_tas5825p_tables)
+    {
+        expect_same_writes(tas5825p, tas5825p_load_configuration, table, configured.amp);
+    }
+}
+
+TEST_F(AmpsPackedConfigTest, Tas5805mTablesWriteTheSameBytes)
+{
+    const Load configured =
+        load_array(TasRegisterModel(), tas5805m, tas5805m_load_configuration, tas5805m_config_registers,
+                   sizeof(tas5805m_config_registers) / sizeof(tas5805m_config_registers[0]));
+
+    for (const auto &table : c_tas5805m_tables)
+    {
+        expect_same_writes(tas5805m, tas5805m_load_configuration, table, configured.amp);
+    }
+}
+
+TEST_F(AmpsPackedConfigTest, Tas5825pSignatureIsOnItsOwnPages)
+{
+    EXPECT_EQ(TAS5825P_SIGNATURE_COUNT, 4u);
+    expect_signature_on_own_pages(tas5825p, tas5825p_load_configuration, c_tas5825p_tables, tas5825p_signature,
+                                  TAS5825P_SIGNATURE_COUNT);
+}
+
+TEST_F(AmpsPackedConfigTest, Tas5805mSignatureIsOnItsOwnPages)
+{
+    EXPECT_EQ(TAS5805M_SIGNATURE_COUNT, 4u);
+    expect_signature_on_own_pages(tas5805m, tas5805m_load_configuration, c_tas5805m_tables, tas5805m_signature,
+                                  TAS5805M_SIGNATURE_COUNT);
+}
+
+TEST_F(AmpsPackedConfigTest, BassStepsReachTheNextLevel)
+{
+    const tasxxxx_packed_config_t *levels[] = {
+        &tas5825p_bass_minus_6db_config_packed, &tas5825p_bass_minus_5db_config_packed,
+        &tas5825p_bass_minus_4db_config_packed, &tas5825p_bass_minus_3db_config_packed,
+        &tas5825p_bass_minus_2db_config_packed, &tas5825p_bass_minus_1db_config_packed,
+        &tas5825p_bass_0db_config_packed,       &tas5825p_bass_plus_1db_config_packed,
+        &tas5825p_bass_plus_2db_config_packed,  &tas5825p_bass_plus_3db_config_packed,
+        &tas5825p_bass_plus_4db_config_packed,  &tas5825p_bass_plus_5db_config_packed,
+        &tas5825p_bass_plus_6db_config_packed,
+    };
+
+    const Load configured = load_packed(TasRegisterModel(), tas5825p_config_registers_packed);
+    const Load preconfig  = load_packed(configured.amp, tas5825p_bass_preconfig_packed);
+
+    for (size_t i = 0; i < BASS_STEPS_COUNT; i++)
+    {
+        SCOPED_TRACE("level " + std::to_string(static_cast<int>(i) - 6));
+
+        const Load lower = load_packed(preconfig.amp, *levels[i]);
+        const Load upper = load_packed(preconfig.amp, *levels[i + 1]);
+
+        EXPECT_EQ(load_packed(lower.amp, bass_steps_up[i]).amp.registers, upper.amp.registers);
+        EXPECT_EQ(load_packed(upper.amp, bass_steps_down[i]).amp.registers, lower.amp.registers);
+    }
+}
+
+TEST_F(AmpsPackedConfigTest, PackedTablesAreSmaller)
+{
+    size_t original_bytes = 0;
+    size_t packed_bytes   = 0;
+
+    for (const auto &table : c_tas5825p_tables)
+    {
+        original_bytes += table.length * sizeof(tas5825p_cfg_reg_t);
+        packed_bytes += table.p_packed->length;
+    }
+    for (const auto &table : c_tas5805m_tables)
+    {
+        original_bytes += table.length * sizeof(tas5805m_cfg_reg_t);
+        packed_bytes += table.p_packed->length;
+    }
+
+    std::printf("%zu bytes of PPC3 arrays, %zu bytes packed, %zu bytes of blob\n", original_bytes, packed_bytes,
+                sizeof(amps_packed_config_blob));
+    EXPECT_LT(sizeof(amps_packed_config_blob), original_bytes);
+}
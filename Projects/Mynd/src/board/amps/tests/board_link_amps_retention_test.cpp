@@ -0,0 +1,171 @@
+#include <cstdint>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "amps_packed_config.h"
+#include "board_link_amps_retention.h"
+}
+
+#include "tas_register_model.h"
+
+// Suspends both amps with the generated configurations and signatures loaded and resumes them through
+// board_link_amps_retention_resume(), as board_link_amps_resume() does.
+
+static constexpr uint8_t WOOFER_ADDRESS  = 0x4C;
+static constexpr uint8_t TWEETER_ADDRESS = 0x2D;
+
+static constexpr uint8_t REG_DEVICE_CTRL_2 = 0x03;
+static constexpr uint8_t REG_FAULT_CLEAR   = 0x78;
+
+static TasRegisterModel s_woofer;
+static TasRegisterModel s_tweeter;
+
+static TasRegisterModel &amp(uint8_t i2c_address)
+{
+    return (i2c_address == WOOFER_ADDRESS) ? s_woofer : s_tweeter;
+}
+
+static int model_read(uint8_t i2c_address, uint8_t register_address, uint8_t *p_data, uint32_t length)
+{
+    return amp(i2c_address).read(register_address, p_data, length);
+}
+
+static int model_write(uint8_t i2c_address, uint8_t register_address, const uint8_t *p_data, uint32_t length)
+{
+    return amp(i2c_address).write(register_address, p_data, length);
+}
+
+static void model_delay(uint32_t) {}
+
+// (register, value) of the fault clear and device state writes on book 0, page 0
+static std::vector<std::pair<uint8_t, uint8_t>> state_writes(const TasRegisterModel &amp)
+{
+    std::vector<std::pair<uint8_t, uint8_t>> writes;
+    for (const auto &[register_address, data] : amp.writes)
+    {
+        if (register_address == REG_FAULT_CLEAR || register_address == REG_DEVICE_CTRL_2)
+        {
+            writes.emplace_back(register_address, data[0]);
+        }
+    }
+    return writes;
+}
+
+class BoardLinkAmpsRetentionTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        static const tas5825p_config_t tas5825p_config = {model_read, model_write, model_delay, WOOFER_ADDRESS};
+        static const tas5805m_config_t tas5805m_config = {model_read, model_write, model_delay, TWEETER_ADDRESS};
+        static tas5825p_handler_t     *p_tas5825p      = tas5825p_init(&tas5825p_config);
+        static tas5805m_handler_t     *p_tas5805m      = tas5805m_init(&tas5805m_config);
+
+        config = {p_tas5825p, p_tas5805m, tas5825p_signature, TAS5825P_SIGNATURE_COUNT,
+                  tas5805m_signature, TAS5805M_SIGNATURE_COUNT};
+
+        s_woofer  = TasRegisterModel();
+        s_tweeter = TasRegisterModel();
+
+        // Setup in normal mode with an EQ level and eco mode on top, then board_link_amps_suspend()
+        ASSERT_EQ(tas5825p_load_packed_configuration(p_tas5825p, &tas5825p_config_registers_packed), 0);
+        ASSERT_EQ(tas5805m_load_packed_configuration(p_tas5805m, &tas5805m_config_registers_packed), 0);
+        ASSERT_EQ(tas5825p_load_packed_configuration(p_tas5825p, &tas5825p_bass_preconfig_packed), 0);
+        ASSERT_EQ(tas5825p_load_packed_configuration(p_tas5825p, &tas5825p_bass_plus_3db_config_packed), 0);
+        ASSERT_EQ(tas5805m_load_packed_configuration(p_tas5805m, &tas5805m_treble_preconfig_packed), 0);
+        ASSERT_EQ(tas5805m_load_packed_configuration(p_tas5805m, &tas5805m_treble_minus_2db_config_packed), 0);
+        ASSERT_EQ(tas5825p_load_packed_configuration(p_tas5825p, &tas5825p_normal_to_eco_mode_config_1_packed), 0);
+        ASSERT_EQ(tas5805m_load_packed_configuration(p_tas5805m, &tas5805m_normal_to_eco_mode_config_1_packed), 0);
+        ASSERT_EQ(tas5825p_set_state(p_tas5825p, TAS5825P_DEVICE_STATE_DEEP_SLEEP), 0);
+        ASSERT_EQ(tas5805m_set_state(p_tas5805m, TAS5805M_DEVICE_STATE_DEEP_SLEEP), 0);
+
+        retention = {true, AMP_MODE_NORMAL};
+        s_woofer.writes.clear();
+        s_tweeter.writes.clear();
+        s_woofer.reads  = 0;
+        s_tweeter.reads = 0;
+    }
+
+    int resume(board_link_amps_mode_t mode)
+    {
+        return board_link_amps_retention_resume(&config, &retention, mode);
+    }
+
+    board_link_amps_retention_config_t config    = {};
+    board_link_amps_retention_t        retention = {};
+};
+
+TEST_F(BoardLinkAmpsRetentionTest, RetainedConfigurationIsResumed)
+{
+    const auto woofer_registers  = s_woofer.registers;
+    const auto tweeter_registers = s_tweeter.registers;
+
+    EXPECT_EQ(resume(AMP_MODE_NORMAL), 0);
+    EXPECT_FALSE(retention.is_retained);
+
+    // Only the book 0 registers change, the configuration is kept
+    for (const auto &[registers, amp] : {std::pair{&woofer_registers, &s_woofer}, {&tweeter_registers, &s_tweeter}})
+    {
+        for (const auto &[address, value] : *registers)
+        {
+            if (std::get<0>(address) != 0x00)
+            {
+                EXPECT_EQ(amp->registers.at(address), value);
+            }
+        }
+
+        // Fault clear, then Hi-Z and Play
+        const auto writes = state_writes(*amp);
+        ASSERT_EQ(writes.size(), 3u);
+        EXPECT_EQ(writes[0], std::make_pair(REG_FAULT_CLEAR, uint8_t{0x80}));
+        EXPECT_EQ(writes[1].first, REG_DEVICE_CTRL_2);
+        EXPECT_EQ(writes[1].second & 0x03, TAS5825P_DEVICE_STATE_HI_Z);
+        EXPECT_EQ(writes[2].first, REG_DEVICE_CTRL_2);
+        EXPECT_EQ(writes[2].second & 0x03, TAS5825P_DEVICE_STATE_PLAY);
+    }
+
+    // The retention is used once
+    s_woofer.reads = 0;
+    EXPECT_EQ(resume(AMP_MODE_NORMAL), -1);
+    EXPECT_EQ(s_woofer.reads, 0u);
+}
+
+TEST_F(BoardLinkAmpsRetentionTest, NotRetained)
+{
+    retention.is_retained = false;
+
+    EXPECT_EQ(resume(AMP_MODE_NORMAL), -1);
+    EXPECT_TRUE(s_woofer.writes.empty());
+    EXPECT_TRUE(s_tweeter.writes.empty());
+}
+
+TEST_F(BoardLinkAmpsRetentionTest, OtherModeIsSetUp)
+{
+    EXPECT_EQ(resume(AMP_MODE_BYPASS), -1);
+    EXPECT_FALSE(retention.is_retained);
+    EXPECT_EQ(s_woofer.reads, 0u);
+    EXPECT_EQ(s_tweeter.reads, 0u);
+}
+
+TEST_F(BoardLinkAmpsRetentionTest, LostConfigurationIsSetUp)
+{
+    // DVDD was removed from the tweeter only
+    s_tweeter.power_down();
+
+    EXPECT_EQ(resume(AMP_MODE_NORMAL), -1);
+    EXPECT_FALSE(retention.is_retained);
+    EXPECT_TRUE(state_writes(s_woofer).empty());
+    EXPECT_TRUE(state_writes(s_tweeter).empty());
+}
+
+TEST_F(BoardLinkAmpsRetentionTest, I2cFailureIsSetUp)
+{
+    s_woofer.fail = true;
+
+    EXPECT_EQ(resume(AMP_MODE_NORMAL), -1);
+    EXPECT_TRUE(state_writes(s_tweeter).empty());
+}
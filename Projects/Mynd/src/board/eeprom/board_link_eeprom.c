@@ -1,6 +1,7 @@
 // Due to the flash size limit, only the WARNING level is available
-// for use in the complete firmware (including the bootloader).
-#if defined(BOOTLOADER)
+// for use in the complete firmware (including the bootloader),
+// unless the binary logger keeps the format strings out of the flash.
+#if defined(BOOTLOADER) && !defined(LOGGER_BINARY)
 #define LOG_LEVEL LOG_LEVEL_ERROR
 #else
 #define LOG_LEVEL LOG_LEVEL_INFO
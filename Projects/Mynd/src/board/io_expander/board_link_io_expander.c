@@ -3,7 +3,12 @@
 #include "board_hw.h"
 #include "bsp_shared_i2c.h"
 #include "aw9523b.h"
+#include "board.h"
 #include "logger.h"
+#include <string.h>
+
+#include "FreeRTOS.h"
+#include "semphr.h"
 
 #define BT_BUTTON_PORT_PIN    AW9523B_P0_2
 #define PLAY_BUTTON_PORT_PIN  AW9523B_P0_3
@@ -18,6 +23,8 @@
 #define STATUS_LED_G_PORT_PIN AW9523B_P1_5
 #define STATUS_LED_B_PORT_PIN AW9523B_P1_4
 
+#define LED_CHANNELS 3u
+
 static struct
 {
     aw9523b_handler_t                         *p_handler;
@@ -25,6 +32,24 @@ static struct
     bool                                       is_initialized;
 } s_io_expander;
 
+// Last PWM values written to the dimming registers of the LEDs, in register order. The LEDs are only written where
+// their values changed, the cache is invalidated whenever the registers may not hold them anymore.
+typedef struct
+{
+    uint8_t pwm[LED_CHANNELS];
+    bool    is_valid;
+} led_cache_t;
+
+static struct
+{
+    led_cache_t                        status_bgr;
+    led_cache_t                        source_rgb;
+    board_link_io_expander_led_stats_t stats;
+    uint32_t                           stats_reset_ms;
+    SemaphoreHandle_t                  mutex;
+    StaticSemaphore_t                  mutex_buffer;
+} s_led_output;
+
 static const char initialization_error_str[] = "IO expander used before initialization";
 
 static int i2c_write(uint8_t i2c_address, uint8_t register_address, uint8_t *p_buffer, uint16_t length);
@@ -72,6 +97,12 @@ void board_link_io_expander_init(void)
     GPIO_InitStruct.Speed = IO_EXP_INT_GPIO_SPEED;
     HAL_GPIO_Init(IO_EXP_INT_GPIO_PORT, &GPIO_InitStruct);
 
+    s_led_output.mutex = xSemaphoreCreateMutexStatic(&s_led_output.mutex_buffer);
+    if (s_led_output.mutex == NULL)
+    {
+        log_error("Failed to create the LED output mutex");
+    }
+
     s_io_expander.p_handler = aw9523b_init(&driver_config);
     if (s_io_expander.p_handler == NULL)
     {
@@ -99,7 +130,9 @@ void board_link_io_expander_reset(bool assert)
 
     if (assert)
     {
-        s_io_expander.is_initialized = false;
+        s_io_expander.is_initialized    = false;
+        s_led_output.status_bgr.is_valid = false;
+        s_led_output.source_rgb.is_valid = false;
     }
 
     log_info("IO expander reset %s", assert ? "asserted" : "deasserted");
@@ -118,6 +151,10 @@ int board_link_io_expander_setup_for_normal_operation(void)
     // Configure LED1 GPIOs as LEDs
     result += aw9523b_config_port(s_io_expander.p_handler, AW9523B_PORT1, 0x77, AW9523B_PORT_MODE_LED);
 
+    // The software reset cleared the dimming registers
+    s_led_output.status_bgr.is_valid = false;
+    s_led_output.source_rgb.is_valid = false;
+
     if (result == 0)
     {
         log_info("IO expander initialized");
@@ -157,25 +194,164 @@ int board_link_io_expander_get_all_buttons(uint8_t *p_state)
     return 0;
 }
 
-int board_link_io_expander_set_status_led(uint8_t r, uint8_t g, uint8_t b)
+// Contiguous run of dimming registers to write
+typedef struct
 {
-    if (s_io_expander.is_initialized == false)
+    uint8_t reg_address;
+    uint8_t length;
+    uint8_t pwm[2 * LED_CHANNELS];
+} led_write_t;
+
+// Adds the channels of an LED that differ from the cache to the write, from the first to the last changed one: the
+// unchanged channels in between are written again rather than splitting the write. Returns false if none changed.
+static bool get_changed_channels(const led_cache_t *p_cache, const uint8_t *p_pwm, uint8_t first_reg_address,
+                                 led_write_t *p_write)
+{
+    int first = -1, last = -1;
+
+    for (int i = 0; i < (int) LED_CHANNELS; i++)
     {
-        log_error("%s", initialization_error_str);
-        return -1;
+        if (!p_cache->is_valid || p_cache->pwm[i] != p_pwm[i])
+        {
+            first = (first < 0) ? i : first;
+            last  = i;
+        }
     }
 
-    // The order of RGB pins was inverted
-    return aw9523b_set_dimming_multi(s_io_expander.p_handler, STATUS_LED_B_PORT_PIN, (uint8_t[]){b, g, r}, 3);
+    if (first < 0)
+    {
+        return false;
+    }
+
+    p_write->reg_address = (uint8_t) (first_reg_address + first);
+    p_write->length      = (uint8_t) (last - first + 1);
+    memcpy(p_write->pwm, &p_pwm[first], p_write->length);
+    return true;
 }
 
-int board_link_io_expander_set_source_led(uint8_t r, uint8_t g, uint8_t b)
+static void update_cache(led_cache_t *p_cache, const uint8_t *p_pwm)
 {
+    if (p_pwm != NULL)
+    {
+        memcpy(p_cache->pwm, p_pwm, LED_CHANNELS);
+        p_cache->is_valid = true;
+    }
+}
+
+// Writes the LEDs given (either may be NULL), in register order, in a single bus transaction: one burst when the
+// changed registers of both LEDs are contiguous, a batch of two writes otherwise
+static int write_leds(const uint8_t *p_status_bgr, const uint8_t *p_source_rgb)
+{
+    led_write_t writes[2];
+    size_t      count  = 0;
+    int         result = 0;
+
     if (s_io_expander.is_initialized == false)
     {
         log_error("%s", initialization_error_str);
         return -1;
     }
 
-    return aw9523b_set_dimming_multi(s_io_expander.p_handler, SOURCE_LED_R_PORT_PIN, (uint8_t[]){r, g, b}, 3);
+    xSemaphoreTake(s_led_output.mutex, portMAX_DELAY);
+
+    s_led_output.stats.updates++;
+
+    if (p_status_bgr != NULL &&
+        get_changed_channels(&s_led_output.status_bgr, p_status_bgr,
+                             (uint8_t) aw9523b_get_dimming_register(STATUS_LED_B_PORT_PIN), &writes[count]))
+    {
+        count++;
+    }
+
+    if (p_source_rgb != NULL &&
+        get_changed_channels(&s_led_output.source_rgb, p_source_rgb,
+                             (uint8_t) aw9523b_get_dimming_register(SOURCE_LED_R_PORT_PIN), &writes[count]))
+    {
+        count++;
+    }
+
+    if (count == 2 && writes[1].reg_address < writes[0].reg_address)
+    {
+        led_write_t first = writes[1];
+        writes[1]         = writes[0];
+        writes[0]         = first;
+    }
+
+    if (count == 2 && writes[0].reg_address + writes[0].length == writes[1].reg_address)
+    {
+        memcpy(&writes[0].pwm[writes[0].length], writes[1].pwm, writes[1].length);
+        writes[0].length = (uint8_t) (writes[0].length + writes[1].length);
+        count            = 1;
+    }
+
+    if (count == 0)
+    {
+        s_led_output.stats.skipped++;
+        xSemaphoreGive(s_led_output.mutex);
+        return 0;
+    }
+
+    i2c_rtos_transfer_t transfers[2];
+    for (size_t i = 0; i < count; i++)
+    {
+        transfers[i] = (i2c_rtos_transfer_t) {
+            .i2c_address      = AW9523B_I2C_ADDRESS,
+            .reg_address      = writes[i].reg_address,
+            .reg_address_size = 1,
+            .direction        = I2C_RTOS_WRITE,
+            .p_buffer         = writes[i].pwm,
+            .length           = writes[i].length,
+        };
+        s_led_output.stats.bytes += writes[i].length;
+    }
+    s_led_output.stats.transactions++;
+
+    if (bsp_shared_i2c_transfer_batch(transfers, count) < 0)
+    {
+        // The registers may hold anything, they are all written again on the next update
+        s_led_output.status_bgr.is_valid = false;
+        s_led_output.source_rgb.is_valid = false;
+        result                           = -1;
+    }
+    else
+    {
+        update_cache(&s_led_output.status_bgr, p_status_bgr);
+        update_cache(&s_led_output.source_rgb, p_source_rgb);
+    }
+
+    xSemaphoreGive(s_led_output.mutex);
+    return result;
+}
+
+int board_link_io_expander_set_status_led(uint8_t r, uint8_t g, uint8_t b)
+{
+    // The order of RGB pins was inverted
+    return write_leds((const uint8_t[]){b, g, r}, NULL);
+}
+
+int board_link_io_expander_set_source_led(uint8_t r, uint8_t g, uint8_t b)
+{
+    return write_leds(NULL, (const uint8_t[]){r, g, b});
+}
+
+int board_link_io_expander_set_leds(const uint8_t *p_status_rgb, const uint8_t *p_source_rgb)
+{
+    // The order of RGB pins of the status LED was inverted
+    return write_leds((const uint8_t[]){p_status_rgb[2], p_status_rgb[1], p_status_rgb[0]}, p_source_rgb);
+}
+
+void board_link_io_expander_get_led_stats(board_link_io_expander_led_stats_t *p_stats)
+{
+    xSemaphoreTake(s_led_output.mutex, portMAX_DELAY);
+    *p_stats            = s_led_output.stats;
+    p_stats->elapsed_ms = board_get_ms_since(s_led_output.stats_reset_ms);
+    xSemaphoreGive(s_led_output.mutex);
+}
+
+void board_link_io_expander_reset_led_stats(void)
+{
+    xSemaphoreTake(s_led_output.mutex, portMAX_DELAY);
+    memset(&s_led_output.stats, 0, sizeof(s_led_output.stats));
+    s_led_output.stats_reset_ms = get_systick();
+    xSemaphoreGive(s_led_output.mutex);
 }
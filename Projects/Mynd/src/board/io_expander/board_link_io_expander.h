@@ -20,6 +20,18 @@ extern "C"
      */
     typedef void (*board_link_io_expander_interrupt_handler_t)(void);
 
+    /**
+     * @brief Statistics of the LED output since the last reset.
+     */
+    typedef struct
+    {
+        uint32_t updates;      // LED updates requested
+        uint32_t skipped;      // updates without a changed channel, that didn't reach the bus
+        uint32_t transactions; // I2C transactions (single writes or batches)
+        uint32_t bytes;        // PWM values written
+        uint32_t elapsed_ms;
+    } board_link_io_expander_led_stats_t;
+
     /**
      * @brief Initializes the IO expander.
      */
@@ -60,7 +72,8 @@ extern "C"
     int board_link_io_expander_get_all_buttons(uint8_t *p_state);
 
     /**
-     * @brief Sets the PWM of all channels of the status LED.
+     * @brief Sets the PWM of all channels of the status LED. The set_*_led() functions only write the channels that
+     *        changed since the last write.
      *
      * @param[in] r                 pwm value for the R channel
      * @param[in] g                 pwm value for the G channel
@@ -81,6 +94,28 @@ extern "C"
      */
     int board_link_io_expander_set_source_led(uint8_t r, uint8_t g, uint8_t b);
 
+    /**
+     * @brief Sets the PWM of all channels of both LEDs in a single I2C batch.
+     *
+     * @param[in] p_status_rgb      pwm values for the R, G and B channels of the status LED
+     * @param[in] p_source_rgb      pwm values for the R, G and B channels of the source LED
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int board_link_io_expander_set_leds(const uint8_t *p_status_rgb, const uint8_t *p_source_rgb);
+
+    /**
+     * @brief Gets the statistics of the LED output since the last reset.
+     *
+     * @param[out] p_stats          statistics
+     */
+    void board_link_io_expander_get_led_stats(board_link_io_expander_led_stats_t *p_stats);
+
+    /**
+     * @brief Resets the statistics of the LED output.
+     */
+    void board_link_io_expander_reset_led_stats(void);
+
 #if defined(__cplusplus)
 }
 #endif
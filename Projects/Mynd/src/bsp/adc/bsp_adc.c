@@ -205,6 +205,11 @@ void bsp_adc_stop(void)
     HAL_ADC_Stop_DMA(&Adc1Handle);
 }
 
+bool bsp_adc_is_busy(void)
+{
+    return (HAL_ADC_GetState(&Adc1Handle) & HAL_ADC_STATE_REG_BUSY) != 0u;
+}
+
 void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef *hadc)
 {
     (void) hadc;
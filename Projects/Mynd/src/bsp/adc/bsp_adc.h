@@ -17,6 +17,11 @@ extern "C"
     void bsp_adc_start(uint32_t *buffer, uint32_t buffer_size, bsp_adc_conversion_complete_callback_t callback);
     void bsp_adc_stop(void);
 
+    /**
+     * @brief Checks whether the conversions run, the STOP mode would interrupt them.
+     */
+    bool bsp_adc_is_busy(void);
+
 #if defined(__cplusplus)
 }
 #endif
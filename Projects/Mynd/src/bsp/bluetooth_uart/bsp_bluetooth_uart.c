@@ -1,4 +1,5 @@
 #include "bsp_bluetooth_uart.h"
+#include "bsp_bluetooth_uart_dma_rx.h"
 #include "board_hw.h"
 #include "FreeRTOS.h"
 #include "stream_buffer.h"
@@ -8,15 +9,36 @@
 #include "logger.h"
 #include <stdbool.h>
 
+// The Actionslink frames are HDLC encoded, so every frame starts and ends with this character
+#define HDLC_FRAME_DELIMITER (0x7Eu)
+
 UART_HandleTypeDef          UART1_Handle;
+static DMA_HandleTypeDef    DmaRxHandle;
+static DMA_HandleTypeDef    DmaTxHandle;
 static StreamBufferHandle_t sbuffer_handle_rx;
-static volatile uint8_t     irq_rx_data[1] = {};
 static volatile bool        missed_rx_data = false;
 
 #define STORAGE_SIZE_BYTES 128u
 static uint8_t              sbuffer_storage[STORAGE_SIZE_BYTES];
 static StaticStreamBuffer_t StreamBufferStruct;
 
+// The DMA writes the received bytes into this circular buffer without CPU intervention.
+// The ISR is only triggered on frame delimiters (character match), idle line and half/full transfer,
+// so the buffer must be able to hold the bytes received between two of these events.
+#define DMA_RX_BUFFER_SIZE 128u
+static uint8_t                     dma_rx_buffer[DMA_RX_BUFFER_SIZE];
+static bsp_bluetooth_uart_dma_rx_t dma_rx;
+
+// The Actionslink frames are built directly in this buffer and sent from it by the DMA,
+// so the Bluetooth task doesn't wait for the bytes to go out on the wire
+#define DMA_TX_BUFFER_SIZE 256u
+static uint8_t              dma_tx_buffer[DMA_TX_BUFFER_SIZE];
+
+static bsp_bluetooth_uart_rx_callback_t rx_callback = NULL;
+
+static void   start_dma_reception(void);
+static size_t push_received_data_from_isr(const uint8_t *p_data, size_t length, void *p_higher_prio_task_woken);
+
 void bsp_bluetooth_uart_init(void)
 {
     sbuffer_handle_rx = xStreamBufferCreateStatic(sizeof(sbuffer_storage), 0u, sbuffer_storage, &StreamBufferStruct);
@@ -26,6 +48,8 @@ void bsp_bluetooth_uart_init(void)
         return;
     }
 
+    bsp_bluetooth_uart_dma_rx_init(&dma_rx, dma_rx_buffer, sizeof(dma_rx_buffer));
+
     UART1_Handle.Instance                    = BLUETOOTH_UART;
     UART1_Handle.Init.BaudRate               = BLUETOOTH_UART_BAUDRATE;
     UART1_Handle.Init.WordLength             = UART_WORDLENGTH_8B;
@@ -39,8 +63,33 @@ void bsp_bluetooth_uart_init(void)
 
     HAL_UART_Init(&UART1_Handle);
 
+    // Not in the MSP init: the error callback runs it again, also while a DMA transfer is ongoing
+    // clang-format off
+    DmaTxHandle.Instance                 = BLUETOOTH_UART_TX_DMA_CHANNEL;
+    DmaTxHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    DmaTxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    DmaTxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    DmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    DmaTxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    DmaTxHandle.Init.Mode                = DMA_NORMAL;
+    DmaTxHandle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+    // clang-format on
+
+    HAL_DMA_DeInit(&DmaTxHandle);
+    HAL_DMA_Init(&DmaTxHandle);
+    __HAL_LINKDMA(&UART1_Handle, hdmatx, DmaTxHandle);
+
+    // Shared by the TX and RX channels, the TX transfer must complete across a UART error
+    HAL_NVIC_SetPriority(BLUETOOTH_UART_DMA_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(BLUETOOTH_UART_DMA_IRQn);
+
+    // The character match address can only be written while the USART is disabled
+    __HAL_UART_DISABLE(&UART1_Handle);
+    LL_USART_ConfigNodeAddress(BLUETOOTH_UART, LL_USART_ADDRESS_DETECT_7B, HDLC_FRAME_DELIMITER);
+    __HAL_UART_ENABLE(&UART1_Handle);
+
     // Trigger receiving
-    HAL_UART_Receive_IT(&UART1_Handle, (uint8_t *) irq_rx_data, 1);
+    start_dma_reception();
 }
 
 void bsp_bluetooth_uart_msp_init(void)
@@ -66,6 +115,26 @@ void bsp_bluetooth_uart_msp_init(void)
     GPIO_InitStruct.Alternate = BLUETOOTH_UART_RX_GPIO_AF;
     HAL_GPIO_Init(BLUETOOTH_UART_RX_GPIO_PORT, &GPIO_InitStruct);
 
+    // clang-format off
+    // Configure DMA parameters
+    BLUETOOTH_UART_DMA_CLK_ENABLE();
+    DmaRxHandle.Instance                 = BLUETOOTH_UART_RX_DMA_CHANNEL;
+    DmaRxHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    DmaRxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    DmaRxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    DmaRxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    DmaRxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    DmaRxHandle.Init.Mode                = DMA_CIRCULAR;              // The DMA never stops, the ISR follows its write index
+    DmaRxHandle.Init.Priority            = DMA_PRIORITY_HIGH;
+    // clang-format on
+
+    // The reception is aborted on UART errors and started again after this, so the RX channel can be reset here
+    HAL_DMA_DeInit(&DmaRxHandle);
+    HAL_DMA_Init(&DmaRxHandle);
+
+    // Associate the DMA handle
+    __HAL_LINKDMA(&UART1_Handle, hdmarx, DmaRxHandle);
+
     HAL_NVIC_SetPriority(BLUETOOTH_UART_IRQn, 2, 0);
     HAL_NVIC_EnableIRQ(BLUETOOTH_UART_IRQn);
 
@@ -77,6 +146,7 @@ void bsp_bluetooth_uart_msp_deinit(void)
     GPIO_InitTypeDef GPIO_InitStruct;
 
     HAL_NVIC_DisableIRQ(BLUETOOTH_UART_IRQn);
+    HAL_DMA_DeInit(&DmaRxHandle);
 
     // Configure USART Tx as alternate function
     GPIO_InitStruct.Pin       = BLUETOOTH_UART_TX_GPIO_PIN;
@@ -100,6 +170,11 @@ void bsp_bluetooth_uart_msp_deinit(void)
 
 void bsp_bluetooth_uart_clear_buffer(void)
 {
+    // Drop whatever the DMA has written but the ISR hasn't forwarded yet
+    taskENTER_CRITICAL();
+    bsp_bluetooth_uart_dma_rx_skip(&dma_rx, __HAL_DMA_GET_COUNTER(&DmaRxHandle));
+    taskEXIT_CRITICAL();
+
     if (xStreamBufferReset(sbuffer_handle_rx) != pdPASS)
     {
         log_error("Failed to reset BT UART buffer");
@@ -112,6 +187,43 @@ int bsp_bluetooth_uart_tx(const uint8_t *p_data, size_t length)
     return 0;
 }
 
+int bsp_bluetooth_uart_tx_get_buffer(uint8_t **pp_buffer, size_t *p_size, uint32_t timeout_ms)
+{
+    // The buffer can only be reused once the previous frame has been sent completely.
+    // Frames are usually followed by a response from the BT module, so this rarely waits
+    TickType_t start = xTaskGetTickCount();
+    while (UART1_Handle.gState != HAL_UART_STATE_READY)
+    {
+        if ((xTaskGetTickCount() - start) > pdMS_TO_TICKS(timeout_ms))
+        {
+            log_error("BT UART TX timeout");
+            return -1;
+        }
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    *pp_buffer = dma_tx_buffer;
+    *p_size    = sizeof(dma_tx_buffer);
+    return 0;
+}
+
+int bsp_bluetooth_uart_tx_send_buffer(const uint8_t *p_data, size_t length)
+{
+    if (p_data < dma_tx_buffer || (p_data + length) > (dma_tx_buffer + sizeof(dma_tx_buffer)))
+    {
+        log_error("BT UART TX data is not in the DMA buffer");
+        return -1;
+    }
+
+    if (HAL_UART_Transmit_DMA(&UART1_Handle, (uint8_t *) p_data, length) != HAL_OK)
+    {
+        log_error("Failed to start BT UART DMA transmission");
+        return -1;
+    }
+
+    return 0;
+}
+
 int bsp_bluetooth_uart_rx(uint8_t *p_data, size_t length)
 {
     if (xStreamBufferBytesAvailable(sbuffer_handle_rx) < length)
@@ -135,21 +247,90 @@ int bsp_bluetooth_uart_rx(uint8_t *p_data, size_t length)
     return 0;
 }
 
-void bsp_bluetooth_uart_isr_rx_complete_callback(void)
+size_t bsp_bluetooth_uart_rx_available(uint8_t *p_data, size_t max_length)
 {
-    if (xStreamBufferIsFull(sbuffer_handle_rx) == pdFALSE)
+    if (missed_rx_data)
     {
-        if (xStreamBufferSendFromISR(sbuffer_handle_rx, (uint8_t *) irq_rx_data, (size_t) 1, (BaseType_t *) pdFALSE) !=
-            1)
-        {
-            missed_rx_data = true;
-        }
+        missed_rx_data = false;
+        log_error("Lost RX data");
+    }
+
+    return xStreamBufferReceive(sbuffer_handle_rx, (void *) p_data, max_length, 0);
+}
+
+void bsp_bluetooth_uart_set_rx_callback(bsp_bluetooth_uart_rx_callback_t callback)
+{
+    rx_callback = callback;
+}
+
+void bsp_bluetooth_uart_get_stats(bsp_bluetooth_uart_stats_t *p_stats)
+{
+    taskENTER_CRITICAL();
+    *p_stats = dma_rx.stats;
+    taskEXIT_CRITICAL();
+}
+
+void bsp_bluetooth_uart_isr_rx_event_callback(void)
+{
+    BaseType_t higher_prio_task_woken = pdFALSE;
+
+    size_t length = bsp_bluetooth_uart_dma_rx_forward(&dma_rx, __HAL_DMA_GET_COUNTER(&DmaRxHandle),
+                                                      push_received_data_from_isr, &higher_prio_task_woken);
+
+    // Let the consumer know there is something to read instead of having it poll the buffer
+    if ((length != 0) && (rx_callback != NULL))
+    {
+        rx_callback();
+    }
+
+    portYIELD_FROM_ISR(higher_prio_task_woken);
+}
+
+void bsp_bluetooth_uart_isr_char_match_callback(void)
+{
+    if (LL_USART_IsActiveFlag_CM(BLUETOOTH_UART) && LL_USART_IsEnabledIT_CM(BLUETOOTH_UART))
+    {
+        LL_USART_ClearFlag_CM(BLUETOOTH_UART);
+        bsp_bluetooth_uart_isr_rx_event_callback();
+    }
+}
+
+void bsp_bluetooth_uart_isr_error_callback(void)
+{
+    // The HAL aborts the DMA reception on blocking errors (e.g. overrun), so it needs to be restarted.
+    // Bytes that were in the DMA buffer and not yet forwarded are lost.
+    if (UART1_Handle.RxState == HAL_UART_STATE_READY)
+    {
+        missed_rx_data = true;
+        start_dma_reception();
     }
-    else
+}
+
+static void start_dma_reception(void)
+{
+    bsp_bluetooth_uart_dma_rx_restart(&dma_rx);
+
+    // In circular mode the HAL reports half transfer, transfer complete and idle line events
+    // through HAL_UARTEx_RxEventCallback
+    if (HAL_UARTEx_ReceiveToIdle_DMA(&UART1_Handle, dma_rx_buffer, sizeof(dma_rx_buffer)) != HAL_OK)
+    {
+        log_error("Failed to start BT UART DMA reception");
+        return;
+    }
+
+    // Forward complete frames as soon as the closing delimiter is received instead of waiting for the line to idle
+    LL_USART_ClearFlag_CM(BLUETOOTH_UART);
+    LL_USART_EnableIT_CM(BLUETOOTH_UART);
+}
+
+static size_t push_received_data_from_isr(const uint8_t *p_data, size_t length, void *p_higher_prio_task_woken)
+{
+    size_t bytes_sent =
+        xStreamBufferSendFromISR(sbuffer_handle_rx, p_data, length, (BaseType_t *) p_higher_prio_task_woken);
+    if (bytes_sent != length)
     {
         missed_rx_data = true;
     }
 
-    // Start receiving
-    HAL_UART_Receive_IT(&UART1_Handle, (uint8_t *) irq_rx_data, 1);
+    return bytes_sent;
 }
@@ -8,6 +8,15 @@ extern "C"
 {
 #endif
 
+    typedef struct
+    {
+        uint32_t rx_irq_count;     // Number of RX events serviced (char match, idle line, half/full transfer)
+        uint32_t rx_bytes;         // Number of bytes forwarded to the RX buffer
+        uint32_t rx_dropped_bytes; // Number of bytes lost because the RX buffer was full
+    } bsp_bluetooth_uart_stats_t;
+
+    typedef void (*bsp_bluetooth_uart_rx_callback_t)(void);
+
     /**
      * @brief Initializes the UART hardware needed to interface with the Bluetooth module.
      */
@@ -31,6 +40,30 @@ extern "C"
      */
     int bsp_bluetooth_uart_tx(const uint8_t *p_data, size_t length);
 
+    /**
+     * @brief Gets the DMA TX buffer, so that the data to send can be written directly into it.
+     * @note  Waits until the previous DMA transmission has completed.
+     *
+     * @param[out] pp_buffer            pointer to where the pointer to the buffer will be written
+     * @param[out] p_size               pointer to where the size of the buffer will be written
+     * @param[in]  timeout_ms           maximum time to wait for the previous transmission
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int bsp_bluetooth_uart_tx_get_buffer(uint8_t **pp_buffer, size_t *p_size, uint32_t timeout_ms);
+
+    /**
+     * @brief Starts the DMA transmission of data written in the DMA TX buffer.
+     * @note  This function returns immediately, without waiting for the transmission to complete.
+     *
+     * @param[in] p_data                pointer to data to send, within the buffer returned by
+     *                                  `bsp_bluetooth_uart_tx_get_buffer()`
+     * @param[in] length                length of data to send
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int bsp_bluetooth_uart_tx_send_buffer(const uint8_t *p_data, size_t length);
+
     /**
      * @brief Reads data from the UART RX buffer.
      *
@@ -45,6 +78,51 @@ extern "C"
      */
     int bsp_bluetooth_uart_rx(uint8_t *p_data, size_t length);
 
+    /**
+     * @brief Reads all the data already received from the UART RX buffer, without waiting.
+     *
+     * @param[out] p_data               pointer to where the read data will be written
+     * @param[in]  max_length           maximum number of bytes to read
+     *
+     * @return number of bytes read
+     */
+    size_t bsp_bluetooth_uart_rx_available(uint8_t *p_data, size_t max_length);
+
+    /**
+     * @brief Registers a function to call when new data has been received.
+     * @note  The callback is called from the interrupt context, once per RX event (frame delimiter,
+     *        idle line, half/full transfer) which forwarded bytes to the RX buffer.
+     *
+     * @param[in] callback      function to call, NULL to disable
+     */
+    void bsp_bluetooth_uart_set_rx_callback(bsp_bluetooth_uart_rx_callback_t callback);
+
+    /**
+     * @brief Gets a snapshot of the RX statistics.
+     *
+     * @param[out] p_stats      pointer to where the statistics will be written
+     */
+    void bsp_bluetooth_uart_get_stats(bsp_bluetooth_uart_stats_t *p_stats);
+
+    /**
+     * @brief Forwards the bytes written by the RX DMA since the last event to the RX buffer.
+     * @note  Must be called from the UART/DMA interrupt context on idle line, half/full transfer
+     *        and character match events.
+     */
+    void bsp_bluetooth_uart_isr_rx_event_callback(void);
+
+    /**
+     * @brief Handles the character match (HDLC frame delimiter) interrupt.
+     * @note  Must be called from the UART interrupt handler before the HAL handler,
+     *        which does not know about this flag.
+     */
+    void bsp_bluetooth_uart_isr_char_match_callback(void);
+
+    /**
+     * @brief Restarts the RX DMA after the HAL aborted it because of a UART error.
+     */
+    void bsp_bluetooth_uart_isr_error_callback(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,66 @@
+#include "bsp_bluetooth_uart_dma_rx.h"
+#include <string.h>
+
+static size_t write_index(const bsp_bluetooth_uart_dma_rx_t *p_rx, size_t dma_counter)
+{
+    // The counter is reloaded with the buffer size when the DMA wraps around
+    return (p_rx->size - dma_counter) % p_rx->size;
+}
+
+static void push(bsp_bluetooth_uart_dma_rx_t *p_rx, size_t start, size_t length,
+                 bsp_bluetooth_uart_dma_rx_push_fn_t push_fn, void *p_context)
+{
+    size_t bytes_sent = push_fn(&p_rx->p_buffer[start], length, p_context);
+
+    p_rx->stats.rx_bytes += bytes_sent;
+    if (bytes_sent != length)
+    {
+        p_rx->stats.rx_dropped_bytes += length - bytes_sent;
+    }
+}
+
+void bsp_bluetooth_uart_dma_rx_init(bsp_bluetooth_uart_dma_rx_t *p_rx, const uint8_t *p_buffer, size_t size)
+{
+    memset(p_rx, 0, sizeof(*p_rx));
+    p_rx->p_buffer = p_buffer;
+    p_rx->size     = size;
+}
+
+void bsp_bluetooth_uart_dma_rx_restart(bsp_bluetooth_uart_dma_rx_t *p_rx)
+{
+    p_rx->read_index = 0;
+}
+
+size_t bsp_bluetooth_uart_dma_rx_forward(bsp_bluetooth_uart_dma_rx_t *p_rx, size_t dma_counter,
+                                         bsp_bluetooth_uart_dma_rx_push_fn_t push_fn, void *p_context)
+{
+    size_t new_write_index = write_index(p_rx, dma_counter);
+    size_t read_index      = p_rx->read_index;
+    size_t length          = 0;
+
+    p_rx->stats.rx_irq_count++;
+
+    if (new_write_index > read_index)
+    {
+        length = new_write_index - read_index;
+        push(p_rx, read_index, length, push_fn, p_context);
+    }
+    else if (new_write_index < read_index)
+    {
+        // The DMA wrapped around, forward the tail and then the head of the buffer
+        length = p_rx->size - read_index + new_write_index;
+        push(p_rx, read_index, p_rx->size - read_index, push_fn, p_context);
+        if (new_write_index > 0)
+        {
+            push(p_rx, 0, new_write_index, push_fn, p_context);
+        }
+    }
+
+    p_rx->read_index = new_write_index;
+    return length;
+}
+
+void bsp_bluetooth_uart_dma_rx_skip(bsp_bluetooth_uart_dma_rx_t *p_rx, size_t dma_counter)
+{
+    p_rx->read_index = write_index(p_rx, dma_counter);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bsp_bluetooth_uart.h"
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Consumer of the received bytes, e.g. the RX stream buffer.
+     *
+     * @param[in] p_data        pointer to the received bytes, within the DMA buffer
+     * @param[in] length        number of received bytes
+     * @param[in] p_context     context given to `bsp_bluetooth_uart_dma_rx_forward()`
+     *
+     * @return number of bytes taken, the others are dropped
+     */
+    typedef size_t (*bsp_bluetooth_uart_dma_rx_push_fn_t)(const uint8_t *p_data, size_t length, void *p_context);
+
+    /**
+     * Follows the write index of a circular RX DMA and forwards the bytes written since the previous event.
+     * It has no dependency on the HAL, so that it builds on the host.
+     */
+    typedef struct
+    {
+        const uint8_t             *p_buffer;   // Buffer written by the DMA
+        size_t                     size;       // Size of the buffer, the DMA wraps around at its end
+        size_t                     read_index; // First byte not forwarded yet
+        bsp_bluetooth_uart_stats_t stats;
+    } bsp_bluetooth_uart_dma_rx_t;
+
+    /**
+     * @brief Initializes the reader of the DMA buffer and clears its statistics.
+     *
+     * @param[out] p_rx         pointer to the reader
+     * @param[in]  p_buffer     pointer to the buffer written by the DMA
+     * @param[in]  size         size of the buffer
+     */
+    void bsp_bluetooth_uart_dma_rx_init(bsp_bluetooth_uart_dma_rx_t *p_rx, const uint8_t *p_buffer, size_t size);
+
+    /**
+     * @brief Starts reading again from the beginning of the buffer, when the DMA is (re)started.
+     *
+     * @param[in] p_rx          pointer to the reader
+     */
+    void bsp_bluetooth_uart_dma_rx_restart(bsp_bluetooth_uart_dma_rx_t *p_rx);
+
+    /**
+     * @brief Forwards the bytes written by the DMA since the previous call, as one span or as two when the DMA
+     *        wrapped around.
+     * @note  Must be called at least every half buffer, which the half/full transfer events guarantee.
+     *
+     * @param[in] p_rx          pointer to the reader
+     * @param[in] dma_counter   DMA counter, the number of bytes left until the end of the buffer
+     * @param[in] push_fn       consumer of the bytes
+     * @param[in] p_context     passed to the consumer
+     *
+     * @return number of new bytes, forwarded or dropped
+     */
+    size_t bsp_bluetooth_uart_dma_rx_forward(bsp_bluetooth_uart_dma_rx_t *p_rx, size_t dma_counter,
+                                             bsp_bluetooth_uart_dma_rx_push_fn_t push_fn, void *p_context);
+
+    /**
+     * @brief Drops the bytes written by the DMA but not forwarded yet.
+     *
+     * @param[in] p_rx          pointer to the reader
+     * @param[in] dma_counter   DMA counter, the number of bytes left until the end of the buffer
+     */
+    void bsp_bluetooth_uart_dma_rx_skip(bsp_bluetooth_uart_dma_rx_t *p_rx, size_t dma_counter);
+
+#if defined(__cplusplus)
+}
+#endif
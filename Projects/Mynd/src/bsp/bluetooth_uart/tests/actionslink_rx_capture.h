@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstdint>
+
+// Module to MCU traffic of a session: power on with the requests of the MCU (firmware version, power state, device
+// name, paired device list, CSB state), connection and playback, an AVRCP volume storm of 60 events every 5 ms with
+// some back to back and set_absolute_avrcp_volume requests in between, CSB broadcasting and a link loss. The frames
+// are encoded from message.proto with the timings of the module: ACKs after 2.5 ms, responses after 8-20 ms.
+// Frames which would overlap on the wire are sent back to back, in one chunk.
+struct CaptureChunk
+{
+    uint32_t start_us; // Start of the first byte on the wire
+    uint16_t offset;   // In c_capture
+    uint16_t length;
+};
+
+// clang-format off
+static const uint8_t c_capture[] = {
+    0x7E, 0x55, 0x01, 0x01, 0x04, 0x00, 0x0B, 0x00, 0xB8, 0x1A, 0x02, 0x52, 0x00, 0x7E, 0x7E, 0x55,
+    0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x5E, 0x7E, 0x7E, 0x55, 0x01, 0x02, 0x26, 0x00, 0x95, 0x00,
+    0xCB, 0x12, 0x24, 0x08, 0x01, 0x5A, 0x20, 0x08, 0x02, 0x10, 0x01, 0x18, 0x04, 0x22, 0x18, 0x76,
+    0x32, 0x2E, 0x31, 0x2E, 0x34, 0x2D, 0x31, 0x37, 0x2D, 0x67, 0x33, 0x66, 0x39, 0x63, 0x32, 0x61,
+    0x62, 0x2D, 0x64, 0x69, 0x72, 0x74, 0x79, 0x7E, 0x7E, 0x55, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00,
+    0xF8, 0x7E, 0x7E, 0x55, 0x01, 0x03, 0x06, 0x00, 0xFA, 0x00, 0x51, 0x12, 0x04, 0x08, 0x02, 0x62,
+    0x00, 0x7E, 0x7E, 0x55, 0x01, 0x04, 0x06, 0x00, 0x15, 0x00, 0xF8, 0x1A, 0x04, 0x5A, 0x02, 0x08,
+    0x01, 0x7E, 0x7E, 0x55, 0x01, 0x05, 0x05, 0x00, 0x5E, 0x00, 0x6C, 0x1A, 0x03, 0xA2, 0x01, 0x00,
+    0x7E, 0x7E, 0x55, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x9A, 0x7E, 0x7E, 0x55, 0x01, 0x06, 0x14,
+    0x00, 0xB2, 0x00, 0x04, 0x12, 0x12, 0x08, 0x03, 0x82, 0x03, 0x0D, 0x0A, 0x0B, 0x54, 0x65, 0x75,
+    0x66, 0x65, 0x6C, 0x20, 0x4D, 0x59, 0x4E, 0x44, 0x7E, 0x7E, 0x55, 0x00, 0x04, 0x00, 0x00, 0x00,
+    0x00, 0xB3, 0x7E, 0x7E, 0x55, 0x01, 0x07, 0x59, 0x00, 0x8E, 0x00, 0x06, 0x12, 0x57, 0x08, 0x04,
+    0x8A, 0x02, 0x52, 0x0A, 0x50, 0x12, 0x08, 0x08, 0x80, 0xB4, 0xE2, 0xB3, 0xC5, 0xC6, 0x04, 0x12,
+    0x08, 0x08, 0x91, 0xD6, 0xE2, 0xB3, 0xC5, 0xC6, 0x04, 0x12, 0x08, 0x08, 0xA2, 0xF8, 0xE2, 0xB3,
+    0xC5, 0xC6, 0x04, 0x12, 0x08, 0x08, 0xB3, 0x9A, 0xE3, 0xB3, 0xC5, 0xC6, 0x04, 0x12, 0x08, 0x08,
+    0xC4, 0xBC, 0xE3, 0xB3, 0xC5, 0xC6, 0x04, 0x12, 0x08, 0x08, 0xD5, 0xDE, 0xE3, 0xB3, 0xC5, 0xC6,
+    0x04, 0x12, 0x08, 0x08, 0xE6, 0x80, 0xE4, 0xB3, 0xC5, 0xC6, 0x04, 0x12, 0x08, 0x08, 0xF7, 0xA2,
+    0xE4, 0xB3, 0xC5, 0xC6, 0x04, 0x7E, 0x7E, 0x55, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0xD1, 0x7E,
+    0x7E, 0x55, 0x01, 0x08, 0x09, 0x00, 0xB8, 0x00, 0x4D, 0x12, 0x07, 0x08, 0x05, 0xD2, 0x02, 0x02,
+    0x0A, 0x00, 0x7E, 0x7E, 0x55, 0x00, 0x06, 0x00, 0x00, 0x00, 0x00, 0x77, 0x7E, 0x7E, 0x55, 0x01,
+    0x09, 0x0F, 0x00, 0xBE, 0x00, 0x25, 0x1A, 0x0D, 0x92, 0x02, 0x0A, 0x0A, 0x08, 0x08, 0xBC, 0xFD,
+    0xF5, 0xF3, 0xD7, 0xCB, 0x1F, 0x7E, 0x7E, 0x55, 0x01, 0x0A, 0x07, 0x00, 0x5D, 0x00, 0x4F, 0x1A,
+    0x05, 0xB2, 0x02, 0x02, 0x08, 0x01, 0x7E, 0x7E, 0x55, 0x01, 0x0B, 0x0D, 0x00, 0xEC, 0x00, 0xEB,
+    0x1A, 0x0B, 0xF2, 0x01, 0x08, 0x08, 0x01, 0x10, 0x02, 0x18, 0xC4, 0xD8, 0x02, 0x7E, 0x7E, 0x55,
+    0x01, 0x0C, 0x05, 0x00, 0x2D, 0x00, 0x8A, 0x1A, 0x03, 0xB0, 0x01, 0x01, 0x7E, 0x7E, 0x55, 0x01,
+    0x0D, 0x05, 0x00, 0x2B, 0x00, 0x96, 0x1A, 0x03, 0xFA, 0x01, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x0E,
+    0x0C, 0x00, 0x78, 0x00, 0xA5, 0x1A, 0x0A, 0x82, 0x02, 0x07, 0x08, 0xCB, 0x89, 0xEC, 0x8F, 0xF7,
+    0x23, 0x7E, 0x7E, 0x55, 0x01, 0x0F, 0x08, 0x00, 0x53, 0x00, 0xA6, 0x1A, 0x06, 0x8A, 0x02, 0x03,
+    0x08, 0xDD, 0x05, 0x7E, 0x7E, 0x55, 0x01, 0x10, 0x08, 0x00, 0x94, 0x00, 0x22, 0x1A, 0x06, 0x8A,
+    0x02, 0x03, 0x08, 0xC5, 0x0D, 0x7E, 0x7E, 0x55, 0x01, 0x11, 0x08, 0x00, 0x81, 0x00, 0x56, 0x1A,
+    0x06, 0x8A, 0x02, 0x03, 0x08, 0xAD, 0x15, 0x7E, 0x7E, 0x55, 0x01, 0x12, 0x08, 0x00, 0xE8, 0x00,
+    0xB8, 0x1A, 0x06, 0x8A, 0x02, 0x03, 0x08, 0x95, 0x1D, 0x7E, 0x7E, 0x55, 0x01, 0x13, 0x08, 0x00,
+    0x1A, 0x00, 0xE4, 0x1A, 0x06, 0x8A, 0x02, 0x03, 0x08, 0xFD, 0x24, 0x7E, 0x7E, 0x55, 0x01, 0x14,
+    0x07, 0x00, 0xEE, 0x00, 0x5F, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x1E, 0x7E, 0x7E, 0x55, 0x01,
+    0x15, 0x07, 0x00, 0xE9, 0x00, 0x56, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x1F, 0x7E, 0x7E, 0x55,
+    0x01, 0x16, 0x07, 0x00, 0x54, 0x00, 0x56, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x20, 0x7E, 0x7E,
+    0x55, 0x01, 0x17, 0x07, 0x00, 0x53, 0x00, 0x5F, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x21, 0x7E,
+    0x7E, 0x55, 0x01, 0x18, 0x07, 0x00, 0x5A, 0x00, 0xD2, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x22,
+    0x7E, 0x7E, 0x55, 0x01, 0x19, 0x07, 0x00, 0x5D, 0x00, 0xDB, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10,
+    0x23, 0x7E, 0x7E, 0x55, 0x01, 0x1A, 0x07, 0x00, 0x48, 0x00, 0x6B, 0x1A, 0x05, 0xAA, 0x01, 0x02,
+    0x10, 0x24, 0x7E, 0x7E, 0x55, 0x01, 0x1B, 0x07, 0x00, 0x4F, 0x00, 0x62, 0x1A, 0x05, 0xAA, 0x01,
+    0x02, 0x10, 0x25, 0x7E, 0x7E, 0x55, 0x01, 0x1C, 0x07, 0x00, 0x46, 0x00, 0xF6, 0x1A, 0x05, 0xAA,
+    0x01, 0x02, 0x10, 0x26, 0x7E, 0x7E, 0x55, 0x01, 0x1D, 0x07, 0x00, 0x41, 0x00, 0xFF, 0x1A, 0x05,
+    0xAA, 0x01, 0x02, 0x10, 0x27, 0x7E, 0x7E, 0x55, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x15, 0x7E,
+    0x7E, 0x55, 0x01, 0x1F, 0x07, 0x00, 0x6C, 0x00, 0x7C, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x28,
+    0x7E, 0x7E, 0x55, 0x01, 0x1E, 0x07, 0x00, 0x7D, 0x5D, 0x00, 0x5C, 0x12, 0x05, 0x08, 0x06, 0x82,
+    0x02, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x20, 0x07, 0x00, 0x6B, 0x00, 0x71, 0x1A, 0x05, 0xAA, 0x01,
+    0x02, 0x10, 0x29, 0x7E, 0x7E, 0x55, 0x01, 0x21, 0x07, 0x00, 0x62, 0x00, 0xAE, 0x1A, 0x05, 0xAA,
+    0x01, 0x02, 0x10, 0x2A, 0x7E, 0x7E, 0x55, 0x01, 0x22, 0x07, 0x00, 0x65, 0x00, 0x63, 0x1A, 0x05,
+    0xAA, 0x01, 0x02, 0x10, 0x2B, 0x7E, 0x7E, 0x55, 0x01, 0x23, 0x07, 0x00, 0x70, 0x00, 0x17, 0x1A,
+    0x05, 0xAA, 0x01, 0x02, 0x10, 0x2C, 0x7E, 0x7E, 0x55, 0x01, 0x24, 0x07, 0x00, 0x77, 0x00, 0x55,
+    0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x2D, 0x7E, 0x7E, 0x55, 0x01, 0x25, 0x07, 0x00, 0x7D, 0x5E,
+    0x00, 0x8A, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x2E, 0x7E, 0x7E, 0x55, 0x01, 0x26, 0x07, 0x00,
+    0x79, 0x00, 0x47, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x2F, 0x7E, 0x7E, 0x55, 0x01, 0x27, 0x07,
+    0x00, 0x24, 0x00, 0xC0, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x30, 0x7E, 0x7E, 0x55, 0x01, 0x28,
+    0x07, 0x00, 0x23, 0x00, 0x9B, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x31, 0x7E, 0x7E, 0x55, 0x00,
+    0x08, 0x00, 0x00, 0x00, 0x00, 0x25, 0x7E, 0x7E, 0x55, 0x01, 0x2A, 0x07, 0x00, 0x2A, 0x00, 0xE2,
+    0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x32, 0x7E, 0x7E, 0x55, 0x01, 0x2B, 0x07, 0x00, 0x2D, 0x00,
+    0xEB, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x33, 0x7E, 0x7E, 0x55, 0x01, 0x29, 0x07, 0x00, 0x6B,
+    0x00, 0x0A, 0x12, 0x05, 0x08, 0x07, 0x82, 0x02, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x2C, 0x07, 0x00,
+    0x38, 0x00, 0xD4, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x34, 0x7E, 0x7E, 0x55, 0x01, 0x2D, 0x07,
+    0x00, 0x3F, 0x00, 0xDD, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x35, 0x7E, 0x7E, 0x55, 0x01, 0x2E,
+    0x07, 0x00, 0x36, 0x00, 0xC6, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x36, 0x7E, 0x7E, 0x55, 0x01,
+    0x2F, 0x07, 0x00, 0x31, 0x00, 0xCF, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x37, 0x7E, 0x7E, 0x55,
+    0x01, 0x30, 0x07, 0x00, 0x1C, 0x00, 0x8A, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x38, 0x7E, 0x7E,
+    0x55, 0x01, 0x31, 0x07, 0x00, 0x1B, 0x00, 0x83, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x39, 0x7E,
+    0x7E, 0x55, 0x01, 0x32, 0x07, 0x00, 0x12, 0x00, 0x98, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x3A,
+    0x7E, 0x7E, 0x55, 0x01, 0x33, 0x07, 0x00, 0x15, 0x00, 0x91, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10,
+    0x3B, 0x7E, 0x7E, 0x55, 0x00, 0x09, 0x00, 0x00, 0x00, 0x00, 0x47, 0x7E, 0x7E, 0x55, 0x01, 0x35,
+    0x07, 0x00, 0x00, 0x00, 0xCC, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x3C, 0x7E, 0x7E, 0x55, 0x01,
+    0x34, 0x07, 0x00, 0xB9, 0x00, 0x5C, 0x12, 0x05, 0x08, 0x08, 0x82, 0x02, 0x00, 0x7E, 0x7E, 0x55,
+    0x01, 0x36, 0x07, 0x00, 0x07, 0x00, 0x01, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x3D, 0x7E, 0x7E,
+    0x55, 0x01, 0x37, 0x07, 0x00, 0x0E, 0x00, 0xDE, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x3E, 0x7E,
+    0x7E, 0x55, 0x01, 0x38, 0x07, 0x00, 0x09, 0x00, 0x85, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x3F,
+    0x7E, 0x7E, 0x55, 0x01, 0x39, 0x07, 0x00, 0x73, 0x00, 0xC7, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10,
+    0x40, 0x7E, 0x7E, 0x55, 0x01, 0x3A, 0x07, 0x00, 0x74, 0x00, 0x0A, 0x1A, 0x05, 0xAA, 0x01, 0x02,
+    0x10, 0x41, 0x7E, 0x7E, 0x55, 0x01, 0x3B, 0x07, 0x00, 0x7D, 0x5D, 0x00, 0xD5, 0x1A, 0x05, 0xAA,
+    0x01, 0x02, 0x10, 0x42, 0x7E, 0x7E, 0x55, 0x01, 0x3C, 0x07, 0x00, 0x7A, 0x00, 0x97, 0x1A, 0x05,
+    0xAA, 0x01, 0x02, 0x10, 0x43, 0x7E, 0x7E, 0x55, 0x01, 0x3D, 0x07, 0x00, 0x6F, 0x00, 0xE3, 0x1A,
+    0x05, 0xAA, 0x01, 0x02, 0x10, 0x44, 0x7E, 0x7E, 0x55, 0x01, 0x3E, 0x07, 0x00, 0x68, 0x00, 0x2E,
+    0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x45, 0x7E, 0x7E, 0x55, 0x00, 0x0A, 0x00, 0x00, 0x00, 0x00,
+    0xE1, 0x7E, 0x7E, 0x55, 0x01, 0x40, 0x07, 0x00, 0x61, 0x00, 0x5F, 0x1A, 0x05, 0xAA, 0x01, 0x02,
+    0x10, 0x46, 0x7E, 0x7E, 0x55, 0x01, 0x41, 0x07, 0x00, 0x66, 0x00, 0x56, 0x1A, 0x05, 0xAA, 0x01,
+    0x02, 0x10, 0x47, 0x7E, 0x7E, 0x55, 0x01, 0x3F, 0x07, 0x00, 0xAF, 0x00, 0xCA, 0x12, 0x05, 0x08,
+    0x09, 0x82, 0x02, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x42, 0x07, 0x00, 0x4B, 0x00, 0xB7, 0x1A, 0x05,
+    0xAA, 0x01, 0x02, 0x10, 0x48, 0x7E, 0x7E, 0x55, 0x01, 0x43, 0x07, 0x00, 0x4C, 0x00, 0xBE, 0x1A,
+    0x05, 0xAA, 0x01, 0x02, 0x10, 0x49, 0x7E, 0x7E, 0x55, 0x01, 0x44, 0x07, 0x00, 0x45, 0x00, 0x2A,
+    0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4A, 0x7E, 0x7E, 0x55, 0x01, 0x45, 0x07, 0x00, 0x42, 0x00,
+    0x23, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4B, 0x7E, 0x7E, 0x55, 0x01, 0x46, 0x07, 0x00, 0x57,
+    0x00, 0x93, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4C, 0x7E, 0x7E, 0x55, 0x01, 0x47, 0x07, 0x00,
+    0x50, 0x00, 0x9A, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4D, 0x7E, 0x7E, 0x55, 0x01, 0x48, 0x07,
+    0x00, 0x59, 0x00, 0x17, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4E, 0x7E, 0x7E, 0x55, 0x01, 0x49,
+    0x07, 0x00, 0x5E, 0x00, 0x1E, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x4F, 0x7E, 0x7E, 0x55, 0x00,
+    0x0B, 0x00, 0x00, 0x00, 0x00, 0x83, 0x7E, 0x7E, 0x55, 0x01, 0x4B, 0x07, 0x00, 0x03, 0x00, 0x3F,
+    0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x50, 0x7E, 0x7E, 0x55, 0x01, 0x4A, 0x07, 0x00, 0x95, 0x00,
+    0xC2, 0x12, 0x05, 0x08, 0x0A, 0x82, 0x02, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x4C, 0x07, 0x00, 0x04,
+    0x00, 0x7D, 0x5D, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x51, 0x7E, 0x7E, 0x55, 0x01, 0x4D, 0x07,
+    0x00, 0x0D, 0x00, 0xA2, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x52, 0x7E, 0x7E, 0x55, 0x01, 0x4E,
+    0x07, 0x00, 0x0A, 0x00, 0x6F, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x53, 0x7E, 0x7E, 0x55, 0x01,
+    0x4F, 0x07, 0x00, 0x1F, 0x00, 0x1B, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x54, 0x7E, 0x7E, 0x55,
+    0x01, 0x50, 0x07, 0x00, 0x18, 0x00, 0x72, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x55, 0x7E, 0x7E,
+    0x55, 0x01, 0x51, 0x07, 0x00, 0x11, 0x00, 0xAD, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x56, 0x7E,
+    0x7E, 0x55, 0x01, 0x52, 0x07, 0x00, 0x16, 0x00, 0x60, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10, 0x57,
+    0x7E, 0x7E, 0x55, 0x01, 0x53, 0x07, 0x00, 0x3B, 0x00, 0x45, 0x1A, 0x05, 0xAA, 0x01, 0x02, 0x10,
+    0x58, 0x7E, 0x7E, 0x55, 0x01, 0x54, 0x07, 0x00, 0x3C, 0x00, 0x07, 0x1A, 0x05, 0xAA, 0x01, 0x02,
+    0x10, 0x59, 0x7E, 0x7E, 0x55, 0x00, 0x0C, 0x00, 0x00, 0x00, 0x00, 0xAA, 0x7E, 0x7E, 0x55, 0x01,
+    0x55, 0x07, 0x00, 0x83, 0x00, 0xE9, 0x12, 0x05, 0x08, 0x0B, 0x82, 0x02, 0x00, 0x7E, 0x7E, 0x55,
+    0x00, 0x0D, 0x00, 0x00, 0x00, 0x00, 0xC8, 0x7E, 0x7E, 0x55, 0x01, 0x56, 0x07, 0x00, 0xC3, 0x00,
+    0x14, 0x1A, 0x05, 0xC2, 0x02, 0x02, 0x08, 0x01, 0x7E, 0x7E, 0x55, 0x00, 0x0E, 0x00, 0x00, 0x00,
+    0x00, 0x6E, 0x7E, 0x7E, 0x55, 0x01, 0x57, 0x07, 0x00, 0xD7, 0x00, 0x75, 0x12, 0x05, 0x08, 0x0C,
+    0xFA, 0x02, 0x00, 0x7E, 0x7E, 0x55, 0x01, 0x58, 0x0F, 0x00, 0x02, 0x00, 0x0E, 0x1A, 0x0D, 0x9A,
+    0x02, 0x0A, 0x0A, 0x08, 0x08, 0xBC, 0xFD, 0xF5, 0xF3, 0xD7, 0xCB, 0x1F, 0x7E, 0x7E, 0x55, 0x01,
+    0x59, 0x05, 0x00, 0xC3, 0x00, 0x08, 0x1A, 0x03, 0xB2, 0x02, 0x00, 0x7E,
+};
+
+static const CaptureChunk c_chunks[] = {
+    {0, 0, 14},
+    {7500, 14, 10},
+    {25000, 24, 48},
+    {42500, 72, 10},
+    {60000, 82, 47},
+    {82500, 129, 10},
+    {100000, 139, 30},
+    {112500, 169, 10},
+    {130000, 179, 99},
+    {142500, 278, 10},
+    {160000, 288, 19},
+    {172500, 307, 10},
+    {1000000, 317, 42},
+    {1200000, 359, 23},
+    {1400000, 382, 52},
+    {2000000, 434, 18},
+    {3000000, 452, 18},
+    {4000000, 470, 18},
+    {5000000, 488, 18},
+    {6000000, 506, 18},
+    {7000000, 524, 34},
+    {7005000, 558, 17},
+    {7010000, 575, 17},
+    {7015000, 592, 34},
+    {7020000, 626, 17},
+    {7025000, 643, 17},
+    {7030000, 660, 34},
+    {7033500, 694, 10},
+    {7035000, 704, 17},
+    {7039000, 721, 35},
+    {7045000, 756, 34},
+    {7050000, 790, 17},
+    {7055000, 807, 17},
+    {7060000, 824, 35},
+    {7065000, 859, 17},
+    {7070000, 876, 17},
+    {7073500, 893, 10},
+    {7075000, 903, 34},
+    {7079000, 937, 34},
+    {7085000, 971, 17},
+    {7090000, 988, 34},
+    {7095000, 1022, 17},
+    {7100000, 1039, 17},
+    {7105000, 1056, 34},
+    {7108500, 1090, 10},
+    {7110000, 1100, 17},
+    {7114000, 1117, 34},
+    {7120000, 1151, 34},
+    {7125000, 1185, 17},
+    {7130000, 1202, 17},
+    {7135000, 1219, 35},
+    {7140000, 1254, 17},
+    {7145000, 1271, 17},
+    {7148500, 1288, 10},
+    {7150000, 1298, 34},
+    {7154000, 1332, 34},
+    {7160000, 1366, 17},
+    {7165000, 1383, 34},
+    {7170000, 1417, 17},
+    {7175000, 1434, 17},
+    {7180000, 1451, 34},
+    {7183500, 1485, 10},
+    {7185000, 1495, 17},
+    {7189000, 1512, 35},
+    {7195000, 1547, 34},
+    {7200000, 1581, 17},
+    {7205000, 1598, 17},
+    {7210000, 1615, 34},
+    {7215000, 1649, 17},
+    {7220000, 1666, 17},
+    {7223500, 1683, 10},
+    {7229000, 1693, 17},
+    {7402500, 1710, 10},
+    {8000000, 1720, 17},
+    {8102500, 1737, 10},
+    {8120000, 1747, 17},
+    {9000000, 1764, 40},
+};
+// clang-format on
@@ -0,0 +1,259 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C"
+{
+#include "bsp_bluetooth_uart_dma_rx.h"
+}
+
+#include "actionslink_rx_capture.h"
+
+// Same sizes as bsp_bluetooth_uart.c
+constexpr size_t c_dma_buffer_size    = 128;
+constexpr size_t c_stream_buffer_size = 128;
+
+constexpr uint32_t c_us_per_byte     = 87; // 115200 baud, 10 bits per byte
+constexpr uint8_t  c_frame_delimiter = 0x7E;
+
+// The RX stream buffer, it takes as many bytes as there is room for
+struct StreamBuffer
+{
+    std::vector<uint8_t> data;
+    size_t               capacity = c_stream_buffer_size;
+    size_t               pushes   = 0;
+
+    static size_t push(const uint8_t *p_data, size_t length, void *p_context)
+    {
+        auto  *p_buffer = static_cast<StreamBuffer *>(p_context);
+        size_t taken    = std::min(length, p_buffer->capacity - p_buffer->data.size());
+        p_buffer->data.insert(p_buffer->data.end(), p_data, p_data + taken);
+        p_buffer->pushes++;
+        return taken;
+    }
+};
+
+// USART1 and its circular RX DMA: the DMA writes every byte into the buffer and the interrupts are raised on half
+// transfer, transfer complete, character match (the frame delimiter) and idle line, one byte time after the last one.
+// The Bluetooth task is woken up by the RX callback and reads the stream buffer after its scheduling latency.
+class FakeUart
+{
+  public:
+    explicit FakeUart(uint32_t task_latency_us) : task_latency_us(task_latency_us)
+    {
+        bsp_bluetooth_uart_dma_rx_init(&rx, dma_buffer, sizeof(dma_buffer));
+    }
+
+    void replay(const CaptureChunk *p_chunks, size_t number_of_chunks)
+    {
+        for (size_t i = 0; i < number_of_chunks; i++)
+        {
+            const CaptureChunk &chunk = p_chunks[i];
+            for (size_t j = 0; j < chunk.length; j++)
+            {
+                receive(c_capture[chunk.offset + j], chunk.start_us + (j + 1) * c_us_per_byte);
+            }
+            idle_line(chunk.start_us + (chunk.length + 1) * c_us_per_byte);
+        }
+        run_task(UINT32_MAX);
+    }
+
+    bsp_bluetooth_uart_dma_rx_t rx;
+    StreamBuffer                stream;
+    std::vector<uint8_t>        received; // Read by the Bluetooth task
+    uint32_t                    irqs = 0;
+
+  private:
+    void receive(uint8_t byte, uint32_t now_us)
+    {
+        run_task(now_us);
+
+        dma_buffer[c_dma_buffer_size - dma_counter] = byte;
+        dma_counter--;
+        if (dma_counter == c_dma_buffer_size / 2)
+        {
+            rx_event(now_us); // Half transfer
+        }
+        if (dma_counter == 0)
+        {
+            dma_counter = c_dma_buffer_size;
+            rx_event(now_us); // Transfer complete
+        }
+        if (byte == c_frame_delimiter)
+        {
+            rx_event(now_us); // Character match
+        }
+    }
+
+    void idle_line(uint32_t now_us)
+    {
+        run_task(now_us);
+
+        // The HAL doesn't report the idle line when the DMA has just wrapped around, the transfer complete did
+        if (dma_counter == c_dma_buffer_size)
+        {
+            irqs++;
+            return;
+        }
+        rx_event(now_us);
+    }
+
+    void rx_event(uint32_t now_us)
+    {
+        irqs++;
+        if (bsp_bluetooth_uart_dma_rx_forward(&rx, dma_counter, StreamBuffer::push, &stream) != 0 && !is_task_woken)
+        {
+            is_task_woken = true;
+            task_run_us   = now_us + task_latency_us;
+        }
+    }
+
+    void run_task(uint32_t now_us)
+    {
+        if (is_task_woken && task_run_us <= now_us)
+        {
+            received.insert(received.end(), stream.data.begin(), stream.data.end());
+            stream.data.clear();
+            is_task_woken = false;
+        }
+    }
+
+    uint8_t  dma_buffer[c_dma_buffer_size] = {};
+    size_t   dma_counter                   = c_dma_buffer_size;
+    uint32_t task_latency_us;
+    uint32_t task_run_us   = 0;
+    bool     is_task_woken = false;
+};
+
+class BluetoothUartDmaRxTest : public ::testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        for (size_t i = 0; i < sizeof(dma_buffer); i++)
+        {
+            dma_buffer[i] = static_cast<uint8_t>(i);
+        }
+        bsp_bluetooth_uart_dma_rx_init(&rx, dma_buffer, sizeof(dma_buffer));
+    }
+
+    // The DMA counter once the DMA has written `count` bytes since it was started
+    static size_t counter_after(size_t count)
+    {
+        return c_dma_buffer_size - (count % c_dma_buffer_size);
+    }
+
+    uint8_t                     dma_buffer[c_dma_buffer_size];
+    bsp_bluetooth_uart_dma_rx_t rx;
+    StreamBuffer                stream;
+};
+
+TEST_F(BluetoothUartDmaRxTest, ForwardsTheBytesWrittenSinceThePreviousEvent)
+{
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(10), StreamBuffer::push, &stream), 10u);
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(25), StreamBuffer::push, &stream), 15u);
+
+    ASSERT_EQ(stream.data.size(), 25u);
+    for (size_t i = 0; i < stream.data.size(); i++)
+    {
+        EXPECT_EQ(stream.data[i], i);
+    }
+    EXPECT_EQ(stream.pushes, 2u);
+    EXPECT_EQ(rx.stats.rx_irq_count, 2u);
+    EXPECT_EQ(rx.stats.rx_bytes, 25u);
+}
+
+TEST_F(BluetoothUartDmaRxTest, EventWithoutNewBytesForwardsNothing)
+{
+    bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(10), StreamBuffer::push, &stream);
+
+    // E.g. the idle line right after the character match of the closing delimiter
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(10), StreamBuffer::push, &stream), 0u);
+    EXPECT_EQ(stream.pushes, 1u);
+    EXPECT_EQ(rx.stats.rx_irq_count, 2u);
+}
+
+TEST_F(BluetoothUartDmaRxTest, WrapAroundForwardsTheTailThenTheHead)
+{
+    bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(120), StreamBuffer::push, &stream);
+    stream.data.clear();
+
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(130), StreamBuffer::push, &stream), 10u);
+
+    const std::vector<uint8_t> expected = {120, 121, 122, 123, 124, 125, 126, 127, 0, 1};
+    EXPECT_EQ(stream.data, expected);
+    EXPECT_EQ(rx.read_index, 2u);
+}
+
+TEST_F(BluetoothUartDmaRxTest, TransferCompleteForwardsUpToTheEndOfTheBuffer)
+{
+    bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(100), StreamBuffer::push, &stream);
+    stream.pushes = 0;
+
+    // The counter is reloaded with the buffer size, there is no head to forward
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, c_dma_buffer_size, StreamBuffer::push, &stream), 28u);
+    EXPECT_EQ(stream.pushes, 1u);
+    EXPECT_EQ(rx.read_index, 0u);
+}
+
+TEST_F(BluetoothUartDmaRxTest, BytesTheConsumerHasNoRoomForAreCountedAsDropped)
+{
+    stream.capacity = 20;
+
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(50), StreamBuffer::push, &stream), 50u);
+    EXPECT_EQ(rx.stats.rx_bytes, 20u);
+    EXPECT_EQ(rx.stats.rx_dropped_bytes, 30u);
+
+    // The dropped bytes aren't forwarded again
+    stream.data.clear();
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(55), StreamBuffer::push, &stream), 5u);
+    EXPECT_EQ(stream.data.front(), 50u);
+}
+
+TEST_F(BluetoothUartDmaRxTest, SkipAndRestart)
+{
+    bsp_bluetooth_uart_dma_rx_skip(&rx, counter_after(40));
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(42), StreamBuffer::push, &stream), 2u);
+    EXPECT_EQ(stream.data.front(), 40u);
+
+    // The DMA is started again from the beginning of the buffer after a UART error
+    bsp_bluetooth_uart_dma_rx_restart(&rx);
+    stream.data.clear();
+    EXPECT_EQ(bsp_bluetooth_uart_dma_rx_forward(&rx, counter_after(3), StreamBuffer::push, &stream), 3u);
+    EXPECT_EQ(stream.data.front(), 0u);
+}
+
+TEST(BluetoothUartDmaRxReplay, CapturedTrafficWithoutDropsAndWithFewerInterrupts)
+{
+    // The Bluetooth task runs within a tick of the RX callback
+    FakeUart uart(1000);
+    uart.replay(c_chunks, sizeof(c_chunks) / sizeof(c_chunks[0]));
+
+    const size_t number_of_bytes  = sizeof(c_capture);
+    const size_t number_of_frames = std::count(c_capture, c_capture + number_of_bytes, c_frame_delimiter) / 2;
+    std::printf("%zu bytes, %zu frames: %u interrupts (%zu with one per byte), %u RX events\n", number_of_bytes,
+                number_of_frames, uart.irqs, number_of_bytes, uart.rx.stats.rx_irq_count);
+
+    ASSERT_EQ(uart.received.size(), number_of_bytes);
+    EXPECT_TRUE(std::equal(uart.received.begin(), uart.received.end(), c_capture));
+    EXPECT_EQ(uart.rx.stats.rx_bytes, number_of_bytes);
+    EXPECT_EQ(uart.rx.stats.rx_dropped_bytes, 0u);
+
+    // Two character matches and an idle line per frame at most, plus the half/full transfers
+    EXPECT_LE(uart.irqs, 3 * number_of_frames + 2 * number_of_bytes / c_dma_buffer_size + 2);
+    EXPECT_LT(uart.irqs, number_of_bytes / 4);
+}
+
+TEST(BluetoothUartDmaRxReplay, StalledTaskDropsAreCounted)
+{
+    // The AVRCP volume storm fills the stream buffer if the task doesn't read it for 30 ms
+    FakeUart uart(30000);
+    uart.replay(c_chunks, sizeof(c_chunks) / sizeof(c_chunks[0]));
+
+    EXPECT_GT(uart.rx.stats.rx_dropped_bytes, 0u);
+    EXPECT_EQ(uart.rx.stats.rx_bytes + uart.rx.stats.rx_dropped_bytes, sizeof(c_capture));
+    EXPECT_EQ(uart.received.size(), uart.rx.stats.rx_bytes);
+}
@@ -54,3 +54,35 @@ uint32_t board_get_ms_since(uint32_t tick_ms)
         return current_tick_ms - tick_ms;
     }
 }
+
+uint32_t board_get_cycle_count(void)
+{
+    // The Cortex-M0 has no cycle counter, the count is made of the FreeRTOS ticks and of the SysTick counter, which
+    // counts down from LOAD to 0 once per tick. A tick interrupt between the two reads makes them start again.
+    uint32_t ticks, value;
+    do
+    {
+        ticks = get_systick();
+        value = SysTick->VAL;
+    } while (ticks != get_systick());
+
+    return ticks * (SysTick->LOAD + 1u) + (SysTick->LOAD - value);
+}
+
+#if (configGENERATE_RUN_TIME_STATS == 1)
+// TIM2 is the only 32 bit timer, the differences of two counts stay valid across its overflow
+void board_run_time_counter_init(void)
+{
+    __HAL_RCC_TIM2_CLK_ENABLE();
+
+    TIM2->PSC = SystemCoreClock / 1000000u - 1u;
+    TIM2->ARR = UINT32_MAX;
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+uint32_t board_get_run_time_counter(void)
+{
+    return TIM2->CNT;
+}
+#endif
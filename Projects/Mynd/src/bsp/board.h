@@ -11,6 +11,19 @@ extern "C"
     uint32_t get_systick(void);
     uint32_t board_get_ms_since(uint32_t tick_ms);
 
+    /**
+     * @brief Free-running count of the CPU cycles, for measuring the duration of a piece of code (the difference of
+     *        two counts, valid for up to 2^32 cycles). Must be called with the interrupts enabled.
+     */
+    uint32_t board_get_cycle_count(void);
+
+    /**
+     * @brief Free-running microsecond counter of the FreeRTOS run time statistics (profiling builds only), it doesn't
+     *        count while the MCU is in the STOP mode.
+     */
+    void     board_run_time_counter_init(void);
+    uint32_t board_get_run_time_counter(void);
+
 #if defined(__cplusplus)
 }
 #endif
@@ -86,9 +86,16 @@
 #define SHARED_I2C_TIMING_300k              0x50330B0B                  // Hand-tuned for 300kHz
 #define SHARED_I2C_TIMING_400k              0x50330808                  // Hand-tuned for 400kHz
 #define SHARED_I2C_TIMING                   (SHARED_I2C_TIMING_400k)
+#define SHARED_I2C_SPEED_KHZ                400                         // Must match SHARED_I2C_TIMING
 #define SHARED_I2C_TIMEOUT_MAX              ((uint32_t) 100)
 #define SHARED_I2C_HANDLE                   &I2C2_Handle
 
+// Shared I2C DMA (default DMA request mapping of the STM32F072)
+#define SHARED_I2C_DMA_CLK_ENABLE()         __HAL_RCC_DMA1_CLK_ENABLE()
+#define SHARED_I2C_TX_DMA_CHANNEL           DMA1_Channel4
+#define SHARED_I2C_RX_DMA_CHANNEL           DMA1_Channel5
+#define SHARED_I2C_DMA_IRQn                 DMA1_Channel4_5_6_7_IRQn
+
 // ST driver expects 7-bit addresses shifted to the left
 #define AW9523B_I2C_ADDRESS                 (0xB6) // 0x5B << 1
 #define TAS5825P_I2C_ADDRESS                (0x98) // 0x4C << 1
@@ -123,6 +130,12 @@
 #define BLUETOOTH_UART_BAUDRATE             115200
 #define BLUETOOTH_UART_IRQn                 USART1_IRQn
 
+// Bluetooth UART DMA (default DMA request mapping of the STM32F072)
+#define BLUETOOTH_UART_DMA_CLK_ENABLE()     __HAL_RCC_DMA1_CLK_ENABLE()
+#define BLUETOOTH_UART_RX_DMA_CHANNEL       DMA1_Channel3
+#define BLUETOOTH_UART_TX_DMA_CHANNEL       DMA1_Channel2
+#define BLUETOOTH_UART_DMA_IRQn             DMA1_Channel2_3_IRQn
+
 // Debug UART TX pin
 #define DEBUG_UART_TX_GPIO_CLK_ENABLE()     __HAL_RCC_GPIOA_CLK_ENABLE()
 #define DEBUG_UART_TX_GPIO_PIN              GPIO_PIN_2
@@ -146,6 +159,12 @@
 #define DEBUG_UART_BAUDRATE                 115200
 #define DEBUG_UART_IRQn                     USART2_IRQn
 
+// Debug UART TX DMA, remapped from channel 4 which is used by the shared I2C TX
+#define DEBUG_UART_DMA_CLK_ENABLE()         __HAL_RCC_DMA1_CLK_ENABLE()
+#define DEBUG_UART_DMA_REMAP()              __HAL_SYSCFG_DMA_REMAP_ENABLE(HAL_REMAPDMA_USART2_DMA_CH67)
+#define DEBUG_UART_TX_DMA_CHANNEL           DMA1_Channel7
+#define DEBUG_UART_DMA_IRQn                 DMA1_Channel4_5_6_7_IRQn
+
 // Amps power down pin
 #define AMPS_POWER_DOWN_GPIO_CLK_ENABLE()   __HAL_RCC_GPIOC_CLK_ENABLE()
 #define AMPS_POWER_DOWN_GPIO_PIN            GPIO_PIN_8
@@ -9,10 +9,14 @@
 #include <stdbool.h>
 
 UART_HandleTypeDef          UART2_Handle;
+static DMA_HandleTypeDef    DmaTxHandle;
 static StreamBufferHandle_t sbuffer_handle_rx;
 static uint8_t              irq_rx_data[1] = {};
 static volatile bool        missed_rx_data = false;
 
+static bsp_debug_uart_tx_done_callback_t tx_done_callback = NULL;
+static volatile bool                     is_tx_dma_active = false; // Until the last byte has left the UART
+
 #define STORAGE_SIZE_BYTES 32
 static uint8_t              sbuffer_storage[STORAGE_SIZE_BYTES];
 static StaticStreamBuffer_t StreamBufferStruct;
@@ -32,6 +36,33 @@ void bsp_debug_uart_init(void)
 
     HAL_UART_Init(&UART2_Handle);
 
+    // Not in the MSP init: the error callback runs it again, also while a DMA transfer is ongoing
+    // clang-format off
+    DEBUG_UART_DMA_CLK_ENABLE();
+    __HAL_RCC_SYSCFG_CLK_ENABLE();
+    DEBUG_UART_DMA_REMAP();
+    DmaTxHandle.Instance                 = DEBUG_UART_TX_DMA_CHANNEL;
+    DmaTxHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    DmaTxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    DmaTxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    DmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    DmaTxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    DmaTxHandle.Init.Mode                = DMA_NORMAL;
+    DmaTxHandle.Init.Priority            = DMA_PRIORITY_LOW;              // Logs only, the other transfers go first
+    // clang-format on
+
+    HAL_DMA_DeInit(&DmaTxHandle);
+    HAL_DMA_Init(&DmaTxHandle);
+    __HAL_LINKDMA(&UART2_Handle, hdmatx, DmaTxHandle);
+
+    HAL_NVIC_SetPriority(DEBUG_UART_DMA_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DEBUG_UART_DMA_IRQn);
+
+    // The shell input wakes the MCU up from the STOP mode, the USART2 clock is the HSI for that
+    UART_WakeUpTypeDef wakeup = {.WakeUpEvent = UART_WAKEUP_ON_READDATA_NONEMPTY};
+    HAL_UARTEx_StopModeWakeUpSourceConfig(&UART2_Handle, wakeup);
+    HAL_UARTEx_EnableStopMode(&UART2_Handle);
+
     sbuffer_handle_rx = xStreamBufferCreateStatic(sizeof(sbuffer_storage), 0u, sbuffer_storage, &StreamBufferStruct);
     if (sbuffer_handle_rx == NULL)
     {
@@ -76,10 +107,39 @@ void bsp_debug_uart_msp_init(void)
 
 int bsp_debug_uart_tx(const uint8_t *p_data, size_t length)
 {
-    HAL_UART_Transmit(&UART2_Handle, (uint8_t *) p_data, length, HAL_MAX_DELAY);
+    HAL_StatusTypeDef status;
+
+    // An ongoing DMA transfer completes without the CPU, the UART is busy until then
+    do
+    {
+        status = HAL_UART_Transmit(&UART2_Handle, (uint8_t *) p_data, length, HAL_MAX_DELAY);
+    } while (status == HAL_BUSY && bsp_debug_uart_is_tx_busy());
+
+    return status == HAL_OK ? 0 : -1;
+}
+
+int bsp_debug_uart_tx_dma(const uint8_t *p_data, size_t length)
+{
+    is_tx_dma_active = true;
+    if (HAL_UART_Transmit_DMA(&UART2_Handle, (uint8_t *) p_data, length) != HAL_OK)
+    {
+        is_tx_dma_active = false;
+        return -1;
+    }
+
     return 0;
 }
 
+void bsp_debug_uart_set_tx_done_callback(bsp_debug_uart_tx_done_callback_t callback)
+{
+    tx_done_callback = callback;
+}
+
+bool bsp_debug_uart_is_tx_busy(void)
+{
+    return is_tx_dma_active;
+}
+
 int bsp_debug_uart_rx(uint8_t *p_data, size_t length)
 {
     if (xStreamBufferBytesAvailable(sbuffer_handle_rx) < length)
@@ -121,3 +181,12 @@ void bsp_debug_uart_isr_rx_complete_callback(void)
     // Start receiving
     HAL_UART_Receive_IT(&UART2_Handle, (uint8_t *) irq_rx_data, 1);
 }
+
+void bsp_debug_uart_isr_tx_complete_callback(void)
+{
+    is_tx_dma_active = false;
+    if (tx_done_callback != NULL)
+    {
+        tx_done_callback();
+    }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -15,10 +16,12 @@ extern "C"
 
     void bsp_debug_uart_msp_init(void);
 
+    typedef void (*bsp_debug_uart_tx_done_callback_t)(void);
+
     /**
      * @brief Sends data over UART.
-     * @note  This function returns immediately. The TX done callback provided
-     *        in `board_hal_bluetooth_uart_init()` will be called when the transfer completes.
+     * @note  This function blocks until the data is sent. A DMA transfer started by `bsp_debug_uart_tx_dma()`
+     *        is completed first.
      *
      * @param[in] p_data    pointer to data to send
      * @param[in] length    length of data to send
@@ -27,6 +30,25 @@ extern "C"
      */
     int bsp_debug_uart_tx(const uint8_t *p_data, size_t length);
 
+    /**
+     * @brief Starts sending data over UART with the DMA.
+     * @note  This function returns immediately, the data must stay valid until the TX done callback
+     *        set by `bsp_debug_uart_set_tx_done_callback()` is called from the interrupt.
+     *
+     * @param[in] p_data    pointer to data to send
+     * @param[in] length    length of data to send
+     *
+     * @return 0 if the transfer started, -1 if the UART is busy or not initialized yet
+     */
+    int bsp_debug_uart_tx_dma(const uint8_t *p_data, size_t length);
+
+    void bsp_debug_uart_set_tx_done_callback(bsp_debug_uart_tx_done_callback_t callback);
+
+    /**
+     * @brief Checks whether a DMA transfer is ongoing, the STOP mode would interrupt it.
+     */
+    bool bsp_debug_uart_is_tx_busy(void);
+
     /**
      * @brief Reads data from the UART RX buffer.
      *
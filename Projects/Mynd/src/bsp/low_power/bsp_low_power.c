@@ -0,0 +1,382 @@
+#define LOG_LEVEL LOG_LEVEL_INFO
+#include "bsp_low_power.h"
+#include "board.h"
+#include "bsp_adc.h"
+#include "bsp_debug_uart.h"
+#include "bsp_shared_i2c.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f0xx_hal.h"
+#include "logger.h"
+
+/*
+ * Tickless idle in the STOP mode. The STM32F072 has no LPTIM, the RTC running from the LSI is the only timer left in
+ * the STOP mode: its wakeup timer (RTCCLK / 16) ends the STOP mode at the next task timeout and its sub-second
+ * counter (RTCCLK / 40, nominally 1 kHz) measures the time spent in it, also when another interrupt ended it early.
+ * The LSI is only specified within 30 and 50 kHz, it is calibrated against the system clock at init.
+ *
+ * When the STOP mode isn't possible the SysTick is reloaded to fire at the next task timeout instead, and the MCU
+ * sleeps until then with the peripherals running, as the default tickless idle of the FreeRTOS Cortex-M0 port does.
+ */
+
+#define RTC_PREDIV_A          39u  // 40 kHz / 40 = 1 kHz sub-second counter
+#define RTC_PREDIV_S          999u // 1 Hz calendar
+#define RTC_TICKS_PER_HOUR    (3600u * (RTC_PREDIV_S + 1u))
+#define RTC_WAKEUP_DIV        16u
+#define RTC_WRITE_KEY_1       0xCAu
+#define RTC_WRITE_KEY_2       0x53u
+#define RTC_WRITE_LOCK        0xFFu
+#define RTC_CALIBRATION_TICKS 50u
+
+// SysTick counts lost while it is stopped to be reloaded, as in the FreeRTOS port
+#define SYSTICK_STOPPED_CYCLES 45u
+
+// Shorter idle periods aren't worth the clock restart, the longest one stays well within the 16 bit wakeup timer
+#define MIN_STOP_TICKS pdMS_TO_TICKS(5u)
+#define MAX_STOP_MS    10000u
+
+static struct
+{
+    volatile bool         is_stop_allowed;
+    bool                  is_initialized;
+    uint32_t              us_per_rtc_tick;
+    uint32_t              remainder_us; // Part of a tick which slept in the STOP mode but wasn't stepped yet
+    bsp_low_power_stats_t stats;
+    uint32_t              stats_reset_ms;
+} s_low_power;
+
+static void rtc_unlock(void)
+{
+    HAL_PWR_EnableBkUpAccess();
+    RTC->WPR = RTC_WRITE_KEY_1;
+    RTC->WPR = RTC_WRITE_KEY_2;
+}
+
+static void rtc_lock(void)
+{
+    RTC->WPR = RTC_WRITE_LOCK;
+}
+
+static void rtc_clear_wakeup_flag(void)
+{
+    RTC->ISR = ~(RTC_ISR_WUTF | RTC_ISR_INIT) | (RTC->ISR & RTC_ISR_INIT);
+    EXTI->PR = EXTI_PR_PR20;
+}
+
+// Time within the hour, in sub-second ticks. The shadow registers are bypassed, they are only updated two RTC clock
+// cycles after the STOP mode: the counters are read until two reads agree instead.
+static uint32_t rtc_get_ticks(void)
+{
+    uint32_t ssr, tr;
+
+    do
+    {
+        ssr = RTC->SSR;
+        tr  = RTC->TR;
+    } while (ssr != RTC->SSR || tr != RTC->TR);
+
+    uint32_t seconds = ((tr >> 12) & 0x7u) * 600u + ((tr >> 8) & 0xFu) * 60u + ((tr >> 4) & 0x7u) * 10u + (tr & 0xFu);
+    return seconds * (RTC_PREDIV_S + 1u) + (RTC_PREDIV_S - ssr);
+}
+
+static uint32_t rtc_get_ticks_since(uint32_t start)
+{
+    return (rtc_get_ticks() + RTC_TICKS_PER_HOUR - start) % RTC_TICKS_PER_HOUR;
+}
+
+static void start_wakeup_timer(uint32_t sleep_ms)
+{
+    // One wakeup timer count is 16 LSI periods, one sub-second tick 40
+    uint32_t counts = (sleep_ms * 1000u * (RTC_PREDIV_A + 1u)) / (s_low_power.us_per_rtc_tick * RTC_WAKEUP_DIV);
+
+    rtc_unlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    while ((RTC->ISR & RTC_ISR_WUTWF) == 0u)
+    {
+    }
+
+    RTC->WUTR = (counts > 1u) ? counts - 1u : 0u;
+    RTC->CR   = (RTC->CR & ~RTC_CR_WUCKSEL) | RTC_CR_WUTIE | RTC_CR_WUTE; // WUCKSEL 0: RTCCLK / 16
+    rtc_clear_wakeup_flag();
+    rtc_lock();
+}
+
+static void stop_wakeup_timer(void)
+{
+    rtc_unlock();
+    RTC->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    rtc_clear_wakeup_flag();
+    rtc_lock();
+}
+
+// The MCU leaves the STOP mode running from the HSI, switches back to the HSI48 as SystemClock_Config() does
+static void restore_system_clock(void)
+{
+    RCC->CR2 |= RCC_CR2_HSI48ON;
+    while ((RCC->CR2 & RCC_CR2_HSI48RDY) == 0u)
+    {
+    }
+
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_HSI48;
+    while ((RCC->CFGR & RCC_CFGR_SWS) != RCC_CFGR_SWS_HSI48)
+    {
+    }
+}
+
+static bool calibrate(void)
+{
+    const uint32_t cycles_per_us  = SystemCoreClock / 1000000u;
+    const uint32_t timeout_cycles = SystemCoreClock / 5u;
+
+    // Starts on a tick edge
+    uint32_t start_cycles = board_get_cycle_count();
+    uint32_t start        = rtc_get_ticks();
+    uint32_t ticks;
+
+    while ((ticks = rtc_get_ticks()) == start)
+    {
+        if (board_get_cycle_count() - start_cycles > timeout_cycles)
+        {
+            return false;
+        }
+    }
+
+    start_cycles = board_get_cycle_count();
+    start        = ticks;
+
+    while (rtc_get_ticks_since(start) < RTC_CALIBRATION_TICKS)
+    {
+        if (board_get_cycle_count() - start_cycles > timeout_cycles)
+        {
+            return false;
+        }
+    }
+
+    s_low_power.us_per_rtc_tick = (board_get_cycle_count() - start_cycles) / cycles_per_us / RTC_CALIBRATION_TICKS;
+    return true;
+}
+
+void bsp_low_power_init(void)
+{
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+
+    RCC->CSR |= RCC_CSR_LSION;
+    while ((RCC->CSR & RCC_CSR_LSIRDY) == 0u)
+    {
+    }
+
+    // The RTC clock can only be selected again after a reset of the backup domain, which clears the backup registers
+    if ((RCC->BDCR & RCC_BDCR_RTCSEL) == 0u)
+    {
+        RCC->BDCR |= RCC_BDCR_RTCSEL_LSI;
+    }
+    RCC->BDCR |= RCC_BDCR_RTCEN;
+
+    rtc_unlock();
+    if (RTC->PRER != ((RTC_PREDIV_A << 16) | RTC_PREDIV_S))
+    {
+        RTC->ISR |= RTC_ISR_INIT;
+        while ((RTC->ISR & RTC_ISR_INITF) == 0u)
+        {
+        }
+
+        // Two separate writes, as required by the reference manual
+        RTC->PRER = RTC_PREDIV_S;
+        RTC->PRER |= RTC_PREDIV_A << 16;
+        RTC->ISR &= ~RTC_ISR_INIT;
+    }
+    RTC->CR |= RTC_CR_BYPSHAD;
+    rtc_lock();
+
+    // EXTI line 20: RTC wakeup timer, line 26: USART2 (debug UART) wakeup
+    EXTI->IMR |= EXTI_IMR_MR20 | EXTI_IMR_MR26;
+    EXTI->RTSR |= EXTI_RTSR_TR20;
+    HAL_NVIC_SetPriority(RTC_IRQn, 3, 0);
+    HAL_NVIC_EnableIRQ(RTC_IRQn);
+
+    if (!calibrate())
+    {
+        log_error("RTC not running, STOP mode disabled");
+        return;
+    }
+
+    log_info("RTC tick %lu us", s_low_power.us_per_rtc_tick);
+    bsp_low_power_reset_stats();
+    s_low_power.is_initialized = true;
+}
+
+void bsp_low_power_allow_stop(bool allow)
+{
+    s_low_power.is_stop_allowed = allow;
+}
+
+bool bsp_low_power_is_stop_allowed(void)
+{
+    return s_low_power.is_initialized && s_low_power.is_stop_allowed;
+}
+
+void bsp_low_power_get_stats(bsp_low_power_stats_t *p_stats)
+{
+    taskENTER_CRITICAL();
+    *p_stats = s_low_power.stats;
+    taskEXIT_CRITICAL();
+
+    p_stats->elapsed_ms      = board_get_ms_since(s_low_power.stats_reset_ms);
+    p_stats->us_per_rtc_tick = s_low_power.us_per_rtc_tick;
+}
+
+void bsp_low_power_reset_stats(void)
+{
+    taskENTER_CRITICAL();
+    s_low_power.stats          = (bsp_low_power_stats_t) {0};
+    s_low_power.stats_reset_ms = get_systick();
+    taskEXIT_CRITICAL();
+}
+
+// Sleeps until the next task timeout or an interrupt with the SysTick reloaded for the whole idle period
+static void sleep_tickless(TickType_t expected_idle_ticks)
+{
+    const uint32_t   cycles_per_tick = SysTick->LOAD + 1u;
+    const TickType_t max_idle_ticks  = SysTick_LOAD_RELOAD_Msk / cycles_per_tick;
+
+    if (expected_idle_ticks > max_idle_ticks)
+    {
+        expected_idle_ticks = max_idle_ticks;
+    }
+
+    __disable_irq();
+
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        __enable_irq();
+        return;
+    }
+
+    // The current value is what is left of the current tick
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t reload = SysTick->VAL + cycles_per_tick * (expected_idle_ticks - 1u);
+    if (reload > SYSTICK_STOPPED_CYCLES)
+    {
+        reload -= SYSTICK_STOPPED_CYCLES;
+    }
+
+    SysTick->LOAD = reload;
+    SysTick->VAL  = 0u;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    // Lets the interrupt which ended the sleep run, a tick interrupt steps the last tick itself
+    __enable_irq();
+    __DSB();
+    __ISB();
+    __disable_irq();
+
+    // Written without reading it first, a read would clear the count flag
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk;
+
+    TickType_t elapsed_ticks;
+    if ((SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk) != 0u)
+    {
+        // The idle period elapsed, the SysTick restarted from the reload value since
+        uint32_t next_load = (cycles_per_tick - 1u) - (reload - SysTick->VAL);
+        if (next_load < SYSTICK_STOPPED_CYCLES || next_load > cycles_per_tick - 1u)
+        {
+            next_load = cycles_per_tick - 1u;
+        }
+
+        SysTick->LOAD = next_load;
+        elapsed_ticks = expected_idle_ticks - 1u;
+    }
+    else
+    {
+        // Another interrupt ended the sleep, the SysTick ends the tick in progress
+        uint32_t elapsed_cycles = expected_idle_ticks * cycles_per_tick - SysTick->VAL;
+        elapsed_ticks           = elapsed_cycles / cycles_per_tick;
+        SysTick->LOAD           = (elapsed_ticks + 1u) * cycles_per_tick - elapsed_cycles;
+    }
+
+    SysTick->VAL = 0u;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    vTaskStepTick(elapsed_ticks);
+    SysTick->LOAD = cycles_per_tick - 1u;
+
+    s_low_power.stats.sleeps++;
+    s_low_power.stats.slept_ms += elapsed_ticks * portTICK_PERIOD_MS;
+
+    __enable_irq();
+}
+
+// Called by the idle task with the scheduler suspended (configUSE_TICKLESS_IDLE 2)
+void vPortSuppressTicksAndSleep(TickType_t expected_idle_ticks)
+{
+    // The STOP mode would stop the I2C and ADC transfers and the DMA of the logs in the middle
+    if (!bsp_low_power_is_stop_allowed() || expected_idle_ticks < MIN_STOP_TICKS || bsp_debug_uart_is_tx_busy() ||
+        bsp_shared_i2c_is_busy() || bsp_adc_is_busy())
+    {
+        sleep_tickless(expected_idle_ticks);
+        return;
+    }
+
+    uint32_t sleep_ms = expected_idle_ticks * portTICK_PERIOD_MS;
+    if (sleep_ms > MAX_STOP_MS)
+    {
+        sleep_ms = MAX_STOP_MS;
+    }
+
+    // The interrupts still end the STOP mode, they are only handled once the tick count is stepped
+    __disable_irq();
+
+    // An interrupt may have unblocked a task since the idle task decided to sleep
+    if (eTaskConfirmSleepModeStatus() == eAbortSleep)
+    {
+        __enable_irq();
+        return;
+    }
+
+    // Part of the current tick that already elapsed
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+    uint32_t elapsed_us = (SysTick->LOAD - SysTick->VAL) / (SystemCoreClock / 1000000u);
+
+    start_wakeup_timer(sleep_ms);
+    uint32_t start = rtc_get_ticks();
+
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    restore_system_clock();
+
+    elapsed_us += rtc_get_ticks_since(start) * s_low_power.us_per_rtc_tick + s_low_power.remainder_us;
+    bool is_woken_early = (RTC->ISR & RTC_ISR_WUTF) == 0u;
+    stop_wakeup_timer();
+
+    // The tick count can't be stepped past the next task timeout, what is left is stepped after the next sleep
+    TickType_t elapsed_ticks = pdMS_TO_TICKS(elapsed_us / 1000u);
+    if (elapsed_ticks > expected_idle_ticks)
+    {
+        elapsed_ticks = expected_idle_ticks;
+    }
+    s_low_power.remainder_us = elapsed_us - elapsed_ticks * portTICK_PERIOD_MS * 1000u;
+    if (s_low_power.remainder_us >= MAX_STOP_MS * 1000u)
+    {
+        s_low_power.remainder_us = 0;
+    }
+    vTaskStepTick(elapsed_ticks);
+
+    SysTick->VAL = 0u;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    s_low_power.stats.stops++;
+    s_low_power.stats.early_wakeups += is_woken_early ? 1u : 0u;
+    s_low_power.stats.stopped_ms += elapsed_ticks * portTICK_PERIOD_MS;
+
+    __enable_irq();
+}
+
+void RTC_IRQHandler(void)
+{
+    // The wakeup only ends the STOP mode, vPortSuppressTicksAndSleep() accounts for the time
+    rtc_clear_wakeup_flag();
+}
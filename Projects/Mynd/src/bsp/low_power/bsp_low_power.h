@@ -0,0 +1,63 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#if defined(__cplusplus)
+extern "C"
+{
+#endif
+
+    /**
+     * @brief Statistics of the tickless idle since the last reset.
+     */
+    typedef struct
+    {
+        uint32_t stops;           // entries in the STOP mode
+        uint32_t early_wakeups;   // wakeups by an interrupt before the RTC wakeup timer expired
+        uint32_t stopped_ms;      // time spent in the STOP mode
+        uint32_t sleeps;          // tickless sleeps without the STOP mode, when it isn't allowed or a transfer runs
+        uint32_t slept_ms;        // time spent in these sleeps
+        uint32_t elapsed_ms;      // time since the last reset
+        uint32_t us_per_rtc_tick; // calibrated period of the RTC sub-second counter, nominally 1000 us
+    } bsp_low_power_stats_t;
+
+    /**
+     * @brief Starts the RTC from the LSI as the wakeup source of the STOP mode and calibrates it against the system
+     *        clock. Blocks for about 50 ms, must be called from a task.
+     */
+    void bsp_low_power_init(void);
+
+    /**
+     * @brief Allows or forbids the STOP mode. When allowed, the idle task stops the MCU until the next task timeout
+     *        instead of waking up on every tick. The STOP mode stops the system clock, the SysTick and every
+     *        peripheral but the RTC, the EXTI lines and the debug UART receiver. It is skipped while a transfer of
+     *        the shared I2C bus, the ADC or the debug UART runs. Otherwise, the MCU sleeps until the next task timeout
+     *        with the SysTick reloaded for it.
+     *
+     * @param[in] allow                 true to allow the STOP mode, false to forbid it
+     */
+    void bsp_low_power_allow_stop(bool allow);
+
+    /**
+     * @brief Checks if the STOP mode is allowed.
+     *
+     * @return true if the STOP mode is allowed, false otherwise
+     */
+    bool bsp_low_power_is_stop_allowed(void);
+
+    /**
+     * @brief Gets the statistics of the STOP mode since the last reset.
+     *
+     * @param[out] p_stats          statistics
+     */
+    void bsp_low_power_get_stats(bsp_low_power_stats_t *p_stats);
+
+    /**
+     * @brief Resets the statistics of the STOP mode.
+     */
+    void bsp_low_power_reset_stats(void);
+
+#if defined(__cplusplus)
+}
+#endif
@@ -2,12 +2,31 @@
 #include "bsp_shared_i2c.h"
 #include "platform/stm32/i2c_freertos.h"
 #include "board_hw.h"
+#include "FreeRTOS.h"
+#include "task.h"
 #include "logger.h"
 #include "app_assert/app_assert.h"
 
 I2C_HandleTypeDef          I2C2_Handle;
+static DMA_HandleTypeDef   DmaTxHandle;
+static DMA_HandleTypeDef   DmaRxHandle;
 static bool                s_is_initialized;
 static i2c_rtos_handler_t *i2c_rtos_h;
+static volatile uint32_t   s_busy_count; // Tasks in a transfer, including those waiting for the bus
+
+static void enter_transfer(void)
+{
+    taskENTER_CRITICAL();
+    s_busy_count++;
+    taskEXIT_CRITICAL();
+}
+
+static void exit_transfer(void)
+{
+    taskENTER_CRITICAL();
+    s_busy_count--;
+    taskEXIT_CRITICAL();
+}
 
 void bsp_shared_i2c_init(void)
 {
@@ -67,6 +86,40 @@ void bsp_shared_i2c_msp_init(void)
     GPIO_InitStruct.Alternate = SHARED_I2C_SDA_GPIO_AF;
     HAL_GPIO_Init(SHARED_I2C_SDA_GPIO_PORT, &GPIO_InitStruct);
 
+    // Configure DMA parameters, register transfers of at least I2C_RTOS_DMA_MIN_LENGTH bytes (DSP coefficients,
+    // LED dimming) are then moved without an interrupt per byte
+    SHARED_I2C_DMA_CLK_ENABLE();
+    DmaTxHandle.Instance                 = SHARED_I2C_TX_DMA_CHANNEL;
+    DmaTxHandle.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+    DmaTxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    DmaTxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    DmaTxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    DmaTxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    DmaTxHandle.Init.Mode                = DMA_NORMAL;
+    DmaTxHandle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+    HAL_DMA_DeInit(&DmaTxHandle);
+    HAL_DMA_Init(&DmaTxHandle);
+
+    DmaRxHandle.Instance                 = SHARED_I2C_RX_DMA_CHANNEL;
+    DmaRxHandle.Init.Direction           = DMA_PERIPH_TO_MEMORY;
+    DmaRxHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
+    DmaRxHandle.Init.MemInc              = DMA_MINC_ENABLE;
+    DmaRxHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+    DmaRxHandle.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+    DmaRxHandle.Init.Mode                = DMA_NORMAL;
+    DmaRxHandle.Init.Priority            = DMA_PRIORITY_MEDIUM;
+
+    HAL_DMA_DeInit(&DmaRxHandle);
+    HAL_DMA_Init(&DmaRxHandle);
+
+    // Associate the DMA handles
+    __HAL_LINKDMA(&I2C2_Handle, hdmatx, DmaTxHandle);
+    __HAL_LINKDMA(&I2C2_Handle, hdmarx, DmaRxHandle);
+
+    HAL_NVIC_SetPriority(SHARED_I2C_DMA_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(SHARED_I2C_DMA_IRQn);
+
     HAL_NVIC_SetPriority(SHARED_I2C_IRQn, 2, 0);
     HAL_NVIC_EnableIRQ(SHARED_I2C_IRQn);
 
@@ -96,6 +149,10 @@ void bsp_shared_i2c_msp_deinit(void)
 
     HAL_NVIC_DisableIRQ(SHARED_I2C_IRQn);
 
+    HAL_NVIC_DisableIRQ(SHARED_I2C_DMA_IRQn);
+    HAL_DMA_DeInit(&DmaTxHandle);
+    HAL_DMA_DeInit(&DmaRxHandle);
+
     SHARED_I2C_CLK_DISABLE();
 }
 
@@ -110,6 +167,7 @@ int bsp_shared_i2c_write(uint8_t i2c_address, uint8_t register_address, const ui
         return -1;
     }
 
+    enter_transfer();
     do
     {
         // Write the data
@@ -123,6 +181,8 @@ int bsp_shared_i2c_write(uint8_t i2c_address, uint8_t register_address, const ui
 
         retries--;
     } while (error < 0 && retries > 0);
+
+    exit_transfer();
     return error;
 }
 
@@ -137,6 +197,7 @@ int bsp_shared_i2c_read(uint8_t i2c_address, uint8_t register_address, uint8_t *
         return -1;
     }
 
+    enter_transfer();
     do
     {
         error = i2c_rtos_read_data(i2c_rtos_h, i2c_address, register_address, 1, p_buffer, length);
@@ -149,5 +210,64 @@ int bsp_shared_i2c_read(uint8_t i2c_address, uint8_t register_address, uint8_t *
 
         retries--;
     } while (error < 0 && retries > 0);
+
+    exit_transfer();
     return error;
 }
+
+int bsp_shared_i2c_transfer_batch(const i2c_rtos_transfer_t *p_transfers, size_t count)
+{
+    int error;
+    int retries = 3;
+
+    if (!s_is_initialized)
+    {
+        log_error("Can't transfer on I2C before initialization");
+        return -1;
+    }
+
+    enter_transfer();
+    do
+    {
+        // The batch is repeated as a whole, all the transfers are plain register accesses
+        error = i2c_rtos_transfer_batch(i2c_rtos_h, p_transfers, count, SHARED_I2C_TIMEOUT_MAX);
+
+        if (error < 0)
+        {
+            log_err("I2C batch of %u transfers failed (error %d)", (unsigned) count, error);
+        }
+
+        retries--;
+    } while (error < 0 && retries > 0);
+
+    exit_transfer();
+    return error;
+}
+
+int bsp_shared_i2c_get_stats(i2c_rtos_stats_t *p_stats)
+{
+    if (!s_is_initialized)
+    {
+        return -1;
+    }
+
+    return i2c_rtos_get_stats(i2c_rtos_h, p_stats);
+}
+
+void bsp_shared_i2c_reset_stats(void)
+{
+    if (s_is_initialized)
+    {
+        i2c_rtos_reset_stats(i2c_rtos_h);
+    }
+}
+
+bool bsp_shared_i2c_is_busy(void)
+{
+    return s_busy_count != 0u;
+}
+
+uint32_t bsp_shared_i2c_get_speed_khz(void)
+{
+    return SHARED_I2C_SPEED_KHZ;
+}
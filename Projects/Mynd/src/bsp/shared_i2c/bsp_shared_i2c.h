@@ -1,6 +1,8 @@
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
+#include "platform/stm32/i2c_freertos.h"
 
 #if defined(__cplusplus)
 extern "C"
@@ -42,6 +44,36 @@ extern "C"
      */
     int bsp_shared_i2c_read(uint8_t i2c_address, uint8_t register_address, uint8_t *p_buffer, uint32_t length);
 
+    /**
+     * @brief Executes several register transfers on the shared I2C bus, back-to-back and with a single wakeup
+     *        of the calling task when all of them are done.
+     *
+     * @param[in] p_transfers           transfers to execute
+     * @param[in] count                 number of transfers
+     *
+     * @return 0 if successful, a negative value otherwise
+     */
+    int bsp_shared_i2c_transfer_batch(const i2c_rtos_transfer_t *p_transfers, size_t count);
+
+    /**
+     * @brief Gets the bus occupancy per device since the last reset.
+     *
+     * @return 0 if successful, -1 otherwise
+     */
+    int bsp_shared_i2c_get_stats(i2c_rtos_stats_t *p_stats);
+
+    void bsp_shared_i2c_reset_stats(void);
+
+    /**
+     * @brief Checks whether a task is in a transfer on the bus, the STOP mode would interrupt it.
+     */
+    bool bsp_shared_i2c_is_busy(void);
+
+    /**
+     * @brief Gets the SCL frequency, to turn the bus clocks of the statistics into a bus utilisation.
+     */
+    uint32_t bsp_shared_i2c_get_speed_khz(void);
+
 #if defined(__cplusplus)
 }
 #endif
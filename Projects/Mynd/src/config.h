@@ -40,4 +40,15 @@
 
 #define CONFIG_FAST_CHARGE_DEFAULT (false)
 
+// On external power the amps stay in deep sleep while the speaker is off, so they don't need a full reconfiguration
+#define CONFIG_AMPS_RETAIN_STATE_WHEN_OFF (1)
+
+// The volume is applied by the amps, ramped in fine steps, instead of by the Bluetooth module. Needs a Bluetooth module
+// configuration which keeps its own volume at 0 dB and only reports the AVRCP volume.
+#define CONFIG_AMPS_VOLUME_RAMP           (0)
+#define CONFIG_AMPS_VOLUME_RAMP_STEP      (4) // 0.25 dB, in 1/16 dB (TASXXXX_VOLUME_STEPS_PER_DB)
+#define CONFIG_AMPS_VOLUME_RAMP_PERIOD_MS (5)
+#define CONFIG_AMPS_VOLUME_MIN_DB         (-60) // AVRCP volume 1, 0 is muted
+#define CONFIG_AMPS_VOLUME_MAX_DB         (0)   // CONFIG_MAX_AVRCP_VOLUME
+
 // clang-format on
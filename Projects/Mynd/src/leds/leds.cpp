@@ -10,6 +10,9 @@
 #include "logger.h"
 #include "board.h"
 
+#include <algorithm>
+#include <atomic>
+
 #ifndef BOOTLOADER
 #include "external/teufel/libs/tshell/tshell.h"
 #endif
@@ -71,40 +74,37 @@ constexpr auto get_rgb(const Color &c)
     }
 }
 
-float cubic_curve_up(float _x) { return _x * _x * _x; }
-float cubic_curve_down(float _x) { return (1.0f - _x) * (1.0f - _x) * (1.0f - _x); }
-float linear_up(float _x) { return _x; }
-float linear_down(float _x) { return 1 - _x; }
+constexpr float cubic_curve_up(float _x) { return _x * _x * _x; }
+constexpr float cubic_curve_down(float _x) { return (1.0f - _x) * (1.0f - _x) * (1.0f - _x); }
+constexpr float linear_up(float _x) { return _x; }
+constexpr float linear_down(float _x) { return 1 - _x; }
 
-// Look up tables
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(500)>  s_fast_ramp_up_table{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(500)>  s_fast_ramp_down_table{0};
-#ifdef BOARD_CONFIG_LED_RGB
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_up_table_r{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_down_table_r{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_up_table_g{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_down_table_g{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_up_table_b{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_down_table_b{0};
-#else
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_up_table{0};
-static std::array<uint8_t, PATTERN_MS_TO_STEPS(2000)> s_pulse_down_table {0};
-#endif
+// Look up tables, at full brightness
+template <std::size_t N, class Function>
+constexpr auto make_lookup_table(Function f)
+{
+    return IndicationEngine::MakeLookUpTable<N>(f, 0.f, 1.f, N - 1);
+}
+
+static constexpr auto s_fast_ramp_up_table   = make_lookup_table<PATTERN_MS_TO_STEPS(500)>(linear_up);
+static constexpr auto s_fast_ramp_down_table = make_lookup_table<PATTERN_MS_TO_STEPS(500)>(linear_down);
+static constexpr auto s_pulse_up_table       = make_lookup_table<PATTERN_MS_TO_STEPS(2000)>(cubic_curve_up);
+static constexpr auto s_pulse_down_table     = make_lookup_table<PATTERN_MS_TO_STEPS(2000)>(cubic_curve_down);
 
 // Pattern segments/snippets
 #ifdef BOARD_CONFIG_LED_RGB
-static IndicationEngine::PatternFn    s_breathe_up_r(s_pulse_up_table_r);
-static IndicationEngine::PatternFn    s_breathe_down_r(s_pulse_down_table_r);
-static IndicationEngine::PatternFn    s_breathe_up_g(s_pulse_up_table_g);
-static IndicationEngine::PatternFn    s_breathe_down_g(s_pulse_down_table_g);
-static IndicationEngine::PatternFn    s_breathe_up_b(s_pulse_up_table_b);
-static IndicationEngine::PatternFn    s_breathe_down_b(s_pulse_down_table_b);
+static IndicationEngine::PatternScaledFn s_breathe_up_r(s_pulse_up_table);
+static IndicationEngine::PatternScaledFn s_breathe_down_r(s_pulse_down_table);
+static IndicationEngine::PatternScaledFn s_breathe_up_g(s_pulse_up_table);
+static IndicationEngine::PatternScaledFn s_breathe_down_g(s_pulse_down_table);
+static IndicationEngine::PatternScaledFn s_breathe_up_b(s_pulse_up_table);
+static IndicationEngine::PatternScaledFn s_breathe_down_b(s_pulse_down_table);
 #else
-static IndicationEngine::PatternFn    s_breathe_up(s_pulse_up_table);
-static IndicationEngine::PatternFn    s_breathe_down(s_pulse_down_table);
+static IndicationEngine::PatternScaledFn s_breathe_up(s_pulse_up_table);
+static IndicationEngine::PatternScaledFn s_breathe_down(s_pulse_down_table);
 #endif
-static IndicationEngine::PatternFn    s_fast_ramp_up(s_fast_ramp_up_table);
-static IndicationEngine::PatternFn    s_fast_ramp_down(s_fast_ramp_down_table);
+static IndicationEngine::PatternScaledFn s_fast_ramp_up(s_fast_ramp_up_table);
+static IndicationEngine::PatternScaledFn s_fast_ramp_down(s_fast_ramp_down_table);
 
 static IndicationEngine::PatternConst s_one_and_half_seconds_on(255, PATTERN_MS_TO_STEPS(1500));
 
@@ -409,10 +409,64 @@ void user_activity()
     dimming_controller.reset();
 }
 
+// The infinite patterns only depend on these inputs and on the state of the engines, they are selected again only
+// when one of them changes instead of on every tick
+static std::atomic<bool> s_status_inputs_changed{true};
+static std::atomic<bool> s_source_inputs_changed{true};
+
+static PropertySubscriber s_charger_status_subscriber{getPropertyTopic<Ux::System::ChargerStatus>(),
+                                                      []() { s_status_inputs_changed = true; }};
+static PropertySubscriber s_battery_level_subscriber{getPropertyTopic<Ux::System::BatteryLevel>(),
+                                                     []() { s_status_inputs_changed = true; }};
+static PropertySubscriber s_bt_status_subscriber{getPropertyTopic<Ux::Bluetooth::Status>(),
+                                                 []() { s_source_inputs_changed = true; }};
+
+struct TickStats
+{
+    uint32_t ticks;
+    uint32_t status_updates;
+    uint32_t source_updates;
+    uint64_t cycles;
+    uint32_t max_cycles;
+};
+
+static TickStats s_tick_stats;
+
+// Running pattern of an engine, std::nullopt when it is stopped
+template <typename Engine>
+static std::optional<uint8_t> get_engine_state(Engine &engine)
+{
+    return engine.is_running() ? engine.getPatternId() : std::nullopt;
+}
+
 static void update_infinite_patterns()
 {
     using namespace IndicationEngine;
 
+    // Inputs which aren't properties, compared with their value of the last tick
+    static bool                   s_moisture_detected_input = false;
+    static Ux::System::PowerState s_power_state_input       = Ux::System::PowerState::Transition;
+    static std::optional<uint8_t> s_status_engine_state;
+    static std::optional<uint8_t> s_source_engine_state;
+
+    if (auto moisture_detected = board_link_moisture_detection_is_detected();
+        moisture_detected != s_moisture_detected_input)
+    {
+        s_moisture_detected_input = moisture_detected;
+        s_status_inputs_changed   = true;
+    }
+
+    if (auto power_state = getProperty<Ux::System::PowerState>(); power_state != s_power_state_input)
+    {
+        s_power_state_input     = power_state;
+        s_source_inputs_changed = true;
+    }
+
+    bool status_changed = s_status_inputs_changed || get_engine_state(s_status_led_engine) != s_status_engine_state;
+    bool source_changed = s_source_inputs_changed || get_engine_state(s_source_led_engine) != s_source_engine_state;
+    if (!status_changed && !source_changed)
+        return;
+
     const std::tuple<LedPattern<RGB_LED> &, bool (*)(), void (*)()> infinite_patterns_status[] = {
         {s_moisture_detected, []() { return board_link_moisture_detection_is_detected(); },
          []()
@@ -423,9 +477,10 @@ static void update_infinite_patterns()
         {s_status_charger_solid_battery_low,
          []()
          {
-             return isProperty(Ux::System::ChargerStatus::Active) &&
-                    get_battery_indication_level(getProperty<Ux::System::BatteryLevel>()) ==
-                        BatteryIndicationLevel::Low;
+             auto [charger_status, battery_level] =
+                 getPropertySnapshot<Ux::System::ChargerStatus, Ux::System::BatteryLevel>();
+             return charger_status == Ux::System::ChargerStatus::Active &&
+                    get_battery_indication_level(battery_level) == BatteryIndicationLevel::Low;
          },
          []()
          {
@@ -437,9 +492,10 @@ static void update_infinite_patterns()
         {s_status_charger_solid_battery_mid,
          []()
          {
-             return isProperty(Ux::System::ChargerStatus::Active) &&
-                    get_battery_indication_level(getProperty<Ux::System::BatteryLevel>()) ==
-                        BatteryIndicationLevel::Half;
+             auto [charger_status, battery_level] =
+                 getPropertySnapshot<Ux::System::ChargerStatus, Ux::System::BatteryLevel>();
+             return charger_status == Ux::System::ChargerStatus::Active &&
+                    get_battery_indication_level(battery_level) == BatteryIndicationLevel::Half;
          },
          []()
          {
@@ -451,9 +507,10 @@ static void update_infinite_patterns()
         {s_status_charger_solid_battery_full,
          []()
          {
-             return isProperty(Ux::System::ChargerStatus::Active) &&
-                    get_battery_indication_level(getProperty<Ux::System::BatteryLevel>()) ==
-                        BatteryIndicationLevel::Full;
+             auto [charger_status, battery_level] =
+                 getPropertySnapshot<Ux::System::ChargerStatus, Ux::System::BatteryLevel>();
+             return charger_status == Ux::System::ChargerStatus::Active &&
+                    get_battery_indication_level(battery_level) == BatteryIndicationLevel::Full;
          },
          []()
          {
@@ -485,9 +542,14 @@ static void update_infinite_patterns()
          []() { s_source_led_engine.run_inf(s_bt_dfu); }},
     };
 
-    if (auto cur_p = s_status_led_engine.getPatternId(); not(s_status_led_engine.is_running() && cur_p.has_value() &&
-                                                             !is_long_pattern(static_cast<PatternId>(cur_p.value()))))
+    if (auto cur_p = s_status_led_engine.getPatternId();
+        status_changed && not(s_status_led_engine.is_running() && cur_p.has_value() &&
+                              !is_long_pattern(static_cast<PatternId>(cur_p.value()))))
     {
+        // Cleared before the inputs are read: a change published in the meantime is seen on the next tick
+        s_status_inputs_changed = false;
+        s_tick_stats.status_updates++;
+
         for (auto [pattern, condition, runner] : infinite_patterns_status)
         {
             if (!s_status_led_engine.is_running(pattern) && condition())
@@ -503,10 +565,14 @@ static void update_infinite_patterns()
         }
     }
 
-    if (auto cur_p = s_source_led_engine.getPatternId(); not(s_source_led_engine.is_running() && cur_p.has_value() &&
-                                                             !is_long_pattern(static_cast<PatternId>(cur_p.value()))) &&
-                                                         isProperty(Teufel::Ux::System::PowerState::On))
+    if (auto cur_p = s_source_led_engine.getPatternId();
+        source_changed && not(s_source_led_engine.is_running() && cur_p.has_value() &&
+                              !is_long_pattern(static_cast<PatternId>(cur_p.value()))) &&
+        s_power_state_input == Teufel::Ux::System::PowerState::On)
     {
+        s_source_inputs_changed = false;
+        s_tick_stats.source_updates++;
+
         for (auto [pattern, condition, runner] : infinite_patterns_source)
         {
             if (!s_source_led_engine.is_running(pattern) && condition())
@@ -521,13 +587,29 @@ static void update_infinite_patterns()
             }
         }
     }
+
+    // The patterns started or finished above are part of the state the next changes are compared with
+    s_status_engine_state = get_engine_state(s_status_led_engine);
+    s_source_engine_state = get_engine_state(s_source_led_engine);
 }
 
 void tick()
 {
+    uint32_t start = board_get_cycle_count();
+
     dimming_controller.tick();
 
     update_infinite_patterns();
+
+    uint32_t cycles = board_get_cycle_count() - start;
+    s_tick_stats.ticks++;
+    s_tick_stats.cycles += cycles;
+    s_tick_stats.max_cycles = std::max(s_tick_stats.max_cycles, cycles);
+}
+
+bool is_engine_running(Led led)
+{
+    return led == Led::Status ? s_status_led_engine.is_running() : s_source_led_engine.is_running();
 }
 
 void run_engines()
@@ -536,12 +618,16 @@ void run_engines()
     // Otherwise the engines will override the values set manually by `set_solid_color()`
 
     auto status_led = s_status_led_engine.exec();
-    board_link_io_expander_set_status_led(status_led[0], status_led[1], status_led[2]);
 
     if (s_source_led_engine.is_running())
     {
+        // Both LEDs are updated in one bus transaction
         auto source_led = s_source_led_engine.exec();
-        board_link_io_expander_set_source_led(source_led[0], source_led[1], source_led[2]);
+        board_link_io_expander_set_leds(status_led.data(), source_led.data());
+    }
+    else
+    {
+        board_link_io_expander_set_status_led(status_led[0], status_led[1], status_led[2]);
     }
 }
 
@@ -772,31 +858,28 @@ static void set_brightness_const_patterns(uint8_t brightness)
 
 static void set_brightness_pattern(uint8_t brightness)
 {
-    IndicationEngine::FillLookUpTable(linear_up, s_fast_ramp_up_table, 0.f, 1.f, brightness);
-    IndicationEngine::FillLookUpTable(linear_down, s_fast_ramp_down_table, 0.f, 1.f, brightness);
+    s_fast_ramp_up.update(brightness);
+    s_fast_ramp_down.update(brightness);
 
 #ifdef BOARD_CONFIG_LED_RGB
     auto [r, g, b] = get_rgb(Color::Blue);
 
-    auto r_brightness = r * brightness / UINT8_MAX;
+    auto r_brightness = static_cast<uint8_t>(r * brightness / UINT8_MAX);
     // Note: R and G channels are the same
     // auto g_brightness = g * brightness / 100;
-    auto b_brightness = b * brightness / UINT8_MAX;
+    auto b_brightness = static_cast<uint8_t>(b * brightness / UINT8_MAX);
 
     // log_high("Set brightness: %d %d %d", r_brightness, g_brightness, b_brightness);
 
-    IndicationEngine::FillLookUpTable(cubic_curve_up, s_pulse_up_table_r, 0.f, 1.f, r_brightness);
-    IndicationEngine::FillLookUpTable(cubic_curve_down, s_pulse_down_table_r, 0.f, 1.f, r_brightness);
-    std::copy(s_pulse_up_table_r.begin(), s_pulse_up_table_r.end(), s_pulse_up_table_g.begin());
-    std::copy(s_pulse_down_table_r.begin(), s_pulse_down_table_r.end(), s_pulse_down_table_g.begin());
-    // Note: R and G channels are the same
-    // IndicationEngine::FillLookUpTable(cubic_curve_up, s_pulse_up_table_g, 0.f, 1.f, g_brightness);
-    // IndicationEngine::FillLookUpTable(cubic_curve_down, s_pulse_down_table_g, 0.f, 1.f, g_brightness);
-    IndicationEngine::FillLookUpTable(cubic_curve_up, s_pulse_up_table_b, 0.f, 1.f, b_brightness);
-    IndicationEngine::FillLookUpTable(cubic_curve_down, s_pulse_down_table_b, 0.f, 1.f, b_brightness);
+    s_breathe_up_r.update(r_brightness);
+    s_breathe_down_r.update(r_brightness);
+    s_breathe_up_g.update(r_brightness);
+    s_breathe_down_g.update(r_brightness);
+    s_breathe_up_b.update(b_brightness);
+    s_breathe_down_b.update(b_brightness);
 #else
-    IndicationEngine::FillLookUpTable(cubic_curve_up, s_pulse_up_table, 0.f, 1.f, brightness);
-    IndicationEngine::FillLookUpTable(cubic_curve_down, s_pulse_down_table, 0.f, 1.f, brightness);
+    s_breathe_up.update(brightness);
+    s_breathe_down.update(brightness);
 #endif
 }
 
@@ -811,12 +894,43 @@ void set_brightness(uint8_t brightness)
 
 #ifndef BOOTLOADER
 
+static void print_tick_stats()
+{
+    const auto stats = s_tick_stats;
+
+    printf("LED ticks: %lu, %lu status and %lu source pattern updates, %lu cycles on average, %lu at most\r\n",
+           stats.ticks, stats.status_updates, stats.source_updates,
+           stats.ticks ? static_cast<uint32_t>(stats.cycles / stats.ticks) : 0u, stats.max_cycles);
+
+    s_tick_stats = {};
+}
+
+// I2C traffic of the LED output since the last call, to compare the idle, breathing and flashing patterns
+static void print_output_stats()
+{
+    board_link_io_expander_led_stats_t stats;
+    board_link_io_expander_get_led_stats(&stats);
+
+    // Per second, with one decimal
+    const auto per_second = [&](uint32_t count)
+    { return stats.elapsed_ms ? static_cast<uint32_t>(uint64_t{count} * 10'000u / stats.elapsed_ms) : 0u; };
+
+    printf("LED output: %lu updates, %lu unchanged, %lu I2C transactions, %lu bytes in %lu ms\r\n", stats.updates,
+           stats.skipped, stats.transactions, stats.bytes, stats.elapsed_ms);
+    printf("  %lu.%lu updates/s, %lu.%lu transactions/s\r\n", per_second(stats.updates) / 10u,
+           per_second(stats.updates) % 10u, per_second(stats.transactions) / 10u, per_second(stats.transactions) % 10u);
+
+    board_link_io_expander_reset_led_stats();
+}
+
 #pragma GCC diagnostic push
 #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
 
 // clang-format off
 SHELL_STATIC_SUBCMD_SET_CREATE(sub_led,
     SHELL_CMD_PARSED_UINT8(b, "brightness", 0, 100, [](uint8_t v) { set_brightness(v); }),
+    SHELL_CMD_NO_ARGS(stats, "tick cycles since the last call", []() { print_tick_stats(); }),
+    SHELL_CMD_NO_ARGS(output, "I2C transactions of the LEDs since the last call", []() { print_output_stats(); }),
     SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 // clang-format on
@@ -4,6 +4,7 @@
 #include "board_hw.h"
 #include "board_link.h"
 #include "bsp_debug_uart.h"
+#include "bsp_low_power.h"
 
 #include "FreeRTOS.h"
 #include "task.h"
@@ -18,31 +19,49 @@
 
 static void SystemClock_Config();
 
+#if LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY
+// The logger thread sends the records of the binary logger as frames, the ring of the records is in the logger
+#define TASK_LOGGER_STACK_SIZE 96
+#else
 #define TASK_LOGGER_STACK_SIZE 64
-static StaticTask_t logger_task_buffer;
-static StackType_t  logger_task_stack[TASK_LOGGER_STACK_SIZE];
 
+// `logger stats` shell command prints the peak fill level and the dropped bytes
 #define LOGGER_STORAGE_SIZE_BYTES 512
 static uint8_t              logger_sbuffer_storage[LOGGER_STORAGE_SIZE_BYTES];
 static StaticStreamBuffer_t LoggerStreamBufferStruct;
+#endif
+
+static TaskHandle_t logger_task_handle;
+static StaticTask_t logger_task_buffer;
+static StackType_t  logger_task_stack[TASK_LOGGER_STACK_SIZE];
+
+// The logger thread hands the logs to the debug UART DMA in spans of up to this size and sleeps until they are sent
+#define LOGGER_UART_BUFFER_SIZE 128
+static uint8_t logger_uart_buffer[LOGGER_UART_BUFFER_SIZE];
+
+// The stream buffer and the binary logger wake the logger thread with the default notification
+#define LOGGER_TX_DONE_NOTIFICATION_INDEX 1
 
 #if defined(__cplusplus)
 extern "C"
 {
 #endif
 
-    extern UART_HandleTypeDef UART2_Handle;
-
     int __io_putchar(int ch)
     {
-        HAL_UART_Transmit(&UART2_Handle, (uint8_t *) &ch, 1, HAL_MAX_DELAY);
+        uint8_t data = static_cast<uint8_t>(ch);
+        bsp_debug_uart_tx(&data, 1);
         return ch;
     }
 
     void vApplicationIdleHook(void)
     {
-        // "Low-power mode"
-        __WFI();
+        // "Low-power mode", when the STOP mode is allowed vPortSuppressTicksAndSleep() sleeps until the next task
+        // timeout instead of the next tick
+        if (!bsp_low_power_is_stop_allowed())
+        {
+            __WFI();
+        }
     }
 
     void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
@@ -100,10 +119,52 @@ extern "C"
         return get_systick();
     }
 
+#if LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY
+    // Wakes the logger thread, the records written before it was created are sent at its first wakeup
+    void logger_binary_notify(void)
+    {
+        if (logger_task_handle == nullptr)
+        {
+            return;
+        }
+
+        if (__get_IPSR() != 0u)
+        {
+            BaseType_t is_higher_priority_task_woken = pdFALSE;
+            vTaskNotifyGiveFromISR(logger_task_handle, &is_higher_priority_task_woken);
+            portYIELD_FROM_ISR(is_higher_priority_task_woken);
+        }
+        else
+        {
+            xTaskNotifyGive(logger_task_handle);
+        }
+    }
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
 
+#if defined(LOGGER_USE_EXTERNAL_THREAD)
+static void logger_output(const uint8_t *p_data, size_t length)
+{
+#if defined(SEGGER_RTT)
+    SEGGER_RTT_Write(0, p_data, length);
+#else
+    // Busy while the shell prints, or until the debug UART is initialized
+    while (bsp_debug_uart_tx_dma(p_data, length) != 0)
+    {
+        vTaskDelay(pdMS_TO_TICKS(1));
+    }
+
+    while (bsp_debug_uart_is_tx_busy())
+    {
+        ulTaskNotifyTakeIndexed(LOGGER_TX_DONE_NOTIFICATION_INDEX, pdTRUE, portMAX_DELAY);
+    }
+#endif
+}
+#endif
+
 int main()
 {
 #if defined(BOOTLOADER)
@@ -123,31 +184,75 @@ int main()
     SEGGER_RTT_Init();
 #endif
 
-#ifdef LOGGER_USE_EXTERNAL_THREAD
+#if defined(LOGGER_USE_EXTERNAL_THREAD) && (LOGGER_OUTPUT_OPTION == LOGGER_OUTPUT_BINARY)
+    static_assert(sizeof(logger_uart_buffer) >= LOGGER_BINARY_FRAME_SIZE);
+
+    logger_task_handle = xTaskCreateStatic(
+        +[](void *)
+        {
+            for (;;)
+            {
+                ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+                // As many frames per transfer as fit, the records written meanwhile go with the next one
+                size_t length;
+                do
+                {
+                    length = 0;
+                    while (sizeof(logger_uart_buffer) - length >= LOGGER_BINARY_FRAME_SIZE)
+                    {
+                        size_t frame_length = logger_binary_read_frame(&logger_uart_buffer[length],
+                                                                       sizeof(logger_uart_buffer) - length);
+                        if (frame_length == 0)
+                        {
+                            break;
+                        }
+                        length += frame_length;
+                    }
+
+                    if (length != 0)
+                    {
+                        logger_output(logger_uart_buffer, length);
+                    }
+                } while (length != 0);
+            }
+        },
+        "Logger", TASK_LOGGER_STACK_SIZE, nullptr, 2, logger_task_stack, &logger_task_buffer);
+    APP_ASSERT(logger_task_handle);
+
+#elif defined(LOGGER_USE_EXTERNAL_THREAD)
     static auto sbuffer_logger_h = xStreamBufferCreateStatic(sizeof(logger_sbuffer_storage), 1u, logger_sbuffer_storage,
                                                              &LoggerStreamBufferStruct);
 
     logger_init(sbuffer_logger_h);
 
-    TaskHandle_t status = nullptr;
-    status              = xTaskCreateStatic(
-                     +[](void *)
-                     {
+    logger_task_handle = xTaskCreateStatic(
+        +[](void *)
+        {
             for (;;)
             {
-                if (uint8_t data; xStreamBufferReceive(sbuffer_logger_h, &data, 1, portMAX_DELAY) > 0)
+                // Everything in the buffer, up to the size of one transfer
+                size_t length = xStreamBufferReceive(sbuffer_logger_h, logger_uart_buffer, sizeof(logger_uart_buffer),
+                                                     portMAX_DELAY);
+                if (length != 0)
                 {
-#if defined(SEGGER_RTT)
-                    SEGGER_RTT_PutChar(0, data);
-#else
-                    __io_putchar(data);
-#endif
+                    logger_output(logger_uart_buffer, length);
                 }
             }
         },
         "Logger", TASK_LOGGER_STACK_SIZE, nullptr, 2, logger_task_stack, &logger_task_buffer);
-    APP_ASSERT(status);
+    APP_ASSERT(logger_task_handle);
+#endif
 
+#if defined(LOGGER_USE_EXTERNAL_THREAD)
+    bsp_debug_uart_set_tx_done_callback(
+        +[]()
+        {
+            BaseType_t is_higher_priority_task_woken = pdFALSE;
+            vTaskNotifyGiveIndexedFromISR(logger_task_handle, LOGGER_TX_DONE_NOTIFICATION_INDEX,
+                                          &is_higher_priority_task_woken);
+            portYIELD_FROM_ISR(is_higher_priority_task_woken);
+        });
 #endif // LOGGER_USE_EXTERNAL_THREAD
 
     Teufel::Task::System::start();
@@ -185,7 +290,7 @@ static void SystemClock_Config()
 
     PeriphClkInit.PeriphClockSelection = RCC_PERIPHCLK_USART1 | RCC_PERIPHCLK_USART2 | RCC_PERIPHCLK_I2C1;
     PeriphClkInit.Usart1ClockSelection = RCC_USART1CLKSOURCE_PCLK1;
-    PeriphClkInit.Usart2ClockSelection = RCC_USART2CLKSOURCE_PCLK1;
+    PeriphClkInit.Usart2ClockSelection = RCC_USART2CLKSOURCE_HSI; // Receives in the STOP mode
     PeriphClkInit.I2c1ClockSelection   = RCC_I2C1CLKSOURCE_SYSCLK;
 
     hal_stat = HAL_RCCEx_PeriphCLKConfig(&PeriphClkInit);
@@ -11,6 +11,8 @@ uint16_t VirtAddVarTab[EEPROM_ELEMENTS] = {
     ADDR_ECO_MODE,
     ADDR_SOUND_ICONS_ACTIVE,
     ADDR_CHARGE_TYPE,
+    ADDR_OFF_TIMER,
+    ADDR_OFF_TIMER_ENABLED,
 
     ADDR_BATTERY_SOC_ALGO_STATE,
     ADDR_BATTERY_SOC_ACCUMULATED_CHARGE_MSB,
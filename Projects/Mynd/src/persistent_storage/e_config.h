@@ -10,6 +10,8 @@ typedef enum
     ADDR_ECO_MODE           = 0x05,
     ADDR_SOUND_ICONS_ACTIVE = 0x06,
     ADDR_CHARGE_TYPE        = 0x07,
+    ADDR_OFF_TIMER          = 0x08,
+    ADDR_OFF_TIMER_ENABLED  = 0x09,
 
     ADDR_BATTERY_SOC_ALGO_STATE             = 0x70,
     ADDR_BATTERY_SOC_ACCUMULATED_CHARGE_MSB = 0x71,
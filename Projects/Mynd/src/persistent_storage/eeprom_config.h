@@ -3,4 +3,4 @@
 #define EEPROM_FLASH_PAGE0 ((uint32_t) ADDR_FLASH_PAGE_62)
 #define EEPROM_FLASH_PAGE1 ((uint32_t) ADDR_FLASH_PAGE_63)
 
-#define EEPROM_ELEMENTS 13
+#define EEPROM_ELEMENTS 15
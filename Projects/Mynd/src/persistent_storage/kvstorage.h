@@ -4,6 +4,7 @@
 #include <unordered_map>
 #include "external/teufel/libs/tshell/tshell.h"
 #endif // INCLUDE_PRODUCTION_TEST
+#include <bit>
 #include <optional>
 #include <variant>
 #include "logger.h"
@@ -54,6 +55,43 @@ inline void init()
     vEEPROM_Init();
 }
 
+// Reads a 32-bit value stored in two variables, the 16 most significant bits first
+inline std::optional<uint32_t> load_u32(uint16_t msb_address, uint16_t lsb_address)
+{
+    uint16_t cell_value_msb;
+    uint16_t cell_value_lsb;
+    if (vEEPROM_AddressRead(msb_address, &cell_value_msb) == 0 &&
+        vEEPROM_AddressRead(lsb_address, &cell_value_lsb) == 0)
+    {
+        return (static_cast<uint32_t>(cell_value_msb) << 16) | cell_value_lsb;
+    }
+    return std::nullopt;
+}
+
+inline void save_u32(uint16_t msb_address, uint16_t lsb_address, uint32_t value)
+{
+    vEEPROM_AddressWrite(msb_address, static_cast<uint16_t>(value >> 16));
+    vEEPROM_AddressWrite(lsb_address, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+// The SoC charge and capacity were stored as float ampere * seconds before they became integer milliampere * seconds.
+// The bit patterns of the floats in their range are integers beyond 2^28 mAs (74 Ah), those are converted.
+inline int32_t load_milliampere_seconds(uint32_t cell_value)
+{
+    auto value = std::bit_cast<int32_t>(cell_value);
+    if (value > -(1 << 28) && value < (1 << 28))
+    {
+        return value;
+    }
+
+    auto legacy_value = std::bit_cast<float>(cell_value) * 1000.f;
+    if (!(legacy_value > -2e9f && legacy_value < 2e9f))
+    {
+        return 0;
+    }
+    return static_cast<int32_t>(legacy_value);
+}
+
 template <typename T>
 constexpr std::optional<T> load()
 {
@@ -68,24 +106,16 @@ constexpr std::optional<T> load()
     }
     else if constexpr (std::is_same_v<T, Teufel::Ux::System::BatterySocAccumulatedCharge>)
     {
-        uint16_t cell_value_msb;
-        uint16_t cell_value_lsb;
-        if (vEEPROM_AddressRead(0x71, &cell_value_msb) == 0 && vEEPROM_AddressRead(0x72, &cell_value_lsb) == 0)
+        if (auto cell_value = load_u32(0x71, 0x72))
         {
-            uint32_t cell_value = (cell_value_msb << 16) | cell_value_lsb;
-            auto     c          = *(float *) &cell_value;
-            return std::optional<T>(T{.value = c});
+            return std::optional<T>(T{.value = load_milliampere_seconds(*cell_value)});
         }
     }
     else if constexpr (std::is_same_v<T, Teufel::Ux::System::BatterySocCapacity>)
     {
-        uint16_t cell_value_msb;
-        uint16_t cell_value_lsb;
-        if (vEEPROM_AddressRead(0x73, &cell_value_msb) == 0 && vEEPROM_AddressRead(0x74, &cell_value_lsb) == 0)
+        if (auto cell_value = load_u32(0x73, 0x74))
         {
-            uint32_t cell_value = (cell_value_msb << 16) | cell_value_lsb;
-            auto     c          = *(float *) &cell_value;
-            return std::optional<T>(T{.value = c});
+            return std::optional<T>(T{.value = load_milliampere_seconds(*cell_value)});
         }
     }
     else
@@ -121,24 +151,14 @@ constexpr void save(T v)
 
     if constexpr (std::is_same_v<T, Teufel::Ux::System::BatterySocAccumulatedCharge>)
     {
-        uint32_t c              = *(uint32_t *) &v.value;
-        uint16_t cell_value_msb = (c >> 16) & 0xFFFF;
-        uint16_t cell_value_lsb = c & 0xFFFF;
-
-        vEEPROM_AddressWrite(0x71, cell_value_msb);
-        vEEPROM_AddressWrite(0x72, cell_value_lsb);
-
+        save_u32(0x71, 0x72, std::bit_cast<uint32_t>(v.value));
         return;
     }
 
     if constexpr (std::is_same_v<T, Teufel::Ux::System::BatterySocCapacity>)
     {
-        uint32_t c              = *(uint32_t *) &v.value;
-        uint16_t cell_value_msb = (c >> 16) & 0xFFFF;
-        uint16_t cell_value_lsb = c & 0xFFFF;
-
-        vEEPROM_AddressWrite(0x73, cell_value_msb);
-        vEEPROM_AddressWrite(0x74, cell_value_lsb);
+        save_u32(0x73, 0x74, std::bit_cast<uint32_t>(v.value));
+        return;
     }
 
     if constexpr (std::is_enum_v<BaseT>)
@@ -165,14 +185,15 @@ inline void test()
     test_helper({17512});
     test_helper({67232});
 
-    test_helper({32.234123415f});
+    test_helper({32234});
+    test_helper({17640000});
     // test_helper({INT32_MAX});
 
     test_helper({-1});
     test_helper({-17});
     test_helper({-130});
     test_helper({-17333});
-    test_helper({-128333.777});
+    test_helper({-128333777});
     // test_helper({INT16_MIN});
     // test_helper({INT32_MIN});
 }
@@ -47,8 +47,37 @@ void DMA1_Channel1_IRQHandler(void)
     HAL_DMA_IRQHandler(Adc1Handle.DMA_Handle);
 }
 
+void DMA1_Channel2_3_IRQHandler(void)
+{
+    // Bluetooth UART TX
+    HAL_DMA_IRQHandler(UART1_Handle.hdmatx);
+    // Bluetooth UART RX
+    HAL_DMA_IRQHandler(UART1_Handle.hdmarx);
+}
+
+void DMA1_Channel4_5_6_7_IRQHandler(void)
+{
+    // Shared I2C TX
+    HAL_DMA_IRQHandler(I2C2_Handle.hdmatx);
+    // Shared I2C RX
+    HAL_DMA_IRQHandler(I2C2_Handle.hdmarx);
+    // Debug UART TX, only linked once the debug UART is initialized
+    if (UART2_Handle.hdmatx != NULL)
+    {
+        HAL_DMA_IRQHandler(UART2_Handle.hdmatx);
+    }
+}
+
+void bsp_bluetooth_uart_isr_char_match_callback(void);
+void bsp_bluetooth_uart_isr_rx_event_callback(void);
+void bsp_bluetooth_uart_isr_error_callback(void);
+void bsp_debug_uart_isr_rx_complete_callback(void);
+void bsp_debug_uart_isr_tx_complete_callback(void);
+
 void USART1_IRQHandler(void)
 {
+    // The HAL does not handle the character match flag, so it has to be cleared before
+    bsp_bluetooth_uart_isr_char_match_callback();
     HAL_UART_IRQHandler(&UART1_Handle);
 }
 
@@ -57,18 +86,28 @@ void USART2_IRQHandler(void)
     HAL_UART_IRQHandler(&UART2_Handle);
 }
 
-void bsp_bluetooth_uart_isr_rx_complete_callback(void);
-void bsp_debug_uart_isr_rx_complete_callback(void);
-
 void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
 {
-    if (huart->Instance == USART1)
+    if (huart->Instance == USART2)
     {
-        bsp_bluetooth_uart_isr_rx_complete_callback();
+        bsp_debug_uart_isr_rx_complete_callback();
     }
-    else if (huart->Instance == USART2)
+}
+
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart)
+{
+    if (huart->Instance == USART2)
     {
-        bsp_debug_uart_isr_rx_complete_callback();
+        bsp_debug_uart_isr_tx_complete_callback();
+    }
+}
+
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
+{
+    (void) Size;
+    if (huart->Instance == USART1)
+    {
+        bsp_bluetooth_uart_isr_rx_event_callback();
     }
 }
 
@@ -85,6 +124,8 @@ void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart)
         __HAL_UART_CLEAR_IDLEFLAG(&UART1_Handle);
 
         HAL_UART_MspInit(&UART1_Handle);
+
+        bsp_bluetooth_uart_isr_error_callback();
     }
     else if (huart->Instance == USART2)
     {
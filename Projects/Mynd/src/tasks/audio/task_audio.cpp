@@ -1,17 +1,21 @@
 // Due to the flash size limit, only the WARNING level is available
-// for use in the complete firmware (including the bootloader).
-#if defined(BOOTLOADER)
+// for use in the complete firmware (including the bootloader),
+// unless the binary logger keeps the format strings out of the flash.
+#if defined(BOOTLOADER) && !defined(LOGGER_BINARY)
 #define LOG_LEVEL LOG_LEVEL_WARNING
 #else
 #define LOG_LEVEL LOG_LEVEL_INFO
 #endif
 
+#include <cstdio>
+
 #include "config.h"
 #include "battery.h"
 #include "board.h"
 #include "board_link.h"
 #include "bsp_shared_i2c.h"
 #include "bsp_usb_pd_i2c.h"
+#include "bsp_low_power.h"
 #include "button_handler.h"
 #include "input_events.h"
 #include "leds.h"
@@ -27,7 +31,9 @@
 #include "task_bluetooth.h"
 #include "task_system.h"
 #include "task_priorities.h"
+#include "idle_policy.h"
 #include "tests.h"
+#include "tasxxxx_volume_table.h"
 
 #include "external/teufel/libs/tshell/tshell.h"
 #include "external/teufel/libs/core_utils/mapper.h"
@@ -99,7 +105,7 @@ static auto pwr_ac_debouncer = Debouncer<bool, 2000>{true, get_systick, board_ge
 // static auto volume_debouncer = Debouncer<bool, 200>{false, get_systick, board_get_ms_since};
 
 static void read_io_expander_inputs();
-static void disable_amps();
+static void disable_amps(bool retain_state);
 
 static Tus::Task                                           ot_id                      = Tus::Task::Audio;
 static Teufel::GenericThread::GenericThread<AudioMessage> *task_handler               = nullptr;
@@ -119,8 +125,30 @@ static struct
     bool ignore_hold_until_stop_pairing           = false;
     bool bypass_mode                              = false;
     bool plug_connected                           = false;
+    bool is_volume_ramping                        = false;
 } s_audio;
 
+#if CONFIG_AMPS_VOLUME_RAMP
+// Volume of the amps for an AVRCP volume, linear in dB from CONFIG_AMPS_VOLUME_MIN_DB to CONFIG_AMPS_VOLUME_MAX_DB
+static int16_t get_amps_volume(uint8_t avrcp_volume)
+{
+    constexpr int32_t c_min = CONFIG_AMPS_VOLUME_MIN_DB * TASXXXX_VOLUME_STEPS_PER_DB;
+    constexpr int32_t c_max = CONFIG_AMPS_VOLUME_MAX_DB * TASXXXX_VOLUME_STEPS_PER_DB;
+
+    if (avrcp_volume == 0)
+    {
+        return TASXXXX_VOLUME_MUTE;
+    }
+    return static_cast<int16_t>(c_min + (c_max - c_min) * (avrcp_volume - 1) / (CONFIG_MAX_AVRCP_VOLUME - 1));
+}
+
+static void ramp_amps_volume(uint8_t avrcp_volume)
+{
+    board_link_amps_ramp_volume_to(get_amps_volume(avrcp_volume));
+    s_audio.is_volume_ramping = true;
+}
+#endif
+
 static const board_link_usb_pd_controller_callbacks_t usb_callbacks = {
     .plug_connection_change_cb =
         +[](bool connected)
@@ -558,11 +586,30 @@ static const button_handler_config_t button_handler_config = {
     .enable_multitouch_support       = false,
 };
 
+// Evaluated before every idle period: the MCU only enters the STOP mode when the task has nothing to poll
+static uint32_t get_idle_ms()
+{
+    const Idle::Inputs inputs{
+        .is_off            = isProperty(Tus::PowerState::Off),
+        .is_charging       = isProperty(Tus::ChargerStatus::Active),
+        .is_led_animating  = Leds::is_engine_running(Leds::Led::Status) || Leds::is_engine_running(Leds::Led::Source),
+        .is_button_pressed = s_buttons_state != 0,
+        .volume_ramp_ms    = s_audio.is_volume_ramping ? CONFIG_AMPS_VOLUME_RAMP_PERIOD_MS : 0u,
+    };
+
+    const bool is_stop_allowed = Idle::is_stop_allowed(inputs);
+    bsp_low_power_allow_stop(is_stop_allowed);
+    Battery::set_adc_one_shot(is_stop_allowed);
+    Battery::set_sample_period(Idle::soc_sample_ms(inputs));
+
+    return Idle::audio_idle_ms(inputs);
+}
+
 static const GenericThread::Config<AudioMessage> threadConfig = {
     .Name      = "Audio",
     .StackSize = TASK_AUDIO_STACK_SIZE,
     .Priority  = TASK_AUDIO_PRIORITY,
-    .IdleMs    = 25,
+    .IdleMs    = Idle::c_active_poll_ms,
     .Callback_Idle = []() {
         // Checking if (not isProperty(Tus::PowerState::Off) is unnecessary here. It prevented charging indication from playing while in pseudo off state and
         // the s_source_led_engine has logic in update_infinite_patterns() to ensure it does not run while in a power-off state.
@@ -639,6 +686,11 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
             board_link_amps_woofer_fault_recover();
         }
 
+#if CONFIG_AMPS_VOLUME_RAMP
+        // The steps only depend on the time, not on how often the volume changes
+        s_audio.is_volume_ramping = isProperty(Tus::PowerState::On) && board_link_amps_run_volume_ramp();
+#endif
+
         factory_test_key_process();
     },
     .Callback_Init = []() {
@@ -757,35 +809,40 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
 
                             Battery::set_power_state(p.to);
 
-                            disable_amps();
+                            disable_amps(true);
 
                             s_audio.bypass_mode = false;
                             break;
                         }
 
-                        case Tus::PowerState::PreOn: {
+                        default:
+                            break;
+                    }
+                    SyncPrimitive::notify(ot_id);
+                },
+                [](const PowerSequence::RunStep &p) {
+                    switch (p.step) {
+                        case PowerSequence::Step::BoostOn: {
                             board_link_io_expander_reset(false);
 
                             // Startup sequence of the amplifiers requires power supplies to be stable
                             // before enabling the amplifiers (bringing PDN pin high)
                             // The boost converter provides PVDD (24V)
                             board_link_boost_converter_enable(true);
+                            break;
+                        }
 
-                            // Boost controller needs 50 us to turn on its internal regulator plus
-                            // 120 us to perform its initial configuration after enabling the device
-                            vTaskDelay(pdMS_TO_TICKS(10));
-
-                            // Reset recovery time for IO expander is ~1 us
+                        case PowerSequence::Step::IoExpander:
                             board_link_io_expander_setup_for_normal_operation();
+                            break;
 
+                        case PowerSequence::Step::AmpsPdn:
                             // Both amps' datasheets specify that the PDN pin should be high for at least 5 ms
-                            // before the I2S clocks start (provided by the BT module, synchronized by the system task)
+                            // before the I2S clocks start (provided by the BT module, sequenced by the system task)
                             board_link_amps_enable(true);
+                            break;
 
-                            // Likely not necessary considering all the stuff that needs to happen
-                            // before the amps are initialized when we get PowerState::On
-                            vTaskDelay(pdMS_TO_TICKS(5));
-
+                        case PowerSequence::Step::Indication: {
                             if (s_audio.bypass_mode)
                             {
                                 log_highlight("Starting in bypass mode");
@@ -802,17 +859,31 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
                             break;
                         }
 
-                        case Tus::PowerState::On: {
-                            // The I2S clocks should be stable by now (provided by BT module, synchronized by the system task)
+                        case PowerSequence::Step::PdVersion: {
+                            uint8_t pd_version = 0x00;
+                            if (board_link_usb_pd_controller_fw_version(&pd_version) == 0)
+                            {
+                                log_warn("PD controller FW version: %d.%d", pd_version >> 4, pd_version & 0x0F);
+                            }
+                            break;
+                        }
+
+                        case PowerSequence::Step::AmpsConfig: {
+                            // The I2S clocks should be stable by now (provided by BT module, sequenced by the system task)
                             // We should now be able to safely start configuring the amplifiers
                             board_link_amps_mode_t amp_mode = s_audio.bypass_mode ? AMP_MODE_BYPASS : AMP_MODE_NORMAL;
-                            board_link_amps_setup_woofer(amp_mode);
-                            board_link_amps_setup_tweeter(amp_mode);
+                            const bool             resumed  = board_link_amps_resume(amp_mode) == 0;
+                            if (!resumed)
+                            {
+                                board_link_amps_setup_woofer(amp_mode);
+                                board_link_amps_setup_tweeter(amp_mode);
+                            }
 
-                            if (isProperty(Tua::EcoMode{true}))
+                            // A loaded configuration is in normal mode, a retained one in the mode it was left in
+                            if (resumed || isProperty(Tua::EcoMode{true}))
                             {
 #ifndef INCLUDE_PRODUCTION_TESTS
-                                board_link_amps_enable_eco_mode(true);
+                                board_link_amps_enable_eco_mode(isProperty(Tua::EcoMode{true}));
 #endif
                             }
 
@@ -824,18 +895,22 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
                             }
 #endif
 
+#if CONFIG_AMPS_VOLUME_RAMP
+                            // The amps start playing muted after a power cycle, the volume fades in
+                            ramp_amps_volume(getProperty<Tua::VolumeLevel>().value);
+#endif
+
                             s_is_aux_jack_connected = board_link_plug_detection_is_jack_connected();
                             Teufel::Task::Bluetooth::postMessage(ot_id, Tub::NotifyAuxConnectionChange{s_is_aux_jack_connected});
 
-                            Battery::set_power_state(p.to);
-
+                            Battery::set_power_state(Tus::PowerState::On);
                             break;
                         }
 
                         default:
                             break;
                     }
-                    SyncPrimitive::notify(ot_id);
+                    Task::System::notifyPowerStepDone(p.step);
                 },
                 [](const IoExpanderInterrupt &) {
                     log_debug("IO expander interrupt");
@@ -849,6 +924,12 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
                 {
                     log_info("Updating current avrcp volume");
                     setProperty(Tua::VolumeLevel{ p.value });
+#if CONFIG_AMPS_VOLUME_RAMP
+                    if (isProperty(Tus::PowerState::On))
+                    {
+                        ramp_amps_volume(p.value);
+                    }
+#endif
                 },
                 [](const Tub::Status &s) {
                     log_info("Bluetooth status changed to %s", getDesc(s));
@@ -946,13 +1027,14 @@ static const GenericThread::Config<AudioMessage> threadConfig = {
                     s_audio.ignore_power_input_until_release = true; // do not allow batt pattern to override
                 },
                 [](const Tus::HardReset &) {
-                    disable_amps();
+                    disable_amps(false);
                     vPortEnterCritical();
                     NVIC_DisableIRQ(SysTick_IRQn);
                     NVIC_SystemReset();
                 },
             }, msg);
     },
+    .Callback_GetIdleMs = get_idle_ms,
     .StackBuffer = audio_task_stack,
     .StaticTask = &audio_task_buffer,
     .StaticQueue = &queue_static,
@@ -998,16 +1080,27 @@ static void read_io_expander_inputs() {
     button_handler_process(s_button_handler, s_buttons_state);
 }
 
-static void disable_amps()
+static void disable_amps(bool retain_state)
 {
     // Mute the amps and wait for them to mute before power down
     board_link_amps_mute(true);
     vTaskDelay(pdMS_TO_TICKS(10));
 
-    // Disable the amplifiers and wait for them to disable before power down
-    // Datasheet specifies to wait at least 6 ms for this (apparently it depends on several things)
-    board_link_amps_enable(false);
-    vTaskDelay(pdMS_TO_TICKS(20));
+#if CONFIG_AMPS_RETAIN_STATE_WHEN_OFF
+    // On external power the MCU keeps running in pseudo-off, the amps can keep their configuration in deep sleep
+    // (a few mW) and the next power on only checks it. On battery the whole speaker is powered down.
+    if (retain_state && board_link_power_supply_is_ac_ok() && board_link_amps_suspend() == 0)
+    {
+        log_info("Amps retain their configuration");
+    }
+    else
+#endif
+    {
+        // Disable the amplifiers and wait for them to disable before power down
+        // Datasheet specifies to wait at least 6 ms for this (apparently it depends on several things)
+        board_link_amps_enable(false);
+        vTaskDelay(pdMS_TO_TICKS(20));
+    }
 
     // Bring down power supplies after disabling the amps
     board_link_boost_converter_enable(false);
@@ -1016,6 +1109,65 @@ static void disable_amps()
     vTaskDelay(pdMS_TO_TICKS(10));
 }
 
+#ifndef BOOTLOADER
+
+// Prints how much of the shared I2C bus time each device used since the last reset
+static void print_i2c_stats()
+{
+    i2c_rtos_stats_t stats;
+    if (bsp_shared_i2c_get_stats(&stats) != 0)
+    {
+        printf("I2C stats not available\r\n");
+        return;
+    }
+
+    printf("I2C: %lu batches, %lu timeouts in %lu ms\r\n", stats.batches, stats.timeouts, stats.elapsed_ms);
+
+    const uint64_t available_clocks = static_cast<uint64_t>(stats.elapsed_ms) * bsp_shared_i2c_get_speed_khz();
+    for (uint8_t i = 0; i < stats.number_of_devices; i++)
+    {
+        const auto    &device   = stats.devices[i];
+        const uint32_t permille = available_clocks ? (uint64_t{device.bus_clocks} * 1000u) / available_clocks : 0u;
+
+        printf("  0x%02X: %lu transfers, %lu bytes, %lu errors, %lu.%lu%% bus\r\n", device.i2c_address >> 1,
+               device.transfers, device.bytes, device.errors, permille / 10u, permille % 10u);
+    }
+
+    board_link_amps_stats_t woofer, tweeter;
+    board_link_amps_get_stats(&woofer, &tweeter);
+
+    const auto print_amp = [](const char *name, const board_link_amps_stats_t &amp)
+    {
+        printf("  %s: %lu writes, %lu reads, %lu page selections, %lu skipped, %lu configurations\r\n", name,
+               amp.writes, amp.reads, amp.selections, amp.selections_skipped, amp.configurations);
+    };
+    print_amp("woofer", woofer);
+    print_amp("tweeter", tweeter);
+}
+
+static void reset_i2c_stats()
+{
+    bsp_shared_i2c_reset_stats();
+    board_link_amps_reset_stats();
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+
+// clang-format off
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_i2c,
+    SHELL_CMD_NO_ARGS(stats, "shared bus occupancy per device", []() { print_i2c_stats(); }),
+    SHELL_CMD_NO_ARGS(reset, "reset the shared bus statistics", []() { reset_i2c_stats(); }),
+    SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+// clang-format on
+
+SHELL_CMD_ARG_REGISTER(i2c, &sub_i2c, "shared i2c bus", NULL, 2, 0);
+
+#pragma GCC diagnostic pop
+
+#endif
+
 }
 
 // Properties public API
@@ -7,6 +7,8 @@
 #include "ux/bluetooth/bluetooth.h"
 #include "ux/system/system.h"
 
+#include "power_sequence.h"
+
 namespace Teufel::Task::Audio
 {
 
@@ -15,6 +17,7 @@ struct IoExpanderInterrupt {};
 
 using AudioMessage = std::variant<
     Teufel::Ux::System::SetPowerState,
+    Teufel::Task::PowerSequence::RunStep,
     Teufel::Ux::System::LedBrightness,
     Teufel::Ux::Audio::UpdateVolume,
     Teufel::Ux::Bluetooth::Status,
@@ -1,6 +1,7 @@
 // Due to the flash size limit, only the WARNING level is available
-// for use in the complete firmware (including the bootloader).
-#if defined(BOOTLOADER)
+// for use in the complete firmware (including the bootloader),
+// unless the binary logger keeps the format strings out of the flash.
+#if defined(BOOTLOADER) && !defined(LOGGER_BINARY)
 #define LOG_LEVEL LOG_LEVEL_WARNING
 #else
 #define LOG_LEVEL LOG_LEVEL_INFO
@@ -33,10 +34,7 @@
 #include "external/teufel/libs/app_assert/app_assert.h"
 #include "gitversion//version.h"
 #include "persistent_storage/kvstorage.h"
-
-#ifdef INCLUDE_PRODUCTION_TESTS
 #include "external/teufel/libs/tshell/tshell.h"
-#endif // INCLUDE_PRODUCTION_TESTS
 
 #define TASK_BLUETOOTH_STACK_SIZE 448
 #define QUEUE_SIZE                8
@@ -100,6 +98,9 @@ TS_KEY_VALUE_CONST_MAP(SoundIconToLengthMapper, actionslink_sound_icon_t, uint16
 constexpr uint32_t c_update_bt_state_ts_duration = 200;
 // clang-format on
 
+// Idle period while something time based is pending, otherwise the task sleeps until it gets a message or data
+constexpr uint32_t c_polling_idle_ms = 10;
+
 static void actionslink_print_log(actionslink_log_level_t level, const char *dsc);
 static int  actionslink_read_buffer(uint8_t *p_data, uint8_t length, uint32_t timeout);
 static int  actionslink_write_buffer(const uint8_t *p_data, uint8_t length, uint32_t timeout);
@@ -107,9 +108,6 @@ static int  actionslink_write_buffer(const uint8_t *p_data, uint8_t length, uint
 #define ACTIONSLINK_RX_BUFFER_SIZE 64u
 uint8_t actionslink_rx_buffer[ACTIONSLINK_RX_BUFFER_SIZE] = {0};
 
-#define ACTIONSLINK_TX_BUFFER_SIZE 32u
-uint8_t actionslink_tx_buffer[ACTIONSLINK_TX_BUFFER_SIZE] = {0};
-
 TS_KEY_VALUE_CONST_MAP(CsbStateMapper, actionslink_csb_state_t, Tub::Status,
                        {ACTIONSLINK_CSB_STATE_BROADCASTING, Tub::Status::CsbChainMaster},
                        {ACTIONSLINK_CSB_STATE_RECEIVER_CONNECTED, Tub::Status::ChainSlave},
@@ -312,6 +310,25 @@ static void update_infinite_sound_icons()
     }
 }
 
+static uint32_t get_idle_ms()
+{
+    const bool is_power_on_sound_icon_playing =
+        s_bluetooth.power_on_sound_icon_ts != 0u && s_bluetooth.power_on_sound_icon_ts != UINT32_MAX;
+
+    // Infinite sound icons are restarted by the idle callback once the current sound icon is over
+    const bool is_infinite_sound_icon_active =
+        isPropertyOneOf(Tub::Status::BluetoothPairing, Tub::Status::SlavePairing);
+
+    // Pending Actionslink transactions time out and get retried from actionslink_tick()
+    if (is_power_on_sound_icon_playing || is_infinite_sound_icon_active || s_bluetooth.update_bt_state ||
+        actionslink_is_busy())
+    {
+        return c_polling_idle_ms;
+    }
+
+    return GenericThread::IdleForever;
+}
+
 static const actionslink_request_handlers_t actionslink_request_handlers = {
     .on_request_get_mcu_firmware_version =
         +[](uint8_t seq_id)
@@ -632,24 +649,27 @@ static const actionslink_event_handlers_t actionslink_event_handlers = {
 };
 
 static const actionslink_config_t actionslink_configuration = {
-    .write_buffer_fn = actionslink_write_buffer,
-    .read_buffer_fn  = actionslink_read_buffer,
-    .get_tick_ms_fn  = get_systick,
-    .msp_init_fn     = nullptr,
-    .msp_deinit_fn   = nullptr,
-    .task_yield_fn   = +[]() { vTaskDelay(pdMS_TO_TICKS(2)); },
-    .log_fn          = actionslink_print_log,
-    .p_rx_buffer     = actionslink_rx_buffer,
-    .p_tx_buffer     = actionslink_tx_buffer,
-    .rx_buffer_size  = ACTIONSLINK_RX_BUFFER_SIZE,
-    .tx_buffer_size  = ACTIONSLINK_TX_BUFFER_SIZE,
+    .write_buffer_fn   = actionslink_write_buffer,
+    .read_buffer_fn    = actionslink_read_buffer,
+    .get_tick_ms_fn    = get_systick,
+    .msp_init_fn       = nullptr,
+    .msp_deinit_fn     = nullptr,
+    .task_yield_fn     = +[]() { GenericThread::WaitForWakeup(2); },
+    .log_fn            = actionslink_print_log,
+    .p_rx_buffer       = actionslink_rx_buffer,
+    .p_tx_buffer       = nullptr, // Frames are built directly in the DMA TX buffer
+    .rx_buffer_size    = ACTIONSLINK_RX_BUFFER_SIZE,
+    .tx_buffer_size    = 0,
+    .read_available_fn = bsp_bluetooth_uart_rx_available,
+    .get_tx_buffer_fn  = bsp_bluetooth_uart_tx_get_buffer,
+    .send_tx_buffer_fn = bsp_bluetooth_uart_tx_send_buffer,
 };
 
 static const GenericThread::Config<BluetoothMessage> threadConfig = {
     .Name      = "Bluetooth",
     .StackSize = TASK_BLUETOOTH_STACK_SIZE,
     .Priority  = TASK_BLUETOOTH_PRIORITY,
-    .IdleMs    = 10,
+    .IdleMs    = c_polling_idle_ms,
     .Callback_Idle =
         []()
     {
@@ -688,6 +708,7 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
         []()
     {
         bsp_bluetooth_uart_init();
+        bsp_bluetooth_uart_set_rx_callback(+[]() { GenericThread::Wakeup(task_handler); });
         board_link_bluetooth_init();
         board_link_bluetooth_set_power(false);
         board_link_bluetooth_reset(true);
@@ -736,7 +757,7 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
                             auto ts = get_systick();
                             while (board_get_ms_since(ts) < 1000 && not s_bluetooth.has_received_power_off_confirmation)
                             {
-                                vTaskDelay(pdMS_TO_TICKS(10));
+                                GenericThread::WaitForWakeup(10);
                                 actionslink_tick();
                             }
                             if (not s_bluetooth.has_received_power_off_confirmation)
@@ -751,7 +772,16 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
                             break;
                         }
 
-                        case Tus::PowerState::On:
+                        default:
+                            break;
+                    }
+                    SyncPrimitive::notify(ot_id);
+                },
+                [](const PowerSequence::RunStep &p)
+                {
+                    switch (p.step)
+                    {
+                        case PowerSequence::Step::BtBoot:
                         {
                             board_link_bluetooth_reset(false);
                             board_link_bluetooth_set_power(true);
@@ -762,25 +792,25 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
 
                             while (not actionslink_is_ready())
                             {
-                                vTaskDelay(pdMS_TO_TICKS(10));
+                                GenericThread::WaitForWakeup(10);
                                 actionslink_tick();
                             }
+                            break;
+                        }
 
+                        case PowerSequence::Step::BtVersion:
+                        {
                             actionslink_firmware_version_t version = {0};
                             if (get_bt_fw_version(&version) == 0)
                             {
                                 log_warn("Actions FW version: %d.%d.%d%s", version.major, version.minor, version.patch,
                                          version.p_build_string->p_buffer);
                             }
+                            break;
+                        }
 
-                            uint8_t pd_version = 0x00;
-                            if (board_link_usb_pd_controller_fw_version(&pd_version) == 0)
-                            {
-                                log_warn("PD controller FW version: %d.%d", pd_version >> 4, pd_version & 0x0F);
-                            }
-
-                            vTaskDelay(pdMS_TO_TICKS(200));
-
+                        case PowerSequence::Step::BtPowerOn:
+                        {
                             if (actionslink_set_power_state(ACTIONSLINK_POWER_STATE_ON) != 0)
                             {
                                 log_error("Failed to request power on");
@@ -788,15 +818,16 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
 
                             while (not s_bluetooth.audio_source.has_value())
                             {
-                                vTaskDelay(pdMS_TO_TICKS(10));
+                                GenericThread::WaitForWakeup(10);
                                 actionslink_tick();
                             }
                             break;
                         }
+
                         default:
                             break;
                     }
-                    SyncPrimitive::notify(ot_id);
+                    Task::System::notifyPowerStepDone(p.step);
                 },
                 [](const Teufel::Ux::System::BatteryLevel &p)
                 {
@@ -1193,10 +1224,11 @@ static const GenericThread::Config<BluetoothMessage> threadConfig = {
             },
             msg);
     },
-    .StackBuffer = bluetooth_task_stack,
-    .StaticTask  = &bluetooth_task_buffer,
-    .StaticQueue = &queue_static,
-    .QueueBuffer = queue_static_buffer,
+    .Callback_GetIdleMs = get_idle_ms,
+    .StackBuffer        = bluetooth_task_stack,
+    .StaticTask         = &bluetooth_task_buffer,
+    .StaticQueue        = &queue_static,
+    .QueueBuffer        = queue_static_buffer,
 };
 
 int start()
@@ -1254,6 +1286,41 @@ static void actionslink_print_log(actionslink_log_level_t level, const char *dsc
     }
 }
 
+#ifndef BOOTLOADER
+
+// Prints why the task woke up since the last call, to check the idle wakeup rate on a bench
+static void print_wakeups()
+{
+    static uint32_t last_print_ts = 0u;
+
+    const auto                 wakeups = task_handler->wakeups;
+    bsp_bluetooth_uart_stats_t uart_stats;
+    bsp_bluetooth_uart_get_stats(&uart_stats);
+
+    printf("BT task wakeups in the last %lu ms: %lu messages, %lu data, %lu timeouts (%lu uart rx events in total)\r\n",
+           board_get_ms_since(last_print_ts), wakeups.Messages, wakeups.Wakeups, wakeups.Timeouts,
+           uart_stats.rx_irq_count);
+
+    task_handler->wakeups = {};
+    last_print_ts         = get_systick();
+}
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+
+// clang-format off
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_bt,
+    SHELL_CMD_NO_ARGS(wakeups, "task wakeups since the last call", []() { print_wakeups(); }),
+    SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+// clang-format on
+
+SHELL_CMD_ARG_REGISTER(bt, &sub_bt, "bluetooth", NULL, 2, 0);
+
+#pragma GCC diagnostic pop
+
+#endif
+
 }
 
 // Properties public API
@@ -7,6 +7,8 @@
 #include "ux/bluetooth/bluetooth.h"
 #include "ux/system/system.h"
 
+#include "power_sequence.h"
+
 namespace Teufel::Task::Bluetooth
 {
 
@@ -15,6 +17,7 @@ struct ActionsReady{};
 
 using BluetoothMessage = std::variant<
     Teufel::Ux::System::SetPowerState,
+    Teufel::Task::PowerSequence::RunStep,
     Teufel::Ux::System::BatteryLevel,
     Teufel::Ux::System::ChargerStatus,
     Teufel::Ux::System::ChargeType,
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+
+// Idle periods of the tasks which poll their inputs, depending on the power state. In the pseudo-off state (off, but
+// kept running by the USB power supply) the tasks only wake up as often as the polled inputs require, and the MCU
+// enters the STOP mode between the wakeups when none of its peripherals is in use.
+namespace Teufel::Task::Idle
+{
+
+struct Inputs
+{
+    bool is_off            = false; // PowerState::Off
+    bool is_charging       = false; // ChargerStatus::Active, the SoC estimator integrates the battery current
+    bool is_led_animating  = false; // An LED engine runs a pattern
+    bool is_button_pressed = false; // The button handler times the press
+
+    uint32_t volume_ramp_ms = 0; // Period of the running volume ramp of the amps, 0 if it isn't running
+};
+
+// LED pattern steps, buttons and the shell
+constexpr uint32_t c_active_poll_ms = 25;
+
+// The power button isn't an interrupt, a press must be seen well before its release
+constexpr uint32_t c_off_poll_ms = 100;
+
+// The SoC estimator integrates the battery current over the actual time between two samples
+constexpr uint32_t c_soc_sample_ms     = 10;
+constexpr uint32_t c_off_soc_sample_ms = 1000;
+
+constexpr bool is_active(const Inputs &inputs)
+{
+    return !inputs.is_off || inputs.is_led_animating || inputs.is_button_pressed || inputs.volume_ramp_ms != 0;
+}
+
+// Audio task: LEDs, buttons, USB PD events, battery, power supply and the steps of the volume ramp
+constexpr uint32_t audio_idle_ms(const Inputs &inputs)
+{
+    const uint32_t poll_ms = is_active(inputs) ? c_active_poll_ms : c_off_poll_ms;
+    return (inputs.volume_ramp_ms != 0 && inputs.volume_ramp_ms < poll_ms) ? inputs.volume_ramp_ms : poll_ms;
+}
+
+// System task: shell and power off timer, the shell input is buffered by the UART interrupt
+constexpr uint32_t system_idle_ms(const Inputs &inputs)
+{
+    return inputs.is_off ? c_off_poll_ms : c_active_poll_ms;
+}
+
+// Period of the SoC timer, the battery current is negligible in the pseudo-off state unless it is charging
+constexpr uint32_t soc_sample_ms(const Inputs &inputs)
+{
+    return (inputs.is_off && !inputs.is_charging) ? c_off_soc_sample_ms : c_soc_sample_ms;
+}
+
+// The STOP mode stops the ADC, the I2C and the timers: only allowed when nothing is measured, animated or timed
+constexpr bool is_stop_allowed(const Inputs &inputs)
+{
+    return !is_active(inputs) && !inputs.is_charging;
+}
+
+}
@@ -0,0 +1,292 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Power on sequence as a dependency graph. Each step runs on the task which owns its hardware as soon as the steps it
+// requires are done and its settle time has passed, so the steps of different tasks overlap: the amplifiers are
+// powered, the LEDs indicate and the USB PD controller is queried while the Bluetooth module boots. A task runs one
+// step at a time. The system task dispatches the steps and records when each of them was ready, started and done.
+namespace Teufel::Task::PowerSequence
+{
+
+enum class Owner : uint8_t
+{
+    Audio,
+    Bluetooth,
+};
+
+struct StepConfig
+{
+    const char *name;
+    Owner       owner;
+    uint32_t    prerequisites; // Bits of the steps which must be done, only earlier steps of the graph
+    uint32_t    settle_ms;     // Minimum time between the last prerequisite being done and the start of the step
+    uint32_t    timeout_ms;    // The sequence goes on as if the step was done, as the serial sequence did
+};
+
+// Milliseconds since the start of the sequence
+struct Timing
+{
+    static constexpr uint32_t c_never = UINT32_MAX;
+
+    uint32_t ready_ms  = c_never; // Prerequisites done and settled
+    uint32_t start_ms  = c_never; // Dispatched to the owner, later than ready when the owner was busy
+    uint32_t end_ms    = c_never;
+    bool     timed_out = false;
+};
+
+// The steps only require earlier steps of the graph: the declaration order is a topological order, without cycles
+template <size_t N>
+constexpr bool is_valid(const std::array<StepConfig, N> &steps)
+{
+    for (size_t i = 0; i < N; i++)
+    {
+        if ((steps[i].prerequisites >> i) != 0u)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <size_t N>
+class Sequencer
+{
+    static_assert(N > 0 && N <= 32, "The prerequisites are a 32 bit mask");
+
+  public:
+    static constexpr size_t   c_none     = N;
+    static constexpr uint32_t c_all_done = (N == 32) ? UINT32_MAX : ((1u << N) - 1u);
+
+    explicit constexpr Sequencer(const std::array<StepConfig, N> &steps) : m_steps(steps) {}
+
+    void start(uint32_t now_ms)
+    {
+        m_start_ms = now_ms;
+        m_started  = 0;
+        m_done     = 0;
+        m_timings  = {};
+    }
+
+    // Next step to dispatch, its owner is idle and its prerequisites have settled. The step is running from now on.
+    size_t next(uint32_t now_ms)
+    {
+        const uint32_t t = now_ms - m_start_ms;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            if ((m_started & bit(i)) != 0u || is_owner_busy(m_steps[i].owner))
+            {
+                continue;
+            }
+
+            const uint32_t ready_ms = ready_at(i);
+            if (ready_ms != Timing::c_never && t >= ready_ms)
+            {
+                m_started |= bit(i);
+                m_timings[i].ready_ms = ready_ms;
+                m_timings[i].start_ms = t;
+                return i;
+            }
+        }
+        return c_none;
+    }
+
+    // Ignores the steps which aren't running, e.g. a late completion after the timeout
+    void complete(size_t step, uint32_t now_ms)
+    {
+        if (step < N && is_running(step))
+        {
+            m_done |= bit(step);
+            m_timings[step].end_ms = now_ms - m_start_ms;
+        }
+    }
+
+    // Bits of the running steps which took longer than their timeout, they are done from now on
+    uint32_t expire(uint32_t now_ms)
+    {
+        const uint32_t t       = now_ms - m_start_ms;
+        uint32_t       expired = 0;
+
+        for (size_t i = 0; i < N; i++)
+        {
+            if (is_running(i) && t - m_timings[i].start_ms >= m_steps[i].timeout_ms)
+            {
+                m_timings[i].timed_out = true;
+                complete(i, now_ms);
+                expired |= bit(i);
+            }
+        }
+        return expired;
+    }
+
+    // Time until a step settles or times out, Timing::c_never when only a completion can make progress
+    uint32_t wait_ms(uint32_t now_ms) const
+    {
+        const uint32_t t    = now_ms - m_start_ms;
+        uint32_t       wait = Timing::c_never;
+
+        const auto until = [&](uint32_t at_ms) { return (at_ms > t) ? at_ms - t : 0u; };
+
+        for (size_t i = 0; i < N; i++)
+        {
+            if (is_running(i))
+            {
+                wait = min(wait, until(m_timings[i].start_ms + m_steps[i].timeout_ms));
+            }
+            else if ((m_started & bit(i)) == 0u && !is_owner_busy(m_steps[i].owner))
+            {
+                const uint32_t ready_ms = ready_at(i);
+                if (ready_ms != Timing::c_never)
+                {
+                    wait = min(wait, until(ready_ms));
+                }
+            }
+        }
+        return wait;
+    }
+
+    bool is_done() const
+    {
+        return m_done == c_all_done;
+    }
+
+    bool is_running(size_t step) const
+    {
+        return ((m_started & ~m_done) & bit(step)) != 0u;
+    }
+
+    // Duration of the whole sequence, the end of its last step
+    uint32_t total_ms() const
+    {
+        uint32_t total = 0;
+        for (const auto &timing : m_timings)
+        {
+            if (timing.end_ms != Timing::c_never)
+            {
+                total = (timing.end_ms > total) ? timing.end_ms : total;
+            }
+        }
+        return total;
+    }
+
+    uint32_t start_ms() const
+    {
+        return m_start_ms;
+    }
+
+    const StepConfig &config(size_t step) const
+    {
+        return m_steps[step];
+    }
+
+    const Timing &timing(size_t step) const
+    {
+        return m_timings[step];
+    }
+
+  private:
+    static constexpr uint32_t bit(size_t step)
+    {
+        return 1u << step;
+    }
+
+    static constexpr uint32_t min(uint32_t a, uint32_t b)
+    {
+        return (a < b) ? a : b;
+    }
+
+    bool is_owner_busy(Owner owner) const
+    {
+        for (size_t i = 0; i < N; i++)
+        {
+            if (m_steps[i].owner == owner && is_running(i))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Time the step may start at, Timing::c_never while a prerequisite isn't done
+    uint32_t ready_at(size_t step) const
+    {
+        const uint32_t prerequisites = m_steps[step].prerequisites;
+        if ((m_done & prerequisites) != prerequisites)
+        {
+            return Timing::c_never;
+        }
+
+        uint32_t last_ms = 0;
+        for (size_t i = 0; i < N; i++)
+        {
+            if ((prerequisites & bit(i)) != 0u && m_timings[i].end_ms > last_ms)
+            {
+                last_ms = m_timings[i].end_ms;
+            }
+        }
+        return last_ms + m_steps[step].settle_ms;
+    }
+
+    const std::array<StepConfig, N> &m_steps;
+    std::array<Timing, N>            m_timings{};
+    uint32_t                         m_start_ms = 0;
+    uint32_t                         m_started  = 0;
+    uint32_t                         m_done     = 0;
+};
+
+// --------------------------------------------------------------------------
+// Power on of the speaker
+// --------------------------------------------------------------------------
+
+enum class Step : uint8_t
+{
+    BoostOn,    // PVDD (24 V) of the amplifiers
+    IoExpander, // Out of reset, configured
+    AmpsPdn,    // Power down pin of both amplifiers high
+    Indication, // Battery level on the LEDs, or bypass mode
+    PdVersion,  // USB PD controller firmware version
+    BtBoot,     // Bluetooth module out of reset, Actions link ready
+    BtVersion,  // Bluetooth module firmware version
+    BtPowerOn,  // Bluetooth module powered on, it provides the I2S clocks and reports the audio source
+    AmpsConfig, // Amplifier DSP configuration, eco mode, aux jack: audio ready
+    Count,
+};
+
+constexpr size_t c_step_count = static_cast<size_t>(Step::Count);
+
+constexpr uint32_t bit(Step step)
+{
+    return 1u << static_cast<uint8_t>(step);
+}
+
+// Handled by the owner of the step, which reports its completion to the system task
+struct RunStep
+{
+    Step step;
+};
+
+// clang-format off
+constexpr std::array<StepConfig, c_step_count> c_power_on = {{
+    {"boost on",    Owner::Audio,     0u,                                        0u,   500u},
+    // The boost controller needs 50 us to turn on its internal regulator plus 120 us for its initial configuration
+    {"io expander", Owner::Audio,     bit(Step::BoostOn),                        10u,  500u},
+    // The power supplies must be stable before the amplifiers are enabled
+    {"amps pdn",    Owner::Audio,     bit(Step::IoExpander),                     0u,   500u},
+    {"indication",  Owner::Audio,     bit(Step::IoExpander),                     0u,   500u},
+    {"pd version",  Owner::Audio,     0u,                                        0u,   500u},
+    // Both amps' datasheets specify that the PDN pin should be high for at least 5 ms before the I2S clocks start
+    {"bt boot",     Owner::Bluetooth, bit(Step::AmpsPdn),                        5u,   4000u},
+    {"bt version",  Owner::Bluetooth, bit(Step::BtBoot),                         0u,   500u},
+    // The BT module needs some time after it reported ready before it accepts the power on
+    {"bt power on", Owner::Bluetooth, bit(Step::BtBoot),                         200u, 4000u},
+    // The amps need the I2S clocks to be stable before they can be configured
+    {"amps config", Owner::Audio,     bit(Step::AmpsPdn) | bit(Step::BtPowerOn), 0u,   3000u},
+}};
+// clang-format on
+
+static_assert(is_valid(c_power_on), "The power on steps may only require earlier steps");
+
+}
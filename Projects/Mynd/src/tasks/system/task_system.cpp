@@ -1,6 +1,7 @@
 // Due to the flash size limit, only the WARNING level is available
-// for use in the complete firmware (including the bootloader).
-#if defined(BOOTLOADER)
+// for use in the complete firmware (including the bootloader),
+// unless the binary logger keeps the format strings out of the flash.
+#if defined(BOOTLOADER) && !defined(LOGGER_BINARY)
 #define LOG_LEVEL LOG_LEVEL_WARNING
 #else
 #define LOG_LEVEL LOG_LEVEL_INFO
@@ -18,12 +19,15 @@
 #include "board.h"
 #include "board_link.h"
 #include "bsp_debug_uart.h"
+#include "bsp_low_power.h"
 #include "logger.h"
 
 #include "task_audio.h"
 #include "task_bluetooth.h"
 #include "task_system.h"
 #include "task_priorities.h"
+#include "idle_policy.h"
+#include "power_sequence.h"
 #include "external/teufel/libs/property/property.h"
 #include "external/teufel/libs/core_utils/overload.h"
 #include "external/teufel/libs/core_utils/sync.h"
@@ -37,6 +41,10 @@
 #define TASK_SYSTEM_STACK_SIZE 384
 #define QUEUE_SIZE             5
 
+// The owners of the power on steps set the bit of the step they completed. The lower indexes are taken by the
+// SyncPrimitive (one per task) and the highest one by the GenericThread wakeup.
+#define POWER_SEQUENCE_NOTIFICATION_INDEX 4
+
 namespace Teufel::Task::System
 {
 
@@ -103,6 +111,56 @@ static struct
 
 static StaticSemaphore_t property_mutex_buffer;
 
+// Timeline of the last power on, kept for the shell
+static PowerSequence::Sequencer<PowerSequence::c_step_count> s_power_on{PowerSequence::c_power_on};
+
+// Dispatches the power on steps to their owners as soon as they are ready, until all of them are done or timed out
+static void run_power_on_sequence()
+{
+    // Completions of the steps which timed out during the previous power on
+    ulTaskNotifyValueClearIndexed(nullptr, POWER_SEQUENCE_NOTIFICATION_INDEX, UINT32_MAX);
+
+    s_power_on.start(get_systick());
+    while (!s_power_on.is_done())
+    {
+        for (size_t step = s_power_on.next(get_systick()); step != s_power_on.c_none;
+             step        = s_power_on.next(get_systick()))
+        {
+            const PowerSequence::RunStep run_step{static_cast<PowerSequence::Step>(step)};
+            if (s_power_on.config(step).owner == PowerSequence::Owner::Audio)
+                Teufel::Task::Audio::postMessage(ot_id, run_step);
+            else
+                Teufel::Task::Bluetooth::postMessage(ot_id, run_step);
+        }
+
+        uint32_t done    = 0;
+        uint32_t wait_ms = s_power_on.wait_ms(get_systick());
+        xTaskNotifyWaitIndexed(POWER_SEQUENCE_NOTIFICATION_INDEX, 0, UINT32_MAX, &done,
+                               wait_ms == PowerSequence::Timing::c_never ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms));
+
+        const uint32_t now = get_systick();
+        for (size_t step = 0; step < PowerSequence::c_step_count; step++)
+        {
+            if (done & (1u << step))
+                s_power_on.complete(step, now);
+        }
+
+        uint32_t expired = s_power_on.expire(now);
+        for (size_t step = 0; step < PowerSequence::c_step_count; step++)
+        {
+            if (expired & (1u << step))
+                log_err("Power on step %s timed out", s_power_on.config(step).name);
+        }
+    }
+
+    log_info("Audio ready %lu ms after the power on request", s_power_on.total_ms());
+}
+
+void notifyPowerStepDone(PowerSequence::Step step)
+{
+    xTaskNotifyIndexed(task_handler->task, POWER_SEQUENCE_NOTIFICATION_INDEX, PowerSequence::bit(step), eSetBits);
+}
+
 static power_state_fn_t power_state_on(const Tus::PowerState &p, const Ux::System::PowerStateChangeReason &reason)
 {
     switch (p)
@@ -174,30 +232,12 @@ static power_state_fn_t power_state_off(const Tus::PowerState &p, const Ux::Syst
         {
             log_highlight("Powering on");
 
-            auto set_power_msg =
-                p_power_state.setTransition(Tus::PowerState::PreOn, reason, getDesc(Tus::PowerState::PreOn));
+            p_power_state.setTransition(Tus::PowerState::On, reason, getDesc(Tus::PowerState::On));
             board_link_power_supply_hold_on(true);
 
-            Teufel::Task::Audio::postMessage(ot_id, set_power_msg);
-            SyncPrimitive::await(Tus::Task::Audio, 200, "enabled amps");
-
-            // Bluetooth task does not need a PreOn state as of now, so we skip it
-
-            set_power_msg = p_power_state.setTransition(Tus::PowerState::On, reason, getDesc(Tus::PowerState::On));
-
-            Teufel::Task::Bluetooth::postMessage(ot_id, set_power_msg);
-            SyncPrimitive::await(Tus::Task::Bluetooth, 4000, "enabled BT");
-
-            // Delay enough for the BT module to power on and start I2S
-            // The amps need the I2S BCLK to be stable before they can be configured
-            // TODO: make it synchronous with BT ActionsReady
-            // TODO: keep it until we clarify power on sequence with BT team
-            // vTaskDelay(pdMS_TO_TICKS(1000));
-
-            log_dbg("Assuming I2S active, configuring amps");
-            Teufel::Task::Audio::postMessage(ot_id, set_power_msg);
-
-            SyncPrimitive::await(Tus::Task::Audio, 3000, "completed power on");
+            // The amps are powered and configured by the audio task, the BT module (which provides the I2S clocks)
+            // is booted by the bluetooth task, in parallel where the power on steps allow it
+            run_power_on_sequence();
 
             Teufel::Task::Bluetooth::postMessage(
                 ot_id, Tua::RequestSoundIcon{ACTIONSLINK_SOUND_ICON_POWER_ON,
@@ -259,7 +299,7 @@ static const GenericThread::Config<SystemMessage> threadConfig = {
     .Name      = "System",
     .StackSize = TASK_SYSTEM_STACK_SIZE,
     .Priority  = TASK_SYSTEM_PRIORITY,
-    .IdleMs    = 25,
+    .IdleMs    = Idle::c_active_poll_ms,
     .Callback_Idle =
         []()
     {
@@ -295,6 +335,9 @@ static const GenericThread::Config<SystemMessage> threadConfig = {
 
         board_link_moisture_detection_init();
 
+        // The audio task decides when the STOP mode is allowed
+        bsp_low_power_init();
+
         Teufel::Task::Audio::start();
         SyncPrimitive::await(Tus::Task::Audio, 2000, "started");
 
@@ -353,8 +396,9 @@ static const GenericThread::Config<SystemMessage> threadConfig = {
             },
             msg);
     },
-    .StackBuffer = system_task_stack,
-    .StaticTask  = &system_task_buffer,
+    .Callback_GetIdleMs = []() { return Idle::system_idle_ms({.is_off = isProperty(Tus::PowerState::Off)}); },
+    .StackBuffer        = system_task_stack,
+    .StaticTask         = &system_task_buffer,
     .StaticQueue = &queue_static,
     .QueueBuffer = queue_static_buffer,
 };
@@ -386,7 +430,7 @@ int start()
 {
     static_assert(sizeof(SystemMessage) <= 6, "Queue message size exceeded 6 bytes!");
 
-    s_system.property_mutex = xSemaphoreCreateMutexStatic(&property_mutex_buffer);
+    s_system.property_mutex = xSemaphoreCreateRecursiveMutexStatic(&property_mutex_buffer);
     APP_ASSERT(s_system.property_mutex, "Mutex was NULL");
 
     PropertyMutex::mutex = &p_mutex;
@@ -402,6 +446,51 @@ int postMessage(Tus::Task source_task, SystemMessage msg)
 }
 
 #ifndef BOOTLOADER
+static void print_sleep_stats()
+{
+    bsp_low_power_stats_t stats;
+    bsp_low_power_get_stats(&stats);
+
+    printf("STOP mode %s, RTC tick %lu us\r\n", bsp_low_power_is_stop_allowed() ? "allowed" : "not allowed",
+           stats.us_per_rtc_tick);
+    printf("  %lu stops (%lu woken early), %lu of %lu ms stopped\r\n", stats.stops, stats.early_wakeups,
+           stats.stopped_ms, stats.elapsed_ms);
+    printf("  %lu tickless sleeps, %lu ms\r\n", stats.sleeps, stats.slept_ms);
+
+    bsp_low_power_reset_stats();
+}
+
+// Milliseconds since the power on request, the start is later than the ready time while the owner was busy
+static void print_power_on_timeline()
+{
+    if (s_power_on.timing(0).start_ms == PowerSequence::Timing::c_never)
+    {
+        printf("No power on yet\r\n");
+        return;
+    }
+
+    printf("%-12s %-9s %6s %6s %6s\r\n", "step", "task", "ready", "start", "end");
+    for (size_t step = 0; step < PowerSequence::c_step_count; step++)
+    {
+        const auto &config = s_power_on.config(step);
+        const auto &timing = s_power_on.timing(step);
+
+        if (timing.start_ms == PowerSequence::Timing::c_never)
+        {
+            printf("%-12s %-9s %6s\r\n", config.name, "", "-");
+            continue;
+        }
+
+        printf("%-12s %-9s %6lu %6lu ", config.name,
+               config.owner == PowerSequence::Owner::Audio ? "audio" : "bluetooth", timing.ready_ms, timing.start_ms);
+        if (timing.end_ms == PowerSequence::Timing::c_never)
+            printf("%6s\r\n", "-");
+        else
+            printf("%6lu%s\r\n", timing.end_ms, timing.timed_out ? " timed out" : "");
+    }
+    printf("Audio ready after %lu ms\r\n", s_power_on.total_ms());
+}
+
 SHELL_STATIC_SUBCMD_SET_CREATE(
     sub_power,
     SHELL_CMD_NO_ARGS(off, "set power off",
@@ -412,10 +501,118 @@ SHELL_STATIC_SUBCMD_SET_CREATE(
                           s_system.stream_inactive_timestamp = 0;
                           postMessage(ot_id, Ux::System::SetPowerState{Ux::System::PowerState::On});
                       }),
+    SHELL_CMD_NO_ARGS(sleep, "STOP mode statistics since the last call", []() { print_sleep_stats(); }),
+    SHELL_CMD_NO_ARGS(boot, "timeline of the last power on", []() { print_power_on_timeline(); }),
     SHELL_SUBCMD_SET_END /* Array terminated. */
 );
 
 SHELL_CMD_ARG_REGISTER(p, &sub_power, "power", NULL, 2, 0);
+
+// Sizes the buffer between the log calls and the logger thread (LOGGER_STORAGE_SIZE_BYTES)
+static void print_logger_stats()
+{
+    logger_stats_t stats;
+    logger_get_stats(&stats);
+
+    printf("Logger buffer peak %lu of %lu bytes, %lu bytes dropped\r\n", stats.peak_fill_bytes, stats.size_bytes,
+           stats.dropped_bytes);
+
+    logger_reset_stats();
+}
+
+SHELL_STATIC_SUBCMD_SET_CREATE(sub_logger,
+    SHELL_CMD_NO_ARGS(stats, "buffer usage since the last call", []() { print_logger_stats(); }),
+    SHELL_SUBCMD_SET_END /* Array terminated. */
+);
+
+SHELL_CMD_ARG_REGISTER(logger, &sub_logger, "logger", NULL, 2, 0);
+
+#if defined(GENERIC_THREAD_ENABLE_STATS)
+static void print_handler_stats(const GenericThread::HandlerStats &stats)
+{
+    printf(" %7lu %7lu", stats.Count, stats.MaxTime);
+    for (auto count : stats.Histogram)
+    {
+        printf(" %7u", count);
+    }
+    printf("\r\n");
+}
+
+// CPU load of every task since the last call and its stack high-water mark, then per GenericThread task the queue
+// high-water mark and the durations of the idle callback and of the message handlers, by the index of the message
+// type in the message variant of the task
+static void print_top()
+{
+    constexpr UBaseType_t c_max_tasks = 8;
+
+    static TaskStatus_t tasks[c_max_tasks];
+    static struct
+    {
+        TaskHandle_t task;
+        uint32_t     run_time;
+    } s_last[c_max_tasks];
+    static uint32_t s_last_total;
+
+    uint32_t    total;
+    UBaseType_t count   = uxTaskGetSystemState(tasks, c_max_tasks, &total);
+    uint32_t    elapsed = total - s_last_total;
+    if (count == 0)
+    {
+        printf("More than %lu tasks\r\n", c_max_tasks);
+        return;
+    }
+
+    printf("%-10s %4s %7s %10s  (%lu us)\r\n", "task", "prio", "cpu %", "stack free", elapsed);
+    for (UBaseType_t i = 0; i < count; i++)
+    {
+        const auto &task = tasks[i];
+        uint32_t    last = 0;
+        for (const auto &entry : s_last)
+        {
+            if (entry.task == task.xHandle)
+            {
+                last = entry.run_time;
+            }
+        }
+
+        auto per_mille = elapsed ? static_cast<uint32_t>(uint64_t{task.ulRunTimeCounter - last} * 1000u / elapsed) : 0u;
+        printf("%-10s %4lu %5lu.%lu %10u\r\n", task.pcTaskName, task.uxCurrentPriority, per_mille / 10u,
+               per_mille % 10u, static_cast<unsigned>(task.usStackHighWaterMark * sizeof(StackType_t)));
+    }
+
+    printf("%-10s %4s %7s %7s", "thread", "type", "count", "max us");
+    for (auto limit : GenericThread::HandlerBucketLimits)
+    {
+        printf("  <%5lu", limit);
+    }
+    printf(" >=%5lu\r\n", GenericThread::HandlerBucketLimits[std::size(GenericThread::HandlerBucketLimits) - 1]);
+
+    for (auto *stats = GenericThread::StatsList; stats != nullptr; stats = stats->Next)
+    {
+        printf("%-10s queue %u of %u\r\n", stats->Name, stats->MaxQueueSize, stats->QueueSize);
+        printf("%-10s %4s", "", "idle");
+        print_handler_stats(stats->Idle);
+        for (uint8_t type = 0; type < stats->HandlerCount; type++)
+        {
+            if (stats->Handlers[type].Count != 0)
+            {
+                printf("%-10s %4u", "", type);
+                print_handler_stats(stats->Handlers[type]);
+            }
+        }
+    }
+
+    for (UBaseType_t i = 0; i < c_max_tasks; i++)
+    {
+        s_last[i] = {i < count ? tasks[i].xHandle : nullptr, i < count ? tasks[i].ulRunTimeCounter : 0u};
+    }
+    s_last_total = total;
+    GenericThread::ResetStats();
+}
+
+SHELL_CMD_ARG_REGISTER(top, NULL, "task load, stack and queue usage, handler durations since the last call",
+                       SHELL_CMD_NO_ARGS_FN([]() { print_top(); }), 1, 0);
+#endif
 #endif
 
 }
@@ -9,6 +9,7 @@
 #include "ux/input/input.h"
 
 #include "task_audio.h"
+#include "power_sequence.h"
 
 namespace Teufel::Task::System
 {
@@ -27,4 +28,7 @@ Teufel::Ux::System::PowerState getState();
 
 int start();
 int postMessage(Teufel::Ux::System::Task source_task, SystemMessage msg);
+
+// Called by the owner of a power on step when it is done, see power_sequence.h
+void notifyPowerStepDone(Teufel::Task::PowerSequence::Step step);
 }
@@ -0,0 +1,123 @@
+#include <cstdint>
+#include <cstdio>
+#include <set>
+
+#include <gtest/gtest.h>
+
+#include "idle_policy.h"
+
+using namespace Teufel::Task::Idle;
+
+// Before the tickless idle, the MCU woke up at every 1 ms tick. It now sleeps until the next task timeout, in the
+// STOP mode when it's allowed and with the SysTick reloaded otherwise: the periodic wakeups of the audio task, the
+// system task and the SoC timer, each with its own phase. Only the pseudo-off state is modelled, in which the
+// Bluetooth task idles forever, and the interrupts of the ADC and the I2C transfers aren't counted.
+constexpr uint32_t c_minute_ms     = 60'000;
+constexpr uint32_t c_tick_ms       = 1;
+constexpr uint32_t c_system_phase  = 7;
+constexpr uint32_t c_soc_phase     = 3;
+constexpr uint32_t c_off_budget      = 1'500;  // Wakeups per minute in the pseudo-off state
+constexpr uint32_t c_charging_budget = 10'000; // Wakeups per minute in the pseudo-off state while charging
+constexpr uint32_t c_baseline_rate   = c_minute_ms / c_tick_ms;
+
+struct Scenario
+{
+    const char *name;
+    Inputs      inputs;
+};
+
+static uint32_t wakeups_per_minute(const Inputs &inputs)
+{
+    if (!inputs.is_off)
+    {
+        return c_baseline_rate;
+    }
+
+    std::set<uint32_t> wakeups;
+    const auto         add_periodic = [&](uint32_t period_ms, uint32_t phase_ms)
+    {
+        for (uint32_t t = phase_ms; t < c_minute_ms; t += period_ms)
+        {
+            wakeups.insert(t);
+        }
+    };
+
+    add_periodic(audio_idle_ms(inputs), 0);
+    add_periodic(system_idle_ms(inputs), c_system_phase);
+    add_periodic(soc_sample_ms(inputs), c_soc_phase);
+
+    return static_cast<uint32_t>(wakeups.size());
+}
+
+static const Scenario c_scenarios[] = {
+    {"on", {.is_off = false, .is_charging = false, .is_led_animating = true, .is_button_pressed = false}},
+    {"off, charging", {.is_off = true, .is_charging = true, .is_led_animating = true, .is_button_pressed = false}},
+    {"off, charged", {.is_off = true, .is_charging = false, .is_led_animating = false, .is_button_pressed = false}},
+    {"off, button held", {.is_off = true, .is_charging = false, .is_led_animating = false, .is_button_pressed = true}},
+    {"off, LED pattern", {.is_off = true, .is_charging = false, .is_led_animating = true, .is_button_pressed = false}},
+};
+
+TEST(IdlePolicy, PseudoOffStaysWithinTheWakeupBudget)
+{
+    std::printf("%-18s %5s %12s %12s\n", "power state", "STOP", "wakeups/min", "before");
+    for (const auto &scenario : c_scenarios)
+    {
+        std::printf("%-18s %5s %12u %12u\n", scenario.name, is_stop_allowed(scenario.inputs) ? "yes" : "no",
+                    wakeups_per_minute(scenario.inputs), c_baseline_rate);
+    }
+
+    const Inputs off{.is_off = true, .is_charging = false, .is_led_animating = false, .is_button_pressed = false};
+    EXPECT_TRUE(is_stop_allowed(off));
+    EXPECT_LE(wakeups_per_minute(off), c_off_budget);
+}
+
+TEST(IdlePolicy, StopModeOnlyWithoutActiveWork)
+{
+    for (const auto &scenario : c_scenarios)
+    {
+        const auto &inputs = scenario.inputs;
+        if (!inputs.is_off || inputs.is_charging || inputs.is_led_animating || inputs.is_button_pressed)
+        {
+            EXPECT_FALSE(is_stop_allowed(inputs)) << scenario.name;
+        }
+    }
+}
+
+TEST(IdlePolicy, PseudoOffWhileChargingSleepsTickless)
+{
+    // No STOP mode while the SoC estimator integrates the current, the ticks are still suppressed
+    const Inputs charging{.is_off = true, .is_charging = true, .is_led_animating = true, .is_button_pressed = false};
+    EXPECT_FALSE(is_stop_allowed(charging));
+    EXPECT_LE(wakeups_per_minute(charging), c_charging_budget);
+}
+
+TEST(IdlePolicy, ActiveStatesPollAtTheActiveRate)
+{
+    for (const auto &scenario : c_scenarios)
+    {
+        if (is_active(scenario.inputs))
+        {
+            EXPECT_EQ(audio_idle_ms(scenario.inputs), c_active_poll_ms) << scenario.name;
+        }
+    }
+
+    // The power button must still be seen in the pseudo-off state
+    const Inputs off{.is_off = true};
+    EXPECT_LE(audio_idle_ms(off), c_off_poll_ms);
+    EXPECT_LE(system_idle_ms(off), c_off_poll_ms);
+}
+
+TEST(IdlePolicy, VolumeRampPollsAtItsPeriod)
+{
+    const Inputs on{.is_off = false};
+    EXPECT_EQ(audio_idle_ms({.is_off = false, .volume_ramp_ms = 5}), 5u);
+    EXPECT_EQ(audio_idle_ms({.is_off = false, .volume_ramp_ms = 100}), audio_idle_ms(on));
+    EXPECT_FALSE(is_stop_allowed({.is_off = true, .volume_ramp_ms = 5}));
+}
+
+TEST(IdlePolicy, SocIsSampledFastWhileCharging)
+{
+    EXPECT_EQ(soc_sample_ms({.is_off = false}), c_soc_sample_ms);
+    EXPECT_EQ(soc_sample_ms({.is_off = true, .is_charging = true}), c_soc_sample_ms);
+    EXPECT_EQ(soc_sample_ms({.is_off = true}), c_off_soc_sample_ms);
+}
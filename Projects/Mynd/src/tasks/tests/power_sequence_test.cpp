@@ -0,0 +1,216 @@
+#include <array>
+#include <cstdint>
+#include <cstdio>
+
+#include <gtest/gtest.h>
+
+#include "power_sequence.h"
+
+using namespace Teufel::Task::PowerSequence;
+
+constexpr uint32_t c_hangs = Timing::c_never;
+
+// Runs a sequence against simulated owner tasks: each step takes its duration from the time it was dispatched. The
+// system task wakes up at every completion and whenever the sequencer has a step to settle or to time out.
+template <size_t N>
+static uint32_t run(Sequencer<N> &sequencer, const std::array<uint32_t, N> &durations)
+{
+    std::array<uint32_t, N> end_ms;
+    end_ms.fill(c_hangs);
+
+    uint32_t now = 1000; // Not at 0, the timeline is relative to the start
+    sequencer.start(now);
+
+    for (unsigned wakeups = 0; !sequencer.is_done(); wakeups++)
+    {
+        EXPECT_LT(wakeups, 100u) << "no progress";
+        if (wakeups >= 100u)
+        {
+            break;
+        }
+
+        for (size_t step = sequencer.next(now); step != sequencer.c_none; step = sequencer.next(now))
+        {
+            end_ms[step] = (durations[step] == c_hangs) ? c_hangs : now + durations[step];
+        }
+
+        uint32_t next = (sequencer.wait_ms(now) == Timing::c_never) ? c_hangs : now + sequencer.wait_ms(now);
+        for (size_t step = 0; step < N; step++)
+        {
+            if (sequencer.is_running(step) && end_ms[step] < next)
+            {
+                next = end_ms[step];
+            }
+        }
+        if (next == c_hangs)
+        {
+            ADD_FAILURE() << "nothing to wait for";
+            break;
+        }
+
+        now = next;
+        for (size_t step = 0; step < N; step++)
+        {
+            if (end_ms[step] == now)
+            {
+                sequencer.complete(step, now);
+            }
+        }
+        sequencer.expire(now);
+    }
+
+    return sequencer.total_ms();
+}
+
+template <size_t N>
+static void print_timeline(const Sequencer<N> &sequencer)
+{
+    std::printf("%-12s %-9s %6s %6s %6s\n", "step", "task", "ready", "start", "end");
+    for (size_t step = 0; step < N; step++)
+    {
+        const auto &timing = sequencer.timing(step);
+        std::printf("%-12s %-9s %6u %6u %6u%s\n", sequencer.config(step).name,
+                    sequencer.config(step).owner == Owner::Audio ? "audio" : "bluetooth", timing.ready_ms,
+                    timing.start_ms, timing.end_ms, timing.timed_out ? " timed out" : "");
+    }
+}
+
+// Typical durations, the Bluetooth module boot and power on dominate
+constexpr std::array<uint32_t, c_step_count> c_durations = {
+    1,    // BoostOn
+    3,    // IoExpander
+    1,    // AmpsPdn
+    4,    // Indication
+    6,    // PdVersion
+    1450, // BtBoot
+    12,   // BtVersion
+    380,  // BtPowerOn
+    95,   // AmpsConfig
+};
+
+TEST(PowerSequence, StepsStartAfterTheirPrerequisitesSettled)
+{
+    Sequencer<c_step_count> sequencer(c_power_on);
+    run(sequencer, c_durations);
+    print_timeline(sequencer);
+
+    ASSERT_TRUE(sequencer.is_done());
+    for (size_t step = 0; step < c_step_count; step++)
+    {
+        const auto &config = c_power_on[step];
+        const auto &timing = sequencer.timing(step);
+
+        EXPECT_FALSE(timing.timed_out) << config.name;
+        EXPECT_GE(timing.start_ms, timing.ready_ms) << config.name;
+        EXPECT_EQ(timing.end_ms - timing.start_ms, c_durations[step]) << config.name;
+
+        for (size_t prerequisite = 0; prerequisite < c_step_count; prerequisite++)
+        {
+            if (config.prerequisites & (1u << prerequisite))
+            {
+                EXPECT_GE(timing.start_ms, sequencer.timing(prerequisite).end_ms + config.settle_ms)
+                    << config.name << " after " << c_power_on[prerequisite].name;
+            }
+        }
+    }
+}
+
+TEST(PowerSequence, OwnersRunOneStepAtATime)
+{
+    Sequencer<c_step_count> sequencer(c_power_on);
+    run(sequencer, c_durations);
+
+    for (size_t a = 0; a < c_step_count; a++)
+    {
+        for (size_t b = a + 1; b < c_step_count; b++)
+        {
+            if (c_power_on[a].owner != c_power_on[b].owner)
+            {
+                continue;
+            }
+
+            const auto &first  = sequencer.timing(a);
+            const auto &second = sequencer.timing(b);
+            EXPECT_TRUE(first.end_ms <= second.start_ms || second.end_ms <= first.start_ms)
+                << c_power_on[a].name << " overlaps " << c_power_on[b].name;
+        }
+    }
+
+    // The PD controller is queried while the boost converter settles
+    EXPECT_LT(sequencer.timing(static_cast<size_t>(Step::PdVersion)).start_ms,
+              sequencer.timing(static_cast<size_t>(Step::IoExpander)).start_ms);
+}
+
+// The serial sequence: audio pre on with its fixed delays, the whole Bluetooth power on, then the amps configuration
+TEST(PowerSequence, FasterThanTheSerialSequence)
+{
+    constexpr uint32_t c_serial_delays_ms = 10 + 5 + 200;
+
+    uint32_t serial_ms = c_serial_delays_ms;
+    for (auto duration : c_durations)
+    {
+        serial_ms += duration;
+    }
+
+    Sequencer<c_step_count> sequencer(c_power_on);
+    const uint32_t          total_ms = run(sequencer, c_durations);
+
+    std::printf("Audio ready after %u ms, %u ms serial\n", total_ms, serial_ms);
+    EXPECT_EQ(total_ms, sequencer.timing(static_cast<size_t>(Step::AmpsConfig)).end_ms);
+    EXPECT_LT(total_ms, serial_ms);
+}
+
+TEST(PowerSequence, TimedOutStepsDontBlockTheSequence)
+{
+    auto durations                                  = c_durations;
+    durations[static_cast<size_t>(Step::BtPowerOn)] = c_hangs;
+
+    Sequencer<c_step_count> sequencer(c_power_on);
+    run(sequencer, durations);
+
+    ASSERT_TRUE(sequencer.is_done());
+
+    const auto &power_on = sequencer.timing(static_cast<size_t>(Step::BtPowerOn));
+    EXPECT_TRUE(power_on.timed_out);
+    EXPECT_EQ(power_on.end_ms - power_on.start_ms, c_power_on[static_cast<size_t>(Step::BtPowerOn)].timeout_ms);
+    EXPECT_EQ(sequencer.timing(static_cast<size_t>(Step::AmpsConfig)).start_ms, power_on.end_ms);
+
+    // The completion after the timeout changes nothing
+    const uint32_t end_ms = power_on.end_ms;
+    sequencer.complete(static_cast<size_t>(Step::BtPowerOn), sequencer.start_ms() + end_ms + 100);
+    EXPECT_EQ(power_on.end_ms, end_ms);
+}
+
+TEST(PowerSequence, StepsOfABusyOwnerWait)
+{
+    // Both steps are ready at once, the second one waits for its owner
+    static constexpr std::array<StepConfig, 3> c_steps = {{
+        {"first", Owner::Audio, 0u, 0u, 100u},
+        {"second", Owner::Audio, 0u, 0u, 100u},
+        {"other", Owner::Bluetooth, 0u, 0u, 100u},
+    }};
+
+    Sequencer<3> sequencer(c_steps);
+    run(sequencer, std::array<uint32_t, 3>{20, 5, 7});
+
+    EXPECT_EQ(sequencer.timing(1).ready_ms, 0u);
+    EXPECT_EQ(sequencer.timing(1).start_ms, 20u);
+    EXPECT_EQ(sequencer.timing(2).start_ms, 0u);
+    EXPECT_EQ(sequencer.total_ms(), 25u);
+}
+
+TEST(PowerSequence, OnlyEarlierStepsMayBeRequired)
+{
+    constexpr std::array<StepConfig, 2> c_forward = {{
+        {"first", Owner::Audio, 1u << 1, 0u, 100u},
+        {"second", Owner::Audio, 0u, 0u, 100u},
+    }};
+    constexpr std::array<StepConfig, 2> c_itself = {{
+        {"first", Owner::Audio, 0u, 0u, 100u},
+        {"second", Owner::Audio, 1u << 1, 0u, 100u},
+    }};
+
+    static_assert(!is_valid(c_forward));
+    static_assert(!is_valid(c_itself));
+    static_assert(is_valid(c_power_on));
+}
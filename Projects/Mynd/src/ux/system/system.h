@@ -5,20 +5,28 @@
 #endif // INCLUDE_PRODUCTION_TEST
 #include <cstdint>
 #include <optional>
+#include <tuple>
 
 #include "external/teufel/libs/power/power.h"
+#include "external/teufel/libs/property/property.h"
 
 #define PROPERTY_SET(_TYPE, _VARIABLE)                                                                                 \
     static void setProperty(_TYPE v)                                                                                   \
     {                                                                                                                  \
         _VARIABLE.set(v.value);                                                                                        \
-    }
+    }                                                                                                                  \
+    PROPERTY_PUBLISH(_TYPE, _VARIABLE)
 
 #define PROPERTY_ENUM_SET(_TYPE, _VARIABLE)                                                                            \
     static void setProperty(_TYPE v)                                                                                   \
     {                                                                                                                  \
         _VARIABLE.set(v, getDesc(v));                                                                                  \
-    }
+    }                                                                                                                  \
+    PROPERTY_PUBLISH(_TYPE, _VARIABLE)
+
+// The changes of _VARIABLE are published to the subscribers of getPropertyTopic<_TYPE>()
+#define PROPERTY_PUBLISH(_TYPE, _VARIABLE)                                                                             \
+    [[maybe_unused]] static const bool _VARIABLE##_published = (_VARIABLE.publish_to(getPropertyTopic<_TYPE>()), true);
 
 template <typename T>
 auto getProperty()
@@ -26,6 +34,19 @@ auto getProperty()
     return getProperty(static_cast<T *>(nullptr));
 }
 
+template <typename T>
+inline constinit PropertyTopic property_topic{};
+
+/**
+ * @brief Topic of the changes of the property T. A static PropertySubscriber on it is notified by each change, in the
+ *        task which made it.
+ */
+template <typename T>
+PropertyTopic &getPropertyTopic()
+{
+    return property_topic<T>;
+}
+
 template <typename T>
 bool isProperty(T v)
 {
@@ -49,6 +70,15 @@ bool isPropertyOneOf(T... v)
     return false;
 }
 
+/**
+ * @brief Reads several properties in one pass: none of them is changed while the others are read.
+ */
+template <typename... T>
+std::tuple<T...> getPropertySnapshot()
+{
+    return PropertySeqLock::read([] { return std::tuple<T...>{getProperty<T>()...}; });
+}
+
 namespace Teufel::Ux::System
 {
 
@@ -241,8 +271,8 @@ struct HardReset {};
 struct ChargeLimitMode { bool value; };
 #endif // INCLUDE_PRODUCTION_TESTS
 
-struct BatterySocAccumulatedCharge { float value; };
-struct BatterySocCapacity { float value; };
+struct BatterySocAccumulatedCharge { int32_t value; }; // Milliampere * seconds
+struct BatterySocCapacity { int32_t value; }; // Milliampere * seconds
 
 enum class BatterySoCAlgoState : uint8_t {
     Reset, // After the factory reset or new battery
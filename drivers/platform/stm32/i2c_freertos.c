@@ -1,6 +1,8 @@
+#include <string.h>
 #include "stm32f0xx_hal.h"
 #include "FreeRTOS.h"
 #include "semphr.h"
+#include "task.h"
 #include "i2c_freertos.h"
 #include "app_assert/app_assert.h"
 
@@ -16,38 +18,170 @@ struct i2c_rtos_handler
     StaticSemaphore_t semaphore_buffer;
 #endif
     uint32_t async_error_code;
+
+    // Batch being executed by the interrupt chain, NULL when idle or after a timeout
+    const i2c_rtos_transfer_t *volatile p_batch;
+    volatile size_t                    batch_count;
+    volatile size_t                    batch_index;
+    volatile int                       batch_error;
+
+    // Only accessed with the mutex taken
+    i2c_rtos_stats_t stats;
+    TickType_t       stats_reset_tick;
 };
 
 static struct i2c_rtos_handler i2c_rtos_handlers[I2C_RTOS_NUM];
 
+static int start_transfer(struct i2c_rtos_handler *i2c_h, const i2c_rtos_transfer_t *p_transfer)
+{
+    I2C_HandleTypeDef *hi2c    = i2c_h->hi2c;
+    HAL_StatusTypeDef  status  = HAL_ERROR;
+    bool               use_dma = p_transfer->length >= I2C_RTOS_DMA_MIN_LENGTH;
+
+    if (p_transfer->direction == I2C_RTOS_WRITE)
+    {
+        if (use_dma && hi2c->hdmatx)
+        {
+            status = HAL_I2C_Mem_Write_DMA(hi2c, p_transfer->i2c_address, p_transfer->reg_address,
+                                           p_transfer->reg_address_size, p_transfer->p_buffer, p_transfer->length);
+        }
+        else
+        {
+            status = HAL_I2C_Mem_Write_IT(hi2c, p_transfer->i2c_address, p_transfer->reg_address,
+                                          p_transfer->reg_address_size, p_transfer->p_buffer, p_transfer->length);
+        }
+    }
+    else
+    {
+        if (use_dma && hi2c->hdmarx)
+        {
+            status = HAL_I2C_Mem_Read_DMA(hi2c, p_transfer->i2c_address, p_transfer->reg_address,
+                                          p_transfer->reg_address_size, p_transfer->p_buffer, p_transfer->length);
+        }
+        else
+        {
+            status = HAL_I2C_Mem_Read_IT(hi2c, p_transfer->i2c_address, p_transfer->reg_address,
+                                         p_transfer->reg_address_size, p_transfer->p_buffer, p_transfer->length);
+        }
+    }
+
+    return status == HAL_OK ? 0 : -1;
+}
+
+// Called from the I2C interrupt when a transfer has finished or failed, starts the next transfer of the batch
+// or wakes up the task waiting for it
+static void on_transfer_done_isr(I2C_HandleTypeDef *hi2c)
+{
+    BaseType_t               xHigherPriorityTaskWoken = pdFALSE;
+    struct i2c_rtos_handler *i2c_h                    = &i2c_rtos_handlers[hi2c->Instance == I2C1 ? 0 : 1];
+
+    if (i2c_h->p_batch == NULL)
+    {
+        // The waiting task has given up on this batch
+        return;
+    }
+
+    i2c_h->async_error_code = hi2c->ErrorCode;
+    if (i2c_h->async_error_code != HAL_I2C_ERROR_NONE)
+    {
+        i2c_h->batch_error = -4;
+    }
+    else if (i2c_h->batch_index + 1 < i2c_h->batch_count)
+    {
+        i2c_h->batch_index++;
+        if (start_transfer(i2c_h, &i2c_h->p_batch[i2c_h->batch_index]) == 0)
+        {
+            return;
+        }
+        i2c_h->batch_error = -2;
+    }
+    else
+    {
+        i2c_h->batch_index = i2c_h->batch_count;
+    }
+
+    i2c_h->p_batch = NULL;
+    xSemaphoreGiveFromISR(i2c_h->semaphore, &xHigherPriorityTaskWoken);
+    portYIELD_FROM_ISR(xHigherPriorityTaskWoken);
+}
+
 void HAL_I2C_MemTxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    portENTER_CRITICAL();
-    BaseType_t xHigherPriorityTaskWoken               = pdFALSE;
-    int        handler_index                          = hi2c->Instance == I2C1 ? 0 : 1;
-    i2c_rtos_handlers[handler_index].async_error_code = hi2c->ErrorCode;
-    portEXIT_CRITICAL();
-    xSemaphoreGiveFromISR(i2c_rtos_handlers[handler_index].semaphore, &xHigherPriorityTaskWoken);
+    on_transfer_done_isr(hi2c);
 }
 
 void HAL_I2C_MemRxCpltCallback(I2C_HandleTypeDef *hi2c)
 {
-    portENTER_CRITICAL();
-    BaseType_t xHigherPriorityTaskWoken               = pdFALSE;
-    int        handler_index                          = hi2c->Instance == I2C1 ? 0 : 1;
-    i2c_rtos_handlers[handler_index].async_error_code = hi2c->ErrorCode;
-    portEXIT_CRITICAL();
-    xSemaphoreGiveFromISR(i2c_rtos_handlers[handler_index].semaphore, &xHigherPriorityTaskWoken);
+    on_transfer_done_isr(hi2c);
 }
 
 void HAL_I2C_ErrorCallback(I2C_HandleTypeDef *hi2c)
 {
-    portENTER_CRITICAL();
-    BaseType_t xHigherPriorityTaskWoken               = pdFALSE;
-    int        handler_index                          = hi2c->Instance == I2C1 ? 0 : 1;
-    i2c_rtos_handlers[handler_index].async_error_code = hi2c->ErrorCode;
-    portEXIT_CRITICAL();
-    xSemaphoreGiveFromISR(i2c_rtos_handlers[handler_index].semaphore, &xHigherPriorityTaskWoken);
+    on_transfer_done_isr(hi2c);
+}
+
+// Stops a transfer that didn't finish in time, it may be stuck on a device holding the bus. The reset of the peripheral
+// through its MSP also stops the DMA channels, where HAL_I2C_Master_Abort_IT() would wait for the STOP condition to be
+// sent. Called with the interrupts disabled, so that the I2C and DMA interrupts don't see the handles in between.
+static void reset_peripheral(struct i2c_rtos_handler *i2c_h)
+{
+    HAL_I2C_DeInit(i2c_h->hi2c);
+    HAL_I2C_Init(i2c_h->hi2c);
+    HAL_I2CEx_ConfigAnalogFilter(i2c_h->hi2c, I2C_ANALOGFILTER_ENABLE);
+}
+
+static i2c_rtos_device_stats_t *get_device_stats(struct i2c_rtos_handler *i2c_h, uint8_t i2c_address)
+{
+    i2c_rtos_stats_t *p_stats = &i2c_h->stats;
+
+    for (uint8_t i = 0; i < p_stats->number_of_devices; i++)
+    {
+        if (p_stats->devices[i].i2c_address == i2c_address)
+        {
+            return &p_stats->devices[i];
+        }
+    }
+
+    if (p_stats->number_of_devices == I2C_RTOS_MAX_DEVICES)
+    {
+        return NULL;
+    }
+
+    i2c_rtos_device_stats_t *p_device = &p_stats->devices[p_stats->number_of_devices++];
+    p_device->i2c_address             = i2c_address;
+    return p_device;
+}
+
+static void update_stats(struct i2c_rtos_handler *i2c_h, const i2c_rtos_transfer_t *p_transfers, size_t count,
+                         size_t completed)
+{
+    i2c_h->stats.batches++;
+
+    for (size_t i = 0; i < count && i <= completed; i++)
+    {
+        i2c_rtos_device_stats_t *p_device = get_device_stats(i2c_h, p_transfers[i].i2c_address);
+        if (p_device == NULL)
+        {
+            continue;
+        }
+
+        if (i == completed)
+        {
+            p_device->errors++;
+            continue;
+        }
+
+        // 9 clocks per byte (8 data bits and the ACK), plus the repeated start and address byte of a read
+        uint32_t frame_bytes = 1u + p_transfers[i].reg_address_size + p_transfers[i].length;
+        if (p_transfers[i].direction == I2C_RTOS_READ)
+        {
+            frame_bytes += 1u;
+        }
+
+        p_device->transfers++;
+        p_device->bytes += p_transfers[i].length;
+        p_device->bus_clocks += frame_bytes * 9u;
+    }
 }
 
 struct i2c_rtos_handler *i2c_rtos_init(I2C_HandleTypeDef *hi2c)
@@ -62,6 +196,9 @@ struct i2c_rtos_handler *i2c_rtos_init(I2C_HandleTypeDef *hi2c)
         xSemaphoreCreateBinaryStatic(&i2c_rtos_handlers[handler_index].semaphore_buffer);
     APP_ASSERT(i2c_rtos_handlers[handler_index].semaphore);
 
+    i2c_rtos_handlers[handler_index].p_batch          = NULL;
+    i2c_rtos_handlers[handler_index].stats_reset_tick = xTaskGetTickCount();
+
     HAL_I2C_Init(hi2c);
 
     HAL_I2CEx_ConfigAnalogFilter(hi2c, I2C_ANALOGFILTER_ENABLE);
@@ -69,87 +206,114 @@ struct i2c_rtos_handler *i2c_rtos_init(I2C_HandleTypeDef *hi2c)
     return &i2c_rtos_handlers[handler_index];
 }
 
-int i2c_rtos_write_data(struct i2c_rtos_handler *i2c_h, uint8_t i2c_address, uint16_t reg_address,
-                        uint16_t reg_address_size, uint8_t *p_buffer, size_t length)
+int i2c_rtos_transfer_batch(struct i2c_rtos_handler *i2c_h, const i2c_rtos_transfer_t *p_transfers, size_t count,
+                            uint32_t timeout_ms)
 {
     int error = 0;
 
-    if (xSemaphoreTake(i2c_h->mutex, pdMS_TO_TICKS(100)) != pdTRUE)
+    if (count == 0)
     {
-        error = -1;
-        goto error_handler;
+        return 0;
     }
 
-    if (HAL_I2C_Mem_Write_IT(i2c_h->hi2c, i2c_address, reg_address, reg_address_size, p_buffer, length) != HAL_OK)
+    if (xSemaphoreTake(i2c_h->mutex, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
     {
-        error = -2;
-        goto error_handler;
+        return -1;
     }
 
-    // Wait for transfer to finish
-    if (xSemaphoreTake(i2c_h->semaphore, pdMS_TO_TICKS(100)) != pdTRUE)
+    // Drop a completion given after a previous batch timed out
+    (void) xSemaphoreTake(i2c_h->semaphore, 0);
+
+    i2c_h->batch_count = count;
+    i2c_h->batch_index = 0;
+    i2c_h->batch_error = 0;
+    i2c_h->p_batch     = p_transfers;
+
+    if (start_transfer(i2c_h, &p_transfers[0]) != 0)
     {
-        error = -3;
-        goto error_handler;
+        i2c_h->p_batch = NULL;
+        error          = -2;
     }
+    // Wait for the whole batch to finish
+    else if (xSemaphoreTake(i2c_h->semaphore, pdMS_TO_TICKS(timeout_ms)) != pdTRUE)
+    {
+        // Stop the interrupt chain from starting further transfers, and the running one
+        taskENTER_CRITICAL();
+        i2c_h->p_batch = NULL;
+        reset_peripheral(i2c_h);
+        taskEXIT_CRITICAL();
 
-    if (i2c_h->async_error_code)
+        i2c_h->stats.timeouts++;
+        error = -3;
+    }
+    else
     {
-        error = -4;
-        goto error_handler;
+        error = i2c_h->batch_error;
     }
 
+    update_stats(i2c_h, p_transfers, count, i2c_h->batch_index);
+
     // Unlock resource mutex
     (void) xSemaphoreGive(i2c_h->mutex);
 
     return error;
+}
 
-error_handler:
-    // Deinit I2C iface?!
-    xSemaphoreGive(i2c_h->mutex);
-    return error;
+int i2c_rtos_write_data(struct i2c_rtos_handler *i2c_h, uint8_t i2c_address, uint16_t reg_address,
+                        uint16_t reg_address_size, uint8_t *p_buffer, size_t length)
+{
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = reg_address,
+        .reg_address_size = reg_address_size,
+        .direction        = I2C_RTOS_WRITE,
+        .p_buffer         = p_buffer,
+        .length           = length,
+    };
+
+    return i2c_rtos_transfer_batch(i2c_h, &transfer, 1, 100);
 }
 
 int i2c_rtos_read_data(struct i2c_rtos_handler *i2c_h, uint8_t i2c_address, uint16_t reg_address,
                        uint16_t reg_address_size, uint8_t *p_buffer, size_t length)
 {
-    int error = 0;
+    const i2c_rtos_transfer_t transfer = {
+        .i2c_address      = i2c_address,
+        .reg_address      = reg_address,
+        .reg_address_size = reg_address_size,
+        .direction        = I2C_RTOS_READ,
+        .p_buffer         = p_buffer,
+        .length           = length,
+    };
 
-    if (xSemaphoreTake(i2c_h->mutex, pdMS_TO_TICKS(1000)) != pdTRUE)
-    {
-        error = -1;
-        goto error_handler;
-    }
+    return i2c_rtos_transfer_batch(i2c_h, &transfer, 1, 1000);
+}
 
-    if (HAL_I2C_Mem_Read_IT(i2c_h->hi2c, i2c_address, reg_address, reg_address_size, p_buffer, length) != HAL_OK)
+int i2c_rtos_get_stats(struct i2c_rtos_handler *i2c_h, i2c_rtos_stats_t *p_stats)
+{
+    if (xSemaphoreTake(i2c_h->mutex, pdMS_TO_TICKS(100)) != pdTRUE)
     {
-        error = -2;
-        goto error_handler;
+        return -1;
     }
 
-    // Wait for transfer to finish
-    if (xSemaphoreTake(i2c_h->semaphore, pdMS_TO_TICKS(1000)) != pdTRUE)
-    {
-        error = -3;
-        goto error_handler;
-    }
+    *p_stats            = i2c_h->stats;
+    p_stats->elapsed_ms = (xTaskGetTickCount() - i2c_h->stats_reset_tick) * portTICK_PERIOD_MS;
 
-    // Check for errors
-    if (i2c_h->async_error_code)
+    (void) xSemaphoreGive(i2c_h->mutex);
+    return 0;
+}
+
+void i2c_rtos_reset_stats(struct i2c_rtos_handler *i2c_h)
+{
+    if (xSemaphoreTake(i2c_h->mutex, pdMS_TO_TICKS(100)) != pdTRUE)
     {
-        error = -4;
-        goto error_handler;
+        return;
     }
 
-    // Unlock resource mutex
-    (void) xSemaphoreGive(i2c_h->mutex);
-
-    return error;
+    memset(&i2c_h->stats, 0, sizeof(i2c_h->stats));
+    i2c_h->stats_reset_tick = xTaskGetTickCount();
 
-error_handler:
-    // Deinit I2C iface?!
-    xSemaphoreGive(i2c_h->mutex);
-    return error;
+    (void) xSemaphoreGive(i2c_h->mutex);
 }
 
 __attribute__((optimize("-O0"))) static void I2C_Error_Handle(I2C_HandleTypeDef *hi2c)
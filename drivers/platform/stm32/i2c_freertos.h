@@ -1,11 +1,77 @@
 #pragma once
 
+#include <stdbool.h>
 #include "stm32f0xx_hal.h"
 
+// Maximum number of devices per bus whose statistics are tracked
+#define I2C_RTOS_MAX_DEVICES 8
+
+// Transfers shorter than this are done with interrupts, the DMA setup isn't worth it for a couple of bytes
+#define I2C_RTOS_DMA_MIN_LENGTH 4
+
 typedef struct i2c_rtos_handler i2c_rtos_handler_t;
 
+typedef enum
+{
+    I2C_RTOS_WRITE,
+    I2C_RTOS_READ,
+} i2c_rtos_direction_t;
+
+typedef struct
+{
+    uint8_t              i2c_address;
+    uint16_t             reg_address;
+    uint16_t             reg_address_size;
+    i2c_rtos_direction_t direction;
+    uint8_t             *p_buffer;
+    size_t               length;
+} i2c_rtos_transfer_t;
+
+typedef struct
+{
+    uint8_t  i2c_address;
+    uint32_t transfers;
+    uint32_t bytes;
+    uint32_t errors;
+    uint32_t bus_clocks; // SCL clocks the transfers occupied the bus for (address, register and data bytes)
+} i2c_rtos_device_stats_t;
+
+typedef struct
+{
+    uint32_t                elapsed_ms; // Time since the statistics were reset
+    uint32_t                batches;
+    uint32_t                timeouts;
+    uint8_t                 number_of_devices;
+    i2c_rtos_device_stats_t devices[I2C_RTOS_MAX_DEVICES];
+} i2c_rtos_stats_t;
+
 i2c_rtos_handler_t *i2c_rtos_init(I2C_HandleTypeDef *hi2c);
 int i2c_rtos_write_data(i2c_rtos_handler_t *i2c_h, uint8_t i2c_address, uint16_t reg_address, uint16_t reg_address_size,
                         uint8_t *p_buffer, size_t length);
 int i2c_rtos_read_data(i2c_rtos_handler_t *i2c_h, uint8_t i2c_address, uint16_t reg_address, uint16_t reg_address_size,
                        uint8_t *p_buffer, size_t length);
+
+/**
+ * @brief Executes a batch of register transfers back-to-back, the next transfer is started from the completion
+ *        interrupt of the previous one and the calling task is only woken up once the whole batch is done.
+ * @note  The transfers use DMA if the I2C handle has DMA channels linked and they are at least
+ *        I2C_RTOS_DMA_MIN_LENGTH bytes long. The batch stops at the first failed transfer. On a timeout the
+ *        peripheral is reset, which stops the running transfer and its DMA.
+ *
+ * @param[in] i2c_h         I2C handler
+ * @param[in] p_transfers   transfers to execute, must stay valid until the function returns
+ * @param[in] count         number of transfers
+ * @param[in] timeout_ms    maximum time to wait for the bus and for the batch to complete
+ *
+ * @return 0 if successful, -1 if the bus is busy, -2 if a transfer couldn't be started, -3 on timeout,
+ *         -4 if a transfer failed
+ */
+int i2c_rtos_transfer_batch(i2c_rtos_handler_t *i2c_h, const i2c_rtos_transfer_t *p_transfers, size_t count,
+                            uint32_t timeout_ms);
+
+/**
+ * @brief Copies the bus statistics collected since the last reset.
+ */
+int i2c_rtos_get_stats(i2c_rtos_handler_t *i2c_h, i2c_rtos_stats_t *p_stats);
+
+void i2c_rtos_reset_stats(i2c_rtos_handler_t *i2c_h);
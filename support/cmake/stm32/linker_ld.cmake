@@ -162,6 +162,9 @@ ${CCRAM_SECTION}\n\
   }\n\
 \n\
   .ARM.attributes 0 : { *(.ARM.attributes) }\n\
+\n\
+  /* Descriptors of the binary logger (format strings), kept in the ELF file for the decoder but not loaded */\n\
+  .logger_fmt 0 (INFO) : { KEEP(*(SORT(.logger_fmt.*))) }\n\
 ${RAM_SHARE_SECTION}\n\
 }"
 )
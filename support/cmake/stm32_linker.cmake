@@ -131,5 +131,6 @@ SET(STM32_LINKER_SCRIPT_TEXT
   "    libgcc.a ( * )\n"
   "  }\n"
   "  .ARM.attributes 0 : { *(.ARM.attributes) }\n"
+  "  .logger_fmt 0 (INFO) : { KEEP(*(SORT(.logger_fmt.*))) }\n"
   "}\n"
 )